@@ -154,14 +154,42 @@ static Type getElementTypeForUKernel(Value input) {
   return castOpSrcType;
 }
 
+/// Returns the tensor.pack op producing `lhs`, if it can be folded into the
+/// pack_mmt4d microkernel: it must pack a 2D tensor into [M, K, M0, K0] tiles
+/// without any transposition, pad with zeros if at all, and have no other use.
+static tensor::PackOp getPackOpFoldableIntoMmt4d(Value lhs) {
+  auto packOp = lhs.getDefiningOp<tensor::PackOp>();
+  if (!packOp || !lhs.hasOneUse()) {
+    return {};
+  }
+  if (packOp.getSourceType().getRank() != 2 ||
+      packOp.getInnerDimsPos() != ArrayRef<int64_t>{0, 1}) {
+    return {};
+  }
+  ArrayRef<int64_t> outerDimsPerm = packOp.getOuterDimsPerm();
+  if (!outerDimsPerm.empty() && outerDimsPerm != ArrayRef<int64_t>{0, 1}) {
+    return {};
+  }
+  Value paddingVal = packOp.getPaddingValue();
+  if (paddingVal && !matchPattern(paddingVal, m_Zero()) &&
+      !matchPattern(paddingVal, m_AnyZeroFloat())) {
+    return {};
+  }
+  return packOp;
+}
+
 /// Matches an (linalg.fill -> )? linalg.mmt4d operation sequence and converts
 /// it into a iree_codegen.ukernel.mmt4d operation, that is later lowered
 /// into a call to the microkernel.
+/// If the LHS is packed by a tensor.pack in the same dispatch, and the
+/// pack_mmt4d microkernel is enabled, the pack is folded into the call so that
+/// the packed LHS is never materialized: the microkernel packs one row panel
+/// at a time into a small local buffer instead.
 static FailureOr<IREE::Codegen::UKernelOpInterface>
 matchDAGForUKernel(RewriterBase &rewriter, linalg::Mmt4DOp op,
                    bool skipIntermediateRoundings) {
   auto targetAttr = IREE::HAL::ExecutableTargetAttr::lookup(op);
-  const char ukernelName[] = "mmt4d";
+  const char *ukernelName = "mmt4d";
   if (!hasUkernel(targetAttr, ukernelName)) {
     return failure();
   }
@@ -237,6 +265,17 @@ matchDAGForUKernel(RewriterBase &rewriter, linalg::Mmt4DOp op,
   Value m = rewriter.create<tensor::DimOp>(loc, lhs, 0);
   Value n = rewriter.create<tensor::DimOp>(loc, rhs, 0);
   Value k = rewriter.create<tensor::DimOp>(loc, rhs, 1);
+  Value packedLhs = lhs;
+  SmallVector<Value> lhsSizes;
+  tensor::PackOp lhsPackOp = getPackOpFoldableIntoMmt4d(lhs);
+  if (lhsPackOp && !isVMVXBackend(targetAttr) &&
+      hasUkernel(targetAttr, "pack_mmt4d")) {
+    ukernelName = "pack_mmt4d";
+    Value unpackedLhs = lhsPackOp.getSource();
+    lhsSizes.push_back(rewriter.create<tensor::DimOp>(loc, unpackedLhs, 0));
+    lhsSizes.push_back(rewriter.create<tensor::DimOp>(loc, unpackedLhs, 1));
+    lhs = unpackedLhs;
+  }
 
   auto getDimAsI32 = [](RewriterBase &rewriter, Location loc, Value value,
                         int dim) -> Value {
@@ -244,7 +283,7 @@ matchDAGForUKernel(RewriterBase &rewriter, linalg::Mmt4DOp op,
         loc, rewriter.getI32Type(),
         rewriter.create<tensor::DimOp>(loc, value, dim));
   };
-  Value m0 = getDimAsI32(rewriter, loc, lhs, 2);
+  Value m0 = getDimAsI32(rewriter, loc, packedLhs, 2);
   Value n0 = getDimAsI32(rewriter, loc, rhs, 2);
   Value k0 = getDimAsI32(rewriter, loc, rhs, 3);
   Value flagsVal = rewriter.create<arith::ConstantOp>(
@@ -257,15 +296,160 @@ matchDAGForUKernel(RewriterBase &rewriter, linalg::Mmt4DOp op,
     // bufferization.
     returnTypes.push_back(rewriter.getI32Type());
   }
+  SmallVector<Value> otherOperands(lhsSizes);
+  otherOperands.append({m, n, k, m0, n0, k0, flagsVal});
+  auto genericMicroKernelOp = rewriter.create<IREE::Codegen::UKernelGenericOp>(
+      loc, returnTypes, fn.name, ValueRange{lhs, rhs}, out, otherOperands,
+      /*fn_def_attrs=*/rewriter.getDictionaryAttr(fn.defAttrs),
+      /*strided_outer_dims=*/rewriter.getIndexAttr(1));
+  return cast<IREE::Codegen::UKernelOpInterface>(
+      genericMicroKernelOp.getOperation());
+}
+
+/// Matches a linalg.generic matmul dequantizing grouped i4 weights in its body
+/// (see getGroupedDequantMatmulOperands) and converts it into a
+/// iree_codegen.ukernel.generic op calling the mmt4d_dequant microkernel.
+/// The unpacked operands are passed as the M0 = N0 = 1 case of the microkernel,
+/// with the group splitting the reduction dimension into K x K0 tiles.
+static FailureOr<IREE::Codegen::UKernelOpInterface>
+matchGroupedDequantMatmulForUKernel(RewriterBase &rewriter,
+                                    linalg::GenericOp op) {
+  auto targetAttr = IREE::HAL::ExecutableTargetAttr::lookup(op);
+  const char ukernelName[] = "mmt4d_dequant";
+  if (!hasUkernel(targetAttr, ukernelName)) {
+    return failure();
+  }
+  FailureOr<GroupedDequantMatmulOperands> operands =
+      getGroupedDequantMatmulOperands(op);
+  if (failed(operands)) {
+    return rewriter.notifyMatchFailure(
+        op, "not a matmul of grouped dequantized weights");
+  }
+  uint32_t flags = IREE_UK_FLAG_MMT4D_DEQUANT_TYPE_F32U4F32;
+  Value out = operands->out;
+  if (isInitializedToZero(out)) {
+    if (auto fillOp = out.getDefiningOp<linalg::FillOp>()) {
+      out = fillOp.getDpsInitOperand(0)->get();
+    }
+  } else {
+    flags |= IREE_UK_FLAG_MMT4D_DEQUANT_ACCUMULATE;
+  }
+  flags |= IREE_UK_FLAG_MMT4D_DEQUANT_ALLOW_GENERIC_FALLBACK_TILE_FUNCTION;
+
+  // The vectorized tile functions consume 32 weights at a time, so split the
+  // groups in such K0-tiles whenever possible.
+  int64_t groupSize = operands->groupSize;
+  int64_t k0Size = groupSize % 32 == 0 ? 32 : groupSize;
+
+  Location loc = op.getLoc();
+  Value lhs = operands->lhs;
+  Value weights = operands->weights;
+  auto lhsType = llvm::cast<ShapedType>(lhs.getType());
+  auto outType = llvm::cast<ShapedType>(out.getType());
+  Value m = lhsType.getRank() == 3
+                ? rewriter.create<tensor::DimOp>(loc, lhs, 0).getResult()
+                : rewriter.create<arith::ConstantIndexOp>(loc, 1).getResult();
+  Value n = rewriter.create<tensor::DimOp>(loc, weights, 0);
+  Value k = rewriter.create<arith::MulIOp>(
+      loc, rewriter.create<tensor::DimOp>(loc, weights, 1),
+      rewriter.create<arith::ConstantIndexOp>(loc, groupSize / k0Size));
+  Value m0 = rewriter.create<arith::ConstantIntOp>(loc, 1, 32);
+  Value n0 = rewriter.create<arith::ConstantIntOp>(loc, 1, 32);
+  Value k0 = rewriter.create<arith::ConstantIntOp>(loc, k0Size, 32);
+  Value groupSizeVal =
+      rewriter.create<arith::ConstantIntOp>(loc, groupSize, 32);
+  Value flagsVal = rewriter.create<arith::ConstantOp>(
+      loc, rewriter.getI32IntegerAttr(flags));
+  auto fn = getFnNameAndDefAttrs(ukernelName, rewriter, targetAttr);
+  SmallVector<Type> returnTypes{outType};
+  if (!isVMVXBackend(targetAttr)) {
+    // Same void-returning function workaround as for mmt4d.
+    returnTypes.push_back(rewriter.getI32Type());
+  }
+  auto genericMicroKernelOp = rewriter.create<IREE::Codegen::UKernelGenericOp>(
+      loc, returnTypes, fn.name,
+      ValueRange{lhs, weights, operands->scales, operands->zeroPoints}, out,
+      ValueRange{m, n, k, m0, n0, k0, groupSizeVal, flagsVal},
+      /*fn_def_attrs=*/rewriter.getDictionaryAttr(fn.defAttrs),
+      /*strided_outer_dims=*/rewriter.getIndexAttr(1));
+  return cast<IREE::Codegen::UKernelOpInterface>(
+      genericMicroKernelOp.getOperation());
+}
+
+/// Matches a (linalg.fill -> )? linalg.generic M == 1 matmul on a packed RHS
+/// (see isPackedGemvOp) and converts it into a iree_codegen.ukernel.generic op
+/// calling the gemv microkernel.
+static FailureOr<IREE::Codegen::UKernelOpInterface>
+matchPackedGemvForUKernel(RewriterBase &rewriter, linalg::GenericOp op) {
+  auto targetAttr = IREE::HAL::ExecutableTargetAttr::lookup(op);
+  const char ukernelName[] = "gemv";
+  if (!hasUkernel(targetAttr, ukernelName)) {
+    return failure();
+  }
+  if (failed(isPackedGemvOp(op))) {
+    return rewriter.notifyMatchFailure(op, "not a gemv on a packed RHS");
+  }
+  Value lhs = op.getDpsInputOperand(0)->get();
+  Value rhs = op.getDpsInputOperand(1)->get();
+  Value out = op.getDpsInitOperand(0)->get();
+  Type lhsElemType = getElementTypeOrSelf(lhs);
+  uint32_t flags = 0;
+  if (lhsElemType.isF32()) {
+    flags = IREE_UK_FLAG_GEMV_TYPE_F32F32F32;
+  } else if (lhsElemType.isF16()) {
+    flags = IREE_UK_FLAG_GEMV_TYPE_F16F16F32;
+  } else if (lhsElemType.isBF16()) {
+    flags = IREE_UK_FLAG_GEMV_TYPE_BF16BF16F32;
+  } else {
+    return rewriter.notifyMatchFailure(op, "unsupported element types");
+  }
+  if (isInitializedToZero(out)) {
+    if (auto fillOp = out.getDefiningOp<linalg::FillOp>()) {
+      out = fillOp.getDpsInitOperand(0)->get();
+    }
+  } else {
+    flags |= IREE_UK_FLAG_GEMV_ACCUMULATE;
+  }
+
+  Location loc = op.getLoc();
+  auto outType = llvm::cast<ShapedType>(out.getType());
+  Value n = rewriter.create<tensor::DimOp>(loc, rhs, 0);
+  Value k = rewriter.create<tensor::DimOp>(loc, rhs, 1);
+  auto getDimAsI32 = [&](Value value, int64_t dim) -> Value {
+    return rewriter.create<arith::IndexCastOp>(
+        loc, rewriter.getI32Type(),
+        rewriter.create<tensor::DimOp>(loc, value, dim));
+  };
+  Value n0 = getDimAsI32(rhs, 2);
+  Value k0 = getDimAsI32(rhs, 3);
+  Value flagsVal = rewriter.create<arith::ConstantOp>(
+      loc, rewriter.getI32IntegerAttr(flags));
+  auto fn = getFnNameAndDefAttrs(ukernelName, rewriter, targetAttr);
+  SmallVector<Type> returnTypes{outType};
+  if (!isVMVXBackend(targetAttr)) {
+    // Same void-returning function workaround as for mmt4d.
+    returnTypes.push_back(rewriter.getI32Type());
+  }
   auto genericMicroKernelOp = rewriter.create<IREE::Codegen::UKernelGenericOp>(
       loc, returnTypes, fn.name, ValueRange{lhs, rhs}, out,
-      ValueRange{m, n, k, m0, n0, k0, flagsVal},
+      ValueRange{n, k, n0, k0, flagsVal},
       /*fn_def_attrs=*/rewriter.getDictionaryAttr(fn.defAttrs),
       /*strided_outer_dims=*/rewriter.getIndexAttr(1));
   return cast<IREE::Codegen::UKernelOpInterface>(
       genericMicroKernelOp.getOperation());
 }
 
+static FailureOr<IREE::Codegen::UKernelOpInterface>
+matchDAGForUKernel(RewriterBase &rewriter, linalg::GenericOp op,
+                   bool /*skipIntermediateRoundings*/) {
+  FailureOr<IREE::Codegen::UKernelOpInterface> ukernelOp =
+      matchPackedGemvForUKernel(rewriter, op);
+  if (succeeded(ukernelOp)) {
+    return ukernelOp;
+  }
+  return matchGroupedDequantMatmulForUKernel(rewriter, op);
+}
+
 static FailureOr<IREE::Codegen::UKernelOpInterface>
 matchDAGForUKernel(RewriterBase &rewriter, tensor::PackOp op,
                    bool /*skipIntermediateRoundings*/) {
@@ -473,6 +657,98 @@ matchDAGForUKernel(RewriterBase &rewriter, tensor::UnPackOp op,
       genericMicroKernelOp.getOperation());
 }
 
+/// Matches a 2-D linalg.softmax that isSoftmaxUKernelCandidate accepted and
+/// converts it into a call to the softmax microkernel. Higher-rank ops are
+/// first reduced to 2-D by CollapseSoftmaxUnitOuterDims.
+static FailureOr<IREE::Codegen::UKernelOpInterface>
+matchDAGForUKernel(RewriterBase &rewriter, linalg::SoftmaxOp op,
+                   bool /*skipIntermediateRoundings*/) {
+  auto targetAttr = IREE::HAL::ExecutableTargetAttr::lookup(op);
+  const char ukernelName[] = "softmax";
+  if (!isSoftmaxUKernelCandidate(op, targetAttr)) {
+    return rewriter.notifyMatchFailure(op, "not a softmax ukernel candidate");
+  }
+  if (op.getInputOperandRank() != 2) {
+    return rewriter.notifyMatchFailure(op, "expected input to be 2D");
+  }
+  Location loc = op.getLoc();
+  Value in = op.getInput();
+  Value out = op.getOutput();
+  Value size0 = rewriter.create<tensor::DimOp>(loc, in, 0);
+  Value size1 = rewriter.create<tensor::DimOp>(loc, in, 1);
+  uint32_t flags = IREE_UK_FLAG_SOFTMAX_TYPE_F32F32;
+  Value flagsVal = rewriter.create<arith::ConstantOp>(
+      loc, rewriter.getI32IntegerAttr(flags));
+  auto fn = getFnNameAndDefAttrs(ukernelName, rewriter, targetAttr);
+  auto genericMicroKernelOp = rewriter.create<IREE::Codegen::UKernelGenericOp>(
+      loc, out.getType(), fn.name, in, out, ValueRange{size0, size1, flagsVal},
+      /*fn_def_attrs=*/rewriter.getDictionaryAttr(fn.defAttrs),
+      /*strided_outer_dims=*/rewriter.getIndexAttr(1));
+  return cast<IREE::Codegen::UKernelOpInterface>(
+      genericMicroKernelOp.getOperation());
+}
+
+/// Matches an iree_linalg_ext.attention op that isAttentionUKernelCandidate
+/// accepted and converts it into a call to the attention microkernel, which
+/// runs the whole online-softmax loop over the key sequence.
+static FailureOr<IREE::Codegen::UKernelOpInterface>
+matchDAGForUKernel(RewriterBase &rewriter, IREE::LinalgExt::AttentionOp op,
+                   bool /*skipIntermediateRoundings*/) {
+  auto targetAttr = IREE::HAL::ExecutableTargetAttr::lookup(op);
+  const char ukernelName[] = "attention";
+  if (!isAttentionUKernelCandidate(op, targetAttr)) {
+    return rewriter.notifyMatchFailure(op,
+                                       "not an attention ukernel candidate");
+  }
+  if (!op.hasPureTensorSemantics()) {
+    return rewriter.notifyMatchFailure(op, "expected tensor semantics");
+  }
+  Type elementType = op.getQueryType().getElementType();
+  uint32_t flags = 0;
+  if (elementType.isF32()) {
+    flags = IREE_UK_FLAG_ATTENTION_TYPE_F32F32;
+  } else if (elementType.isF16()) {
+    flags = IREE_UK_FLAG_ATTENTION_TYPE_F16F16;
+  } else if (elementType.isBF16()) {
+    flags = IREE_UK_FLAG_ATTENTION_TYPE_BF16BF16;
+  } else {
+    return rewriter.notifyMatchFailure(op, "unhandled element type");
+  }
+  if (op.getTransposeV()) {
+    flags |= IREE_UK_FLAG_ATTENTION_TRANSPOSE_V;
+  }
+  Location loc = op.getLoc();
+  Value query = op.getQuery();
+  Value key = op.getKey();
+  Value value = op.getValue();
+  Value out = op.getOutput();
+  Value batch = rewriter.create<tensor::DimOp>(loc, query, 0);
+  Value m = rewriter.create<tensor::DimOp>(loc, query, 1);
+  Value k1 = rewriter.create<tensor::DimOp>(loc, query, 2);
+  Value k2 = rewriter.create<tensor::DimOp>(loc, key, 1);
+  Value n = rewriter.create<tensor::DimOp>(loc, out, 2);
+  // The ukernel takes the scale as a f32. The scale type is independent of the
+  // element type, so convert based on its own width.
+  Value scale = op.getScale();
+  FloatType scaleType = op.getScaleType();
+  Type f32Type = rewriter.getF32Type();
+  if (scaleType.getWidth() < 32) {
+    scale = rewriter.create<arith::ExtFOp>(loc, f32Type, scale);
+  } else if (scaleType.getWidth() > 32) {
+    scale = rewriter.create<arith::TruncFOp>(loc, f32Type, scale);
+  }
+  Value flagsVal = rewriter.create<arith::ConstantOp>(
+      loc, rewriter.getI32IntegerAttr(flags));
+  auto fn = getFnNameAndDefAttrs(ukernelName, rewriter, targetAttr);
+  auto genericMicroKernelOp = rewriter.create<IREE::Codegen::UKernelGenericOp>(
+      loc, out.getType(), fn.name, ValueRange{query, key, value}, out,
+      ValueRange{batch, m, k1, k2, n, scale, flagsVal},
+      /*fn_def_attrs=*/rewriter.getDictionaryAttr(fn.defAttrs),
+      /*strided_outer_dims=*/rewriter.getIndexAttr(2));
+  return cast<IREE::Codegen::UKernelOpInterface>(
+      genericMicroKernelOp.getOperation());
+}
+
 static uint32_t
 getFlagForUserAndOperandTypes(IREE::LinalgExt::EncodingAttr encoding,
                               ArrayRef<Attribute> operandTypes) {
@@ -596,6 +872,49 @@ struct LowerToUKernelPattern : OpRewritePattern<OpType> {
   bool skipIntermediateRoundings;
 };
 
+/// Collapses the outer dimensions of a softmax ukernel candidate into its row
+/// dimension. The outer dimensions are distributed with unit tile sizes (see
+/// KernelDispatch), so this only drops unit dimensions and the reshapes fold
+/// away at bufferization.
+struct CollapseSoftmaxUnitOuterDims : OpRewritePattern<linalg::SoftmaxOp> {
+  using OpRewritePattern<linalg::SoftmaxOp>::OpRewritePattern;
+
+  LogicalResult matchAndRewrite(linalg::SoftmaxOp op,
+                                PatternRewriter &rewriter) const override {
+    auto targetAttr = IREE::HAL::ExecutableTargetAttr::lookup(op);
+    if (!isSoftmaxUKernelCandidate(op, targetAttr)) {
+      return failure();
+    }
+    auto inType = llvm::cast<RankedTensorType>(op.getInput().getType());
+    auto outType = llvm::cast<RankedTensorType>(op.getOutput().getType());
+    int64_t rank = inType.getRank();
+    if (rank <= 2) {
+      return failure();
+    }
+    for (int64_t i = 0; i < rank - 2; ++i) {
+      if (inType.getDimSize(i) != 1 || outType.getDimSize(i) != 1) {
+        return rewriter.notifyMatchFailure(op, "expected unit outer dims");
+      }
+    }
+    Location loc = op.getLoc();
+    SmallVector<ReassociationIndices> reassociation(2);
+    for (int64_t i = 0; i < rank - 1; ++i) {
+      reassociation[0].push_back(i);
+    }
+    reassociation[1].push_back(rank - 1);
+    Value in = rewriter.create<tensor::CollapseShapeOp>(loc, op.getInput(),
+                                                        reassociation);
+    Value out = rewriter.create<tensor::CollapseShapeOp>(loc, op.getOutput(),
+                                                         reassociation);
+    auto softmaxOp = rewriter.create<linalg::SoftmaxOp>(
+        loc, TypeRange{out.getType()}, in, out, /*dimension=*/1);
+    rewriter.replaceOpWithNewOp<tensor::ExpandShapeOp>(
+        op, op.getResult()[0].getType(), softmaxOp.getResult()[0],
+        reassociation);
+    return success();
+  }
+};
+
 } // namespace
 
 void CPULowerToUKernelsPass::runOnOperation() {
@@ -616,6 +935,18 @@ void CPULowerToUKernelsPass::runOnOperation() {
   auto allTargets = [](auto target) { return true; };
   patterns.insert<LowerToUKernelPattern<linalg::Mmt4DOp>>(
       context, allTargets, skipIntermediateRoundings);
+  // The mmt4d_dequant and gemv microkernels have no VMVX counterparts.
+  patterns.insert<LowerToUKernelPattern<linalg::GenericOp>>(
+      context, [](auto target) { return !isVMVXBackend(target); });
+  // Only the softmax ops that DecomposeSoftmax left alone make it here, and
+  // those are LLVMCPU-specific (see isSoftmaxUKernelCandidate).
+  patterns.insert<CollapseSoftmaxUnitOuterDims>(context);
+  patterns.insert<LowerToUKernelPattern<linalg::SoftmaxOp>>(context,
+                                                            isLLVMCPUBackend);
+  // Likewise, only attention ops for which KernelDispatch picked the ukernel
+  // (see isAttentionUKernelCandidate) are converted.
+  patterns.insert<LowerToUKernelPattern<IREE::LinalgExt::AttentionOp>>(
+      context, isLLVMCPUBackend);
   // These patterns could in principle be used on LLVMCPU, not just VMVX, but
   // we choose not to, for two reasons:
   // 1. Codegen for these ops is thought to be good enough, that we do not
@@ -15,7 +15,9 @@
 #include "iree/compiler/Dialect/LinalgExt/IR/LinalgExtOps.h"
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/SmallVector.h"
+#include "llvm/Support/CommandLine.h"
 #include "llvm/Support/MathExtras.h"
+#include "llvm/Support/MemoryBuffer.h"
 #include "mlir/Dialect/Arith/IR/Arith.h"
 #include "mlir/Dialect/Linalg/IR/LinalgInterfaces.h"
 #include "mlir/Dialect/MemRef/Transforms/Transforms.h"
@@ -31,6 +33,134 @@ namespace mlir::iree_compiler {
 using namespace IREE::LinalgExt;
 using IREE::HAL::ExecutableTargetAttr;
 
+static llvm::cl::opt<std::string> clTileSizesCache(
+    "iree-llvmcpu-tile-sizes-cache",
+    llvm::cl::desc(
+        "path to a tile sizes cache written by the mmt4d_autotune tool. "
+        "Data-tiled matmuls using ukernels also consider the cached tiles "
+        "that the target CPU has the features for, and prefer the fastest "
+        "of them over the built-in choice. The tiles are fixed at compile "
+        "time: llvm-cpu executables do not consult the cache at runtime."),
+    llvm::cl::init(""));
+
+namespace {
+// A matmul tile from the tile sizes cache, see mmt4d_autotune.c for the format.
+struct TunedTileMxNxK {
+  std::string arch;
+  // LLVM names of the CPU features that the tile function requires.
+  SmallVector<std::string> features;
+  std::string types;
+  TileMxNxK tile;
+  // Throughput measured by the tool, to compare tiles by.
+  double rate = 0.0;
+};
+} // namespace
+
+static FailureOr<SmallVector<TunedTileMxNxK>>
+loadTileSizesCache(StringRef path) {
+  SmallVector<TunedTileMxNxK> result;
+  if (path.empty()) {
+    return result;
+  }
+  auto buffer = llvm::MemoryBuffer::getFile(path, /*IsText=*/true);
+  if (!buffer) {
+    return failure();
+  }
+  SmallVector<StringRef> lines;
+  (*buffer)->getBuffer().split(lines, '\n', /*MaxSplit=*/-1,
+                               /*KeepEmpty=*/false);
+  for (StringRef line : lines) {
+    line = line.trim();
+    if (line.empty() || line.starts_with("#")) {
+      continue;
+    }
+    SmallVector<StringRef> fields;
+    line.split(fields, ' ', /*MaxSplit=*/-1, /*KeepEmpty=*/false);
+    TunedTileMxNxK tuned;
+    if (fields.size() != 7 || fields[3].getAsInteger(10, tuned.tile.M) ||
+        fields[4].getAsInteger(10, tuned.tile.N) ||
+        fields[5].getAsInteger(10, tuned.tile.K) ||
+        fields[6].getAsDouble(tuned.rate) || tuned.tile.M <= 0 ||
+        tuned.tile.N <= 0 || tuned.tile.K <= 0) {
+      return failure();
+    }
+    tuned.arch = fields[0].str();
+    if (fields[1] != "-") {
+      SmallVector<StringRef> features;
+      fields[1].split(features, ',', /*MaxSplit=*/-1, /*KeepEmpty=*/false);
+      for (StringRef feature : features) {
+        tuned.features.push_back(feature.str());
+      }
+    }
+    tuned.types = fields[2].str();
+    result.push_back(tuned);
+  }
+  return result;
+}
+
+// Returns the contents of the --iree-llvmcpu-tile-sizes-cache file, loaded
+// once per process.
+static const FailureOr<SmallVector<TunedTileMxNxK>> &getTileSizesCache() {
+  static const FailureOr<SmallVector<TunedTileMxNxK>> cache =
+      loadTileSizesCache(clTileSizesCache);
+  return cache;
+}
+
+// Returns the element types of a matmul spelled as in the tile sizes cache,
+// e.g. "s8s8s32", or an empty string if they have no such spelling.
+static std::string getTileSizesCacheTypes(TypeRange elementTypes) {
+  std::string result;
+  llvm::raw_string_ostream os(result);
+  for (Type type : elementTypes) {
+    if (type.isF16() || type.isBF16() || type.isF32()) {
+      os << type;
+    } else if (auto intType = dyn_cast<IntegerType>(type)) {
+      os << (intType.isUnsigned() ? "u" : "s") << intType.getWidth();
+    } else {
+      return "";
+    }
+  }
+  return os.str();
+}
+
+// Appends to |tiles| the cached tiles for the given matmul element types that
+// the target CPU has all the features for, and their measured throughputs to
+// |rates|. The cache may have been written on a CPU with more features than
+// the target, e.g. when cross-compiling, so tiles are keyed by the features
+// that their tile function requires rather than only by architecture.
+static void appendTunedMatmulTiles(TypeRange elementTypes,
+                                   ExecutableTargetAttr target,
+                                   SmallVectorImpl<TileMxNxK> &tiles,
+                                   SmallVectorImpl<double> &rates) {
+  const auto &cache = getTileSizesCache();
+  if (failed(cache) || cache->empty() || elementTypes.size() != 3 ||
+      !hasUkernel(target, "mmt4d")) {
+    return;
+  }
+  // Spelled as IREE_ARCH in the runtime.
+  StringRef arch;
+  if (isX86_64(target)) {
+    arch = "x86_64";
+  } else if (isAArch64(target)) {
+    arch = "arm_64";
+  } else {
+    return;
+  }
+  std::string types = getTileSizesCacheTypes(elementTypes);
+  for (const TunedTileMxNxK &tuned : *cache) {
+    if (tuned.arch != arch || tuned.types != types) {
+      continue;
+    }
+    if (!llvm::all_of(tuned.features, [&](const std::string &feature) {
+          return hasFeature(target, "+" + feature);
+        })) {
+      continue;
+    }
+    tiles.push_back(tuned.tile);
+    rates.push_back(tuned.rate);
+  }
+}
+
 // Enumerate tile sizes to choose from when no specific architecture is
 // targeted. For narrow-{M,N} cases, this only enumerates on narrow M. The
 // narrow-N cases are handled by transposition in chooseMatmulTile.
@@ -157,6 +287,14 @@ enumerateMatmulTileArm64(TypeRange elementTypes, ExecutableTargetAttr target) {
     };
   }
 
+  if (hasUkernel(target) && lhs.isSignlessInteger(16) &&
+      rhs.isUnsignedInteger(4) && out.isSignlessInteger(32)) {
+    // Experimental s16u4s32 case. Focusing only on the vecmat case for now.
+    return {
+        TileMxNxK{1, 8, 8}, // Aim to use SDOT/UDOT or SMLAL.
+    };
+  }
+
   if (!hasUkernel(target)) {
     if (lhs.isSignlessInteger(8) && rhs.isSignlessInteger(8) &&
         (out.isSignlessInteger(32) || out.isF32())) {
@@ -291,6 +429,29 @@ enumerateMatmulTileX86_64(TypeRange elementTypes, ExecutableTargetAttr target) {
     };
   }
 
+  if (hasUkernel(target) && out.isSignlessInteger(32) &&
+      lhs.isSignlessInteger(8) && rhs.isSignlessInteger(4)) {
+    // The i4 RHS values are sign-extended to i16 in registers by the ukernels,
+    // so this uses the same tile shapes as the i8*i8 case.
+    if (hasFeature(target, "+avx512vnni") || hasFeature(target, "+avx512bw")) {
+      return {
+          TileMxNxK{16, 16, 2}, // Aim to use VPDPWSSD or VPMADDWD (zmm).
+          TileMxNxK{8, 16, 2},  // Truncation of the above.
+          TileMxNxK{4, 16, 2},  // Truncation of the above.
+          TileMxNxK{2, 16, 2},  // Truncation of the above.
+          TileMxNxK{1, 16, 2},  // Truncation of the above.
+      };
+    }
+    if (hasFeature(target, "+avx2")) {
+      return {
+          TileMxNxK{8, 8, 2}, // Aim to use VPMADDWD (ymm).
+          TileMxNxK{4, 8, 2}, // Truncation of the above.
+          TileMxNxK{2, 8, 2}, // Truncation of the above.
+          TileMxNxK{1, 8, 2}, // Truncation of the above.
+      };
+    }
+  }
+
   if (out.isSignlessInteger(32) && lhs.isSignlessInteger(16) &&
       rhs.isUnsignedInteger(4)) {
     // Experimental s16u4s32 case. Focusing only on the vecmat case for now.
@@ -299,19 +460,36 @@ enumerateMatmulTileX86_64(TypeRange elementTypes, ExecutableTargetAttr target) {
           TileMxNxK{1, 32, 8}, // Aim to use VPDPBUSD (zmm).
       };
     }
+    if (hasUkernel(target) && hasFeature(target, "+avx512bw")) {
+      return {
+          TileMxNxK{1, 32, 8}, // Aim to use VPMADDWD (zmm).
+      };
+    }
+    if (hasUkernel(target) && hasFeature(target, "+avx2")) {
+      return {
+          TileMxNxK{1, 16, 8}, // Aim to use VPMADDWD (ymm).
+      };
+    }
   }
 
   // Fallback - no architecture-optimized tile size for this case.
   return {};
 }
 
+// When |measuredRates| is not empty, it holds the measured throughput of each
+// of the |enumeratedTiles|, or 0 for tiles that were not measured. Among tiles
+// that minimize padding, higher measured throughput then takes precedence over
+// tile size.
 static TileMxNxK chooseMatmulTile(ArrayRef<TileMxNxK> enumeratedTiles,
-                                  int64_t matmulNarrowM,
-                                  int64_t matmulNarrowN) {
+                                  int64_t matmulNarrowM, int64_t matmulNarrowN,
+                                  ArrayRef<double> measuredRates = {}) {
+  assert(measuredRates.empty() ||
+         measuredRates.size() == enumeratedTiles.size());
   // Handle narrow-N by transposing to reduce to narrow-M. Note: the
   // enumeratedTiles currently only enumerate narrow-M cases.
   if (matmulNarrowN && (!matmulNarrowM || matmulNarrowN < matmulNarrowM)) {
-    TileMxNxK tile = chooseMatmulTile(enumeratedTiles, matmulNarrowN, 0);
+    TileMxNxK tile =
+        chooseMatmulTile(enumeratedTiles, matmulNarrowN, 0, measuredRates);
     std::swap(tile.M, tile.N);
     return tile;
   }
@@ -338,11 +516,13 @@ static TileMxNxK chooseMatmulTile(ArrayRef<TileMxNxK> enumeratedTiles,
     int64_t paddingPenalty = 0;
     // Favor larger tiles, as long as they still minimize paddingPenalty.
     int64_t productMxNxK = 0;
+    // Favor faster tiles when their speed is known, before the above.
+    double measuredRate = 0.0;
   };
   SmallVector<RatedTileMxNxK> ratedTiles;
   ratedTiles.reserve(enumeratedTiles.size());
   int64_t bestPaddingPenalty = INT64_MAX;
-  for (auto tile : enumeratedTiles) {
+  for (auto [index, tile] : llvm::enumerate(enumeratedTiles)) {
     RatedTileMxNxK ratedTile(tile);
     ratedTile.paddingPenalty = 0;
     // If we are choosing a tile for a narrow-M case, we want to minimize
@@ -358,15 +538,21 @@ static TileMxNxK chooseMatmulTile(ArrayRef<TileMxNxK> enumeratedTiles,
           std::max<int64_t>(tile.M - llvm::PowerOf2Ceil(matmulNarrowM), 0);
     }
     ratedTile.productMxNxK = tile.M * tile.N * tile.K;
+    if (!measuredRates.empty()) {
+      ratedTile.measuredRate = measuredRates[index];
+    }
     ratedTiles.push_back(ratedTile);
     bestPaddingPenalty = std::min(bestPaddingPenalty, ratedTile.paddingPenalty);
   }
   RatedTileMxNxK bestRatedTile;
   for (auto ratedTile : ratedTiles) {
     // Choose only among tiles that minimize paddingPenalty. Among those,
-    // maximize productMxNxK.
-    if (ratedTile.paddingPenalty == bestPaddingPenalty &&
-        bestRatedTile.productMxNxK < ratedTile.productMxNxK) {
+    // maximize measuredRate, then productMxNxK.
+    if (ratedTile.paddingPenalty != bestPaddingPenalty) {
+      continue;
+    }
+    if (std::make_pair(bestRatedTile.measuredRate, bestRatedTile.productMxNxK) <
+        std::make_pair(ratedTile.measuredRate, ratedTile.productMxNxK)) {
       bestRatedTile = ratedTile;
     }
   }
@@ -426,6 +612,29 @@ private:
   SmallVector<IREE::HAL::ExecutableTargetAttr, 4> targetAttrs;
 };
 
+// Returns true if a matmul with the given dimensions, element types and tile
+// is to be lowered to the gemv ukernel. That is the case of M == 1 matmuls with
+// a 1xN0x1 tile, for which packing the LHS is a plain copy of the vector, and
+// unpacking the result another: the gemv ukernel takes both in their original
+// layout instead, and only streams through the packed RHS.
+static bool isPackedGemvCandidate(ExecutableTargetAttr targetAttr,
+                                  const linalg::ContractionDimensions &cDims,
+                                  TypeRange elementTypes, int64_t matmulNarrowM,
+                                  TileMxNxK tile) {
+  if (isVMVXBackend(targetAttr) || !hasUkernel(targetAttr, "gemv")) {
+    return false;
+  }
+  if (matmulNarrowM != 1 || !cDims.batch.empty() || cDims.n.size() != 1 ||
+      tile.M != 1 || tile.K != 1 || ShapedType::isDynamic(tile.N)) {
+    return false;
+  }
+  Type lhs = elementTypes[0];
+  Type rhs = elementTypes[1];
+  Type out = elementTypes[2];
+  return out.isF32() && lhs == rhs &&
+         (lhs.isF32() || lhs.isF16() || lhs.isBF16());
+}
+
 FailureOr<MaterializeEncodingInfo>
 materializeEncodingForTarget(RankedTensorType tensorType,
                              ExecutableTargetAttr targetAttr) {
@@ -441,7 +650,9 @@ materializeEncodingForTarget(RankedTensorType tensorType,
       cDims->n.size() > 1 || cDims->k.size() > 1) {
     return failure();
   }
-  // Enumerate available tile shapes for the given encoding and target.
+  // Enumerate available tile shapes for the given encoding and target. Tiles
+  // tuned on a machine with the target's CPU features, if any were cached,
+  // are added to the built-in ones along with their measured throughput.
   auto elementTypes = llvm::to_vector(
       llvm::map_range(encoding.getElementTypes().getValue(), [](Attribute a) {
         return a.cast<TypeAttr>().getValue();
@@ -451,6 +662,15 @@ materializeEncodingForTarget(RankedTensorType tensorType,
   if (enumeratedTileMxNxK.empty()) {
     return failure();
   }
+  SmallVector<double> measuredRates;
+  appendTunedMatmulTiles(elementTypes, targetAttr, enumeratedTileMxNxK,
+                         measuredRates);
+  if (!measuredRates.empty()) {
+    // The built-in tiles were not measured.
+    measuredRates.insert(measuredRates.begin(),
+                         enumeratedTileMxNxK.size() - measuredRates.size(),
+                         0.0);
+  }
   // Check if the encoding specifies static narrow sizes for the M/N dimensions.
   // This can be used to choose a correspondingly narrow tile shape.
   // With microkernels, we keep this logic in sync with the set of actual
@@ -467,8 +687,15 @@ materializeEncodingForTarget(RankedTensorType tensorType,
                               : getIntOrZero(encoding.getMatmulNarrow_N());
   // Choose a final matmul TileMxNxK from the above-enumarated tile shapes,
   // taking narrow dimensions into account.
-  TileMxNxK chosenTileMxNxK =
-      chooseMatmulTile(enumeratedTileMxNxK, matmulNarrowM, matmulNarrowN);
+  TileMxNxK chosenTileMxNxK = chooseMatmulTile(
+      enumeratedTileMxNxK, matmulNarrowM, matmulNarrowN, measuredRates);
+  // Leave the LHS and result of M == 1 matmuls unpacked when the gemv ukernel
+  // can consume them as they are, see lowerContractionOpWithEncoding.
+  if (encoding.getRole().getValue() != EncodingRole::RHS &&
+      isPackedGemvCandidate(targetAttr, *cDims, elementTypes, matmulNarrowM,
+                            chosenTileMxNxK)) {
+    return failure();
+  }
   // Map the matmul TileMxNxK to an actual tile shape for the tensor at hand,
   // based on its role in the matmul.
   auto rank = tensorType.getRank();
@@ -558,6 +785,11 @@ void CPUMaterializeEncodingPass::runOnOperation() {
   RewritePatternSet materializeEncodingPattern(context);
   if (!targetAttr)
     targetAttr = ExecutableTargetAttr::lookup(operation);
+  if (failed(getTileSizesCache())) {
+    operation.emitOpError("failed to load tile sizes cache ")
+        << clTileSizesCache.getValue();
+    return signalPassFailure();
+  }
   auto materializeEncodingFn = getMaterializeEncodingFn(targetAttr);
   if (!materializeEncodingFn) {
     return signalPassFailure();
@@ -595,6 +827,11 @@ void CPUMaterializeUpperBoundTileSizePass::runOnOperation() {
     targetAttrs =
         IREE::HAL::DeviceTargetAttr::lookupExecutableTargets(operation);
   }
+  if (failed(getTileSizesCache())) {
+    operation.emitOpError("failed to load tile sizes cache ")
+        << clTileSizesCache.getValue();
+    return signalPassFailure();
+  }
   RewritePatternSet patterns(context);
   MaterializeEncodingFn materializeEncodingFn =
       getUpperBoundMaterializeEncodingFn(targetAttrs);
@@ -254,6 +254,319 @@ func.func @mmt4d_bf16bf16f32(%arg0 : tensor<?x?x16x2xbf16>, %arg1 : tensor<?x?x1
 
 // -----
 
+func.func @pack_mmt4d_f32f32f32(%arg0 : tensor<?x?xf32>, %arg1 : tensor<?x?x16x1xf32>,
+    %arg2 : tensor<?x?x16x1xf32>, %arg3 : tensor<?x?x16x16xf32>) -> tensor<?x?x16x16xf32> attributes {
+  hal.executable.target = #hal.executable.target<"llvm-cpu", "xyz", {ukernels = "all", target_triple="x86_64-xyz-xyz", cpu_features="+avx512f"}>
+} {
+  %cst = arith.constant 0.0 : f32
+  %pack = tensor.pack %arg0 padding_value(%cst : f32) inner_dims_pos = [0, 1] inner_tiles = [16, 1]
+      into %arg1 : tensor<?x?xf32> -> tensor<?x?x16x1xf32>
+  %0 = linalg.mmt4d ins(%pack, %arg2 : tensor<?x?x16x1xf32>, tensor<?x?x16x1xf32>)
+      outs(%arg3 : tensor<?x?x16x16xf32>) -> tensor<?x?x16x16xf32>
+  return %0 : tensor<?x?x16x16xf32>
+}
+// CHECK-LABEL: func @pack_mmt4d_f32f32f32(
+// CHECK-SAME:     %[[ARG0:[a-zA-Z0-9]+]]: tensor<?x?xf32>
+// CHECK-SAME:     %[[ARG1:[a-zA-Z0-9]+]]: tensor<?x?x16x1xf32>
+// CHECK-SAME:     %[[ARG2:[a-zA-Z0-9]+]]: tensor<?x?x16x1xf32>
+// CHECK-SAME:     %[[ARG3:[a-zA-Z0-9]+]]: tensor<?x?x16x16xf32>
+//  CHECK-DAG:   %[[FLAGS:.+]] = arith.constant {{[0-9]+}} : i32
+//  CHECK-DAG:   %[[C0:.+]] = arith.constant 0 : index
+//  CHECK-DAG:   %[[C1:.+]] = arith.constant 1 : index
+//  CHECK-DAG:   %[[C1_i32:.+]] = arith.constant 1 : i32
+//  CHECK-DAG:   %[[C16_i32:.+]] = arith.constant 16 : i32
+//  CHECK-DAG:   %[[LHS_SIZE0:.+]] = tensor.dim %[[ARG0]], %[[C0]]
+//  CHECK-DAG:   %[[LHS_SIZE1:.+]] = tensor.dim %[[ARG0]], %[[C1]]
+//  CHECK-DAG:   %[[M:.+]] = tensor.dim %[[ARG1]], %[[C0]]
+//  CHECK-DAG:   %[[N:.+]] = tensor.dim %[[ARG2]], %[[C0]]
+//  CHECK-DAG:   %[[K:.+]] = tensor.dim %[[ARG2]], %[[C1]]
+//  CHECK-NOT:   tensor.pack
+//      CHECK:   %[[MICRO_KERNEL:.+]]:2 = iree_codegen.ukernel.generic "iree_uk_pack_mmt4d"
+// CHECK-SAME:       ins(%[[ARG0]], %[[ARG2]] :
+// CHECK-SAME:       outs(%[[ARG3]] :
+// CHECK-SAME:       (%[[LHS_SIZE0]], %[[LHS_SIZE1]], %[[M]], %[[N]], %[[K]], %[[C16_i32]], %[[C16_i32]], %[[C1_i32]], %[[FLAGS]] :
+// CHECK-SAME:       strided_outer_dims(1)
+//      CHECK:   return %[[MICRO_KERNEL]]#0
+
+// -----
+
+func.func @pack_mmt4d_transpose_outer_not_folded(%arg0 : tensor<?x?xf32>, %arg1 : tensor<?x?x16x1xf32>,
+    %arg2 : tensor<?x?x16x1xf32>, %arg3 : tensor<?x?x16x16xf32>) -> tensor<?x?x16x16xf32> attributes {
+  hal.executable.target = #hal.executable.target<"llvm-cpu", "xyz", {ukernels = "all", target_triple="x86_64-xyz-xyz", cpu_features="+avx512f"}>
+} {
+  %pack = tensor.pack %arg0 outer_dims_perm = [1, 0] inner_dims_pos = [0, 1] inner_tiles = [16, 1]
+      into %arg1 : tensor<?x?xf32> -> tensor<?x?x16x1xf32>
+  %0 = linalg.mmt4d ins(%pack, %arg2 : tensor<?x?x16x1xf32>, tensor<?x?x16x1xf32>)
+      outs(%arg3 : tensor<?x?x16x16xf32>) -> tensor<?x?x16x16xf32>
+  return %0 : tensor<?x?x16x16xf32>
+}
+// CHECK-LABEL: func @pack_mmt4d_transpose_outer_not_folded(
+//       CHECK:   %[[PACK:.+]] = tensor.pack
+//       CHECK:   iree_codegen.ukernel.generic "iree_uk_mmt4d"
+//  CHECK-SAME:       ins(%[[PACK]],
+
+// -----
+
+func.func @grouped_dequant_matmul_f32u4f32(%arg0: tensor<11008x32x128xi4>, %arg1: tensor<32x128xf32>,
+    %arg2: tensor<11008x32xf32>, %arg3: tensor<11008x32xf32>) -> tensor<11008xf32> attributes {
+  hal.executable.target = #hal.executable.target<"llvm-cpu", "xyz", {ukernels = "all", target_triple="x86_64-xyz-xyz", cpu_features="+avx512f"}>
+} {
+  %cst = arith.constant 0.000000e+00 : f32
+  %0 = tensor.empty() : tensor<11008xf32>
+  %1 = linalg.fill ins(%cst : f32) outs(%0 : tensor<11008xf32>) -> tensor<11008xf32>
+  %2 = linalg.generic {
+      indexing_maps = [affine_map<(d0, d1, d2) -> (d1, d2)>,
+                       affine_map<(d0, d1, d2) -> (d0, d1, d2)>,
+                       affine_map<(d0, d1, d2) -> (d0, d1)>,
+                       affine_map<(d0, d1, d2) -> (d0, d1)>,
+                       affine_map<(d0, d1, d2) -> (d0)>],
+      iterator_types = ["parallel", "reduction", "reduction"]}
+      ins(%arg1, %arg0, %arg2, %arg3 : tensor<32x128xf32>, tensor<11008x32x128xi4>, tensor<11008x32xf32>, tensor<11008x32xf32>)
+      outs(%1 : tensor<11008xf32>) {
+  ^bb0(%in: f32, %in_0: i4, %in_1: f32, %in_2: f32, %out: f32):
+    %3 = arith.extui %in_0 : i4 to i32
+    %4 = arith.uitofp %3 : i32 to f32
+    %5 = arith.subf %4, %in_2 : f32
+    %6 = arith.mulf %5, %in_1 : f32
+    %7 = arith.mulf %in, %6 : f32
+    %8 = arith.addf %7, %out : f32
+    linalg.yield %8 : f32
+  } -> tensor<11008xf32>
+  return %2 : tensor<11008xf32>
+}
+// CHECK-LABEL: func @grouped_dequant_matmul_f32u4f32(
+// CHECK-SAME:     %[[WEIGHTS:[a-zA-Z0-9]+]]: tensor<11008x32x128xi4>
+// CHECK-SAME:     %[[LHS:[a-zA-Z0-9]+]]: tensor<32x128xf32>
+// CHECK-SAME:     %[[SCALES:[a-zA-Z0-9]+]]: tensor<11008x32xf32>
+// CHECK-SAME:     %[[ZPS:[a-zA-Z0-9]+]]: tensor<11008x32xf32>
+//  CHECK-DAG:   %[[FLAGS:.+]] = arith.constant 513 : i32
+//  CHECK-DAG:   %[[C1:.+]] = arith.constant 1 : index
+//  CHECK-DAG:   %[[C128:.+]] = arith.constant 128 : index
+//  CHECK-DAG:   %[[C11008:.+]] = arith.constant 11008 : index
+//  CHECK-DAG:   %[[C1_i32:.+]] = arith.constant 1 : i32
+//  CHECK-DAG:   %[[C32_i32:.+]] = arith.constant 32 : i32
+//  CHECK-DAG:   %[[C128_i32:.+]] = arith.constant 128 : i32
+//  CHECK-DAG:   %[[EMPTY:.+]] = tensor.empty() : tensor<11008xf32>
+//      CHECK:   %[[MICRO_KERNEL:.+]]:2 = iree_codegen.ukernel.generic "iree_uk_mmt4d_dequant"
+// CHECK-SAME:       ins(%[[LHS]], %[[WEIGHTS]], %[[SCALES]], %[[ZPS]] :
+// CHECK-SAME:       outs(%[[EMPTY]] :
+// CHECK-SAME:       (%[[C1]], %[[C11008]], %[[C128]], %[[C1_i32]], %[[C1_i32]], %[[C32_i32]], %[[C128_i32]], %[[FLAGS]] :
+//      CHECK:   return %[[MICRO_KERNEL]]#0
+
+// -----
+
+func.func @packed_gemv_f16f16f32(%arg0: tensor<?x1xf16>, %arg1: tensor<?x?x16x1xf16>,
+    %arg2: tensor<?x16xf32>) -> tensor<?x16xf32> attributes {
+  hal.executable.target = #hal.executable.target<"llvm-cpu", "xyz", {ukernels = "gemv", target_triple="x86_64-xyz-xyz", cpu_features="+avx512f"}>
+} {
+  %0 = linalg.generic {
+      indexing_maps = [affine_map<(d0, d1, d2, d3) -> (d2, d3)>,
+                       affine_map<(d0, d1, d2, d3) -> (d0, d2, d1, d3)>,
+                       affine_map<(d0, d1, d2, d3) -> (d0, d1)>],
+      iterator_types = ["parallel", "parallel", "reduction", "reduction"]}
+      ins(%arg0, %arg1 : tensor<?x1xf16>, tensor<?x?x16x1xf16>)
+      outs(%arg2 : tensor<?x16xf32>) {
+  ^bb0(%in: f16, %in_0: f16, %out: f32):
+    %1 = arith.extf %in : f16 to f32
+    %2 = arith.extf %in_0 : f16 to f32
+    %3 = arith.mulf %1, %2 : f32
+    %4 = arith.addf %3, %out : f32
+    linalg.yield %4 : f32
+  } -> tensor<?x16xf32>
+  return %0 : tensor<?x16xf32>
+}
+//      CHECK: func @packed_gemv_f16f16f32(
+// CHECK-SAME:     %[[LHS:[a-zA-Z0-9]+]]: tensor<?x1xf16>
+// CHECK-SAME:     %[[RHS:[a-zA-Z0-9]+]]: tensor<?x?x16x1xf16>
+// CHECK-SAME:     %[[OUT:[a-zA-Z0-9]+]]: tensor<?x16xf32>
+//  CHECK-DAG:   %[[C0:.+]] = arith.constant 0 : index
+//  CHECK-DAG:   %[[C1:.+]] = arith.constant 1 : index
+//  CHECK-DAG:   %[[C1_i32:.+]] = arith.constant 1 : i32
+//  CHECK-DAG:   %[[C16_i32:.+]] = arith.constant 16 : i32
+//  CHECK-DAG:   %[[FLAGS:.+]] = arith.constant 258 : i32
+//  CHECK-DAG:   %[[N:.+]] = tensor.dim %[[RHS]], %[[C0]]
+//  CHECK-DAG:   %[[K:.+]] = tensor.dim %[[RHS]], %[[C1]]
+//      CHECK:   %[[MICRO_KERNEL:.+]]:2 = iree_codegen.ukernel.generic "iree_uk_gemv"
+// CHECK-SAME:       ins(%[[LHS]], %[[RHS]] :
+// CHECK-SAME:       outs(%[[OUT]] :
+// CHECK-SAME:       (%[[N]], %[[K]], %[[C16_i32]], %[[C1_i32]], %[[FLAGS]] :
+// CHECK-SAME:       strided_outer_dims(1)
+//      CHECK:   return %[[MICRO_KERNEL]]#0
+
+// -----
+
+func.func @softmax_f32(%arg0 : tensor<?x?xf32>, %arg1 : tensor<?x?xf32>) -> tensor<?x?xf32> attributes {
+  hal.executable.target = #hal.executable.target<"llvm-cpu", "xyz", {ukernels = "softmax", target_triple="x86_64-xyz-xyz"}>
+} {
+  %0 = linalg.softmax dimension(1) ins(%arg0 : tensor<?x?xf32>) outs(%arg1 : tensor<?x?xf32>) -> tensor<?x?xf32>
+  func.return %0 : tensor<?x?xf32>
+}
+//      CHECK: func @softmax_f32(
+// CHECK-SAME:     %[[ARG0:[a-zA-Z0-9]+]]: tensor<?x?xf32>
+// CHECK-SAME:     %[[ARG1:[a-zA-Z0-9]+]]: tensor<?x?xf32>
+//  CHECK-DAG:   %[[C0:.+]] = arith.constant 0 : index
+//  CHECK-DAG:   %[[C1:.+]] = arith.constant 1 : index
+//  CHECK-DAG:   %[[FLAGS:.+]] = arith.constant 1 : i32
+//  CHECK-DAG:   %[[SIZE0:.+]] = tensor.dim %[[ARG0]], %[[C0]]
+//  CHECK-DAG:   %[[SIZE1:.+]] = tensor.dim %[[ARG0]], %[[C1]]
+//      CHECK:   %[[MICRO_KERNEL:.+]] = iree_codegen.ukernel.generic "iree_uk_softmax"
+// CHECK-SAME:       ins(%[[ARG0]] :
+// CHECK-SAME:       outs(%[[ARG1]] :
+// CHECK-SAME:       (%[[SIZE0]], %[[SIZE1]], %[[FLAGS]] :
+// CHECK-SAME:       strided_outer_dims(1)
+//      CHECK:   return %[[MICRO_KERNEL]]
+
+// -----
+
+func.func @softmax_f32_unit_outer_dims(%arg0 : tensor<1x16x128xf32>, %arg1 : tensor<1x16x128xf32>) -> tensor<1x16x128xf32> attributes {
+  hal.executable.target = #hal.executable.target<"llvm-cpu", "xyz", {ukernels = "all", target_triple="x86_64-xyz-xyz"}>
+} {
+  %0 = linalg.softmax dimension(2) ins(%arg0 : tensor<1x16x128xf32>) outs(%arg1 : tensor<1x16x128xf32>) -> tensor<1x16x128xf32>
+  func.return %0 : tensor<1x16x128xf32>
+}
+//      CHECK: func @softmax_f32_unit_outer_dims(
+// CHECK-SAME:     %[[ARG0:[a-zA-Z0-9]+]]: tensor<1x16x128xf32>
+// CHECK-SAME:     %[[ARG1:[a-zA-Z0-9]+]]: tensor<1x16x128xf32>
+//  CHECK-DAG:   %[[IN:.+]] = tensor.collapse_shape %[[ARG0]] {{\[}}[0, 1], [2]{{\]}}
+//  CHECK-DAG:   %[[OUT:.+]] = tensor.collapse_shape %[[ARG1]] {{\[}}[0, 1], [2]{{\]}}
+//      CHECK:   %[[MICRO_KERNEL:.+]] = iree_codegen.ukernel.generic "iree_uk_softmax"
+// CHECK-SAME:       ins(%[[IN]] : tensor<16x128xf32>)
+// CHECK-SAME:       outs(%[[OUT]] : tensor<16x128xf32>)
+//      CHECK:   %[[RESULT:.+]] = tensor.expand_shape %[[MICRO_KERNEL]] {{\[}}[0, 1], [2]{{\]}}
+//      CHECK:   return %[[RESULT]]
+
+// -----
+
+// Softmax over an outer dimension has no microkernel.
+func.func @softmax_f32_outer_dim(%arg0 : tensor<?x?xf32>, %arg1 : tensor<?x?xf32>) -> tensor<?x?xf32> attributes {
+  hal.executable.target = #hal.executable.target<"llvm-cpu", "xyz", {ukernels = "all", target_triple="x86_64-xyz-xyz"}>
+} {
+  %0 = linalg.softmax dimension(0) ins(%arg0 : tensor<?x?xf32>) outs(%arg1 : tensor<?x?xf32>) -> tensor<?x?xf32>
+  func.return %0 : tensor<?x?xf32>
+}
+//      CHECK: func @softmax_f32_outer_dim(
+//      CHECK:   linalg.softmax
+//  CHECK-NOT:   iree_codegen.ukernel.generic
+
+// -----
+
+func.func @attention_f32(%query : tensor<2x128x64xf32>, %key : tensor<2x1024x64xf32>, %value : tensor<2x1024x32xf32>, %scale : f32, %out : tensor<2x128x32xf32>) -> tensor<2x128x32xf32> attributes {
+  hal.executable.target = #hal.executable.target<"llvm-cpu", "xyz", {ukernels = "attention", target_triple="x86_64-xyz-xyz"}>
+} {
+  %0 = iree_linalg_ext.attention ins(%query, %key, %value, %scale : tensor<2x128x64xf32>, tensor<2x1024x64xf32>, tensor<2x1024x32xf32>, f32) outs(%out : tensor<2x128x32xf32>) -> tensor<2x128x32xf32>
+  func.return %0 : tensor<2x128x32xf32>
+}
+//      CHECK: func @attention_f32(
+// CHECK-SAME:     %[[QUERY:[a-zA-Z0-9]+]]: tensor<2x128x64xf32>
+// CHECK-SAME:     %[[KEY:[a-zA-Z0-9]+]]: tensor<2x1024x64xf32>
+// CHECK-SAME:     %[[VALUE:[a-zA-Z0-9]+]]: tensor<2x1024x32xf32>
+// CHECK-SAME:     %[[SCALE:[a-zA-Z0-9]+]]: f32
+// CHECK-SAME:     %[[OUT:[a-zA-Z0-9]+]]: tensor<2x128x32xf32>
+//  CHECK-DAG:   %[[BATCH:.+]] = arith.constant 2 : index
+//  CHECK-DAG:   %[[M:.+]] = arith.constant 128 : index
+//  CHECK-DAG:   %[[K1:.+]] = arith.constant 64 : index
+//  CHECK-DAG:   %[[K2:.+]] = arith.constant 1024 : index
+//  CHECK-DAG:   %[[N:.+]] = arith.constant 32 : index
+//  CHECK-DAG:   %[[FLAGS:.+]] = arith.constant 1 : i32
+//      CHECK:   %[[MICRO_KERNEL:.+]] = iree_codegen.ukernel.generic "iree_uk_attention"
+// CHECK-SAME:       ins(%[[QUERY]], %[[KEY]], %[[VALUE]] :
+// CHECK-SAME:       outs(%[[OUT]] :
+// CHECK-SAME:       (%[[BATCH]], %[[M]], %[[K1]], %[[K2]], %[[N]], %[[SCALE]], %[[FLAGS]] :
+// CHECK-SAME:       strided_outer_dims(2)
+//      CHECK:   return %[[MICRO_KERNEL]]
+
+// -----
+
+func.func @attention_f16_transpose_v(%query : tensor<1x64x64xf16>, %key : tensor<1x256x64xf16>, %value : tensor<1x64x256xf16>, %scale : f16, %out : tensor<1x64x64xf16>) -> tensor<1x64x64xf16> attributes {
+  hal.executable.target = #hal.executable.target<"llvm-cpu", "xyz", {ukernels = "all", target_triple="x86_64-xyz-xyz"}>
+} {
+  %0 = iree_linalg_ext.attention {transpose_v = true} ins(%query, %key, %value, %scale : tensor<1x64x64xf16>, tensor<1x256x64xf16>, tensor<1x64x256xf16>, f16) outs(%out : tensor<1x64x64xf16>) -> tensor<1x64x64xf16>
+  func.return %0 : tensor<1x64x64xf16>
+}
+//      CHECK: func @attention_f16_transpose_v(
+// CHECK-SAME:     %[[SCALE:[a-zA-Z0-9]+]]: f16
+//  CHECK-DAG:   %[[FLAGS:.+]] = arith.constant 258 : i32
+//  CHECK-DAG:   %[[SCALE_F32:.+]] = arith.extf %[[SCALE]] : f16 to f32
+//      CHECK:   iree_codegen.ukernel.generic "iree_uk_attention"
+// CHECK-SAME:       %[[SCALE_F32]], %[[FLAGS]] :
+
+// -----
+
+// The scale type is independent of the element type: a f32 scale is passed
+// through as is, even with f16 or bf16 query/key/value.
+func.func @attention_f16_f32_scale(%query : tensor<1x64x64xf16>, %key : tensor<1x256x64xf16>, %value : tensor<1x256x64xf16>, %scale : f32, %out : tensor<1x64x64xf16>) -> tensor<1x64x64xf16> attributes {
+  hal.executable.target = #hal.executable.target<"llvm-cpu", "xyz", {ukernels = "all", target_triple="x86_64-xyz-xyz"}>
+} {
+  %0 = iree_linalg_ext.attention ins(%query, %key, %value, %scale : tensor<1x64x64xf16>, tensor<1x256x64xf16>, tensor<1x256x64xf16>, f32) outs(%out : tensor<1x64x64xf16>) -> tensor<1x64x64xf16>
+  func.return %0 : tensor<1x64x64xf16>
+}
+//      CHECK: func @attention_f16_f32_scale(
+// CHECK-SAME:     %[[SCALE:[a-zA-Z0-9]+]]: f32
+//  CHECK-DAG:   %[[FLAGS:.+]] = arith.constant 2 : i32
+//      CHECK:   iree_codegen.ukernel.generic "iree_uk_attention"
+// CHECK-SAME:       %[[SCALE]], %[[FLAGS]] :
+
+// -----
+
+func.func @attention_bf16_f32_scale(%query : tensor<1x64x64xbf16>, %key : tensor<1x256x64xbf16>, %value : tensor<1x256x64xbf16>, %scale : f32, %out : tensor<1x64x64xbf16>) -> tensor<1x64x64xbf16> attributes {
+  hal.executable.target = #hal.executable.target<"llvm-cpu", "xyz", {ukernels = "all", target_triple="x86_64-xyz-xyz"}>
+} {
+  %0 = iree_linalg_ext.attention ins(%query, %key, %value, %scale : tensor<1x64x64xbf16>, tensor<1x256x64xbf16>, tensor<1x256x64xbf16>, f32) outs(%out : tensor<1x64x64xbf16>) -> tensor<1x64x64xbf16>
+  func.return %0 : tensor<1x64x64xbf16>
+}
+//      CHECK: func @attention_bf16_f32_scale(
+// CHECK-SAME:     %[[SCALE:[a-zA-Z0-9]+]]: f32
+//  CHECK-DAG:   %[[FLAGS:.+]] = arith.constant 3 : i32
+//      CHECK:   iree_codegen.ukernel.generic "iree_uk_attention"
+// CHECK-SAME:       %[[SCALE]], %[[FLAGS]] :
+
+// -----
+
+// A narrower scale is extended to f32 even with f32 query/key/value.
+func.func @attention_f32_f16_scale(%query : tensor<1x64x64xf32>, %key : tensor<1x256x64xf32>, %value : tensor<1x256x64xf32>, %scale : f16, %out : tensor<1x64x64xf32>) -> tensor<1x64x64xf32> attributes {
+  hal.executable.target = #hal.executable.target<"llvm-cpu", "xyz", {ukernels = "all", target_triple="x86_64-xyz-xyz"}>
+} {
+  %0 = iree_linalg_ext.attention ins(%query, %key, %value, %scale : tensor<1x64x64xf32>, tensor<1x256x64xf32>, tensor<1x256x64xf32>, f16) outs(%out : tensor<1x64x64xf32>) -> tensor<1x64x64xf32>
+  func.return %0 : tensor<1x64x64xf32>
+}
+//      CHECK: func @attention_f32_f16_scale(
+// CHECK-SAME:     %[[SCALE:[a-zA-Z0-9]+]]: f16
+//  CHECK-DAG:   %[[FLAGS:.+]] = arith.constant 1 : i32
+//  CHECK-DAG:   %[[SCALE_F32:.+]] = arith.extf %[[SCALE]] : f16 to f32
+//      CHECK:   iree_codegen.ukernel.generic "iree_uk_attention"
+// CHECK-SAME:       %[[SCALE_F32]], %[[FLAGS]] :
+
+// -----
+
+// A wider scale is truncated to f32.
+func.func @attention_f16_f64_scale(%query : tensor<1x64x64xf16>, %key : tensor<1x256x64xf16>, %value : tensor<1x256x64xf16>, %scale : f64, %out : tensor<1x64x64xf16>) -> tensor<1x64x64xf16> attributes {
+  hal.executable.target = #hal.executable.target<"llvm-cpu", "xyz", {ukernels = "all", target_triple="x86_64-xyz-xyz"}>
+} {
+  %0 = iree_linalg_ext.attention ins(%query, %key, %value, %scale : tensor<1x64x64xf16>, tensor<1x256x64xf16>, tensor<1x256x64xf16>, f64) outs(%out : tensor<1x64x64xf16>) -> tensor<1x64x64xf16>
+  func.return %0 : tensor<1x64x64xf16>
+}
+//      CHECK: func @attention_f16_f64_scale(
+// CHECK-SAME:     %[[SCALE:[a-zA-Z0-9]+]]: f64
+//  CHECK-DAG:   %[[FLAGS:.+]] = arith.constant 2 : i32
+//  CHECK-DAG:   %[[SCALE_F32:.+]] = arith.truncf %[[SCALE]] : f64 to f32
+//      CHECK:   iree_codegen.ukernel.generic "iree_uk_attention"
+// CHECK-SAME:       %[[SCALE_F32]], %[[FLAGS]] :
+
+// -----
+
+// Attention ops with dynamic shapes are not lowered to the microkernel.
+func.func @attention_f32_dynamic(%query : tensor<?x?x64xf32>, %key : tensor<?x?x64xf32>, %value : tensor<?x?x64xf32>, %scale : f32, %out : tensor<?x?x64xf32>) -> tensor<?x?x64xf32> attributes {
+  hal.executable.target = #hal.executable.target<"llvm-cpu", "xyz", {ukernels = "all", target_triple="x86_64-xyz-xyz"}>
+} {
+  %0 = iree_linalg_ext.attention ins(%query, %key, %value, %scale : tensor<?x?x64xf32>, tensor<?x?x64xf32>, tensor<?x?x64xf32>, f32) outs(%out : tensor<?x?x64xf32>) -> tensor<?x?x64xf32>
+  func.return %0 : tensor<?x?x64xf32>
+}
+//      CHECK: func @attention_f32_dynamic(
+//      CHECK:   iree_linalg_ext.attention
+//  CHECK-NOT:   iree_codegen.ukernel.generic
+
+// -----
+
 // Check that tensor.pack is not lowered to a microkernel by default - it should
 // only be on VMVX.
 // CHECK-LABEL: func @pack_i8i8_default(
@@ -6,6 +6,7 @@
 
 #include "iree/compiler/Codegen/Common/PassDetail.h"
 #include "iree/compiler/Codegen/Common/Passes.h"
+#include "iree/compiler/Codegen/Utils/Utils.h"
 #include "mlir/Dialect/Arith/IR/Arith.h"
 #include "mlir/Dialect/Linalg/IR/Linalg.h"
 #include "mlir/Dialect/Linalg/Transforms/Transforms.h"
@@ -39,7 +40,12 @@ static LogicalResult convertSoftmaxToGenerics(mlir::FunctionOpInterface funcOp,
   IRRewriter rewriter(funcOp.getContext());
   SmallVector<Operation *> toDelete;
   SmallVector<Operation *> softmaxOpsToDecompose;
+  auto targetAttr = IREE::HAL::ExecutableTargetAttr::lookup(funcOp);
   funcOp.walk([&](linalg::SoftmaxOp softmaxOp) {
+    // Ops that are going to be lowered to the softmax ukernel are left alone.
+    if (isSoftmaxUKernelCandidate(softmaxOp, targetAttr)) {
+      return;
+    }
     softmaxOpsToDecompose.push_back(softmaxOp);
   });
 
@@ -171,6 +171,155 @@ Value getMmt4dOperand(Value value, linalg::LinalgOp linalgOp,
   return expandedValue;
 }
 
+/// Returns the single row of the M == 1 matmul operand `value`, as a 1-D tensor
+/// of `size` elements, given the position `mPos` of its M dimension, if any.
+static Value extractGemvVector(RewriterBase &rewriter, Location loc,
+                               Value value, std::optional<unsigned> mPos,
+                               OpFoldResult size) {
+  auto type = cast<RankedTensorType>(value.getType());
+  int64_t staticSize = getConstantIntValue(size).value_or(ShapedType::kDynamic);
+  auto vectorType = RankedTensorType::get({staticSize}, type.getElementType());
+  SmallVector<OpFoldResult> offsets(type.getRank(), rewriter.getIndexAttr(0));
+  SmallVector<OpFoldResult> sizes(type.getRank(), size);
+  SmallVector<OpFoldResult> strides(type.getRank(), rewriter.getIndexAttr(1));
+  if (mPos) {
+    sizes[*mPos] = rewriter.getIndexAttr(1);
+  }
+  return rewriter.create<tensor::ExtractSliceOp>(loc, vectorType, value,
+                                                 offsets, sizes, strides);
+}
+
+/// Lowers a M == 1 contraction whose RHS is packed while its LHS and result
+/// are not (see materializeEncodingForTarget) to the linalg.generic matched by
+/// isPackedGemvOp:
+///   out[N1, N0] += lhs[K1, K0] * rhs[N1, K1, N0, K0]
+/// The result is padded to a multiple of N0 for the duration of the op.
+static FailureOr<Operation *>
+lowerContractionOpToPackedGemv(RewriterBase &rewriter,
+                               linalg::LinalgOp linalgOp, ValueRange operands) {
+  auto cDims = linalg::inferContractionDims(linalgOp);
+  if (failed(cDims) || !cDims->batch.empty() || cDims->m.size() > 1 ||
+      cDims->n.size() != 1 || cDims->k.size() != 1) {
+    return failure();
+  }
+  Value lhs = operands[0];
+  Value rhs = operands[1];
+  Value out = operands[2];
+  auto rhsType = cast<RankedTensorType>(rhs.getType());
+  auto outType = cast<RankedTensorType>(out.getType());
+  if (rhsType.getRank() != 4 || rhsType.isDynamicDim(2) ||
+      rhsType.isDynamicDim(3)) {
+    return failure();
+  }
+  MLIRContext *ctx = rewriter.getContext();
+  auto getMPos = [&](OpOperand *operand) -> std::optional<unsigned> {
+    if (cDims->m.empty()) {
+      return std::nullopt;
+    }
+    return linalgOp.getMatchingIndexingMap(operand).getResultPosition(
+        getAffineDimExpr(cDims->m[0], ctx));
+  };
+  std::optional<unsigned> lhsMPos = getMPos(linalgOp.getDpsInputOperand(0));
+  std::optional<unsigned> outMPos = getMPos(linalgOp.getDpsInitOperand(0));
+  unsigned outNPos =
+      *linalgOp.getMatchingIndexingMap(linalgOp.getDpsInitOperand(0))
+           .getResultPosition(getAffineDimExpr(cDims->n[0], ctx));
+
+  Location loc = linalgOp.getLoc();
+  int64_t n0 = rhsType.getDimSize(2);
+  int64_t k0 = rhsType.getDimSize(3);
+  AffineExpr s0, s1;
+  bindSymbols(ctx, s0, s1);
+  OpFoldResult n1Size = tensor::getMixedSize(rewriter, loc, rhs, 0);
+  OpFoldResult k1Size = tensor::getMixedSize(rewriter, loc, rhs, 1);
+  // The LHS may have been padded beyond K1 * K0 for another target, only the
+  // part that the RHS covers is used.
+  OpFoldResult kSize =
+      affine::makeComposedFoldedAffineApply(rewriter, loc, s0 * k0, {k1Size});
+  OpFoldResult nSize = tensor::getMixedSize(rewriter, loc, out, outNPos);
+  OpFoldResult paddedNSize =
+      affine::makeComposedFoldedAffineApply(rewriter, loc, s0 * n0, {n1Size});
+
+  // LHS: [K] -> [K1, K0].
+  Value lhsVector = extractGemvVector(rewriter, loc, lhs, lhsMPos, kSize);
+  auto lhsVectorType = cast<RankedTensorType>(lhsVector.getType());
+  auto newLhsType = RankedTensorType::get(
+      {getConstantIntValue(k1Size).value_or(ShapedType::kDynamic), k0},
+      lhsVectorType.getElementType());
+  SmallVector<ReassociationIndices> ri = {{0, 1}};
+  Value newLhs =
+      rewriter.create<tensor::ExpandShapeOp>(loc, newLhsType, lhsVector, ri);
+
+  // Result: [N] -> padded to [N1 * N0] -> [N1, N0].
+  Value outVector = extractGemvVector(rewriter, loc, out, outMPos, nSize);
+  bool needsPadding = !isEqualConstantIntOrValue(nSize, paddedNSize);
+  Value paddedOutVector = outVector;
+  if (needsPadding) {
+    OpFoldResult highPad = affine::makeComposedFoldedAffineApply(
+        rewriter, loc, s0 - s1, {paddedNSize, nSize});
+    Type elemType = outType.getElementType();
+    Value zero = rewriter.create<arith::ConstantOp>(
+        loc, elemType, rewriter.getZeroAttr(elemType));
+    paddedOutVector = rewriter.create<tensor::PadOp>(
+        loc, /*resultType=*/nullptr, outVector,
+        ArrayRef<OpFoldResult>{rewriter.getIndexAttr(0)},
+        ArrayRef<OpFoldResult>{highPad}, zero);
+  }
+  auto newOutType = RankedTensorType::get(
+      {getConstantIntValue(n1Size).value_or(ShapedType::kDynamic), n0},
+      outType.getElementType());
+  Value newOut = rewriter.create<tensor::ExpandShapeOp>(loc, newOutType,
+                                                        paddedOutVector, ri);
+
+  AffineExpr d0, d1, d2, d3;
+  bindDims(ctx, d0, d1, d2, d3);
+  SmallVector<AffineMap> maps = {
+      AffineMap::get(4, 0, {d2, d3}, ctx),
+      AffineMap::get(4, 0, {d0, d2, d1, d3}, ctx),
+      AffineMap::get(4, 0, {d0, d1}, ctx),
+  };
+  SmallVector<utils::IteratorType> iteratorTypes = {
+      utils::IteratorType::parallel, utils::IteratorType::parallel,
+      utils::IteratorType::reduction, utils::IteratorType::reduction};
+  Type outElemType = outType.getElementType();
+  auto gemvOp = rewriter.create<linalg::GenericOp>(
+      loc, newOutType, ValueRange{newLhs, rhs}, ValueRange{newOut}, maps,
+      iteratorTypes, [&](OpBuilder &b, Location nestedLoc, ValueRange args) {
+        Value lhsElem = args[0];
+        Value rhsElem = args[1];
+        if (lhsElem.getType() != outElemType) {
+          lhsElem = b.create<arith::ExtFOp>(nestedLoc, outElemType, lhsElem);
+        }
+        if (rhsElem.getType() != outElemType) {
+          rhsElem = b.create<arith::ExtFOp>(nestedLoc, outElemType, rhsElem);
+        }
+        Value mul = b.create<arith::MulFOp>(nestedLoc, lhsElem, rhsElem);
+        Value add = b.create<arith::AddFOp>(nestedLoc, mul, args[2]);
+        b.create<linalg::YieldOp>(nestedLoc, add);
+      });
+
+  // Back to the type of the original result.
+  Value result = rewriter.create<tensor::CollapseShapeOp>(
+      loc, paddedOutVector.getType(), gemvOp.getResult(0), ri);
+  if (needsPadding) {
+    result = rewriter.create<tensor::ExtractSliceOp>(
+        loc, cast<RankedTensorType>(outVector.getType()), result,
+        ArrayRef<OpFoldResult>{rewriter.getIndexAttr(0)},
+        ArrayRef<OpFoldResult>{nSize},
+        ArrayRef<OpFoldResult>{rewriter.getIndexAttr(1)});
+  }
+  if (outType.getRank() == 1) {
+    return result.getDefiningOp();
+  }
+  SmallVector<OpFoldResult> offsets(2, rewriter.getIndexAttr(0));
+  SmallVector<OpFoldResult> sizes(2, rewriter.getIndexAttr(1));
+  SmallVector<OpFoldResult> strides(2, rewriter.getIndexAttr(1));
+  sizes[outNPos] = nSize;
+  return rewriter
+      .create<tensor::InsertSliceOp>(loc, result, out, offsets, sizes, strides)
+      .getOperation();
+}
+
 //===---------------------------------------------------------------------===//
 // Methods to convert `set_encoding` and `unset_encoding` operations
 // to `pack` and `unpack` operations respectively.
@@ -330,6 +479,12 @@ lowerContractionOpWithEncoding(RewriterBase &rewriter,
           linalgOp->getResultTypes()[0].cast<RankedTensorType>()));
 
   Operation *result;
+  if (failed(materializeEncodingInfo) &&
+      succeeded(materializeEncodingFn(getOriginalTypeWithEncoding(rhsType)))) {
+    // Only the RHS is packed: this is the M == 1 case that targets lower to a
+    // gemv rather than to a mmt4d with unit M tiles.
+    return lowerContractionOpToPackedGemv(rewriter, linalgOp, operands);
+  }
   if (failed(materializeEncodingInfo)) {
     result = dropEncodingAndCloneOp(rewriter, linalgOp,
                                     operands.take_front(inputs.size()),
@@ -82,3 +82,18 @@ func.func @softmax(%arg0: tensor<2x16x32xf32>) -> tensor<2x16x32xf32> {
 // CHECK-NO-FUSE:        } -> tensor<2x16x32xf32>
 // CHECK-NO-FUSE:        return %[[D7]] : tensor<2x16x32xf32>
 // CHECK-NO-FUSE:      }
+
+// -----
+
+// Softmax ops that are lowered to the softmax ukernel later are kept.
+func.func @softmax_ukernel(%arg0: tensor<2x16x32xf32>) -> tensor<2x16x32xf32> attributes {
+  hal.executable.target = #hal.executable.target<"llvm-cpu", "xyz", {ukernels = "softmax", target_triple="x86_64-xyz-xyz"}>
+} {
+  %0 = tensor.empty() : tensor<2x16x32xf32>
+  %1 = linalg.softmax dimension(2) ins(%arg0 : tensor<2x16x32xf32>) outs(%0 : tensor<2x16x32xf32>) -> tensor<2x16x32xf32>
+  return %1 : tensor<2x16x32xf32>
+}
+// CHECK-LABEL: func.func @softmax_ukernel(
+//       CHECK:   linalg.softmax dimension(2)
+// CHECK-NO-FUSE-LABEL: func.func @softmax_ukernel(
+//       CHECK-NO-FUSE:   linalg.softmax dimension(2)
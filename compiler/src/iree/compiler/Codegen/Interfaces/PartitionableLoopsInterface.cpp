@@ -91,6 +91,31 @@ struct BatchMmt4DOpPartitionableLoops
   }
 };
 
+/// External model implementation for linalg::SoftmaxOp. All loops are
+/// reported as parallel by the op, but the softmax dimension is a reduction
+/// that must not be split across workgroups.
+struct SoftmaxOpPartitionableLoops
+    : public PartitionableLoopsInterface::ExternalModel<
+          SoftmaxOpPartitionableLoops, linalg::SoftmaxOp> {
+  llvm::SmallVector<unsigned>
+  getPartitionableLoops(Operation *op,
+                        std::optional<unsigned> maxNumPartitionedLoops) const {
+    auto softmaxOp = cast<linalg::SoftmaxOp>(op);
+    SmallVector<unsigned> partitionableLoops;
+    for (unsigned i = 0, e = softmaxOp.getInputOperandRank(); i < e; ++i) {
+      if (i != softmaxOp.getDimension()) {
+        partitionableLoops.push_back(i);
+      }
+    }
+    if (maxNumPartitionedLoops.has_value() &&
+        partitionableLoops.size() > maxNumPartitionedLoops.value()) {
+      return llvm::to_vector(llvm::ArrayRef(partitionableLoops)
+                                 .take_back(maxNumPartitionedLoops.value()));
+    }
+    return partitionableLoops;
+  }
+};
+
 /// External model implementation for all operations to make only
 /// the outer parallel loops as partitionable.
 template <typename OpTy>
@@ -228,6 +253,7 @@ void registerPartitionableLoopsInterfaceModels(DialectRegistry &registry) {
     registerInterfaceForLinalgOps<
 #include "mlir/Dialect/Linalg/IR/LinalgStructuredOps.cpp.inc"
         >(ctx);
+    linalg::SoftmaxOp::attachInterface<SoftmaxOpPartitionableLoops>(*ctx);
   });
 
   registry.insert<IREE::LinalgExt::IREELinalgExtDialect>();
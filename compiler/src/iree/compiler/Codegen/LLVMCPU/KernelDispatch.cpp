@@ -1461,9 +1461,19 @@ static LogicalResult setRootConfig(mlir::FunctionOpInterface entryPointFn,
 
 static LogicalResult setRootConfig(mlir::FunctionOpInterface entryPointFn,
                                    IREE::LinalgExt::AttentionOp attnOp) {
-  SmallVector<int64_t> distTileSizes = getDefaultDistributedLevelTileSizes(
-      attnOp, DistributionHeuristicConfig{});
   int64_t iterationDomainRank = attnOp.getIterationDomainRank();
+  DistributionHeuristicConfig distConfig;
+  auto targetAttr = IREE::HAL::ExecutableTargetAttr::lookup(entryPointFn);
+  if (isAttentionUKernelCandidate(attnOp, targetAttr)) {
+    // The op is converted to a ukernel call right after distribution (see
+    // addCPULinalgExtTileAndVectorizePipeline). The ukernel works on blocks of
+    // IREE_UK_ATTENTION_BLOCK_M (8) query rows, so prefer multiples of that.
+    distConfig.minTileSizes.resize(iterationDomainRank, 1);
+    distConfig.minTileSizes.back() = 8;
+    distConfig.vectorSizeHints = distConfig.minTileSizes;
+  }
+  SmallVector<int64_t> distTileSizes =
+      getDefaultDistributedLevelTileSizes(attnOp, distConfig);
   // There are some dimensions are not tiled. Set vector tile sizes being ones
   // to avoid huge vectors.
   // TODO: We should be able to tile other dimensions.
@@ -1852,6 +1862,125 @@ static LogicalResult setElementwiseGenericOpRootConfig(
                                                tileSizes, passPipeline);
 }
 
+/// Sets the lowering configuration for a matmul consuming grouped dequantized
+/// weights, when the mmt4d_dequant ukernel is enabled. These use the
+/// Mmt4dTilingExpert pipeline so that CPULowerToUKernels gets to convert them,
+/// with only the parallel dimensions distributed as the ukernel does the
+/// whole reduction.
+static LogicalResult
+setGroupedDequantMatmulRootConfig(mlir::FunctionOpInterface entryPointFn,
+                                  linalg::GenericOp genericOp) {
+  auto targetAttr = IREE::HAL::ExecutableTargetAttr::lookup(entryPointFn);
+  if (!hasUkernel(targetAttr, "mmt4d_dequant")) {
+    return failure();
+  }
+  FailureOr<GroupedDequantMatmulOperands> operands =
+      getGroupedDequantMatmulOperands(genericOp);
+  if (failed(operands)) {
+    return failure();
+  }
+
+  auto linalgOp = cast<linalg::LinalgOp>(genericOp.getOperation());
+  unsigned numLoops = linalgOp.getNumLoops();
+  SmallVector<int64_t> loopRanges = linalgOp.getStaticLoopRanges();
+  // Loops are (N, G, GS) or (M, N, G, GS).
+  bool hasM = numLoops == 4;
+  int64_t M = hasM ? loopRanges[0] : 1;
+  int64_t groupCount = loopRanges[numLoops - 2];
+  int64_t reductionSize = ShapedType::isDynamic(groupCount)
+                              ? 1024
+                              : groupCount * operands->groupSize;
+  // Same sizing as for mmt4d, with i4 weights and f32 activations.
+  int64_t tileBytes =
+      M == 1 ? clNarrowMatmulTileBytes : clGeneralMatmulTileBytes;
+  DistributionHeuristicConfig distConfig;
+  distConfig.allowIncompleteTile = true;
+  distConfig.minTileSizes.resize(numLoops, 0);
+  distConfig.maxTileSizes.resize(numLoops, 0);
+  if (hasM) {
+    distConfig.minTileSizes[0] = 1;
+    distConfig.maxTileSizes[0] =
+        M == 1 ? 1 : std::max<int64_t>(tileBytes * 8 / 32 / reductionSize, 1);
+  }
+  distConfig.minTileSizes[numLoops - 3] = 1;
+  distConfig.maxTileSizes[numLoops - 3] =
+      std::max<int64_t>(tileBytes * 8 / 4 / reductionSize, 1);
+  SmallVector<int64_t> distTileSizes =
+      getDefaultDistributedLevelTileSizes(linalgOp, distConfig);
+  SmallVector<int64_t> cacheParallelTileSizes(distTileSizes.begin(),
+                                              distTileSizes.end());
+  SmallVector<int64_t> cacheReductionTileSizes(numLoops, 0);
+
+  // These only matter for the codegen fallback, if the ukernel lowering does
+  // not kick in: one output element at a time, one group at a time.
+  SmallVector<int64_t> parallelTileSizes(numLoops, 1);
+  parallelTileSizes[numLoops - 1] = operands->groupSize;
+  SmallVector<int64_t> reductionTileSizes;
+  splitParallelAndReductionTiles(linalgOp, parallelTileSizes,
+                                 reductionTileSizes);
+  SmallVector<int64_t> vectorInnerParallelTileSizes(numLoops, 0);
+  TileSizesListType tileSizes = {
+      distTileSizes,     cacheParallelTileSizes, cacheReductionTileSizes,
+      parallelTileSizes, reductionTileSizes,     vectorInnerParallelTileSizes};
+  return setOpConfigAndEntryPointFnTranslation(
+      entryPointFn, genericOp, tileSizes,
+      DispatchLoweringPassPipeline::Mmt4dTilingExpert);
+}
+
+/// Sets the lowering configuration for a M == 1 matmul on a packed RHS (see
+/// isPackedGemvOp), when the gemv ukernel is enabled. Like mmt4d, these use the
+/// Mmt4dTilingExpert pipeline so that CPULowerToUKernels gets to convert them,
+/// with only the N1 dimension distributed as the ukernel does the whole
+/// reduction.
+static LogicalResult
+setPackedGemvRootConfig(mlir::FunctionOpInterface entryPointFn,
+                        linalg::GenericOp genericOp) {
+  auto targetAttr = IREE::HAL::ExecutableTargetAttr::lookup(entryPointFn);
+  if (!hasUkernel(targetAttr, "gemv") || failed(isPackedGemvOp(genericOp))) {
+    return failure();
+  }
+
+  // Loops are (N1, N0, K1, K0).
+  auto linalgOp = cast<linalg::LinalgOp>(genericOp.getOperation());
+  unsigned numLoops = linalgOp.getNumLoops();
+  SmallVector<int64_t> loopRanges = linalgOp.getStaticLoopRanges();
+  int64_t N0 = loopRanges[1];
+  int64_t K1 = loopRanges[2];
+  int64_t K0 = loopRanges[3];
+  int64_t reductionSize = ShapedType::isDynamic(K1) ? 1024 : K0 * K1;
+  auto rhsType =
+      cast<ShapedType>(genericOp.getDpsInputOperand(1)->get().getType());
+  // Same sizing as for narrow mmt4d.
+  int64_t targetRhsTileElems =
+      clNarrowMatmulTileBytes * 8 / rhsType.getElementTypeBitWidth();
+  DistributionHeuristicConfig distConfig;
+  distConfig.allowIncompleteTile = true;
+  distConfig.minTileSizes.resize(numLoops, 0);
+  distConfig.maxTileSizes.resize(numLoops, 0);
+  distConfig.minTileSizes[0] = 1;
+  distConfig.maxTileSizes[0] = std::max<int64_t>(
+      llvm::divideCeil(targetRhsTileElems / reductionSize, N0), 1);
+  SmallVector<int64_t> distTileSizes =
+      getDefaultDistributedLevelTileSizes(linalgOp, distConfig);
+  SmallVector<int64_t> cacheParallelTileSizes(distTileSizes.begin(),
+                                              distTileSizes.end());
+  SmallVector<int64_t> cacheReductionTileSizes(numLoops, 0);
+
+  // These only matter for the codegen fallback, if the ukernel lowering does
+  // not kick in: one N0 x K0 tile at a time, as for mmt4d.
+  SmallVector<int64_t> parallelTileSizes = {1, N0, 1, K0};
+  SmallVector<int64_t> reductionTileSizes;
+  splitParallelAndReductionTiles(linalgOp, parallelTileSizes,
+                                 reductionTileSizes);
+  SmallVector<int64_t> vectorInnerParallelTileSizes(numLoops, 0);
+  TileSizesListType tileSizes = {
+      distTileSizes,     cacheParallelTileSizes, cacheReductionTileSizes,
+      parallelTileSizes, reductionTileSizes,     vectorInnerParallelTileSizes};
+  return setOpConfigAndEntryPointFnTranslation(
+      entryPointFn, genericOp, tileSizes,
+      DispatchLoweringPassPipeline::Mmt4dTilingExpert);
+}
+
 /// Sets the lowering configuration for a generic op to use
 /// CPUDoubleTilingExpert pipeline.
 static LogicalResult
@@ -1866,6 +1995,12 @@ setRootConfig(mlir::FunctionOpInterface entryPointFn,
     return success();
   }
 
+  if (succeeded(setGroupedDequantMatmulRootConfig(entryPointFn, genericOp))) {
+    return success();
+  }
+  if (succeeded(setPackedGemvRootConfig(entryPointFn, genericOp))) {
+    return success();
+  }
   if (succeeded(setTransposeLikeOpRootConfig(
           entryPointFn, genericOp, linalgOpInfo, targetMLTransInfo))) {
     return success();
@@ -2091,6 +2226,64 @@ static LogicalResult setRootConfig(mlir::FunctionOpInterface entryPointFn,
       entryPointFn, op, tileSizes, DispatchLoweringPassPipeline::CPUDefault);
 }
 
+/// Sets the lowering configuration for a linalg.softmax that is lowered to the
+/// softmax ukernel (see isSoftmaxUKernelCandidate). These use the
+/// Mmt4dTilingExpert pipeline so that CPULowerToUKernels gets to convert them.
+/// Each workgroup gets whole rows, and a single index along the outer
+/// dimensions so that the ukernel sees a 2-D problem.
+static LogicalResult setSoftmaxUKernelRootConfig(
+    mlir::FunctionOpInterface entryPointFn, linalg::SoftmaxOp softmaxOp) {
+  auto targetAttr = IREE::HAL::ExecutableTargetAttr::lookup(entryPointFn);
+  if (!isSoftmaxUKernelCandidate(softmaxOp, targetAttr)) {
+    return failure();
+  }
+  int64_t numLoops = softmaxOp.getInputOperandRank();
+  int64_t rowDim = numLoops - 2;
+  int64_t rowSize = softmaxOp.getInputOperandType().getShape().back();
+  if (ShapedType::isDynamic(rowSize)) {
+    rowSize = 1024;
+  }
+  DistributionHeuristicConfig distConfig;
+  distConfig.allowIncompleteTile = true;
+  distConfig.minTileSizes.resize(numLoops, 1);
+  distConfig.maxTileSizes.resize(numLoops, 1);
+  // Aim for the f32 input and output rows of a workgroup to fit the same
+  // budget as a matmul tile.
+  int64_t rowBytes = 2 * 4 * rowSize;
+  distConfig.maxTileSizes[rowDim] =
+      std::max<int64_t>(clGeneralMatmulTileBytes / rowBytes, 1);
+  SmallVector<int64_t> distTileSizes =
+      getDefaultDistributedLevelTileSizes(softmaxOp, distConfig);
+  SmallVector<int64_t> cacheParallelTileSizes(distTileSizes.begin(),
+                                              distTileSizes.end());
+  SmallVector<int64_t> cacheReductionTileSizes(numLoops, 0);
+  // These only matter for the tiling passes that run after the op has been
+  // converted to a ukernel: one row at a time.
+  SmallVector<int64_t> parallelTileSizes(numLoops, 1);
+  parallelTileSizes[numLoops - 1] = 0;
+  SmallVector<int64_t> reductionTileSizes(numLoops, 0);
+  SmallVector<int64_t> vectorInnerParallelTileSizes(numLoops, 0);
+  TileSizesListType tileSizes = {
+      distTileSizes,     cacheParallelTileSizes, cacheReductionTileSizes,
+      parallelTileSizes, reductionTileSizes,     vectorInnerParallelTileSizes};
+  return setOpConfigAndEntryPointFnTranslation(
+      entryPointFn, softmaxOp, tileSizes,
+      DispatchLoweringPassPipeline::Mmt4dTilingExpert);
+}
+
+/// Sets the lowering configuration for dispatch region for linalg.softmax
+/// root op.
+static LogicalResult setRootConfig(mlir::FunctionOpInterface entryPointFn,
+                                   linalg::SoftmaxOp softmaxOp) {
+  assert(!getLoweringConfig(softmaxOp) &&
+         "expected lowering_config is not set");
+  if (succeeded(setSoftmaxUKernelRootConfig(entryPointFn, softmaxOp))) {
+    return success();
+  }
+  return setRootConfig(entryPointFn,
+                       cast<TilingInterface>(softmaxOp.getOperation()));
+}
+
 /// Redirects to methods that set the configuration based on operation type.
 static LogicalResult
 setRootConfigImpl(mlir::FunctionOpInterface entryPointFn, Operation *op,
@@ -2117,6 +2310,8 @@ setRootConfigImpl(mlir::FunctionOpInterface entryPointFn, Operation *op,
             })
         .Case<linalg::ContractionOpInterface>(
             [&](auto op) { return setRootConfig(entryPointFn, op); })
+        .Case<linalg::SoftmaxOp>(
+            [&](auto op) { return setRootConfig(entryPointFn, op); })
         .Case<TilingInterface>(
             [&](auto op) { return setRootConfig(entryPointFn, op); })
         .Default([&](Operation *op) { return success(); });
@@ -582,6 +582,12 @@ void addCPULinalgExtTileAndVectorizePipeline(
     OpPassManager &funcPassManager, TilingConfig &tilingConfig,
     LLVMCPUPipelineOptions &pipelineOpt) {
   addTileAndDistributePasses(funcPassManager);
+  // Attention ops that have a ukernel are converted to it whole after
+  // distribution, before they get tiled further and decomposed.
+  if (pipelineOpt.enableUkernels) {
+    funcPassManager.addPass(
+        createCPULowerToUKernelsPass(clSkipIntermediateRoundings));
+  }
   funcPassManager.addPass(
       createLLVMCPUTilePass(tilingConfig.getVectorCommonParallelLevel()));
   // TODO: Should only apply decomposition here?
@@ -1444,6 +1444,105 @@ module {
 
 // -----
 
+#executable_target_embedded_elf_x86_64_ = #hal.executable.target<"llvm-cpu", "embedded-elf-x86_64", {data_layout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128", native_vector_size = 16 : index, target_triple = "x86_64-unknown-linux-gnu", ukernels = "mmt4d_dequant"}>
+#map = affine_map<(d0, d1, d2) -> (d1, d2)>
+#map1 = affine_map<(d0, d1, d2) -> (d0, d1, d2)>
+#map2 = affine_map<(d0, d1, d2) -> (d0, d1)>
+#map3 = affine_map<(d0, d1, d2) -> (d0)>
+module {
+  func.func @i4_dequant_matvec_f32_ukernel() attributes {hal.executable.target = #executable_target_embedded_elf_x86_64_} {
+    %cst = arith.constant 0.000000e+00 : f32
+    %0 = hal.interface.binding.subspan set(0) binding(0) type(storage_buffer) : !flow.dispatch.tensor<readonly:tensor<4096x86x128xi4>>
+    %1 = hal.interface.binding.subspan set(0) binding(1) type(storage_buffer) : !flow.dispatch.tensor<readonly:tensor<4096x86xf32>>
+    %2 = hal.interface.binding.subspan set(0) binding(2) type(storage_buffer) : !flow.dispatch.tensor<readonly:tensor<4096x86xf32>>
+    %3 = hal.interface.binding.subspan set(0) binding(3) type(storage_buffer) : !flow.dispatch.tensor<readonly:tensor<86x128xf32>>
+    %4 = hal.interface.binding.subspan set(0) binding(4) type(storage_buffer) : !flow.dispatch.tensor<writeonly:tensor<4096xf32>>
+    %5 = flow.dispatch.tensor.load %0, offsets = [0, 0, 0], sizes = [4096, 86, 128], strides = [1, 1, 1] : !flow.dispatch.tensor<readonly:tensor<4096x86x128xi4>> -> tensor<4096x86x128xi4>
+    %6 = flow.dispatch.tensor.load %1, offsets = [0, 0], sizes = [4096, 86], strides = [1, 1] : !flow.dispatch.tensor<readonly:tensor<4096x86xf32>> -> tensor<4096x86xf32>
+    %7 = flow.dispatch.tensor.load %2, offsets = [0, 0], sizes = [4096, 86], strides = [1, 1] : !flow.dispatch.tensor<readonly:tensor<4096x86xf32>> -> tensor<4096x86xf32>
+    %8 = flow.dispatch.tensor.load %3, offsets = [0, 0], sizes = [86, 128], strides = [1, 1] : !flow.dispatch.tensor<readonly:tensor<86x128xf32>> -> tensor<86x128xf32>
+    %9 = tensor.empty() : tensor<4096xf32>
+    %10 = linalg.fill ins(%cst : f32) outs(%9 : tensor<4096xf32>) -> tensor<4096xf32>
+    %11 = linalg.generic {indexing_maps = [#map, #map1, #map2, #map2, #map3], iterator_types = ["parallel", "reduction", "reduction"]} ins(%8, %5, %6, %7 : tensor<86x128xf32>, tensor<4096x86x128xi4>, tensor<4096x86xf32>, tensor<4096x86xf32>) outs(%10 : tensor<4096xf32>) {
+    ^bb0(%in: f32, %in_0: i4, %in_1: f32, %in_2: f32, %out: f32):
+      %12 = arith.extui %in_0 : i4 to i32
+      %13 = arith.uitofp %12 : i32 to f32
+      %14 = arith.subf %13, %in_2 : f32
+      %15 = arith.mulf %14, %in_1 : f32
+      %16 = arith.mulf %in, %15 : f32
+      %17 = arith.addf %16, %out : f32
+      linalg.yield %17 : f32
+    } -> tensor<4096xf32>
+    flow.dispatch.tensor.store %11, %4, offsets = [0], sizes = [4096], strides = [1] : tensor<4096xf32> -> !flow.dispatch.tensor<writeonly:tensor<4096xf32>>
+    return
+  }
+}
+
+//   CHECK-DAG: #[[CONFIG:.+]] = #iree_codegen.lowering_config<tile_sizes = {{\[}}[{{[0-9]+}}, 0, 0], [{{[0-9]+}}, 0, 0], [0, 0, 0], [1, 0, 0], [0, 1, 128], [0, 0, 0]]>
+//   CHECK-DAG: #[[TRANSLATION:.+]] = #iree_codegen.translation_info<Mmt4dTilingExpert>
+//       CHECK: func.func @i4_dequant_matvec_f32_ukernel()
+//  CHECK-SAME:     translation_info = #[[TRANSLATION]]
+//       CHECK: linalg.generic {{.*}} iterator_types = ["parallel", "reduction", "reduction"]
+//  CHECK-SAME:     lowering_config = #[[CONFIG]]
+
+// -----
+
+#executable_target_embedded_elf_x86_64_ = #hal.executable.target<"llvm-cpu", "embedded-elf-x86_64", {cpu_features = "+avx512f", data_layout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128", native_vector_size = 64 : index, target_triple = "x86_64-unknown-linux-gnu", ukernels = "gemv"}>
+#map = affine_map<(d0, d1, d2, d3) -> (d2, d3)>
+#map1 = affine_map<(d0, d1, d2, d3) -> (d0, d2, d1, d3)>
+#map2 = affine_map<(d0, d1, d2, d3) -> (d0, d1)>
+module {
+  func.func @packed_gemv_f32_ukernel() attributes {hal.executable.target = #executable_target_embedded_elf_x86_64_} {
+    %cst = arith.constant 0.000000e+00 : f32
+    %0 = hal.interface.binding.subspan set(0) binding(0) type(storage_buffer) : !flow.dispatch.tensor<readonly:tensor<4096x1xf32>>
+    %1 = hal.interface.binding.subspan set(0) binding(1) type(storage_buffer) : !flow.dispatch.tensor<readonly:tensor<256x4096x16x1xf32>>
+    %2 = hal.interface.binding.subspan set(0) binding(2) type(storage_buffer) : !flow.dispatch.tensor<writeonly:tensor<256x16xf32>>
+    %3 = flow.dispatch.tensor.load %0, offsets = [0, 0], sizes = [4096, 1], strides = [1, 1] : !flow.dispatch.tensor<readonly:tensor<4096x1xf32>> -> tensor<4096x1xf32>
+    %4 = flow.dispatch.tensor.load %1, offsets = [0, 0, 0, 0], sizes = [256, 4096, 16, 1], strides = [1, 1, 1, 1] : !flow.dispatch.tensor<readonly:tensor<256x4096x16x1xf32>> -> tensor<256x4096x16x1xf32>
+    %5 = tensor.empty() : tensor<256x16xf32>
+    %6 = linalg.fill ins(%cst : f32) outs(%5 : tensor<256x16xf32>) -> tensor<256x16xf32>
+    %7 = linalg.generic {indexing_maps = [#map, #map1, #map2], iterator_types = ["parallel", "parallel", "reduction", "reduction"]} ins(%3, %4 : tensor<4096x1xf32>, tensor<256x4096x16x1xf32>) outs(%6 : tensor<256x16xf32>) {
+    ^bb0(%in: f32, %in_0: f32, %out: f32):
+      %8 = arith.mulf %in, %in_0 : f32
+      %9 = arith.addf %8, %out : f32
+      linalg.yield %9 : f32
+    } -> tensor<256x16xf32>
+    flow.dispatch.tensor.store %7, %2, offsets = [0, 0], sizes = [256, 16], strides = [1, 1] : tensor<256x16xf32> -> !flow.dispatch.tensor<writeonly:tensor<256x16xf32>>
+    return
+  }
+}
+
+//   CHECK-DAG: #[[CONFIG:.+]] = #iree_codegen.lowering_config<tile_sizes = {{\[}}[{{[0-9]+}}, 0, 0, 0], [{{[0-9]+}}, 0, 0, 0], [0, 0, 0, 0], [1, 16, 0, 0], [0, 0, 1, 1], [0, 0, 0, 0]]>
+//   CHECK-DAG: #[[TRANSLATION:.+]] = #iree_codegen.translation_info<Mmt4dTilingExpert>
+//       CHECK: func.func @packed_gemv_f32_ukernel()
+//  CHECK-SAME:     translation_info = #[[TRANSLATION]]
+//       CHECK: linalg.generic {{.*}} iterator_types = ["parallel", "parallel", "reduction", "reduction"]
+//  CHECK-SAME:     lowering_config = #[[CONFIG]]
+
+// -----
+
+#executable_target_embedded_elf_x86_64_ = #hal.executable.target<"llvm-cpu", "embedded-elf-x86_64", {data_layout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128", native_vector_size = 16 : index, target_triple = "x86_64-unknown-linux-gnu", ukernels = "softmax"}>
+module {
+  func.func @softmax_f32_ukernel() attributes {hal.executable.target = #executable_target_embedded_elf_x86_64_} {
+    %0 = hal.interface.binding.subspan set(0) binding(0) type(storage_buffer) : !flow.dispatch.tensor<readonly:tensor<12x128x128xf32>>
+    %1 = hal.interface.binding.subspan set(0) binding(1) type(storage_buffer) : !flow.dispatch.tensor<writeonly:tensor<12x128x128xf32>>
+    %2 = flow.dispatch.tensor.load %0, offsets = [0, 0, 0], sizes = [12, 128, 128], strides = [1, 1, 1] : !flow.dispatch.tensor<readonly:tensor<12x128x128xf32>> -> tensor<12x128x128xf32>
+    %3 = tensor.empty() : tensor<12x128x128xf32>
+    %4 = linalg.softmax dimension(2) ins(%2 : tensor<12x128x128xf32>) outs(%3 : tensor<12x128x128xf32>) -> tensor<12x128x128xf32>
+    flow.dispatch.tensor.store %4, %1, offsets = [0, 0, 0], sizes = [12, 128, 128], strides = [1, 1, 1] : tensor<12x128x128xf32> -> !flow.dispatch.tensor<writeonly:tensor<12x128x128xf32>>
+    return
+  }
+}
+
+//   CHECK-DAG: #[[CONFIG:.+]] = #iree_codegen.lowering_config<tile_sizes = {{\[}}[1, {{[0-9]+}}, 0], [1, {{[0-9]+}}, 0], [0, 0, 0], [1, 1, 0], [0, 0, 0], [0, 0, 0]]>
+//   CHECK-DAG: #[[TRANSLATION:.+]] = #iree_codegen.translation_info<Mmt4dTilingExpert>
+//       CHECK: func.func @softmax_f32_ukernel()
+//  CHECK-SAME:     translation_info = #[[TRANSLATION]]
+//       CHECK: linalg.softmax
+//  CHECK-SAME:     lowering_config = #[[CONFIG]]
+
+// -----
+
 #executable_target_embedded_elf_x86_64_ = #hal.executable.target<"llvm-cpu", "embedded-elf-x86_64", {cpu = "cascadelake", cpu_features = "", data_layout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128", native_vector_size = 32 : index, target_triple = "x86_64-unknown-unknown-eabi-elf", ukernels = true}>
 module {
   func.func @batch_mmt4d() attributes {hal.executable.target = #executable_target_embedded_elf_x86_64_} {
@@ -1616,3 +1715,38 @@ module {
 // CHECK-SAME:     translation_info = #[[TRANSLATION]]
 //     CHECK:   iree_linalg_ext.attention
 // CHECK-SAME:    {lowering_config = #[[CONFIG]]}
+
+// -----
+
+#executable_target_embedded_elf_x86_64_ = #hal.executable.target<"llvm-cpu", "embedded-elf-x86_64", {
+      cpu = "generic", cpu_features = "",
+      data_layout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128",
+      native_vector_size = 64 : index, target_triple = "x86_64-none-elf",
+      ukernels = "attention"}>
+module {
+  func.func @attention_ukernel() attributes {hal.executable.target = #executable_target_embedded_elf_x86_64_} {
+    %c0 = arith.constant 0 : index
+    %scale = arith.constant 0.125 : f32
+    %0 = hal.interface.binding.subspan set(0) binding(0) type(storage_buffer) alignment(64) offset(%c0) flags(ReadOnly) : !flow.dispatch.tensor<readonly:tensor<20x120x64xf32>>
+    %1 = hal.interface.binding.subspan set(0) binding(1) type(storage_buffer) alignment(64) offset(%c0) flags(ReadOnly) : !flow.dispatch.tensor<readonly:tensor<20x4096x64xf32>>
+    %2 = hal.interface.binding.subspan set(0) binding(2) type(storage_buffer) alignment(64) offset(%c0) flags(ReadOnly) : !flow.dispatch.tensor<readonly:tensor<20x4096x64xf32>>
+    %3 = hal.interface.binding.subspan set(0) binding(3) type(storage_buffer) alignment(64) offset(%c0) : !flow.dispatch.tensor<writeonly:tensor<20x120x64xf32>>
+    %4 = flow.dispatch.tensor.load %0, offsets = [0, 0, 0], sizes = [20, 120, 64], strides = [1, 1, 1] : !flow.dispatch.tensor<readonly:tensor<20x120x64xf32>> -> tensor<20x120x64xf32>
+    %5 = flow.dispatch.tensor.load %1, offsets = [0, 0, 0], sizes = [20, 4096, 64], strides = [1, 1, 1] : !flow.dispatch.tensor<readonly:tensor<20x4096x64xf32>> -> tensor<20x4096x64xf32>
+    %6 = flow.dispatch.tensor.load %2, offsets = [0, 0, 0], sizes = [20, 4096, 64], strides = [1, 1, 1] : !flow.dispatch.tensor<readonly:tensor<20x4096x64xf32>> -> tensor<20x4096x64xf32>
+    %7 = tensor.empty() : tensor<20x120x64xf32>
+    %8 = iree_linalg_ext.attention
+      ins(%4, %5, %6, %scale : tensor<20x120x64xf32>, tensor<20x4096x64xf32>, tensor<20x4096x64xf32>, f32)
+      outs(%7 : tensor<20x120x64xf32>) -> tensor<20x120x64xf32>
+    flow.dispatch.tensor.store %8, %3, offsets = [0, 0, 0], sizes = [20, 120, 64], strides = [1, 1, 1] : tensor<20x120x64xf32> -> !flow.dispatch.tensor<writeonly:tensor<20x120x64xf32>>
+    return
+  }
+}
+// With the attention ukernel, the query rows are distributed in multiples of
+// the 8-row blocks of the ukernel.
+//  CHECK-DAG: #[[CONFIG:.+]] = #iree_codegen.lowering_config<tile_sizes = {{\[}}[5, 40], [1, 1]]>
+//  CHECK-DAG: #[[TRANSLATION:.+]] = #iree_codegen.translation_info<CPULinalgExtTileAndVectorize>
+//      CHECK: func.func @attention_ukernel()
+// CHECK-SAME:     translation_info = #[[TRANSLATION]]
+//      CHECK:   iree_linalg_ext.attention
+// CHECK-SAME:    {lowering_config = #[[CONFIG]]}
@@ -25,6 +25,7 @@
 #include "mlir/IR/AffineExprVisitor.h"
 #include "mlir/IR/Matchers.h"
 #include "mlir/IR/SymbolTable.h"
+#include "mlir/IR/TypeUtilities.h"
 #include "mlir/Interfaces/TilingInterface.h"
 
 #define DEBUG_TYPE "iree-codegen-utils"
@@ -134,6 +135,11 @@ bool isROCMBackend(IREE::HAL::ExecutableTargetAttr targetAttr) {
   return targetAttr && targetAttr.getBackend().getValue().starts_with("rocm");
 }
 
+bool isLLVMCPUBackend(IREE::HAL::ExecutableTargetAttr targetAttr) {
+  return targetAttr &&
+         targetAttr.getBackend().getValue().starts_with("llvm-cpu");
+}
+
 bool hasUkernel(IREE::HAL::ExecutableTargetAttr targetAttr,
                 StringRef ukernelName) {
   auto enabledUkernels = getConfigStringAttr(targetAttr, "ukernels");
@@ -909,6 +915,240 @@ LogicalResult isArgmaxOp(linalg::GenericOp genericOp) {
   return success();
 }
 
+FailureOr<GroupedDequantMatmulOperands>
+getGroupedDequantMatmulOperands(linalg::GenericOp genericOp) {
+  if (genericOp.getNumDpsInputs() != 4 || genericOp.getNumDpsInits() != 1) {
+    return failure();
+  }
+  // Loops are (N, G, GS) or (M, N, G, GS), the last two being reductions.
+  unsigned numLoops = genericOp.getNumLoops();
+  if ((numLoops != 3 && numLoops != 4) ||
+      genericOp.getNumReductionLoops() != 2 ||
+      genericOp.getIteratorTypesArray()[numLoops - 3] !=
+          utils::IteratorType::parallel) {
+    return failure();
+  }
+
+  // Work back from linalg.yield, the body should be:
+  //   %0 = arith.extui %weights
+  //   %1 = arith.uitofp %0
+  //   %2 = arith.subf %1, %zero_points
+  //   %3 = arith.mulf %2, %scales
+  //   %4 = arith.mulf %lhs, %3
+  //   %5 = arith.addf %4, %out
+  Block *body = genericOp.getBody();
+  if (body->getOperations().size() != 7) {
+    return failure();
+  }
+  auto yieldOp = cast<linalg::YieldOp>(body->getTerminator());
+  auto addOp = yieldOp->getOperand(0).getDefiningOp<arith::AddFOp>();
+  if (!addOp) {
+    return failure();
+  }
+  BlockArgument outArg = genericOp.getMatchingBlockArgument(
+      genericOp.getDpsInitOperand(0));
+  if (addOp.getLhs() != outArg && addOp.getRhs() != outArg) {
+    return failure();
+  }
+  Value product = addOp.getLhs() == outArg ? addOp.getRhs() : addOp.getLhs();
+  auto mulOp = product.getDefiningOp<arith::MulFOp>();
+  if (!mulOp) {
+    return failure();
+  }
+  auto scaleOp = mulOp.getRhs().getDefiningOp<arith::MulFOp>();
+  Value lhsValue = mulOp.getLhs();
+  if (!scaleOp) {
+    scaleOp = mulOp.getLhs().getDefiningOp<arith::MulFOp>();
+    lhsValue = mulOp.getRhs();
+  }
+  if (!scaleOp) {
+    return failure();
+  }
+  auto subOp = scaleOp.getLhs().getDefiningOp<arith::SubFOp>();
+  if (!subOp) {
+    return failure();
+  }
+  auto uitofpOp = subOp.getLhs().getDefiningOp<arith::UIToFPOp>();
+  if (!uitofpOp) {
+    return failure();
+  }
+  auto extOp = uitofpOp.getIn().getDefiningOp<arith::ExtUIOp>();
+  if (!extOp) {
+    return failure();
+  }
+  auto lhsArg = dyn_cast<BlockArgument>(lhsValue);
+  auto weightsArg = dyn_cast<BlockArgument>(extOp.getIn());
+  auto scalesArg = dyn_cast<BlockArgument>(scaleOp.getRhs());
+  auto zeroPointsArg = dyn_cast<BlockArgument>(subOp.getRhs());
+  unsigned numInputs = genericOp.getNumDpsInputs();
+  for (BlockArgument arg : {lhsArg, weightsArg, scalesArg, zeroPointsArg}) {
+    if (!arg || arg.getOwner() != body || arg.getArgNumber() >= numInputs) {
+      return failure();
+    }
+  }
+  OpOperand *lhsOperand = genericOp.getDpsInputOperand(lhsArg.getArgNumber());
+  OpOperand *weightsOperand =
+      genericOp.getDpsInputOperand(weightsArg.getArgNumber());
+  OpOperand *scalesOperand =
+      genericOp.getDpsInputOperand(scalesArg.getArgNumber());
+  OpOperand *zeroPointsOperand =
+      genericOp.getDpsInputOperand(zeroPointsArg.getArgNumber());
+
+  // Check the indexing maps of each role.
+  MLIRContext *ctx = genericOp.getContext();
+  auto d = [&](unsigned pos) { return getAffineDimExpr(pos, ctx); };
+  AffineMap lhsMap, weightsMap, groupMap, outMap;
+  if (numLoops == 3) {
+    lhsMap = AffineMap::get(numLoops, 0, {d(1), d(2)}, ctx);
+    weightsMap = AffineMap::get(numLoops, 0, {d(0), d(1), d(2)}, ctx);
+    groupMap = AffineMap::get(numLoops, 0, {d(0), d(1)}, ctx);
+    outMap = AffineMap::get(numLoops, 0, {d(0)}, ctx);
+  } else {
+    lhsMap = AffineMap::get(numLoops, 0, {d(0), d(2), d(3)}, ctx);
+    weightsMap = AffineMap::get(numLoops, 0, {d(1), d(2), d(3)}, ctx);
+    groupMap = AffineMap::get(numLoops, 0, {d(1), d(2)}, ctx);
+    outMap = AffineMap::get(numLoops, 0, {d(0), d(1)}, ctx);
+  }
+  if (genericOp.getMatchingIndexingMap(lhsOperand) != lhsMap ||
+      genericOp.getMatchingIndexingMap(weightsOperand) != weightsMap ||
+      genericOp.getMatchingIndexingMap(scalesOperand) != groupMap ||
+      genericOp.getMatchingIndexingMap(zeroPointsOperand) != groupMap ||
+      genericOp.getMatchingIndexingMap(genericOp.getDpsInitOperand(0)) !=
+          outMap) {
+    return failure();
+  }
+
+  // Only i4 weights with f32 everything else are handled for now.
+  Value weights = weightsOperand->get();
+  auto weightsType = llvm::cast<ShapedType>(weights.getType());
+  Value lhs = lhsOperand->get();
+  Value scales = scalesOperand->get();
+  Value zeroPoints = zeroPointsOperand->get();
+  Value out = genericOp.getDpsInitOperand(0)->get();
+  if (!weightsType.getElementType().isInteger(4) ||
+      !getElementTypeOrSelf(lhs).isF32() ||
+      !getElementTypeOrSelf(scales).isF32() ||
+      !getElementTypeOrSelf(zeroPoints).isF32() ||
+      !getElementTypeOrSelf(out).isF32()) {
+    return failure();
+  }
+  // Groups have to be static, and made of whole bytes of i4 weights.
+  int64_t groupSize = weightsType.getShape().back();
+  if (ShapedType::isDynamic(groupSize) || groupSize % 2) {
+    return failure();
+  }
+  return GroupedDequantMatmulOperands{lhs,        weights, scales,
+                                      zeroPoints, out,     groupSize};
+}
+
+bool isSoftmaxUKernelCandidate(linalg::SoftmaxOp softmaxOp,
+                               IREE::HAL::ExecutableTargetAttr targetAttr) {
+  if (!isLLVMCPUBackend(targetAttr) || !hasUkernel(targetAttr, "softmax")) {
+    return false;
+  }
+  auto inputType = dyn_cast<RankedTensorType>(softmaxOp.getInput().getType());
+  auto outputType =
+      dyn_cast<RankedTensorType>(softmaxOp.getOutput().getType());
+  // All outer dimensions need to be distributed for the op to be reduced to a
+  // 2-D ukernel call, so there can be at most kNumMaxParallelDims of them.
+  if (!inputType || !outputType || inputType.getRank() < 2 ||
+      inputType.getRank() > kNumMaxParallelDims + 1) {
+    return false;
+  }
+  return inputType.getElementType().isF32() &&
+         outputType.getElementType().isF32() &&
+         static_cast<int64_t>(softmaxOp.getDimension()) ==
+             inputType.getRank() - 1;
+}
+
+bool isAttentionUKernelCandidate(IREE::LinalgExt::AttentionOp attnOp,
+                                 IREE::HAL::ExecutableTargetAttr targetAttr) {
+  if (!isLLVMCPUBackend(targetAttr) || !hasUkernel(targetAttr, "attention")) {
+    return false;
+  }
+  // The tiled form carries the running max and sum as extra outputs, which
+  // the ukernel keeps internally.
+  if (attnOp.getNumDpsInits() != 1) {
+    return false;
+  }
+  SmallVector<ShapedType> types = {
+      attnOp.getQueryType(), attnOp.getKeyType(), attnOp.getValueType(),
+      attnOp.getOutputType()};
+  Type elementType = types.front().getElementType();
+  if (!elementType.isF32() && !elementType.isF16() && !elementType.isBF16()) {
+    return false;
+  }
+  return llvm::all_of(types, [&](ShapedType type) {
+    return type.getRank() == 3 && type.hasStaticShape() &&
+           type.getElementType() == elementType;
+  });
+}
+
+LogicalResult isPackedGemvOp(linalg::GenericOp genericOp) {
+  if (genericOp.getNumDpsInputs() != 2 || genericOp.getNumDpsInits() != 1 ||
+      genericOp.getNumLoops() != 4 || genericOp.getNumReductionLoops() != 2) {
+    return failure();
+  }
+  // Loops are (N1, N0, K1, K0).
+  MLIRContext *ctx = genericOp.getContext();
+  AffineExpr d0, d1, d2, d3;
+  bindDims(ctx, d0, d1, d2, d3);
+  SmallVector<AffineMap> expectedMaps = {
+      AffineMap::get(4, 0, {d2, d3}, ctx),
+      AffineMap::get(4, 0, {d0, d2, d1, d3}, ctx),
+      AffineMap::get(4, 0, {d0, d1}, ctx),
+  };
+  if (genericOp.getIndexingMapsArray() != expectedMaps) {
+    return failure();
+  }
+
+  // Work back from linalg.yield, the body should be:
+  //   %0 = arith.extf %lhs (optional)
+  //   %1 = arith.extf %rhs (optional)
+  //   %2 = arith.mulf %0, %1
+  //   %3 = arith.addf %2, %out
+  Block *body = genericOp.getBody();
+  if (body->getOperations().size() > 5) {
+    return failure();
+  }
+  auto yieldOp = cast<linalg::YieldOp>(body->getTerminator());
+  auto addOp = yieldOp->getOperand(0).getDefiningOp<arith::AddFOp>();
+  BlockArgument outArg = body->getArgument(2);
+  if (!addOp || (addOp.getLhs() != outArg && addOp.getRhs() != outArg)) {
+    return failure();
+  }
+  Value product = addOp.getLhs() == outArg ? addOp.getRhs() : addOp.getLhs();
+  auto mulOp = product.getDefiningOp<arith::MulFOp>();
+  if (!mulOp) {
+    return failure();
+  }
+  auto isExtendedArg = [&](Value value, unsigned argNumber) {
+    if (auto extOp = value.getDefiningOp<arith::ExtFOp>()) {
+      value = extOp.getIn();
+    }
+    return value == body->getArgument(argNumber);
+  };
+  if (!isExtendedArg(mulOp.getLhs(), 0) || !isExtendedArg(mulOp.getRhs(), 1)) {
+    return failure();
+  }
+
+  // Static N0 x K0 tiles, and the same element types as the gemv ukernel.
+  auto rhsType =
+      cast<ShapedType>(genericOp.getDpsInputOperand(1)->get().getType());
+  if (rhsType.isDynamicDim(2) || rhsType.isDynamicDim(3)) {
+    return failure();
+  }
+  Type lhsElemType =
+      getElementTypeOrSelf(genericOp.getDpsInputOperand(0)->get());
+  Type outElemType =
+      getElementTypeOrSelf(genericOp.getDpsInitOperand(0)->get());
+  if (!outElemType.isF32() || lhsElemType != rhsType.getElementType() ||
+      !(lhsElemType.isF32() || lhsElemType.isF16() || lhsElemType.isBF16())) {
+    return failure();
+  }
+  return success();
+}
+
 //===---------------------------------------------------------------------===//
 // Replace Memref users (transitively)
 //===---------------------------------------------------------------------===//
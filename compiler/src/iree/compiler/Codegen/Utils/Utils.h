@@ -9,6 +9,7 @@
 
 #include "iree/compiler/Codegen/Interfaces/PartitionableLoopsInterface.h"
 #include "iree/compiler/Dialect/HAL/IR/HALOps.h"
+#include "iree/compiler/Dialect/LinalgExt/IR/LinalgExtOps.h"
 #include "llvm/ADT/StringMap.h"
 #include "llvm/TargetParser/Triple.h"
 #include "mlir/Dialect/Linalg/IR/Linalg.h"
@@ -69,6 +70,9 @@ bool isVMVXBackend(IREE::HAL::ExecutableTargetAttr targetAttr);
 /// Methods to get target information.
 bool isROCMBackend(IREE::HAL::ExecutableTargetAttr targetAttr);
 
+/// Methods to get target information.
+bool isLLVMCPUBackend(IREE::HAL::ExecutableTargetAttr targetAttr);
+
 // Returns true if the ukernel with given `ukernelName` is enabled.
 // If `ukernelName` is empty (the default), returns true if any ukernel
 // is enabled at all.
@@ -214,6 +218,46 @@ OpFoldResult convertByteOffsetToElementOffset(RewriterBase &rewriter,
 /// Check if a linalg.generic is representing an argmax operation.
 LogicalResult isArgmaxOp(linalg::GenericOp genericOp);
 
+/// Operands of a matmul with grouped dequantization of its i4 weights fused
+/// in, as formed out of FuseDequantizationMatmul-style dispatches:
+///   weights: [N, G, GS] x i4, scales and zero points: [N, G] x f32,
+///   lhs: [G, GS] or [M, G, GS] x f32, out: [N] or [M, N] x f32.
+struct GroupedDequantMatmulOperands {
+  Value lhs;
+  Value weights;
+  Value scales;
+  Value zeroPoints;
+  Value out;
+  // Static number of elements per group (GS).
+  int64_t groupSize;
+};
+
+/// Check if a linalg.generic is a matmul dequantizing its grouped i4 weights
+/// in its body, and return the operands of the computation if so.
+FailureOr<GroupedDequantMatmulOperands>
+getGroupedDequantMatmulOperands(linalg::GenericOp genericOp);
+
+/// Returns true if `softmaxOp` is to be lowered to the softmax ukernel on the
+/// target described by `targetAttr`: the ukernel is enabled on an LLVMCPU
+/// target, the op works on f32 tensors of rank 2 to kNumMaxParallelDims + 1
+/// and normalizes along the innermost dimension. Such ops are kept as
+/// linalg.softmax instead of being decomposed.
+bool isSoftmaxUKernelCandidate(linalg::SoftmaxOp softmaxOp,
+                               IREE::HAL::ExecutableTargetAttr targetAttr);
+
+/// Returns true if `attnOp` is to be lowered to the attention ukernel on the
+/// target described by `targetAttr`: the ukernel is enabled on an LLVMCPU
+/// target, the op is untiled, has static shapes, and its operands all have
+/// the same f32, f16 or bf16 element type.
+bool isAttentionUKernelCandidate(IREE::LinalgExt::AttentionOp attnOp,
+                                 IREE::HAL::ExecutableTargetAttr targetAttr);
+
+/// Check if a linalg.generic is the M == 1 matmul produced by materializing
+/// the encodings of a matmul whose only packed operand is the RHS:
+///   out[N1, N0] += lhs[K1, K0] * rhs[N1, K1, N0, K0]
+/// with f32, f16 or bf16 inputs and a f32 accumulator.
+LogicalResult isPackedGemvOp(linalg::GenericOp genericOp);
+
 /// Replace the uses of memref value `origValue` with the given
 /// `replacementValue`. Some uses of the memref value might require changes to
 /// the operation itself. Create new operations which can carry the change, and
@@ -11,6 +11,7 @@
 #include "iree/compiler/Dialect/Flow/Transforms/ConvertRegionToWorkgroups.h"
 #include "iree/compiler/Dialect/Flow/Transforms/Passes.h"
 #include "iree/compiler/Dialect/Flow/Transforms/RegionOpUtils.h"
+#include "iree/compiler/Dialect/HAL/IR/HALTypes.h"
 #include "iree/compiler/Dialect/LinalgExt/IR/LinalgExtOps.h"
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/TypeSwitch.h"
@@ -282,6 +283,51 @@ static bool isPadUsedInSetEncoding(tensor::PadOp padOp) {
                       llvm::IsaPred<IREE::LinalgExt::SetEncodingOp>);
 }
 
+/// Returns true if `operand` is the LHS of a `linalg.matmul` produced by a
+/// `set_encoding` op with the LHS role, or the LHS of a `linalg.mmt4d` produced
+/// by a `tensor.pack` op (the same `set_encoding` once materialized).
+static bool isLhsPackOfMatmul(OpOperand &operand) {
+  if (operand.getOperandNumber() != 0) {
+    return false;
+  }
+  Operation *producer = operand.get().getDefiningOp();
+  Operation *consumer = operand.getOwner();
+  if (auto setEncodingOp =
+          dyn_cast_or_null<IREE::LinalgExt::SetEncodingOp>(producer)) {
+    auto encoding =
+        IREE::LinalgExt::getEncodingAttr(setEncodingOp.getResultType());
+    return isa<linalg::MatmulOp>(consumer) && encoding &&
+           encoding.getRole().getValue() == IREE::LinalgExt::EncodingRole::LHS;
+  }
+  return isa_and_nonnull<tensor::PackOp>(producer) &&
+         isa<linalg::Mmt4DOp>(consumer);
+}
+
+/// Returns true if every executable target of `op` is an llvm-cpu target with
+/// the pack_mmt4d microkernel enabled. The CPU backend then folds a packed LHS
+/// into the microkernel if the packing is in the same dispatch as the mmt4d.
+static bool isPackMmt4dUkernelEnabled(Operation *op) {
+  auto targetAttrs = IREE::HAL::DeviceTargetAttr::lookupExecutableTargets(op);
+  if (targetAttrs.empty()) {
+    return false;
+  }
+  return llvm::all_of(targetAttrs, [](IREE::HAL::ExecutableTargetAttr attr) {
+    if (attr.getBackend() != "llvm-cpu" || !attr.getConfiguration()) {
+      return false;
+    }
+    auto ukernels = attr.getConfiguration().getAs<StringAttr>("ukernels");
+    if (!ukernels) {
+      return false;
+    }
+    if (ukernels.getValue() == "all") {
+      return true;
+    }
+    SmallVector<StringRef> names;
+    ukernels.getValue().split(names, ',');
+    return llvm::is_contained(names, "pack_mmt4d");
+  });
+}
+
 //===----------------------------------------------------------------------===//
 // Heuristics for fusing dispatchble ops with root ops using tile + fuse.
 //===----------------------------------------------------------------------===//
@@ -700,6 +746,10 @@ isFusableWithProducer(OpOperand &operand,
         .Default([](Operation *) { return false; });
   }
 
+  if (options.fuseLhsPackWithMatmul && isLhsPackOfMatmul(operand)) {
+    return true;
+  }
+
   if (!isa<linalg::LinalgOp>(consumer) || !isa<linalg::LinalgOp>(producer)) {
     return false;
   }
@@ -721,12 +771,21 @@ fuseRootsWithProducers(MLIRContext *context, Operation *root, unsigned groupNum,
   SmallVector<Operation *> worklist;
   worklist.push_back(root);
   llvm::SmallBitVector rootOuterParallelLoops = getOuterParallelLoops(root);
+  // LHS packs fused with a matmul and the `tensor.pad` feeding them. The
+  // dispatch has to read the unpacked LHS for the packing to be folded into
+  // the pack_mmt4d microkernel, so only the `tensor.pad` that becomes part of
+  // the packing is fused with a pack, and nothing is fused with that pad.
+  llvm::SmallPtrSet<Operation *, 2> lhsPackOps;
   while (!worklist.empty()) {
     Operation *candidate = worklist.pop_back_val();
     for (OpOperand &operand : candidate->getOpOperands()) {
       Operation *producer = operand.get().getDefiningOp();
       if (!producer)
         continue;
+      if (lhsPackOps.contains(candidate) &&
+          (isa<tensor::PadOp>(candidate) || !isa<tensor::PadOp>(producer))) {
+        continue;
+      }
       if (isClonableIntoDispatchOp(producer) ||
           hasFusionGroupsAttribute(producer) || hasRootOpAttribute(producer)) {
         continue;
@@ -741,6 +800,10 @@ fuseRootsWithProducers(MLIRContext *context, Operation *root, unsigned groupNum,
         continue;
       }
 
+      if (lhsPackOps.contains(candidate) ||
+          (options.fuseLhsPackWithMatmul && isLhsPackOfMatmul(operand))) {
+        lhsPackOps.insert(producer);
+      }
       appendToFusionGroup(producer, groupNum);
       worklist.push_back(producer);
     }
@@ -936,9 +999,10 @@ void FormDispatchRegionsPass::runOnOperation() {
   mlir::FunctionOpInterface funcOp = getOperation();
   DominanceInfo const &dominanceInfo = getAnalysis<DominanceInfo>();
   TensorDimTrackingRewriter rewriter(funcOp);
-  FormDispatchRegionsPassOptions options{fuseMultiUse, generateWorkloadRegion,
-                                         fusePadWithConsumers,
-                                         fusePadWithProducers};
+  FormDispatchRegionsPassOptions options{
+      fuseMultiUse, generateWorkloadRegion, fusePadWithConsumers,
+      fusePadWithProducers,
+      fuseLhsPackWithMatmul || isPackMmt4dUkernelEnabled(funcOp)};
   if (failed(createFusionGroups(rewriter, funcOp, dominanceInfo, options))) {
     funcOp->emitOpError("failed to create fusion groups");
     return signalPassFailure();
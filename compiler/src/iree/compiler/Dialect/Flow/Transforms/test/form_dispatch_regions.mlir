@@ -609,3 +609,159 @@ module {
 //  CHECK-SAME:       outs(%[[FILL]] :
 //       CHECK:   flow.return %[[MMT4D]] :
 //       CHECK:   util.return %[[DISP]]
+
+// -----
+
+#executable_target = #hal.executable.target<"llvm-cpu", "embedded-elf-x86_64", {ukernels = "mmt4d,pack_mmt4d"}>
+#device_target = #hal.device.target<"llvm-cpu", [#executable_target]>
+module attributes {hal.device.targets = [#device_target]} {
+  util.func public @lhs_pack_mmt4d_fusion(%arg0 : tensor<?x?xf32>,
+      %arg1 : tensor<?x?x16x1xf32>, %arg2 : index, %arg3 : index,
+      %arg4 : index) -> tensor<?x?x16x16xf32> {
+    %cst = arith.constant 0.0 : f32
+    %0 = tensor.empty(%arg2, %arg3) : tensor<?x?x16x1xf32>
+    %1 = tensor.pack %arg0 padding_value(%cst : f32)
+        inner_dims_pos = [0, 1] inner_tiles = [16, 1]
+        into %0 : tensor<?x?xf32> -> tensor<?x?x16x1xf32>
+    %2 = tensor.empty(%arg2, %arg4) : tensor<?x?x16x16xf32>
+    %3 = linalg.fill ins(%cst : f32) outs(%2 : tensor<?x?x16x16xf32>)
+        -> tensor<?x?x16x16xf32>
+    %4 = linalg.mmt4d ins(%1, %arg1 : tensor<?x?x16x1xf32>, tensor<?x?x16x1xf32>)
+        outs(%3 : tensor<?x?x16x16xf32>) -> tensor<?x?x16x16xf32>
+    util.return %4 : tensor<?x?x16x16xf32>
+  }
+}
+// CHECK-LABEL: util.func public @lhs_pack_mmt4d_fusion(
+//  CHECK-SAME:     %[[ARG0:[a-zA-Z0-9]+]]: tensor<?x?xf32>
+//  CHECK-SAME:     %[[ARG1:[a-zA-Z0-9]+]]: tensor<?x?x16x1xf32>
+//   CHECK-NOT:   tensor.pack
+//       CHECK:   %[[RETURN:.+]] = flow.dispatch.region
+//       CHECK:     %[[PACK:.+]] = tensor.pack %[[ARG0]]
+//       CHECK:     %[[MMT4D:.+]] = linalg.mmt4d
+//  CHECK-SAME:         ins(%[[PACK]], %[[ARG1]] :
+//       CHECK:     flow.return %[[MMT4D]]
+//       CHECK:   util.return %[[RETURN]]
+
+// -----
+
+#executable_target = #hal.executable.target<"llvm-cpu", "embedded-elf-x86_64", {ukernels = "mmt4d"}>
+#device_target = #hal.device.target<"llvm-cpu", [#executable_target]>
+module attributes {hal.device.targets = [#device_target]} {
+  util.func public @lhs_pack_mmt4d_no_fusion(%arg0 : tensor<?x?xf32>,
+      %arg1 : tensor<?x?x16x1xf32>, %arg2 : index, %arg3 : index,
+      %arg4 : index) -> tensor<?x?x16x16xf32> {
+    %cst = arith.constant 0.0 : f32
+    %0 = tensor.empty(%arg2, %arg3) : tensor<?x?x16x1xf32>
+    %1 = tensor.pack %arg0 padding_value(%cst : f32)
+        inner_dims_pos = [0, 1] inner_tiles = [16, 1]
+        into %0 : tensor<?x?xf32> -> tensor<?x?x16x1xf32>
+    %2 = tensor.empty(%arg2, %arg4) : tensor<?x?x16x16xf32>
+    %3 = linalg.fill ins(%cst : f32) outs(%2 : tensor<?x?x16x16xf32>)
+        -> tensor<?x?x16x16xf32>
+    %4 = linalg.mmt4d ins(%1, %arg1 : tensor<?x?x16x1xf32>, tensor<?x?x16x1xf32>)
+        outs(%3 : tensor<?x?x16x16xf32>) -> tensor<?x?x16x16xf32>
+    util.return %4 : tensor<?x?x16x16xf32>
+  }
+}
+// CHECK-LABEL: util.func public @lhs_pack_mmt4d_no_fusion(
+//  CHECK-SAME:     %[[ARG0:[a-zA-Z0-9]+]]: tensor<?x?xf32>
+//       CHECK:   %[[PACK_DISPATCH:.+]] = flow.dispatch.region
+//       CHECK:     %[[PACK:.+]] = tensor.pack %[[ARG0]]
+//       CHECK:     flow.return %[[PACK]]
+//       CHECK:   %[[RETURN:.+]] = flow.dispatch.region
+//       CHECK:     %[[MMT4D:.+]] = linalg.mmt4d
+//  CHECK-SAME:         ins(%[[PACK_DISPATCH]],
+//       CHECK:     flow.return %[[MMT4D]]
+//       CHECK:   util.return %[[RETURN]]
+
+// -----
+
+#executable_target = #hal.executable.target<"llvm-cpu", "embedded-elf-x86_64", {ukernels = "all"}>
+#device_target = #hal.device.target<"llvm-cpu", [#executable_target]>
+module attributes {hal.device.targets = [#device_target]} {
+  util.func public @lhs_set_encoding_matmul_fusion(%arg0 : tensor<?x?xf32>,
+      %arg1 : tensor<?x?xf32, #iree_linalg_ext.encoding<role = RHS, element_types = [f32, f32, f32]>>,
+      %arg2 : index, %arg3 : index, %arg4 : index, %arg5 : index)
+      -> tensor<?x?xf32, #iree_linalg_ext.encoding<role = RESULT, element_types = [f32, f32, f32]>> {
+    %cst = arith.constant 0.0 : f32
+    %0 = tensor.pad %arg0 low[0, 0] high[%arg2, %arg3] {
+      ^bb0(%b0: index, %b1 : index):
+        tensor.yield %cst : f32
+    } : tensor<?x?xf32> to tensor<?x?xf32>
+    %1 = iree_linalg_ext.set_encoding %0
+        : tensor<?x?xf32> -> tensor<?x?xf32, #iree_linalg_ext.encoding<role = LHS, element_types = [f32, f32, f32]>>
+    %2 = tensor.empty(%arg4, %arg5) : tensor<?x?xf32, #iree_linalg_ext.encoding<role = RESULT, element_types = [f32, f32, f32]>>
+    %3 = linalg.fill ins(%cst : f32) outs(%2 : tensor<?x?xf32, #iree_linalg_ext.encoding<role = RESULT, element_types = [f32, f32, f32]>>)
+        -> tensor<?x?xf32, #iree_linalg_ext.encoding<role = RESULT, element_types = [f32, f32, f32]>>
+    %4 = linalg.matmul
+        ins(%1, %arg1
+            : tensor<?x?xf32, #iree_linalg_ext.encoding<role = LHS, element_types = [f32, f32, f32]>>,
+              tensor<?x?xf32, #iree_linalg_ext.encoding<role = RHS, element_types = [f32, f32, f32]>>)
+        outs(%3 : tensor<?x?xf32, #iree_linalg_ext.encoding<role = RESULT, element_types = [f32, f32, f32]>>)
+        -> tensor<?x?xf32, #iree_linalg_ext.encoding<role = RESULT, element_types = [f32, f32, f32]>>
+    util.return %4 : tensor<?x?xf32, #iree_linalg_ext.encoding<role = RESULT, element_types = [f32, f32, f32]>>
+  }
+}
+// CHECK-LABEL: util.func public @lhs_set_encoding_matmul_fusion(
+//  CHECK-SAME:     %[[ARG0:[a-zA-Z0-9]+]]: tensor<?x?xf32>
+//  CHECK-SAME:     %[[ARG1:[a-zA-Z0-9]+]]: tensor<?x?xf32, #iree_linalg_ext.encoding<role = RHS
+//       CHECK:   %[[RETURN:.+]] = flow.dispatch.region
+//       CHECK:     %[[PAD:.+]] = tensor.pad %[[ARG0]]
+//       CHECK:     %[[ENCODING:.+]] = iree_linalg_ext.set_encoding %[[PAD]]
+//       CHECK:     %[[MATMUL:.+]] = linalg.matmul
+//  CHECK-SAME:         ins(%[[ENCODING]], %[[ARG1]] :
+//       CHECK:     flow.return %[[MATMUL]]
+//       CHECK:   util.return %[[RETURN]]
+
+// -----
+
+#executable_target = #hal.executable.target<"llvm-cpu", "embedded-elf-x86_64", {ukernels = "all"}>
+#device_target = #hal.device.target<"llvm-cpu", [#executable_target]>
+#map = affine_map<(d0, d1) -> (d0, d1)>
+module attributes {hal.device.targets = [#device_target]} {
+  util.func public @lhs_set_encoding_matmul_no_producer_fusion(%arg0 : tensor<?x?xf32>,
+      %arg1 : tensor<?x?xf32, #iree_linalg_ext.encoding<role = RHS, element_types = [f32, f32, f32]>>,
+      %arg2 : index, %arg3 : index, %arg4 : index, %arg5 : index)
+      -> tensor<?x?xf32, #iree_linalg_ext.encoding<role = RESULT, element_types = [f32, f32, f32]>> {
+    %cst = arith.constant 0.0 : f32
+    %c0 = arith.constant 0 : index
+    %c1 = arith.constant 1 : index
+    %d0 = tensor.dim %arg0, %c0 : tensor<?x?xf32>
+    %d1 = tensor.dim %arg0, %c1 : tensor<?x?xf32>
+    %0 = tensor.empty(%d0, %d1) : tensor<?x?xf32>
+    %1 = linalg.generic {
+        indexing_maps = [#map, #map], iterator_types = ["parallel", "parallel"]}
+        ins(%arg0 : tensor<?x?xf32>) outs(%0 : tensor<?x?xf32>) {
+      ^bb0(%b0 : f32, %b1 : f32):
+        %2 = arith.negf %b0 : f32
+        linalg.yield %2 : f32
+    } -> tensor<?x?xf32>
+    %3 = tensor.pad %1 low[0, 0] high[%arg2, %arg3] {
+      ^bb0(%b0: index, %b1 : index):
+        tensor.yield %cst : f32
+    } : tensor<?x?xf32> to tensor<?x?xf32>
+    %4 = iree_linalg_ext.set_encoding %3
+        : tensor<?x?xf32> -> tensor<?x?xf32, #iree_linalg_ext.encoding<role = LHS, element_types = [f32, f32, f32]>>
+    %5 = tensor.empty(%arg4, %arg5) : tensor<?x?xf32, #iree_linalg_ext.encoding<role = RESULT, element_types = [f32, f32, f32]>>
+    %6 = linalg.fill ins(%cst : f32) outs(%5 : tensor<?x?xf32, #iree_linalg_ext.encoding<role = RESULT, element_types = [f32, f32, f32]>>)
+        -> tensor<?x?xf32, #iree_linalg_ext.encoding<role = RESULT, element_types = [f32, f32, f32]>>
+    %7 = linalg.matmul
+        ins(%4, %arg1
+            : tensor<?x?xf32, #iree_linalg_ext.encoding<role = LHS, element_types = [f32, f32, f32]>>,
+              tensor<?x?xf32, #iree_linalg_ext.encoding<role = RHS, element_types = [f32, f32, f32]>>)
+        outs(%6 : tensor<?x?xf32, #iree_linalg_ext.encoding<role = RESULT, element_types = [f32, f32, f32]>>)
+        -> tensor<?x?xf32, #iree_linalg_ext.encoding<role = RESULT, element_types = [f32, f32, f32]>>
+    util.return %7 : tensor<?x?xf32, #iree_linalg_ext.encoding<role = RESULT, element_types = [f32, f32, f32]>>
+  }
+}
+// CHECK-LABEL: util.func public @lhs_set_encoding_matmul_no_producer_fusion(
+//       CHECK:   %[[GENERIC_DISPATCH:.+]] = flow.dispatch.region
+//       CHECK:     %[[GENERIC:.+]] = linalg.generic
+//       CHECK:     flow.return %[[GENERIC]]
+//       CHECK:   %[[RETURN:.+]] = flow.dispatch.region
+//       CHECK:     %[[PAD:.+]] = tensor.pad %[[GENERIC_DISPATCH]]
+//       CHECK:     %[[ENCODING:.+]] = iree_linalg_ext.set_encoding %[[PAD]]
+//       CHECK:     %[[MATMUL:.+]] = linalg.matmul
+//  CHECK-SAME:         ins(%[[ENCODING]],
+//       CHECK:     flow.return %[[MATMUL]]
+//       CHECK:   util.return %[[RETURN]]
@@ -159,3 +159,321 @@ void iree_memory_flush_icache(void* base_address, iree_host_size_t length) {
 }
 
 #endif  // IREE_PLATFORM_*
+
+//===----------------------------------------------------------------------===//
+// Access pattern hints
+//===----------------------------------------------------------------------===//
+
+#if defined(IREE_PLATFORM_ANDROID) || defined(IREE_PLATFORM_APPLE) || \
+    defined(IREE_PLATFORM_LINUX)
+
+#include <sys/mman.h>
+
+void iree_memory_advise(const void* base_address, iree_host_size_t length,
+                        iree_memory_advice_t advice) {
+  if (!base_address || !length || advice == IREE_MEMORY_ADVICE_NONE) return;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, length);
+
+  // madvise requires a page-aligned base address.
+  const iree_host_size_t page_size = iree_memory_query_info().normal_page_size;
+  uintptr_t range_start =
+      (uintptr_t)base_address & ~((uintptr_t)page_size - 1);
+  iree_host_size_t range_length =
+      length + (iree_host_size_t)((uintptr_t)base_address - range_start);
+
+  // Sequential goes first so that the readahead window used when servicing the
+  // will-need request is already widened.
+  if (iree_all_bits_set(advice, IREE_MEMORY_ADVICE_SEQUENTIAL)) {
+    madvise((void*)range_start, range_length, MADV_SEQUENTIAL);
+  }
+  if (iree_all_bits_set(advice, IREE_MEMORY_ADVICE_WILL_NEED)) {
+    madvise((void*)range_start, range_length, MADV_WILLNEED);
+  }
+
+  // Releasing pages shrinks the range inward so that neighboring ranges that
+  // share the boundary pages are not affected.
+  if (iree_all_bits_set(advice, IREE_MEMORY_ADVICE_DONT_NEED)) {
+    uintptr_t release_start =
+        ((uintptr_t)base_address + page_size - 1) & ~((uintptr_t)page_size - 1);
+    uintptr_t release_end =
+        ((uintptr_t)base_address + length) & ~((uintptr_t)page_size - 1);
+    if (release_end > release_start) {
+      madvise((void*)release_start, release_end - release_start,
+              MADV_DONTNEED);
+    }
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+#elif defined(IREE_PLATFORM_WINDOWS)
+
+#if WINAPI_FAMILY_PARTITION(WINAPI_PARTITION_DESKTOP) && \
+    (_WIN32_WINNT >= 0x0602)
+
+void iree_memory_advise(const void* base_address, iree_host_size_t length,
+                        iree_memory_advice_t advice) {
+  if (!base_address || !length) return;
+  // Windows has no sequential access hint for existing views; the best we can
+  // do is prefetch the pages. Releasing pages of file views is not supported
+  // and the system is left to trim the working set on its own.
+  if (!iree_all_bits_set(advice, IREE_MEMORY_ADVICE_WILL_NEED)) return;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, length);
+  WIN32_MEMORY_RANGE_ENTRY range_entry = {
+      .VirtualAddress = (PVOID)base_address,
+      .NumberOfBytes = (SIZE_T)length,
+  };
+  PrefetchVirtualMemory(GetCurrentProcess(), 1, &range_entry, 0);
+  IREE_TRACE_ZONE_END(z0);
+}
+
+#else
+
+void iree_memory_advise(const void* base_address, iree_host_size_t length,
+                        iree_memory_advice_t advice) {
+  // PrefetchVirtualMemory is only available to desktop apps on Windows 8+.
+}
+
+#endif  // WINAPI_PARTITION_DESKTOP
+
+#else
+
+void iree_memory_advise(const void* base_address, iree_host_size_t length,
+                        iree_memory_advice_t advice) {
+  // No hinting support on this platform.
+}
+
+#endif  // IREE_PLATFORM_*
+
+//===----------------------------------------------------------------------===//
+// NUMA-aware allocation
+//===----------------------------------------------------------------------===//
+
+#if defined(IREE_PLATFORM_ANDROID) || defined(IREE_PLATFORM_LINUX) || \
+    defined(IREE_PLATFORM_WINDOWS)
+#define IREE_MEMORY_NUMA_PAGES 1
+#endif  // IREE_PLATFORM_*
+
+#if defined(IREE_MEMORY_NUMA_PAGES)
+
+#if defined(IREE_PLATFORM_ANDROID) || defined(IREE_PLATFORM_LINUX)
+
+#include <errno.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+// Policy values from linux/mempolicy.h. We only need the raw syscall and avoid
+// taking a dependency on the kernel headers (or libnuma).
+#define IREE_LINUX_MPOL_PREFERRED 1
+#define IREE_LINUX_MPOL_BIND 2
+#define IREE_LINUX_MPOL_INTERLEAVE 3
+
+// Applies the NUMA |params| to the pages in the given range.
+// Kernels built without NUMA support return ENOSYS; they only have a single
+// node and the pages remain usable with the default placement. Any other
+// failure (nodes that don't exist, policies denied by the sandbox, etc) is
+// returned as an error instead of silently ignoring the requested policy.
+static iree_status_t iree_memory_numa_apply_policy(
+    const iree_memory_numa_params_t* params, void* base_address,
+    iree_host_size_t length) {
+#if defined(SYS_mbind)
+  int mode = 0;
+  switch (params->policy) {
+    case IREE_MEMORY_NUMA_POLICY_PREFERRED:
+      mode = IREE_LINUX_MPOL_PREFERRED;
+      break;
+    case IREE_MEMORY_NUMA_POLICY_BIND:
+      mode = IREE_LINUX_MPOL_BIND;
+      break;
+    case IREE_MEMORY_NUMA_POLICY_INTERLEAVE:
+      mode = IREE_LINUX_MPOL_INTERLEAVE;
+      break;
+    default:
+      return iree_ok_status();
+  }
+  uint64_t node_mask = params->node_mask;
+  if (!node_mask) return iree_ok_status();
+  if (mode == IREE_LINUX_MPOL_PREFERRED) {
+    // Preferred only accepts a single node; use the lowest specified.
+    node_mask &= ~node_mask + 1;
+  }
+  // The kernel takes the mask as an array of unsigned longs and (due to an
+  // ancient off-by-one) one more than the number of valid bits.
+  unsigned long nodes[sizeof(uint64_t) / sizeof(unsigned long)];
+  memcpy(nodes, &node_mask, sizeof(nodes));
+  if (syscall(SYS_mbind, base_address, length, mode, nodes,
+              sizeof(node_mask) * 8 + 1, 0) != 0 &&
+      errno != ENOSYS) {
+    return iree_make_status(iree_status_code_from_errno(errno),
+                            "mbind failed to apply NUMA policy %d with node "
+                            "mask 0x%016" PRIx64 " to %" PRIhsz " bytes",
+                            (int)params->policy, params->node_mask, length);
+  }
+#endif  // SYS_mbind
+  return iree_ok_status();
+}
+
+static iree_status_t iree_memory_numa_allocate_pages(
+    const iree_memory_numa_params_t* params, iree_host_size_t length,
+    void** out_base_address) {
+  void* base_address = mmap(NULL, length, PROT_READ | PROT_WRITE,
+                            MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (base_address == MAP_FAILED) {
+    return iree_make_status(iree_status_code_from_errno(errno),
+                            "mmap failed to allocate %" PRIhsz " bytes",
+                            length);
+  }
+  // Must happen before any page is touched as the policy only applies to pages
+  // faulted in after it is set.
+  iree_status_t status =
+      iree_memory_numa_apply_policy(params, base_address, length);
+  if (!iree_status_is_ok(status)) {
+    munmap(base_address, length);
+    return status;
+  }
+  *out_base_address = base_address;
+  return iree_ok_status();
+}
+
+static void iree_memory_numa_free_pages(void* base_address,
+                                        iree_host_size_t length) {
+  munmap(base_address, length);
+}
+
+#elif defined(IREE_PLATFORM_WINDOWS)
+
+#include "iree/base/internal/math.h"
+
+static iree_status_t iree_memory_numa_allocate_pages(
+    const iree_memory_numa_params_t* params, iree_host_size_t length,
+    void** out_base_address) {
+  void* base_address = NULL;
+  if (params->node_mask &&
+      (params->policy == IREE_MEMORY_NUMA_POLICY_PREFERRED ||
+       params->policy == IREE_MEMORY_NUMA_POLICY_BIND)) {
+    // Windows only supports a preferred node on allocation and has no strict
+    // binding or interleaving.
+    DWORD node = (DWORD)iree_math_count_trailing_zeros_u64(params->node_mask);
+    base_address =
+        VirtualAllocExNuma(GetCurrentProcess(), NULL, length,
+                           MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE, node);
+  } else {
+    base_address =
+        VirtualAlloc(NULL, length, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+  }
+  if (!base_address) {
+    return iree_make_status(iree_status_code_from_win32_error(GetLastError()),
+                            "VirtualAlloc failed to allocate %" PRIhsz
+                            " bytes",
+                            length);
+  }
+  *out_base_address = base_address;
+  return iree_ok_status();
+}
+
+static void iree_memory_numa_free_pages(void* base_address,
+                                        iree_host_size_t length) {
+  VirtualFree(base_address, 0, MEM_RELEASE);
+}
+
+#endif  // IREE_PLATFORM_*
+
+// Header prefixed to each allocation made by iree_allocator_numa.
+// The user pointer starts at IREE_MEMORY_NUMA_HEADER_SIZE from the base of the
+// pages and will have at least iree_max_align_t alignment.
+typedef struct iree_memory_numa_header_t {
+  // Total size of the pages allocated, including the header.
+  iree_host_size_t page_length;
+  // Size of the user allocation following the header.
+  iree_host_size_t byte_length;
+} iree_memory_numa_header_t;
+#define IREE_MEMORY_NUMA_HEADER_SIZE \
+  iree_sizeof_struct(iree_memory_numa_header_t)
+
+static iree_status_t iree_allocator_numa_alloc(
+    const iree_memory_numa_params_t* numa_params,
+    const iree_allocator_alloc_params_t* params, void** out_ptr) {
+  const iree_host_size_t page_size = iree_memory_query_info().normal_page_size;
+  const iree_host_size_t page_length = iree_host_align(
+      IREE_MEMORY_NUMA_HEADER_SIZE + params->byte_length, page_size);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)page_length);
+
+  // Fresh pages from the system are always zeroed so CALLOC is free.
+  void* base_address = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_memory_numa_allocate_pages(numa_params, page_length,
+                                          &base_address));
+  iree_memory_numa_header_t* header = (iree_memory_numa_header_t*)base_address;
+  header->page_length = page_length;
+  header->byte_length = params->byte_length;
+  *out_ptr = (uint8_t*)base_address + IREE_MEMORY_NUMA_HEADER_SIZE;
+  IREE_TRACE_ALLOC_NAMED("numa", *out_ptr, params->byte_length);
+
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+static void iree_allocator_numa_free(void* ptr) {
+  if (!ptr) return;
+  IREE_TRACE_FREE_NAMED("numa", ptr);
+  iree_memory_numa_header_t* header =
+      (iree_memory_numa_header_t*)((uint8_t*)ptr -
+                                   IREE_MEMORY_NUMA_HEADER_SIZE);
+  iree_memory_numa_free_pages(header, header->page_length);
+}
+
+iree_status_t iree_allocator_numa_ctl(void* self,
+                                      iree_allocator_command_t command,
+                                      const void* params, void** inout_ptr) {
+  const iree_memory_numa_params_t* numa_params =
+      (const iree_memory_numa_params_t*)self;
+  switch (command) {
+    case IREE_ALLOCATOR_COMMAND_MALLOC:
+    case IREE_ALLOCATOR_COMMAND_CALLOC:
+      return iree_allocator_numa_alloc(
+          numa_params, (const iree_allocator_alloc_params_t*)params,
+          inout_ptr);
+    case IREE_ALLOCATOR_COMMAND_REALLOC: {
+      // Reallocation is rare for the large blocks this is used for so we just
+      // allocate new pages (with the same policy) and copy.
+      void* old_ptr = *inout_ptr;
+      void* new_ptr = NULL;
+      IREE_RETURN_IF_ERROR(iree_allocator_numa_alloc(
+          numa_params, (const iree_allocator_alloc_params_t*)params,
+          &new_ptr));
+      if (old_ptr) {
+        const iree_memory_numa_header_t* old_header =
+            (const iree_memory_numa_header_t*)((uint8_t*)old_ptr -
+                                               IREE_MEMORY_NUMA_HEADER_SIZE);
+        memcpy(new_ptr, old_ptr,
+               iree_min(old_header->byte_length,
+                        ((const iree_allocator_alloc_params_t*)params)
+                            ->byte_length));
+        iree_allocator_numa_free(old_ptr);
+      }
+      *inout_ptr = new_ptr;
+      return iree_ok_status();
+    }
+    case IREE_ALLOCATOR_COMMAND_FREE:
+      iree_allocator_numa_free(*inout_ptr);
+      return iree_ok_status();
+    default:
+      return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                              "unsupported NUMA allocator command");
+  }
+}
+
+#else
+
+iree_status_t iree_allocator_numa_ctl(void* self,
+                                      iree_allocator_command_t command,
+                                      const void* params, void** inout_ptr) {
+  // No NUMA support on this platform; behave as the system allocator.
+  return iree_allocator_system_ctl(NULL, command, params, inout_ptr);
+}
+
+#endif  // IREE_MEMORY_NUMA_PAGES
@@ -68,6 +68,90 @@ void iree_memory_jit_context_end(void);
 // executing code from any pages that have been written during load.
 void iree_memory_flush_icache(void* base_address, iree_host_size_t length);
 
+//===----------------------------------------------------------------------===//
+// Access pattern hints
+//===----------------------------------------------------------------------===//
+
+enum iree_memory_advice_bits_e {
+  IREE_MEMORY_ADVICE_NONE = 0u,
+
+  // Pages will be accessed soon and the system should begin reading them in
+  // (for file-backed mappings) asynchronously.
+  IREE_MEMORY_ADVICE_WILL_NEED = 1u << 0,
+
+  // Pages will be accessed once in ascending order. The system may read ahead
+  // more aggressively and reclaim pages soon after they have been accessed.
+  IREE_MEMORY_ADVICE_SEQUENTIAL = 1u << 1,
+
+  // Pages will not be accessed soon and the system may reclaim them. Only
+  // pages entirely within the range are released. File-backed mappings (shared
+  // or private) fault the pages back in from the file on next access, though
+  // private mappings lose any modifications made to them, while anonymous
+  // mappings (heap memory) observe zeros: only use this on ranges whose
+  // contents can be rematerialized from their backing file.
+  IREE_MEMORY_ADVICE_DONT_NEED = 1u << 2,
+};
+typedef uint32_t iree_memory_advice_t;
+
+// Hints to the system how the pages spanning [base_address, base_address +
+// length) will be accessed. The range is expanded to page boundaries (except
+// when releasing pages with IREE_MEMORY_ADVICE_DONT_NEED).
+// Hints are best-effort: they are ignored on platforms that don't support them
+// and failures are dropped as the caller can always fall back to faulting.
+void iree_memory_advise(const void* base_address, iree_host_size_t length,
+                        iree_memory_advice_t advice);
+
+//===----------------------------------------------------------------------===//
+// NUMA-aware allocation
+//===----------------------------------------------------------------------===//
+
+// Defines how pages of an allocation are placed across NUMA nodes.
+typedef enum iree_memory_numa_policy_e {
+  // Uses the system default policy (usually first-touch).
+  IREE_MEMORY_NUMA_POLICY_DEFAULT = 0,
+  // Prefers placing pages on the lowest node in the node mask and falls back to
+  // other nodes if that node is out of memory.
+  IREE_MEMORY_NUMA_POLICY_PREFERRED,
+  // Strictly places pages on the nodes in the node mask. Allocations may fail
+  // (or the process may be killed on overcommitting systems) if the nodes are
+  // out of memory. Not all platforms support strict binding and may treat this
+  // as IREE_MEMORY_NUMA_POLICY_PREFERRED.
+  IREE_MEMORY_NUMA_POLICY_BIND,
+  // Interleaves pages round-robin across all nodes in the node mask. Useful
+  // for large shared allocations accessed by workers on all nodes. Platforms
+  // that don't support interleaving will use the system default policy.
+  IREE_MEMORY_NUMA_POLICY_INTERLEAVE,
+} iree_memory_numa_policy_t;
+
+// Parameters controlling NUMA placement of allocations.
+typedef struct iree_memory_numa_params_t {
+  // Policy used to place allocation pages.
+  iree_memory_numa_policy_t policy;
+  // Bitmask of NUMA nodes (bit N = node N) the policy applies to. Ignored for
+  // IREE_MEMORY_NUMA_POLICY_DEFAULT. Nodes >= 64 are not supported.
+  uint64_t node_mask;
+} iree_memory_numa_params_t;
+
+// Allocator controller used by iree_allocator_numa.
+// |self| must point to an iree_memory_numa_params_t.
+iree_status_t iree_allocator_numa_ctl(void* self,
+                                      iree_allocator_command_t command,
+                                      const void* params, void** inout_ptr);
+
+// Returns an allocator that places allocations according to |params|.
+// Allocations are made with page granularity directly from the system and are
+// only suitable for large long-lived blocks such as buffer storage. On
+// platforms without NUMA support this behaves like iree_allocator_system.
+//
+// |params| must remain valid for as long as allocations or reallocations are
+// made with the allocator. Frees do not access |params| and may be performed
+// after it has been released.
+static inline iree_allocator_t iree_allocator_numa(
+    const iree_memory_numa_params_t* params) {
+  iree_allocator_t v = {(void*)params, iree_allocator_numa_ctl};
+  return v;
+}
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -0,0 +1,97 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/base/internal/memory.h"
+
+#include <cstdint>
+#include <cstring>
+
+#include "iree/base/api.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace {
+
+// Fills |length| bytes at |ptr| with a pattern derived from |seed|.
+static void FillPattern(void* ptr, iree_host_size_t length, uint8_t seed) {
+  uint8_t* bytes = (uint8_t*)ptr;
+  for (iree_host_size_t i = 0; i < length; ++i) {
+    bytes[i] = (uint8_t)(seed + i);
+  }
+}
+
+// Returns true if |length| bytes at |ptr| match FillPattern with |seed|.
+static bool CheckPattern(const void* ptr, iree_host_size_t length,
+                         uint8_t seed) {
+  const uint8_t* bytes = (const uint8_t*)ptr;
+  for (iree_host_size_t i = 0; i < length; ++i) {
+    if (bytes[i] != (uint8_t)(seed + i)) return false;
+  }
+  return true;
+}
+
+TEST(NumaAllocatorTest, DefaultPolicy) {
+  iree_memory_numa_params_t params = {IREE_MEMORY_NUMA_POLICY_DEFAULT, 0};
+  iree_allocator_t allocator = iree_allocator_numa(&params);
+
+  void* ptr = NULL;
+  IREE_ASSERT_OK(iree_allocator_malloc(allocator, 123, &ptr));
+  ASSERT_NE(ptr, nullptr);
+  EXPECT_EQ(0, (uintptr_t)ptr % iree_max_align_t);
+  // Fresh pages are zeroed as CALLOC is implied by iree_allocator_malloc.
+  const uint8_t zeros[123] = {0};
+  EXPECT_EQ(0, memcmp(ptr, zeros, sizeof(zeros)));
+  FillPattern(ptr, 123, 7);
+
+  // Growing across a page boundary preserves the contents.
+  IREE_ASSERT_OK(iree_allocator_realloc(allocator, 64 * 1024, &ptr));
+  EXPECT_TRUE(CheckPattern(ptr, 123, 7));
+
+  // Shrinking preserves the remaining contents.
+  IREE_ASSERT_OK(iree_allocator_realloc(allocator, 16, &ptr));
+  EXPECT_TRUE(CheckPattern(ptr, 16, 7));
+
+  iree_allocator_free(allocator, ptr);
+}
+
+TEST(NumaAllocatorTest, PolicyOnCurrentNodes) {
+  // Node 0 always exists and every policy must either apply or be ignored.
+  const iree_memory_numa_policy_t policies[] = {
+      IREE_MEMORY_NUMA_POLICY_PREFERRED,
+      IREE_MEMORY_NUMA_POLICY_BIND,
+      IREE_MEMORY_NUMA_POLICY_INTERLEAVE,
+  };
+  for (iree_memory_numa_policy_t policy : policies) {
+    iree_memory_numa_params_t params = {policy, 0x1ull};
+    iree_allocator_t allocator = iree_allocator_numa(&params);
+    void* ptr = NULL;
+    IREE_ASSERT_OK(iree_allocator_malloc(allocator, 3 * 4096 + 5, &ptr));
+    FillPattern(ptr, 3 * 4096 + 5, (uint8_t)policy);
+    EXPECT_TRUE(CheckPattern(ptr, 3 * 4096 + 5, (uint8_t)policy));
+    iree_allocator_free(allocator, ptr);
+  }
+}
+
+#if defined(IREE_PLATFORM_LINUX) || defined(IREE_PLATFORM_ANDROID)
+TEST(NumaAllocatorTest, BindToMissingNodeFails) {
+  // No system has 64 nodes with the last one online and no others.
+  iree_memory_numa_params_t params = {IREE_MEMORY_NUMA_POLICY_BIND,
+                                      0x1ull << 63};
+  iree_allocator_t allocator = iree_allocator_numa(&params);
+  void* ptr = NULL;
+  iree_status_t status = iree_allocator_malloc(allocator, 4096, &ptr);
+  if (iree_status_is_ok(status)) {
+    // Kernels without NUMA support accept any policy.
+    iree_allocator_free(allocator, ptr);
+    GTEST_SKIP() << "kernel does not support NUMA policies";
+  }
+  IREE_EXPECT_STATUS_IS(IREE_STATUS_INVALID_ARGUMENT,
+                        iree::Status(std::move(status)));
+  EXPECT_EQ(ptr, nullptr);
+}
+#endif  // IREE_PLATFORM_LINUX || IREE_PLATFORM_ANDROID
+
+}  // namespace
@@ -0,0 +1,239 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/arm_64/attention_arm_64_internal.h"
+#include "iree/builtins/ukernel/arch/arm_64/common_arm_64.h"
+
+// Loads 4 consecutive elements of the given type as f32.
+IREE_UK_ATTRIBUTE_ALWAYS_INLINE static inline float32x4_t
+iree_uk_attention_neon_load_f32x4(const void* ptr, iree_uk_type_t type) {
+  switch (type) {
+    case IREE_UK_TYPE_FLOAT_16:
+      return vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(ptr)));
+    case IREE_UK_TYPE_BFLOAT_16:
+      return vreinterpretq_f32_u32(vshll_n_u16(vld1_u16(ptr), 16));
+    default:
+      return vld1q_f32(ptr);
+  }
+}
+
+// Stores 4 f32 values as consecutive elements of the given type.
+IREE_UK_ATTRIBUTE_ALWAYS_INLINE static inline void
+iree_uk_attention_neon_store_f32x4(void* ptr, float32x4_t value,
+                                   iree_uk_type_t type) {
+  switch (type) {
+    case IREE_UK_TYPE_FLOAT_16:
+      vst1_u16(ptr, vreinterpret_u16_f16(vcvt_f16_f32(value)));
+      break;
+    case IREE_UK_TYPE_BFLOAT_16: {
+      float values[4];
+      vst1q_f32(values, value);
+      for (int i = 0; i < 4; ++i) {
+        ((iree_uk_uint16_t*)ptr)[i] = iree_uk_f32_to_bf16(values[i]);
+      }
+      break;
+    }
+    default:
+      vst1q_f32(ptr, value);
+      break;
+  }
+}
+
+// Writes to `result[i]` the dot product of a_rows[i] with b, all of them
+// `size` elements long.
+IREE_UK_ATTRIBUTE_ALWAYS_INLINE static inline void
+iree_uk_attention_neon_dot_8x1(const void* const* a_rows,
+                               iree_uk_type_t a_type, const void* b,
+                               iree_uk_type_t b_type, iree_uk_index_t size,
+                               float* result) {
+  iree_uk_index_t a_elem_size = iree_uk_type_size(a_type);
+  iree_uk_index_t b_elem_size = iree_uk_type_size(b_type);
+  float32x4_t dot[IREE_UK_ATTENTION_BLOCK_M];
+  IREE_UK_UNROLL for (int i = 0; i < IREE_UK_ATTENTION_BLOCK_M; ++i) {
+    dot[i] = vdupq_n_f32(0.f);
+  }
+  iree_uk_index_t c = 0;
+  for (; c + 4 <= size; c += 4) {
+    float32x4_t b_v = iree_uk_attention_neon_load_f32x4(
+        (const char*)b + c * b_elem_size, b_type);
+    IREE_UK_UNROLL for (int i = 0; i < IREE_UK_ATTENTION_BLOCK_M; ++i) {
+      float32x4_t a_v = iree_uk_attention_neon_load_f32x4(
+          (const char*)a_rows[i] + c * a_elem_size, a_type);
+      dot[i] = vfmaq_f32(dot[i], a_v, b_v);
+    }
+  }
+  for (int i = 0; i < IREE_UK_ATTENTION_BLOCK_M; ++i) {
+    float r = vaddvq_f32(dot[i]);
+    for (iree_uk_index_t t = c; t < size; ++t) {
+      r += iree_uk_attention_load(a_rows[i], t, a_type) *
+           iree_uk_attention_load(b, t, b_type);
+    }
+    result[i] = r;
+  }
+}
+
+IREE_UK_ATTRIBUTE_ALWAYS_INLINE static inline void
+iree_uk_attention_tile_arm_64(
+    void* IREE_UK_RESTRICT out_rows, const void* IREE_UK_RESTRICT q_rows,
+    const void* IREE_UK_RESTRICT k, const void* IREE_UK_RESTRICT v,
+    iree_uk_index_t rows, const iree_uk_attention_params_t* params,
+    iree_uk_type_t in_type, iree_uk_type_t out_type) {
+  enum { R = IREE_UK_ATTENTION_BLOCK_M };
+  iree_uk_index_t K1 = params->K1;
+  iree_uk_index_t K2 = params->K2;
+  iree_uk_index_t N = params->N;
+  iree_uk_index_t in_elem_size = iree_uk_type_size(in_type);
+  iree_uk_index_t out_elem_size = iree_uk_type_size(out_type);
+  iree_uk_index_t k_row_stride = params->k_stride1 * in_elem_size;
+  iree_uk_index_t v_row_stride = params->v_stride1 * in_elem_size;
+  bool transpose_v = params->flags & IREE_UK_FLAG_ATTENTION_TRANSPOSE_V;
+  // Missing q rows in a partial tile alias the last one, so that the loops
+  // below always run over R rows; their results are never stored.
+  const void* q_row_ptrs[R];
+  for (int i = 0; i < R; ++i) {
+    q_row_ptrs[i] = (const char*)q_rows + iree_uk_index_min(i, rows - 1) *
+                                              params->q_stride1 * in_elem_size;
+  }
+  // Scores, then probabilities, one row per q row.
+  float s[R][IREE_UK_ATTENTION_BLOCK_K2];
+  const void* s_row_ptrs[R];
+  for (int i = 0; i < R; ++i) s_row_ptrs[i] = s[i];
+  float acc[R][IREE_UK_ATTENTION_BLOCK_N];
+  float row_max[R];
+  float row_sum[R];
+  float corrections[R];
+  float dots[R];
+  for (iree_uk_index_t n0 = 0; n0 < N; n0 += IREE_UK_ATTENTION_BLOCK_N) {
+    iree_uk_index_t nb = iree_uk_index_min(IREE_UK_ATTENTION_BLOCK_N, N - n0);
+    for (int i = 0; i < R; ++i) {
+      row_max[i] = IREE_UK_FLOAT_LOWEST;
+      row_sum[i] = 0.f;
+      for (iree_uk_index_t n = 0; n < nb; ++n) acc[i][n] = 0.f;
+    }
+    for (iree_uk_index_t k0 = 0; k0 < K2; k0 += IREE_UK_ATTENTION_BLOCK_K2) {
+      iree_uk_index_t kb =
+          iree_uk_index_min(IREE_UK_ATTENTION_BLOCK_K2, K2 - k0);
+      // s = scale * q . k^T for this block of k rows.
+      for (iree_uk_index_t j = 0; j < kb; ++j) {
+        const char* k_row = (const char*)k + (k0 + j) * k_row_stride;
+        iree_uk_attention_neon_dot_8x1(q_row_ptrs, in_type, k_row, in_type, K1,
+                                       dots);
+        for (int i = 0; i < R; ++i) s[i][j] = params->scale * dots[i];
+      }
+      // Online softmax: rescale what was accumulated against the old max,
+      // then turn the scores into probabilities against the new one.
+      for (int i = 0; i < R; ++i) {
+        float32x4_t max_v = vdupq_n_f32(row_max[i]);
+        iree_uk_index_t j = 0;
+        for (; j + 4 <= kb; j += 4) {
+          max_v = vmaxq_f32(max_v, vld1q_f32(s[i] + j));
+        }
+        float block_max = vmaxvq_f32(max_v);
+        for (; j < kb; ++j) {
+          if (s[i][j] > block_max) block_max = s[i][j];
+        }
+        corrections[i] = iree_uk_exp_f32(row_max[i] - block_max);
+        row_max[i] = block_max;
+        float32x4_t block_max_v = vdupq_n_f32(block_max);
+        float32x4_t sum_v = vdupq_n_f32(0.f);
+        for (j = 0; j + 4 <= kb; j += 4) {
+          float32x4_t p = iree_uk_neon_exp_f32x4(
+              vsubq_f32(vld1q_f32(s[i] + j), block_max_v));
+          sum_v = vaddq_f32(sum_v, p);
+          vst1q_f32(s[i] + j, p);
+        }
+        float sum = vaddvq_f32(sum_v);
+        for (; j < kb; ++j) {
+          s[i][j] = iree_uk_exp_f32(s[i][j] - block_max);
+          sum += s[i][j];
+        }
+        row_sum[i] = row_sum[i] * corrections[i] + sum;
+      }
+      if (transpose_v) {
+        // acc += p . v where v^T is given: dot products of the rows of p with
+        // the rows of v^T, one output column at a time.
+        for (iree_uk_index_t n = 0; n < nb; ++n) {
+          const char* v_row =
+              (const char*)v + (n0 + n) * v_row_stride + k0 * in_elem_size;
+          iree_uk_attention_neon_dot_8x1(s_row_ptrs, IREE_UK_TYPE_FLOAT_32,
+                                         v_row, in_type, kb, dots);
+          for (int i = 0; i < R; ++i) {
+            acc[i][n] = acc[i][n] * corrections[i] + dots[i];
+          }
+        }
+        continue;
+      }
+      // acc += p . v, 4 output columns at a time, with the accumulators for
+      // all R rows held in registers across the block of v rows.
+      iree_uk_index_t n = 0;
+      for (; n + 4 <= nb; n += 4) {
+        float32x4_t acc_v[R];
+        IREE_UK_UNROLL for (int i = 0; i < R; ++i) {
+          acc_v[i] = vmulq_n_f32(vld1q_f32(acc[i] + n), corrections[i]);
+        }
+        const char* v_col = (const char*)v + (n0 + n) * in_elem_size;
+        for (iree_uk_index_t j = 0; j < kb; ++j) {
+          float32x4_t v_j = iree_uk_attention_neon_load_f32x4(
+              v_col + (k0 + j) * v_row_stride, in_type);
+          IREE_UK_UNROLL for (int i = 0; i < R; ++i) {
+            acc_v[i] = vfmaq_n_f32(acc_v[i], v_j, s[i][j]);
+          }
+        }
+        IREE_UK_UNROLL for (int i = 0; i < R; ++i) {
+          vst1q_f32(acc[i] + n, acc_v[i]);
+        }
+      }
+      for (; n < nb; ++n) {
+        for (int i = 0; i < R; ++i) {
+          acc[i][n] *= corrections[i];
+          for (iree_uk_index_t j = 0; j < kb; ++j) {
+            iree_uk_index_t v_index = (k0 + j) * params->v_stride1 + n0 + n;
+            acc[i][n] += s[i][j] * iree_uk_attention_load(v, v_index, in_type);
+          }
+        }
+      }
+    }
+    // out = acc / row_sum. An empty k (K2 == 0) gives zeros, not NaNs.
+    for (iree_uk_index_t i = 0; i < rows; ++i) {
+      float inv_sum = row_sum[i] > 0.f ? 1.f / row_sum[i] : 0.f;
+      char* out_row = (char*)out_rows + i * params->out_stride1 * out_elem_size;
+      iree_uk_index_t n = 0;
+      for (; n + 4 <= nb; n += 4) {
+        iree_uk_attention_neon_store_f32x4(
+            out_row + (n0 + n) * out_elem_size,
+            vmulq_n_f32(vld1q_f32(acc[i] + n), inv_sum), out_type);
+      }
+      for (; n < nb; ++n) {
+        iree_uk_attention_store(out_row, n0 + n, acc[i][n] * inv_sum,
+                                out_type);
+      }
+    }
+  }
+}
+
+void iree_uk_attention_tile_f32f32_arm_64(
+    void* IREE_UK_RESTRICT out_rows, const void* IREE_UK_RESTRICT q_rows,
+    const void* IREE_UK_RESTRICT k, const void* IREE_UK_RESTRICT v,
+    iree_uk_index_t rows, const iree_uk_attention_params_t* params) {
+  iree_uk_attention_tile_arm_64(out_rows, q_rows, k, v, rows, params,
+                                IREE_UK_TYPE_FLOAT_32, IREE_UK_TYPE_FLOAT_32);
+}
+
+void iree_uk_attention_tile_f16f16_arm_64(
+    void* IREE_UK_RESTRICT out_rows, const void* IREE_UK_RESTRICT q_rows,
+    const void* IREE_UK_RESTRICT k, const void* IREE_UK_RESTRICT v,
+    iree_uk_index_t rows, const iree_uk_attention_params_t* params) {
+  iree_uk_attention_tile_arm_64(out_rows, q_rows, k, v, rows, params,
+                                IREE_UK_TYPE_FLOAT_16, IREE_UK_TYPE_FLOAT_16);
+}
+
+void iree_uk_attention_tile_bf16bf16_arm_64(
+    void* IREE_UK_RESTRICT out_rows, const void* IREE_UK_RESTRICT q_rows,
+    const void* IREE_UK_RESTRICT k, const void* IREE_UK_RESTRICT v,
+    iree_uk_index_t rows, const iree_uk_attention_params_t* params) {
+  iree_uk_attention_tile_arm_64(out_rows, q_rows, k, v, rows, params,
+                                IREE_UK_TYPE_BFLOAT_16, IREE_UK_TYPE_BFLOAT_16);
+}
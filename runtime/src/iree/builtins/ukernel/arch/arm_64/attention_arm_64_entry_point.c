@@ -0,0 +1,22 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/arm_64/attention_arm_64_internal.h"
+#include "iree/builtins/ukernel/arch/arm_64/common_arm_64.h"
+
+iree_uk_attention_tile_func_t iree_uk_attention_select_tile_func_arch(
+    const iree_uk_attention_params_t* params) {
+  switch (iree_uk_attention_type(params->flags)) {
+    case iree_uk_attention_type_f32f32:
+      return iree_uk_attention_tile_f32f32_arm_64;
+    case iree_uk_attention_type_f16f16:
+      return iree_uk_attention_tile_f16f16_arm_64;
+    case iree_uk_attention_type_bf16bf16:
+      return iree_uk_attention_tile_bf16bf16_arm_64;
+    default:
+      return 0;
+  }
+}
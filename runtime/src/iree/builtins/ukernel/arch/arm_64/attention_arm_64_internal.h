@@ -0,0 +1,16 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_BUILTINS_UKERNEL_ARCH_ARM_64_ATTENTION_ARM_64_INTERNAL_H_
+#define IREE_BUILTINS_UKERNEL_ARCH_ARM_64_ATTENTION_ARM_64_INTERNAL_H_
+
+#include "iree/builtins/ukernel/attention_internal.h"
+
+IREE_UK_ATTENTION_TILE_FUNC_DECL(iree_uk_attention_tile_f32f32_arm_64)
+IREE_UK_ATTENTION_TILE_FUNC_DECL(iree_uk_attention_tile_f16f16_arm_64)
+IREE_UK_ATTENTION_TILE_FUNC_DECL(iree_uk_attention_tile_bf16bf16_arm_64)
+
+#endif  // IREE_BUILTINS_UKERNEL_ARCH_ARM_64_ATTENTION_ARM_64_INTERNAL_H_
@@ -229,4 +229,27 @@ static inline void iree_uk_neon_copy_8x8xi8_transpose_strided_to_unstrided(
                                                         in_stride);
 }
 
+// Vectorized iree_uk_exp_f32, see common.h.
+static inline float32x4_t iree_uk_neon_exp_f32x4(float32x4_t x) {
+  uint32x4_t underflow = vcltq_f32(x, vdupq_n_f32(IREE_UK_EXP_F32_LO));
+  x = vminq_f32(x, vdupq_n_f32(IREE_UK_EXP_F32_HI));
+  x = vmaxq_f32(x, vdupq_n_f32(IREE_UK_EXP_F32_LO));
+  float32x4_t fn = vrndmq_f32(
+      vfmaq_f32(vdupq_n_f32(0.5f), x, vdupq_n_f32(IREE_UK_EXP_F32_LOG2E)));
+  float32x4_t r = vfmsq_f32(x, fn, vdupq_n_f32(IREE_UK_EXP_F32_LN2_HI));
+  r = vfmsq_f32(r, fn, vdupq_n_f32(IREE_UK_EXP_F32_LN2_LO));
+  float32x4_t p = vdupq_n_f32(IREE_UK_EXP_F32_P0);
+  p = vfmaq_f32(vdupq_n_f32(IREE_UK_EXP_F32_P1), p, r);
+  p = vfmaq_f32(vdupq_n_f32(IREE_UK_EXP_F32_P2), p, r);
+  p = vfmaq_f32(vdupq_n_f32(IREE_UK_EXP_F32_P3), p, r);
+  p = vfmaq_f32(vdupq_n_f32(IREE_UK_EXP_F32_P4), p, r);
+  p = vfmaq_f32(vdupq_n_f32(IREE_UK_EXP_F32_P5), p, r);
+  p = vaddq_f32(vfmaq_f32(r, p, vmulq_f32(r, r)), vdupq_n_f32(1.f));
+  int32x4_t pow2n =
+      vshlq_n_s32(vaddq_s32(vcvtq_s32_f32(fn), vdupq_n_s32(127)), 23);
+  float32x4_t result = vmulq_f32(p, vreinterpretq_f32_s32(pow2n));
+  return vreinterpretq_f32_u32(
+      vbicq_u32(vreinterpretq_u32_f32(result), underflow));
+}
+
 #endif  // IREE_BUILTINS_UKERNEL_ARCH_ARM_64_COMMON_ARM_64_H_
@@ -0,0 +1,74 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/arm_64/common_arm_64.h"
+#include "iree/builtins/ukernel/arch/arm_64/gemv_arm_64_internal.h"
+
+// Accumulates into `acc` the products of LHS element `k` with the k-th row of
+// each RHS panel, each row being two float32x4_t.
+IREE_UK_ATTRIBUTE_ALWAYS_INLINE static inline void
+iree_uk_gemv_f32f32f32_8x1_step_arm_64(float32x4_t (*acc)[2],
+                                       const float* lhs_ptr,
+                                       const float* const* rhs_ptrs,
+                                       iree_uk_index_t k,
+                                       iree_uk_index_t lhs_stride) {
+  float lhs = lhs_ptr[k * lhs_stride];
+  IREE_UK_UNROLL for (int p = 0; p < IREE_UK_GEMV_MAX_PANELS; ++p) {
+    const float* rhs_ptr = rhs_ptrs[p] + k * 8;
+    IREE_UK_PREFETCH_RO((const char*)rhs_ptr + IREE_UK_GEMV_PREFETCH_DISTANCE,
+                        IREE_UK_PREFETCH_LOCALITY_L1);
+    acc[p][0] = vfmaq_n_f32(acc[p][0], vld1q_f32(rhs_ptr), lhs);
+    acc[p][1] = vfmaq_n_f32(acc[p][1], vld1q_f32(rhs_ptr + 4), lhs);
+  }
+}
+
+// Same structure as the x86_64 tile functions: each panel has two sets of
+// accumulators, for even and odd k, to have more independent FMA chains.
+void iree_uk_gemv_tile_f32f32f32_8x1_arm_64(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_vector,
+    const void* IREE_UK_RESTRICT rhs_panels, iree_uk_int32_t panel_count,
+    const iree_uk_gemv_params_t* params) {
+  enum { P = IREE_UK_GEMV_MAX_PANELS };
+  float* IREE_UK_RESTRICT out_ptr = out_tile;
+  const float* IREE_UK_RESTRICT lhs_ptr = lhs_vector;
+  // Missing panels in a partial group alias the last one, so that the loops
+  // below always run over P panels; their results are never stored.
+  const float* rhs_ptrs[P];
+  for (int p = 0; p < P; ++p) {
+    rhs_ptrs[p] = (const float*)rhs_panels +
+                  iree_uk_index_min(p, panel_count - 1) * params->rhs_stride0;
+  }
+  float32x4_t acc[2][P][2];
+  IREE_UK_UNROLL for (int p = 0; p < P; ++p) {
+    IREE_UK_UNROLL for (int i = 0; i < 2; ++i) {
+      acc[0][p][i] = vdupq_n_f32(0.f);
+      acc[1][p][i] = vdupq_n_f32(0.f);
+    }
+  }
+  iree_uk_index_t K = params->K;
+  iree_uk_index_t lhs_stride = params->lhs_stride0;
+  iree_uk_index_t k = 0;
+  for (; k + 2 <= K; k += 2) {
+    iree_uk_gemv_f32f32f32_8x1_step_arm_64(acc[0], lhs_ptr, rhs_ptrs, k,
+                                           lhs_stride);
+    iree_uk_gemv_f32f32f32_8x1_step_arm_64(acc[1], lhs_ptr, rhs_ptrs, k + 1,
+                                           lhs_stride);
+  }
+  if (k < K) {
+    iree_uk_gemv_f32f32f32_8x1_step_arm_64(acc[0], lhs_ptr, rhs_ptrs, k,
+                                           lhs_stride);
+  }
+  for (int p = 0; p < panel_count; ++p) {
+    float* out_p = out_ptr + p * params->out_stride0;
+    IREE_UK_UNROLL for (int i = 0; i < 2; ++i) {
+      float32x4_t sum = vaddq_f32(acc[0][p][i], acc[1][p][i]);
+      if (params->flags & IREE_UK_FLAG_GEMV_ACCUMULATE) {
+        sum = vaddq_f32(sum, vld1q_f32(out_p + 4 * i));
+      }
+      vst1q_f32(out_p + 4 * i, sum);
+    }
+  }
+}
@@ -0,0 +1,19 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/arm_64/common_arm_64.h"
+#include "iree/builtins/ukernel/arch/arm_64/gemv_arm_64_internal.h"
+
+iree_uk_gemv_tile_func_t iree_uk_gemv_select_tile_func_arch(
+    const iree_uk_gemv_params_t* params) {
+  // The 8x1 shape is that of the narrow-M f32 mmt4d tiles. The f16 and bf16
+  // cases use the generic tile function for now.
+  if (iree_uk_gemv_type(params->flags) == iree_uk_gemv_type_f32f32f32 &&
+      params->N0 == 8 && params->K0 == 1) {
+    return iree_uk_gemv_tile_f32f32f32_8x1_arm_64;
+  }
+  return 0;
+}
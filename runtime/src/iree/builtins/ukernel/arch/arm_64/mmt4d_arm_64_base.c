@@ -431,3 +431,62 @@ IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
 IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
     iree_uk_mmt4d_tile_s8s4s32_1x16x2_to_4x16x2_arm_64,
     iree_uk_mmt4d_tile_s8s4s32_4x16x2_arm_64, 4)
+
+// Vecmat kernel. The rhs holds 8 u4 values along K for each column, with the
+// even K positions in the low nibbles and the odd K positions in the high
+// nibbles. Deinterleaving the lhs the same way lets each column accumulate
+// its own dot product in the 4 lanes of one register, without moving rhs data
+// across lanes. The lanes are only reduced once at the end.
+void iree_uk_mmt4d_tile_s16u4s32_1x8x8_arm_64(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const iree_uk_mmt4d_params_t* params) {
+  iree_uk_int32_t* IREE_UK_RESTRICT out_ptr = out_tile;
+  const iree_uk_int16_t* IREE_UK_RESTRICT lhs_ptr = lhs_panel;
+  const iree_uk_uint8_t* IREE_UK_RESTRICT rhs_ptr = rhs_panel;
+  // One accumulator per column, each holding 4 partial sums.
+  int32x4_t acc[8];
+  IREE_UK_UNROLL for (int j = 0; j < 8; ++j) { acc[j] = vdupq_n_s32(0); }
+  const uint8x16_t mask_0f = vdupq_n_u8(0x0f);
+  for (int k = 0; k < params->K; ++k) {
+    // Load 8xs16 LHS data, deinterleaved into the even and odd K positions.
+    int16x4x2_t lhs = vld2_s16(lhs_ptr);
+    lhs_ptr += 8;
+    IREE_UK_UNROLL for (int i = 0; i < 2; ++i) {
+      // Load 8x4xu4 RHS data, for 4 columns, and widen its even and odd K
+      // positions to s16. The u4 values are non-negative so they fit in s16.
+      uint8x16_t rhs = vld1q_u8(rhs_ptr);
+      rhs_ptr += 16;
+      uint8x16_t rhs_even = vandq_u8(rhs, mask_0f);
+      uint8x16_t rhs_odd = vshrq_n_u8(rhs, 4);
+      int16x8_t rhs_even_01 =
+          vreinterpretq_s16_u16(vmovl_u8(vget_low_u8(rhs_even)));
+      int16x8_t rhs_even_23 =
+          vreinterpretq_s16_u16(vmovl_u8(vget_high_u8(rhs_even)));
+      int16x8_t rhs_odd_01 =
+          vreinterpretq_s16_u16(vmovl_u8(vget_low_u8(rhs_odd)));
+      int16x8_t rhs_odd_23 =
+          vreinterpretq_s16_u16(vmovl_u8(vget_high_u8(rhs_odd)));
+      int32x4_t* col_acc = acc + 4 * i;
+      col_acc[0] = vmlal_s16(col_acc[0], vget_low_s16(rhs_even_01), lhs.val[0]);
+      col_acc[1] =
+          vmlal_s16(col_acc[1], vget_high_s16(rhs_even_01), lhs.val[0]);
+      col_acc[2] = vmlal_s16(col_acc[2], vget_low_s16(rhs_even_23), lhs.val[0]);
+      col_acc[3] =
+          vmlal_s16(col_acc[3], vget_high_s16(rhs_even_23), lhs.val[0]);
+      col_acc[0] = vmlal_s16(col_acc[0], vget_low_s16(rhs_odd_01), lhs.val[1]);
+      col_acc[1] = vmlal_s16(col_acc[1], vget_high_s16(rhs_odd_01), lhs.val[1]);
+      col_acc[2] = vmlal_s16(col_acc[2], vget_low_s16(rhs_odd_23), lhs.val[1]);
+      col_acc[3] = vmlal_s16(col_acc[3], vget_high_s16(rhs_odd_23), lhs.val[1]);
+    }
+  }
+  // Reduce the 4 partial sums of each column.
+  IREE_UK_UNROLL for (int i = 0; i < 2; ++i) {
+    int32x4_t out = vpaddq_s32(vpaddq_s32(acc[4 * i + 0], acc[4 * i + 1]),
+                               vpaddq_s32(acc[4 * i + 2], acc[4 * i + 3]));
+    if (params->flags & IREE_UK_FLAG_MMT4D_ACCUMULATE) {
+      out = vaddq_s32(out, vld1q_s32(out_ptr + 4 * i));
+    }
+    vst1q_s32(out_ptr + 4 * i, out);
+  }
+}
@@ -220,3 +220,61 @@ IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
 IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
     iree_uk_mmt4d_tile_s8s4s32_1x8x8_to_8x8x8_arm_64_dotprod,
     iree_uk_mmt4d_tile_s8s4s32_8x8x8_arm_64_dotprod, 8)
+
+// Vecmat kernel. SDOT and UDOT only multiply 8-bit values, so each s16 lhs
+// value is split into its signed high byte and its unsigned low byte, and
+// each is multiplied against the u4 rhs values, which fit in both s8 and u8.
+// The two products are recombined as (high << 8) + low when storing. The rhs
+// holds 8 u4 values along K for each column, with the even K positions in the
+// low nibbles and the odd K positions in the high nibbles, so the lhs bytes
+// are deinterleaved the same way.
+void iree_uk_mmt4d_tile_s16u4s32_1x8x8_arm_64_dotprod(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const iree_uk_mmt4d_params_t* params) {
+  iree_uk_int32_t* IREE_UK_RESTRICT out_ptr = out_tile;
+  const iree_uk_uint8_t* IREE_UK_RESTRICT lhs_ptr = lhs_panel;
+  const iree_uk_uint8_t* IREE_UK_RESTRICT rhs_ptr = rhs_panel;
+  // Accumulator shape: 1x8xs32, in 2 registers, each 1x4xs32, separately for
+  // the high and low bytes of the lhs.
+  int32x4_t acc_high[2];
+  uint32x4_t acc_low[2];
+  IREE_UK_UNROLL for (int i = 0; i < 2; ++i) {
+    acc_high[i] = vdupq_n_s32(0);
+    acc_low[i] = vdupq_n_u32(0);
+  }
+  const uint8x16_t mask_0f = vdupq_n_u8(0x0f);
+  for (int k = 0; k < params->K; ++k) {
+    // Load 8xs16 LHS data and deinterleave its bytes twice so that lane 0 of
+    // each 32-bit pair holds the low bytes and lane 1 the high bytes of the
+    // even K positions (lhs_even) and of the odd K positions (lhs_odd).
+    uint8x16_t lhs = vld1q_u8(lhs_ptr);
+    lhs_ptr += 16;
+    uint8x8x2_t lhs_bytes = vuzp_u8(vget_low_u8(lhs), vget_high_u8(lhs));
+    uint8x8x2_t lhs_k = vuzp_u8(lhs_bytes.val[0], lhs_bytes.val[1]);
+    uint8x8_t lhs_even = lhs_k.val[0];
+    uint8x8_t lhs_odd = lhs_k.val[1];
+    IREE_UK_UNROLL for (int i = 0; i < 2; ++i) {
+      // Load 8x4xu4 RHS data, for 4 columns, and split its even and odd K
+      // positions into separate bytes.
+      uint8x16_t rhs = vld1q_u8(rhs_ptr);
+      rhs_ptr += 16;
+      uint8x16_t rhs_even = vandq_u8(rhs, mask_0f);
+      uint8x16_t rhs_odd = vshrq_n_u8(rhs, 4);
+      acc_low[i] = vdotq_lane_u32(acc_low[i], rhs_even, lhs_even, 0);
+      acc_low[i] = vdotq_lane_u32(acc_low[i], rhs_odd, lhs_odd, 0);
+      acc_high[i] = vdotq_lane_s32(acc_high[i], vreinterpretq_s8_u8(rhs_even),
+                                   vreinterpret_s8_u8(lhs_even), 1);
+      acc_high[i] = vdotq_lane_s32(acc_high[i], vreinterpretq_s8_u8(rhs_odd),
+                                   vreinterpret_s8_u8(lhs_odd), 1);
+    }
+  }
+  IREE_UK_UNROLL for (int i = 0; i < 2; ++i) {
+    int32x4_t out = vaddq_s32(vshlq_n_s32(acc_high[i], 8),
+                              vreinterpretq_s32_u32(acc_low[i]));
+    if (params->flags & IREE_UK_FLAG_MMT4D_ACCUMULATE) {
+      out = vaddq_s32(out, vld1q_s32(out_ptr + 4 * i));
+    }
+    vst1q_s32(out_ptr + 4 * i, out);
+  }
+}
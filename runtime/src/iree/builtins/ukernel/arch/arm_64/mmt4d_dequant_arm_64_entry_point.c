@@ -0,0 +1,14 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/arm_64/common_arm_64.h"
+#include "iree/builtins/ukernel/mmt4d_dequant_internal.h"
+
+// No arm_64 specific tile functions yet: use the generic fallback.
+iree_uk_mmt4d_dequant_tile_func_t iree_uk_mmt4d_dequant_select_tile_func_arch(
+    const iree_uk_mmt4d_dequant_params_t* params) {
+  return 0;
+}
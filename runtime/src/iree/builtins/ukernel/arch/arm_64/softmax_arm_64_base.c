@@ -0,0 +1,63 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/arm_64/common_arm_64.h"
+#include "iree/builtins/ukernel/arch/arm_64/softmax_arm_64_internal.h"
+
+void iree_uk_softmax_tile_f32f32_arm_64(
+    void* IREE_UK_RESTRICT out_row_untyped,
+    const void* IREE_UK_RESTRICT in_row_untyped,
+    const iree_uk_softmax_params_t* params) {
+  float* IREE_UK_RESTRICT out_row = out_row_untyped;
+  const float* IREE_UK_RESTRICT in_row = in_row_untyped;
+  iree_uk_index_t size = params->size1;
+  // First pass: per-lane running max and sum of exponentials relative to it.
+  // Blocks of 4 vectors share a single rescaling of the partial sums.
+  float32x4_t max = vdupq_n_f32(IREE_UK_FLOAT_LOWEST);
+  float32x4_t sum = vdupq_n_f32(0.f);
+  iree_uk_index_t j = 0;
+  for (; j + 16 <= size; j += 16) {
+    float32x4_t x0 = vld1q_f32(in_row + j + 0);
+    float32x4_t x1 = vld1q_f32(in_row + j + 4);
+    float32x4_t x2 = vld1q_f32(in_row + j + 8);
+    float32x4_t x3 = vld1q_f32(in_row + j + 12);
+    float32x4_t new_max = vmaxq_f32(vmaxq_f32(x0, x1), vmaxq_f32(x2, x3));
+    new_max = vmaxq_f32(max, new_max);
+    sum = vmulq_f32(sum, iree_uk_neon_exp_f32x4(vsubq_f32(max, new_max)));
+    float32x4_t e01 = vaddq_f32(iree_uk_neon_exp_f32x4(vsubq_f32(x0, new_max)),
+                                iree_uk_neon_exp_f32x4(vsubq_f32(x1, new_max)));
+    float32x4_t e23 = vaddq_f32(iree_uk_neon_exp_f32x4(vsubq_f32(x2, new_max)),
+                                iree_uk_neon_exp_f32x4(vsubq_f32(x3, new_max)));
+    sum = vaddq_f32(sum, vaddq_f32(e01, e23));
+    max = new_max;
+  }
+  for (; j + 4 <= size; j += 4) {
+    float32x4_t x = vld1q_f32(in_row + j);
+    float32x4_t new_max = vmaxq_f32(max, x);
+    sum = vmulq_f32(sum, iree_uk_neon_exp_f32x4(vsubq_f32(max, new_max)));
+    sum = vaddq_f32(sum, iree_uk_neon_exp_f32x4(vsubq_f32(x, new_max)));
+    max = new_max;
+  }
+  // Combine the lanes, then fold in the remaining elements.
+  float row_max = vmaxvq_f32(max);
+  float row_sum = vaddvq_f32(vmulq_f32(
+      sum, iree_uk_neon_exp_f32x4(vsubq_f32(max, vdupq_n_f32(row_max)))));
+  for (; j < size; ++j) {
+    iree_uk_softmax_accumulate_f32(in_row[j], &row_max, &row_sum);
+  }
+  // Second pass: write the normalized exponentials.
+  float inv_sum = 1.f / row_sum;
+  float32x4_t row_max_v = vdupq_n_f32(row_max);
+  j = 0;
+  for (; j + 4 <= size; j += 4) {
+    float32x4_t x = vld1q_f32(in_row + j);
+    float32x4_t e = iree_uk_neon_exp_f32x4(vsubq_f32(x, row_max_v));
+    vst1q_f32(out_row + j, vmulq_n_f32(e, inv_sum));
+  }
+  for (; j < size; ++j) {
+    out_row[j] = iree_uk_exp_f32(in_row[j] - row_max) * inv_sum;
+  }
+}
@@ -0,0 +1,16 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/arm_64/common_arm_64.h"
+#include "iree/builtins/ukernel/arch/arm_64/softmax_arm_64_internal.h"
+
+iree_uk_softmax_tile_func_t iree_uk_softmax_select_tile_func_arch(
+    const iree_uk_softmax_params_t* params) {
+  if (iree_uk_softmax_type(params->flags) == iree_uk_softmax_type_f32f32) {
+    return iree_uk_softmax_tile_f32f32_arm_64;
+  }
+  return 0;
+}
@@ -0,0 +1,261 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/x86_64/attention_x86_64_internal.h"
+#include "iree/builtins/ukernel/arch/x86_64/common_x86_64.h"
+
+// Loads 8 consecutive elements of the given type as f32.
+IREE_UK_ATTRIBUTE_ALWAYS_INLINE static inline __m256
+iree_uk_attention_avx2_load_ps(const void* ptr, iree_uk_type_t type) {
+  switch (type) {
+    case IREE_UK_TYPE_FLOAT_16:
+      return _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)ptr));
+    case IREE_UK_TYPE_BFLOAT_16:
+      return _mm256_castsi256_ps(_mm256_slli_epi32(
+          _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)ptr)), 16));
+    default:
+      return _mm256_loadu_ps(ptr);
+  }
+}
+
+// Stores 8 f32 values as consecutive elements of the given type.
+IREE_UK_ATTRIBUTE_ALWAYS_INLINE static inline void
+iree_uk_attention_avx2_store_ps(void* ptr, __m256 value, iree_uk_type_t type) {
+  switch (type) {
+    case IREE_UK_TYPE_FLOAT_16:
+      _mm_storeu_si128((__m128i*)ptr,
+                       _mm256_cvtps_ph(value, _MM_FROUND_TO_NEAREST_INT));
+      break;
+    case IREE_UK_TYPE_BFLOAT_16: {
+      float values[8];
+      _mm256_storeu_ps(values, value);
+      for (int i = 0; i < 8; ++i) {
+        ((iree_uk_uint16_t*)ptr)[i] = iree_uk_f32_to_bf16(values[i]);
+      }
+      break;
+    }
+    default:
+      _mm256_storeu_ps(ptr, value);
+      break;
+  }
+}
+
+// Returns the vector whose lane i is the dot product of a_rows[i] with b, all
+// of them `size` elements long.
+IREE_UK_ATTRIBUTE_ALWAYS_INLINE static inline __m256
+iree_uk_attention_avx2_dot_8x1(const void* const* a_rows,
+                               iree_uk_type_t a_type, const void* b,
+                               iree_uk_type_t b_type, iree_uk_index_t size) {
+  iree_uk_index_t a_elem_size = iree_uk_type_size(a_type);
+  iree_uk_index_t b_elem_size = iree_uk_type_size(b_type);
+  __m256 dot[IREE_UK_ATTENTION_BLOCK_M];
+  IREE_UK_UNROLL for (int i = 0; i < IREE_UK_ATTENTION_BLOCK_M; ++i) {
+    dot[i] = _mm256_setzero_ps();
+  }
+  iree_uk_index_t c = 0;
+  for (; c + 8 <= size; c += 8) {
+    __m256 b_v = iree_uk_attention_avx2_load_ps(
+        (const char*)b + c * b_elem_size, b_type);
+    IREE_UK_UNROLL for (int i = 0; i < IREE_UK_ATTENTION_BLOCK_M; ++i) {
+      __m256 a_v = iree_uk_attention_avx2_load_ps(
+          (const char*)a_rows[i] + c * a_elem_size, a_type);
+      dot[i] = _mm256_fmadd_ps(a_v, b_v, dot[i]);
+    }
+  }
+  __m256 result = iree_uk_avx2_reduce_add_8x8_ps(dot);
+  if (c < size) {
+    float tail[IREE_UK_ATTENTION_BLOCK_M];
+    for (int i = 0; i < IREE_UK_ATTENTION_BLOCK_M; ++i) {
+      tail[i] = 0.f;
+      for (iree_uk_index_t t = c; t < size; ++t) {
+        tail[i] += iree_uk_attention_load(a_rows[i], t, a_type) *
+                   iree_uk_attention_load(b, t, b_type);
+      }
+    }
+    result = _mm256_add_ps(result, _mm256_loadu_ps(tail));
+  }
+  return result;
+}
+
+IREE_UK_ATTRIBUTE_ALWAYS_INLINE static inline void
+iree_uk_attention_tile_x86_64_avx2_fma(
+    void* IREE_UK_RESTRICT out_rows, const void* IREE_UK_RESTRICT q_rows,
+    const void* IREE_UK_RESTRICT k, const void* IREE_UK_RESTRICT v,
+    iree_uk_index_t rows, const iree_uk_attention_params_t* params,
+    iree_uk_type_t in_type, iree_uk_type_t out_type) {
+  // The IREE_UK_ATTENTION_BLOCK_M == 8 q rows of the tile are the 8 lanes of
+  // the score vectors.
+  enum { R = IREE_UK_ATTENTION_BLOCK_M };
+  iree_uk_index_t K1 = params->K1;
+  iree_uk_index_t K2 = params->K2;
+  iree_uk_index_t N = params->N;
+  iree_uk_index_t in_elem_size = iree_uk_type_size(in_type);
+  iree_uk_index_t out_elem_size = iree_uk_type_size(out_type);
+  iree_uk_index_t k_row_stride = params->k_stride1 * in_elem_size;
+  iree_uk_index_t v_row_stride = params->v_stride1 * in_elem_size;
+  bool transpose_v = params->flags & IREE_UK_FLAG_ATTENTION_TRANSPOSE_V;
+  // Missing q rows in a partial tile alias the last one, so that the loops
+  // below always run over R rows; their results are never stored.
+  const void* q_row_ptrs[R];
+  for (int i = 0; i < R; ++i) {
+    q_row_ptrs[i] = (const char*)q_rows + iree_uk_index_min(i, rows - 1) *
+                                              params->q_stride1 * in_elem_size;
+  }
+  // Scores, then probabilities, one vector per k row.
+  float s[IREE_UK_ATTENTION_BLOCK_K2][R];
+  // The same probabilities with the k rows contiguous, to take dot products
+  // with the rows of a transposed v.
+  float p[R][IREE_UK_ATTENTION_BLOCK_K2];
+  const void* p_row_ptrs[R];
+  for (int i = 0; i < R; ++i) p_row_ptrs[i] = p[i];
+  // Accumulators, [R][BLOCK_N] row-major, or [BLOCK_N][R] with a transposed
+  // v so that each output column is one vector.
+  float acc[R * IREE_UK_ATTENTION_BLOCK_N];
+  __m256 scale = _mm256_set1_ps(params->scale);
+  for (iree_uk_index_t n0 = 0; n0 < N; n0 += IREE_UK_ATTENTION_BLOCK_N) {
+    iree_uk_index_t nb = iree_uk_index_min(IREE_UK_ATTENTION_BLOCK_N, N - n0);
+    for (int x = 0; x < R * IREE_UK_ATTENTION_BLOCK_N; x += 8) {
+      _mm256_storeu_ps(acc + x, _mm256_setzero_ps());
+    }
+    __m256 row_max = _mm256_set1_ps(IREE_UK_FLOAT_LOWEST);
+    __m256 row_sum = _mm256_setzero_ps();
+    for (iree_uk_index_t k0 = 0; k0 < K2; k0 += IREE_UK_ATTENTION_BLOCK_K2) {
+      iree_uk_index_t kb =
+          iree_uk_index_min(IREE_UK_ATTENTION_BLOCK_K2, K2 - k0);
+      // s = scale * q . k^T for this block of k rows.
+      __m256 block_max = row_max;
+      for (iree_uk_index_t j = 0; j < kb; ++j) {
+        const char* k_row = (const char*)k + (k0 + j) * k_row_stride;
+        __m256 s_j = _mm256_mul_ps(
+            scale, iree_uk_attention_avx2_dot_8x1(q_row_ptrs, in_type, k_row,
+                                                  in_type, K1));
+        _mm256_storeu_ps(s[j], s_j);
+        block_max = _mm256_max_ps(block_max, s_j);
+      }
+      // Online softmax: rescale what was accumulated against the old max,
+      // then turn the scores into probabilities against the new one.
+      __m256 correction =
+          iree_uk_avx2_exp_ps(_mm256_sub_ps(row_max, block_max));
+      row_max = block_max;
+      row_sum = _mm256_mul_ps(row_sum, correction);
+      for (iree_uk_index_t j = 0; j < kb; ++j) {
+        __m256 p_j =
+            iree_uk_avx2_exp_ps(_mm256_sub_ps(_mm256_loadu_ps(s[j]), row_max));
+        row_sum = _mm256_add_ps(row_sum, p_j);
+        _mm256_storeu_ps(s[j], p_j);
+      }
+      if (transpose_v) {
+        // acc^T += v^T . p^T, one output column at a time.
+        for (iree_uk_index_t j = 0; j < kb; ++j) {
+          for (int i = 0; i < R; ++i) p[i][j] = s[j][i];
+        }
+        for (iree_uk_index_t n = 0; n < nb; ++n) {
+          const char* v_row =
+              (const char*)v + (n0 + n) * v_row_stride + k0 * in_elem_size;
+          __m256 acc_n = _mm256_mul_ps(_mm256_loadu_ps(acc + n * R),
+                                       correction);
+          acc_n = _mm256_add_ps(
+              acc_n, iree_uk_attention_avx2_dot_8x1(
+                         p_row_ptrs, IREE_UK_TYPE_FLOAT_32, v_row, in_type,
+                         kb));
+          _mm256_storeu_ps(acc + n * R, acc_n);
+        }
+        continue;
+      }
+      // acc += p . v, 8 output columns at a time, with the accumulators for
+      // all R rows held in registers across the block of v rows.
+      float corrections[R];
+      _mm256_storeu_ps(corrections, correction);
+      iree_uk_index_t n = 0;
+      for (; n + 8 <= nb; n += 8) {
+        __m256 acc_v[R];
+        IREE_UK_UNROLL for (int i = 0; i < R; ++i) {
+          float* acc_row = acc + i * IREE_UK_ATTENTION_BLOCK_N;
+          acc_v[i] = _mm256_mul_ps(_mm256_loadu_ps(acc_row + n),
+                                   _mm256_set1_ps(corrections[i]));
+        }
+        const char* v_col = (const char*)v + (n0 + n) * in_elem_size;
+        for (iree_uk_index_t j = 0; j < kb; ++j) {
+          __m256 v_j = iree_uk_attention_avx2_load_ps(
+              v_col + (k0 + j) * v_row_stride, in_type);
+          IREE_UK_UNROLL for (int i = 0; i < R; ++i) {
+            acc_v[i] = _mm256_fmadd_ps(_mm256_broadcast_ss(&s[j][i]), v_j,
+                                       acc_v[i]);
+          }
+        }
+        IREE_UK_UNROLL for (int i = 0; i < R; ++i) {
+          float* acc_row = acc + i * IREE_UK_ATTENTION_BLOCK_N;
+          _mm256_storeu_ps(acc_row + n, acc_v[i]);
+        }
+      }
+      for (; n < nb; ++n) {
+        for (int i = 0; i < R; ++i) {
+          float* acc_row = acc + i * IREE_UK_ATTENTION_BLOCK_N;
+          acc_row[n] *= corrections[i];
+          for (iree_uk_index_t j = 0; j < kb; ++j) {
+            iree_uk_index_t v_index = (k0 + j) * params->v_stride1 + n0 + n;
+            acc_row[n] += s[j][i] * iree_uk_attention_load(v, v_index, in_type);
+          }
+        }
+      }
+    }
+    // out = acc / row_sum. An empty k (K2 == 0) gives zeros, not NaNs.
+    __m256 inv_sum_v = _mm256_and_ps(
+        _mm256_div_ps(_mm256_set1_ps(1.f), row_sum),
+        _mm256_cmp_ps(row_sum, _mm256_setzero_ps(), _CMP_GT_OQ));
+    float inv_sum[R];
+    _mm256_storeu_ps(inv_sum, inv_sum_v);
+    for (iree_uk_index_t i = 0; i < rows; ++i) {
+      char* out_row = (char*)out_rows + i * params->out_stride1 * out_elem_size;
+      if (transpose_v) {
+        for (iree_uk_index_t n = 0; n < nb; ++n) {
+          iree_uk_attention_store(out_row, n0 + n, acc[n * R + i] * inv_sum[i],
+                                  out_type);
+        }
+        continue;
+      }
+      const float* acc_row = acc + i * IREE_UK_ATTENTION_BLOCK_N;
+      __m256 inv_sum_i = _mm256_set1_ps(inv_sum[i]);
+      iree_uk_index_t n = 0;
+      for (; n + 8 <= nb; n += 8) {
+        iree_uk_attention_avx2_store_ps(
+            out_row + (n0 + n) * out_elem_size,
+            _mm256_mul_ps(_mm256_loadu_ps(acc_row + n), inv_sum_i), out_type);
+      }
+      for (; n < nb; ++n) {
+        iree_uk_attention_store(out_row, n0 + n, acc_row[n] * inv_sum[i],
+                                out_type);
+      }
+    }
+  }
+}
+
+void iree_uk_attention_tile_f32f32_x86_64_avx2_fma(
+    void* IREE_UK_RESTRICT out_rows, const void* IREE_UK_RESTRICT q_rows,
+    const void* IREE_UK_RESTRICT k, const void* IREE_UK_RESTRICT v,
+    iree_uk_index_t rows, const iree_uk_attention_params_t* params) {
+  iree_uk_attention_tile_x86_64_avx2_fma(out_rows, q_rows, k, v, rows, params,
+                                         IREE_UK_TYPE_FLOAT_32,
+                                         IREE_UK_TYPE_FLOAT_32);
+}
+
+void iree_uk_attention_tile_f16f16_x86_64_avx2_fma(
+    void* IREE_UK_RESTRICT out_rows, const void* IREE_UK_RESTRICT q_rows,
+    const void* IREE_UK_RESTRICT k, const void* IREE_UK_RESTRICT v,
+    iree_uk_index_t rows, const iree_uk_attention_params_t* params) {
+  iree_uk_attention_tile_x86_64_avx2_fma(out_rows, q_rows, k, v, rows, params,
+                                         IREE_UK_TYPE_FLOAT_16,
+                                         IREE_UK_TYPE_FLOAT_16);
+}
+
+void iree_uk_attention_tile_bf16bf16_x86_64_avx2_fma(
+    void* IREE_UK_RESTRICT out_rows, const void* IREE_UK_RESTRICT q_rows,
+    const void* IREE_UK_RESTRICT k, const void* IREE_UK_RESTRICT v,
+    iree_uk_index_t rows, const iree_uk_attention_params_t* params) {
+  iree_uk_attention_tile_x86_64_avx2_fma(out_rows, q_rows, k, v, rows, params,
+                                         IREE_UK_TYPE_BFLOAT_16,
+                                         IREE_UK_TYPE_BFLOAT_16);
+}
@@ -0,0 +1,56 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/x86_64/attention_x86_64_internal.h"
+#include "iree/builtins/ukernel/arch/x86_64/common_x86_64.h"
+
+static iree_uk_attention_tile_func_t
+iree_uk_attention_select_tile_func_x86_64_avx512_base(
+    const iree_uk_attention_params_t* params) {
+#if defined(IREE_UK_BUILD_X86_64_AVX512_BASE)
+  if (!iree_uk_cpu_x86_64_avx512_base(params->cpu_data)) return 0;
+  switch (iree_uk_attention_type(params->flags)) {
+    case iree_uk_attention_type_f32f32:
+      return iree_uk_attention_tile_f32f32_x86_64_avx512_base;
+    case iree_uk_attention_type_f16f16:
+      return iree_uk_attention_tile_f16f16_x86_64_avx512_base;
+    case iree_uk_attention_type_bf16bf16:
+      return iree_uk_attention_tile_bf16bf16_x86_64_avx512_base;
+    default:
+      return 0;
+  }
+#else
+  return 0;
+#endif
+}
+
+static iree_uk_attention_tile_func_t
+iree_uk_attention_select_tile_func_x86_64_avx2_fma(
+    const iree_uk_attention_params_t* params) {
+#if defined(IREE_UK_BUILD_X86_64_AVX2_FMA)
+  if (!iree_uk_cpu_x86_64_avx2_fma(params->cpu_data)) return 0;
+  switch (iree_uk_attention_type(params->flags)) {
+    case iree_uk_attention_type_f32f32:
+      return iree_uk_attention_tile_f32f32_x86_64_avx2_fma;
+    case iree_uk_attention_type_f16f16:
+      return iree_uk_attention_tile_f16f16_x86_64_avx2_fma;
+    case iree_uk_attention_type_bf16bf16:
+      return iree_uk_attention_tile_bf16bf16_x86_64_avx2_fma;
+    default:
+      return 0;
+  }
+#else
+  return 0;
+#endif
+}
+
+iree_uk_attention_tile_func_t iree_uk_attention_select_tile_func_arch(
+    const iree_uk_attention_params_t* params) {
+  iree_uk_attention_tile_func_t tile_func =
+      iree_uk_attention_select_tile_func_x86_64_avx512_base(params);
+  if (tile_func) return tile_func;
+  return iree_uk_attention_select_tile_func_x86_64_avx2_fma(params);
+}
@@ -265,6 +265,58 @@ iree_uk_avx2_copy_8x16xi8_tiled_1x2_transpose_strided_to_strided(
                            r0123456701234567_3);
 }
 
+// Vectorized iree_uk_exp_f32, see common.h.
+static inline __m256 iree_uk_avx2_exp_ps(__m256 x) {
+  __m256 underflow =
+      _mm256_cmp_ps(x, _mm256_set1_ps(IREE_UK_EXP_F32_LO), _CMP_LT_OQ);
+  x = _mm256_min_ps(x, _mm256_set1_ps(IREE_UK_EXP_F32_HI));
+  x = _mm256_max_ps(x, _mm256_set1_ps(IREE_UK_EXP_F32_LO));
+  __m256 fn = _mm256_floor_ps(_mm256_fmadd_ps(
+      x, _mm256_set1_ps(IREE_UK_EXP_F32_LOG2E), _mm256_set1_ps(0.5f)));
+  __m256 r = _mm256_fnmadd_ps(fn, _mm256_set1_ps(IREE_UK_EXP_F32_LN2_HI), x);
+  r = _mm256_fnmadd_ps(fn, _mm256_set1_ps(IREE_UK_EXP_F32_LN2_LO), r);
+  __m256 p = _mm256_set1_ps(IREE_UK_EXP_F32_P0);
+  p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(IREE_UK_EXP_F32_P1));
+  p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(IREE_UK_EXP_F32_P2));
+  p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(IREE_UK_EXP_F32_P3));
+  p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(IREE_UK_EXP_F32_P4));
+  p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(IREE_UK_EXP_F32_P5));
+  p = _mm256_add_ps(_mm256_fmadd_ps(p, _mm256_mul_ps(r, r), r),
+                    _mm256_set1_ps(1.f));
+  __m256i pow2n = _mm256_slli_epi32(
+      _mm256_add_epi32(_mm256_cvtps_epi32(fn), _mm256_set1_epi32(127)), 23);
+  __m256 result = _mm256_mul_ps(p, _mm256_castsi256_ps(pow2n));
+  return _mm256_andnot_ps(underflow, result);
+}
+
+static inline float iree_uk_avx2_reduce_max_ps(__m256 v) {
+  __m128 v4 =
+      _mm_max_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+  __m128 v2 = _mm_max_ps(v4, _mm_movehl_ps(v4, v4));
+  __m128 v1 = _mm_max_ss(v2, _mm_movehdup_ps(v2));
+  return _mm_cvtss_f32(v1);
+}
+
+static inline float iree_uk_avx2_reduce_add_ps(__m256 v) {
+  __m128 v4 =
+      _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+  __m128 v2 = _mm_add_ps(v4, _mm_movehl_ps(v4, v4));
+  __m128 v1 = _mm_add_ss(v2, _mm_movehdup_ps(v2));
+  return _mm_cvtss_f32(v1);
+}
+
+// Returns the vector whose lane i is the sum of the lanes of v[i], i < 8.
+static inline __m256 iree_uk_avx2_reduce_add_8x8_ps(const __m256* v) {
+  __m256 t0 = _mm256_hadd_ps(v[0], v[1]);
+  __m256 t1 = _mm256_hadd_ps(v[2], v[3]);
+  __m256 t2 = _mm256_hadd_ps(v[4], v[5]);
+  __m256 t3 = _mm256_hadd_ps(v[6], v[7]);
+  __m256 u0 = _mm256_hadd_ps(t0, t1);
+  __m256 u1 = _mm256_hadd_ps(t2, t3);
+  return _mm256_add_ps(_mm256_permute2f128_ps(u0, u1, 0x20),
+                       _mm256_permute2f128_ps(u0, u1, 0x31));
+}
+
 #if defined(__AVX512F__)
 
 static inline __m512i iree_uk_avx512_loadu_4x128(const void* src0,
@@ -446,6 +498,31 @@ iree_uk_avx512_copy_16x16xi8_tiled_1x2_transpose_strided_to_strided(
       r0123456701234567_3);
 }
 
+// Vectorized iree_uk_exp_f32, see common.h.
+static inline __m512 iree_uk_avx512_exp_ps(__m512 x) {
+  __mmask16 underflow =
+      _mm512_cmp_ps_mask(x, _mm512_set1_ps(IREE_UK_EXP_F32_LO), _CMP_LT_OQ);
+  x = _mm512_min_ps(x, _mm512_set1_ps(IREE_UK_EXP_F32_HI));
+  x = _mm512_max_ps(x, _mm512_set1_ps(IREE_UK_EXP_F32_LO));
+  __m512 fn = _mm512_roundscale_ps(
+      _mm512_fmadd_ps(x, _mm512_set1_ps(IREE_UK_EXP_F32_LOG2E),
+                      _mm512_set1_ps(0.5f)),
+      _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC);
+  __m512 r = _mm512_fnmadd_ps(fn, _mm512_set1_ps(IREE_UK_EXP_F32_LN2_HI), x);
+  r = _mm512_fnmadd_ps(fn, _mm512_set1_ps(IREE_UK_EXP_F32_LN2_LO), r);
+  __m512 p = _mm512_set1_ps(IREE_UK_EXP_F32_P0);
+  p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(IREE_UK_EXP_F32_P1));
+  p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(IREE_UK_EXP_F32_P2));
+  p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(IREE_UK_EXP_F32_P3));
+  p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(IREE_UK_EXP_F32_P4));
+  p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(IREE_UK_EXP_F32_P5));
+  p = _mm512_add_ps(_mm512_fmadd_ps(p, _mm512_mul_ps(r, r), r),
+                    _mm512_set1_ps(1.f));
+  __m512i pow2n = _mm512_slli_epi32(
+      _mm512_add_epi32(_mm512_cvtps_epi32(fn), _mm512_set1_epi32(127)), 23);
+  return _mm512_maskz_mul_ps(~underflow, p, _mm512_castsi512_ps(pow2n));
+}
+
 #endif  // defined (__AVX512F__)
 
 #endif  // defined(__AVX2__)
@@ -0,0 +1,94 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/x86_64/common_x86_64.h"
+#include "iree/builtins/ukernel/arch/x86_64/gemv_x86_64_internal.h"
+
+// Accumulates into `acc` the products of LHS element `k` with the k-th row of
+// each RHS panel.
+IREE_UK_ATTRIBUTE_ALWAYS_INLINE static inline void
+iree_uk_gemv_fXXfXXf32_16x1_step_x86_64_avx512_base(
+    __m512* acc, const char* lhs_ptr, const char* const* rhs_ptrs,
+    iree_uk_index_t k, iree_uk_index_t lhs_stride, bool is_f16) {
+  __m512 lhs;
+  if (is_f16) {
+    lhs = _mm512_cvtph_ps(_mm256_set1_epi16(
+        *(const iree_uk_int16_t*)(lhs_ptr + k * lhs_stride)));
+  } else {
+    lhs = _mm512_set1_ps(*(const float*)(lhs_ptr + k * lhs_stride));
+  }
+  IREE_UK_UNROLL for (int p = 0; p < IREE_UK_GEMV_MAX_PANELS; ++p) {
+    const char* rhs_ptr = rhs_ptrs[p] + k * (is_f16 ? 32 : 64);
+    IREE_UK_PREFETCH_RO(rhs_ptr + IREE_UK_GEMV_PREFETCH_DISTANCE,
+                        IREE_UK_PREFETCH_LOCALITY_L1);
+    __m512 rhs =
+        is_f16 ? _mm512_cvtph_ps(_mm256_loadu_si256((const __m256i*)rhs_ptr))
+               : _mm512_loadu_ps((const float*)rhs_ptr);
+    acc[p] = _mm512_fmadd_ps(lhs, rhs, acc[p]);
+  }
+}
+
+// Same as the AVX2 variant, with N0 = 16.
+IREE_UK_ATTRIBUTE_ALWAYS_INLINE static inline void
+iree_uk_gemv_tile_fXXfXXf32_16x1_x86_64_avx512_base(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_vector,
+    const void* IREE_UK_RESTRICT rhs_panels, iree_uk_int32_t panel_count,
+    const iree_uk_gemv_params_t* params, bool is_f16) {
+  enum { P = IREE_UK_GEMV_MAX_PANELS };
+  float* IREE_UK_RESTRICT out_ptr = out_tile;
+  const char* lhs_ptr = lhs_vector;
+  const int elem_size = is_f16 ? 2 : 4;
+  iree_uk_index_t lhs_stride = params->lhs_stride0 * elem_size;
+  // Missing panels in a partial group alias the last one, so that the loops
+  // below always run over P panels; their results are never stored.
+  const char* rhs_ptrs[P];
+  for (int p = 0; p < P; ++p) {
+    rhs_ptrs[p] = (const char*)rhs_panels +
+                  iree_uk_index_min(p, panel_count - 1) * params->rhs_stride0 *
+                      elem_size;
+  }
+  __m512 acc[2][P];
+  IREE_UK_UNROLL for (int p = 0; p < P; ++p) {
+    acc[0][p] = _mm512_setzero_ps();
+    acc[1][p] = _mm512_setzero_ps();
+  }
+  iree_uk_index_t K = params->K;
+  iree_uk_index_t k = 0;
+  for (; k + 2 <= K; k += 2) {
+    iree_uk_gemv_fXXfXXf32_16x1_step_x86_64_avx512_base(
+        acc[0], lhs_ptr, rhs_ptrs, k, lhs_stride, is_f16);
+    iree_uk_gemv_fXXfXXf32_16x1_step_x86_64_avx512_base(
+        acc[1], lhs_ptr, rhs_ptrs, k + 1, lhs_stride, is_f16);
+  }
+  if (k < K) {
+    iree_uk_gemv_fXXfXXf32_16x1_step_x86_64_avx512_base(
+        acc[0], lhs_ptr, rhs_ptrs, k, lhs_stride, is_f16);
+  }
+  for (int p = 0; p < panel_count; ++p) {
+    float* out_p = out_ptr + p * params->out_stride0;
+    __m512 sum = _mm512_add_ps(acc[0][p], acc[1][p]);
+    if (params->flags & IREE_UK_FLAG_GEMV_ACCUMULATE) {
+      sum = _mm512_add_ps(sum, _mm512_loadu_ps(out_p));
+    }
+    _mm512_storeu_ps(out_p, sum);
+  }
+}
+
+void iree_uk_gemv_tile_f32f32f32_16x1_x86_64_avx512_base(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_vector,
+    const void* IREE_UK_RESTRICT rhs_panels, iree_uk_int32_t panel_count,
+    const iree_uk_gemv_params_t* params) {
+  iree_uk_gemv_tile_fXXfXXf32_16x1_x86_64_avx512_base(
+      out_tile, lhs_vector, rhs_panels, panel_count, params, false);
+}
+
+void iree_uk_gemv_tile_f16f16f32_16x1_x86_64_avx512_base(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_vector,
+    const void* IREE_UK_RESTRICT rhs_panels, iree_uk_int32_t panel_count,
+    const iree_uk_gemv_params_t* params) {
+  iree_uk_gemv_tile_fXXfXXf32_16x1_x86_64_avx512_base(
+      out_tile, lhs_vector, rhs_panels, panel_count, params, true);
+}
@@ -0,0 +1,52 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/x86_64/common_x86_64.h"
+#include "iree/builtins/ukernel/arch/x86_64/gemv_x86_64_internal.h"
+
+// The N0 x K0 shapes here are those of the narrow-M mmt4d tiles, so that a RHS
+// packed for mmt4d on the same CPU can be consumed as is.
+static iree_uk_gemv_tile_func_t iree_uk_gemv_select_tile_func_x86_64_8x1(
+    const iree_uk_gemv_params_t* params) {
+#if defined(IREE_UK_BUILD_X86_64_AVX2_FMA)
+  if (!iree_uk_cpu_x86_64_avx2_fma(params->cpu_data)) return 0;
+  switch (iree_uk_gemv_type(params->flags)) {
+    case iree_uk_gemv_type_f32f32f32:
+      return iree_uk_gemv_tile_f32f32f32_8x1_x86_64_avx2_fma;
+    case iree_uk_gemv_type_f16f16f32:
+      return iree_uk_gemv_tile_f16f16f32_8x1_x86_64_avx2_fma;
+    default:
+      return 0;
+  }
+#endif
+  return 0;
+}
+
+static iree_uk_gemv_tile_func_t iree_uk_gemv_select_tile_func_x86_64_16x1(
+    const iree_uk_gemv_params_t* params) {
+#if defined(IREE_UK_BUILD_X86_64_AVX512_BASE)
+  if (!iree_uk_cpu_x86_64_avx512_base(params->cpu_data)) return 0;
+  switch (iree_uk_gemv_type(params->flags)) {
+    case iree_uk_gemv_type_f32f32f32:
+      return iree_uk_gemv_tile_f32f32f32_16x1_x86_64_avx512_base;
+    case iree_uk_gemv_type_f16f16f32:
+      return iree_uk_gemv_tile_f16f16f32_16x1_x86_64_avx512_base;
+    default:
+      return 0;
+  }
+#endif
+  return 0;
+}
+
+iree_uk_gemv_tile_func_t iree_uk_gemv_select_tile_func_arch(
+    const iree_uk_gemv_params_t* params) {
+  if (params->K0 != 1) return 0;
+  if (params->N0 == 8) return iree_uk_gemv_select_tile_func_x86_64_8x1(params);
+  if (params->N0 == 16) {
+    return iree_uk_gemv_select_tile_func_x86_64_16x1(params);
+  }
+  return 0;
+}
@@ -0,0 +1,17 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_BUILTINS_UKERNEL_ARCH_X86_64_GEMV_X86_64_INTERNAL_H_
+#define IREE_BUILTINS_UKERNEL_ARCH_X86_64_GEMV_X86_64_INTERNAL_H_
+
+#include "iree/builtins/ukernel/gemv_internal.h"
+
+IREE_UK_GEMV_TILE_FUNC_DECL(iree_uk_gemv_tile_f32f32f32_8x1_x86_64_avx2_fma)
+IREE_UK_GEMV_TILE_FUNC_DECL(iree_uk_gemv_tile_f16f16f32_8x1_x86_64_avx2_fma)
+IREE_UK_GEMV_TILE_FUNC_DECL(iree_uk_gemv_tile_f32f32f32_16x1_x86_64_avx512_base)
+IREE_UK_GEMV_TILE_FUNC_DECL(iree_uk_gemv_tile_f16f16f32_16x1_x86_64_avx512_base)
+
+#endif  // IREE_BUILTINS_UKERNEL_ARCH_X86_64_GEMV_X86_64_INTERNAL_H_
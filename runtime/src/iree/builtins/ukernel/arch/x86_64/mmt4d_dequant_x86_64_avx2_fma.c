@@ -0,0 +1,64 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/x86_64/common_x86_64.h"
+#include "iree/builtins/ukernel/arch/x86_64/mmt4d_dequant_x86_64_internal.h"
+
+// Each K0-tile is 32 consecutive f32 LHS values and 16 bytes of u4 RHS values,
+// the even elements in the low nibbles. Interleaving the low and high nibbles
+// restores the element order so that the LHS can be loaded as is.
+void iree_uk_mmt4d_dequant_tile_f32u4f32_1x1x32_x86_64_avx2_fma(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const void* IREE_UK_RESTRICT scales_panel,
+    const void* IREE_UK_RESTRICT zero_points_panel,
+    const iree_uk_mmt4d_dequant_params_t* params) {
+  float* IREE_UK_RESTRICT out_ptr = out_tile;
+  const float* IREE_UK_RESTRICT lhs_ptr = lhs_panel;
+  const iree_uk_uint8_t* IREE_UK_RESTRICT rhs_ptr = rhs_panel;
+  const float* IREE_UK_RESTRICT scales_ptr = scales_panel;
+  const float* IREE_UK_RESTRICT zero_points_ptr = zero_points_panel;
+  const __m128i nibble_mask = _mm_set1_epi8(0x0F);
+  iree_uk_index_t group_tiles = params->group_size / 32;
+  iree_uk_index_t group_count = params->K / group_tiles;
+  __m256 acc = _mm256_setzero_ps();
+  for (iree_uk_index_t g = 0; g < group_count; ++g) {
+    __m256 zero_point = _mm256_set1_ps(zero_points_ptr[g]);
+    __m256 group_acc[4];
+    IREE_UK_UNROLL for (int i = 0; i < 4; ++i) {
+      group_acc[i] = _mm256_setzero_ps();
+    }
+    for (iree_uk_index_t k = 0; k < group_tiles; ++k) {
+      __m128i rhs_u4 = _mm_loadu_si128((const __m128i*)rhs_ptr);
+      rhs_ptr += 16;
+      __m128i rhs_lo = _mm_and_si128(rhs_u4, nibble_mask);
+      __m128i rhs_hi = _mm_and_si128(_mm_srli_epi16(rhs_u4, 4), nibble_mask);
+      __m128i rhs_u8[2] = {_mm_unpacklo_epi8(rhs_lo, rhs_hi),
+                           _mm_unpackhi_epi8(rhs_lo, rhs_hi)};
+      IREE_UK_UNROLL for (int i = 0; i < 4; ++i) {
+        __m128i rhs_u8_8 =
+            (i & 1) ? _mm_srli_si128(rhs_u8[i / 2], 8) : rhs_u8[i / 2];
+        __m256 rhs = _mm256_sub_ps(
+            _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(rhs_u8_8)), zero_point);
+        group_acc[i] = _mm256_fmadd_ps(_mm256_loadu_ps(lhs_ptr + 8 * i), rhs,
+                                       group_acc[i]);
+      }
+      lhs_ptr += 32;
+    }
+    __m256 group_sum = _mm256_add_ps(_mm256_add_ps(group_acc[0], group_acc[1]),
+                                     _mm256_add_ps(group_acc[2], group_acc[3]));
+    acc = _mm256_fmadd_ps(group_sum, _mm256_set1_ps(scales_ptr[g]), acc);
+  }
+  __m128 acc_128 =
+      _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+  acc_128 = _mm_add_ps(acc_128, _mm_movehl_ps(acc_128, acc_128));
+  acc_128 = _mm_add_ss(acc_128, _mm_movehdup_ps(acc_128));
+  float result = _mm_cvtss_f32(acc_128);
+  if (params->flags & IREE_UK_FLAG_MMT4D_DEQUANT_ACCUMULATE) {
+    result += *out_ptr;
+  }
+  *out_ptr = result;
+}
@@ -0,0 +1,55 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/x86_64/common_x86_64.h"
+#include "iree/builtins/ukernel/arch/x86_64/mmt4d_dequant_x86_64_internal.h"
+
+// Same as the AVX2 variant, processing a K0-tile as two 16-wide halves.
+void iree_uk_mmt4d_dequant_tile_f32u4f32_1x1x32_x86_64_avx512_base(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const void* IREE_UK_RESTRICT scales_panel,
+    const void* IREE_UK_RESTRICT zero_points_panel,
+    const iree_uk_mmt4d_dequant_params_t* params) {
+  float* IREE_UK_RESTRICT out_ptr = out_tile;
+  const float* IREE_UK_RESTRICT lhs_ptr = lhs_panel;
+  const iree_uk_uint8_t* IREE_UK_RESTRICT rhs_ptr = rhs_panel;
+  const float* IREE_UK_RESTRICT scales_ptr = scales_panel;
+  const float* IREE_UK_RESTRICT zero_points_ptr = zero_points_panel;
+  const __m128i nibble_mask = _mm_set1_epi8(0x0F);
+  iree_uk_index_t group_tiles = params->group_size / 32;
+  iree_uk_index_t group_count = params->K / group_tiles;
+  __m512 acc = _mm512_setzero_ps();
+  for (iree_uk_index_t g = 0; g < group_count; ++g) {
+    __m512 zero_point = _mm512_set1_ps(zero_points_ptr[g]);
+    __m512 group_acc[2];
+    IREE_UK_UNROLL for (int i = 0; i < 2; ++i) {
+      group_acc[i] = _mm512_setzero_ps();
+    }
+    for (iree_uk_index_t k = 0; k < group_tiles; ++k) {
+      __m128i rhs_u4 = _mm_loadu_si128((const __m128i*)rhs_ptr);
+      rhs_ptr += 16;
+      __m128i rhs_lo = _mm_and_si128(rhs_u4, nibble_mask);
+      __m128i rhs_hi = _mm_and_si128(_mm_srli_epi16(rhs_u4, 4), nibble_mask);
+      __m128i rhs_u8[2] = {_mm_unpacklo_epi8(rhs_lo, rhs_hi),
+                           _mm_unpackhi_epi8(rhs_lo, rhs_hi)};
+      IREE_UK_UNROLL for (int i = 0; i < 2; ++i) {
+        __m512 rhs = _mm512_sub_ps(
+            _mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(rhs_u8[i])), zero_point);
+        group_acc[i] = _mm512_fmadd_ps(_mm512_loadu_ps(lhs_ptr + 16 * i), rhs,
+                                       group_acc[i]);
+      }
+      lhs_ptr += 32;
+    }
+    acc = _mm512_fmadd_ps(_mm512_add_ps(group_acc[0], group_acc[1]),
+                          _mm512_set1_ps(scales_ptr[g]), acc);
+  }
+  float result = _mm512_reduce_add_ps(acc);
+  if (params->flags & IREE_UK_FLAG_MMT4D_DEQUANT_ACCUMULATE) {
+    result += *out_ptr;
+  }
+  *out_ptr = result;
+}
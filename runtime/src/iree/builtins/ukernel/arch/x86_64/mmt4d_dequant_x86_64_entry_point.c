@@ -0,0 +1,37 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/x86_64/common_x86_64.h"
+#include "iree/builtins/ukernel/arch/x86_64/mmt4d_dequant_x86_64_internal.h"
+
+// The 1x1x32 tile is the unpacked row-major case, as produced by the compiler
+// for grouped-dequantization matmuls that were not data-tiled.
+static iree_uk_mmt4d_dequant_tile_func_t
+iree_uk_mmt4d_dequant_select_tile_func_x86_64_f32u4f32_1x1x32(
+    const iree_uk_mmt4d_dequant_params_t* params) {
+#if defined(IREE_UK_BUILD_X86_64_AVX512_BASE)
+  if (iree_uk_cpu_x86_64_avx512_base(params->cpu_data)) {
+    return iree_uk_mmt4d_dequant_tile_f32u4f32_1x1x32_x86_64_avx512_base;
+  }
+#endif
+#if defined(IREE_UK_BUILD_X86_64_AVX2_FMA)
+  if (iree_uk_cpu_x86_64_avx2_fma(params->cpu_data)) {
+    return iree_uk_mmt4d_dequant_tile_f32u4f32_1x1x32_x86_64_avx2_fma;
+  }
+#endif
+  return 0;
+}
+
+iree_uk_mmt4d_dequant_tile_func_t iree_uk_mmt4d_dequant_select_tile_func_arch(
+    const iree_uk_mmt4d_dequant_params_t* params) {
+  iree_uk_mmt4d_dequant_type_t type = iree_uk_mmt4d_dequant_type(params->flags);
+  if (type == iree_uk_mmt4d_dequant_type_f32u4f32 && params->M0 == 1 &&
+      params->N0 == 1 && params->K0 == 32) {
+    return iree_uk_mmt4d_dequant_select_tile_func_x86_64_f32u4f32_1x1x32(
+        params);
+  }
+  return 0;
+}
@@ -315,3 +315,113 @@ IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
 IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
     iree_uk_mmt4d_tile_s16s16s32_1x8x2_to_8x8x2_x86_64_avx2_fma,
     iree_uk_mmt4d_tile_s16s16s32_8x8x2_x86_64_avx2_fma, 8)
+
+IREE_UK_ATTRIBUTE_ALWAYS_INLINE static inline void
+iree_uk_mmt4d_tile_s8s4s32_1x8x2_to_8x8x2_x86_64_avx2_fma(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const iree_uk_mmt4d_params_t* params, int M0) {
+  IREE_UK_ASSERT(M0 >= 1 && M0 <= 8 && iree_uk_is_po2_u32(M0));
+  iree_uk_int32_t* IREE_UK_RESTRICT out_ptr = out_tile;
+  const iree_uk_int8_t* IREE_UK_RESTRICT lhs_ptr = lhs_panel;
+  const iree_uk_int8_t* IREE_UK_RESTRICT rhs_ptr = rhs_panel;
+  __m256i acc[8];
+  if (params->flags & IREE_UK_FLAG_MMT4D_ACCUMULATE) {
+    IREE_UK_UNROLL for (int i = 0; i < M0; ++i) {
+      acc[i] = _mm256_loadu_si256((__m256i*)(out_ptr + i * 8));
+    }
+  } else {
+    IREE_UK_UNROLL for (int i = 0; i < M0; ++i) {
+      acc[i] = _mm256_setzero_si256();
+    }
+  }
+
+  for (int k = 0; k < params->K; ++k) {
+    // Each rhs byte holds the 2 s4 values along K of one of the 8 columns.
+    // Zero-extend each byte to its own 32-bit lane and shift copies of it so
+    // that the low s4 lands in the top bits of the low i16 and the high s4 in
+    // the top bits of the high i16. An arithmetic shift then sign-extends both
+    // to i16, producing the rhs tile (2x8) in the same layout as s8s8s32.
+    __m256i rhs_u32 =
+        _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)rhs_ptr));
+    rhs_ptr += 8;
+    __m256i rhs_i16 = _mm256_srai_epi16(
+        _mm256_or_si256(_mm256_slli_epi32(rhs_u32, 12),
+                        _mm256_slli_epi32(rhs_u32, 24)),
+        12);
+    IREE_UK_UNROLL for (int i = 0; i < M0; ++i) {
+      acc[i] = _mm256_add_epi32(
+          acc[i], _mm256_madd_epi16(_mm256_cvtepi8_epi16(_mm_set1_epi16(
+                                        *(const iree_uk_int16_t*)lhs_ptr)),
+                                    rhs_i16));
+      lhs_ptr += 2;
+    }
+  }
+
+  IREE_UK_UNROLL for (int i = 0; i < M0; ++i) {
+    _mm256_storeu_si256((__m256i*)(out_ptr + i * 8), acc[i]);
+  }
+}
+
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_s8s4s32_1x8x2_to_8x8x2_x86_64_avx2_fma,
+    iree_uk_mmt4d_tile_s8s4s32_1x8x2_x86_64_avx2_fma, 1)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_s8s4s32_1x8x2_to_8x8x2_x86_64_avx2_fma,
+    iree_uk_mmt4d_tile_s8s4s32_2x8x2_x86_64_avx2_fma, 2)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_s8s4s32_1x8x2_to_8x8x2_x86_64_avx2_fma,
+    iree_uk_mmt4d_tile_s8s4s32_4x8x2_x86_64_avx2_fma, 4)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_s8s4s32_1x8x2_to_8x8x2_x86_64_avx2_fma,
+    iree_uk_mmt4d_tile_s8s4s32_8x8x2_x86_64_avx2_fma, 8)
+
+// Vecmat kernel. The rhs holds 8 u4 values along K for each column, so each
+// column is exactly one 32-bit lane, and each i16 half of that lane holds 4 of
+// the u4 values. Extracting the m-th u4 of each i16 half gives a vector that
+// _mm256_madd_epi16 can multiply against lhs values m and m+4 to accumulate
+// a partial dot product per column, without ever moving rhs data across lanes.
+void iree_uk_mmt4d_tile_s16u4s32_1x16x8_x86_64_avx2_fma(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const iree_uk_mmt4d_params_t* params) {
+  iree_uk_int32_t* IREE_UK_RESTRICT out_ptr = out_tile;
+  const iree_uk_int16_t* IREE_UK_RESTRICT lhs_ptr = lhs_panel;
+  const iree_uk_uint8_t* IREE_UK_RESTRICT rhs_ptr = rhs_panel;
+  // Accumulator shape: 1x16xs32, in 2 registers, each 1x8xs32.
+  __m256i acc0, acc1;
+  if (params->flags & IREE_UK_FLAG_MMT4D_ACCUMULATE) {
+    acc0 = _mm256_loadu_si256((const __m256i*)(out_ptr + 8 * 0));
+    acc1 = _mm256_loadu_si256((const __m256i*)(out_ptr + 8 * 1));
+  } else {
+    acc0 = _mm256_setzero_si256();
+    acc1 = _mm256_setzero_si256();
+  }
+  const __m256i mask_000f = _mm256_set1_epi16(0x000f);
+  for (int k = 0; k < params->K; ++k) {
+    // Load 8xs16 LHS data and pair up lanes m and m+4 as
+    // (0, 4, 1, 5, 2, 6, 3, 7), then broadcast each pair.
+    __m128i lhs = _mm_loadu_si128((const __m128i*)lhs_ptr);
+    lhs_ptr += 8;
+    __m128i lhs_pairs = _mm_unpacklo_epi16(lhs, _mm_srli_si128(lhs, 8));
+    __m256i lhs_pair[4];
+    lhs_pair[0] = _mm256_broadcastd_epi32(lhs_pairs);
+    lhs_pair[1] = _mm256_broadcastd_epi32(_mm_srli_si128(lhs_pairs, 4));
+    lhs_pair[2] = _mm256_broadcastd_epi32(_mm_srli_si128(lhs_pairs, 8));
+    lhs_pair[3] = _mm256_broadcastd_epi32(_mm_srli_si128(lhs_pairs, 12));
+    // Load 8x16xu4 RHS data, in 2 registers, each 8x8xu4.
+    __m256i rhs0 = _mm256_loadu_si256((const __m256i*)(rhs_ptr + 32 * 0));
+    __m256i rhs1 = _mm256_loadu_si256((const __m256i*)(rhs_ptr + 32 * 1));
+    rhs_ptr += 64;
+    IREE_UK_UNROLL for (int m = 0; m < 4; ++m) {
+      __m256i rhs0_u4 =
+          _mm256_and_si256(mask_000f, _mm256_srli_epi16(rhs0, 4 * m));
+      __m256i rhs1_u4 =
+          _mm256_and_si256(mask_000f, _mm256_srli_epi16(rhs1, 4 * m));
+      acc0 = _mm256_add_epi32(acc0, _mm256_madd_epi16(lhs_pair[m], rhs0_u4));
+      acc1 = _mm256_add_epi32(acc1, _mm256_madd_epi16(lhs_pair[m], rhs1_u4));
+    }
+  }
+  _mm256_storeu_si256((__m256i*)(out_ptr + 8 * 0), acc0);
+  _mm256_storeu_si256((__m256i*)(out_ptr + 8 * 1), acc1);
+}
@@ -360,3 +360,112 @@ IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
 IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
     iree_uk_mmt4d_tile_s16s16s32_1x16x2_to_16x16x2_x86_64_avx512_base,
     iree_uk_mmt4d_tile_s16s16s32_16x16x2_x86_64_avx512_base, 16)
+
+IREE_UK_ATTRIBUTE_ALWAYS_INLINE static inline void
+iree_uk_mmt4d_tile_s8s4s32_1x16x2_to_16x16x2_x86_64_avx512_base(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const iree_uk_mmt4d_params_t* params, int M0) {
+  IREE_UK_ASSERT(M0 >= 1 && M0 <= 16 && iree_uk_is_po2_u32(M0));
+  iree_uk_int32_t* IREE_UK_RESTRICT out_ptr = out_tile;
+  const iree_uk_int8_t* IREE_UK_RESTRICT lhs_ptr = lhs_panel;
+  const iree_uk_int8_t* IREE_UK_RESTRICT rhs_ptr = rhs_panel;
+  __m512i acc[16];
+  if (params->flags & IREE_UK_FLAG_MMT4D_ACCUMULATE) {
+    IREE_UK_UNROLL for (int i = 0; i < M0; ++i) {
+      acc[i] = _mm512_loadu_si512((__m512i*)(out_ptr + i * 16));
+    }
+  } else {
+    IREE_UK_UNROLL for (int i = 0; i < M0; ++i) {
+      acc[i] = _mm512_setzero_si512();
+    }
+  }
+
+  for (int k = 0; k < params->K; ++k) {
+    // rhs_i16 is the rhs tile (2x16), sign-extended from s4 to i16. See the
+    // s8s4s32 avx2_fma tile for how the s4 values are extracted.
+    __m512i rhs_u32 =
+        _mm512_cvtepu8_epi32(_mm_loadu_si128((const __m128i*)rhs_ptr));
+    rhs_ptr += 16;
+    __m512i rhs_i16 = _mm512_srai_epi16(
+        _mm512_or_si512(_mm512_slli_epi32(rhs_u32, 12),
+                        _mm512_slli_epi32(rhs_u32, 24)),
+        12);
+    IREE_UK_UNROLL for (int i = 0; i < M0; ++i) {
+      acc[i] = _mm512_add_epi32(
+          acc[i], _mm512_madd_epi16(_mm512_cvtepi8_epi16(_mm256_set1_epi16(
+                                        *(const iree_uk_int16_t*)lhs_ptr)),
+                                    rhs_i16));
+      lhs_ptr += 2;
+    }
+  }
+
+  IREE_UK_UNROLL for (int i = 0; i < M0; ++i) {
+    _mm512_storeu_si512((__m512i*)(out_ptr + i * 16), acc[i]);
+  }
+}
+
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_s8s4s32_1x16x2_to_16x16x2_x86_64_avx512_base,
+    iree_uk_mmt4d_tile_s8s4s32_1x16x2_x86_64_avx512_base, 1)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_s8s4s32_1x16x2_to_16x16x2_x86_64_avx512_base,
+    iree_uk_mmt4d_tile_s8s4s32_2x16x2_x86_64_avx512_base, 2)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_s8s4s32_1x16x2_to_16x16x2_x86_64_avx512_base,
+    iree_uk_mmt4d_tile_s8s4s32_4x16x2_x86_64_avx512_base, 4)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_s8s4s32_1x16x2_to_16x16x2_x86_64_avx512_base,
+    iree_uk_mmt4d_tile_s8s4s32_8x16x2_x86_64_avx512_base, 8)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_s8s4s32_1x16x2_to_16x16x2_x86_64_avx512_base,
+    iree_uk_mmt4d_tile_s8s4s32_16x16x2_x86_64_avx512_base, 16)
+
+// Vecmat kernel. Same approach as the s16u4s32 avx2_fma tile: each column of
+// 8 u4 values is one 32-bit lane and the m-th u4 of each i16 half is multiplied
+// against lhs values m and m+4 with _mm512_madd_epi16. The avx512_vnni tile is
+// preferred where available as it avoids most of the rhs unpacking.
+void iree_uk_mmt4d_tile_s16u4s32_1x32x8_x86_64_avx512_base(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const iree_uk_mmt4d_params_t* params) {
+  iree_uk_int32_t* IREE_UK_RESTRICT out_ptr = out_tile;
+  const iree_uk_int16_t* IREE_UK_RESTRICT lhs_ptr = lhs_panel;
+  const iree_uk_uint8_t* IREE_UK_RESTRICT rhs_ptr = rhs_panel;
+  // Accumulator shape: 1x32xs32, in 2 registers, each 1x16xs32.
+  __m512i acc0, acc1;
+  if (params->flags & IREE_UK_FLAG_MMT4D_ACCUMULATE) {
+    acc0 = _mm512_loadu_si512((const __m512i*)(out_ptr + 16 * 0));
+    acc1 = _mm512_loadu_si512((const __m512i*)(out_ptr + 16 * 1));
+  } else {
+    acc0 = _mm512_setzero_si512();
+    acc1 = _mm512_setzero_si512();
+  }
+  const __m512i mask_000f = _mm512_set1_epi16(0x000f);
+  for (int k = 0; k < params->K; ++k) {
+    // Load 8xs16 LHS data and pair up lanes m and m+4 as
+    // (0, 4, 1, 5, 2, 6, 3, 7), then broadcast each pair.
+    __m128i lhs = _mm_loadu_si128((const __m128i*)lhs_ptr);
+    lhs_ptr += 8;
+    __m128i lhs_pairs = _mm_unpacklo_epi16(lhs, _mm_srli_si128(lhs, 8));
+    __m512i lhs_pair[4];
+    lhs_pair[0] = _mm512_broadcastd_epi32(lhs_pairs);
+    lhs_pair[1] = _mm512_broadcastd_epi32(_mm_srli_si128(lhs_pairs, 4));
+    lhs_pair[2] = _mm512_broadcastd_epi32(_mm_srli_si128(lhs_pairs, 8));
+    lhs_pair[3] = _mm512_broadcastd_epi32(_mm_srli_si128(lhs_pairs, 12));
+    // Load 8x32xu4 RHS data, in 2 registers, each 8x16xu4.
+    __m512i rhs0 = _mm512_loadu_si512((const __m512i*)(rhs_ptr + 64 * 0));
+    __m512i rhs1 = _mm512_loadu_si512((const __m512i*)(rhs_ptr + 64 * 1));
+    rhs_ptr += 128;
+    IREE_UK_UNROLL for (int m = 0; m < 4; ++m) {
+      __m512i rhs0_u4 =
+          _mm512_and_si512(mask_000f, _mm512_srli_epi16(rhs0, 4 * m));
+      __m512i rhs1_u4 =
+          _mm512_and_si512(mask_000f, _mm512_srli_epi16(rhs1, 4 * m));
+      acc0 = _mm512_add_epi32(acc0, _mm512_madd_epi16(lhs_pair[m], rhs0_u4));
+      acc1 = _mm512_add_epi32(acc1, _mm512_madd_epi16(lhs_pair[m], rhs1_u4));
+    }
+  }
+  _mm512_storeu_si512((__m512i*)(out_ptr + 16 * 0), acc0);
+  _mm512_storeu_si512((__m512i*)(out_ptr + 16 * 1), acc1);
+}
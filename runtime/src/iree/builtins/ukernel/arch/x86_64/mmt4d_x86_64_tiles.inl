@@ -11,10 +11,15 @@ IREE_UK_MMT4D_TILE(x86_64, s8, s8, s32, 1, 8, 2, _avx2_fma)
 IREE_UK_MMT4D_TILE(x86_64, s8, s8, s32, 2, 8, 2, _avx2_fma)
 IREE_UK_MMT4D_TILE(x86_64, s8, s8, s32, 4, 8, 2, _avx2_fma)
 IREE_UK_MMT4D_TILE(x86_64, s8, s8, s32, 8, 8, 2, _avx2_fma)
+IREE_UK_MMT4D_TILE(x86_64, s8, s4, s32, 1, 8, 2, _avx2_fma)
+IREE_UK_MMT4D_TILE(x86_64, s8, s4, s32, 2, 8, 2, _avx2_fma)
+IREE_UK_MMT4D_TILE(x86_64, s8, s4, s32, 4, 8, 2, _avx2_fma)
+IREE_UK_MMT4D_TILE(x86_64, s8, s4, s32, 8, 8, 2, _avx2_fma)
 IREE_UK_MMT4D_TILE(x86_64, s16, s16, s32, 1, 8, 2, _avx2_fma)
 IREE_UK_MMT4D_TILE(x86_64, s16, s16, s32, 2, 8, 2, _avx2_fma)
 IREE_UK_MMT4D_TILE(x86_64, s16, s16, s32, 4, 8, 2, _avx2_fma)
 IREE_UK_MMT4D_TILE(x86_64, s16, s16, s32, 8, 8, 2, _avx2_fma)
+IREE_UK_MMT4D_TILE(x86_64, s16, u4, s32, 1, 16, 8, _avx2_fma)
 IREE_UK_MMT4D_TILE(x86_64, f32, f32, f32, 1, 8, 1, _avx2_fma)
 IREE_UK_MMT4D_TILE(x86_64, f32, f32, f32, 2, 8, 1, _avx2_fma)
 IREE_UK_MMT4D_TILE(x86_64, f32, f32, f32, 4, 8, 1, _avx2_fma)
@@ -62,6 +67,16 @@ IREE_UK_MMT4D_TILE(x86_64, s8, s8, s32, 2, 16, 2, _avx512_vnni)
 IREE_UK_MMT4D_TILE(x86_64, s8, s8, s32, 4, 16, 2, _avx512_vnni)
 IREE_UK_MMT4D_TILE(x86_64, s8, s8, s32, 8, 16, 2, _avx512_vnni)
 IREE_UK_MMT4D_TILE(x86_64, s8, s8, s32, 16, 16, 2, _avx512_vnni)
+IREE_UK_MMT4D_TILE(x86_64, s8, s4, s32, 1, 16, 2, _avx512_base)
+IREE_UK_MMT4D_TILE(x86_64, s8, s4, s32, 2, 16, 2, _avx512_base)
+IREE_UK_MMT4D_TILE(x86_64, s8, s4, s32, 4, 16, 2, _avx512_base)
+IREE_UK_MMT4D_TILE(x86_64, s8, s4, s32, 8, 16, 2, _avx512_base)
+IREE_UK_MMT4D_TILE(x86_64, s8, s4, s32, 16, 16, 2, _avx512_base)
+IREE_UK_MMT4D_TILE(x86_64, s8, s4, s32, 1, 16, 2, _avx512_vnni)
+IREE_UK_MMT4D_TILE(x86_64, s8, s4, s32, 2, 16, 2, _avx512_vnni)
+IREE_UK_MMT4D_TILE(x86_64, s8, s4, s32, 4, 16, 2, _avx512_vnni)
+IREE_UK_MMT4D_TILE(x86_64, s8, s4, s32, 8, 16, 2, _avx512_vnni)
+IREE_UK_MMT4D_TILE(x86_64, s8, s4, s32, 16, 16, 2, _avx512_vnni)
 IREE_UK_MMT4D_TILE(x86_64, s16, s16, s32, 1, 16, 2, _avx512_base)
 IREE_UK_MMT4D_TILE(x86_64, s16, s16, s32, 2, 16, 2, _avx512_base)
 IREE_UK_MMT4D_TILE(x86_64, s16, s16, s32, 4, 16, 2, _avx512_base)
@@ -72,4 +87,5 @@ IREE_UK_MMT4D_TILE(x86_64, s16, s16, s32, 2, 16, 2, _avx512_vnni)
 IREE_UK_MMT4D_TILE(x86_64, s16, s16, s32, 4, 16, 2, _avx512_vnni)
 IREE_UK_MMT4D_TILE(x86_64, s16, s16, s32, 8, 16, 2, _avx512_vnni)
 IREE_UK_MMT4D_TILE(x86_64, s16, s16, s32, 16, 16, 2, _avx512_vnni)
+IREE_UK_MMT4D_TILE(x86_64, s16, u4, s32, 1, 32, 8, _avx512_base)
 IREE_UK_MMT4D_TILE(x86_64, s16, u4, s32, 1, 32, 8, _avx512_vnni)
@@ -0,0 +1,68 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/x86_64/common_x86_64.h"
+#include "iree/builtins/ukernel/arch/x86_64/softmax_x86_64_internal.h"
+
+void iree_uk_softmax_tile_f32f32_x86_64_avx2_fma(
+    void* IREE_UK_RESTRICT out_row_untyped,
+    const void* IREE_UK_RESTRICT in_row_untyped,
+    const iree_uk_softmax_params_t* params) {
+  float* IREE_UK_RESTRICT out_row = out_row_untyped;
+  const float* IREE_UK_RESTRICT in_row = in_row_untyped;
+  iree_uk_index_t size = params->size1;
+  // First pass: per-lane running max and sum of exponentials relative to it.
+  // Blocks of 4 vectors share a single rescaling of the partial sums.
+  __m256 max = _mm256_set1_ps(IREE_UK_FLOAT_LOWEST);
+  __m256 sum = _mm256_setzero_ps();
+  iree_uk_index_t j = 0;
+  for (; j + 32 <= size; j += 32) {
+    __m256 x0 = _mm256_loadu_ps(in_row + j + 0);
+    __m256 x1 = _mm256_loadu_ps(in_row + j + 8);
+    __m256 x2 = _mm256_loadu_ps(in_row + j + 16);
+    __m256 x3 = _mm256_loadu_ps(in_row + j + 24);
+    __m256 new_max =
+        _mm256_max_ps(_mm256_max_ps(x0, x1), _mm256_max_ps(x2, x3));
+    new_max = _mm256_max_ps(max, new_max);
+    sum = _mm256_mul_ps(sum, iree_uk_avx2_exp_ps(_mm256_sub_ps(max, new_max)));
+    __m256 e01 =
+        _mm256_add_ps(iree_uk_avx2_exp_ps(_mm256_sub_ps(x0, new_max)),
+                      iree_uk_avx2_exp_ps(_mm256_sub_ps(x1, new_max)));
+    __m256 e23 =
+        _mm256_add_ps(iree_uk_avx2_exp_ps(_mm256_sub_ps(x2, new_max)),
+                      iree_uk_avx2_exp_ps(_mm256_sub_ps(x3, new_max)));
+    sum = _mm256_add_ps(sum, _mm256_add_ps(e01, e23));
+    max = new_max;
+  }
+  for (; j + 8 <= size; j += 8) {
+    __m256 x = _mm256_loadu_ps(in_row + j);
+    __m256 new_max = _mm256_max_ps(max, x);
+    sum = _mm256_mul_ps(sum, iree_uk_avx2_exp_ps(_mm256_sub_ps(max, new_max)));
+    sum = _mm256_add_ps(sum, iree_uk_avx2_exp_ps(_mm256_sub_ps(x, new_max)));
+    max = new_max;
+  }
+  // Combine the lanes, then fold in the remaining elements.
+  float row_max = iree_uk_avx2_reduce_max_ps(max);
+  float row_sum = iree_uk_avx2_reduce_add_ps(_mm256_mul_ps(
+      sum,
+      iree_uk_avx2_exp_ps(_mm256_sub_ps(max, _mm256_set1_ps(row_max)))));
+  for (; j < size; ++j) {
+    iree_uk_softmax_accumulate_f32(in_row[j], &row_max, &row_sum);
+  }
+  // Second pass: write the normalized exponentials.
+  float inv_sum = 1.f / row_sum;
+  __m256 row_max_v = _mm256_set1_ps(row_max);
+  __m256 inv_sum_v = _mm256_set1_ps(inv_sum);
+  j = 0;
+  for (; j + 8 <= size; j += 8) {
+    __m256 x = _mm256_loadu_ps(in_row + j);
+    __m256 e = iree_uk_avx2_exp_ps(_mm256_sub_ps(x, row_max_v));
+    _mm256_storeu_ps(out_row + j, _mm256_mul_ps(e, inv_sum_v));
+  }
+  for (; j < size; ++j) {
+    out_row[j] = iree_uk_exp_f32(in_row[j] - row_max) * inv_sum;
+  }
+}
@@ -0,0 +1,66 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/x86_64/common_x86_64.h"
+#include "iree/builtins/ukernel/arch/x86_64/softmax_x86_64_internal.h"
+
+void iree_uk_softmax_tile_f32f32_x86_64_avx512_base(
+    void* IREE_UK_RESTRICT out_row_untyped,
+    const void* IREE_UK_RESTRICT in_row_untyped,
+    const iree_uk_softmax_params_t* params) {
+  float* IREE_UK_RESTRICT out_row = out_row_untyped;
+  const float* IREE_UK_RESTRICT in_row = in_row_untyped;
+  iree_uk_index_t size = params->size1;
+  // First pass: per-lane running max and sum of exponentials relative to it.
+  // Blocks of 4 vectors share a single rescaling of the partial sums.
+  __m512 max = _mm512_set1_ps(IREE_UK_FLOAT_LOWEST);
+  __m512 sum = _mm512_setzero_ps();
+  iree_uk_index_t j = 0;
+  for (; j + 64 <= size; j += 64) {
+    __m512 x0 = _mm512_loadu_ps(in_row + j + 0);
+    __m512 x1 = _mm512_loadu_ps(in_row + j + 16);
+    __m512 x2 = _mm512_loadu_ps(in_row + j + 32);
+    __m512 x3 = _mm512_loadu_ps(in_row + j + 48);
+    __m512 new_max =
+        _mm512_max_ps(_mm512_max_ps(x0, x1), _mm512_max_ps(x2, x3));
+    new_max = _mm512_max_ps(max, new_max);
+    sum = _mm512_mul_ps(sum,
+                        iree_uk_avx512_exp_ps(_mm512_sub_ps(max, new_max)));
+    __m512 e01 =
+        _mm512_add_ps(iree_uk_avx512_exp_ps(_mm512_sub_ps(x0, new_max)),
+                      iree_uk_avx512_exp_ps(_mm512_sub_ps(x1, new_max)));
+    __m512 e23 =
+        _mm512_add_ps(iree_uk_avx512_exp_ps(_mm512_sub_ps(x2, new_max)),
+                      iree_uk_avx512_exp_ps(_mm512_sub_ps(x3, new_max)));
+    sum = _mm512_add_ps(sum, _mm512_add_ps(e01, e23));
+    max = new_max;
+  }
+  // Remaining elements, including a final partial vector, update only the
+  // lanes that they occupy.
+  for (; j < size; j += 16) {
+    __mmask16 mask = size - j >= 16 ? 0xFFFF : (1u << (size - j)) - 1;
+    __m512 x = _mm512_maskz_loadu_ps(mask, in_row + j);
+    __m512 new_max = _mm512_mask_max_ps(max, mask, max, x);
+    sum = _mm512_mul_ps(sum,
+                        iree_uk_avx512_exp_ps(_mm512_sub_ps(max, new_max)));
+    sum = _mm512_mask_add_ps(
+        sum, mask, sum, iree_uk_avx512_exp_ps(_mm512_sub_ps(x, new_max)));
+    max = new_max;
+  }
+  float row_max = _mm512_reduce_max_ps(max);
+  float row_sum = _mm512_reduce_add_ps(_mm512_mul_ps(
+      sum,
+      iree_uk_avx512_exp_ps(_mm512_sub_ps(max, _mm512_set1_ps(row_max)))));
+  // Second pass: write the normalized exponentials.
+  __m512 row_max_v = _mm512_set1_ps(row_max);
+  __m512 inv_sum_v = _mm512_set1_ps(1.f / row_sum);
+  for (j = 0; j < size; j += 16) {
+    __mmask16 mask = size - j >= 16 ? 0xFFFF : (1u << (size - j)) - 1;
+    __m512 x = _mm512_maskz_loadu_ps(mask, in_row + j);
+    __m512 e = iree_uk_avx512_exp_ps(_mm512_sub_ps(x, row_max_v));
+    _mm512_mask_storeu_ps(out_row + j, mask, _mm512_mul_ps(e, inv_sum_v));
+  }
+}
@@ -0,0 +1,26 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/x86_64/common_x86_64.h"
+#include "iree/builtins/ukernel/arch/x86_64/softmax_x86_64_internal.h"
+
+iree_uk_softmax_tile_func_t iree_uk_softmax_select_tile_func_arch(
+    const iree_uk_softmax_params_t* params) {
+  if (iree_uk_softmax_type(params->flags) != iree_uk_softmax_type_f32f32) {
+    return 0;
+  }
+#if defined(IREE_UK_BUILD_X86_64_AVX512_BASE)
+  if (iree_uk_cpu_x86_64_avx512_base(params->cpu_data)) {
+    return iree_uk_softmax_tile_f32f32_x86_64_avx512_base;
+  }
+#endif
+#if defined(IREE_UK_BUILD_X86_64_AVX2_FMA)
+  if (iree_uk_cpu_x86_64_avx2_fma(params->cpu_data)) {
+    return iree_uk_softmax_tile_f32f32_x86_64_avx2_fma;
+  }
+#endif
+  return 0;
+}
@@ -0,0 +1,120 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/attention.h"
+
+#include "iree/builtins/ukernel/attention_internal.h"
+
+static void iree_uk_attention_validate(
+    const iree_uk_attention_params_t* params) {
+#ifdef IREE_UK_ENABLE_ASSERTS
+  const iree_uk_uint32_t allflags =
+      IREE_UK_FLAG_ATTENTION_TYPE_MASK | IREE_UK_FLAG_ATTENTION_TRANSPOSE_V;
+  IREE_UK_ASSERT(!(params->flags & ~allflags));
+  iree_uk_uint32_t flags_type =
+      params->flags & IREE_UK_FLAG_ATTENTION_TYPE_MASK;
+  IREE_UK_ASSERT(flags_type != IREE_UK_FLAG_ATTENTION_TYPE_NONE);
+  IREE_UK_ASSERT(flags_type < IREE_UK_FLAG_ATTENTION_TYPE_END);
+  IREE_UK_ASSERT(params->batch >= 0);
+  IREE_UK_ASSERT(params->M >= 0);
+  IREE_UK_ASSERT(params->K1 >= 0);
+  IREE_UK_ASSERT(params->K2 >= 0);
+  IREE_UK_ASSERT(params->N >= 0);
+  IREE_UK_ASSERT(params->q_stride1 >= params->K1);
+  IREE_UK_ASSERT(params->k_stride1 >= params->K1);
+  bool transpose_v = params->flags & IREE_UK_FLAG_ATTENTION_TRANSPOSE_V;
+  IREE_UK_ASSERT(params->v_stride1 >= (transpose_v ? params->K2 : params->N));
+  IREE_UK_ASSERT(params->out_stride1 >= params->N);
+#endif  // IREE_UK_ENABLE_ASSERTS
+}
+
+// Early-return implementation for this ukernel. Returns true if already done.
+// Note that K2 == 0 is not an early return: the softmax over an empty row is
+// defined here as all zeros, and the tile functions write those.
+static bool iree_uk_attention_early(const iree_uk_attention_params_t* params) {
+  return params->batch == 0 || params->M == 0 || params->N == 0;
+}
+
+static void iree_uk_attention_using_tile_func(
+    const iree_uk_attention_params_t* params,
+    iree_uk_attention_tile_func_t tile_func) {
+  iree_uk_attention_type_t type = iree_uk_attention_type(params->flags);
+  iree_uk_index_t in_elem_size =
+      iree_uk_type_size(iree_uk_attention_in_type(type));
+  iree_uk_index_t out_elem_size =
+      iree_uk_type_size(iree_uk_attention_out_type(type));
+  const char* q =
+      (const char*)params->q_buffer + params->q_offset * in_elem_size;
+  const char* k =
+      (const char*)params->k_buffer + params->k_offset * in_elem_size;
+  const char* v =
+      (const char*)params->v_buffer + params->v_offset * in_elem_size;
+  char* out = (char*)params->out_buffer + params->out_offset * out_elem_size;
+  for (iree_uk_index_t b = 0; b < params->batch; ++b) {
+    const char* q_rows = q;
+    char* out_rows = out;
+    for (iree_uk_index_t i = 0; i < params->M;
+         i += IREE_UK_ATTENTION_BLOCK_M) {
+      iree_uk_index_t rows =
+          iree_uk_index_min(IREE_UK_ATTENTION_BLOCK_M, params->M - i);
+      tile_func(out_rows, q_rows, k, v, rows, params);
+      q_rows += IREE_UK_ATTENTION_BLOCK_M * params->q_stride1 * in_elem_size;
+      out_rows +=
+          IREE_UK_ATTENTION_BLOCK_M * params->out_stride1 * out_elem_size;
+    }
+    q += params->q_stride0 * in_elem_size;
+    k += params->k_stride0 * in_elem_size;
+    v += params->v_stride0 * in_elem_size;
+    out += params->out_stride0 * out_elem_size;
+  }
+}
+
+void iree_uk_attention_p(const iree_uk_attention_params_t* params) {
+  iree_uk_attention_validate(params);
+
+  if (iree_uk_attention_early(params)) return;
+
+  iree_uk_attention_tile_func_t tile_func =
+      iree_uk_attention_select_tile_func(params);
+  iree_uk_attention_using_tile_func(params, tile_func);
+}
+
+IREE_UK_EXPORT void iree_uk_attention(
+    const void* q_buffer, iree_uk_index_t q_offset, iree_uk_index_t q_stride0,
+    iree_uk_index_t q_stride1, const void* k_buffer, iree_uk_index_t k_offset,
+    iree_uk_index_t k_stride0, iree_uk_index_t k_stride1, const void* v_buffer,
+    iree_uk_index_t v_offset, iree_uk_index_t v_stride0,
+    iree_uk_index_t v_stride1, void* out_buffer, iree_uk_index_t out_offset,
+    iree_uk_index_t out_stride0, iree_uk_index_t out_stride1,
+    iree_uk_index_t batch, iree_uk_index_t M, iree_uk_index_t K1,
+    iree_uk_index_t K2, iree_uk_index_t N, float scale, iree_uk_uint32_t flags,
+    const iree_uk_uint64_t* cpu_data) {
+  iree_uk_attention_params_t params = {.q_buffer = q_buffer,
+                                       .q_offset = q_offset,
+                                       .q_stride0 = q_stride0,
+                                       .q_stride1 = q_stride1,
+                                       .k_buffer = k_buffer,
+                                       .k_offset = k_offset,
+                                       .k_stride0 = k_stride0,
+                                       .k_stride1 = k_stride1,
+                                       .v_buffer = v_buffer,
+                                       .v_offset = v_offset,
+                                       .v_stride0 = v_stride0,
+                                       .v_stride1 = v_stride1,
+                                       .out_buffer = out_buffer,
+                                       .out_offset = out_offset,
+                                       .out_stride0 = out_stride0,
+                                       .out_stride1 = out_stride1,
+                                       .batch = batch,
+                                       .M = M,
+                                       .K1 = K1,
+                                       .K2 = K2,
+                                       .N = N,
+                                       .scale = scale,
+                                       .flags = flags,
+                                       .cpu_data = cpu_data};
+  iree_uk_attention_p(&params);
+}
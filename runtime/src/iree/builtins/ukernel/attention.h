@@ -0,0 +1,39 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_BUILTINS_UKERNEL_ATTENTION_H_
+#define IREE_BUILTINS_UKERNEL_ATTENTION_H_
+
+#include "iree/builtins/ukernel/common.h"
+
+// `attention` microkernel. Computes, independently for each of the `batch`
+// batch entries,
+//
+//   out = softmax(scale * q . k^T) . v
+//
+// where q is [M][K1], k is [K2][K1], v is [K2][N] (or [N][K2] with
+// IREE_UK_FLAG_ATTENTION_TRANSPOSE_V) and out is [M][N]. Each operand has a
+// batch stride (stride0) and a row stride (stride1), its innermost dimension
+// being contiguous.
+//
+// This is a flash-attention style kernel: k and v are traversed in blocks of
+// rows, the softmax is computed online (rescaling the partial results
+// whenever the running row max grows), and the [M][K2] score matrix is never
+// materialized. Only a small block of scores for a few q rows lives at a time,
+// so the working set stays in L1 however long the sequence is. All arithmetic
+// is in f32 regardless of the element type.
+IREE_UK_EXPORT void iree_uk_attention(
+    const void* q_buffer, iree_uk_index_t q_offset, iree_uk_index_t q_stride0,
+    iree_uk_index_t q_stride1, const void* k_buffer, iree_uk_index_t k_offset,
+    iree_uk_index_t k_stride0, iree_uk_index_t k_stride1, const void* v_buffer,
+    iree_uk_index_t v_offset, iree_uk_index_t v_stride0,
+    iree_uk_index_t v_stride1, void* out_buffer, iree_uk_index_t out_offset,
+    iree_uk_index_t out_stride0, iree_uk_index_t out_stride1,
+    iree_uk_index_t batch, iree_uk_index_t M, iree_uk_index_t K1,
+    iree_uk_index_t K2, iree_uk_index_t N, float scale, iree_uk_uint32_t flags,
+    const iree_uk_uint64_t* cpu_data);
+
+#endif  // IREE_BUILTINS_UKERNEL_ATTENTION_H_
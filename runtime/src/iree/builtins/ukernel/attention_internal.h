@@ -0,0 +1,141 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_BUILTINS_UKERNEL_ATTENTION_INTERNAL_H_
+#define IREE_BUILTINS_UKERNEL_ATTENTION_INTERNAL_H_
+
+#include "iree/builtins/ukernel/attention.h"
+
+typedef struct iree_uk_attention_params_t {
+  const void* q_buffer;
+  iree_uk_index_t q_offset;
+  iree_uk_index_t q_stride0;
+  iree_uk_index_t q_stride1;
+  const void* k_buffer;
+  iree_uk_index_t k_offset;
+  iree_uk_index_t k_stride0;
+  iree_uk_index_t k_stride1;
+  const void* v_buffer;
+  iree_uk_index_t v_offset;
+  iree_uk_index_t v_stride0;
+  iree_uk_index_t v_stride1;
+  void* out_buffer;
+  iree_uk_index_t out_offset;
+  iree_uk_index_t out_stride0;
+  iree_uk_index_t out_stride1;
+  iree_uk_index_t batch;
+  iree_uk_index_t M;
+  iree_uk_index_t K1;
+  iree_uk_index_t K2;
+  iree_uk_index_t N;
+  float scale;
+  iree_uk_uint32_t flags;
+  const iree_uk_uint64_t* cpu_data;
+} iree_uk_attention_params_t;
+
+void iree_uk_attention_p(const iree_uk_attention_params_t* params);
+
+// The first type is that of q, k and v, the second that of out.
+typedef enum iree_uk_attention_type_t {
+  iree_uk_attention_type_f32f32 =
+      IREE_UK_TIE_2_TYPES_LITERAL(FLOAT_32, FLOAT_32),
+  iree_uk_attention_type_f16f16 =
+      IREE_UK_TIE_2_TYPES_LITERAL(FLOAT_16, FLOAT_16),
+  iree_uk_attention_type_bf16bf16 =
+      IREE_UK_TIE_2_TYPES_LITERAL(BFLOAT_16, BFLOAT_16),
+} iree_uk_attention_type_t;
+
+static inline iree_uk_attention_type_t iree_uk_attention_type(
+    iree_uk_uint32_t flags) {
+  switch (flags & IREE_UK_FLAG_ATTENTION_TYPE_MASK) {
+    case IREE_UK_FLAG_ATTENTION_TYPE_F32F32:
+      return iree_uk_attention_type_f32f32;
+    case IREE_UK_FLAG_ATTENTION_TYPE_F16F16:
+      return iree_uk_attention_type_f16f16;
+    case IREE_UK_FLAG_ATTENTION_TYPE_BF16BF16:
+      return iree_uk_attention_type_bf16bf16;
+    default:
+      // Shouldn't happen, validated earlier.
+      return (iree_uk_attention_type_t)0;
+  }
+}
+
+static inline iree_uk_type_t iree_uk_attention_in_type(
+    iree_uk_attention_type_t type) {
+  return iree_uk_untie_type(0, type);
+}
+
+static inline iree_uk_type_t iree_uk_attention_out_type(
+    iree_uk_attention_type_t type) {
+  return iree_uk_untie_type(1, type);
+}
+
+// Number of q rows processed together by a tile function. Each k and v row
+// loaded from memory is reused across that many q rows.
+#define IREE_UK_ATTENTION_BLOCK_M 8
+// Number of k and v rows per step of the online softmax. The block of scores
+// for all q rows of a tile is 8 * 64 floats = 2 KiB.
+#define IREE_UK_ATTENTION_BLOCK_K2 64
+// Number of output columns accumulated at a time. The f32 accumulators for
+// all q rows of a tile are 8 * 128 floats = 4 KiB. Larger N are processed in
+// several passes over k and v.
+#define IREE_UK_ATTENTION_BLOCK_N 128
+
+// Loads element `i` of a q, k or v buffer of the given type, as f32. Used by
+// the generic tile function and by the scalar tails of the
+// architecture-specific ones.
+IREE_UK_ATTRIBUTE_ALWAYS_INLINE static inline float iree_uk_attention_load(
+    const void* buffer, iree_uk_index_t i, iree_uk_type_t type) {
+  switch (type) {
+    case IREE_UK_TYPE_FLOAT_16:
+      return iree_uk_f16_to_f32(((const iree_uk_uint16_t*)buffer)[i]);
+    case IREE_UK_TYPE_BFLOAT_16:
+      return iree_uk_bf16_to_f32(((const iree_uk_uint16_t*)buffer)[i]);
+    default:
+      return ((const float*)buffer)[i];
+  }
+}
+
+// Stores `value` as element `i` of an out buffer of the given type.
+IREE_UK_ATTRIBUTE_ALWAYS_INLINE static inline void iree_uk_attention_store(
+    void* buffer, iree_uk_index_t i, float value, iree_uk_type_t type) {
+  switch (type) {
+    case IREE_UK_TYPE_FLOAT_16:
+      ((iree_uk_uint16_t*)buffer)[i] = iree_uk_f32_to_f16(value);
+      break;
+    case IREE_UK_TYPE_BFLOAT_16:
+      ((iree_uk_uint16_t*)buffer)[i] = iree_uk_f32_to_bf16(value);
+      break;
+    default:
+      ((float*)buffer)[i] = value;
+      break;
+  }
+}
+
+// Function pointer type for tile functions, each processing `rows` (at most
+// IREE_UK_ATTENTION_BLOCK_M) consecutive q rows of one batch entry against
+// the whole of that entry's k and v. The row strides are taken from `params`.
+typedef void (*iree_uk_attention_tile_func_t)(
+    void* IREE_UK_RESTRICT out_rows, const void* IREE_UK_RESTRICT q_rows,
+    const void* IREE_UK_RESTRICT k, const void* IREE_UK_RESTRICT v,
+    iree_uk_index_t rows, const iree_uk_attention_params_t* params);
+
+// Tile kernel declarations. Prototype matches iree_uk_attention_tile_func_t.
+#define IREE_UK_ATTENTION_TILE_FUNC_DECL(NAME)                            \
+  void NAME(void* IREE_UK_RESTRICT out_rows,                              \
+            const void* IREE_UK_RESTRICT q_rows,                          \
+            const void* IREE_UK_RESTRICT k, const void* IREE_UK_RESTRICT v, \
+            iree_uk_index_t rows, const iree_uk_attention_params_t* params);
+
+// Returns the tile function to use for the attention op with the given params.
+iree_uk_attention_tile_func_t iree_uk_attention_select_tile_func(
+    const iree_uk_attention_params_t* params);
+
+// Architecture-specific implementation.
+iree_uk_attention_tile_func_t iree_uk_attention_select_tile_func_arch(
+    const iree_uk_attention_params_t* params);
+
+#endif  // IREE_BUILTINS_UKERNEL_ATTENTION_INTERNAL_H_
@@ -0,0 +1,135 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/attention_internal.h"
+
+IREE_UK_ATTRIBUTE_ALWAYS_INLINE static inline void
+iree_uk_attention_tile_generic(void* IREE_UK_RESTRICT out_rows,
+                               const void* IREE_UK_RESTRICT q_rows,
+                               const void* IREE_UK_RESTRICT k,
+                               const void* IREE_UK_RESTRICT v,
+                               iree_uk_index_t rows,
+                               const iree_uk_attention_params_t* params,
+                               iree_uk_type_t in_type,
+                               iree_uk_type_t out_type) {
+  iree_uk_index_t K1 = params->K1;
+  iree_uk_index_t K2 = params->K2;
+  iree_uk_index_t N = params->N;
+  bool transpose_v = params->flags & IREE_UK_FLAG_ATTENTION_TRANSPOSE_V;
+  float acc[IREE_UK_ATTENTION_BLOCK_M][IREE_UK_ATTENTION_BLOCK_N];
+  float s[IREE_UK_ATTENTION_BLOCK_M][IREE_UK_ATTENTION_BLOCK_K2];
+  float row_max[IREE_UK_ATTENTION_BLOCK_M];
+  float row_sum[IREE_UK_ATTENTION_BLOCK_M];
+  for (iree_uk_index_t n0 = 0; n0 < N; n0 += IREE_UK_ATTENTION_BLOCK_N) {
+    iree_uk_index_t nb = iree_uk_index_min(IREE_UK_ATTENTION_BLOCK_N, N - n0);
+    for (iree_uk_index_t i = 0; i < rows; ++i) {
+      row_max[i] = IREE_UK_FLOAT_LOWEST;
+      row_sum[i] = 0.f;
+      for (iree_uk_index_t n = 0; n < nb; ++n) acc[i][n] = 0.f;
+    }
+    for (iree_uk_index_t k0 = 0; k0 < K2; k0 += IREE_UK_ATTENTION_BLOCK_K2) {
+      iree_uk_index_t kb =
+          iree_uk_index_min(IREE_UK_ATTENTION_BLOCK_K2, K2 - k0);
+      for (iree_uk_index_t i = 0; i < rows; ++i) {
+        // s = scale * q . k^T for this block of k rows.
+        iree_uk_index_t q_row = i * params->q_stride1;
+        float block_max = row_max[i];
+        for (iree_uk_index_t j = 0; j < kb; ++j) {
+          iree_uk_index_t k_row = (k0 + j) * params->k_stride1;
+          float dot = 0.f;
+          for (iree_uk_index_t c = 0; c < K1; ++c) {
+            dot += iree_uk_attention_load(q_rows, q_row + c, in_type) *
+                   iree_uk_attention_load(k, k_row + c, in_type);
+          }
+          s[i][j] = params->scale * dot;
+          if (s[i][j] > block_max) block_max = s[i][j];
+        }
+        // Online softmax: rescale what was accumulated against the old max,
+        // then turn the scores into probabilities against the new one.
+        float correction = iree_uk_exp_f32(row_max[i] - block_max);
+        row_max[i] = block_max;
+        row_sum[i] *= correction;
+        for (iree_uk_index_t n = 0; n < nb; ++n) acc[i][n] *= correction;
+        for (iree_uk_index_t j = 0; j < kb; ++j) {
+          s[i][j] = iree_uk_exp_f32(s[i][j] - block_max);
+          row_sum[i] += s[i][j];
+        }
+      }
+      // acc += p . v for this block of v rows.
+      for (iree_uk_index_t i = 0; i < rows; ++i) {
+        for (iree_uk_index_t j = 0; j < kb; ++j) {
+          for (iree_uk_index_t n = 0; n < nb; ++n) {
+            iree_uk_index_t v_index =
+                transpose_v ? (n0 + n) * params->v_stride1 + k0 + j
+                            : (k0 + j) * params->v_stride1 + n0 + n;
+            acc[i][n] += s[i][j] * iree_uk_attention_load(v, v_index, in_type);
+          }
+        }
+      }
+    }
+    for (iree_uk_index_t i = 0; i < rows; ++i) {
+      float inv_sum = row_sum[i] > 0.f ? 1.f / row_sum[i] : 0.f;
+      iree_uk_index_t out_row = i * params->out_stride1;
+      for (iree_uk_index_t n = 0; n < nb; ++n) {
+        iree_uk_attention_store(out_rows, out_row + n0 + n, acc[i][n] * inv_sum,
+                                out_type);
+      }
+    }
+  }
+}
+
+static void iree_uk_attention_tile_f32f32_generic(
+    void* IREE_UK_RESTRICT out_rows, const void* IREE_UK_RESTRICT q_rows,
+    const void* IREE_UK_RESTRICT k, const void* IREE_UK_RESTRICT v,
+    iree_uk_index_t rows, const iree_uk_attention_params_t* params) {
+  iree_uk_attention_tile_generic(out_rows, q_rows, k, v, rows, params,
+                                 IREE_UK_TYPE_FLOAT_32, IREE_UK_TYPE_FLOAT_32);
+}
+
+static void iree_uk_attention_tile_f16f16_generic(
+    void* IREE_UK_RESTRICT out_rows, const void* IREE_UK_RESTRICT q_rows,
+    const void* IREE_UK_RESTRICT k, const void* IREE_UK_RESTRICT v,
+    iree_uk_index_t rows, const iree_uk_attention_params_t* params) {
+  iree_uk_attention_tile_generic(out_rows, q_rows, k, v, rows, params,
+                                 IREE_UK_TYPE_FLOAT_16, IREE_UK_TYPE_FLOAT_16);
+}
+
+static void iree_uk_attention_tile_bf16bf16_generic(
+    void* IREE_UK_RESTRICT out_rows, const void* IREE_UK_RESTRICT q_rows,
+    const void* IREE_UK_RESTRICT k, const void* IREE_UK_RESTRICT v,
+    iree_uk_index_t rows, const iree_uk_attention_params_t* params) {
+  iree_uk_attention_tile_generic(out_rows, q_rows, k, v, rows, params,
+                                 IREE_UK_TYPE_BFLOAT_16,
+                                 IREE_UK_TYPE_BFLOAT_16);
+}
+
+static iree_uk_attention_tile_func_t
+iree_uk_attention_select_tile_func_generic(
+    const iree_uk_attention_params_t* params) {
+  switch (iree_uk_attention_type(params->flags)) {
+    case iree_uk_attention_type_f32f32:
+      return iree_uk_attention_tile_f32f32_generic;
+    case iree_uk_attention_type_f16f16:
+      return iree_uk_attention_tile_f16f16_generic;
+    case iree_uk_attention_type_bf16bf16:
+      return iree_uk_attention_tile_bf16bf16_generic;
+    default:
+      // Shouldn't happen, validated earlier.
+      return 0;
+  }
+}
+
+// Select the 'tile function' that is the typically target-optimized inner loop
+// implementation.
+iree_uk_attention_tile_func_t iree_uk_attention_select_tile_func(
+    const iree_uk_attention_params_t* params) {
+  iree_uk_attention_tile_func_t arch_tile_func =
+      iree_uk_attention_select_tile_func_arch(params);
+  if (arch_tile_func) {
+    return arch_tile_func;
+  }
+  return iree_uk_attention_select_tile_func_generic(params);
+}
@@ -791,4 +791,56 @@ static inline iree_uk_uint16_t iree_uk_f32_to_bf16(float value) {
   return iree_uk_f32_to_generic_fp16(value, 8);
 }
 
+//===----------------------------------------------------------------------===//
+// Elementary functions on 32-bit floats.
+//
+// Microkernels can't depend on libm, so these are implemented here. They are
+// only meant for scalar tails and generic fallbacks; architecture-specific
+// code has vectorized versions of the same approximations in common_<arch>.h.
+//===----------------------------------------------------------------------===//
+
+static inline float iree_uk_bits_to_f32(iree_uk_uint32_t bits) {
+  float result;
+  iree_uk_memcpy(&result, &bits, sizeof result);
+  return result;
+}
+
+// Lowest finite float, a safe initial value for running maxima: unlike -inf,
+// subtracting it from itself doesn't produce a NaN.
+#define IREE_UK_FLOAT_LOWEST -3.40282347e+38f
+
+// Constants of the Cephes expf approximation: range reduction to
+// x = n * ln(2) + r with |r| <= ln(2)/2, then a degree-5 polynomial for e^r.
+#define IREE_UK_EXP_F32_HI 88.3762626647950f
+#define IREE_UK_EXP_F32_LO -88.3762626647949f
+#define IREE_UK_EXP_F32_LOG2E 1.44269504088896341f
+#define IREE_UK_EXP_F32_LN2_HI 0.693359375f
+#define IREE_UK_EXP_F32_LN2_LO -2.12194440e-4f
+#define IREE_UK_EXP_F32_P0 1.9875691500E-4f
+#define IREE_UK_EXP_F32_P1 1.3981999507E-3f
+#define IREE_UK_EXP_F32_P2 8.3334519073E-3f
+#define IREE_UK_EXP_F32_P3 4.1665795894E-2f
+#define IREE_UK_EXP_F32_P4 1.6666665459E-1f
+#define IREE_UK_EXP_F32_P5 5.0000001201E-1f
+
+// Returns e^x, within a couple of ulps for normal results. Inputs below
+// IREE_UK_EXP_F32_LO flush to zero, which is what softmax wants for -inf.
+static inline float iree_uk_exp_f32(float x) {
+  if (x < IREE_UK_EXP_F32_LO) return 0.f;
+  if (x > IREE_UK_EXP_F32_HI) x = IREE_UK_EXP_F32_HI;
+  float fn = x * IREE_UK_EXP_F32_LOG2E + 0.5f;
+  iree_uk_int32_t n = (iree_uk_int32_t)fn;
+  if ((float)n > fn) --n;  // Round towards -inf, as floorf would.
+  fn = (float)n;
+  float r = x - fn * IREE_UK_EXP_F32_LN2_HI - fn * IREE_UK_EXP_F32_LN2_LO;
+  float p = IREE_UK_EXP_F32_P0;
+  p = p * r + IREE_UK_EXP_F32_P1;
+  p = p * r + IREE_UK_EXP_F32_P2;
+  p = p * r + IREE_UK_EXP_F32_P3;
+  p = p * r + IREE_UK_EXP_F32_P4;
+  p = p * r + IREE_UK_EXP_F32_P5;
+  p = p * r * r + r + 1.f;
+  return p * iree_uk_bits_to_f32((iree_uk_uint32_t)(n + 127) << 23);
+}
+
 #endif  // IREE_BUILTINS_UKERNEL_COMMON_H_
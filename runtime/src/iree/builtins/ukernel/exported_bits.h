@@ -48,6 +48,35 @@
 // output bit flags for iree_uk_mmt4d_info
 #define IREE_UK_FLAG_MMT4D_INFO_HAVE_ARCHITECTURE_SPECIFIC_TILE_FUNCTION 0x1
 
+//===----------------------------------------------------------------------===//
+// mmt4d_dequant
+//===----------------------------------------------------------------------===//
+
+// type enum
+#define IREE_UK_FLAG_MMT4D_DEQUANT_TYPE_MASK 0xFF
+#define IREE_UK_FLAG_MMT4D_DEQUANT_TYPE_NONE 0x00
+#define IREE_UK_FLAG_MMT4D_DEQUANT_TYPE_F32U4F32 0x01
+#define IREE_UK_FLAG_MMT4D_DEQUANT_TYPE_END 0x02
+
+// bit flags
+#define IREE_UK_FLAG_MMT4D_DEQUANT_ACCUMULATE 0x100
+#define IREE_UK_FLAG_MMT4D_DEQUANT_ALLOW_GENERIC_FALLBACK_TILE_FUNCTION 0x200
+
+//===----------------------------------------------------------------------===//
+// gemv
+//===----------------------------------------------------------------------===//
+
+// type enum
+#define IREE_UK_FLAG_GEMV_TYPE_MASK 0xFF
+#define IREE_UK_FLAG_GEMV_TYPE_NONE 0x00
+#define IREE_UK_FLAG_GEMV_TYPE_F32F32F32 0x01
+#define IREE_UK_FLAG_GEMV_TYPE_F16F16F32 0x02
+#define IREE_UK_FLAG_GEMV_TYPE_BF16BF16F32 0x03
+#define IREE_UK_FLAG_GEMV_TYPE_END 0x04
+
+// bit flags
+#define IREE_UK_FLAG_GEMV_ACCUMULATE 0x100
+
 //===----------------------------------------------------------------------===//
 // pack
 //===----------------------------------------------------------------------===//
@@ -82,6 +111,32 @@
 #define IREE_UK_FLAG_UNPACK_TRANSPOSE_INNER 0x100
 #define IREE_UK_FLAG_UNPACK_TRANSPOSE_OUTER 0x200
 
+//===----------------------------------------------------------------------===//
+// softmax
+//===----------------------------------------------------------------------===//
+
+// type enum
+#define IREE_UK_FLAG_SOFTMAX_TYPE_MASK 0xFF
+#define IREE_UK_FLAG_SOFTMAX_TYPE_NONE 0x00
+#define IREE_UK_FLAG_SOFTMAX_TYPE_F32F32 0x01
+#define IREE_UK_FLAG_SOFTMAX_TYPE_END 0x02
+
+//===----------------------------------------------------------------------===//
+// attention
+//===----------------------------------------------------------------------===//
+
+// type enum
+#define IREE_UK_FLAG_ATTENTION_TYPE_MASK 0xFF
+#define IREE_UK_FLAG_ATTENTION_TYPE_NONE 0x00
+#define IREE_UK_FLAG_ATTENTION_TYPE_F32F32 0x01
+#define IREE_UK_FLAG_ATTENTION_TYPE_F16F16 0x02
+#define IREE_UK_FLAG_ATTENTION_TYPE_BF16BF16 0x03
+#define IREE_UK_FLAG_ATTENTION_TYPE_END 0x04
+
+// bit flags
+// v is given as [N][K2] instead of [K2][N].
+#define IREE_UK_FLAG_ATTENTION_TRANSPOSE_V 0x100
+
 //===----------------------------------------------------------------------===//
 // query_tile_sizes
 //===----------------------------------------------------------------------===//
@@ -4,9 +4,13 @@
 // See https://llvm.org/LICENSE.txt for license information.
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
+#include "iree/builtins/ukernel/attention_internal.h"
+#include "iree/builtins/ukernel/gemv_internal.h"
+#include "iree/builtins/ukernel/mmt4d_dequant_internal.h"
 #include "iree/builtins/ukernel/mmt4d_internal.h"
 #include "iree/builtins/ukernel/pack_internal.h"
 #include "iree/builtins/ukernel/query_tile_sizes_internal.h"
+#include "iree/builtins/ukernel/softmax_internal.h"
 #include "iree/builtins/ukernel/unpack_internal.h"
 
 iree_uk_mmt4d_tile_func_t iree_uk_mmt4d_select_tile_func_arch(
@@ -14,6 +18,16 @@ iree_uk_mmt4d_tile_func_t iree_uk_mmt4d_select_tile_func_arch(
   return 0;
 }
 
+iree_uk_mmt4d_dequant_tile_func_t iree_uk_mmt4d_dequant_select_tile_func_arch(
+    const iree_uk_mmt4d_dequant_params_t* params) {
+  return 0;
+}
+
+iree_uk_gemv_tile_func_t iree_uk_gemv_select_tile_func_arch(
+    const iree_uk_gemv_params_t* params) {
+  return 0;
+}
+
 iree_uk_pack_tile_func_t iree_uk_pack_select_tile_func_arch(
     const iree_uk_pack_params_t* params) {
   return 0;
@@ -24,6 +38,16 @@ iree_uk_unpack_tile_func_t iree_uk_unpack_select_tile_func_arch(
   return 0;
 }
 
+iree_uk_softmax_tile_func_t iree_uk_softmax_select_tile_func_arch(
+    const iree_uk_softmax_params_t* params) {
+  return 0;
+}
+
+iree_uk_attention_tile_func_t iree_uk_attention_select_tile_func_arch(
+    const iree_uk_attention_params_t* params) {
+  return 0;
+}
+
 bool iree_uk_query_matmul_tile_sizes_arch(
     const iree_uk_query_tile_sizes_2d_params_t* params,
     iree_uk_matmul_tile_sizes_t* out_matmul_tile_sizes) {
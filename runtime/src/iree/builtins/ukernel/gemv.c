@@ -0,0 +1,99 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/gemv.h"
+
+#include "iree/builtins/ukernel/exported_bits.h"
+#include "iree/builtins/ukernel/gemv_internal.h"
+
+static void iree_uk_gemv_validate(const iree_uk_gemv_params_t* params) {
+#ifdef IREE_UK_ENABLE_ASSERTS
+  const iree_uk_uint32_t allflags =
+      IREE_UK_FLAG_GEMV_TYPE_MASK | IREE_UK_FLAG_GEMV_ACCUMULATE;
+  IREE_UK_ASSERT(!(params->flags & ~allflags));
+  iree_uk_uint32_t flags_type = params->flags & IREE_UK_FLAG_GEMV_TYPE_MASK;
+  IREE_UK_ASSERT(flags_type != IREE_UK_FLAG_GEMV_TYPE_NONE);
+  IREE_UK_ASSERT(flags_type < IREE_UK_FLAG_GEMV_TYPE_END);
+  // Same range requirements as mmt4d.
+  IREE_UK_ASSERT(IREE_UK_VALUE_IN_UNSIGNED_INT_RANGE(params->N, 31));
+  IREE_UK_ASSERT(IREE_UK_VALUE_IN_UNSIGNED_INT_RANGE(params->K, 31));
+  IREE_UK_ASSERT(IREE_UK_VALUE_IN_UNSIGNED_INT_RANGE(params->N0, 15));
+  IREE_UK_ASSERT(IREE_UK_VALUE_IN_UNSIGNED_INT_RANGE(params->K0, 15));
+#endif  // IREE_UK_ENABLE_ASSERTS
+}
+
+// Returns true if already done.
+static bool iree_uk_gemv_early(const iree_uk_gemv_params_t* params) {
+  return params->N == 0 ||
+         (params->K == 0 && params->flags & IREE_UK_FLAG_GEMV_ACCUMULATE);
+}
+
+static void iree_uk_gemv_using_tile_func(const iree_uk_gemv_params_t* params,
+                                         iree_uk_gemv_tile_func_t tile_func) {
+  const iree_uk_int32_t N = params->N;
+  iree_uk_gemv_type_t type = iree_uk_gemv_type(params->flags);
+  const iree_uk_int16_t lhs_elem_size_log2 =
+      iree_uk_type_size_log2(iree_uk_gemv_lhs_type(type));
+  const iree_uk_int16_t rhs_elem_size_log2 =
+      iree_uk_type_size_log2(iree_uk_gemv_rhs_type(type));
+  const iree_uk_int16_t out_elem_size_log2 =
+      iree_uk_type_size_log2(iree_uk_gemv_out_type(type));
+  const char* lhs_vector = (const char*)params->lhs_buffer +
+                           (params->lhs_offset << lhs_elem_size_log2);
+  const char* rhs_panel = (const char*)params->rhs_buffer +
+                          (params->rhs_offset << rhs_elem_size_log2);
+  char* out_tile =
+      (char*)params->out_buffer + (params->out_offset << out_elem_size_log2);
+  iree_uk_index_t rhs_panel_stride = params->rhs_stride0 << rhs_elem_size_log2;
+  iree_uk_index_t out_tile_stride = params->out_stride0 << out_elem_size_log2;
+  // The LHS vector is reused for every group of panels, so it stays in cache
+  // once the first group has streamed it in. The RHS is only read once.
+  IREE_UK_PREFETCH_RO(lhs_vector, IREE_UK_PREFETCH_LOCALITY_L1);
+  for (iree_uk_int32_t j = 0; j < N; j += IREE_UK_GEMV_MAX_PANELS) {
+    iree_uk_int32_t panel_count =
+        iree_uk_index_min(IREE_UK_GEMV_MAX_PANELS, N - j);
+    tile_func(out_tile, lhs_vector, rhs_panel, panel_count, params);
+    out_tile += IREE_UK_GEMV_MAX_PANELS * out_tile_stride;
+    rhs_panel += IREE_UK_GEMV_MAX_PANELS * rhs_panel_stride;
+  }
+}
+
+void iree_uk_gemv_p(const iree_uk_gemv_params_t* params) {
+  iree_uk_gemv_validate(params);
+
+  if (iree_uk_gemv_early(params)) return;
+
+  iree_uk_gemv_tile_func_t tile_func =
+      iree_uk_gemv_select_tile_func_arch(params);
+  if (!tile_func) tile_func = iree_uk_gemv_select_tile_func_generic(params);
+
+  iree_uk_gemv_using_tile_func(params, tile_func);
+}
+
+IREE_UK_EXPORT void iree_uk_gemv(
+    const void* lhs_buffer, iree_uk_index_t lhs_offset,
+    iree_uk_index_t lhs_stride0, const void* rhs_buffer,
+    iree_uk_index_t rhs_offset, iree_uk_index_t rhs_stride0, void* out_buffer,
+    iree_uk_index_t out_offset, iree_uk_index_t out_stride0, iree_uk_index_t N,
+    iree_uk_index_t K, iree_uk_int32_t N0, iree_uk_int32_t K0,
+    iree_uk_uint32_t flags, const iree_uk_uint64_t* cpu_data) {
+  iree_uk_gemv_params_t params = {.lhs_buffer = lhs_buffer,
+                                  .lhs_offset = lhs_offset,
+                                  .lhs_stride0 = lhs_stride0,
+                                  .rhs_buffer = rhs_buffer,
+                                  .rhs_offset = rhs_offset,
+                                  .rhs_stride0 = rhs_stride0,
+                                  .out_buffer = out_buffer,
+                                  .out_offset = out_offset,
+                                  .out_stride0 = out_stride0,
+                                  .N = N,
+                                  .K = K,
+                                  .N0 = N0,
+                                  .K0 = K0,
+                                  .flags = flags,
+                                  .cpu_data = cpu_data};
+  iree_uk_gemv_p(&params);
+}
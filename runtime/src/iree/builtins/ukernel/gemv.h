@@ -0,0 +1,27 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_BUILTINS_UKERNEL_GEMV_H_
+#define IREE_BUILTINS_UKERNEL_GEMV_H_
+
+#include "iree/builtins/ukernel/common.h"
+
+// `gemv` microkernel: the M = 1 case of `mmt4d`, where the LHS and the output
+// are plain vectors instead of packed matrices. The RHS has the same packed
+// [N][K][N0][K0] layout as for `mmt4d`, so that a RHS packed for `mmt4d` can
+// be used as is. The LHS is viewed as [K][K0] and the output as [N][N0], the
+// outer dimension having strides `lhs_stride0` and `out_stride0`. As the LHS
+// has no M0 dimension, it is the unpacked vector itself when K0 == 1, and
+// likewise for the output.
+IREE_UK_EXPORT void iree_uk_gemv(
+    const void* lhs_buffer, iree_uk_index_t lhs_offset,
+    iree_uk_index_t lhs_stride0, const void* rhs_buffer,
+    iree_uk_index_t rhs_offset, iree_uk_index_t rhs_stride0, void* out_buffer,
+    iree_uk_index_t out_offset, iree_uk_index_t out_stride0, iree_uk_index_t N,
+    iree_uk_index_t K, iree_uk_int32_t N0, iree_uk_int32_t K0,
+    iree_uk_uint32_t flags, const iree_uk_uint64_t* cpu_data);
+
+#endif  // IREE_BUILTINS_UKERNEL_GEMV_H_
@@ -0,0 +1,109 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_BUILTINS_UKERNEL_GEMV_INTERNAL_H_
+#define IREE_BUILTINS_UKERNEL_GEMV_INTERNAL_H_
+
+#include "iree/builtins/ukernel/gemv.h"
+
+// While the iree_uk_gemv public entry point takes separate parameters,
+// internally the implementation functions pass parameters as this struct.
+typedef struct iree_uk_gemv_params_t {
+  const void* lhs_buffer;
+  iree_uk_index_t lhs_offset;
+  iree_uk_index_t lhs_stride0;
+  const void* rhs_buffer;
+  iree_uk_index_t rhs_offset;
+  iree_uk_index_t rhs_stride0;
+  void* out_buffer;
+  iree_uk_index_t out_offset;
+  iree_uk_index_t out_stride0;
+  iree_uk_index_t N;
+  iree_uk_index_t K;
+  iree_uk_int32_t N0;
+  iree_uk_int32_t K0;
+  iree_uk_uint32_t flags;
+  const iree_uk_uint64_t* cpu_data;
+} iree_uk_gemv_params_t;
+
+// Same as the iree_uk_gemv public entry point, but taking the struct.
+void iree_uk_gemv_p(const iree_uk_gemv_params_t* params);
+
+typedef enum iree_uk_gemv_type_t {
+  iree_uk_gemv_type_f32f32f32 =
+      IREE_UK_TIE_3_TYPES_LITERAL(FLOAT_32, FLOAT_32, FLOAT_32),
+  iree_uk_gemv_type_f16f16f32 =
+      IREE_UK_TIE_3_TYPES_LITERAL(FLOAT_16, FLOAT_16, FLOAT_32),
+  iree_uk_gemv_type_bf16bf16f32 =
+      IREE_UK_TIE_3_TYPES_LITERAL(BFLOAT_16, BFLOAT_16, FLOAT_32),
+} iree_uk_gemv_type_t;
+
+static inline iree_uk_gemv_type_t iree_uk_gemv_type(iree_uk_uint32_t flags) {
+  switch (flags & IREE_UK_FLAG_GEMV_TYPE_MASK) {
+    case IREE_UK_FLAG_GEMV_TYPE_F32F32F32:
+      return iree_uk_gemv_type_f32f32f32;
+    case IREE_UK_FLAG_GEMV_TYPE_F16F16F32:
+      return iree_uk_gemv_type_f16f16f32;
+    case IREE_UK_FLAG_GEMV_TYPE_BF16BF16F32:
+      return iree_uk_gemv_type_bf16bf16f32;
+    default:
+#if defined(IREE_UK_COMPILER_CLANG) && defined(IREE_UK_ARCH_RISCV_32)
+      // See the comment in iree_uk_mmt4d_type.
+      __builtin_unreachable();
+#endif
+      // Shouldn't happen, validated earlier.
+      return (iree_uk_gemv_type_t)0;
+  }
+}
+
+static inline iree_uk_type_t iree_uk_gemv_lhs_type(iree_uk_gemv_type_t type) {
+  return iree_uk_untie_type(0, type);
+}
+
+static inline iree_uk_type_t iree_uk_gemv_rhs_type(iree_uk_gemv_type_t type) {
+  return iree_uk_untie_type(1, type);
+}
+
+static inline iree_uk_type_t iree_uk_gemv_out_type(iree_uk_gemv_type_t type) {
+  return iree_uk_untie_type(2, type);
+}
+
+// Maximum number of RHS panels that a tile function consumes at once. Working
+// on several panels gives the tile functions independent accumulators to hide
+// the FMA latency, and several memory streams to keep in flight, which matters
+// more than the arithmetic here as each RHS element is only used once.
+#define IREE_UK_GEMV_MAX_PANELS 4
+
+// Distance in bytes ahead of the current position in each RHS panel at which
+// the tile functions prefetch. The prefetches target L1 even though the RHS is
+// only read once: the lines are consumed a few iterations later, and a
+// non-temporal hint lets them be evicted before that.
+#define IREE_UK_GEMV_PREFETCH_DISTANCE 1024
+
+// Function pointer type for tile functions computing `panel_count` (at most
+// IREE_UK_GEMV_MAX_PANELS) consecutive N0-tiles of the output vector, from
+// the whole LHS vector and the as many consecutive RHS panels.
+typedef void (*iree_uk_gemv_tile_func_t)(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_vector,
+    const void* IREE_UK_RESTRICT rhs_panels, iree_uk_int32_t panel_count,
+    const iree_uk_gemv_params_t* params);
+
+// Tile kernel declarations. Prototype matches iree_uk_gemv_tile_func_t.
+#define IREE_UK_GEMV_TILE_FUNC_DECL(NAME)                                 \
+  void NAME(void* IREE_UK_RESTRICT out_tile,                              \
+            const void* IREE_UK_RESTRICT lhs_vector,                      \
+            const void* IREE_UK_RESTRICT rhs_panels,                      \
+            iree_uk_int32_t panel_count, const iree_uk_gemv_params_t* params);
+
+// Architecture-specific implementation, or generic fallback returning null.
+iree_uk_gemv_tile_func_t iree_uk_gemv_select_tile_func_arch(
+    const iree_uk_gemv_params_t* params);
+
+// Generic fallback.
+iree_uk_gemv_tile_func_t iree_uk_gemv_select_tile_func_generic(
+    const iree_uk_gemv_params_t* params);
+
+#endif  // IREE_BUILTINS_UKERNEL_GEMV_INTERNAL_H_
@@ -0,0 +1,90 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/gemv_internal.h"
+
+// Loads the `index`-th element of an input buffer of the given type as f32.
+static inline float iree_uk_gemv_load_f32(const void* buffer,
+                                          iree_uk_type_t type,
+                                          iree_uk_index_t index) {
+  switch (type) {
+    case IREE_UK_TYPE_FLOAT_16:
+      return iree_uk_f16_to_f32(((const iree_uk_uint16_t*)buffer)[index]);
+    case IREE_UK_TYPE_BFLOAT_16:
+      return iree_uk_bf16_to_f32(((const iree_uk_uint16_t*)buffer)[index]);
+    default:
+      return ((const float*)buffer)[index];
+  }
+}
+
+// Generic implementation of the gemv tile, for all types as they all
+// accumulate in f32. The input type is known at compile time in each of the
+// wrappers below, so the switch in iree_uk_gemv_load_f32 folds away.
+static inline void iree_uk_gemv_tile_generic(
+    float* out_tile, const void* lhs_vector, const void* rhs_panels,
+    iree_uk_int32_t panel_count, iree_uk_type_t in_type,
+    const iree_uk_gemv_params_t* params) {
+  iree_uk_int16_t N0 = params->N0;
+  iree_uk_int16_t K0 = params->K0;
+  for (iree_uk_int32_t p = 0; p < panel_count; ++p) {
+    float* out_ptr = out_tile + p * params->out_stride0;
+    iree_uk_index_t rhs_panel_index = p * params->rhs_stride0;
+    for (iree_uk_int32_t n0 = 0; n0 < N0; ++n0) {
+      float acc = (params->flags & IREE_UK_FLAG_GEMV_ACCUMULATE) ? out_ptr[n0]
+                                                                 : 0.f;
+      for (iree_uk_index_t k = 0; k < params->K; ++k) {
+        for (iree_uk_int32_t k0 = 0; k0 < K0; ++k0) {
+          float lhs = iree_uk_gemv_load_f32(lhs_vector, in_type,
+                                            k * params->lhs_stride0 + k0);
+          float rhs = iree_uk_gemv_load_f32(
+              rhs_panels, in_type,
+              rhs_panel_index + k * N0 * K0 + n0 * K0 + k0);
+          acc += lhs * rhs;
+        }
+      }
+      out_ptr[n0] = acc;
+    }
+  }
+}
+
+static void iree_uk_gemv_tile_f32f32f32_generic(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_vector,
+    const void* IREE_UK_RESTRICT rhs_panels, iree_uk_int32_t panel_count,
+    const iree_uk_gemv_params_t* params) {
+  iree_uk_gemv_tile_generic(out_tile, lhs_vector, rhs_panels, panel_count,
+                            IREE_UK_TYPE_FLOAT_32, params);
+}
+
+static void iree_uk_gemv_tile_f16f16f32_generic(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_vector,
+    const void* IREE_UK_RESTRICT rhs_panels, iree_uk_int32_t panel_count,
+    const iree_uk_gemv_params_t* params) {
+  iree_uk_gemv_tile_generic(out_tile, lhs_vector, rhs_panels, panel_count,
+                            IREE_UK_TYPE_FLOAT_16, params);
+}
+
+static void iree_uk_gemv_tile_bf16bf16f32_generic(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_vector,
+    const void* IREE_UK_RESTRICT rhs_panels, iree_uk_int32_t panel_count,
+    const iree_uk_gemv_params_t* params) {
+  iree_uk_gemv_tile_generic(out_tile, lhs_vector, rhs_panels, panel_count,
+                            IREE_UK_TYPE_BFLOAT_16, params);
+}
+
+iree_uk_gemv_tile_func_t iree_uk_gemv_select_tile_func_generic(
+    const iree_uk_gemv_params_t* params) {
+  switch (iree_uk_gemv_type(params->flags)) {
+    case iree_uk_gemv_type_f32f32f32:
+      return iree_uk_gemv_tile_f32f32f32_generic;
+    case iree_uk_gemv_type_f16f16f32:
+      return iree_uk_gemv_tile_f16f16f32_generic;
+    case iree_uk_gemv_type_bf16bf16f32:
+      return iree_uk_gemv_tile_bf16bf16f32_generic;
+    default:
+      // Shouldn't happen, validated earlier.
+      return 0;
+  }
+}
@@ -0,0 +1,46 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_BUILTINS_UKERNEL_MMT4D_DEQUANT_H_
+#define IREE_BUILTINS_UKERNEL_MMT4D_DEQUANT_H_
+
+#include "iree/builtins/ukernel/common.h"
+
+// `mmt4d_dequant` microkernel. Same as `mmt4d`, but the RHS holds quantized
+// values that are dequantized inside the tile loop as
+//
+//   rhs_dequantized = (rhs - zero_point) * scale
+//
+// where each group of `group_size` consecutive elements along the reduction
+// dimension of each RHS row has its own scale and zero point. `group_size` is
+// counted in elements of the unpacked reduction dimension (i.e. K * K0) and
+// must be a multiple of K0 dividing K * K0.
+//
+// The scales and zero points are laid out as [N][K * K0 / group_size][N0], the
+// outer dimension having strides `scales_stride0` and `zero_points_stride0`.
+// Unpacked row-major matrices are the special case M0 = N0 = 1 where the
+// scales and zero points are just [N][K * K0 / group_size].
+IREE_UK_EXPORT void iree_uk_mmt4d_dequant(
+    const void* lhs_buffer, iree_uk_index_t lhs_offset,
+    iree_uk_index_t lhs_stride0, const void* rhs_buffer,
+    iree_uk_index_t rhs_offset, iree_uk_index_t rhs_stride0,
+    const void* scales_buffer, iree_uk_index_t scales_offset,
+    iree_uk_index_t scales_stride0, const void* zero_points_buffer,
+    iree_uk_index_t zero_points_offset, iree_uk_index_t zero_points_stride0,
+    void* out_buffer, iree_uk_index_t out_offset, iree_uk_index_t out_stride0,
+    iree_uk_index_t M, iree_uk_index_t N, iree_uk_index_t K,
+    iree_uk_int32_t M0, iree_uk_int32_t N0, iree_uk_int32_t K0,
+    iree_uk_int32_t group_size, iree_uk_uint32_t flags,
+    const iree_uk_uint64_t* cpu_data);
+
+// Returns a bit-field of information about how a mmt4d_dequant with the given
+// parameters would run. Uses the IREE_UK_FLAG_MMT4D_INFO_* output bits.
+IREE_UK_EXPORT iree_uk_uint32_t iree_uk_mmt4d_dequant_info(
+    iree_uk_int32_t M0, iree_uk_int32_t N0, iree_uk_int32_t K0,
+    iree_uk_int32_t group_size, iree_uk_uint32_t flags,
+    const iree_uk_uint64_t* cpu_data);
+
+#endif  // IREE_BUILTINS_UKERNEL_MMT4D_DEQUANT_H_
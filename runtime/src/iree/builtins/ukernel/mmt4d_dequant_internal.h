@@ -0,0 +1,117 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_BUILTINS_UKERNEL_MMT4D_DEQUANT_INTERNAL_H_
+#define IREE_BUILTINS_UKERNEL_MMT4D_DEQUANT_INTERNAL_H_
+
+#include "iree/builtins/ukernel/mmt4d_dequant.h"
+
+// While the iree_uk_mmt4d_dequant public entry point takes separate
+// parameters, internally the implementation functions pass parameters as this
+// struct.
+typedef struct iree_uk_mmt4d_dequant_params_t {
+  const void* lhs_buffer;
+  iree_uk_index_t lhs_offset;
+  iree_uk_index_t lhs_stride0;
+  const void* rhs_buffer;
+  iree_uk_index_t rhs_offset;
+  iree_uk_index_t rhs_stride0;
+  const void* scales_buffer;
+  iree_uk_index_t scales_offset;
+  iree_uk_index_t scales_stride0;
+  const void* zero_points_buffer;
+  iree_uk_index_t zero_points_offset;
+  iree_uk_index_t zero_points_stride0;
+  void* out_buffer;
+  iree_uk_index_t out_offset;
+  iree_uk_index_t out_stride0;
+  iree_uk_index_t M;
+  iree_uk_index_t N;
+  iree_uk_index_t K;
+  iree_uk_int32_t M0;
+  iree_uk_int32_t N0;
+  iree_uk_int32_t K0;
+  iree_uk_int32_t group_size;
+  iree_uk_uint32_t flags;
+  const iree_uk_uint64_t* cpu_data;
+} iree_uk_mmt4d_dequant_params_t;
+
+// Same as the iree_uk_mmt4d_dequant public entry point, but taking the struct.
+void iree_uk_mmt4d_dequant_p(const iree_uk_mmt4d_dequant_params_t* params);
+
+// Same as the iree_uk_mmt4d_dequant_info public entry point, but taking the
+// struct. Only the struct fields corresponding to iree_uk_mmt4d_dequant_info
+// parameters are used.
+iree_uk_uint32_t iree_uk_mmt4d_dequant_info_p(
+    const iree_uk_mmt4d_dequant_params_t* params);
+
+// The scales and zero points share the LHS (= output) element type, so only
+// the LHS, RHS and output types are tied here.
+typedef enum iree_uk_mmt4d_dequant_type_t {
+  iree_uk_mmt4d_dequant_type_f32u4f32 =
+      IREE_UK_TIE_3_TYPES_LITERAL(FLOAT_32, UINT_4, FLOAT_32),
+} iree_uk_mmt4d_dequant_type_t;
+
+static inline iree_uk_mmt4d_dequant_type_t iree_uk_mmt4d_dequant_type(
+    iree_uk_uint32_t flags) {
+  switch (flags & IREE_UK_FLAG_MMT4D_DEQUANT_TYPE_MASK) {
+    case IREE_UK_FLAG_MMT4D_DEQUANT_TYPE_F32U4F32:
+      return iree_uk_mmt4d_dequant_type_f32u4f32;
+    default:
+#if defined(IREE_UK_COMPILER_CLANG) && defined(IREE_UK_ARCH_RISCV_32)
+      // See the comment in iree_uk_mmt4d_type.
+      __builtin_unreachable();
+#endif
+      // Shouldn't happen, validated earlier.
+      return (iree_uk_mmt4d_dequant_type_t)0;
+  }
+}
+
+static inline iree_uk_type_t iree_uk_mmt4d_dequant_lhs_type(
+    iree_uk_mmt4d_dequant_type_t type) {
+  return iree_uk_untie_type(0, type);
+}
+
+static inline iree_uk_type_t iree_uk_mmt4d_dequant_rhs_type(
+    iree_uk_mmt4d_dequant_type_t type) {
+  return iree_uk_untie_type(1, type);
+}
+
+static inline iree_uk_type_t iree_uk_mmt4d_dequant_out_type(
+    iree_uk_mmt4d_dequant_type_t type) {
+  return iree_uk_untie_type(2, type);
+}
+
+// Function pointer type for tile functions computing one M0xN0 tile of the
+// output matrix. The scales and zero points panels point to the
+// [K * K0 / group_size][N0] slices for the RHS panel being consumed.
+typedef void (*iree_uk_mmt4d_dequant_tile_func_t)(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const void* IREE_UK_RESTRICT scales_panel,
+    const void* IREE_UK_RESTRICT zero_points_panel,
+    const iree_uk_mmt4d_dequant_params_t* params);
+
+// Tile kernel declarations. Prototype matches
+// iree_uk_mmt4d_dequant_tile_func_t.
+#define IREE_UK_MMT4D_DEQUANT_TILE_FUNC_DECL(NAME)          \
+  void NAME(void* IREE_UK_RESTRICT out_tile,                \
+            const void* IREE_UK_RESTRICT lhs_panel,         \
+            const void* IREE_UK_RESTRICT rhs_panel,         \
+            const void* IREE_UK_RESTRICT scales_panel,      \
+            const void* IREE_UK_RESTRICT zero_points_panel, \
+            const iree_uk_mmt4d_dequant_params_t* params);
+
+// Architecture-specific implementation, or generic fallback returning null.
+iree_uk_mmt4d_dequant_tile_func_t iree_uk_mmt4d_dequant_select_tile_func_arch(
+    const iree_uk_mmt4d_dequant_params_t* params);
+
+// Generic fallback.
+iree_uk_mmt4d_dequant_tile_func_t
+iree_uk_mmt4d_dequant_select_tile_func_generic(
+    const iree_uk_mmt4d_dequant_params_t* params);
+
+#endif  // IREE_BUILTINS_UKERNEL_MMT4D_DEQUANT_INTERNAL_H_
@@ -0,0 +1,65 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/exported_bits.h"
+#include "iree/builtins/ukernel/mmt4d_dequant_internal.h"
+
+// Generic implementation of dequantizing matmul tile, f32*u4->f32 case.
+// Within each group, (rhs - zero_point) is accumulated against the LHS and the
+// scale is only applied once per group.
+static void iree_uk_mmt4d_dequant_tile_f32u4f32_generic(
+    void* out_tile_untyped, const void* lhs_panel_untyped,
+    const void* rhs_panel_untyped, const void* scales_panel_untyped,
+    const void* zero_points_panel_untyped,
+    const iree_uk_mmt4d_dequant_params_t* params) {
+  float* out_tile = out_tile_untyped;
+  const float* lhs_panel = lhs_panel_untyped;
+  const iree_uk_uint8_t* rhs_panel = rhs_panel_untyped;
+  const float* scales_panel = scales_panel_untyped;
+  const float* zero_points_panel = zero_points_panel_untyped;
+  iree_uk_int16_t M0 = params->M0;
+  iree_uk_int16_t N0 = params->N0;
+  iree_uk_int16_t K0 = params->K0;
+  iree_uk_index_t group_tiles = params->group_size / K0;
+  iree_uk_index_t group_count = params->K / group_tiles;
+  for (iree_uk_index_t i0 = 0; i0 < M0; ++i0) {
+    for (iree_uk_index_t j0 = 0; j0 < N0; ++j0) {
+      float acc = (params->flags & IREE_UK_FLAG_MMT4D_DEQUANT_ACCUMULATE)
+                      ? out_tile[i0 * N0 + j0]
+                      : 0.f;
+      for (iree_uk_index_t g = 0; g < group_count; ++g) {
+        float scale = scales_panel[g * N0 + j0];
+        float zero_point = zero_points_panel[g * N0 + j0];
+        float group_acc = 0.f;
+        for (iree_uk_index_t k = g * group_tiles; k < (g + 1) * group_tiles;
+             ++k) {
+          for (iree_uk_index_t k0 = 0; k0 < K0; ++k0) {
+            float lhs = lhs_panel[k * M0 * K0 + i0 * K0 + k0];
+            iree_uk_index_t rhs_index = k * N0 * K0 + j0 * K0 + k0;
+            iree_uk_uint8_t rhs_byte = rhs_panel[rhs_index >> 1];
+            iree_uk_uint8_t rhs_u4 =
+                (rhs_index & 1) ? (rhs_byte >> 4) : (rhs_byte & 0x0F);
+            group_acc += lhs * ((float)rhs_u4 - zero_point);
+          }
+        }
+        acc += group_acc * scale;
+      }
+      out_tile[i0 * N0 + j0] = acc;
+    }
+  }
+}
+
+iree_uk_mmt4d_dequant_tile_func_t
+iree_uk_mmt4d_dequant_select_tile_func_generic(
+    const iree_uk_mmt4d_dequant_params_t* params) {
+  switch (iree_uk_mmt4d_dequant_type(params->flags)) {
+    case iree_uk_mmt4d_dequant_type_f32u4f32:
+      return iree_uk_mmt4d_dequant_tile_f32u4f32_generic;
+    default:
+      // Shouldn't happen, validated earlier.
+      return 0;
+  }
+}
@@ -0,0 +1,275 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/pack_mmt4d.h"
+
+#include "iree/builtins/ukernel/exported_bits.h"
+#include "iree/builtins/ukernel/mmt4d_internal.h"
+#include "iree/builtins/ukernel/pack_internal.h"
+#include "iree/builtins/ukernel/pack_mmt4d_internal.h"
+
+static void iree_uk_pack_mmt4d_validate(
+    const iree_uk_pack_mmt4d_params_t* params) {
+#ifdef IREE_UK_ENABLE_ASSERTS
+  const iree_uk_uint32_t allflags =
+      IREE_UK_FLAG_MMT4D_TYPE_MASK | IREE_UK_FLAG_MMT4D_ACCUMULATE |
+      IREE_UK_FLAG_MMT4D_SKIP_INTERMEDIATE_ROUNDINGS |
+      IREE_UK_FLAG_MMT4D_ALLOW_GENERIC_FALLBACK_TILE_FUNCTION;
+  IREE_UK_ASSERT(!(params->flags & ~allflags));
+  iree_uk_uint32_t flags_type = params->flags & IREE_UK_FLAG_MMT4D_TYPE_MASK;
+  IREE_UK_ASSERT(flags_type != IREE_UK_FLAG_MMT4D_TYPE_NONE);
+  IREE_UK_ASSERT(flags_type < IREE_UK_FLAG_MMT4D_TYPE_END);
+  // Same range requirements as mmt4d.
+  IREE_UK_ASSERT(IREE_UK_VALUE_IN_UNSIGNED_INT_RANGE(params->M, 31));
+  IREE_UK_ASSERT(IREE_UK_VALUE_IN_UNSIGNED_INT_RANGE(params->N, 31));
+  IREE_UK_ASSERT(IREE_UK_VALUE_IN_UNSIGNED_INT_RANGE(params->K, 31));
+  IREE_UK_ASSERT(IREE_UK_VALUE_IN_UNSIGNED_INT_RANGE(params->M0, 15));
+  IREE_UK_ASSERT(IREE_UK_VALUE_IN_UNSIGNED_INT_RANGE(params->N0, 15));
+  IREE_UK_ASSERT(IREE_UK_VALUE_IN_UNSIGNED_INT_RANGE(params->K0, 15));
+  // The unpacked LHS is addressed in whole bytes.
+  iree_uk_mmt4d_type_t mmt4d_type = iree_uk_mmt4d_type(params->flags);
+  iree_uk_type_t lhs_type = iree_uk_mmt4d_lhs_type(mmt4d_type);
+  IREE_UK_ASSERT(iree_uk_type_bit_count(lhs_type) >= 8);
+  // At least one tile must fit in the LHS panel buffer.
+  IREE_UK_ASSERT(params->M0 * params->K0 * iree_uk_type_size(lhs_type) <=
+                 IREE_UK_PACK_MMT4D_LHS_PANEL_BUFFER_SIZE);
+  // Padding must not exceed the inner tile sizes, as for pack.
+  IREE_UK_ASSERT(params->lhs_stride0 >= params->lhs_size1);
+  IREE_UK_ASSERT(params->lhs_size0 >= 0 &&
+                 params->lhs_size0 <= params->M * params->M0 &&
+                 params->lhs_size0 > (params->M - 1) * params->M0);
+  IREE_UK_ASSERT(params->lhs_size1 >= 0 &&
+                 params->lhs_size1 <= params->K * params->K0 &&
+                 params->lhs_size1 > (params->K - 1) * params->K0);
+#endif  // IREE_UK_ENABLE_ASSERTS
+}
+
+// Returns true if already done.
+static bool iree_uk_pack_mmt4d_early(
+    const iree_uk_pack_mmt4d_params_t* params) {
+  return params->M == 0 || params->N == 0 ||
+         (params->K == 0 && params->flags & IREE_UK_FLAG_MMT4D_ACCUMULATE);
+}
+
+// Copies `count` chunks of `size` bytes, contiguous in `src`, to `dst` with a
+// stride of `dst_stride` bytes. The common sizes are special-cased so that the
+// copies become single loads and stores.
+static void iree_uk_pack_mmt4d_scatter(char* IREE_UK_RESTRICT dst,
+                                       const char* IREE_UK_RESTRICT src,
+                                       iree_uk_index_t count,
+                                       iree_uk_index_t dst_stride,
+                                       iree_uk_index_t size) {
+#define IREE_UK_PACK_MMT4D_SCATTER_CASE(SIZE)                     \
+  case SIZE:                                                      \
+    for (iree_uk_index_t i = 0; i < count; ++i) {                 \
+      iree_uk_memcpy(dst + i * dst_stride, src + i * SIZE, SIZE); \
+    }                                                             \
+    return;
+  switch (size) {
+    IREE_UK_PACK_MMT4D_SCATTER_CASE(1)
+    IREE_UK_PACK_MMT4D_SCATTER_CASE(2)
+    IREE_UK_PACK_MMT4D_SCATTER_CASE(4)
+    IREE_UK_PACK_MMT4D_SCATTER_CASE(8)
+    IREE_UK_PACK_MMT4D_SCATTER_CASE(16)
+    default:
+      for (iree_uk_index_t i = 0; i < count; ++i) {
+        iree_uk_memcpy(dst + i * dst_stride, src + i * size, size);
+      }
+  }
+#undef IREE_UK_PACK_MMT4D_SCATTER_CASE
+}
+
+// Packs `rows` (at most M0) rows of the LHS, each having `cols` readable
+// elements starting at `src`, into a [K1][M0][K0] panel in `dst`. Anything past
+// `rows` or `cols` is zero padding. Whole tiles of full panels go through the
+// pack ukernel's tile function, which is vectorized where the scatter is not.
+static void iree_uk_pack_mmt4d_pack_lhs_panel(
+    iree_uk_pack_tile_func_t pack_tile_func, char* IREE_UK_RESTRICT dst,
+    const char* IREE_UK_RESTRICT src, iree_uk_index_t src_stride,
+    iree_uk_index_t rows, iree_uk_index_t cols, iree_uk_index_t K1,
+    iree_uk_int16_t M0, iree_uk_int16_t K0, iree_uk_index_t elem_size) {
+  iree_uk_index_t tile_row_size = K0 * elem_size;
+  iree_uk_index_t tile_size = M0 * tile_row_size;
+  iree_uk_index_t full_tiles = iree_uk_index_min(K1, cols / K0);
+  iree_uk_index_t partial_cols =
+      full_tiles < K1 ? cols - full_tiles * K0 : 0;
+  if (rows < M0) {
+    iree_uk_memset(dst, 0, K1 * tile_size);
+  } else if (full_tiles < K1) {
+    iree_uk_memset(dst + full_tiles * tile_size, 0,
+                   (K1 - full_tiles) * tile_size);
+  }
+  if (rows == M0 && full_tiles > 0) {
+    pack_tile_func(dst, src, full_tiles, M0 * K0, src_stride / elem_size,
+                   elem_size, M0, K0);
+  } else {
+    for (iree_uk_index_t m0 = 0; m0 < rows; ++m0) {
+      iree_uk_pack_mmt4d_scatter(dst + m0 * tile_row_size,
+                                 src + m0 * src_stride, full_tiles, tile_size,
+                                 tile_row_size);
+    }
+  }
+  if (partial_cols) {
+    for (iree_uk_index_t m0 = 0; m0 < rows; ++m0) {
+      iree_uk_memcpy(dst + full_tiles * tile_size + m0 * tile_row_size,
+                     src + m0 * src_stride + full_tiles * tile_row_size,
+                     partial_cols * elem_size);
+    }
+  }
+}
+
+// Same outer loops as iree_uk_mmt4d_using_tile_func, except that each LHS row
+// panel is first packed into `lhs_panel_buf`, in chunks along K that fit in
+// it, and the RHS panels are consumed chunk by chunk accordingly. The tile
+// functions get a copy of the params with K set to the chunk size, and with
+// accumulation enabled after the first chunk.
+static void iree_uk_pack_mmt4d_using_tile_func(
+    const iree_uk_pack_mmt4d_params_t* params,
+    iree_uk_mmt4d_params_t* mmt4d_params, iree_uk_mmt4d_tile_func_t tile_func,
+    iree_uk_pack_tile_func_t pack_tile_func) {
+  IREE_UK_ATTRIBUTE_ALIGNED(64)
+  char lhs_panel_buf[IREE_UK_PACK_MMT4D_LHS_PANEL_BUFFER_SIZE];
+  const iree_uk_int32_t M = params->M;
+  const iree_uk_int32_t N = params->N;
+  const iree_uk_int32_t K = params->K;
+  const iree_uk_int16_t M0 = params->M0;
+  const iree_uk_int16_t N0 = params->N0;
+  const iree_uk_int16_t K0 = params->K0;
+  iree_uk_mmt4d_type_t mmt4d_type = iree_uk_mmt4d_type(params->flags);
+  const iree_uk_type_t lhs_type = iree_uk_mmt4d_lhs_type(mmt4d_type);
+  const iree_uk_type_t rhs_type = iree_uk_mmt4d_rhs_type(mmt4d_type);
+  const iree_uk_type_t out_type = iree_uk_mmt4d_out_type(mmt4d_type);
+  const iree_uk_int16_t lhs_elem_size = iree_uk_type_size(lhs_type);
+  const iree_uk_int16_t lhs_elem_size_log2 = iree_uk_type_size_log2(lhs_type);
+  const iree_uk_int16_t rhs_elem_bits_log2 =
+      iree_uk_type_bit_count_log2(rhs_type);
+  const iree_uk_int16_t out_elem_size_log2 = iree_uk_type_size_log2(out_type);
+  const iree_uk_int32_t K1_per_chunk =
+      IREE_UK_PACK_MMT4D_LHS_PANEL_BUFFER_SIZE /
+      ((M0 * K0) << lhs_elem_size_log2);
+  char* out_tile_row =
+      (char*)params->out_buffer + (params->out_offset << out_elem_size_log2);
+  const char* lhs_rows = (const char*)params->lhs_buffer +
+                         (params->lhs_offset << lhs_elem_size_log2);
+  const char* rhs_panel_start =
+      (const char*)params->rhs_buffer +
+      iree_uk_bits_to_bytes_exact(params->rhs_offset << rhs_elem_bits_log2);
+  iree_uk_int32_t out_tile_size = (M0 * N0) << out_elem_size_log2;
+  iree_uk_index_t lhs_row_stride = params->lhs_stride0 << lhs_elem_size_log2;
+  iree_uk_index_t rhs_panel_stride =
+      iree_uk_bits_to_bytes_exact(params->rhs_stride0 << rhs_elem_bits_log2);
+  iree_uk_index_t out_stride = params->out_stride0 << out_elem_size_log2;
+  for (iree_uk_int32_t i = 0; i < M; ++i) {
+    iree_uk_index_t rows =
+        iree_uk_index_clamp(params->lhs_size0 - i * M0, 0, M0);
+    // K == 0 still takes one (empty) chunk, to zero the output if needed.
+    iree_uk_int32_t k1_start = 0;
+    do {
+      iree_uk_int32_t K1 = iree_uk_index_min(K1_per_chunk, K - k1_start);
+      iree_uk_index_t cols = iree_uk_index_clamp(
+          params->lhs_size1 - k1_start * K0, 0, K1 * K0);
+      iree_uk_pack_mmt4d_pack_lhs_panel(
+          pack_tile_func, lhs_panel_buf,
+          lhs_rows + ((k1_start * K0) << lhs_elem_size_log2), lhs_row_stride,
+          rows, cols, K1, M0, K0, lhs_elem_size);
+      mmt4d_params->K = K1;
+      mmt4d_params->flags = params->flags;
+      if (k1_start > 0) mmt4d_params->flags |= IREE_UK_FLAG_MMT4D_ACCUMULATE;
+      char* out_tile = out_tile_row;
+      const char* rhs_panel =
+          rhs_panel_start + iree_uk_bits_to_bytes_exact(
+                                ((iree_uk_index_t)k1_start * N0 * K0)
+                                << rhs_elem_bits_log2);
+      IREE_UK_PREFETCH_RW(out_tile_row, IREE_UK_PREFETCH_LOCALITY_L3);
+      IREE_UK_PREFETCH_RO(rhs_panel, IREE_UK_PREFETCH_LOCALITY_L1);
+      for (iree_uk_int32_t j = 0; j < N; ++j) {
+        tile_func(out_tile, lhs_panel_buf, rhs_panel, mmt4d_params);
+        out_tile += out_tile_size;
+        rhs_panel += rhs_panel_stride;
+      }
+      k1_start += K1;
+    } while (k1_start < K);
+    out_tile_row += out_stride;
+    lhs_rows += M0 * lhs_row_stride;
+  }
+}
+
+void iree_uk_pack_mmt4d_p(const iree_uk_pack_mmt4d_params_t* params) {
+  iree_uk_pack_mmt4d_validate(params);
+
+  if (iree_uk_pack_mmt4d_early(params)) return;
+
+  // The tile functions are exactly those of mmt4d, which only ever look at the
+  // tile sizes, flags, K and cpu_data in the params.
+  iree_uk_mmt4d_params_t mmt4d_params = {.M = 1,
+                                         .N = params->N,
+                                         .K = params->K,
+                                         .M0 = params->M0,
+                                         .N0 = params->N0,
+                                         .K0 = params->K0,
+                                         .flags = params->flags,
+                                         .cpu_data = params->cpu_data};
+  iree_uk_mmt4d_tile_func_t tile_func =
+      iree_uk_mmt4d_select_tile_func_arch(&mmt4d_params);
+  if (!tile_func) {
+    if (params->flags &
+        IREE_UK_FLAG_MMT4D_ALLOW_GENERIC_FALLBACK_TILE_FUNCTION) {
+      tile_func = iree_uk_mmt4d_select_tile_func_generic(&mmt4d_params);
+    } else {
+      IREE_UK_ASSERT(
+          0 && "no target-specific tile function, and fallback not enabled.");
+    }
+  }
+
+  // The LHS packing only moves elements around, so any pack type with the
+  // same element size selects the right tile function.
+  iree_uk_mmt4d_type_t mmt4d_type = iree_uk_mmt4d_type(params->flags);
+  iree_uk_int16_t lhs_elem_size =
+      iree_uk_type_size(iree_uk_mmt4d_lhs_type(mmt4d_type));
+  iree_uk_pack_params_t pack_params = {
+      .out_size2 = params->M0,
+      .out_size3 = params->K0,
+      .flags = lhs_elem_size == 1   ? IREE_UK_FLAG_PACK_TYPE_I8I8
+               : lhs_elem_size == 2 ? IREE_UK_FLAG_PACK_TYPE_F16F16
+                                    : IREE_UK_FLAG_PACK_TYPE_F32F32,
+      .cpu_data = params->cpu_data};
+  iree_uk_pack_tile_func_t pack_tile_func =
+      iree_uk_pack_select_tile_func(&pack_params);
+
+  iree_uk_pack_mmt4d_using_tile_func(params, &mmt4d_params, tile_func,
+                                     pack_tile_func);
+}
+
+IREE_UK_EXPORT void iree_uk_pack_mmt4d(
+    const void* lhs_buffer, iree_uk_index_t lhs_offset,
+    iree_uk_index_t lhs_stride0, iree_uk_index_t lhs_size0,
+    iree_uk_index_t lhs_size1, const void* rhs_buffer,
+    iree_uk_index_t rhs_offset, iree_uk_index_t rhs_stride0, void* out_buffer,
+    iree_uk_index_t out_offset, iree_uk_index_t out_stride0, iree_uk_index_t M,
+    iree_uk_index_t N, iree_uk_index_t K, iree_uk_int32_t M0,
+    iree_uk_int32_t N0, iree_uk_int32_t K0, iree_uk_uint32_t flags,
+    const iree_uk_uint64_t* cpu_data) {
+  iree_uk_pack_mmt4d_params_t params = {.lhs_buffer = lhs_buffer,
+                                        .lhs_offset = lhs_offset,
+                                        .lhs_stride0 = lhs_stride0,
+                                        .lhs_size0 = lhs_size0,
+                                        .lhs_size1 = lhs_size1,
+                                        .rhs_buffer = rhs_buffer,
+                                        .rhs_offset = rhs_offset,
+                                        .rhs_stride0 = rhs_stride0,
+                                        .out_buffer = out_buffer,
+                                        .out_offset = out_offset,
+                                        .out_stride0 = out_stride0,
+                                        .M = M,
+                                        .N = N,
+                                        .K = K,
+                                        .M0 = M0,
+                                        .N0 = N0,
+                                        .K0 = K0,
+                                        .flags = flags,
+                                        .cpu_data = cpu_data};
+  iree_uk_pack_mmt4d_p(&params);
+}
@@ -0,0 +1,30 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_BUILTINS_UKERNEL_PACK_MMT4D_H_
+#define IREE_BUILTINS_UKERNEL_PACK_MMT4D_H_
+
+#include "iree/builtins/ukernel/common.h"
+
+// `pack_mmt4d` microkernel: `mmt4d` on an LHS that has not been packed yet.
+// The LHS is a plain row-major [lhs_size0][lhs_size1] matrix with stride
+// `lhs_stride0`, and each [M0][K] row panel of it is packed into a small local
+// buffer right before being consumed, instead of materializing the whole packed
+// LHS in memory. The RHS and the output, as well as M, N, K, M0, N0, K0 and
+// `flags`, are the same as for `mmt4d`. The LHS is padded with zeros up to
+// [M * M0][K * K0], with the same constraint as `pack` that the padding is
+// smaller than one tile.
+IREE_UK_EXPORT void iree_uk_pack_mmt4d(
+    const void* lhs_buffer, iree_uk_index_t lhs_offset,
+    iree_uk_index_t lhs_stride0, iree_uk_index_t lhs_size0,
+    iree_uk_index_t lhs_size1, const void* rhs_buffer,
+    iree_uk_index_t rhs_offset, iree_uk_index_t rhs_stride0, void* out_buffer,
+    iree_uk_index_t out_offset, iree_uk_index_t out_stride0, iree_uk_index_t M,
+    iree_uk_index_t N, iree_uk_index_t K, iree_uk_int32_t M0,
+    iree_uk_int32_t N0, iree_uk_int32_t K0, iree_uk_uint32_t flags,
+    const iree_uk_uint64_t* cpu_data);
+
+#endif  // IREE_BUILTINS_UKERNEL_PACK_MMT4D_H_
@@ -0,0 +1,46 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_BUILTINS_UKERNEL_PACK_MMT4D_INTERNAL_H_
+#define IREE_BUILTINS_UKERNEL_PACK_MMT4D_INTERNAL_H_
+
+#include "iree/builtins/ukernel/pack_mmt4d.h"
+
+// While the iree_uk_pack_mmt4d public entry point takes separate parameters,
+// internally the implementation functions pass parameters as this struct.
+typedef struct iree_uk_pack_mmt4d_params_t {
+  const void* lhs_buffer;
+  iree_uk_index_t lhs_offset;
+  iree_uk_index_t lhs_stride0;
+  iree_uk_index_t lhs_size0;
+  iree_uk_index_t lhs_size1;
+  const void* rhs_buffer;
+  iree_uk_index_t rhs_offset;
+  iree_uk_index_t rhs_stride0;
+  void* out_buffer;
+  iree_uk_index_t out_offset;
+  iree_uk_index_t out_stride0;
+  iree_uk_index_t M;
+  iree_uk_index_t N;
+  iree_uk_index_t K;
+  iree_uk_int32_t M0;
+  iree_uk_int32_t N0;
+  iree_uk_int32_t K0;
+  iree_uk_uint32_t flags;
+  const iree_uk_uint64_t* cpu_data;
+} iree_uk_pack_mmt4d_params_t;
+
+// Same as the iree_uk_pack_mmt4d public entry point, but taking the struct.
+void iree_uk_pack_mmt4d_p(const iree_uk_pack_mmt4d_params_t* params);
+
+// Size in bytes of the buffer that LHS panels get packed into. The buffer is
+// on the stack, so this is kept well below the minimum worker stack size, and
+// it is small enough to stay in L1 while it is reused across all RHS panels.
+// Panels with more than this many bytes are packed and consumed in chunks
+// along K, accumulating into the output.
+#define IREE_UK_PACK_MMT4D_LHS_PANEL_BUFFER_SIZE 8192
+
+#endif  // IREE_BUILTINS_UKERNEL_PACK_MMT4D_INTERNAL_H_
@@ -40,11 +40,28 @@ static iree_uk_matmul_tile_sizes_t iree_uk_query_matmul_tile_sizes_generic(
   return (iree_uk_matmul_tile_sizes_t){.M = 8, .K = 4, .N = 8};
 }
 
+static bool iree_uk_query_matmul_tile_sizes_tuned(
+    const iree_uk_query_tile_sizes_2d_params_t* params,
+    iree_uk_matmul_tile_sizes_t* out_matmul_tile_sizes) {
+  iree_uk_uint32_t op = iree_uk_query_tile_sizes_operation(params->flags);
+  for (iree_uk_index_t i = 0; i < params->tuned_matmul_count; ++i) {
+    const iree_uk_query_tile_sizes_tuned_matmul_t* tuned =
+        &params->tuned_matmuls[i];
+    if (tuned->operation == op) {
+      *out_matmul_tile_sizes = (iree_uk_matmul_tile_sizes_t){
+          .M = tuned->M, .K = tuned->K, .N = tuned->N};
+      return true;
+    }
+  }
+  return false;
+}
+
 static void iree_uk_query_tile_sizes_2d_matmul(
     const iree_uk_query_tile_sizes_2d_params_t* params,
     iree_uk_query_tile_sizes_2d_out_params_t* out_params) {
   iree_uk_matmul_tile_sizes_t matmul_tile_sizes;
-  if (!iree_uk_query_matmul_tile_sizes_arch(params, &matmul_tile_sizes)) {
+  if (!iree_uk_query_matmul_tile_sizes_tuned(params, &matmul_tile_sizes) &&
+      !iree_uk_query_matmul_tile_sizes_arch(params, &matmul_tile_sizes)) {
     matmul_tile_sizes = iree_uk_query_matmul_tile_sizes_generic(params);
   }
   iree_uk_uint32_t role = iree_uk_query_tile_sizes_operand_role(params->flags);
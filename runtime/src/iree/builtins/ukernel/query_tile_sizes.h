@@ -13,12 +13,27 @@
 // is the only place where target information is not known at compile time,
 // forcing deferral of tile-size selection to runtime.
 
+// Matmul tile sizes to return for one operation instead of the built-in
+// choice for the CPU, typically measured to be faster on the actual host by
+// tools/mmt4d_autotune.c.
+typedef struct iree_uk_query_tile_sizes_tuned_matmul_t {
+  // One of the IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_* values.
+  iree_uk_uint32_t operation;
+  iree_uk_int32_t M, K, N;
+} iree_uk_query_tile_sizes_tuned_matmul_t;
+
 // Parameters for a query_tile_sizes operation.
 typedef struct iree_uk_query_tile_sizes_2d_params_t {
   iree_uk_uint32_t flags;
   iree_uk_index_t size0;
   iree_uk_index_t size1;
   const iree_uk_uint64_t* cpu_data;
+  // Optional array of tuned matmul tile sizes. The first entry matching the
+  // operation in |flags| takes precedence over the built-in choice. It is up
+  // to the caller to only pass tile sizes that have a tile function for the
+  // CPU, see iree_uk_mmt4d_info.
+  const iree_uk_query_tile_sizes_tuned_matmul_t* tuned_matmuls;
+  iree_uk_index_t tuned_matmul_count;
 } iree_uk_query_tile_sizes_2d_params_t;
 
 typedef struct iree_uk_query_tile_sizes_2d_out_params_t {
@@ -0,0 +1,77 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/softmax.h"
+
+#include "iree/builtins/ukernel/softmax_internal.h"
+
+static void iree_uk_softmax_validate(const iree_uk_softmax_params_t* params) {
+#ifdef IREE_UK_ENABLE_ASSERTS
+  const iree_uk_uint32_t allflags = IREE_UK_FLAG_SOFTMAX_TYPE_MASK;
+  IREE_UK_ASSERT(!(params->flags & ~allflags));
+  iree_uk_uint32_t flags_type = params->flags & IREE_UK_FLAG_SOFTMAX_TYPE_MASK;
+  IREE_UK_ASSERT(flags_type != IREE_UK_FLAG_SOFTMAX_TYPE_NONE);
+  IREE_UK_ASSERT(flags_type < IREE_UK_FLAG_SOFTMAX_TYPE_END);
+  IREE_UK_ASSERT(params->size0 >= 0);
+  IREE_UK_ASSERT(params->size1 >= 0);
+  IREE_UK_ASSERT(params->in_stride0 >= params->size1);
+  IREE_UK_ASSERT(params->out_stride0 >= params->size1);
+#endif  // IREE_UK_ENABLE_ASSERTS
+}
+
+// Early-return implementation for this ukernel. Returns true if already done.
+static bool iree_uk_softmax_early(const iree_uk_softmax_params_t* params) {
+  return params->size0 == 0 || params->size1 == 0;
+}
+
+static void iree_uk_softmax_using_tile_func(
+    const iree_uk_softmax_params_t* params,
+    iree_uk_softmax_tile_func_t tile_func) {
+  iree_uk_softmax_type_t type = iree_uk_softmax_type(params->flags);
+  iree_uk_index_t in_elem_size =
+      iree_uk_type_size(iree_uk_softmax_in_type(type));
+  iree_uk_index_t out_elem_size =
+      iree_uk_type_size(iree_uk_softmax_out_type(type));
+  const char* in_row =
+      (const char*)params->in_buffer + params->in_offset * in_elem_size;
+  char* out_row =
+      (char*)params->out_buffer + params->out_offset * out_elem_size;
+  iree_uk_index_t in_row_stride = params->in_stride0 * in_elem_size;
+  iree_uk_index_t out_row_stride = params->out_stride0 * out_elem_size;
+  for (iree_uk_index_t i = 0; i < params->size0; ++i) {
+    tile_func(out_row, in_row, params);
+    in_row += in_row_stride;
+    out_row += out_row_stride;
+  }
+}
+
+void iree_uk_softmax_p(const iree_uk_softmax_params_t* params) {
+  iree_uk_softmax_validate(params);
+
+  if (iree_uk_softmax_early(params)) return;
+
+  iree_uk_softmax_tile_func_t tile_func =
+      iree_uk_softmax_select_tile_func(params);
+  iree_uk_softmax_using_tile_func(params, tile_func);
+}
+
+IREE_UK_EXPORT void iree_uk_softmax(
+    const void* in_buffer, iree_uk_index_t in_offset,
+    iree_uk_index_t in_stride0, void* out_buffer, iree_uk_index_t out_offset,
+    iree_uk_index_t out_stride0, iree_uk_index_t size0, iree_uk_index_t size1,
+    iree_uk_uint32_t flags, const iree_uk_uint64_t* cpu_data) {
+  iree_uk_softmax_params_t params = {.in_buffer = in_buffer,
+                                     .in_offset = in_offset,
+                                     .in_stride0 = in_stride0,
+                                     .out_buffer = out_buffer,
+                                     .out_offset = out_offset,
+                                     .out_stride0 = out_stride0,
+                                     .size0 = size0,
+                                     .size1 = size1,
+                                     .flags = flags,
+                                     .cpu_data = cpu_data};
+  iree_uk_softmax_p(&params);
+}
@@ -0,0 +1,84 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_BUILTINS_UKERNEL_SOFTMAX_INTERNAL_H_
+#define IREE_BUILTINS_UKERNEL_SOFTMAX_INTERNAL_H_
+
+#include "iree/builtins/ukernel/softmax.h"
+
+typedef struct iree_uk_softmax_params_t {
+  const void* in_buffer;
+  iree_uk_index_t in_offset;
+  iree_uk_index_t in_stride0;
+  void* out_buffer;
+  iree_uk_index_t out_offset;
+  iree_uk_index_t out_stride0;
+  iree_uk_index_t size0;
+  iree_uk_index_t size1;
+  iree_uk_uint32_t flags;
+  const iree_uk_uint64_t* cpu_data;
+} iree_uk_softmax_params_t;
+
+void iree_uk_softmax_p(const iree_uk_softmax_params_t* params);
+
+typedef enum iree_uk_softmax_type_t {
+  iree_uk_softmax_type_f32f32 = IREE_UK_TIE_2_TYPES_LITERAL(FLOAT_32, FLOAT_32),
+} iree_uk_softmax_type_t;
+
+static inline iree_uk_softmax_type_t iree_uk_softmax_type(
+    iree_uk_uint32_t flags) {
+  switch (flags & IREE_UK_FLAG_SOFTMAX_TYPE_MASK) {
+    case IREE_UK_FLAG_SOFTMAX_TYPE_F32F32:
+      return iree_uk_softmax_type_f32f32;
+    default:
+      // Shouldn't happen, validated earlier.
+      return (iree_uk_softmax_type_t)0;
+  }
+}
+
+static inline iree_uk_type_t iree_uk_softmax_in_type(
+    iree_uk_softmax_type_t type) {
+  return iree_uk_untie_type(0, type);
+}
+
+static inline iree_uk_type_t iree_uk_softmax_out_type(
+    iree_uk_softmax_type_t type) {
+  return iree_uk_untie_type(1, type);
+}
+
+// Folds `x` into the running `max` and `sum` of exponentials relative to it.
+// Used by the generic tile function and by the scalar tails of the
+// architecture-specific ones.
+static inline void iree_uk_softmax_accumulate_f32(float x, float* max,
+                                                  float* sum) {
+  if (x > *max) {
+    *sum *= iree_uk_exp_f32(*max - x);
+    *max = x;
+  }
+  *sum += iree_uk_exp_f32(x - *max);
+}
+
+// Function pointer type for tile functions, each processing one whole row of
+// `params->size1` elements.
+typedef void (*iree_uk_softmax_tile_func_t)(
+    void* IREE_UK_RESTRICT out_row, const void* IREE_UK_RESTRICT in_row,
+    const iree_uk_softmax_params_t* params);
+
+// Tile kernel declarations. Prototype matches iree_uk_softmax_tile_func_t.
+#define IREE_UK_SOFTMAX_TILE_FUNC_DECL(NAME)     \
+  void NAME(void* IREE_UK_RESTRICT out_row,      \
+            const void* IREE_UK_RESTRICT in_row, \
+            const iree_uk_softmax_params_t* params);
+
+// Returns the tile function to use for the softmax op with the given params.
+iree_uk_softmax_tile_func_t iree_uk_softmax_select_tile_func(
+    const iree_uk_softmax_params_t* params);
+
+// Architecture-specific implementation.
+iree_uk_softmax_tile_func_t iree_uk_softmax_select_tile_func_arch(
+    const iree_uk_softmax_params_t* params);
+
+#endif  // IREE_BUILTINS_UKERNEL_SOFTMAX_INTERNAL_H_
@@ -0,0 +1,48 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/softmax_internal.h"
+
+static void iree_uk_softmax_tile_f32f32_generic(
+    void* IREE_UK_RESTRICT out_row_untyped,
+    const void* IREE_UK_RESTRICT in_row_untyped,
+    const iree_uk_softmax_params_t* params) {
+  float* IREE_UK_RESTRICT out_row = out_row_untyped;
+  const float* IREE_UK_RESTRICT in_row = in_row_untyped;
+  iree_uk_index_t size = params->size1;
+  float max = IREE_UK_FLOAT_LOWEST;
+  float sum = 0.f;
+  for (iree_uk_index_t j = 0; j < size; ++j) {
+    iree_uk_softmax_accumulate_f32(in_row[j], &max, &sum);
+  }
+  float inv_sum = 1.f / sum;
+  for (iree_uk_index_t j = 0; j < size; ++j) {
+    out_row[j] = iree_uk_exp_f32(in_row[j] - max) * inv_sum;
+  }
+}
+
+static iree_uk_softmax_tile_func_t iree_uk_softmax_select_tile_func_generic(
+    const iree_uk_softmax_params_t* params) {
+  switch (iree_uk_softmax_type(params->flags)) {
+    case iree_uk_softmax_type_f32f32:
+      return iree_uk_softmax_tile_f32f32_generic;
+    default:
+      // Shouldn't happen, validated earlier.
+      return 0;
+  }
+}
+
+// Select the 'tile function' that is the typically target-optimized inner loop
+// implementation.
+iree_uk_softmax_tile_func_t iree_uk_softmax_select_tile_func(
+    const iree_uk_softmax_params_t* params) {
+  iree_uk_softmax_tile_func_t arch_tile_func =
+      iree_uk_softmax_select_tile_func_arch(params);
+  if (arch_tile_func) {
+    return arch_tile_func;
+  }
+  return iree_uk_softmax_select_tile_func_generic(params);
+}
@@ -0,0 +1,134 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <stdio.h>
+
+#include "iree/base/api.h"
+#include "iree/base/internal/flags.h"
+#include "iree/builtins/ukernel/api.h"
+#include "iree/builtins/ukernel/attention_internal.h"
+#include "iree/builtins/ukernel/tools/benchmark.h"
+#include "iree/builtins/ukernel/tools/util.h"
+
+IREE_FLAG(int32_t, batch_size, 1,
+          "Number of batch entries, e.g. attention heads.");
+IREE_FLAG(int32_t, query_size, 128, "Number of q rows (M).");
+IREE_FLAG(int32_t, sequence_size, 1024,
+          "Number of k and v rows (K2), the length of the softmax reduction.");
+IREE_FLAG(int32_t, head_size, 64,
+          "Size of the q, k and v rows (K1 and N), i.e. the head dimension.");
+IREE_FLAG(bool, transpose_v, false, "Whether v is given as [N][K2].");
+
+static iree_status_t iree_uk_benchmark_attention(
+    const iree_benchmark_def_t* benchmark_def,
+    iree_benchmark_state_t* benchmark_state) {
+  const iree_uk_benchmark_user_data_t* user_data = benchmark_def->user_data;
+  const iree_uk_attention_params_t* src_params =
+      iree_uk_benchmark_params(user_data);
+  iree_uk_attention_params_t params;
+  memcpy(&params, src_params, sizeof params);
+  params.cpu_data = iree_uk_benchmark_cpu_data(user_data);
+  if (FLAG_transpose_v) params.flags |= IREE_UK_FLAG_ATTENTION_TRANSPOSE_V;
+  iree_uk_attention_type_t type = iree_uk_attention_type(params.flags);
+  iree_uk_type_t in_type = iree_uk_attention_in_type(type);
+  iree_uk_type_t out_type = iree_uk_attention_out_type(type);
+  params.batch = FLAG_batch_size;
+  params.M = FLAG_query_size;
+  params.K1 = FLAG_head_size;
+  params.K2 = FLAG_sequence_size;
+  params.N = FLAG_head_size;
+  params.scale = 1.f / 8.f;
+  params.q_stride1 = params.K1;
+  params.k_stride1 = params.K1;
+  params.v_stride1 = FLAG_transpose_v ? params.K2 : params.N;
+  params.out_stride1 = params.N;
+  params.q_stride0 = params.M * params.q_stride1;
+  params.k_stride0 = params.K2 * params.k_stride1;
+  params.v_stride0 = params.K2 * params.N;
+  params.out_stride0 = params.M * params.out_stride1;
+  iree_uk_index_t q_buffer_size = iree_uk_2d_buffer_length(
+      in_type, params.batch, params.q_stride0);
+  iree_uk_index_t k_buffer_size = iree_uk_2d_buffer_length(
+      in_type, params.batch, params.k_stride0);
+  iree_uk_index_t v_buffer_size = iree_uk_2d_buffer_length(
+      in_type, params.batch, params.v_stride0);
+  iree_uk_index_t out_buffer_size = iree_uk_2d_buffer_length(
+      out_type, params.batch, params.out_stride0);
+  void* q_buffer = malloc(q_buffer_size);
+  void* k_buffer = malloc(k_buffer_size);
+  void* v_buffer = malloc(v_buffer_size);
+  void* out_buffer = malloc(out_buffer_size);
+  iree_uk_random_engine_t* engine = iree_uk_benchmark_random_engine(user_data);
+  iree_uk_write_random_buffer(q_buffer, q_buffer_size, in_type, engine);
+  iree_uk_write_random_buffer(k_buffer, k_buffer_size, in_type, engine);
+  iree_uk_write_random_buffer(v_buffer, v_buffer_size, in_type, engine);
+  iree_uk_write_random_buffer(out_buffer, out_buffer_size, out_type, engine);
+  params.q_buffer = q_buffer;
+  params.k_buffer = k_buffer;
+  params.v_buffer = v_buffer;
+  params.out_buffer = out_buffer;
+  int64_t total_iterations = 0;
+  int64_t batch_count = 1;
+  while (iree_uk_benchmark_keep_running(benchmark_state, batch_count)) {
+    for (int i = 0; i < batch_count; ++i) {
+      iree_uk_attention_p(&params);
+    }
+    total_iterations += batch_count;
+    batch_count *= 2;
+  }
+  // Count the multiply-adds of the two matmuls, q . k^T and p . v, as 2 ops
+  // each, like mmt4d_benchmark. The exponentials are not counted.
+  iree_benchmark_set_items_processed(
+      benchmark_state, total_iterations * 2 * params.batch * params.M *
+                           params.K2 * (params.K1 + params.N));
+  free(q_buffer);
+  free(k_buffer);
+  free(v_buffer);
+  free(out_buffer);
+  return iree_ok_status();
+}
+
+static void iree_uk_benchmark_register_attention(iree_uk_uint32_t flags,
+                                                 const char* cpu_features) {
+  char type_str[32];
+  iree_uk_type_pair_str(type_str, sizeof type_str,
+                        iree_uk_attention_type(flags));
+  iree_uk_attention_params_t params = {.flags = flags};
+  char name[128];
+  snprintf(name, sizeof name, "attention_%s_b_%d_m_%d_k2_%d_head_%d",
+           type_str, FLAG_batch_size, FLAG_query_size, FLAG_sequence_size,
+           FLAG_head_size);
+  iree_uk_benchmark_register(name, iree_uk_benchmark_attention, &params,
+                             sizeof params, cpu_features);
+}
+
+int main(int argc, char** argv) {
+  iree_flags_set_usage("attention_benchmark", "");
+
+  iree_flags_parse_checked(IREE_FLAGS_PARSE_MODE_UNDEFINED_OK, &argc, &argv);
+  iree_uk_benchmark_initialize(&argc, argv);
+
+  iree_uk_benchmark_register_attention(IREE_UK_FLAG_ATTENTION_TYPE_F32F32, "");
+  iree_uk_benchmark_register_attention(IREE_UK_FLAG_ATTENTION_TYPE_F16F16, "");
+  iree_uk_benchmark_register_attention(IREE_UK_FLAG_ATTENTION_TYPE_BF16BF16,
+                                       "");
+#if defined(IREE_ARCH_X86_64)
+  iree_uk_benchmark_register_attention(IREE_UK_FLAG_ATTENTION_TYPE_F32F32,
+                                       "avx2_fma");
+  iree_uk_benchmark_register_attention(IREE_UK_FLAG_ATTENTION_TYPE_F16F16,
+                                       "avx2_fma");
+  iree_uk_benchmark_register_attention(IREE_UK_FLAG_ATTENTION_TYPE_BF16BF16,
+                                       "avx2_fma");
+  iree_uk_benchmark_register_attention(IREE_UK_FLAG_ATTENTION_TYPE_F32F32,
+                                       "avx512_base");
+  iree_uk_benchmark_register_attention(IREE_UK_FLAG_ATTENTION_TYPE_F16F16,
+                                       "avx512_base");
+  iree_uk_benchmark_register_attention(IREE_UK_FLAG_ATTENTION_TYPE_BF16BF16,
+                                       "avx512_base");
+#endif  // defined(IREE_ARCH_X86_64)
+
+  iree_uk_benchmark_run_and_cleanup();
+}
@@ -0,0 +1,253 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <math.h>
+
+#include "iree/base/api.h"
+#include "iree/builtins/ukernel/api.h"
+#include "iree/builtins/ukernel/attention_internal.h"
+#include "iree/builtins/ukernel/tools/test.h"
+#include "iree/builtins/ukernel/tools/util.h"
+
+// The ukernel computes the softmax online, block by block, with an
+// approximate exp, so the comparison against this straightforward
+// double-precision reference is tolerance-based.
+static void iree_attention_reference(const iree_uk_attention_params_t* params) {
+  iree_uk_attention_type_t type = iree_uk_attention_type(params->flags);
+  iree_uk_type_t in_type = iree_uk_attention_in_type(type);
+  iree_uk_type_t out_type = iree_uk_attention_out_type(type);
+  bool transpose_v = params->flags & IREE_UK_FLAG_ATTENTION_TRANSPOSE_V;
+  double* s = malloc((params->K2 + 1) * sizeof(double));
+  for (iree_uk_index_t b = 0; b < params->batch; ++b) {
+    iree_uk_index_t q_base = params->q_offset + b * params->q_stride0;
+    iree_uk_index_t k_base = params->k_offset + b * params->k_stride0;
+    iree_uk_index_t v_base = params->v_offset + b * params->v_stride0;
+    iree_uk_index_t out_base = params->out_offset + b * params->out_stride0;
+    for (iree_uk_index_t i = 0; i < params->M; ++i) {
+      double max = -INFINITY;
+      for (iree_uk_index_t j = 0; j < params->K2; ++j) {
+        double dot = 0;
+        for (iree_uk_index_t c = 0; c < params->K1; ++c) {
+          dot += (double)iree_uk_attention_load(
+                     params->q_buffer, q_base + i * params->q_stride1 + c,
+                     in_type) *
+                 iree_uk_attention_load(params->k_buffer,
+                                        k_base + j * params->k_stride1 + c,
+                                        in_type);
+        }
+        s[j] = params->scale * dot;
+        if (s[j] > max) max = s[j];
+      }
+      double sum = 0;
+      for (iree_uk_index_t j = 0; j < params->K2; ++j) {
+        s[j] = exp(s[j] - max);
+        sum += s[j];
+      }
+      for (iree_uk_index_t n = 0; n < params->N; ++n) {
+        double acc = 0;
+        for (iree_uk_index_t j = 0; j < params->K2; ++j) {
+          iree_uk_index_t v_index =
+              v_base + (transpose_v ? n * params->v_stride1 + j
+                                    : j * params->v_stride1 + n);
+          acc += s[j] *
+                 iree_uk_attention_load(params->v_buffer, v_index, in_type);
+        }
+        iree_uk_attention_store(params->out_buffer,
+                                out_base + i * params->out_stride1 + n,
+                                sum > 0 ? (float)(acc / sum) : 0.f, out_type);
+      }
+    }
+  }
+  free(s);
+}
+
+// Fills a buffer of the given floating-point type with values in
+// [-range, range]. The integer-valued buffers from iree_uk_write_random_buffer
+// would make all the scores exact and leave the exp polynomial untested.
+static void iree_uk_test_write_random_float_buffer(
+    void* buffer, iree_uk_index_t size, iree_uk_type_t type, float range,
+    iree_uk_random_engine_t* engine) {
+  for (iree_uk_index_t i = 0; i < size; ++i) {
+    float u = iree_uk_random_engine_get_0_65535(engine) / 65535.f;
+    iree_uk_attention_store(buffer, i, range * (2.f * u - 1.f), type);
+  }
+}
+
+static bool iree_uk_test_attention_outputs_close(
+    const iree_uk_attention_params_t* params, const void* actual,
+    const void* expected) {
+  iree_uk_type_t out_type =
+      iree_uk_attention_out_type(iree_uk_attention_type(params->flags));
+  // Tolerances account for the rounding of the output to its type.
+  float tolerance = out_type == IREE_UK_TYPE_FLOAT_32   ? 1e-5f
+                    : out_type == IREE_UK_TYPE_FLOAT_16 ? 2e-3f
+                                                        : 1e-2f;
+  for (iree_uk_index_t b = 0; b < params->batch; ++b) {
+    for (iree_uk_index_t i = 0; i < params->M; ++i) {
+      for (iree_uk_index_t n = 0; n < params->N; ++n) {
+        iree_uk_index_t offset =
+            b * params->out_stride0 + i * params->out_stride1 + n;
+        float a = iree_uk_attention_load(actual, offset, out_type);
+        float e = iree_uk_attention_load(expected, offset, out_type);
+        if (!(fabsf(a - e) <= tolerance + 10 * tolerance * fabsf(e))) {
+          fprintf(stderr,
+                  "mismatch at (%d, %d, %d): actual %g expected %g\n", (int)b,
+                  (int)i, (int)n, a, e);
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+static void* iree_uk_test_attention_alloc_operand(
+    iree_uk_index_t rows, iree_uk_index_t cols, iree_uk_index_t batch,
+    iree_uk_type_t type, iree_uk_index_t* stride1, iree_uk_index_t* stride0,
+    iree_uk_index_t* offset, iree_uk_random_engine_t* engine) {
+  // Randomly make strides either tight or not to exercise all cases.
+  *stride1 = cols + iree_uk_random_engine_get_0_1(engine);
+  *stride0 = rows * *stride1 + iree_uk_random_engine_get_0_1(engine);
+  *offset = iree_uk_random_engine_get_0_1(engine);
+  iree_uk_index_t size = *offset + batch * *stride0 + 1;
+  void* buffer = malloc(size * iree_uk_type_size(type));
+  iree_uk_test_write_random_float_buffer(buffer, size, type, 1.f, engine);
+  return buffer;
+}
+
+static void iree_uk_test_attention_for_shape_params(
+    iree_uk_test_t* test, const iree_uk_attention_params_t* src_params) {
+  iree_uk_attention_params_t params;
+  memcpy(&params, src_params, sizeof params);
+  iree_uk_random_engine_t* engine = iree_uk_test_random_engine(test);
+  iree_uk_attention_type_t type = iree_uk_attention_type(params.flags);
+  iree_uk_type_t in_type = iree_uk_attention_in_type(type);
+  iree_uk_type_t out_type = iree_uk_attention_out_type(type);
+  bool transpose_v = params.flags & IREE_UK_FLAG_ATTENTION_TRANSPOSE_V;
+  void* q_buffer = iree_uk_test_attention_alloc_operand(
+      params.M, params.K1, params.batch, in_type, &params.q_stride1,
+      &params.q_stride0, &params.q_offset, engine);
+  void* k_buffer = iree_uk_test_attention_alloc_operand(
+      params.K2, params.K1, params.batch, in_type, &params.k_stride1,
+      &params.k_stride0, &params.k_offset, engine);
+  void* v_buffer = iree_uk_test_attention_alloc_operand(
+      transpose_v ? params.N : params.K2, transpose_v ? params.K2 : params.N,
+      params.batch, in_type, &params.v_stride1, &params.v_stride0,
+      &params.v_offset, engine);
+  params.q_buffer = q_buffer;
+  params.k_buffer = k_buffer;
+  params.v_buffer = v_buffer;
+
+  params.out_stride1 = params.N + iree_uk_random_engine_get_0_1(engine);
+  params.out_stride0 =
+      params.M * params.out_stride1 + iree_uk_random_engine_get_0_1(engine);
+  params.out_offset = iree_uk_random_engine_get_0_65535(engine);
+  iree_uk_index_t out_buffer_size =
+      (params.batch * params.out_stride0 + 1) * iree_uk_type_size(out_type);
+  void* reference_out_buffer = malloc(out_buffer_size);
+  void* actual_out_buffer = malloc(out_buffer_size);
+  iree_uk_write_random_buffer(reference_out_buffer, out_buffer_size, out_type,
+                              engine);
+  memcpy(actual_out_buffer, reference_out_buffer, out_buffer_size);
+
+  iree_uk_index_t out_offset_bytes =
+      params.out_offset * iree_uk_type_size(out_type);
+  iree_uk_attention_params_t reference_params;
+  memcpy(&reference_params, &params, sizeof reference_params);
+  reference_params.out_buffer =
+      (char*)reference_out_buffer - out_offset_bytes;
+  iree_uk_attention_params_t actual_params;
+  memcpy(&actual_params, &params, sizeof actual_params);
+  actual_params.out_buffer = (char*)actual_out_buffer - out_offset_bytes;
+
+  iree_attention_reference(&reference_params);
+  iree_uk_attention_p(&actual_params);
+
+  if (!iree_uk_test_attention_outputs_close(&params, actual_out_buffer,
+                                            reference_out_buffer)) {
+    IREE_UK_TEST_FAIL(test);
+  }
+
+  free(reference_out_buffer);
+  free(actual_out_buffer);
+  free(q_buffer);
+  free(k_buffer);
+  free(v_buffer);
+}
+
+static void iree_uk_test_attention_for_tile_params(iree_uk_test_t* test,
+                                                   const void* src_params) {
+  typedef struct shape_t {
+    int batch, M, K1, K2, N;
+  } shape_t;
+  const shape_t shapes[] = {
+      // Degenerate cases. Vacuous.
+      {0, 1, 1, 1, 1},
+      {1, 0, 1, 1, 1},
+      {1, 1, 1, 1, 0},
+      // An empty k and v. The output is all zeros.
+      {1, 3, 8, 0, 8},
+      // Non-degenerate cases. The sizes straddle the vector widths, the
+      // number of q rows per tile, and the k and output column blocks.
+      {1, 1, 1, 1, 1},
+      {1, 3, 7, 5, 9},
+      {2, 8, 16, 64, 16},
+      {1, 9, 33, 65, 17},
+      {3, 17, 64, 130, 32},
+      {1, 5, 24, 40, 129},
+      {1, 2, 128, 300, 64},
+  };
+  // A small scale keeps the scores close to each other, a large one
+  // exercises the underflow path and the online rescaling.
+  const float scales[] = {0.125f, 8.f};
+  for (int i = 0; i < IREE_ARRAYSIZE(shapes); ++i) {
+    for (int s = 0; s < IREE_ARRAYSIZE(scales); ++s) {
+      for (int transpose_v = 0; transpose_v <= 1; ++transpose_v) {
+        iree_uk_attention_params_t params;
+        memcpy(&params, src_params, sizeof params);
+        params.cpu_data = iree_uk_test_cpu_data(test);
+        params.batch = shapes[i].batch;
+        params.M = shapes[i].M;
+        params.K1 = shapes[i].K1;
+        params.K2 = shapes[i].K2;
+        params.N = shapes[i].N;
+        params.scale = scales[s];
+        if (transpose_v) params.flags |= IREE_UK_FLAG_ATTENTION_TRANSPOSE_V;
+        iree_uk_test_attention_for_shape_params(test, &params);
+      }
+    }
+  }
+}
+
+static void iree_uk_test_attention(iree_uk_uint32_t flags,
+                                   const char* cpu_features) {
+  iree_uk_attention_params_t params = {.flags = flags};
+  char types_str[32];
+  iree_uk_type_pair_str(types_str, sizeof types_str,
+                        iree_uk_attention_type(flags));
+  char test_label_str[256];
+  snprintf(test_label_str, sizeof test_label_str, "types:%s", types_str);
+  iree_uk_test(test_label_str, iree_uk_test_attention_for_tile_params, &params,
+               cpu_features);
+}
+
+int main(int argc, char** argv) {
+  iree_uk_test_attention(IREE_UK_FLAG_ATTENTION_TYPE_F32F32, "");
+  iree_uk_test_attention(IREE_UK_FLAG_ATTENTION_TYPE_F16F16, "");
+  iree_uk_test_attention(IREE_UK_FLAG_ATTENTION_TYPE_BF16BF16, "");
+
+#if defined(IREE_ARCH_X86_64)
+  iree_uk_test_attention(IREE_UK_FLAG_ATTENTION_TYPE_F32F32, "avx2_fma");
+  iree_uk_test_attention(IREE_UK_FLAG_ATTENTION_TYPE_F16F16, "avx2_fma");
+  iree_uk_test_attention(IREE_UK_FLAG_ATTENTION_TYPE_BF16BF16, "avx2_fma");
+  iree_uk_test_attention(IREE_UK_FLAG_ATTENTION_TYPE_F32F32, "avx512_base");
+  iree_uk_test_attention(IREE_UK_FLAG_ATTENTION_TYPE_F16F16, "avx512_base");
+  iree_uk_test_attention(IREE_UK_FLAG_ATTENTION_TYPE_BF16BF16,
+                         "avx512_base");
+#endif  // defined(IREE_ARCH_X86_64)
+
+  return iree_uk_test_exit_status();
+}
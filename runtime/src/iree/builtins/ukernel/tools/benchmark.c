@@ -6,11 +6,34 @@
 
 #include "iree/builtins/ukernel/tools/benchmark.h"
 
+#include <stdio.h>
 #include <string.h>
 
 #include "iree/base/api.h"
+#include "iree/base/internal/flags.h"
 #include "iree/schemas/cpu_data.h"
 
+#if defined(IREE_PLATFORM_LINUX) || defined(IREE_PLATFORM_ANDROID)
+#define IREE_UK_BENCHMARK_HAVE_PERF_EVENT 1
+#include <errno.h>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#if defined(IREE_ARCH_X86_64)
+#include <cpuid.h>
+#endif  // defined(IREE_ARCH_X86_64)
+#endif  // IREE_PLATFORM_LINUX || IREE_PLATFORM_ANDROID
+
+IREE_FLAG(bool, perf_counters, false,
+          "Counts hardware events with Linux perf_event_open over each\n"
+          "benchmark loop and reports them per iteration as extra counters:\n"
+          "cycles, instructions, IPC, L1D and LLC read misses, and, where the\n"
+          "CPU has a suitable event, fp_ops (FP operations, FMA counting as\n"
+          "2; single precision only on x86). Only the benchmark thread is\n"
+          "counted. Events the kernel or CPU refuses are left out; see\n"
+          "/proc/sys/kernel/perf_event_paranoid if none can be opened.");
+
 struct iree_uk_benchmark_user_data_t {
   const void* params;
   iree_uk_uint64_t* cpu_data;
@@ -34,6 +57,201 @@ iree_uk_random_engine_t* iree_uk_benchmark_random_engine(
   return (iree_uk_random_engine_t*)&user_data->random_engine;
 }
 
+//===----------------------------------------------------------------------===//
+// Hardware counters
+//===----------------------------------------------------------------------===//
+
+// Maximum number of perf events opened. Some counters are the weighted sum of
+// several events, e.g. fp_ops over the vector widths.
+#define IREE_UK_BENCHMARK_MAX_PERF_EVENTS 16
+
+typedef struct iree_uk_benchmark_perf_event_t {
+  // Name of the counter reported to the benchmark library. Events with the
+  // same name are summed into one counter.
+  const char* name;
+  // What this event counts, e.g. operations per instruction for fp_ops.
+  double weight;
+  int fd;
+} iree_uk_benchmark_perf_event_t;
+
+static int s_iree_uk_benchmark_perf_event_count;
+static iree_uk_benchmark_perf_event_t
+    s_iree_uk_benchmark_perf_events[IREE_UK_BENCHMARK_MAX_PERF_EVENTS];
+// Whether the events are enabled, i.e. a benchmark loop is running.
+static bool s_iree_uk_benchmark_perf_events_enabled;
+
+#if defined(IREE_UK_BENCHMARK_HAVE_PERF_EVENT)
+
+// Opens a disabled event counting user-space activity of the calling thread.
+// Events that fail to open are left out: not all are available everywhere.
+static void iree_uk_benchmark_open_perf_event(const char* name, double weight,
+                                              uint32_t type, uint64_t config) {
+  if (s_iree_uk_benchmark_perf_event_count ==
+      IREE_UK_BENCHMARK_MAX_PERF_EVENTS) {
+    return;
+  }
+  struct perf_event_attr attr;
+  memset(&attr, 0, sizeof attr);
+  attr.size = sizeof attr;
+  attr.type = type;
+  attr.config = config;
+  attr.disabled = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  // There may be more events than hardware counters, in which case the kernel
+  // multiplexes them and we scale the counts by the time each was running.
+  attr.read_format =
+      PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+  int fd = (int)syscall(SYS_perf_event_open, &attr, /*pid=*/0, /*cpu=*/-1,
+                        /*group_fd=*/-1, /*flags=*/0);
+  if (fd < 0) return;
+  s_iree_uk_benchmark_perf_events[s_iree_uk_benchmark_perf_event_count++] =
+      (iree_uk_benchmark_perf_event_t){
+          .name = name, .weight = weight, .fd = fd};
+}
+
+static uint64_t iree_uk_benchmark_hw_cache_config(uint64_t cache) {
+  return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+         (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+}
+
+// Opens the raw events counting FP operations, when this CPU has them.
+static void iree_uk_benchmark_open_fp_ops_perf_events(void) {
+#if defined(IREE_ARCH_X86_64)
+  // Intel FP_ARITH_INST_RETIRED (event 0xC7), one umask per vector width,
+  // each counting FMAs twice. AMD has no equivalent with the same encoding.
+  unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+  __cpuid(0, eax, ebx, ecx, edx);
+  bool is_intel = ebx == 0x756e6547 && edx == 0x49656e69 && ecx == 0x6c65746e;
+  if (!is_intel) return;
+  iree_uk_benchmark_open_perf_event("fp_ops", 1, PERF_TYPE_RAW, 0x02c7);
+  iree_uk_benchmark_open_perf_event("fp_ops", 4, PERF_TYPE_RAW, 0x08c7);
+  iree_uk_benchmark_open_perf_event("fp_ops", 8, PERF_TYPE_RAW, 0x20c7);
+  iree_uk_benchmark_open_perf_event("fp_ops", 16, PERF_TYPE_RAW, 0x80c7);
+#elif defined(IREE_ARCH_ARM_64)
+  // FP_FIXED_OPS_SPEC, counting the FP operations of scalar and Advanced SIMD
+  // instructions. Common event from Armv8.7/Armv9.2, missing on older cores.
+  iree_uk_benchmark_open_perf_event("fp_ops", 1, PERF_TYPE_RAW, 0x80c1);
+#endif  // defined(IREE_ARCH_ARM_64)
+}
+
+static void iree_uk_benchmark_open_perf_events(void) {
+  iree_uk_benchmark_open_perf_event("cycles", 1, PERF_TYPE_HARDWARE,
+                                    PERF_COUNT_HW_CPU_CYCLES);
+  iree_uk_benchmark_open_perf_event("instructions", 1, PERF_TYPE_HARDWARE,
+                                    PERF_COUNT_HW_INSTRUCTIONS);
+  iree_uk_benchmark_open_perf_event(
+      "L1D_misses", 1, PERF_TYPE_HW_CACHE,
+      iree_uk_benchmark_hw_cache_config(PERF_COUNT_HW_CACHE_L1D));
+  iree_uk_benchmark_open_perf_event(
+      "LLC_misses", 1, PERF_TYPE_HW_CACHE,
+      iree_uk_benchmark_hw_cache_config(PERF_COUNT_HW_CACHE_LL));
+  iree_uk_benchmark_open_fp_ops_perf_events();
+  if (!s_iree_uk_benchmark_perf_event_count) {
+    fprintf(stderr,
+            "--perf_counters: perf_event_open failed (%s), reporting no "
+            "counters. Check /proc/sys/kernel/perf_event_paranoid.\n",
+            strerror(errno));
+  }
+}
+
+static void iree_uk_benchmark_close_perf_events(void) {
+  for (int i = 0; i < s_iree_uk_benchmark_perf_event_count; ++i) {
+    close(s_iree_uk_benchmark_perf_events[i].fd);
+  }
+  s_iree_uk_benchmark_perf_event_count = 0;
+}
+
+static void iree_uk_benchmark_enable_perf_events(void) {
+  for (int i = 0; i < s_iree_uk_benchmark_perf_event_count; ++i) {
+    int fd = s_iree_uk_benchmark_perf_events[i].fd;
+    ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+    ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+  }
+}
+
+static void iree_uk_benchmark_disable_perf_events(void) {
+  for (int i = 0; i < s_iree_uk_benchmark_perf_event_count; ++i) {
+    ioctl(s_iree_uk_benchmark_perf_events[i].fd, PERF_EVENT_IOC_DISABLE, 0);
+  }
+}
+
+// Returns the count of event |i|, scaled up if it was multiplexed.
+static double iree_uk_benchmark_read_perf_event(int i) {
+  uint64_t values[3] = {0};  // value, time_enabled, time_running.
+  if (read(s_iree_uk_benchmark_perf_events[i].fd, values, sizeof values) !=
+          sizeof values ||
+      !values[2]) {
+    return 0;
+  }
+  return (double)values[0] * ((double)values[1] / (double)values[2]);
+}
+
+#else
+
+static void iree_uk_benchmark_open_perf_events(void) {
+  fprintf(stderr, "--perf_counters: only supported on Linux and Android.\n");
+}
+static void iree_uk_benchmark_close_perf_events(void) {}
+static void iree_uk_benchmark_enable_perf_events(void) {}
+static void iree_uk_benchmark_disable_perf_events(void) {}
+static double iree_uk_benchmark_read_perf_event(int i) { return 0; }
+
+#endif  // defined(IREE_UK_BENCHMARK_HAVE_PERF_EVENT)
+
+// Reports the counts of all events, summed by name, per iteration.
+static void iree_uk_benchmark_report_perf_events(
+    iree_benchmark_state_t* benchmark_state) {
+  double cycles = 0, instructions = 0;
+  for (int i = 0; i < s_iree_uk_benchmark_perf_event_count; ++i) {
+    const char* name = s_iree_uk_benchmark_perf_events[i].name;
+    // Only the first event of each name reports, summing all the others.
+    bool is_first = true;
+    for (int j = 0; j < i; ++j) {
+      if (!strcmp(s_iree_uk_benchmark_perf_events[j].name, name)) {
+        is_first = false;
+      }
+    }
+    if (!is_first) continue;
+    double total = 0;
+    for (int j = i; j < s_iree_uk_benchmark_perf_event_count; ++j) {
+      if (strcmp(s_iree_uk_benchmark_perf_events[j].name, name)) continue;
+      total += s_iree_uk_benchmark_perf_events[j].weight *
+               iree_uk_benchmark_read_perf_event(j);
+    }
+    if (!strcmp(name, "cycles")) cycles = total;
+    if (!strcmp(name, "instructions")) instructions = total;
+    iree_benchmark_set_counter(benchmark_state, name, total,
+                               IREE_BENCHMARK_COUNTER_FLAG_AVERAGE_ITERATIONS);
+  }
+  if (cycles > 0 && instructions > 0) {
+    iree_benchmark_set_counter(benchmark_state, "IPC", instructions / cycles,
+                               IREE_BENCHMARK_COUNTER_FLAG_NONE);
+  }
+}
+
+bool iree_uk_benchmark_keep_running(iree_benchmark_state_t* benchmark_state,
+                                    uint64_t batch_count) {
+  if (!s_iree_uk_benchmark_perf_event_count) {
+    return iree_benchmark_keep_running(benchmark_state, batch_count);
+  }
+  if (!s_iree_uk_benchmark_perf_events_enabled) {
+    iree_uk_benchmark_enable_perf_events();
+    s_iree_uk_benchmark_perf_events_enabled = true;
+  }
+  if (iree_benchmark_keep_running(benchmark_state, batch_count)) {
+    return true;
+  }
+  iree_uk_benchmark_disable_perf_events();
+  s_iree_uk_benchmark_perf_events_enabled = false;
+  iree_uk_benchmark_report_perf_events(benchmark_state);
+  return false;
+}
+
+//===----------------------------------------------------------------------===//
+// Registration and static allocations
+//===----------------------------------------------------------------------===//
+
 static int s_iree_uk_benchmark_static_alloc_count;
 static int s_iree_uk_benchmark_static_alloc_max;
 static void** s_iree_uk_benchmark_static_alloc_ptrs;
@@ -60,10 +278,14 @@ void iree_uk_benchmark_initialize(int* argc, char** argv) {
       malloc(s_iree_uk_benchmark_static_alloc_max * sizeof(void*));
 
   iree_benchmark_initialize(argc, argv);
+  if (FLAG_perf_counters) {
+    iree_uk_benchmark_open_perf_events();
+  }
 }
 
 void iree_uk_benchmark_run_and_cleanup(void) {
   iree_benchmark_run_specified();
+  iree_uk_benchmark_close_perf_events();
   for (int i = 0; i < s_iree_uk_benchmark_static_alloc_count; ++i) {
     free(s_iree_uk_benchmark_static_alloc_ptrs[i]);
   }
@@ -22,6 +22,12 @@ void iree_uk_benchmark_register(
     const void* params, size_t params_size, const char* cpu_features);
 void iree_uk_benchmark_run_and_cleanup(void);
 
+// Same as iree_benchmark_keep_running, but with --perf_counters, also counts
+// hardware events over the benchmark loop, reporting them when it ends. Used
+// by benchmark payload funcs for their step loop.
+bool iree_uk_benchmark_keep_running(iree_benchmark_state_t* benchmark_state,
+                                    uint64_t batch_count);
+
 // Like malloc, but any buffers allocated through this are freed by
 // iree_uk_benchmark_run_and_cleanup. Used during benchmark registration to
 // allocate buffers that will be accessed when the benchmark is run.
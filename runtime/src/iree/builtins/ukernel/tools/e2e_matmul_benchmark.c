@@ -352,7 +352,7 @@ static iree_status_t iree_uk_benchmark_e2e_matmul(
   // The benchmark loop.
   int64_t batch_count = 1;
   int64_t total_iterations = 0;
-  while (iree_benchmark_keep_running(benchmark_state, batch_count)) {
+  while (iree_uk_benchmark_keep_running(benchmark_state, batch_count)) {
     for (int i = 0; i < batch_count; ++i) {
       iree_uk_e2e_matmul(&pack_lhs_params, &pack_rhs_params, &pack_out_params,
                          &mmt4d_params, &unpack_out_params);
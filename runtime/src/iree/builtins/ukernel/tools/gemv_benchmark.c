@@ -0,0 +1,113 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <stdio.h>
+
+#include "iree/base/api.h"
+#include "iree/base/internal/flags.h"
+#include "iree/builtins/ukernel/api.h"
+#include "iree/builtins/ukernel/gemv_internal.h"
+#include "iree/builtins/ukernel/tools/benchmark.h"
+#include "iree/builtins/ukernel/tools/memcpy_benchmark.h"
+#include "iree/builtins/ukernel/tools/util.h"
+
+IREE_FLAG(int32_t, n_size, 4096,
+          "Number of output elements (unpacked N). Rounded up to N0.");
+IREE_FLAG(int32_t, k_size, 4096,
+          "Number of LHS elements (unpacked K). Rounded up to K0.");
+
+static iree_status_t iree_uk_benchmark_gemv(
+    const iree_benchmark_def_t* benchmark_def,
+    iree_benchmark_state_t* benchmark_state) {
+  const iree_uk_benchmark_user_data_t* user_data = benchmark_def->user_data;
+  const iree_uk_gemv_params_t* src_params = iree_uk_benchmark_params(user_data);
+  iree_uk_gemv_params_t params;
+  memcpy(&params, src_params, sizeof params);
+  params.cpu_data = iree_uk_benchmark_cpu_data(user_data);
+  iree_uk_gemv_type_t type = iree_uk_gemv_type(params.flags);
+  iree_uk_type_t in_type = iree_uk_gemv_lhs_type(type);
+  iree_uk_type_t out_type = iree_uk_gemv_out_type(type);
+  params.N = (FLAG_n_size + params.N0 - 1) / params.N0;
+  params.K = (FLAG_k_size + params.K0 - 1) / params.K0;
+  params.lhs_stride0 = params.K0;
+  params.rhs_stride0 = params.K * params.N0 * params.K0;
+  params.out_stride0 = params.N0;
+  iree_uk_index_t lhs_buffer_size =
+      iree_uk_2d_buffer_length(in_type, params.K, params.lhs_stride0);
+  iree_uk_index_t rhs_buffer_size =
+      iree_uk_2d_buffer_length(in_type, params.N, params.rhs_stride0);
+  iree_uk_index_t out_buffer_size =
+      iree_uk_2d_buffer_length(out_type, params.N, params.out_stride0);
+  void* lhs_buffer = malloc(lhs_buffer_size);
+  void* rhs_buffer = malloc(rhs_buffer_size);
+  void* out_buffer = malloc(out_buffer_size);
+  iree_uk_random_engine_t* engine = iree_uk_benchmark_random_engine(user_data);
+  iree_uk_write_random_buffer(lhs_buffer, lhs_buffer_size, in_type, engine);
+  iree_uk_write_random_buffer(rhs_buffer, rhs_buffer_size, in_type, engine);
+  iree_uk_write_random_buffer(out_buffer, out_buffer_size, out_type, engine);
+  params.lhs_buffer = lhs_buffer;
+  params.rhs_buffer = rhs_buffer;
+  params.out_buffer = out_buffer;
+  int64_t total_iterations = 0;
+  int64_t batch_count = 1;
+  while (iree_uk_benchmark_keep_running(benchmark_state, batch_count)) {
+    for (int i = 0; i < batch_count; ++i) {
+      iree_uk_gemv_p(&params);
+    }
+    total_iterations += batch_count;
+    batch_count *= 2;
+  }
+  // Report bytes per second, as gemv is meant to be memory-bound: the RHS is
+  // read exactly once and dominates the traffic. Compare with the memcpy
+  // benchmark of the same working set size.
+  iree_benchmark_set_bytes_processed(
+      benchmark_state,
+      total_iterations *
+          (lhs_buffer_size + rhs_buffer_size + out_buffer_size));
+  free(lhs_buffer);
+  free(rhs_buffer);
+  free(out_buffer);
+  return iree_ok_status();
+}
+
+static void iree_uk_benchmark_register_gemv(iree_uk_uint32_t flags, int N0,
+                                            int K0, const char* cpu_features) {
+  char type_str[32];
+  iree_uk_type_triple_str(type_str, sizeof type_str, iree_uk_gemv_type(flags));
+  iree_uk_gemv_params_t params = {.flags = flags, .N0 = N0, .K0 = K0};
+  char name[128];
+  snprintf(name, sizeof name, "gemv_%s_tile_%dx%d_n_%d_k_%d", type_str, N0, K0,
+           FLAG_n_size, FLAG_k_size);
+  iree_uk_benchmark_register(name, iree_uk_benchmark_gemv, &params,
+                             sizeof params, cpu_features);
+}
+
+int main(int argc, char** argv) {
+  iree_flags_set_usage("gemv_benchmark", "");
+
+  iree_flags_parse_checked(IREE_FLAGS_PARSE_MODE_UNDEFINED_OK, &argc, &argv);
+  iree_uk_benchmark_initialize(&argc, argv);
+
+  // The memcpy benchmark over the size of the f32 RHS is the bandwidth roof
+  // that the f32 gemv benchmarks should approach.
+  iree_uk_benchmark_register_memcpy((int64_t)FLAG_n_size * FLAG_k_size *
+                                    sizeof(float));
+
+  iree_uk_benchmark_register_gemv(IREE_UK_FLAG_GEMV_TYPE_F32F32F32, 8, 1, "");
+  iree_uk_benchmark_register_gemv(IREE_UK_FLAG_GEMV_TYPE_F16F16F32, 8, 1, "");
+#if defined(IREE_ARCH_X86_64)
+  iree_uk_benchmark_register_gemv(IREE_UK_FLAG_GEMV_TYPE_F32F32F32, 8, 1,
+                                  "avx2_fma");
+  iree_uk_benchmark_register_gemv(IREE_UK_FLAG_GEMV_TYPE_F16F16F32, 8, 1,
+                                  "avx2_fma");
+  iree_uk_benchmark_register_gemv(IREE_UK_FLAG_GEMV_TYPE_F32F32F32, 16, 1,
+                                  "avx512_base");
+  iree_uk_benchmark_register_gemv(IREE_UK_FLAG_GEMV_TYPE_F16F16F32, 16, 1,
+                                  "avx512_base");
+#endif  // defined(IREE_ARCH_X86_64)
+
+  iree_uk_benchmark_run_and_cleanup();
+}
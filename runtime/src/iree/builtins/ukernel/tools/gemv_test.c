@@ -0,0 +1,193 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/base/api.h"
+#include "iree/base/internal/math.h"
+#include "iree/builtins/ukernel/api.h"
+#include "iree/builtins/ukernel/exported_bits.h"
+#include "iree/builtins/ukernel/gemv_internal.h"
+#include "iree/builtins/ukernel/tools/test.h"
+#include "iree/builtins/ukernel/tools/util.h"
+
+static float iree_gemv_reference_load(const void* buffer, iree_uk_type_t type,
+                                      iree_uk_index_t index) {
+  switch (type) {
+    case IREE_UK_TYPE_FLOAT_32:
+      return ((const float*)buffer)[index];
+    case IREE_UK_TYPE_FLOAT_16:
+      return iree_math_f16_to_f32(((const uint16_t*)buffer)[index]);
+    case IREE_UK_TYPE_BFLOAT_16:
+      return iree_math_bf16_to_f32(((const uint16_t*)buffer)[index]);
+    default:
+      IREE_UK_ASSERT(false && "unhandled type");
+      return 0.f;
+  }
+}
+
+static void iree_gemv_reference(const iree_uk_gemv_params_t* params) {
+  iree_uk_gemv_type_t type = iree_uk_gemv_type(params->flags);
+  iree_uk_type_t in_type = iree_uk_gemv_lhs_type(type);
+  for (iree_uk_index_t j = 0; j < params->N; ++j) {
+    for (iree_uk_index_t j0 = 0; j0 < params->N0; ++j0) {
+      float* out_ptr = (float*)params->out_buffer + params->out_offset +
+                       j * params->out_stride0 + j0;
+      float acc = params->flags & IREE_UK_FLAG_GEMV_ACCUMULATE ? *out_ptr : 0.f;
+      for (iree_uk_index_t k = 0; k < params->K; ++k) {
+        for (iree_uk_index_t k0 = 0; k0 < params->K0; ++k0) {
+          float lhs = iree_gemv_reference_load(
+              params->lhs_buffer, in_type,
+              params->lhs_offset + k * params->lhs_stride0 + k0);
+          float rhs = iree_gemv_reference_load(
+              params->rhs_buffer, in_type,
+              params->rhs_offset + j * params->rhs_stride0 +
+                  k * params->N0 * params->K0 + j0 * params->K0 + k0);
+          acc += lhs * rhs;
+        }
+      }
+      *out_ptr = acc;
+    }
+  }
+}
+
+static void iree_uk_test_gemv_for_shape_params(
+    iree_uk_test_t* test, const iree_uk_gemv_params_t* src_params) {
+  iree_uk_gemv_params_t params;
+  memcpy(&params, src_params, sizeof params);
+  iree_uk_gemv_type_t type = iree_uk_gemv_type(params.flags);
+  iree_uk_type_t in_type = iree_uk_gemv_lhs_type(type);
+  iree_uk_type_t out_type = iree_uk_gemv_out_type(type);
+  iree_uk_random_engine_t* engine = iree_uk_test_random_engine(test);
+  // Randomly make strides either tight or not to exercise all cases.
+  params.lhs_stride0 = params.K0 + iree_uk_random_engine_get_0_1(engine);
+  params.rhs_stride0 =
+      params.K * params.N0 * params.K0 + iree_uk_random_engine_get_0_1(engine);
+  params.out_stride0 = params.N0 + iree_uk_random_engine_get_0_1(engine);
+  iree_uk_index_t lhs_buffer_size =
+      iree_uk_2d_buffer_length(in_type, params.K, params.lhs_stride0);
+  iree_uk_index_t rhs_buffer_size =
+      iree_uk_2d_buffer_length(in_type, params.N, params.rhs_stride0);
+  iree_uk_index_t out_buffer_size =
+      iree_uk_2d_buffer_length(out_type, params.N, params.out_stride0);
+  void* lhs_buffer = malloc(lhs_buffer_size);
+  void* rhs_buffer = malloc(rhs_buffer_size);
+  void* init_out_buffer = malloc(out_buffer_size);
+  iree_uk_write_random_buffer(lhs_buffer, lhs_buffer_size, in_type, engine);
+  iree_uk_write_random_buffer(rhs_buffer, rhs_buffer_size, in_type, engine);
+  iree_uk_write_random_buffer(init_out_buffer, out_buffer_size, out_type,
+                              engine);
+  int in_elem_size = iree_uk_type_size(in_type);
+  params.lhs_offset = iree_uk_random_engine_get_0_1(engine);
+  params.rhs_offset = iree_uk_random_engine_get_0_1(engine);
+  params.out_offset = iree_uk_random_engine_get_0_1(engine);
+  params.lhs_buffer =
+      (const char*)lhs_buffer - params.lhs_offset * in_elem_size;
+  params.rhs_buffer =
+      (const char*)rhs_buffer - params.rhs_offset * in_elem_size;
+
+  iree_uk_gemv_params_t reference_params;
+  memcpy(&reference_params, &params, sizeof params);
+  void* reference_out_buffer = malloc(out_buffer_size);
+  memcpy(reference_out_buffer, init_out_buffer, out_buffer_size);
+  reference_params.out_buffer =
+      (float*)reference_out_buffer - params.out_offset;
+
+  iree_uk_gemv_params_t actual_params;
+  memcpy(&actual_params, &params, sizeof params);
+  void* actual_out_buffer = malloc(out_buffer_size);
+  memcpy(actual_out_buffer, init_out_buffer, out_buffer_size);
+  actual_params.out_buffer = (float*)actual_out_buffer - params.out_offset;
+
+  iree_gemv_reference(&reference_params);
+  iree_uk_gemv_p(&actual_params);
+
+  // As in mmt4d_test, exact comparisons rely on all test values being small
+  // integers so that the different accumulation orders are all exact.
+  bool fail = memcmp(actual_out_buffer, reference_out_buffer, out_buffer_size);
+  if (fail) {
+    IREE_UK_TEST_FAIL(test);
+  }
+
+  free(init_out_buffer);
+  free(reference_out_buffer);
+  free(actual_out_buffer);
+  free(lhs_buffer);
+  free(rhs_buffer);
+}
+
+static void iree_uk_test_gemv_for_tile_params(iree_uk_test_t* test,
+                                              const void* src_params) {
+  typedef struct shape_nk_t {
+    int n, k;
+  } shape_nk_t;
+  // The values of N cover full and partial groups of IREE_UK_GEMV_MAX_PANELS
+  // panels, and those of K both parities of the unrolled loops.
+  const shape_nk_t shapes[] = {
+      // Degenerate cases.
+      {0, 1},
+      {1, 0},
+      {7, 0},
+      // Non-degenerate cases.
+      {1, 1},
+      {1, 2},
+      {2, 3},
+      {3, 8},
+      {4, 1},
+      {5, 17},
+      {8, 16},
+      {9, 33},
+  };
+  for (int i = 0; i < IREE_ARRAYSIZE(shapes); ++i) {
+    iree_uk_gemv_params_t params;
+    memcpy(&params, src_params, sizeof params);
+    params.cpu_data = iree_uk_test_cpu_data(test);
+    params.N = shapes[i].n;
+    params.K = shapes[i].k;
+    for (int accumulate = 0; accumulate <= 1; ++accumulate) {
+      if (accumulate) params.flags |= IREE_UK_FLAG_GEMV_ACCUMULATE;
+      iree_uk_test_gemv_for_shape_params(test, &params);
+    }
+  }
+}
+
+static void iree_uk_test_gemv(iree_uk_uint32_t flags, int N0, int K0,
+                              const char* cpu_features) {
+  char types_str[32];
+  iree_uk_type_triple_str(types_str, sizeof types_str,
+                          iree_uk_gemv_type(flags));
+  iree_uk_gemv_params_t params = {.flags = flags, .N0 = N0, .K0 = K0};
+  char test_label_str[256];
+  snprintf(test_label_str, sizeof test_label_str, "types:%s tile:%dx%d",
+           types_str, N0, K0);
+  iree_uk_test(test_label_str, iree_uk_test_gemv_for_tile_params, &params,
+               cpu_features);
+}
+
+int main(int argc, char** argv) {
+  // Generic tests, not matching any arch specialization by design.
+  iree_uk_test_gemv(IREE_UK_FLAG_GEMV_TYPE_F32F32F32, 3, 5, "");
+  iree_uk_test_gemv(IREE_UK_FLAG_GEMV_TYPE_F16F16F32, 3, 5, "");
+  iree_uk_test_gemv(IREE_UK_FLAG_GEMV_TYPE_BF16BF16F32, 3, 5, "");
+  iree_uk_test_gemv(IREE_UK_FLAG_GEMV_TYPE_F32F32F32, 4, 2, "");
+
+#if defined(IREE_ARCH_ARM_64)
+
+  iree_uk_test_gemv(IREE_UK_FLAG_GEMV_TYPE_F32F32F32, 8, 1, "");
+  iree_uk_test_gemv(IREE_UK_FLAG_GEMV_TYPE_F16F16F32, 8, 1, "");
+
+#elif defined(IREE_ARCH_X86_64)
+
+  iree_uk_test_gemv(IREE_UK_FLAG_GEMV_TYPE_F32F32F32, 8, 1, "avx2_fma");
+  iree_uk_test_gemv(IREE_UK_FLAG_GEMV_TYPE_F16F16F32, 8, 1, "avx2_fma");
+  iree_uk_test_gemv(IREE_UK_FLAG_GEMV_TYPE_BF16BF16F32, 8, 1, "avx2_fma");
+  iree_uk_test_gemv(IREE_UK_FLAG_GEMV_TYPE_F32F32F32, 16, 1, "avx512_base");
+  iree_uk_test_gemv(IREE_UK_FLAG_GEMV_TYPE_F16F16F32, 16, 1, "avx512_base");
+  iree_uk_test_gemv(IREE_UK_FLAG_GEMV_TYPE_BF16BF16F32, 16, 1,
+                    "avx512_base");
+
+#endif  // defined(IREE_ARCH_X86_64)
+
+  return iree_uk_test_exit_status();
+}
@@ -9,6 +9,18 @@
 
 #include <stdint.h>
 
+#include "iree/builtins/ukernel/tools/thread_pool.h"
+
 void iree_uk_benchmark_register_memcpy(int64_t working_set_size);
 
+// Measures the memcpy bandwidth with a working set of `working_set_size` bytes
+// split evenly across the workers of `pool` (the calling thread if NULL).
+// Stores bytes per second in `out_bytes_per_second`, counting both the bytes
+// read and the bytes written, so that the result is comparable to the memory
+// traffic of a kernel reading its inputs and writing its outputs. Used as the
+// bandwidth roof when reporting how close a kernel gets to being memory-bound.
+iree_status_t iree_uk_benchmark_measure_memcpy_bandwidth(
+    int64_t working_set_size, iree_uk_benchmark_thread_pool_t* pool,
+    double* out_bytes_per_second);
+
 #endif  // IREE_BUILTINS_UKERNEL_TOOLS_MEMCPY_BENCHMARK_H_
@@ -0,0 +1,218 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// Times the mmt4d tile functions available on the host CPU and writes the
+// fastest tile sizes for each element type and M0 to a tile sizes cache, read
+// by the compiler (--iree-llvmcpu-tile-sizes-cache=) and the VMVX module
+// (IREE_VMVX_TILE_SIZES_CACHE environment variable).
+//
+// Only VMVX reads the cache at runtime, as it queries its tile sizes then.
+// llvm-cpu executables have their tile sizes fixed when they are compiled, so
+// the cache only affects them through the compiler flag, and changing the
+// cache afterwards requires recompiling them.
+//
+// CPUs with the same ISA features may still prefer different tiles because of
+// their cache sizes and number of execution ports, which is what the built-in
+// tile size choices can't account for.
+//
+// The cache is a text file with one line per tile:
+//   <arch> <features> <lhs><rhs><out> <M0> <N0> <K0> <Gop/s>
+// e.g.
+//   x86_64 fma,f16c,avx2 f32f32f32 8 8 1 61.20
+// where <features> are the LLVM names of the CPU features that the tile
+// function requires, comma-separated, or "-" if it requires none. Consumers
+// must only use tiles whose features their target CPU has: the cache may be
+// used to compile for other CPUs of the same architecture. The types are
+// spelled as in the IREE_UK_FLAG_MMT4D_TYPE_* names, and the last column is
+// the measured throughput that consumers compare tiles by. Lines starting
+// with '#' are comments.
+
+#include <stdio.h>
+
+#include "iree/base/api.h"
+#include "iree/base/internal/cpu.h"
+#include "iree/base/internal/flags.h"
+#include "iree/builtins/ukernel/api.h"
+#include "iree/builtins/ukernel/exported_bits.h"
+#include "iree/builtins/ukernel/mmt4d_internal.h"
+#include "iree/builtins/ukernel/tools/util.h"
+#include "iree/schemas/cpu_data.h"
+
+IREE_FLAG(string, output, "",
+          "Path of the tile sizes cache file to write. Prints to stdout if "
+          "empty.");
+IREE_FLAG(int32_t, matmul_size, 512,
+          "M, N and K of the matmul timed for each tile, in elements. Rounded "
+          "up to whole tiles.");
+IREE_FLAG(double, min_seconds, 0.1,
+          "Minimum time spent timing each tile, in seconds.");
+
+// Candidate values of each tile dimension. Only the combinations that have an
+// architecture-specific tile function on the host, that is the enabled
+// entries of the mmt4d_*_tiles.inl table for its architecture, are timed.
+static const int iree_uk_autotune_m0_values[] = {1, 2, 4, 8, 16, 32};
+static const int iree_uk_autotune_n0_values[] = {1,  2,  4,  8,
+                                                 16, 32, 64, 128};
+static const int iree_uk_autotune_k0_values[] = {1, 2, 4, 8, 16};
+
+// Returns the throughput of mmt4d on the host with the tile sizes in |params|,
+// in operations (multiplications and additions) per nanosecond.
+static double iree_uk_autotune_time_tile(iree_uk_mmt4d_params_t* params,
+                                         iree_uk_random_engine_t* engine) {
+  iree_uk_mmt4d_type_t mmt4d_type = iree_uk_mmt4d_type(params->flags);
+  iree_uk_type_t lhs_type = iree_uk_mmt4d_lhs_type(mmt4d_type);
+  iree_uk_type_t rhs_type = iree_uk_mmt4d_rhs_type(mmt4d_type);
+  iree_uk_type_t out_type = iree_uk_mmt4d_out_type(mmt4d_type);
+  int size = FLAG_matmul_size;
+  params->M = (size + params->M0 - 1) / params->M0;
+  params->N = (size + params->N0 - 1) / params->N0;
+  params->K = (size + params->K0 - 1) / params->K0;
+  params->lhs_stride0 = params->K * params->M0 * params->K0;
+  params->rhs_stride0 = params->K * params->N0 * params->K0;
+  params->out_stride0 = params->N * params->M0 * params->N0;
+  iree_uk_index_t lhs_buffer_size =
+      iree_uk_2d_buffer_length(lhs_type, params->M, params->lhs_stride0);
+  iree_uk_index_t rhs_buffer_size =
+      iree_uk_2d_buffer_length(rhs_type, params->N, params->rhs_stride0);
+  iree_uk_index_t out_buffer_size =
+      iree_uk_2d_buffer_length(out_type, params->M, params->out_stride0);
+  void* lhs_buffer = malloc(lhs_buffer_size);
+  void* rhs_buffer = malloc(rhs_buffer_size);
+  void* out_buffer = malloc(out_buffer_size);
+  iree_uk_write_random_buffer(lhs_buffer, lhs_buffer_size, lhs_type, engine);
+  iree_uk_write_random_buffer(rhs_buffer, rhs_buffer_size, rhs_type, engine);
+  iree_uk_write_random_buffer(out_buffer, out_buffer_size, out_type, engine);
+  params->lhs_buffer = lhs_buffer;
+  params->rhs_buffer = rhs_buffer;
+  params->out_buffer = out_buffer;
+
+  // Warm up caches and page in the buffers before timing.
+  iree_uk_mmt4d_p(params);
+  int64_t run_count = 0;
+  iree_time_t start_ns = iree_time_now();
+  iree_time_t min_duration_ns = (iree_time_t)(FLAG_min_seconds * 1e9);
+  iree_time_t elapsed_ns = 0;
+  do {
+    iree_uk_mmt4d_p(params);
+    ++run_count;
+    elapsed_ns = iree_time_now() - start_ns;
+  } while (elapsed_ns < min_duration_ns);
+
+  free(lhs_buffer);
+  free(rhs_buffer);
+  free(out_buffer);
+  double ops_per_run = 2.0 * params->M * params->M0 * params->N * params->N0 *
+                       params->K * params->K0;
+  return ops_per_run * run_count / (elapsed_ns ? elapsed_ns : 1);
+}
+
+// Returns true if there is an architecture-specific tile function for the tile
+// sizes and types in |params|, with its CPU data.
+static bool iree_uk_autotune_have_tile_function(
+    const iree_uk_mmt4d_params_t* params) {
+  return iree_uk_mmt4d_info_p(params) &
+         IREE_UK_FLAG_MMT4D_INFO_HAVE_ARCHITECTURE_SPECIFIC_TILE_FUNCTION;
+}
+
+// Writes to |out_features| the LLVM names of the host CPU features that the
+// tile function for |params| requires. Found by clearing host feature bits one
+// at a time and keeping them cleared as long as the tile function remains
+// available.
+static void iree_uk_autotune_required_features(
+    const iree_uk_mmt4d_params_t* params, char* out_features,
+    int out_features_length) {
+  iree_uk_uint64_t cpu_data[IREE_CPU_DATA_FIELD_COUNT];
+  memcpy(cpu_data, params->cpu_data, sizeof cpu_data);
+  iree_uk_mmt4d_params_t probe_params = *params;
+  probe_params.cpu_data = cpu_data;
+  for (int i = 0; i < IREE_CPU_DATA_FIELD_COUNT; ++i) {
+    for (int bit_pos = 0; bit_pos < 64; ++bit_pos) {
+      iree_uk_uint64_t bit = 1ull << bit_pos;
+      if (!(cpu_data[i] & bit)) continue;
+      cpu_data[i] &= ~bit;
+      if (!iree_uk_autotune_have_tile_function(&probe_params)) {
+        cpu_data[i] |= bit;
+      }
+    }
+  }
+  if (!iree_uk_cpu_features_str(out_features, out_features_length,
+                                cpu_data)) {
+    snprintf(out_features, out_features_length, "-");
+  }
+}
+
+// Times all the available tiles for the element types in |type_flags|, and
+// writes the fastest one for each M0 to |file|.
+static void iree_uk_autotune_type(iree_uk_uint32_t type_flags,
+                                  const iree_uk_uint64_t* cpu_data,
+                                  iree_uk_random_engine_t* engine,
+                                  FILE* file) {
+  char types_str[32];
+  iree_uk_type_triple_str(types_str, sizeof types_str,
+                          iree_uk_mmt4d_type(type_flags));
+  for (int m = 0; m < IREE_ARRAYSIZE(iree_uk_autotune_m0_values); ++m) {
+    iree_uk_mmt4d_params_t best_params = {0};
+    double best_rate = 0;
+    for (int n = 0; n < IREE_ARRAYSIZE(iree_uk_autotune_n0_values); ++n) {
+      for (int k = 0; k < IREE_ARRAYSIZE(iree_uk_autotune_k0_values); ++k) {
+        iree_uk_mmt4d_params_t params = {
+            .M0 = iree_uk_autotune_m0_values[m],
+            .N0 = iree_uk_autotune_n0_values[n],
+            .K0 = iree_uk_autotune_k0_values[k],
+            .flags = type_flags,
+            .cpu_data = cpu_data,
+        };
+        if (!iree_uk_autotune_have_tile_function(&params)) continue;
+        double rate = iree_uk_autotune_time_tile(&params, engine);
+        if (rate > best_rate) {
+          best_rate = rate;
+          best_params = params;
+        }
+      }
+    }
+    if (best_rate > 0) {
+      char features_str[256];
+      iree_uk_autotune_required_features(&best_params, features_str,
+                                         sizeof features_str);
+      fprintf(file, "%s %s %s %d %d %d %.2f\n", IREE_ARCH, features_str,
+              types_str, best_params.M0, best_params.N0, best_params.K0,
+              best_rate);
+      fflush(file);
+    }
+  }
+}
+
+int main(int argc, char** argv) {
+  iree_flags_set_usage(
+      "mmt4d_autotune",
+      "Times the mmt4d tile functions available on this CPU and writes the\n"
+      "fastest tile sizes for each element type to a tile sizes cache.\n");
+  iree_flags_parse_checked(IREE_FLAGS_PARSE_MODE_DEFAULT, &argc, &argv);
+  if (FLAG_matmul_size <= 0) {
+    fprintf(stderr, "--matmul_size must be positive\n");
+    return EXIT_FAILURE;
+  }
+  FILE* file = stdout;
+  if (FLAG_output[0]) {
+    file = fopen(FLAG_output, "w");
+    if (!file) {
+      fprintf(stderr, "failed to open %s for writing\n", FLAG_output);
+      return EXIT_FAILURE;
+    }
+  }
+  iree_uk_initialize_cpu_once();
+  const iree_uk_uint64_t* cpu_data =
+      (const iree_uk_uint64_t*)iree_cpu_data_fields();
+  iree_uk_random_engine_t engine = iree_uk_random_engine_init();
+  fprintf(file, "# Tile sizes cache written by mmt4d_autotune.\n");
+  fprintf(file, "# <arch> <features> <types> <M0> <N0> <K0> <Gop/s>\n");
+  for (iree_uk_uint32_t type_flags = IREE_UK_FLAG_MMT4D_TYPE_NONE + 1;
+       type_flags < IREE_UK_FLAG_MMT4D_TYPE_END; ++type_flags) {
+    iree_uk_autotune_type(type_flags, cpu_data, &engine, file);
+  }
+  if (file != stdout) fclose(file);
+  return EXIT_SUCCESS;
+}
@@ -13,7 +13,10 @@
 #include "iree/builtins/ukernel/mmt4d.h"
 #include "iree/builtins/ukernel/mmt4d_internal.h"
 #include "iree/builtins/ukernel/tools/benchmark.h"
+#include "iree/builtins/ukernel/tools/memcpy_benchmark.h"
+#include "iree/builtins/ukernel/tools/thread_pool.h"
 #include "iree/builtins/ukernel/tools/util.h"
+#include "iree/task/api.h"
 
 IREE_FLAG(int32_t, m_size, 1,
           "M-dimension of mmt4d ops. The overall number of rows of the "
@@ -28,6 +31,66 @@ IREE_FLAG(
 IREE_FLAG(bool, accumulate, false,
           "Whether the kernel should accumulate into the existing accumulator "
           "tile values, or zero the accumulator tile.");
+IREE_FLAG(
+    string, shapes, "",
+    "Comma-separated list of MxNxK matmul shapes, in elements, to benchmark\n"
+    "instead of the single shape given by --m_size, --n_size and --k_size.\n"
+    "Each shape is rounded up to whole tiles, and only benchmarked with the\n"
+    "M0 that the compiler would pick for it, e.g. 1 for M=1. `sweep`\n"
+    "selects shapes typical of LLM inference, including M=1 decode GEMVs.");
+IREE_FLAG(
+    int32_t, threads, 1,
+    "Number of threads to run each mmt4d op on, splitting it along N (or M\n"
+    "if N has fewer tiles than there are threads). Threads are pinned as\n"
+    "given by the --task_topology_* flags; 0 uses all the groups of the\n"
+    "topology. With 1, the op runs on the benchmark thread as before.");
+IREE_FLAG(bool, roofline, false,
+          "Measures the memcpy bandwidth once at startup with the same\n"
+          "threads, and labels each benchmark with its arithmetic intensity,\n"
+          "achieved GFLOP/s and GB/s, and how close that gets to the\n"
+          "bandwidth roof.");
+IREE_FLAG(int64_t, roofline_working_set_size, 256 * 1024 * 1024,
+          "Working set size in bytes of the memcpy measuring the bandwidth\n"
+          "roof. Should be well above the last-level cache size.");
+
+// Shapes selected by --shapes=sweep, as {M, N, K} in elements.
+static const int iree_uk_benchmark_mmt4d_sweep_shapes[][3] = {
+    {1, 4096, 4096},     // Decode GEMV, e.g. an attention projection.
+    {1, 11008, 4096},    // Decode GEMV, e.g. an MLP up-projection.
+    {16, 4096, 4096},    // Small-batch decode or speculative decoding.
+    {128, 4096, 4096},   // Prefill chunk.
+    {1024, 1024, 1024},  // Square matmul with high arithmetic intensity.
+};
+
+// Pool running the mmt4d ops when --threads is not 1, NULL otherwise.
+static iree_uk_benchmark_thread_pool_t* iree_uk_benchmark_mmt4d_pool;
+
+// Bandwidth roof in bytes per second when --roofline is set.
+static double iree_uk_benchmark_mmt4d_peak_bytes_per_second;
+
+// Runs the part of the mmt4d op given as `arg` that falls on one thread.
+static void iree_uk_benchmark_mmt4d_slice(void* arg, int thread_index,
+                                          int thread_count) {
+  const iree_uk_mmt4d_params_t* params = arg;
+  iree_uk_mmt4d_params_t slice;
+  memcpy(&slice, params, sizeof slice);
+  // Splitting along N keeps all threads busy on M=1 decode GEMVs, where they
+  // each stream a different part of the rhs.
+  if (params->N >= thread_count) {
+    iree_uk_index_t begin = params->N * thread_index / thread_count;
+    iree_uk_index_t end = params->N * (thread_index + 1) / thread_count;
+    slice.rhs_offset += begin * params->rhs_stride0;
+    slice.out_offset += begin * params->M0 * params->N0;
+    slice.N = end - begin;
+  } else {
+    iree_uk_index_t begin = params->M * thread_index / thread_count;
+    iree_uk_index_t end = params->M * (thread_index + 1) / thread_count;
+    slice.lhs_offset += begin * params->lhs_stride0;
+    slice.out_offset += begin * params->out_stride0;
+    slice.M = end - begin;
+  }
+  if (slice.M && slice.N) iree_uk_mmt4d_p(&slice);
+}
 
 static iree_status_t iree_uk_benchmark_mmt4d(
     const iree_benchmark_def_t* benchmark_def,
@@ -39,9 +102,6 @@ static iree_status_t iree_uk_benchmark_mmt4d(
   memcpy(&params, src_params, sizeof params);
   params.cpu_data = iree_uk_benchmark_cpu_data(user_data);
   if (FLAG_accumulate) params.flags |= IREE_UK_FLAG_MMT4D_ACCUMULATE;
-  params.M = FLAG_m_size;
-  params.N = FLAG_n_size;
-  params.K = FLAG_k_size;
   params.lhs_stride0 = params.K * params.M0 * params.K0;
   params.rhs_stride0 = params.K * params.N0 * params.K0;
   params.out_stride0 = params.N * params.M0 * params.N0;
@@ -69,18 +129,55 @@ static iree_status_t iree_uk_benchmark_mmt4d(
   params.lhs_buffer = lhs_buffer;
   params.rhs_buffer = rhs_buffer;
   params.out_buffer = out_buffer;
+  iree_uk_benchmark_thread_pool_t* pool = iree_uk_benchmark_mmt4d_pool;
   int64_t total_iterations = 0;
   int64_t batch_count = 1;
-  while (iree_benchmark_keep_running(benchmark_state, batch_count)) {
+  iree_time_t start_ns = iree_time_now();
+  while (iree_uk_benchmark_keep_running(benchmark_state, batch_count)) {
     for (int i = 0; i < batch_count; ++i) {
-      iree_uk_mmt4d_p(&params);
+      if (pool) {
+        iree_uk_benchmark_thread_pool_run(pool, iree_uk_benchmark_mmt4d_slice,
+                                          &params);
+      } else {
+        iree_uk_mmt4d_p(&params);
+      }
     }
     total_iterations += batch_count;
     batch_count *= 2;
   }
-  iree_benchmark_set_items_processed(
-      benchmark_state, total_iterations * 2 * params.M * params.N * params.K *
-                           params.M0 * params.N0 * params.K0);
+  iree_duration_t elapsed_ns = iree_time_now() - start_ns;
+  int64_t flops_per_iteration =
+      2 * params.M * params.N * params.K * params.M0 * params.N0 * params.K0;
+  // The minimum memory traffic of one op: reading both operands once, and
+  // writing the accumulator, which is also read when accumulating.
+  int64_t bytes_per_iteration =
+      lhs_buffer_size + rhs_buffer_size +
+      (FLAG_accumulate ? 2 : 1) * out_buffer_size;
+  iree_benchmark_set_items_processed(benchmark_state,
+                                     total_iterations * flops_per_iteration);
+  iree_benchmark_set_bytes_processed(benchmark_state,
+                                     total_iterations * bytes_per_iteration);
+  if (FLAG_roofline && elapsed_ns > 0) {
+    // The bandwidth roof caps the GFLOP/s at intensity * peak bandwidth, so
+    // the fraction of that roof reached is also the fraction of the peak
+    // bandwidth used. Close to it, the op is memory-bound, and a regression
+    // there is about data movement rather than the arithmetic of the tile.
+    // Far from it, nothing is implied: no compute peak is measured, so the op
+    // may be compute-bound or just slow.
+    double seconds = elapsed_ns * 1e-9;
+    double gflops = total_iterations * flops_per_iteration / seconds * 1e-9;
+    double gbytes = total_iterations * bytes_per_iteration / seconds * 1e-9;
+    double peak_gbytes = iree_uk_benchmark_mmt4d_peak_bytes_per_second * 1e-9;
+    double roof_fraction = peak_gbytes > 0 ? gbytes / peak_gbytes : 0;
+    char label[256];
+    snprintf(label, sizeof label,
+             "threads=%d flop/byte=%.2f GFLOP/s=%.1f GB/s=%.1f "
+             "peak_GB/s=%.1f bw_roof=%.0f%%",
+             iree_uk_benchmark_thread_pool_size(pool),
+             (double)flops_per_iteration / bytes_per_iteration, gflops, gbytes,
+             peak_gbytes, 100 * roof_fraction);
+    iree_benchmark_set_label(benchmark_state, label);
+  }
   free(lhs_buffer);
   free(rhs_buffer);
   free(out_buffer);
@@ -88,8 +185,8 @@ static iree_status_t iree_uk_benchmark_mmt4d(
 }
 
 static void iree_uk_benchmark_register_mmt4d_impl(
-    iree_uk_uint32_t flags, int M0, int N0, int K0, const char* cpu_features,
-    const char* code_path_suffix) {
+    iree_uk_uint32_t flags, int M0, int N0, int K0, int M, int N, int K,
+    const char* cpu_features, const char* code_path_suffix) {
   char type_str[32];
   iree_uk_mmt4d_type_t mmt4d_type = iree_uk_mmt4d_type(flags);
   iree_uk_type_triple_str(type_str, sizeof type_str, mmt4d_type);
@@ -99,6 +196,9 @@ static void iree_uk_benchmark_register_mmt4d_impl(
   iree_uk_mmt4d_params_t params = {
       .flags = flags | IREE_UK_FLAG_MMT4D_SKIP_INTERMEDIATE_ROUNDINGS |
                IREE_UK_FLAG_MMT4D_ALLOW_GENERIC_FALLBACK_TILE_FUNCTION,
+      .M = M,
+      .N = N,
+      .K = K,
       .M0 = M0,
       .N0 = N0,
       .K0 = K0};
@@ -106,16 +206,84 @@ static void iree_uk_benchmark_register_mmt4d_impl(
                              sizeof params, cpu_features);
 }
 
+// Registers the given tile on one MxNxK shape given in elements, rounded up to
+// whole tiles. M0 is narrowed to the smallest power of two covering M, like
+// the compiler does for narrow matmuls.
+static void iree_uk_benchmark_register_mmt4d_shape(
+    iree_uk_uint32_t flags, int M0, int N0, int K0, int M, int N, int K,
+    const char* cpu_features) {
+  int narrowM0 = 1;
+  while (narrowM0 < M0 && narrowM0 < M) narrowM0 *= 2;
+  char suffix[64];
+  snprintf(suffix, sizeof suffix, "_shape_%dx%dx%d", M, N, K);
+  iree_uk_benchmark_register_mmt4d_impl(
+      flags, narrowM0, N0, K0, (M + narrowM0 - 1) / narrowM0,
+      (N + N0 - 1) / N0, (K + K0 - 1) / K0, cpu_features, suffix);
+}
+
 static void iree_uk_benchmark_register_mmt4d(iree_uk_uint32_t flags, int M0,
                                              int N0, int K0,
                                              const char* cpu_features) {
+  iree_string_view_t shapes = iree_make_cstring_view(FLAG_shapes);
+  if (iree_string_view_equal(shapes, IREE_SV("sweep"))) {
+    for (int i = 0; i < IREE_ARRAYSIZE(iree_uk_benchmark_mmt4d_sweep_shapes);
+         ++i) {
+      const int* shape = iree_uk_benchmark_mmt4d_sweep_shapes[i];
+      iree_uk_benchmark_register_mmt4d_shape(flags, M0, N0, K0, shape[0],
+                                             shape[1], shape[2], cpu_features);
+    }
+    return;
+  }
+  if (!iree_string_view_is_empty(shapes)) {
+    while (!iree_string_view_is_empty(shapes)) {
+      iree_string_view_t shape;
+      iree_string_view_split(shapes, ',', &shape, &shapes);
+      char shape_str[64] = {0};
+      memcpy(shape_str, shape.data, iree_min(shape.size, sizeof shape_str - 1));
+      int M = 0, N = 0, K = 0;
+      if (sscanf(shape_str, "%dx%dx%d", &M, &N, &K) != 3 || M <= 0 || N <= 0 ||
+          K <= 0) {
+        fprintf(stderr, "Invalid shape '%s' in --shapes, expected MxNxK.\n",
+                shape_str);
+        exit(EXIT_FAILURE);
+      }
+      iree_uk_benchmark_register_mmt4d_shape(flags, M0, N0, K0, M, N, K,
+                                             cpu_features);
+    }
+    return;
+  }
   // Test narrowed, power-of-two values of M0, as mmt4d kernels tend to have
   // narrow variants for handling these cases.
   for (int narrowM0 = 1; narrowM0 < M0; narrowM0 *= 2) {
-    iree_uk_benchmark_register_mmt4d_impl(flags, narrowM0, N0, K0, cpu_features,
-                                          "");
+    iree_uk_benchmark_register_mmt4d_impl(flags, narrowM0, N0, K0, FLAG_m_size,
+                                          FLAG_n_size, FLAG_k_size,
+                                          cpu_features, "");
+  }
+  iree_uk_benchmark_register_mmt4d_impl(flags, M0, N0, K0, FLAG_m_size,
+                                        FLAG_n_size, FLAG_k_size, cpu_features,
+                                        "");
+}
+
+// Creates the thread pool for --threads and measures the bandwidth roof for
+// --roofline.
+static void iree_uk_benchmark_mmt4d_initialize(void) {
+  if (FLAG_threads != 1) {
+    iree_task_topology_t topology;
+    IREE_CHECK_OK(iree_task_topology_initialize_from_flags(
+        iree_task_topology_query_current_node(), &topology));
+    IREE_CHECK_OK(iree_uk_benchmark_thread_pool_create(
+        &topology, FLAG_threads, iree_allocator_system(),
+        &iree_uk_benchmark_mmt4d_pool));
+    iree_task_topology_deinitialize(&topology);
+  }
+  if (FLAG_roofline) {
+    IREE_CHECK_OK(iree_uk_benchmark_measure_memcpy_bandwidth(
+        FLAG_roofline_working_set_size, iree_uk_benchmark_mmt4d_pool,
+        &iree_uk_benchmark_mmt4d_peak_bytes_per_second));
+    fprintf(stdout, "memcpy bandwidth roof on %d thread(s): %.1f GB/s\n",
+            iree_uk_benchmark_thread_pool_size(iree_uk_benchmark_mmt4d_pool),
+            iree_uk_benchmark_mmt4d_peak_bytes_per_second * 1e-9);
   }
-  iree_uk_benchmark_register_mmt4d_impl(flags, M0, N0, K0, cpu_features, "");
 }
 
 int main(int argc, char** argv) {
@@ -123,6 +291,7 @@ int main(int argc, char** argv) {
 
   iree_flags_parse_checked(IREE_FLAGS_PARSE_MODE_UNDEFINED_OK, &argc, &argv);
   iree_uk_benchmark_initialize(&argc, argv);
+  iree_uk_benchmark_mmt4d_initialize();
 
 #if defined(IREE_ARCH_ARM_64)
   iree_uk_benchmark_register_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F32F32F32, 8, 8, 1,
@@ -151,6 +320,10 @@ int main(int argc, char** argv) {
                                    "dotprod");
   iree_uk_benchmark_register_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_S8S4S32, 4, 8, 16,
                                    "i8mm");
+  iree_uk_benchmark_register_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_S16U4S32, 1, 8, 8,
+                                   "");
+  iree_uk_benchmark_register_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_S16U4S32, 1, 8, 8,
+                                   "dotprod");
 #elif defined(IREE_ARCH_X86_64)
   iree_uk_benchmark_register_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F32F32F32, 8, 8, 1,
                                    "avx2_fma");
@@ -174,12 +347,22 @@ int main(int argc, char** argv) {
                                    "avx512_base");
   iree_uk_benchmark_register_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_S8S8S32, 16, 16, 2,
                                    "avx512_vnni");
+  iree_uk_benchmark_register_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_S8S4S32, 8, 8, 2,
+                                   "avx2_fma");
+  iree_uk_benchmark_register_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_S8S4S32, 16, 16, 2,
+                                   "avx512_base");
+  iree_uk_benchmark_register_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_S8S4S32, 16, 16, 2,
+                                   "avx512_vnni");
   iree_uk_benchmark_register_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_S16S16S32, 8, 8, 2,
                                    "avx2_fma");
   iree_uk_benchmark_register_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_S16S16S32, 16, 16, 2,
                                    "avx512_base");
   iree_uk_benchmark_register_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_S16S16S32, 16, 16, 2,
                                    "avx512_vnni");
+  iree_uk_benchmark_register_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_S16U4S32, 1, 16, 8,
+                                   "avx2_fma");
+  iree_uk_benchmark_register_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_S16U4S32, 1, 32, 8,
+                                   "avx512_base");
   iree_uk_benchmark_register_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_S16U4S32, 1, 32, 8,
                                    "avx512_vnni");
 #else   // defined(IREE_ARCH_ARM_64)
@@ -196,4 +379,5 @@ int main(int argc, char** argv) {
 #endif  // defined(IREE_ARCH_ARM_64)
 
   iree_uk_benchmark_run_and_cleanup();
+  iree_uk_benchmark_thread_pool_release(iree_uk_benchmark_mmt4d_pool);
 }
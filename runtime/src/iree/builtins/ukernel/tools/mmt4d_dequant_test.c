@@ -0,0 +1,259 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/base/api.h"
+#include "iree/builtins/ukernel/api.h"
+#include "iree/builtins/ukernel/exported_bits.h"
+#include "iree/builtins/ukernel/mmt4d_dequant_internal.h"
+#include "iree/builtins/ukernel/tools/test.h"
+#include "iree/builtins/ukernel/tools/util.h"
+
+// Dequantizes each RHS element separately and accumulates the whole reduction
+// in one float, as opposed to the tile functions which apply the scale once
+// per group.
+static void iree_mmt4d_dequant_reference_innerloop_f32u4f32(
+    float* out_ptr, const float* lhs_ptr, const uint8_t* rhs_ptr,
+    const float* scales_ptr, const float* zero_points_ptr, iree_uk_index_t j0,
+    const iree_uk_mmt4d_dequant_params_t* params) {
+  float acc =
+      params->flags & IREE_UK_FLAG_MMT4D_DEQUANT_ACCUMULATE ? *out_ptr : 0.f;
+  for (iree_uk_index_t k = 0; k < params->K; ++k) {
+    for (iree_uk_index_t k0 = 0; k0 < params->K0; ++k0) {
+      iree_uk_index_t g = (k * params->K0 + k0) / params->group_size;
+      float scale = scales_ptr[g * params->N0];
+      float zero_point = zero_points_ptr[g * params->N0];
+      float lhs_f32 = lhs_ptr[k * params->M0 * params->K0 + k0];
+      iree_uk_index_t rhs_index =
+          k * params->N0 * params->K0 + j0 * params->K0 + k0;
+      uint8_t rhs_byte = rhs_ptr[rhs_index / 2];
+      uint8_t rhs_u4 = (rhs_index % 2) ? (rhs_byte >> 4) : (rhs_byte & 0x0F);
+      acc += lhs_f32 * (((float)rhs_u4 - zero_point) * scale);
+    }
+  }
+  *out_ptr = acc;
+}
+
+static void iree_mmt4d_dequant_reference(
+    const iree_uk_mmt4d_dequant_params_t* params) {
+  for (iree_uk_index_t i = 0; i < params->M; ++i) {
+    for (iree_uk_index_t j = 0; j < params->N; ++j) {
+      float* out_tile_ptr =
+          (float*)params->out_buffer + params->out_offset +
+          i * params->out_stride0 + j * params->M0 * params->N0;
+      const float* lhs_panel_ptr = (const float*)params->lhs_buffer +
+                                   params->lhs_offset + i * params->lhs_stride0;
+      const uint8_t* rhs_panel_ptr =
+          (const uint8_t*)params->rhs_buffer +
+          iree_uk_bits_to_bytes_exact(
+              (params->rhs_offset + j * params->rhs_stride0) * 4);
+      const float* scales_panel_ptr = (const float*)params->scales_buffer +
+                                      params->scales_offset +
+                                      j * params->scales_stride0;
+      const float* zero_points_panel_ptr =
+          (const float*)params->zero_points_buffer +
+          params->zero_points_offset + j * params->zero_points_stride0;
+      for (iree_uk_index_t i0 = 0; i0 < params->M0; ++i0) {
+        for (iree_uk_index_t j0 = 0; j0 < params->N0; ++j0) {
+          switch (params->flags & IREE_UK_FLAG_MMT4D_DEQUANT_TYPE_MASK) {
+            case IREE_UK_FLAG_MMT4D_DEQUANT_TYPE_F32U4F32:
+              iree_mmt4d_dequant_reference_innerloop_f32u4f32(
+                  out_tile_ptr + i0 * params->N0 + j0,
+                  lhs_panel_ptr + i0 * params->K0, rhs_panel_ptr,
+                  scales_panel_ptr + j0, zero_points_panel_ptr + j0, j0,
+                  params);
+              break;
+            default:
+              IREE_UK_ASSERT(false && "unhandled type");
+          }
+        }
+      }
+    }
+  }
+}
+
+static iree_uk_index_t iree_uk_test_random_stride(
+    iree_uk_index_t min_stride, iree_uk_type_t type,
+    iree_uk_random_engine_t* engine) {
+  // Randomly make strides either tight or not to exercise all cases, honoring
+  // the requirement that strides should be multiples of 8 bits.
+  iree_uk_index_t stride = min_stride + iree_uk_random_engine_get_0_1(engine);
+  while ((stride << iree_uk_type_bit_count_log2(type)) & 7) {
+    ++stride;
+  }
+  return stride;
+}
+
+static void iree_uk_test_mmt4d_dequant_for_shape_params(
+    iree_uk_test_t* test, const iree_uk_mmt4d_dequant_params_t* src_params) {
+  iree_uk_mmt4d_dequant_params_t params;
+  memcpy(&params, src_params, sizeof params);
+  iree_uk_mmt4d_dequant_type_t type = iree_uk_mmt4d_dequant_type(params.flags);
+  iree_uk_type_t lhs_type = iree_uk_mmt4d_dequant_lhs_type(type);
+  iree_uk_type_t rhs_type = iree_uk_mmt4d_dequant_rhs_type(type);
+  iree_uk_type_t out_type = iree_uk_mmt4d_dequant_out_type(type);
+  iree_uk_index_t group_count = params.K * params.K0 / params.group_size;
+  iree_uk_random_engine_t* engine = iree_uk_test_random_engine(test);
+  params.lhs_stride0 = iree_uk_test_random_stride(
+      params.K * params.M0 * params.K0, lhs_type, engine);
+  params.rhs_stride0 = iree_uk_test_random_stride(
+      params.K * params.N0 * params.K0, rhs_type, engine);
+  params.scales_stride0 =
+      iree_uk_test_random_stride(group_count * params.N0, lhs_type, engine);
+  params.zero_points_stride0 =
+      iree_uk_test_random_stride(group_count * params.N0, lhs_type, engine);
+  params.out_stride0 = iree_uk_test_random_stride(
+      params.N * params.M0 * params.N0, out_type, engine);
+  iree_uk_index_t lhs_buffer_size =
+      iree_uk_2d_buffer_length(lhs_type, params.M, params.lhs_stride0);
+  iree_uk_index_t rhs_buffer_size =
+      iree_uk_2d_buffer_length(rhs_type, params.N, params.rhs_stride0);
+  iree_uk_index_t scales_buffer_size =
+      iree_uk_2d_buffer_length(lhs_type, params.N, params.scales_stride0);
+  iree_uk_index_t zero_points_buffer_size =
+      iree_uk_2d_buffer_length(lhs_type, params.N, params.zero_points_stride0);
+  void* lhs_buffer = malloc(lhs_buffer_size);
+  void* rhs_buffer = malloc(rhs_buffer_size);
+  void* scales_buffer = malloc(scales_buffer_size);
+  void* zero_points_buffer = malloc(zero_points_buffer_size);
+  iree_uk_write_random_buffer(lhs_buffer, lhs_buffer_size, lhs_type, engine);
+  iree_uk_write_random_buffer(rhs_buffer, rhs_buffer_size, rhs_type, engine);
+  iree_uk_write_random_buffer(scales_buffer, scales_buffer_size, lhs_type,
+                              engine);
+  iree_uk_write_random_buffer(zero_points_buffer, zero_points_buffer_size,
+                              lhs_type, engine);
+  // Offsets are all zero except for the f32 operands, as the u4 RHS offset
+  // would need to be a multiple of 2 anyway.
+  params.lhs_offset = iree_uk_random_engine_get_0_1(engine);
+  params.rhs_offset = 0;
+  params.scales_offset = iree_uk_random_engine_get_0_1(engine);
+  params.zero_points_offset = iree_uk_random_engine_get_0_1(engine);
+  params.out_offset = iree_uk_random_engine_get_0_1(engine);
+  params.lhs_buffer = (const float*)lhs_buffer - params.lhs_offset;
+  params.rhs_buffer = rhs_buffer;
+  params.scales_buffer = (const float*)scales_buffer - params.scales_offset;
+  params.zero_points_buffer =
+      (const float*)zero_points_buffer - params.zero_points_offset;
+
+  iree_uk_index_t out_buffer_size =
+      iree_uk_2d_buffer_length(out_type, params.M, params.out_stride0);
+  void* init_out_buffer = malloc(out_buffer_size);
+  iree_uk_write_random_buffer(init_out_buffer, out_buffer_size, out_type,
+                              engine);
+
+  iree_uk_mmt4d_dequant_params_t reference_params;
+  memcpy(&reference_params, &params, sizeof params);
+  void* reference_out_buffer = malloc(out_buffer_size);
+  memcpy(reference_out_buffer, init_out_buffer, out_buffer_size);
+  reference_params.out_buffer =
+      (float*)reference_out_buffer - params.out_offset;
+
+  iree_uk_mmt4d_dequant_params_t actual_params;
+  memcpy(&actual_params, &params, sizeof params);
+  void* actual_out_buffer = malloc(out_buffer_size);
+  memcpy(actual_out_buffer, init_out_buffer, out_buffer_size);
+  actual_params.out_buffer = (float*)actual_out_buffer - params.out_offset;
+
+  iree_mmt4d_dequant_reference(&reference_params);
+  iree_uk_mmt4d_dequant_p(&actual_params);
+
+  // As in mmt4d_test, exact comparisons rely on all test values being small
+  // integers so that the different accumulation orders are all exact.
+  bool fail = memcmp(actual_out_buffer, reference_out_buffer, out_buffer_size);
+  if (fail) {
+    IREE_UK_TEST_FAIL(test);
+  }
+
+  free(init_out_buffer);
+  free(reference_out_buffer);
+  free(actual_out_buffer);
+  free(lhs_buffer);
+  free(rhs_buffer);
+  free(scales_buffer);
+  free(zero_points_buffer);
+}
+
+static void iree_uk_test_mmt4d_dequant_for_tile_params(iree_uk_test_t* test,
+                                                       const void* src_params) {
+  typedef struct shape_mn_groups_t {
+    int m, n, groups;
+  } shape_mn_groups_t;
+  const shape_mn_groups_t shapes[] = {
+      // Degenerate cases.
+      {0, 1, 1},
+      {1, 0, 1},
+      {1, 1, 0},
+      {5, 7, 0},
+      // Non-degenerate cases.
+      {1, 1, 1},
+      {1, 1, 2},
+      {1, 1, 10},
+      {2, 1, 1},
+      {1, 2, 1},
+      {2, 2, 2},
+      {5, 7, 3},
+  };
+  for (int i = 0; i < IREE_ARRAYSIZE(shapes); ++i) {
+    iree_uk_mmt4d_dequant_params_t params;
+    memcpy(&params, src_params, sizeof params);
+    params.cpu_data = iree_uk_test_cpu_data(test);
+    shape_mn_groups_t shape = shapes[i];
+    params.M = shape.m;
+    params.N = shape.n;
+    params.K = shape.groups * (params.group_size / params.K0);
+    for (int accumulate = 0; accumulate <= 1; ++accumulate) {
+      if (accumulate) params.flags |= IREE_UK_FLAG_MMT4D_DEQUANT_ACCUMULATE;
+      iree_uk_test_mmt4d_dequant_for_shape_params(test, &params);
+    }
+  }
+}
+
+static void iree_uk_test_mmt4d_dequant(iree_uk_uint32_t flags, int M0, int N0,
+                                       int K0, int group_size,
+                                       const char* cpu_features) {
+  // Always allow the fallback, see the comment in mmt4d_test.
+  flags |= IREE_UK_FLAG_MMT4D_DEQUANT_ALLOW_GENERIC_FALLBACK_TILE_FUNCTION;
+  char types_str[32];
+  iree_uk_type_triple_str(types_str, sizeof types_str,
+                          iree_uk_mmt4d_dequant_type(flags));
+  iree_uk_mmt4d_dequant_params_t params = {.flags = flags,
+                                           .M0 = M0,
+                                           .N0 = N0,
+                                           .K0 = K0,
+                                           .group_size = group_size};
+  char test_label_str[256];
+  snprintf(test_label_str, sizeof test_label_str,
+           "types:%s tile:%dx%dx%d group_size:%d", types_str, M0, N0, K0,
+           group_size);
+  iree_uk_test(test_label_str, iree_uk_test_mmt4d_dequant_for_tile_params,
+               &params, cpu_features);
+}
+
+int main(int argc, char** argv) {
+  // Generic tests, including packed layouts and groups spanning a single tile.
+  iree_uk_test_mmt4d_dequant(IREE_UK_FLAG_MMT4D_DEQUANT_TYPE_F32U4F32, 3, 5, 2,
+                             2, "");
+  iree_uk_test_mmt4d_dequant(IREE_UK_FLAG_MMT4D_DEQUANT_TYPE_F32U4F32, 4, 8, 2,
+                             6, "");
+  iree_uk_test_mmt4d_dequant(IREE_UK_FLAG_MMT4D_DEQUANT_TYPE_F32U4F32, 1, 1, 8,
+                             24, "");
+  iree_uk_test_mmt4d_dequant(IREE_UK_FLAG_MMT4D_DEQUANT_TYPE_F32U4F32, 1, 1, 32,
+                             128, "");
+
+#if defined(IREE_ARCH_X86_64)
+
+  iree_uk_test_mmt4d_dequant(IREE_UK_FLAG_MMT4D_DEQUANT_TYPE_F32U4F32, 1, 1, 32,
+                             32, "avx2_fma");
+  iree_uk_test_mmt4d_dequant(IREE_UK_FLAG_MMT4D_DEQUANT_TYPE_F32U4F32, 1, 1, 32,
+                             128, "avx2_fma");
+  iree_uk_test_mmt4d_dequant(IREE_UK_FLAG_MMT4D_DEQUANT_TYPE_F32U4F32, 1, 1, 32,
+                             32, "avx512_base");
+  iree_uk_test_mmt4d_dequant(IREE_UK_FLAG_MMT4D_DEQUANT_TYPE_F32U4F32, 1, 1, 32,
+                             128, "avx512_base");
+
+#endif  // defined(IREE_ARCH_X86_64)
+
+  return iree_uk_test_exit_status();
+}
@@ -83,7 +83,7 @@ static iree_status_t iree_uk_benchmark_pack(
   params.padding_value = 0;
   int64_t total_iterations = 0;
   int64_t batch_count = 1;
-  while (iree_benchmark_keep_running(benchmark_state, batch_count)) {
+  while (iree_uk_benchmark_keep_running(benchmark_state, batch_count)) {
     for (int i = 0; i < batch_count; ++i) {
       iree_uk_pack_p(&params);
     }
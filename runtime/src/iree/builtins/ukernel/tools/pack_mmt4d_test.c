@@ -0,0 +1,216 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/base/api.h"
+#include "iree/builtins/ukernel/api.h"
+#include "iree/builtins/ukernel/exported_bits.h"
+#include "iree/builtins/ukernel/mmt4d_internal.h"
+#include "iree/builtins/ukernel/pack_mmt4d_internal.h"
+#include "iree/builtins/ukernel/tools/test.h"
+#include "iree/builtins/ukernel/tools/util.h"
+
+// Reference: packs the LHS into a separate buffer, padding with zeros, and
+// runs mmt4d on it. Since pack_mmt4d uses the same tile functions, with the
+// same accumulation order along K, results must match exactly.
+static void iree_pack_mmt4d_reference(
+    const iree_uk_pack_mmt4d_params_t* params) {
+  iree_uk_mmt4d_type_t mmt4d_type = iree_uk_mmt4d_type(params->flags);
+  iree_uk_type_t lhs_type = iree_uk_mmt4d_lhs_type(mmt4d_type);
+  iree_uk_index_t elem_size = iree_uk_type_size(lhs_type);
+  iree_uk_index_t packed_stride0 = params->K * params->M0 * params->K0;
+  iree_uk_index_t packed_size =
+      iree_uk_2d_buffer_length(lhs_type, params->M, packed_stride0);
+  char* packed = calloc(1, packed_size ? packed_size : 1);
+  const char* lhs =
+      (const char*)params->lhs_buffer + params->lhs_offset * elem_size;
+  for (iree_uk_index_t i = 0; i < params->lhs_size0; ++i) {
+    for (iree_uk_index_t k = 0; k < params->lhs_size1; ++k) {
+      iree_uk_index_t i1 = i / params->M0, i0 = i % params->M0;
+      iree_uk_index_t k1 = k / params->K0, k0 = k % params->K0;
+      iree_uk_index_t packed_index = i1 * packed_stride0 +
+                                     k1 * params->M0 * params->K0 +
+                                     i0 * params->K0 + k0;
+      memcpy(packed + packed_index * elem_size,
+             lhs + (i * params->lhs_stride0 + k) * elem_size, elem_size);
+    }
+  }
+  iree_uk_mmt4d_params_t mmt4d_params = {.lhs_buffer = packed,
+                                         .lhs_offset = 0,
+                                         .lhs_stride0 = packed_stride0,
+                                         .rhs_buffer = params->rhs_buffer,
+                                         .rhs_offset = params->rhs_offset,
+                                         .rhs_stride0 = params->rhs_stride0,
+                                         .out_buffer = params->out_buffer,
+                                         .out_offset = params->out_offset,
+                                         .out_stride0 = params->out_stride0,
+                                         .M = params->M,
+                                         .N = params->N,
+                                         .K = params->K,
+                                         .M0 = params->M0,
+                                         .N0 = params->N0,
+                                         .K0 = params->K0,
+                                         .flags = params->flags,
+                                         .cpu_data = params->cpu_data};
+  iree_uk_mmt4d_p(&mmt4d_params);
+  free(packed);
+}
+
+static void iree_uk_test_pack_mmt4d_for_shape_params(
+    iree_uk_test_t* test, const iree_uk_pack_mmt4d_params_t* src_params) {
+  iree_uk_pack_mmt4d_params_t params;
+  memcpy(&params, src_params, sizeof params);
+  iree_uk_mmt4d_type_t mmt4d_type = iree_uk_mmt4d_type(params.flags);
+  iree_uk_type_t lhs_type = iree_uk_mmt4d_lhs_type(mmt4d_type);
+  iree_uk_type_t rhs_type = iree_uk_mmt4d_rhs_type(mmt4d_type);
+  iree_uk_type_t out_type = iree_uk_mmt4d_out_type(mmt4d_type);
+  iree_uk_random_engine_t* engine = iree_uk_test_random_engine(test);
+  // Randomly pad by up to one less than the tile size, and make strides and
+  // offsets either tight or not, to exercise all cases.
+  params.lhs_size0 =
+      params.M ? params.M * params.M0 -
+                     iree_uk_random_engine_get_0_65535(engine) % params.M0
+               : 0;
+  params.lhs_size1 =
+      params.K ? params.K * params.K0 -
+                     iree_uk_random_engine_get_0_65535(engine) % params.K0
+               : 0;
+  params.lhs_stride0 =
+      params.lhs_size1 + iree_uk_random_engine_get_0_1(engine);
+  // Honor the requirement that RHS strides are multiples of 8 bits.
+  params.rhs_stride0 = params.K * params.N0 * params.K0;
+  params.out_stride0 =
+      params.N * params.M0 * params.N0 + iree_uk_random_engine_get_0_1(engine);
+  iree_uk_index_t lhs_buffer_size =
+      iree_uk_2d_buffer_length(lhs_type, params.lhs_size0, params.lhs_stride0);
+  iree_uk_index_t rhs_buffer_size =
+      iree_uk_2d_buffer_length(rhs_type, params.N, params.rhs_stride0);
+  iree_uk_index_t out_buffer_size =
+      iree_uk_2d_buffer_length(out_type, params.M, params.out_stride0);
+  void* lhs_buffer = malloc(lhs_buffer_size);
+  void* rhs_buffer = malloc(rhs_buffer_size);
+  void* init_out_buffer = malloc(out_buffer_size);
+  iree_uk_write_random_buffer(lhs_buffer, lhs_buffer_size, lhs_type, engine);
+  iree_uk_write_random_buffer(rhs_buffer, rhs_buffer_size, rhs_type, engine);
+  iree_uk_write_random_buffer(init_out_buffer, out_buffer_size, out_type,
+                              engine);
+  iree_uk_index_t lhs_elem_size = iree_uk_type_size(lhs_type);
+  iree_uk_index_t out_elem_size = iree_uk_type_size(out_type);
+  params.lhs_offset = iree_uk_random_engine_get_0_1(engine);
+  params.out_offset = iree_uk_random_engine_get_0_1(engine);
+  params.lhs_buffer =
+      (const char*)lhs_buffer - params.lhs_offset * lhs_elem_size;
+  params.rhs_buffer = rhs_buffer;
+
+  iree_uk_pack_mmt4d_params_t reference_params;
+  memcpy(&reference_params, &params, sizeof params);
+  void* reference_out_buffer = malloc(out_buffer_size);
+  memcpy(reference_out_buffer, init_out_buffer, out_buffer_size);
+  reference_params.out_buffer =
+      (char*)reference_out_buffer - params.out_offset * out_elem_size;
+
+  iree_uk_pack_mmt4d_params_t actual_params;
+  memcpy(&actual_params, &params, sizeof params);
+  void* actual_out_buffer = malloc(out_buffer_size);
+  memcpy(actual_out_buffer, init_out_buffer, out_buffer_size);
+  actual_params.out_buffer =
+      (char*)actual_out_buffer - params.out_offset * out_elem_size;
+
+  iree_pack_mmt4d_reference(&reference_params);
+  iree_uk_pack_mmt4d_p(&actual_params);
+
+  bool fail = memcmp(actual_out_buffer, reference_out_buffer, out_buffer_size);
+  if (fail) {
+    IREE_UK_TEST_FAIL(test);
+  }
+
+  free(init_out_buffer);
+  free(reference_out_buffer);
+  free(actual_out_buffer);
+  free(lhs_buffer);
+  free(rhs_buffer);
+}
+
+static void iree_uk_test_pack_mmt4d_for_tile_params(iree_uk_test_t* test,
+                                                    const void* src_params) {
+  typedef struct shape_mnk_t {
+    int m, n, k;
+  } shape_mnk_t;
+  // The largest K is enough to need several chunks of the LHS panel buffer
+  // for all the tile sizes tested below.
+  const shape_mnk_t shapes[] = {
+      // Degenerate cases.
+      {0, 5, 7},
+      {5, 0, 7},
+      {1, 1, 0},
+      {5, 7, 0},
+      // Non-degenerate cases.
+      {1, 1, 1},
+      {1, 1, 10},
+      {2, 3, 1},
+      {5, 7, 13},
+      {3, 2, 700},
+  };
+  for (int i = 0; i < IREE_ARRAYSIZE(shapes); ++i) {
+    iree_uk_pack_mmt4d_params_t params;
+    memcpy(&params, src_params, sizeof params);
+    params.cpu_data = iree_uk_test_cpu_data(test);
+    params.M = shapes[i].m;
+    params.N = shapes[i].n;
+    params.K = shapes[i].k;
+    for (int accumulate = 0; accumulate <= 1; ++accumulate) {
+      if (accumulate) params.flags |= IREE_UK_FLAG_MMT4D_ACCUMULATE;
+      iree_uk_test_pack_mmt4d_for_shape_params(test, &params);
+    }
+  }
+}
+
+static void iree_uk_test_pack_mmt4d(iree_uk_uint32_t flags, int M0, int N0,
+                                    int K0, const char* cpu_features) {
+  // As in mmt4d_test, always allow the fallback.
+  flags |= IREE_UK_FLAG_MMT4D_ALLOW_GENERIC_FALLBACK_TILE_FUNCTION;
+  char types_str[32];
+  iree_uk_type_triple_str(types_str, sizeof types_str,
+                          iree_uk_mmt4d_type(flags));
+  iree_uk_pack_mmt4d_params_t params = {
+      .flags = flags, .M0 = M0, .N0 = N0, .K0 = K0};
+  char test_label_str[256];
+  snprintf(test_label_str, sizeof test_label_str, "types:%s tile:%dx%dx%d",
+           types_str, M0, N0, K0);
+  iree_uk_test(test_label_str, iree_uk_test_pack_mmt4d_for_tile_params,
+               &params, cpu_features);
+}
+
+int main(int argc, char** argv) {
+  // Generic tests, not matching any arch specialization by design.
+  iree_uk_test_pack_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F32F32F32, 3, 5, 7, "");
+  iree_uk_test_pack_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_S8S8S32, 9, 6, 3, "");
+  iree_uk_test_pack_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_S8S4S32, 9, 12, 2, "");
+  iree_uk_test_pack_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_S16S16S32, 7, 3, 6, "");
+  iree_uk_test_pack_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F16F16F32, 4, 6, 5, "");
+  iree_uk_test_pack_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_BF16BF16F32, 11, 4, 1, "");
+
+#if defined(IREE_ARCH_ARM_64)
+
+  iree_uk_test_pack_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F32F32F32, 8, 8, 1, "");
+  iree_uk_test_pack_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_S8S8S32, 8, 8, 4,
+                          "dotprod");
+  iree_uk_test_pack_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_S8S8S32, 8, 8, 8, "i8mm");
+
+#elif defined(IREE_ARCH_X86_64)
+
+  iree_uk_test_pack_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F32F32F32, 8, 8, 1,
+                          "avx2_fma");
+  iree_uk_test_pack_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_S8S8S32, 8, 8, 2,
+                          "avx2_fma");
+  iree_uk_test_pack_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F32F32F32, 16, 16, 1,
+                          "avx512_base");
+  iree_uk_test_pack_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_S8S8S32, 16, 16, 2,
+                          "avx512_vnni");
+
+#endif  // defined(IREE_ARCH_X86_64)
+
+  return iree_uk_test_exit_status();
+}
@@ -0,0 +1,169 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <math.h>
+
+#include "iree/base/api.h"
+#include "iree/builtins/ukernel/api.h"
+#include "iree/builtins/ukernel/softmax_internal.h"
+#include "iree/builtins/ukernel/tools/test.h"
+#include "iree/builtins/ukernel/tools/util.h"
+
+// Unlike the data-movement ukernels, softmax results depend on the exp
+// approximation and on the summation order, so the comparison against this
+// double-precision reference is tolerance-based.
+static void iree_softmax_reference(const iree_uk_softmax_params_t* params) {
+  const float* in_buffer = params->in_buffer;
+  float* out_buffer = params->out_buffer;
+  for (iree_uk_index_t i = 0; i < params->size0; ++i) {
+    const float* in_row =
+        in_buffer + params->in_offset + i * params->in_stride0;
+    float* out_row = out_buffer + params->out_offset + i * params->out_stride0;
+    double max = -INFINITY;
+    for (iree_uk_index_t j = 0; j < params->size1; ++j) {
+      if (in_row[j] > max) max = in_row[j];
+    }
+    double sum = 0;
+    for (iree_uk_index_t j = 0; j < params->size1; ++j) {
+      sum += exp(in_row[j] - max);
+    }
+    for (iree_uk_index_t j = 0; j < params->size1; ++j) {
+      out_row[j] = (float)(exp(in_row[j] - max) / sum);
+    }
+  }
+}
+
+// Fills a f32 buffer with values in [-range, range]. The integer-valued
+// buffers from iree_uk_write_random_buffer would leave most of the exp
+// polynomial untested.
+static void iree_uk_test_write_random_f32_buffer(
+    float* buffer, iree_uk_index_t size, float range,
+    iree_uk_random_engine_t* engine) {
+  for (iree_uk_index_t i = 0; i < size; ++i) {
+    float u = iree_uk_random_engine_get_0_65535(engine) / 65535.f;
+    buffer[i] = range * (2.f * u - 1.f);
+  }
+}
+
+static bool iree_uk_test_softmax_rows_close(
+    const iree_uk_softmax_params_t* params, const float* actual,
+    const float* expected) {
+  for (iree_uk_index_t i = 0; i < params->size0; ++i) {
+    for (iree_uk_index_t j = 0; j < params->size1; ++j) {
+      iree_uk_index_t offset = i * params->out_stride0 + j;
+      float a = actual[offset];
+      float e = expected[offset];
+      if (!(fabsf(a - e) <= 1e-6f + 1e-5f * fabsf(e))) {
+        fprintf(stderr, "mismatch at (%d, %d): actual %g expected %g\n",
+                (int)i, (int)j, a, e);
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+static void iree_uk_test_softmax_for_shape_params(
+    iree_uk_test_t* test, const iree_uk_softmax_params_t* src_params,
+    float range) {
+  iree_uk_softmax_params_t params;
+  memcpy(&params, src_params, sizeof params);
+  // Randomly make strides either tight or not to exercise all cases.
+  iree_uk_random_engine_t* engine = iree_uk_test_random_engine(test);
+  params.in_stride0 = params.size1 + iree_uk_random_engine_get_0_1(engine);
+  params.out_stride0 = params.size1 + iree_uk_random_engine_get_0_1(engine);
+  iree_uk_index_t in_size = params.size0 * params.in_stride0;
+  iree_uk_index_t out_size = params.size0 * params.out_stride0;
+  float* in_buffer = malloc((in_size + 1) * sizeof(float));
+  iree_uk_test_write_random_f32_buffer(in_buffer, in_size + 1, range, engine);
+  params.in_offset = iree_uk_random_engine_get_0_1(engine);
+  params.out_offset = iree_uk_random_engine_get_0_65535(engine);
+  params.in_buffer = in_buffer;
+
+  iree_uk_index_t out_buffer_size = (out_size + 1) * sizeof(float);
+  float* reference_out_buffer = malloc(out_buffer_size);
+  float* actual_out_buffer = malloc(out_buffer_size);
+  iree_uk_write_random_buffer(reference_out_buffer, out_buffer_size,
+                              IREE_UK_TYPE_FLOAT_32, engine);
+  memcpy(actual_out_buffer, reference_out_buffer, out_buffer_size);
+
+  iree_uk_softmax_params_t reference_params;
+  memcpy(&reference_params, &params, sizeof reference_params);
+  reference_params.out_buffer = reference_out_buffer - params.out_offset;
+  iree_uk_softmax_params_t actual_params;
+  memcpy(&actual_params, &params, sizeof actual_params);
+  actual_params.out_buffer = actual_out_buffer - params.out_offset;
+
+  iree_softmax_reference(&reference_params);
+  iree_uk_softmax_p(&actual_params);
+
+  if (!iree_uk_test_softmax_rows_close(&params, actual_out_buffer,
+                                       reference_out_buffer)) {
+    IREE_UK_TEST_FAIL(test);
+  }
+
+  free(reference_out_buffer);
+  free(actual_out_buffer);
+  free(in_buffer);
+}
+
+static void iree_uk_test_softmax_for_tile_params(iree_uk_test_t* test,
+                                                 const void* src_params) {
+  typedef struct shape_t {
+    int size0, size1;
+  } shape_t;
+  const shape_t shapes[] = {
+      // Degenerate cases. Vacuous.
+      {0, 1},
+      {1, 0},
+      // Non-degenerate cases. The row sizes straddle the vector widths and
+      // the unrolled block sizes of the SIMD tile functions.
+      {1, 1},
+      {3, 7},
+      {2, 8},
+      {2, 17},
+      {1, 64},
+      {5, 67},
+      {2, 130},
+      {1, 1000},
+  };
+  // A small range keeps the exponents close to each other, a large range
+  // exercises the underflow path and the online rescaling of the sum.
+  const float ranges[] = {1.f, 100.f};
+  for (int i = 0; i < IREE_ARRAYSIZE(shapes); ++i) {
+    for (int r = 0; r < IREE_ARRAYSIZE(ranges); ++r) {
+      iree_uk_softmax_params_t params;
+      memcpy(&params, src_params, sizeof params);
+      params.cpu_data = iree_uk_test_cpu_data(test);
+      params.size0 = shapes[i].size0;
+      params.size1 = shapes[i].size1;
+      iree_uk_test_softmax_for_shape_params(test, &params, ranges[r]);
+    }
+  }
+}
+
+static void iree_uk_test_softmax(iree_uk_uint32_t flags,
+                                 const char* cpu_features) {
+  iree_uk_softmax_params_t params = {.flags = flags};
+  char types_str[32];
+  iree_uk_type_pair_str(types_str, sizeof types_str,
+                        iree_uk_softmax_type(flags));
+  char test_label_str[256];
+  snprintf(test_label_str, sizeof test_label_str, "types:%s", types_str);
+  iree_uk_test(test_label_str, iree_uk_test_softmax_for_tile_params, &params,
+               cpu_features);
+}
+
+int main(int argc, char** argv) {
+  iree_uk_test_softmax(IREE_UK_FLAG_SOFTMAX_TYPE_F32F32, "");
+
+#if defined(IREE_ARCH_X86_64)
+  iree_uk_test_softmax(IREE_UK_FLAG_SOFTMAX_TYPE_F32F32, "avx2_fma");
+  iree_uk_test_softmax(IREE_UK_FLAG_SOFTMAX_TYPE_F32F32, "avx512_base");
+#endif  // defined(IREE_ARCH_X86_64)
+
+  return iree_uk_test_exit_status();
+}
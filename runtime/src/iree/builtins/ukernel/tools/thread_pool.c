@@ -0,0 +1,186 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/tools/thread_pool.h"
+
+#include "iree/base/internal/atomics.h"
+#include "iree/base/internal/synchronization.h"
+#include "iree/base/internal/threading.h"
+
+typedef struct iree_uk_benchmark_thread_pool_worker_t {
+  iree_uk_benchmark_thread_pool_t* pool;
+  int index;
+  // Value of pool->generation when this worker last picked up work. Only
+  // accessed by the worker thread.
+  int32_t seen_generation;
+  iree_thread_t* thread;
+} iree_uk_benchmark_thread_pool_worker_t;
+
+struct iree_uk_benchmark_thread_pool_t {
+  iree_allocator_t allocator;
+  int thread_count;
+  // Function and argument of the current run. Written before `generation` is
+  // bumped, read by the workers after they observe the new generation.
+  iree_uk_benchmark_thread_pool_func_t func;
+  void* arg;
+  // Incremented once per run to wake up the workers.
+  iree_atomic_int32_t generation;
+  // Set when the pool is released, to make the workers exit.
+  iree_atomic_int32_t exit_requested;
+  // Number of workers that have not finished the current run yet.
+  iree_atomic_int32_t pending_count;
+  // Number of created workers that have not exited yet.
+  iree_atomic_int32_t live_count;
+  iree_notification_t start_notification;
+  iree_notification_t done_notification;
+  // Posted by each worker as it exits.
+  iree_notification_t exit_notification;
+  iree_uk_benchmark_thread_pool_worker_t workers[];
+};
+
+static bool iree_uk_benchmark_thread_pool_worker_should_wake(void* arg) {
+  iree_uk_benchmark_thread_pool_worker_t* worker = arg;
+  iree_uk_benchmark_thread_pool_t* pool = worker->pool;
+  return iree_atomic_load_int32(&pool->exit_requested,
+                                iree_memory_order_acquire) ||
+         iree_atomic_load_int32(&pool->generation,
+                                iree_memory_order_acquire) !=
+             worker->seen_generation;
+}
+
+static int iree_uk_benchmark_thread_pool_worker_main(void* arg) {
+  iree_uk_benchmark_thread_pool_worker_t* worker = arg;
+  iree_uk_benchmark_thread_pool_t* pool = worker->pool;
+  while (true) {
+    iree_notification_await(&pool->start_notification,
+                            iree_uk_benchmark_thread_pool_worker_should_wake,
+                            worker, iree_infinite_timeout());
+    if (iree_atomic_load_int32(&pool->exit_requested,
+                               iree_memory_order_acquire)) {
+      break;
+    }
+    worker->seen_generation =
+        iree_atomic_load_int32(&pool->generation, iree_memory_order_acquire);
+    pool->func(pool->arg, worker->index, pool->thread_count);
+    if (iree_atomic_fetch_sub_int32(&pool->pending_count, 1,
+                                    iree_memory_order_acq_rel) == 1) {
+      iree_notification_post(&pool->done_notification, IREE_ALL_WAITERS);
+    }
+  }
+  iree_atomic_fetch_sub_int32(&pool->live_count, 1, iree_memory_order_acq_rel);
+  iree_notification_post(&pool->exit_notification, IREE_ALL_WAITERS);
+  return 0;
+}
+
+static bool iree_uk_benchmark_thread_pool_all_exited(void* arg) {
+  iree_uk_benchmark_thread_pool_t* pool = arg;
+  return iree_atomic_load_int32(&pool->live_count,
+                                iree_memory_order_acquire) == 0;
+}
+
+static bool iree_uk_benchmark_thread_pool_is_done(void* arg) {
+  iree_uk_benchmark_thread_pool_t* pool = arg;
+  return iree_atomic_load_int32(&pool->pending_count,
+                                iree_memory_order_acquire) == 0;
+}
+
+iree_status_t iree_uk_benchmark_thread_pool_create(
+    const iree_task_topology_t* topology, int max_threads,
+    iree_allocator_t allocator, iree_uk_benchmark_thread_pool_t** out_pool) {
+  IREE_ASSERT_ARGUMENT(topology);
+  IREE_ASSERT_ARGUMENT(out_pool);
+  *out_pool = NULL;
+  int thread_count = (int)iree_task_topology_group_count(topology);
+  if (max_threads > 0 && max_threads < thread_count) {
+    thread_count = max_threads;
+  }
+  if (thread_count == 0) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "topology has no groups to create workers for");
+  }
+  iree_uk_benchmark_thread_pool_t* pool = NULL;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      allocator,
+      sizeof(*pool) + thread_count * sizeof(pool->workers[0]),
+      (void**)&pool));
+  memset(pool, 0, sizeof(*pool));
+  pool->allocator = allocator;
+  iree_notification_initialize(&pool->start_notification);
+  iree_notification_initialize(&pool->done_notification);
+  iree_notification_initialize(&pool->exit_notification);
+  iree_status_t status = iree_ok_status();
+  for (int i = 0; i < thread_count && iree_status_is_ok(status); ++i) {
+    iree_uk_benchmark_thread_pool_worker_t* worker = &pool->workers[i];
+    worker->pool = pool;
+    worker->index = i;
+    worker->seen_generation = 0;
+    worker->thread = NULL;
+    iree_thread_create_params_t params;
+    memset(&params, 0, sizeof(params));
+    params.name = iree_make_cstring_view("iree-uk-benchmark-worker");
+    params.initial_affinity = topology->groups[i].ideal_thread_affinity;
+    iree_atomic_fetch_add_int32(&pool->live_count, 1,
+                                iree_memory_order_relaxed);
+    status = iree_thread_create(iree_uk_benchmark_thread_pool_worker_main,
+                                worker, params, allocator, &worker->thread);
+    // Only count the workers that exist, so that release waits for those.
+    if (iree_status_is_ok(status)) {
+      pool->thread_count = i + 1;
+    } else {
+      iree_atomic_fetch_sub_int32(&pool->live_count, 1,
+                                  iree_memory_order_relaxed);
+    }
+  }
+  if (!iree_status_is_ok(status)) {
+    iree_uk_benchmark_thread_pool_release(pool);
+    return status;
+  }
+  *out_pool = pool;
+  return iree_ok_status();
+}
+
+void iree_uk_benchmark_thread_pool_release(
+    iree_uk_benchmark_thread_pool_t* pool) {
+  if (!pool) return;
+  iree_atomic_store_int32(&pool->exit_requested, 1, iree_memory_order_release);
+  iree_notification_post(&pool->start_notification, IREE_ALL_WAITERS);
+  // Releasing a thread only joins it if it has started running, so a worker
+  // that has not been scheduled yet could otherwise wake up to a freed pool.
+  // Once all have exited their main function, releasing them joins them.
+  iree_notification_await(&pool->exit_notification,
+                          iree_uk_benchmark_thread_pool_all_exited, pool,
+                          iree_infinite_timeout());
+  for (int i = 0; i < pool->thread_count; ++i) {
+    iree_thread_release(pool->workers[i].thread);
+  }
+  iree_notification_deinitialize(&pool->start_notification);
+  iree_notification_deinitialize(&pool->done_notification);
+  iree_notification_deinitialize(&pool->exit_notification);
+  iree_allocator_free(pool->allocator, pool);
+}
+
+int iree_uk_benchmark_thread_pool_size(
+    const iree_uk_benchmark_thread_pool_t* pool) {
+  return pool ? pool->thread_count : 1;
+}
+
+void iree_uk_benchmark_thread_pool_run(
+    iree_uk_benchmark_thread_pool_t* pool,
+    iree_uk_benchmark_thread_pool_func_t func, void* arg) {
+  if (!pool) {
+    func(arg, 0, 1);
+    return;
+  }
+  pool->func = func;
+  pool->arg = arg;
+  iree_atomic_store_int32(&pool->pending_count, pool->thread_count,
+                          iree_memory_order_relaxed);
+  iree_atomic_fetch_add_int32(&pool->generation, 1, iree_memory_order_release);
+  iree_notification_post(&pool->start_notification, IREE_ALL_WAITERS);
+  iree_notification_await(&pool->done_notification,
+                          iree_uk_benchmark_thread_pool_is_done, pool,
+                          iree_infinite_timeout());
+}
@@ -0,0 +1,46 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_BUILTINS_UKERNEL_TOOLS_THREAD_POOL_H_
+#define IREE_BUILTINS_UKERNEL_TOOLS_THREAD_POOL_H_
+
+#include "iree/base/api.h"
+#include "iree/task/topology.h"
+
+// A minimal pool of worker threads for benchmarks that want to measure a
+// ukernel running on several cores at once. Unlike the task system, there is
+// no scheduling: each call to iree_uk_benchmark_thread_pool_run runs the same
+// function once on every worker and waits for all of them.
+typedef struct iree_uk_benchmark_thread_pool_t iree_uk_benchmark_thread_pool_t;
+
+// Function run by each worker. `thread_index` is in [0, thread_count).
+typedef void (*iree_uk_benchmark_thread_pool_func_t)(void* arg,
+                                                     int thread_index,
+                                                     int thread_count);
+
+// Creates a pool with one worker per group of `topology`, up to `max_threads`
+// of them if it is positive. Each worker is pinned to the ideal affinity of
+// its group.
+iree_status_t iree_uk_benchmark_thread_pool_create(
+    const iree_task_topology_t* topology, int max_threads,
+    iree_allocator_t allocator, iree_uk_benchmark_thread_pool_t** out_pool);
+
+// Joins the workers and frees the pool. `pool` may be NULL.
+void iree_uk_benchmark_thread_pool_release(
+    iree_uk_benchmark_thread_pool_t* pool);
+
+// Returns the number of workers, 1 if `pool` is NULL.
+int iree_uk_benchmark_thread_pool_size(
+    const iree_uk_benchmark_thread_pool_t* pool);
+
+// Runs `func(arg, i, n)` on each worker i of the n workers in `pool` and
+// returns once all of them are done. If `pool` is NULL, runs `func(arg, 0, 1)`
+// on the calling thread.
+void iree_uk_benchmark_thread_pool_run(
+    iree_uk_benchmark_thread_pool_t* pool,
+    iree_uk_benchmark_thread_pool_func_t func, void* arg);
+
+#endif  // IREE_BUILTINS_UKERNEL_TOOLS_THREAD_POOL_H_
@@ -82,7 +82,7 @@ static iree_status_t iree_uk_benchmark_unpack(
   params.out_buffer = out_buffer;
   int64_t total_iterations = 0;
   int64_t batch_count = 1;
-  while (iree_benchmark_keep_running(benchmark_state, batch_count)) {
+  while (iree_uk_benchmark_keep_running(benchmark_state, batch_count)) {
     for (int i = 0; i < batch_count; ++i) {
       iree_uk_unpack_p(&params);
     }
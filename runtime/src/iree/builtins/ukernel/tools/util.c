@@ -334,3 +334,18 @@ const char* iree_uk_cpu_first_unsupported_feature(
                  "unsupported CPU feature");
   return NULL;
 }
+
+int iree_uk_cpu_features_str(char* buf, int buf_length,
+                             const iree_uk_uint64_t* cpu_data_fields) {
+  int length = 0;
+  if (buf_length > 0) buf[0] = 0;
+  for (int i = 0; i < IREE_CPU_DATA_FIELD_COUNT; ++i) {
+    for (int bit_pos = 0; bit_pos < 64; ++bit_pos) {
+      if (!(cpu_data_fields[i] & (1ull << bit_pos))) continue;
+      int remaining = buf_length > length ? buf_length - length : 0;
+      length += snprintf(buf + length, remaining, "%s%s", length ? "," : "",
+                         iree_uk_cpu_feature_name(i, bit_pos));
+    }
+  }
+  return length;
+}
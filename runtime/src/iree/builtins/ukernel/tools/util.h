@@ -57,4 +57,10 @@ bool iree_uk_cpu_supports(const iree_uk_uint64_t* cpu_data_fields);
 const char* iree_uk_cpu_first_unsupported_feature(
     const iree_uk_uint64_t* cpu_data_fields);
 
+// Writes the LLVM names of the CPU features set in |cpu_data_fields| as a
+// comma-separated list, e.g. "fma,avx2", or an empty string if there are
+// none. Works like the above type stringification helpers.
+int iree_uk_cpu_features_str(char* buf, int buf_length,
+                             const iree_uk_uint64_t* cpu_data_fields);
+
 #endif  // IREE_BUILTINS_UKERNEL_TOOLS_UTIL_H_
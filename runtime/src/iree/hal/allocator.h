@@ -537,6 +537,37 @@ IREE_API_EXPORT iree_status_t iree_hal_allocator_create_heap(
     iree_string_view_t identifier, iree_allocator_t data_allocator,
     iree_allocator_t host_allocator, iree_hal_allocator_t** out_allocator);
 
+// Controls how device-local heap allocator storage is placed across NUMA nodes.
+typedef enum iree_hal_heap_numa_policy_e {
+  // Device-local storage is allocated from the data allocator like any other
+  // heap allocation and placed by the system (usually on first-touch).
+  IREE_HAL_HEAP_NUMA_POLICY_NONE = 0,
+  // Device-local storage prefers the lowest node in the node mask and falls
+  // back to other nodes when it is out of memory.
+  IREE_HAL_HEAP_NUMA_POLICY_PREFERRED,
+  // Device-local storage is strictly bound to the nodes in the node mask where
+  // supported by the platform.
+  IREE_HAL_HEAP_NUMA_POLICY_BIND,
+  // Device-local storage is interleaved page-by-page across all nodes in the
+  // node mask. Useful when workers on all nodes touch the same buffers.
+  IREE_HAL_HEAP_NUMA_POLICY_INTERLEAVE,
+} iree_hal_heap_numa_policy_t;
+
+// Creates a host-local heap allocator as with iree_hal_allocator_create_heap
+// that places device-local buffer storage on the NUMA nodes in |node_mask|
+// (bit N = node N) based on |policy|. Buffers that are not device-local (such
+// as host staging buffers) are allocated from |host_allocator|.
+//
+// Device-local storage is allocated directly from the system with page
+// granularity so that the placement policy can be applied before any pages
+// are touched. Usually |node_mask| is derived from the NUMA nodes of the task
+// executor topology groups that will be running the dispatches using the
+// buffers.
+IREE_API_EXPORT iree_status_t iree_hal_allocator_create_heap_numa(
+    iree_string_view_t identifier, iree_hal_heap_numa_policy_t policy,
+    uint64_t node_mask, iree_allocator_t host_allocator,
+    iree_hal_allocator_t** out_allocator);
+
 //===----------------------------------------------------------------------===//
 // iree_hal_allocator_t implementation details
 //===----------------------------------------------------------------------===//
@@ -7,6 +7,7 @@
 #include <stddef.h>
 
 #include "iree/base/api.h"
+#include "iree/base/internal/memory.h"
 #include "iree/hal/allocator.h"
 #include "iree/hal/buffer.h"
 #include "iree/hal/buffer_heap_impl.h"
@@ -16,6 +17,11 @@ typedef struct iree_hal_heap_allocator_t {
   iree_hal_resource_t resource;
   iree_allocator_t host_allocator;
   iree_allocator_t data_allocator;
+  // Allocator used for device-local buffer storage. Either |data_allocator| or
+  // a NUMA allocator referencing |numa_params|.
+  iree_allocator_t device_local_data_allocator;
+  // NUMA placement of device-local storage; unused if the policy is default.
+  iree_memory_numa_params_t numa_params;
   iree_string_view_t identifier;
   IREE_STATISTICS(iree_hal_heap_allocator_statistics_t statistics;)
 } iree_hal_heap_allocator_t;
@@ -27,9 +33,10 @@ iree_hal_heap_allocator_t* iree_hal_heap_allocator_cast(
   return (iree_hal_heap_allocator_t*)base_value;
 }
 
-IREE_API_EXPORT iree_status_t iree_hal_allocator_create_heap(
+static iree_status_t iree_hal_heap_allocator_create_internal(
     iree_string_view_t identifier, iree_allocator_t data_allocator,
-    iree_allocator_t host_allocator, iree_hal_allocator_t** out_allocator) {
+    iree_memory_numa_params_t numa_params, iree_allocator_t host_allocator,
+    iree_hal_allocator_t** out_allocator) {
   IREE_ASSERT_ARGUMENT(out_allocator);
   *out_allocator = NULL;
   IREE_TRACE_ZONE_BEGIN(z0);
@@ -44,6 +51,15 @@ IREE_API_EXPORT iree_status_t iree_hal_allocator_create_heap(
                                  &allocator->resource);
     allocator->host_allocator = host_allocator;
     allocator->data_allocator = data_allocator;
+    allocator->numa_params = numa_params;
+    if (numa_params.policy == IREE_MEMORY_NUMA_POLICY_DEFAULT) {
+      allocator->device_local_data_allocator = data_allocator;
+    } else {
+      // NOTE: the NUMA allocator references the params stored in the allocator
+      // and buffers must not outlive the allocator that created them.
+      allocator->device_local_data_allocator =
+          iree_allocator_numa(&allocator->numa_params);
+    }
     iree_string_view_append_to_buffer(
         identifier, &allocator->identifier,
         (char*)allocator + iree_sizeof_struct(*allocator));
@@ -60,6 +76,50 @@ IREE_API_EXPORT iree_status_t iree_hal_allocator_create_heap(
   return status;
 }
 
+IREE_API_EXPORT iree_status_t iree_hal_allocator_create_heap(
+    iree_string_view_t identifier, iree_allocator_t data_allocator,
+    iree_allocator_t host_allocator, iree_hal_allocator_t** out_allocator) {
+  iree_memory_numa_params_t numa_params = {
+      .policy = IREE_MEMORY_NUMA_POLICY_DEFAULT,
+      .node_mask = 0,
+  };
+  return iree_hal_heap_allocator_create_internal(
+      identifier, data_allocator, numa_params, host_allocator, out_allocator);
+}
+
+IREE_API_EXPORT iree_status_t iree_hal_allocator_create_heap_numa(
+    iree_string_view_t identifier, iree_hal_heap_numa_policy_t policy,
+    uint64_t node_mask, iree_allocator_t host_allocator,
+    iree_hal_allocator_t** out_allocator) {
+  iree_memory_numa_params_t numa_params = {
+      .policy = IREE_MEMORY_NUMA_POLICY_DEFAULT,
+      .node_mask = node_mask,
+  };
+  switch (policy) {
+    case IREE_HAL_HEAP_NUMA_POLICY_NONE:
+      numa_params.policy = IREE_MEMORY_NUMA_POLICY_DEFAULT;
+      break;
+    case IREE_HAL_HEAP_NUMA_POLICY_PREFERRED:
+      numa_params.policy = IREE_MEMORY_NUMA_POLICY_PREFERRED;
+      break;
+    case IREE_HAL_HEAP_NUMA_POLICY_BIND:
+      numa_params.policy = IREE_MEMORY_NUMA_POLICY_BIND;
+      break;
+    case IREE_HAL_HEAP_NUMA_POLICY_INTERLEAVE:
+      numa_params.policy = IREE_MEMORY_NUMA_POLICY_INTERLEAVE;
+      break;
+    default:
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "unknown NUMA policy %d", (int)policy);
+  }
+  if (numa_params.policy != IREE_MEMORY_NUMA_POLICY_DEFAULT && !node_mask) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "at least one NUMA node must be specified");
+  }
+  return iree_hal_heap_allocator_create_internal(
+      identifier, host_allocator, numa_params, host_allocator, out_allocator);
+}
+
 static void iree_hal_heap_allocator_destroy(
     iree_hal_allocator_t* IREE_RESTRICT base_allocator) {
   iree_hal_heap_allocator_t* allocator =
@@ -196,10 +256,16 @@ static iree_status_t iree_hal_heap_allocator_allocate_buffer(
   // Allocate the buffer (both the wrapper and the contents).
   iree_hal_heap_allocator_statistics_t* statistics = NULL;
   IREE_STATISTICS(statistics = &allocator->statistics);
+  // Device-local storage may have a placement policy while everything else
+  // (staging buffers/etc) is placed wherever the host touches it first.
+  iree_allocator_t data_allocator =
+      iree_all_bits_set(compat_params.type, IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL)
+          ? allocator->device_local_data_allocator
+          : allocator->data_allocator;
   iree_hal_buffer_t* buffer = NULL;
   IREE_RETURN_IF_ERROR(iree_hal_heap_buffer_create(
       base_allocator, statistics, &compat_params, allocation_size,
-      allocator->data_allocator, allocator->host_allocator, &buffer));
+      data_allocator, allocator->host_allocator, &buffer));
 
   *out_buffer = buffer;
   return iree_ok_status();
@@ -590,6 +590,69 @@ TEST_P(command_buffer_test, UpdateBufferSubspan) {
   iree_hal_buffer_release(device_buffer);
 }
 
+TEST_P(command_buffer_test, SubmitReusable) {
+  iree_device_size_t buffer_size = 16;
+  std::vector<uint8_t> source_buffer{0x01, 0x02, 0x03, 0x04,  //
+                                     0x05, 0x06, 0x07, 0x08,  //
+                                     0xA1, 0xA2, 0xA3, 0xA4,  //
+                                     0xA5, 0xA6, 0xA7, 0xA8};
+
+  iree_hal_buffer_t* update_buffer = NULL;
+  CreateZeroedDeviceBuffer(buffer_size, &update_buffer);
+  iree_hal_buffer_t* copy_buffer = NULL;
+  CreateZeroedDeviceBuffer(buffer_size, &copy_buffer);
+
+  // Not all drivers support command buffers without the one-shot mode.
+  iree_hal_command_buffer_t* command_buffer = NULL;
+  iree_status_t status = iree_hal_command_buffer_create(
+      device_, /*mode=*/0, IREE_HAL_COMMAND_CATEGORY_ANY,
+      IREE_HAL_QUEUE_AFFINITY_ANY, /*binding_capacity=*/0, &command_buffer);
+  if (iree_status_is_unimplemented(status)) {
+    iree_status_ignore(status);
+    iree_hal_buffer_release(copy_buffer);
+    iree_hal_buffer_release(update_buffer);
+    GTEST_SKIP() << "reusable command buffers not supported";
+  }
+  IREE_ASSERT_OK(status);
+
+  // Record a dependent update and copy once.
+  IREE_ASSERT_OK(iree_hal_command_buffer_begin(command_buffer));
+  IREE_ASSERT_OK(iree_hal_command_buffer_update_buffer(
+      command_buffer, source_buffer.data(), /*source_offset=*/0, update_buffer,
+      /*target_offset=*/0, /*length=*/buffer_size));
+  IREE_ASSERT_OK(iree_hal_command_buffer_execution_barrier(
+      command_buffer,
+      /*source_stage_mask=*/IREE_HAL_EXECUTION_STAGE_TRANSFER,
+      /*target_stage_mask=*/IREE_HAL_EXECUTION_STAGE_TRANSFER,
+      IREE_HAL_EXECUTION_BARRIER_FLAG_NONE, /*memory_barrier_count=*/0,
+      /*memory_barriers=*/NULL,
+      /*buffer_barrier_count=*/0, /*buffer_barriers=*/NULL));
+  IREE_ASSERT_OK(iree_hal_command_buffer_copy_buffer(
+      command_buffer, /*source_buffer=*/update_buffer, /*source_offset=*/0,
+      /*target_buffer=*/copy_buffer, /*target_offset=*/0,
+      /*length=*/buffer_size));
+  IREE_ASSERT_OK(iree_hal_command_buffer_end(command_buffer));
+
+  // Submit it several times, clearing the results in between.
+  for (int i = 0; i < 3; ++i) {
+    IREE_ASSERT_OK(
+        iree_hal_buffer_map_zero(update_buffer, 0, IREE_WHOLE_BUFFER));
+    IREE_ASSERT_OK(iree_hal_buffer_map_zero(copy_buffer, 0, IREE_WHOLE_BUFFER));
+    IREE_ASSERT_OK(SubmitCommandBufferAndWait(command_buffer));
+
+    std::vector<uint8_t> actual_data(buffer_size);
+    IREE_ASSERT_OK(iree_hal_device_transfer_d2h(
+        device_, copy_buffer, /*source_offset=*/0, actual_data.data(),
+        actual_data.size(), IREE_HAL_TRANSFER_BUFFER_FLAG_DEFAULT,
+        iree_infinite_timeout()));
+    EXPECT_THAT(actual_data, ContainerEq(source_buffer));
+  }
+
+  iree_hal_command_buffer_release(command_buffer);
+  iree_hal_buffer_release(copy_buffer);
+  iree_hal_buffer_release(update_buffer);
+}
+
 }  // namespace cts
 }  // namespace hal
 }  // namespace iree
@@ -18,7 +18,9 @@
 #include "iree/hal/local/inline_command_buffer.h"
 #include "iree/hal/local/local_executable_cache.h"
 #include "iree/hal/local/local_pipeline_layout.h"
+#include "iree/hal/local/profiling.h"
 #include "iree/hal/utils/deferred_command_buffer.h"
+#include "iree/hal/utils/fd_file.h"
 #include "iree/hal/utils/file_transfer.h"
 #include "iree/hal/utils/memory_file.h"
 
@@ -32,6 +34,9 @@ typedef struct iree_hal_sync_device_t {
   // Optional provider used for creating/configuring collective channels.
   iree_hal_channel_provider_t* channel_provider;
 
+  // Active profiling session begun on this device, if any.
+  iree_hal_local_profiling_session_t* profiling_session;
+
   // Block pool used for command buffers with a larger block size (as command
   // buffers can contain inlined data uploads).
   iree_arena_block_pool_t large_block_pool;
@@ -130,6 +135,8 @@ static void iree_hal_sync_device_destroy(iree_hal_device_t* base_device) {
     iree_hal_executable_loader_release(device->loaders[i]);
   }
 
+  iree_status_ignore(
+      iree_hal_local_profiling_session_end(device->profiling_session));
   iree_hal_allocator_release(device->device_allocator);
   iree_hal_channel_provider_release(device->channel_provider);
 
@@ -275,15 +282,21 @@ static iree_status_t iree_hal_sync_device_import_file(
     iree_hal_device_t* base_device, iree_hal_queue_affinity_t queue_affinity,
     iree_hal_memory_access_t access, iree_io_file_handle_t* handle,
     iree_hal_external_file_flags_t flags, iree_hal_file_t** out_file) {
-  if (iree_io_file_handle_type(handle) !=
-      IREE_IO_FILE_HANDLE_TYPE_HOST_ALLOCATION) {
-    return iree_make_status(
-        IREE_STATUS_UNAVAILABLE,
-        "implementation does not support the external file type");
+  switch (iree_io_file_handle_type(handle)) {
+    case IREE_IO_FILE_HANDLE_TYPE_HOST_ALLOCATION:
+      return iree_hal_memory_file_wrap(
+          queue_affinity, access, handle,
+          iree_hal_device_allocator(base_device),
+          iree_hal_device_host_allocator(base_device), out_file);
+    case IREE_IO_FILE_HANDLE_TYPE_FD:
+      return iree_hal_fd_file_from_handle(
+          access, handle, iree_hal_device_host_allocator(base_device),
+          out_file);
+    default:
+      return iree_make_status(
+          IREE_STATUS_UNAVAILABLE,
+          "implementation does not support the external file type");
   }
-  return iree_hal_memory_file_wrap(
-      queue_affinity, access, handle, iree_hal_device_allocator(base_device),
-      iree_hal_device_host_allocator(base_device), out_file);
 }
 
 static iree_status_t iree_hal_sync_device_create_pipeline_layout(
@@ -471,27 +484,31 @@ static iree_status_t iree_hal_sync_device_wait_semaphores(
 static iree_status_t iree_hal_sync_device_profiling_begin(
     iree_hal_device_t* base_device,
     const iree_hal_device_profiling_options_t* options) {
-  // Unimplemented (and that's ok).
-  // We could hook in to vendor APIs (Intel/ARM/etc) or generic perf infra:
-  // https://man7.org/linux/man-pages/man2/perf_event_open.2.html
-  // Capturing things like:
-  //   PERF_COUNT_HW_CPU_CYCLES / PERF_COUNT_HW_INSTRUCTIONS
-  //   PERF_COUNT_HW_CACHE_REFERENCES / PERF_COUNT_HW_CACHE_MISSES
-  //   etc
-  // TODO(benvanik): shared iree/hal/local/profiling implementation of this.
-  return iree_ok_status();
+  iree_hal_sync_device_t* device = iree_hal_sync_device_cast(base_device);
+  if (device->profiling_session) {
+    return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                            "profiling already begun on this device");
+  }
+  // Dispatch counters are captured around each executable call with
+  // perf_event_open; see iree/hal/local/profiling.h. Other modes are
+  // unimplemented (and that's ok).
+  return iree_hal_local_profiling_session_begin(
+      options, device->host_allocator, &device->profiling_session);
 }
 
 static iree_status_t iree_hal_sync_device_profiling_flush(
     iree_hal_device_t* base_device) {
-  // Unimplemented (and that's ok).
-  return iree_ok_status();
+  iree_hal_sync_device_t* device = iree_hal_sync_device_cast(base_device);
+  return iree_hal_local_profiling_session_flush(device->profiling_session);
 }
 
 static iree_status_t iree_hal_sync_device_profiling_end(
     iree_hal_device_t* base_device) {
-  // Unimplemented (and that's ok).
-  return iree_ok_status();
+  iree_hal_sync_device_t* device = iree_hal_sync_device_cast(base_device);
+  iree_status_t status =
+      iree_hal_local_profiling_session_end(device->profiling_session);
+  device->profiling_session = NULL;
+  return status;
 }
 
 static const iree_hal_device_vtable_t iree_hal_sync_device_vtable = {
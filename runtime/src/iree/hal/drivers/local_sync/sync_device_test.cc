@@ -0,0 +1,308 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// Tests for the dispatch counters profiling of the synchronous device. The
+// profiling implementation is shared by all local devices but the synchronous
+// device issues all executable calls on the calling thread which makes the
+// output deterministic.
+
+#include "iree/hal/drivers/local_sync/sync_device.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/hal/local/executable_library.h"
+#include "iree/hal/local/loaders/static_library_loader.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+#if defined(IREE_PLATFORM_LINUX) || defined(IREE_PLATFORM_ANDROID)
+#include <errno.h>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif  // IREE_PLATFORM_LINUX || IREE_PLATFORM_ANDROID
+
+namespace {
+
+//===----------------------------------------------------------------------===//
+// Test executable library
+//===----------------------------------------------------------------------===//
+
+// Spins for a few microseconds so that each workgroup takes measurable time.
+static int spin(
+    const iree_hal_executable_environment_v0_t* environment,
+    const iree_hal_executable_dispatch_state_v0_t* dispatch_state,
+    const iree_hal_executable_workgroup_state_v0_t* workgroup_state) {
+  const iree_time_t deadline = iree_time_now() + 10 * 1000;
+  while (iree_time_now() < deadline) {
+  }
+  return 0;
+}
+
+static const iree_hal_executable_library_header_t test_library_header = {
+    IREE_HAL_EXECUTABLE_LIBRARY_VERSION_LATEST,
+    "sync_device_test",
+    IREE_HAL_EXECUTABLE_LIBRARY_FEATURE_NONE,
+    IREE_HAL_EXECUTABLE_LIBRARY_SANITIZER_NONE,
+};
+static const iree_hal_executable_dispatch_v0_t test_library_entry_points[] = {
+    spin,
+};
+static const char* test_library_entry_point_names[] = {
+    "spin",
+};
+static const iree_hal_executable_library_v0_t test_library = {
+    &test_library_header,
+    /*imports=*/{0, NULL},
+    /*exports=*/
+    {
+        IREE_ARRAYSIZE(test_library_entry_points),
+        test_library_entry_points,
+        /*attrs=*/NULL,
+        test_library_entry_point_names,
+    },
+};
+
+static const iree_hal_executable_library_header_t** test_library_query(
+    iree_hal_executable_library_version_t max_version,
+    const iree_hal_executable_environment_v0_t* environment) {
+  return max_version <= IREE_HAL_EXECUTABLE_LIBRARY_VERSION_LATEST
+             ? (const iree_hal_executable_library_header_t**)&test_library
+             : NULL;
+}
+
+//===----------------------------------------------------------------------===//
+// Helpers
+//===----------------------------------------------------------------------===//
+
+// Whether hardware counters can be opened on the calling thread.
+enum class PerfEventAccess {
+  kAvailable,
+  // No hardware counters (virtual machines, unsupported CPUs).
+  kUnsupported,
+  // Denied by perf_event_paranoid or the sandbox.
+  kDenied,
+};
+
+static PerfEventAccess QueryPerfEventAccess() {
+#if defined(IREE_PLATFORM_LINUX) || defined(IREE_PLATFORM_ANDROID)
+  struct perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.config = PERF_COUNT_HW_CPU_CYCLES;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  int fd = (int)syscall(SYS_perf_event_open, &attr, /*pid=*/0, /*cpu=*/-1,
+                        /*group_fd=*/-1, /*flags=*/0);
+  if (fd >= 0) {
+    close(fd);
+    return PerfEventAccess::kAvailable;
+  }
+  return errno == EACCES || errno == EPERM ? PerfEventAccess::kDenied
+                                           : PerfEventAccess::kUnsupported;
+#else
+  return PerfEventAccess::kDenied;
+#endif  // IREE_PLATFORM_LINUX || IREE_PLATFORM_ANDROID
+}
+
+static std::vector<std::string> Split(const std::string& line, char sep) {
+  std::vector<std::string> fields;
+  std::stringstream stream(line);
+  std::string field;
+  while (std::getline(stream, field, sep)) fields.push_back(field);
+  // getline drops a trailing empty field.
+  if (!line.empty() && line.back() == sep) fields.push_back("");
+  return fields;
+}
+
+static std::vector<std::string> ReadLines(const std::string& path) {
+  std::ifstream file(path);
+  std::vector<std::string> lines;
+  std::string line;
+  while (std::getline(file, line)) lines.push_back(line);
+  return lines;
+}
+
+//===----------------------------------------------------------------------===//
+// Test fixture
+//===----------------------------------------------------------------------===//
+
+class SyncDeviceProfilingTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    iree_allocator_t host_allocator = iree_allocator_system();
+    const iree_hal_executable_library_query_fn_t library_query_fns[] = {
+        test_library_query,
+    };
+    IREE_ASSERT_OK(iree_hal_static_library_loader_create(
+        IREE_ARRAYSIZE(library_query_fns), library_query_fns,
+        iree_hal_executable_import_provider_null(), host_allocator, &loader_));
+    IREE_ASSERT_OK(iree_hal_allocator_create_heap(
+        IREE_SV("heap"), host_allocator, host_allocator, &device_allocator_));
+    device_ = CreateDevice();
+
+    IREE_ASSERT_OK(iree_hal_pipeline_layout_create(
+        device_, /*push_constants=*/0, /*set_layout_count=*/0, NULL,
+        &pipeline_layout_));
+    IREE_ASSERT_OK(iree_hal_executable_cache_create(
+        device_, IREE_SV("default"), iree_loop_inline(&loop_status_),
+        &executable_cache_));
+    iree_hal_executable_params_t executable_params;
+    iree_hal_executable_params_initialize(&executable_params);
+    executable_params.executable_format = IREE_SV("static");
+    executable_params.executable_data = iree_make_const_byte_span(
+        test_library_header.name, strlen(test_library_header.name));
+    executable_params.pipeline_layout_count = 1;
+    executable_params.pipeline_layouts = &pipeline_layout_;
+    IREE_ASSERT_OK(iree_hal_executable_cache_prepare_executable(
+        executable_cache_, &executable_params, &executable_));
+
+    file_path_ = ::testing::TempDir() + "/sync_device_test_counters.csv";
+  }
+
+  void TearDown() override {
+    iree_hal_executable_release(executable_);
+    iree_hal_executable_cache_release(executable_cache_);
+    iree_hal_pipeline_layout_release(pipeline_layout_);
+    for (iree_hal_device_t* device : extra_devices_) {
+      iree_hal_device_release(device);
+    }
+    iree_hal_device_release(device_);
+    iree_hal_allocator_release(device_allocator_);
+    iree_hal_executable_loader_release(loader_);
+    IREE_ASSERT_OK(loop_status_);
+    std::remove(file_path_.c_str());
+  }
+
+  iree_hal_device_t* CreateDevice() {
+    iree_hal_sync_device_params_t params;
+    iree_hal_sync_device_params_initialize(&params);
+    iree_hal_device_t* device = NULL;
+    IREE_CHECK_OK(iree_hal_sync_device_create(
+        IREE_SV("local-sync"), &params, /*loader_count=*/1, &loader_,
+        device_allocator_, iree_allocator_system(), &device));
+    return device;
+  }
+
+  // Begins a dispatch counters profiling session on |device| writing to
+  // |file_path_|.
+  iree_status_t BeginProfiling(iree_hal_device_t* device) {
+    iree_hal_device_profiling_options_t options = {};
+    options.mode = IREE_HAL_DEVICE_PROFILING_MODE_DISPATCH_COUNTERS;
+    options.file_path = file_path_.c_str();
+    return iree_hal_device_profiling_begin(device, &options);
+  }
+
+  // Dispatches |workgroup_count| workgroups of the spin export and waits for
+  // them to complete.
+  void Dispatch(uint32_t workgroup_count) {
+    iree_hal_command_buffer_t* command_buffer = NULL;
+    IREE_ASSERT_OK(iree_hal_command_buffer_create(
+        device_, IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT,
+        IREE_HAL_COMMAND_CATEGORY_DISPATCH, IREE_HAL_QUEUE_AFFINITY_ANY,
+        /*binding_capacity=*/0, &command_buffer));
+    IREE_ASSERT_OK(iree_hal_command_buffer_begin(command_buffer));
+    IREE_ASSERT_OK(iree_hal_command_buffer_dispatch(
+        command_buffer, executable_, /*entry_point=*/0, workgroup_count, 1, 1));
+    IREE_ASSERT_OK(iree_hal_command_buffer_end(command_buffer));
+    IREE_ASSERT_OK(iree_hal_device_queue_execute(
+        device_, IREE_HAL_QUEUE_AFFINITY_ANY, iree_hal_semaphore_list_empty(),
+        iree_hal_semaphore_list_empty(), 1, &command_buffer));
+    iree_hal_command_buffer_release(command_buffer);
+  }
+
+  iree_hal_executable_loader_t* loader_ = NULL;
+  iree_hal_allocator_t* device_allocator_ = NULL;
+  iree_hal_device_t* device_ = NULL;
+  std::vector<iree_hal_device_t*> extra_devices_;
+  iree_hal_pipeline_layout_t* pipeline_layout_ = NULL;
+  iree_status_t loop_status_ = iree_ok_status();
+  iree_hal_executable_cache_t* executable_cache_ = NULL;
+  iree_hal_executable_t* executable_ = NULL;
+  std::string file_path_;
+};
+
+// Each flush appends one row per export called since the previous flush.
+TEST_F(SyncDeviceProfilingTest, DispatchCountersFile) {
+  PerfEventAccess access = QueryPerfEventAccess();
+  if (access == PerfEventAccess::kDenied) {
+    GTEST_SKIP() << "perf_event_open is not available or permitted";
+  }
+
+  IREE_ASSERT_OK(BeginProfiling(device_));
+  Dispatch(/*workgroup_count=*/8);
+  IREE_ASSERT_OK(iree_hal_device_profiling_flush(device_));
+  // Flushing without calls adds no rows.
+  IREE_ASSERT_OK(iree_hal_device_profiling_flush(device_));
+  Dispatch(/*workgroup_count=*/3);
+  Dispatch(/*workgroup_count=*/1);
+  IREE_ASSERT_OK(iree_hal_device_profiling_end(device_));
+  // Calls after the session has ended are not counted.
+  Dispatch(/*workgroup_count=*/2);
+
+  std::vector<std::string> lines = ReadLines(file_path_);
+  ASSERT_EQ(3, lines.size());
+  EXPECT_EQ(
+      "flush,thread_id,worker_id,dispatch,workgroups,time_ns,cycles,"
+      "instructions,cache_misses",
+      lines[0]);
+  const char* expected_flushes[] = {"0", "2"};
+  const char* expected_workgroups[] = {"8", "4"};
+  for (int i = 0; i < 2; ++i) {
+    SCOPED_TRACE(lines[i + 1]);
+    std::vector<std::string> fields = Split(lines[i + 1], ',');
+    ASSERT_EQ(9, fields.size());
+    EXPECT_EQ(expected_flushes[i], fields[0]);
+#if defined(IREE_PLATFORM_LINUX) || defined(IREE_PLATFORM_ANDROID)
+    // The synchronous device issues calls on the submitting thread.
+    EXPECT_EQ(std::to_string(syscall(SYS_gettid)), fields[1]);
+#endif  // IREE_PLATFORM_LINUX || IREE_PLATFORM_ANDROID
+    EXPECT_EQ("spin", fields[3]);
+    EXPECT_EQ(expected_workgroups[i], fields[4]);
+    EXPECT_GT(std::stoll(fields[5]), 0);
+    // Counters that cannot be opened are left empty.
+    if (access == PerfEventAccess::kAvailable) {
+      EXPECT_GT(std::stod(fields[6]), 0.0);
+    } else {
+      EXPECT_EQ("", fields[6]);
+      EXPECT_EQ("", fields[7]);
+      EXPECT_EQ("", fields[8]);
+    }
+  }
+}
+
+// Hardware counters are per-thread so only one session may be active in the
+// process regardless of the device it was begun on.
+TEST_F(SyncDeviceProfilingTest, OneSessionPerProcess) {
+  iree_status_t status = BeginProfiling(device_);
+  if (iree_status_is_unavailable(status)) {
+    iree_status_ignore(status);
+    GTEST_SKIP() << "dispatch counters are not supported";
+  }
+  IREE_ASSERT_OK(status);
+  IREE_EXPECT_STATUS_IS(IREE_STATUS_FAILED_PRECONDITION,
+                        BeginProfiling(device_));
+  iree_hal_device_t* other_device = CreateDevice();
+  extra_devices_.push_back(other_device);
+  IREE_EXPECT_STATUS_IS(IREE_STATUS_FAILED_PRECONDITION,
+                        BeginProfiling(other_device));
+  IREE_ASSERT_OK(iree_hal_device_profiling_end(device_));
+
+  // Once ended another device may begin a session.
+  IREE_ASSERT_OK(BeginProfiling(other_device));
+  IREE_ASSERT_OK(iree_hal_device_profiling_end(other_device));
+}
+
+}  // namespace
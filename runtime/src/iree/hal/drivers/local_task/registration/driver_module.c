@@ -20,6 +20,70 @@ IREE_FLAG(
     bool, task_abort_on_failure, false,
     "Aborts the program on the first failure within a task system queue.");
 
+IREE_FLAG(
+    string, task_executable_cache_dir, "",
+    "Existing directory used to persist loaded executables across processes.\n"
+    "Executables allowing persistent caching are stored keyed by content hash\n"
+    "and on subsequent runs are mapped from the directory instead of being\n"
+    "reloaded and relocated. Empty disables persistence.");
+
+IREE_FLAG(
+    string, task_allocator_numa_policy, "none",
+    "NUMA placement policy for device-local buffer storage:\n"
+    "  'none': no policy; pages are placed by the OS on first touch.\n"
+    "  'local': prefer the nodes the task executors run on.\n"
+    "  'bind': require the nodes the task executors run on.\n"
+    "  'interleave': interleave pages across all nodes in the system.");
+
+static iree_status_t iree_hal_local_task_parse_numa_policy(
+    iree_string_view_t value, iree_hal_heap_numa_policy_t* out_policy) {
+  if (iree_string_view_is_empty(value) ||
+      iree_string_view_equal(value, IREE_SV("none"))) {
+    *out_policy = IREE_HAL_HEAP_NUMA_POLICY_NONE;
+  } else if (iree_string_view_equal(value, IREE_SV("local"))) {
+    *out_policy = IREE_HAL_HEAP_NUMA_POLICY_PREFERRED;
+  } else if (iree_string_view_equal(value, IREE_SV("bind"))) {
+    *out_policy = IREE_HAL_HEAP_NUMA_POLICY_BIND;
+  } else if (iree_string_view_equal(value, IREE_SV("interleave"))) {
+    *out_policy = IREE_HAL_HEAP_NUMA_POLICY_INTERLEAVE;
+  } else {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "unknown --task_allocator_numa_policy '%.*s'; "
+                            "expected none, local, bind, or interleave",
+                            (int)value.size, value.data);
+  }
+  return iree_ok_status();
+}
+
+// Creates the heap allocator used for device-local storage with the NUMA
+// policy specified by flags applied to the nodes |executors| run on.
+static iree_status_t iree_hal_local_task_create_device_allocator_from_flags(
+    iree_host_size_t executor_count, iree_task_executor_t** executors,
+    iree_allocator_t host_allocator, iree_hal_allocator_t** out_allocator) {
+  iree_hal_heap_numa_policy_t policy = IREE_HAL_HEAP_NUMA_POLICY_NONE;
+  IREE_RETURN_IF_ERROR(iree_hal_local_task_parse_numa_policy(
+      iree_make_cstring_view(FLAG_task_allocator_numa_policy), &policy));
+  if (policy == IREE_HAL_HEAP_NUMA_POLICY_NONE) {
+    return iree_hal_allocator_create_heap(iree_make_cstring_view("local"),
+                                          host_allocator, host_allocator,
+                                          out_allocator);
+  }
+
+  uint64_t node_mask = 0;
+  if (policy == IREE_HAL_HEAP_NUMA_POLICY_INTERLEAVE) {
+    iree_host_size_t node_count = iree_task_topology_query_node_count();
+    node_mask = node_count >= 64 ? UINT64_MAX : ((1ull << node_count) - 1);
+  } else {
+    for (iree_host_size_t i = 0; i < executor_count; ++i) {
+      node_mask |= iree_task_executor_node_mask(executors[i]);
+    }
+  }
+  if (!node_mask) node_mask = 1ull;  // node 0 as a fallback
+  return iree_hal_allocator_create_heap_numa(iree_make_cstring_view("local"),
+                                             policy, node_mask, host_allocator,
+                                             out_allocator);
+}
+
 static iree_status_t iree_hal_local_task_driver_factory_enumerate(
     void* self, iree_host_size_t* out_driver_info_count,
     const iree_hal_driver_info_t** out_driver_infos) {
@@ -49,6 +113,8 @@ static iree_status_t iree_hal_local_task_driver_factory_try_create(
   if (FLAG_task_abort_on_failure) {
     default_params.queue_scope_flags |= IREE_TASK_SCOPE_FLAG_ABORT_ON_FAILURE;
   }
+  default_params.executable_cache_dir =
+      iree_make_cstring_view(FLAG_task_executable_cache_dir);
 
   // Create executors for each topology specified by flags.
   // Stack allocated storage today but we can query for the total count and
@@ -76,9 +142,8 @@ static iree_status_t iree_hal_local_task_driver_factory_try_create(
   // TODO(benvanik): allow this to be injected to share across drivers.
   iree_hal_allocator_t* device_allocator = NULL;
   if (iree_status_is_ok(status)) {
-    status = iree_hal_allocator_create_heap(iree_make_cstring_view("local"),
-                                            host_allocator, host_allocator,
-                                            &device_allocator);
+    status = iree_hal_local_task_create_device_allocator_from_flags(
+        executor_count, executors, host_allocator, &device_allocator);
   }
 
   // Create a task driver that will use the given executors for scheduling work
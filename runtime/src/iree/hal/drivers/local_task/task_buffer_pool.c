@@ -0,0 +1,617 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/drivers/local_task/task_buffer_pool.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#include "iree/base/internal/atomics.h"
+#include "iree/base/internal/synchronization.h"
+
+//===----------------------------------------------------------------------===//
+// iree_hal_task_buffer_pool_t
+//===----------------------------------------------------------------------===//
+
+// Persistently mapped storage that is either owned by a live allocation or
+// waiting in the pool free list for reuse.
+typedef struct iree_hal_task_buffer_pool_block_t {
+  struct iree_hal_task_buffer_pool_block_t* next;
+
+  // Parameters the storage was requested with. Reuse requires an exact match
+  // as the buffers handed out are created with them.
+  iree_hal_memory_type_t type;
+  iree_hal_memory_access_t access;
+  iree_hal_buffer_usage_t usage;
+
+  // Storage allocated from the device allocator along with its mapping.
+  iree_hal_buffer_t* storage;
+  iree_hal_buffer_mapping_t mapping;
+
+  // Timepoints that must all be reached before the storage is reused, set by
+  // the dealloca that returned it to the pool. Semaphores are retained and
+  // both arrays are stored in a single host allocation.
+  iree_hal_semaphore_list_t release_list;
+} iree_hal_task_buffer_pool_block_t;
+
+static iree_device_size_t iree_hal_task_buffer_pool_block_size(
+    const iree_hal_task_buffer_pool_block_t* block) {
+  return block->mapping.contents.data_length;
+}
+
+// Whether the storage of a block in the free list can be reused.
+typedef enum iree_hal_task_buffer_pool_block_state_e {
+  // Some release timepoint has not yet been reached.
+  IREE_HAL_TASK_BUFFER_POOL_BLOCK_STATE_PENDING = 0,
+  // All release timepoints have been reached or are waited on.
+  IREE_HAL_TASK_BUFFER_POOL_BLOCK_STATE_RELEASED,
+  // A release semaphore has failed and the timepoint will never be reached.
+  IREE_HAL_TASK_BUFFER_POOL_BLOCK_STATE_FAILED,
+} iree_hal_task_buffer_pool_block_state_t;
+
+struct iree_hal_task_buffer_pool_t {
+  // Retained by the device and each live buffer.
+  iree_atomic_ref_count_t ref_count;
+  iree_allocator_t host_allocator;
+
+  // Released blocks are freed once the free list holds more than this many
+  // bytes.
+  iree_device_size_t max_free_size;
+
+  // Guards the free list and the block ownership of each buffer. Allocation
+  // traffic is low compared to dispatch traffic and all work under the lock is
+  // bounded so a mutex is fine.
+  iree_slim_mutex_t mutex;
+
+  // Blocks available for reuse, most recently returned first.
+  iree_hal_task_buffer_pool_block_t* free_head IREE_GUARDED_BY(mutex);
+  // Total size of the blocks in the free list.
+  iree_device_size_t free_size IREE_GUARDED_BY(mutex);
+};
+
+static void iree_hal_task_buffer_pool_free(iree_hal_task_buffer_pool_t* pool);
+
+iree_status_t iree_hal_task_buffer_pool_create(
+    iree_device_size_t max_free_size, iree_allocator_t host_allocator,
+    iree_hal_task_buffer_pool_t** out_pool) {
+  IREE_ASSERT_ARGUMENT(out_pool);
+  *out_pool = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_hal_task_buffer_pool_t* pool = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(host_allocator, sizeof(*pool), (void**)&pool));
+  memset(pool, 0, sizeof(*pool));
+  iree_atomic_ref_count_init(&pool->ref_count);  // -> 1
+  pool->host_allocator = host_allocator;
+  pool->max_free_size = max_free_size;
+  iree_slim_mutex_initialize(&pool->mutex);
+
+  *out_pool = pool;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+// Releases the release timepoints of |block|, if any.
+static void iree_hal_task_buffer_pool_block_reset_release(
+    iree_hal_task_buffer_pool_t* pool,
+    iree_hal_task_buffer_pool_block_t* block) {
+  for (iree_host_size_t i = 0; i < block->release_list.count; ++i) {
+    iree_hal_semaphore_release(block->release_list.semaphores[i]);
+  }
+  iree_allocator_free(pool->host_allocator, block->release_list.semaphores);
+  block->release_list = iree_hal_semaphore_list_empty();
+}
+
+static void iree_hal_task_buffer_pool_block_free(
+    iree_hal_task_buffer_pool_t* pool,
+    iree_hal_task_buffer_pool_block_t* block) {
+  iree_hal_task_buffer_pool_block_reset_release(pool, block);
+  iree_status_ignore(iree_hal_buffer_unmap_range(&block->mapping));
+  iree_hal_buffer_release(block->storage);
+  iree_allocator_free(pool->host_allocator, block);
+}
+
+static void iree_hal_task_buffer_pool_free(iree_hal_task_buffer_pool_t* pool) {
+  iree_allocator_t host_allocator = pool->host_allocator;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Live buffers retain the pool so only free blocks remain. Any queue work
+  // still pending on their release timepoints would have had to retain the
+  // buffers and thus the pool.
+  while (pool->free_head) {
+    iree_hal_task_buffer_pool_block_t* block = pool->free_head;
+    pool->free_head = block->next;
+    iree_hal_task_buffer_pool_block_free(pool, block);
+  }
+  IREE_ASSERT_REF_COUNT_ZERO(&pool->ref_count);
+
+  iree_slim_mutex_deinitialize(&pool->mutex);
+  iree_allocator_free(host_allocator, pool);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+void iree_hal_task_buffer_pool_retain(iree_hal_task_buffer_pool_t* pool) {
+  if (IREE_LIKELY(pool)) {
+    iree_atomic_ref_count_inc(&pool->ref_count);
+  }
+}
+
+void iree_hal_task_buffer_pool_release(iree_hal_task_buffer_pool_t* pool) {
+  if (IREE_LIKELY(pool) && iree_atomic_ref_count_dec(&pool->ref_count) == 1) {
+    iree_hal_task_buffer_pool_free(pool);
+  }
+}
+
+
+// Returns whether the storage of |block| can be reused by work ordered after
+// |wait_semaphore_list|. Timepoints are released when reached or waited on.
+// Semaphores that have failed make the block fail as the work they were
+// guarding may not have retired and the timepoints will never be reached.
+static iree_hal_task_buffer_pool_block_state_t
+iree_hal_task_buffer_pool_block_state(
+    iree_hal_task_buffer_pool_block_t* block,
+    const iree_hal_semaphore_list_t wait_semaphore_list) {
+  iree_hal_task_buffer_pool_block_state_t state =
+      IREE_HAL_TASK_BUFFER_POOL_BLOCK_STATE_RELEASED;
+  for (iree_host_size_t i = 0; i < block->release_list.count; ++i) {
+    iree_hal_semaphore_t* semaphore = block->release_list.semaphores[i];
+    uint64_t value = block->release_list.payload_values[i];
+    bool is_waited = false;
+    for (iree_host_size_t j = 0; j < wait_semaphore_list.count; ++j) {
+      if (wait_semaphore_list.semaphores[j] == semaphore &&
+          wait_semaphore_list.payload_values[j] >= value) {
+        is_waited = true;
+        break;
+      }
+    }
+    if (is_waited) continue;
+    uint64_t current_value = 0;
+    iree_status_t status = iree_hal_semaphore_query(semaphore, &current_value);
+    if (!iree_status_is_ok(status)) {
+      iree_status_ignore(status);
+      return IREE_HAL_TASK_BUFFER_POOL_BLOCK_STATE_FAILED;
+    }
+    if (current_value < value) {
+      state = IREE_HAL_TASK_BUFFER_POOL_BLOCK_STATE_PENDING;
+    }
+  }
+  return state;
+}
+
+// Returns |block| to the pool free list.
+// The pool mutex must be held by the caller.
+static void iree_hal_task_buffer_pool_push_block(
+    iree_hal_task_buffer_pool_t* pool,
+    iree_hal_task_buffer_pool_block_t* block) {
+  block->next = pool->free_head;
+  pool->free_head = block;
+  pool->free_size += iree_hal_task_buffer_pool_block_size(block);
+}
+
+// Removes the block at |block_ptr| from the pool free list and returns it.
+// The pool mutex must be held by the caller.
+static iree_hal_task_buffer_pool_block_t*
+iree_hal_task_buffer_pool_unlink_block(
+    iree_hal_task_buffer_pool_t* pool,
+    iree_hal_task_buffer_pool_block_t** block_ptr) {
+  iree_hal_task_buffer_pool_block_t* block = *block_ptr;
+  *block_ptr = block->next;
+  block->next = NULL;
+  pool->free_size -= iree_hal_task_buffer_pool_block_size(block);
+  return block;
+}
+
+// Moves released blocks from the free list to |evict_head| until the free list
+// is within the pool limit. The most recently returned blocks are kept as they
+// are the most likely to be reused soon and to still be in cache.
+// The pool mutex must be held by the caller.
+static void iree_hal_task_buffer_pool_evict_blocks(
+    iree_hal_task_buffer_pool_t* pool,
+    iree_hal_task_buffer_pool_block_t** evict_head) {
+  iree_device_size_t kept_size = 0;
+  iree_hal_task_buffer_pool_block_t** block_ptr = &pool->free_head;
+  while (*block_ptr && pool->free_size > pool->max_free_size) {
+    iree_hal_task_buffer_pool_block_t* block = *block_ptr;
+    iree_device_size_t block_size = iree_hal_task_buffer_pool_block_size(block);
+    if (kept_size + block_size > pool->max_free_size &&
+        iree_hal_task_buffer_pool_block_state(
+            block, iree_hal_semaphore_list_empty()) ==
+            IREE_HAL_TASK_BUFFER_POOL_BLOCK_STATE_RELEASED) {
+      iree_hal_task_buffer_pool_unlink_block(pool, block_ptr);
+      block->next = *evict_head;
+      *evict_head = block;
+    } else {
+      kept_size += block_size;
+      block_ptr = &block->next;
+    }
+  }
+}
+
+// Frees all blocks in the list starting at |block_head|.
+// Must be called without the pool mutex held.
+static void iree_hal_task_buffer_pool_free_blocks(
+    iree_hal_task_buffer_pool_t* pool,
+    iree_hal_task_buffer_pool_block_t* block_head) {
+  while (block_head) {
+    iree_hal_task_buffer_pool_block_t* block = block_head;
+    block_head = block->next;
+    iree_hal_task_buffer_pool_block_free(pool, block);
+  }
+}
+
+void iree_hal_task_buffer_pool_trim(iree_hal_task_buffer_pool_t* pool) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Unlink all released and failed blocks and then free them outside of the
+  // lock. Failed blocks are never reused and this is the only place where
+  // their storage is reclaimed.
+  iree_hal_task_buffer_pool_block_t* trim_head = NULL;
+  iree_slim_mutex_lock(&pool->mutex);
+  iree_hal_task_buffer_pool_block_t** block_ptr = &pool->free_head;
+  while (*block_ptr) {
+    iree_hal_task_buffer_pool_block_t* block = *block_ptr;
+    if (iree_hal_task_buffer_pool_block_state(
+            block, iree_hal_semaphore_list_empty()) !=
+        IREE_HAL_TASK_BUFFER_POOL_BLOCK_STATE_PENDING) {
+      iree_hal_task_buffer_pool_unlink_block(pool, block_ptr);
+      block->next = trim_head;
+      trim_head = block;
+    } else {
+      block_ptr = &block->next;
+    }
+  }
+  iree_slim_mutex_unlock(&pool->mutex);
+
+  iree_hal_task_buffer_pool_free_blocks(pool, trim_head);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+// Removes and returns a free block that can hold |allocation_size| bytes with
+// |params| and that is released with respect to |wait_semaphore_list|, or NULL
+// if there is none. Blocks more than twice the requested size are skipped to
+// avoid pinning large blocks with small allocations.
+//
+// On a miss released blocks beyond the pool limit are moved to |evict_head|
+// as new storage is about to be allocated.
+static iree_hal_task_buffer_pool_block_t* iree_hal_task_buffer_pool_take_block(
+    iree_hal_task_buffer_pool_t* pool,
+    const iree_hal_semaphore_list_t wait_semaphore_list,
+    const iree_hal_buffer_params_t* params, iree_device_size_t allocation_size,
+    iree_hal_task_buffer_pool_block_t** evict_head) {
+  iree_hal_task_buffer_pool_block_t* found_block = NULL;
+  iree_slim_mutex_lock(&pool->mutex);
+  iree_hal_task_buffer_pool_block_t** block_ptr = &pool->free_head;
+  for (; *block_ptr; block_ptr = &(*block_ptr)->next) {
+    iree_hal_task_buffer_pool_block_t* block = *block_ptr;
+    iree_device_size_t block_size = iree_hal_task_buffer_pool_block_size(block);
+    if (block->type != params->type || block->access != params->access ||
+        block->usage != params->usage || block_size < allocation_size ||
+        block_size / 2 > allocation_size) {
+      continue;
+    }
+    if (iree_hal_task_buffer_pool_block_state(block, wait_semaphore_list) !=
+        IREE_HAL_TASK_BUFFER_POOL_BLOCK_STATE_RELEASED) {
+      continue;
+    }
+    found_block = iree_hal_task_buffer_pool_unlink_block(pool, block_ptr);
+    break;
+  }
+  if (!found_block) {
+    iree_hal_task_buffer_pool_evict_blocks(pool, evict_head);
+  }
+  iree_slim_mutex_unlock(&pool->mutex);
+
+  // The timepoints are no longer needed once reached (or waited on).
+  if (found_block) {
+    iree_hal_task_buffer_pool_block_reset_release(pool, found_block);
+  }
+  return found_block;
+}
+
+// Allocates a new block of |allocation_size| bytes from |device_allocator|.
+// Fails with IREE_STATUS_UNAVAILABLE if the storage cannot be mapped.
+static iree_status_t iree_hal_task_buffer_pool_allocate_block(
+    iree_hal_task_buffer_pool_t* pool, iree_hal_allocator_t* device_allocator,
+    const iree_hal_buffer_params_t* params, iree_device_size_t allocation_size,
+    iree_hal_task_buffer_pool_block_t** out_block) {
+  *out_block = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)allocation_size);
+
+  iree_hal_task_buffer_pool_block_t* block = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(pool->host_allocator, sizeof(*block),
+                                (void**)&block));
+  memset(block, 0, sizeof(*block));
+  block->type = params->type;
+  block->access = params->access;
+  block->usage = params->usage;
+
+  // The storage is only ever accessed through its persistent mapping.
+  iree_hal_buffer_params_t storage_params = *params;
+  storage_params.type |= IREE_HAL_MEMORY_TYPE_HOST_VISIBLE;
+  storage_params.access = IREE_HAL_MEMORY_ACCESS_ALL;
+  storage_params.usage |= IREE_HAL_BUFFER_USAGE_MAPPING_PERSISTENT;
+  iree_status_t status = iree_hal_allocator_allocate_buffer(
+      device_allocator, storage_params, allocation_size, &block->storage);
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_buffer_map_range(
+        block->storage, IREE_HAL_MAPPING_MODE_PERSISTENT,
+        IREE_HAL_MEMORY_ACCESS_ANY, 0, IREE_WHOLE_BUFFER, &block->mapping);
+    if (!iree_status_is_ok(status)) {
+      iree_status_ignore(status);
+      status = iree_make_status(IREE_STATUS_UNAVAILABLE,
+                                "pooled storage is not host mappable");
+    }
+  }
+
+  if (iree_status_is_ok(status)) {
+    *out_block = block;
+  } else {
+    iree_hal_buffer_release(block->storage);
+    iree_allocator_free(pool->host_allocator, block);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+//===----------------------------------------------------------------------===//
+// iree_hal_task_buffer_pool_buffer_t
+//===----------------------------------------------------------------------===//
+
+// A buffer handed out by the pool. Owns its block until it is deallocated or
+// the buffer is destroyed, whichever comes first.
+typedef struct iree_hal_task_buffer_pool_buffer_t {
+  iree_hal_buffer_t base;
+  // Retained until the buffer is destroyed.
+  iree_hal_task_buffer_pool_t* pool;
+  // Block whose storage backs the buffer. Its storage must not be accessed by
+  // work not ordered before the release of a dealloca as the block may have
+  // been reused or freed by then.
+  iree_hal_task_buffer_pool_block_t* block;
+  // True until the block is returned to the pool by a dealloca. Guarded by the
+  // pool mutex.
+  bool owns_block;
+} iree_hal_task_buffer_pool_buffer_t;
+
+static const iree_hal_buffer_vtable_t iree_hal_task_buffer_pool_buffer_vtable;
+
+static iree_hal_task_buffer_pool_buffer_t*
+iree_hal_task_buffer_pool_buffer_cast(iree_hal_buffer_t* base_value) {
+  IREE_HAL_ASSERT_TYPE(base_value, &iree_hal_task_buffer_pool_buffer_vtable);
+  return (iree_hal_task_buffer_pool_buffer_t*)base_value;
+}
+
+// Wraps the storage of |block| in a buffer of |allocation_size| bytes that
+// returns the block to the pool when destroyed. Fails with
+// IREE_STATUS_UNAVAILABLE if |device_allocator| cannot allocate buffers with
+// |params|.
+static iree_status_t iree_hal_task_buffer_pool_wrap_block(
+    iree_hal_task_buffer_pool_t* pool, iree_hal_allocator_t* device_allocator,
+    iree_hal_task_buffer_pool_block_t* block,
+    const iree_hal_buffer_params_t* params, iree_device_size_t allocation_size,
+    iree_hal_buffer_t** out_buffer) {
+  // Buffers are given the parameters they would have had if allocated from
+  // |device_allocator| directly.
+  iree_hal_buffer_params_t compat_params = *params;
+  if (!iree_all_bits_set(iree_hal_allocator_query_buffer_compatibility(
+                             device_allocator, *params, allocation_size,
+                             &compat_params, NULL),
+                         IREE_HAL_BUFFER_COMPATIBILITY_ALLOCATABLE)) {
+    return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                            "pooled storage cannot be allocated with the "
+                            "given parameters");
+  }
+
+  iree_hal_task_buffer_pool_buffer_t* buffer = NULL;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      pool->host_allocator, sizeof(*buffer), (void**)&buffer));
+  // The buffer has no device allocator as it is returned to the pool and not
+  // to the allocator when destroyed.
+  iree_hal_buffer_initialize(
+      pool->host_allocator, /*device_allocator=*/NULL, &buffer->base,
+      allocation_size, /*byte_offset=*/0, allocation_size, compat_params.type,
+      compat_params.access, compat_params.usage,
+      &iree_hal_task_buffer_pool_buffer_vtable, &buffer->base);
+  buffer->pool = pool;
+  iree_hal_task_buffer_pool_retain(pool);
+  buffer->block = block;
+  buffer->owns_block = true;
+
+  *out_buffer = &buffer->base;
+  return iree_ok_status();
+}
+
+static void iree_hal_task_buffer_pool_buffer_destroy(
+    iree_hal_buffer_t* base_buffer) {
+  iree_hal_task_buffer_pool_buffer_t* buffer =
+      iree_hal_task_buffer_pool_buffer_cast(base_buffer);
+  iree_hal_task_buffer_pool_t* pool = buffer->pool;
+
+  // Queue work retains the buffers it uses so the storage of a buffer that was
+  // never deallocated is idle and can be reused immediately. That may push the
+  // pool over its limit in which case released storage is freed.
+  iree_hal_task_buffer_pool_block_t* evict_head = NULL;
+  iree_slim_mutex_lock(&pool->mutex);
+  if (buffer->owns_block) {
+    iree_hal_task_buffer_pool_push_block(pool, buffer->block);
+    iree_hal_task_buffer_pool_evict_blocks(pool, &evict_head);
+  }
+  iree_slim_mutex_unlock(&pool->mutex);
+  iree_hal_task_buffer_pool_free_blocks(pool, evict_head);
+
+  iree_allocator_free(base_buffer->host_allocator, buffer);
+  iree_hal_task_buffer_pool_release(pool);
+}
+
+static iree_status_t iree_hal_task_buffer_pool_buffer_map_range(
+    iree_hal_buffer_t* base_buffer, iree_hal_mapping_mode_t mapping_mode,
+    iree_hal_memory_access_t memory_access,
+    iree_device_size_t local_byte_offset, iree_device_size_t local_byte_length,
+    iree_hal_buffer_mapping_t* mapping) {
+  iree_hal_task_buffer_pool_buffer_t* buffer =
+      iree_hal_task_buffer_pool_buffer_cast(base_buffer);
+  mapping->contents = iree_make_byte_span(
+      buffer->block->mapping.contents.data + local_byte_offset,
+      local_byte_length);
+  return iree_ok_status();
+}
+
+static iree_status_t iree_hal_task_buffer_pool_buffer_unmap_range(
+    iree_hal_buffer_t* base_buffer, iree_device_size_t local_byte_offset,
+    iree_device_size_t local_byte_length, iree_hal_buffer_mapping_t* mapping) {
+  // No-op as the storage is persistently mapped.
+  return iree_ok_status();
+}
+
+static iree_status_t iree_hal_task_buffer_pool_buffer_invalidate_range(
+    iree_hal_buffer_t* base_buffer, iree_device_size_t local_byte_offset,
+    iree_device_size_t local_byte_length) {
+  iree_hal_task_buffer_pool_buffer_t* buffer =
+      iree_hal_task_buffer_pool_buffer_cast(base_buffer);
+  return iree_hal_buffer_mapping_invalidate_range(
+      &buffer->block->mapping, local_byte_offset, local_byte_length);
+}
+
+static iree_status_t iree_hal_task_buffer_pool_buffer_flush_range(
+    iree_hal_buffer_t* base_buffer, iree_device_size_t local_byte_offset,
+    iree_device_size_t local_byte_length) {
+  iree_hal_task_buffer_pool_buffer_t* buffer =
+      iree_hal_task_buffer_pool_buffer_cast(base_buffer);
+  return iree_hal_buffer_mapping_flush_range(
+      &buffer->block->mapping, local_byte_offset, local_byte_length);
+}
+
+static const iree_hal_buffer_vtable_t iree_hal_task_buffer_pool_buffer_vtable =
+    {
+        .recycle = iree_hal_buffer_recycle,
+        .destroy = iree_hal_task_buffer_pool_buffer_destroy,
+        .map_range = iree_hal_task_buffer_pool_buffer_map_range,
+        .unmap_range = iree_hal_task_buffer_pool_buffer_unmap_range,
+        .invalidate_range = iree_hal_task_buffer_pool_buffer_invalidate_range,
+        .flush_range = iree_hal_task_buffer_pool_buffer_flush_range,
+};
+
+//===----------------------------------------------------------------------===//
+// Queue-ordered allocation
+//===----------------------------------------------------------------------===//
+
+iree_status_t iree_hal_task_buffer_pool_alloca(
+    iree_hal_task_buffer_pool_t* pool, iree_hal_allocator_t* device_allocator,
+    const iree_hal_semaphore_list_t wait_semaphore_list,
+    iree_hal_buffer_params_t params, iree_device_size_t allocation_size,
+    iree_hal_buffer_t** out_buffer) {
+  IREE_ASSERT_ARGUMENT(pool);
+  IREE_ASSERT_ARGUMENT(device_allocator);
+  IREE_ASSERT_ARGUMENT(out_buffer);
+  *out_buffer = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)allocation_size);
+
+  iree_hal_task_buffer_pool_block_t* evict_head = NULL;
+  iree_hal_task_buffer_pool_block_t* block =
+      iree_hal_task_buffer_pool_take_block(pool, wait_semaphore_list, &params,
+                                           allocation_size, &evict_head);
+  iree_hal_task_buffer_pool_free_blocks(pool, evict_head);
+  const bool is_new_block = !block;
+  iree_status_t status = iree_ok_status();
+  if (is_new_block) {
+    status = iree_hal_task_buffer_pool_allocate_block(
+        pool, device_allocator, &params, allocation_size, &block);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_task_buffer_pool_wrap_block(
+        pool, device_allocator, block, &params, allocation_size, out_buffer);
+    if (!iree_status_is_ok(status)) {
+      if (is_new_block) {
+        iree_hal_task_buffer_pool_block_free(pool, block);
+      } else {
+        iree_slim_mutex_lock(&pool->mutex);
+        iree_hal_task_buffer_pool_push_block(pool, block);
+        iree_slim_mutex_unlock(&pool->mutex);
+      }
+    }
+  }
+
+  // Allocators that cannot map their storage (external or device-only memory)
+  // still work but without pooling.
+  if (iree_status_is_unavailable(status)) {
+    iree_status_ignore(status);
+    status = iree_hal_allocator_allocate_buffer(device_allocator, params,
+                                                allocation_size, out_buffer);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+iree_status_t iree_hal_task_buffer_pool_dealloca(
+    iree_hal_task_buffer_pool_t* pool, iree_hal_buffer_t* buffer,
+    const iree_hal_semaphore_list_t release_semaphore_list) {
+  IREE_ASSERT_ARGUMENT(pool);
+  IREE_ASSERT_ARGUMENT(buffer);
+
+  // Without a timepoint there's no way to know when the storage is idle and it
+  // will be reclaimed when the buffer is released instead. The same goes for
+  // buffers that are not from this pool.
+  iree_hal_buffer_t* allocated_buffer =
+      iree_hal_buffer_allocated_buffer(buffer);
+  if (!release_semaphore_list.count ||
+      !iree_hal_resource_is(allocated_buffer,
+                            &iree_hal_task_buffer_pool_buffer_vtable)) {
+    return iree_ok_status();
+  }
+  iree_hal_task_buffer_pool_buffer_t* pool_buffer =
+      iree_hal_task_buffer_pool_buffer_cast(allocated_buffer);
+  if (pool_buffer->pool != pool) return iree_ok_status();
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Allocate and retain the release timepoints up front so the list is only
+  // modified under the lock.
+  iree_hal_semaphore_list_t release_list = {
+      .count = release_semaphore_list.count,
+  };
+  iree_host_size_t semaphores_size =
+      release_list.count * sizeof(*release_list.semaphores);
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(
+              pool->host_allocator,
+              semaphores_size +
+                  release_list.count * sizeof(*release_list.payload_values),
+              (void**)&release_list.semaphores));
+  release_list.payload_values =
+      (uint64_t*)((uint8_t*)release_list.semaphores + semaphores_size);
+  for (iree_host_size_t i = 0; i < release_list.count; ++i) {
+    release_list.semaphores[i] = release_semaphore_list.semaphores[i];
+    iree_hal_semaphore_retain(release_list.semaphores[i]);
+    release_list.payload_values[i] = release_semaphore_list.payload_values[i];
+  }
+
+  // Detach the block from the buffer (if it has not already been deallocated)
+  // and return it to the pool.
+  iree_hal_task_buffer_pool_block_t* block = NULL;
+  iree_slim_mutex_lock(&pool->mutex);
+  if (pool_buffer->owns_block) {
+    pool_buffer->owns_block = false;
+    block = pool_buffer->block;
+    block->release_list = release_list;
+    iree_hal_task_buffer_pool_push_block(pool, block);
+  }
+  iree_slim_mutex_unlock(&pool->mutex);
+
+  if (!block) {
+    iree_hal_task_buffer_pool_block_t unused_block = {
+        .release_list = release_list,
+    };
+    iree_hal_task_buffer_pool_block_reset_release(pool, &unused_block);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
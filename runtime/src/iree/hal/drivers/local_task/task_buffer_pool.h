@@ -0,0 +1,89 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_DRIVERS_LOCAL_TASK_TASK_BUFFER_POOL_H_
+#define IREE_HAL_DRIVERS_LOCAL_TASK_TASK_BUFFER_POOL_H_
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+//===----------------------------------------------------------------------===//
+// iree_hal_task_buffer_pool_t
+//===----------------------------------------------------------------------===//
+
+// A stream-ordered pool of buffer storage backing queue-ordered allocations.
+//
+// Host memory can be allocated at any time and so allocations never wait on
+// the queue: the storage is reserved immediately and only its reuse is
+// ordered. Storage deallocated with iree_hal_task_buffer_pool_dealloca is
+// tagged with the semaphore timepoints that complete the deallocation and can
+// be handed to a new allocation as soon as those timepoints are reached or
+// when the new allocation itself waits on them. Storage of buffers released
+// without a dealloca returns to the pool immediately as no queue work can be
+// referencing it anymore.
+//
+// Buffers are returned as wrappers around the persistently mapped storage so
+// that users can hold on to them after they have been deallocated without
+// keeping the storage from being reused.
+//
+// Storage returned to the pool is kept for reuse up to a configurable total
+// size; released storage beyond that is freed as the pool is used, oldest
+// first.
+//
+// Thread-safe; multiple threads may allocate and deallocate concurrently and
+// buffers may be released from any thread.
+typedef struct iree_hal_task_buffer_pool_t iree_hal_task_buffer_pool_t;
+
+// Creates an empty buffer pool that keeps at most |max_free_size| bytes of
+// released storage for reuse.
+iree_status_t iree_hal_task_buffer_pool_create(
+    iree_device_size_t max_free_size, iree_allocator_t host_allocator,
+    iree_hal_task_buffer_pool_t** out_pool);
+
+// Retains the given |pool| by increasing its reference count.
+void iree_hal_task_buffer_pool_retain(iree_hal_task_buffer_pool_t* pool);
+
+// Releases the given |pool| by decreasing its reference count.
+// Buffers allocated from the pool retain it until they are released.
+void iree_hal_task_buffer_pool_release(iree_hal_task_buffer_pool_t* pool);
+
+// Releases all unused storage whose deallocation has completed or failed back
+// to the device allocator it was allocated from. Storage whose release
+// timepoints failed is never reused and is only reclaimed here.
+void iree_hal_task_buffer_pool_trim(iree_hal_task_buffer_pool_t* pool);
+
+// Allocates a buffer of |allocation_size| bytes for use by queue work ordered
+// after |wait_semaphore_list|. Unused storage is reused if its deallocation
+// has completed or is covered by |wait_semaphore_list| and otherwise new
+// storage is allocated from |device_allocator|. Never blocks on the queue.
+//
+// If |device_allocator| cannot persistently map its storage the buffer is
+// allocated from it directly and is not pooled.
+iree_status_t iree_hal_task_buffer_pool_alloca(
+    iree_hal_task_buffer_pool_t* pool, iree_hal_allocator_t* device_allocator,
+    const iree_hal_semaphore_list_t wait_semaphore_list,
+    iree_hal_buffer_params_t params, iree_device_size_t allocation_size,
+    iree_hal_buffer_t** out_buffer);
+
+// Returns the storage of |buffer| to the pool for reuse once all of
+// |release_semaphore_list| has been reached. |buffer| remains valid but its
+// contents must not be accessed by any work not ordered before the release.
+// Buffers not allocated from the pool and deallocations without a release
+// timepoint are ignored and the storage is reclaimed when |buffer| is
+// released.
+iree_status_t iree_hal_task_buffer_pool_dealloca(
+    iree_hal_task_buffer_pool_t* pool, iree_hal_buffer_t* buffer,
+    const iree_hal_semaphore_list_t release_semaphore_list);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_DRIVERS_LOCAL_TASK_TASK_BUFFER_POOL_H_
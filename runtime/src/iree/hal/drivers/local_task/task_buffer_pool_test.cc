@@ -0,0 +1,310 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/drivers/local_task/task_buffer_pool.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/hal/drivers/local_task/task_device.h"
+#include "iree/task/api.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace {
+
+constexpr iree_device_size_t kBlockSize = 4096;
+
+// Forwards to the system allocator while counting live allocations so tests
+// can observe when the pool allocates and frees buffer storage.
+iree_status_t CountingAllocatorCtl(void* self, iree_allocator_command_t command,
+                                   const void* params, void** inout_ptr) {
+  iree_allocator_t system_allocator = iree_allocator_system();
+  IREE_RETURN_IF_ERROR(system_allocator.ctl(system_allocator.self, command,
+                                            params, inout_ptr));
+  int* live_count = (int*)self;
+  if (command == IREE_ALLOCATOR_COMMAND_MALLOC ||
+      command == IREE_ALLOCATOR_COMMAND_CALLOC) {
+    ++*live_count;
+  } else if (command == IREE_ALLOCATOR_COMMAND_FREE) {
+    --*live_count;
+  }
+  return iree_ok_status();
+}
+
+class TaskBufferPoolTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    iree_allocator_t host_allocator = iree_allocator_system();
+
+    // The device is only used to create semaphores.
+    iree_task_topology_t topology;
+    iree_task_topology_initialize_from_group_count(/*group_count=*/1,
+                                                   &topology);
+    iree_task_executor_options_t options;
+    iree_task_executor_options_initialize(&options);
+    iree_status_t status = iree_task_executor_create(
+        options, &topology, host_allocator, &executor_);
+    iree_task_topology_deinitialize(&topology);
+    IREE_ASSERT_OK(status);
+
+    // Buffer storage comes from the counting allocator. It is also used for
+    // the allocator itself so that buffers are allocated as a single slab.
+    iree_allocator_t counting_allocator = {&live_allocation_count_,
+                                           CountingAllocatorCtl};
+    IREE_ASSERT_OK(iree_hal_allocator_create_heap(
+        IREE_SV("heap"), counting_allocator, counting_allocator,
+        &device_allocator_));
+    base_allocation_count_ = live_allocation_count_;
+    iree_hal_task_device_params_t params;
+    iree_hal_task_device_params_initialize(&params);
+    IREE_ASSERT_OK(iree_hal_task_device_create(
+        IREE_SV("local-task"), &params, /*queue_count=*/1, &executor_,
+        /*loader_count=*/0, /*loaders=*/NULL, device_allocator_,
+        host_allocator, &device_));
+
+    CreatePool(/*max_free_size=*/16 * kBlockSize);
+  }
+
+  void TearDown() override {
+    for (iree_hal_buffer_t* buffer : buffers_) {
+      iree_hal_buffer_release(buffer);
+    }
+    iree_hal_task_buffer_pool_release(pool_);
+    for (iree_hal_semaphore_t* semaphore : semaphores_) {
+      iree_hal_semaphore_release(semaphore);
+    }
+    iree_hal_device_release(device_);
+    iree_hal_allocator_release(device_allocator_);
+    iree_task_executor_release(executor_);
+    EXPECT_EQ(0, live_allocation_count_);
+  }
+
+  // Returns the number of buffer storage allocations alive in
+  // |device_allocator_|.
+  int LiveStorageCount() {
+    return live_allocation_count_ - base_allocation_count_;
+  }
+
+  // Replaces the pool with one that keeps at most |max_free_size| bytes.
+  void CreatePool(iree_device_size_t max_free_size) {
+    iree_hal_task_buffer_pool_release(pool_);
+    pool_ = NULL;
+    IREE_ASSERT_OK(iree_hal_task_buffer_pool_create(
+        max_free_size, iree_allocator_system(), &pool_));
+  }
+
+  iree_hal_semaphore_t* CreateSemaphore() {
+    iree_hal_semaphore_t* semaphore = NULL;
+    IREE_CHECK_OK(iree_hal_semaphore_create(device_, 0ull, &semaphore));
+    semaphores_.push_back(semaphore);
+    return semaphore;
+  }
+
+  // Allocates a buffer for work waiting on |semaphore| reaching |value|, if
+  // any. Returns a buffer that must be released with Release.
+  iree_hal_buffer_t* Alloca(iree_device_size_t allocation_size = kBlockSize,
+                            iree_hal_semaphore_t* semaphore = NULL,
+                            uint64_t value = 0) {
+    iree_hal_semaphore_list_t wait_list = {semaphore ? 1u : 0u, &semaphore,
+                                           &value};
+    iree_hal_buffer_params_t params = {0};
+    params.type =
+        IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL | IREE_HAL_MEMORY_TYPE_HOST_VISIBLE;
+    params.usage = IREE_HAL_BUFFER_USAGE_DISPATCH_STORAGE |
+                   IREE_HAL_BUFFER_USAGE_TRANSFER |
+                   IREE_HAL_BUFFER_USAGE_MAPPING;
+    iree_hal_buffer_t* buffer = NULL;
+    IREE_CHECK_OK(iree_hal_task_buffer_pool_alloca(
+        pool_, device_allocator_, wait_list, params, allocation_size,
+        &buffer));
+    buffers_.push_back(buffer);
+    return buffer;
+  }
+
+  // Returns the storage of |buffer| to the pool once |semaphore| reaches
+  // |value|.
+  void Dealloca(iree_hal_buffer_t* buffer, iree_hal_semaphore_t* semaphore,
+                uint64_t value) {
+    iree_hal_semaphore_list_t release_list = {1, &semaphore, &value};
+    IREE_ASSERT_OK(
+        iree_hal_task_buffer_pool_dealloca(pool_, buffer, release_list));
+  }
+
+  void Release(iree_hal_buffer_t* buffer) {
+    buffers_.erase(std::find(buffers_.begin(), buffers_.end(), buffer));
+    iree_hal_buffer_release(buffer);
+  }
+
+  // Returns the address of the storage backing |buffer|. Buffers reusing the
+  // same storage have the same address.
+  uint8_t* StorageAddress(iree_hal_buffer_t* buffer) {
+    iree_hal_buffer_mapping_t mapping;
+    IREE_CHECK_OK(iree_hal_buffer_map_range(
+        buffer, IREE_HAL_MAPPING_MODE_SCOPED, IREE_HAL_MEMORY_ACCESS_READ, 0,
+        IREE_WHOLE_BUFFER, &mapping));
+    uint8_t* address = mapping.contents.data;
+    IREE_CHECK_OK(iree_hal_buffer_unmap_range(&mapping));
+    return address;
+  }
+
+  iree_task_executor_t* executor_ = NULL;
+  iree_hal_allocator_t* device_allocator_ = NULL;
+  iree_hal_device_t* device_ = NULL;
+  iree_hal_task_buffer_pool_t* pool_ = NULL;
+  std::vector<iree_hal_semaphore_t*> semaphores_;
+  std::vector<iree_hal_buffer_t*> buffers_;
+  // Number of allocations alive in the counting allocator and how many of
+  // them are not buffer storage.
+  int live_allocation_count_ = 0;
+  int base_allocation_count_ = 0;
+};
+
+TEST_F(TaskBufferPoolTest, ReuseOnceReleaseTimepointReached) {
+  iree_hal_semaphore_t* semaphore = CreateSemaphore();
+  iree_hal_buffer_t* buffer = Alloca();
+  uint8_t* address = StorageAddress(buffer);
+  Dealloca(buffer, semaphore, 1);
+  IREE_ASSERT_OK(iree_hal_semaphore_signal(semaphore, 1));
+  // The deallocated buffer remains valid but no longer owns the storage.
+  iree_hal_buffer_t* reused_buffer = Alloca();
+  EXPECT_EQ(address, StorageAddress(reused_buffer));
+  EXPECT_EQ(1, LiveStorageCount());
+  Release(buffer);
+  EXPECT_NE(address, StorageAddress(Alloca()));
+}
+
+TEST_F(TaskBufferPoolTest, ReuseWhenWaitListCoversReleaseTimepoint) {
+  iree_hal_semaphore_t* semaphore = CreateSemaphore();
+  iree_hal_buffer_t* buffer = Alloca();
+  uint8_t* address = StorageAddress(buffer);
+  Dealloca(buffer, semaphore, 2);
+  Release(buffer);
+  // Waiting on an earlier timepoint does not order after the release.
+  EXPECT_NE(address, StorageAddress(Alloca(kBlockSize, semaphore, 1)));
+  EXPECT_EQ(address, StorageAddress(Alloca(kBlockSize, semaphore, 2)));
+}
+
+TEST_F(TaskBufferPoolTest, NoReuseWhileReleasePending) {
+  iree_hal_semaphore_t* semaphore = CreateSemaphore();
+  iree_hal_buffer_t* buffer = Alloca();
+  uint8_t* address = StorageAddress(buffer);
+  Dealloca(buffer, semaphore, 2);
+  Release(buffer);
+  IREE_ASSERT_OK(iree_hal_semaphore_signal(semaphore, 1));
+  EXPECT_NE(address, StorageAddress(Alloca()));
+  EXPECT_EQ(2, LiveStorageCount());
+  // Trimming keeps storage that may still be in use.
+  iree_hal_task_buffer_pool_trim(pool_);
+  EXPECT_EQ(2, LiveStorageCount());
+}
+
+TEST_F(TaskBufferPoolTest, NoReuseAfterSemaphoreFailure) {
+  iree_hal_semaphore_t* semaphore = CreateSemaphore();
+  iree_hal_buffer_t* buffer = Alloca();
+  uint8_t* address = StorageAddress(buffer);
+  Dealloca(buffer, semaphore, 1);
+  Release(buffer);
+  iree_hal_semaphore_fail(semaphore,
+                          iree_make_status(IREE_STATUS_DATA_LOSS, "failed"));
+  EXPECT_NE(address, StorageAddress(Alloca()));
+  EXPECT_EQ(2, LiveStorageCount());
+  // Failed storage is never reused but trimming reclaims it.
+  iree_hal_task_buffer_pool_trim(pool_);
+  EXPECT_EQ(1, LiveStorageCount());
+}
+
+TEST_F(TaskBufferPoolTest, ReleaseWithoutDealloca) {
+  iree_hal_buffer_t* buffer = Alloca();
+  uint8_t* address = StorageAddress(buffer);
+  Release(buffer);
+  EXPECT_EQ(address, StorageAddress(Alloca()));
+  EXPECT_EQ(1, LiveStorageCount());
+}
+
+TEST_F(TaskBufferPoolTest, DoubleDealloca) {
+  iree_hal_semaphore_t* semaphore = CreateSemaphore();
+  iree_hal_buffer_t* buffer = Alloca();
+  uint8_t* address = StorageAddress(buffer);
+  Dealloca(buffer, semaphore, 1);
+  // The second dealloca is ignored and neither moves the release timepoint
+  // nor returns the storage to the pool twice.
+  Dealloca(buffer, semaphore, 2);
+  Release(buffer);
+  IREE_ASSERT_OK(iree_hal_semaphore_signal(semaphore, 1));
+  EXPECT_EQ(address, StorageAddress(Alloca()));
+  EXPECT_NE(address, StorageAddress(Alloca()));
+  EXPECT_EQ(2, LiveStorageCount());
+}
+
+TEST_F(TaskBufferPoolTest, DeallocaOfUnpooledBufferIsIgnored) {
+  iree_hal_semaphore_t* semaphore = CreateSemaphore();
+  iree_hal_buffer_params_t params = {0};
+  params.type = IREE_HAL_MEMORY_TYPE_HOST_LOCAL;
+  params.usage = IREE_HAL_BUFFER_USAGE_MAPPING;
+  iree_hal_buffer_t* buffer = NULL;
+  IREE_ASSERT_OK(iree_hal_allocator_allocate_buffer(
+      device_allocator_, params, kBlockSize, &buffer));
+  Dealloca(buffer, semaphore, 1);
+  iree_hal_buffer_release(buffer);
+  EXPECT_EQ(0, LiveStorageCount());
+}
+
+TEST_F(TaskBufferPoolTest, Trim) {
+  iree_hal_semaphore_t* semaphore = CreateSemaphore();
+  iree_hal_buffer_t* released_buffer = Alloca();
+  iree_hal_buffer_t* signaled_buffer = Alloca();
+  iree_hal_buffer_t* pending_buffer = Alloca();
+  iree_hal_buffer_t* live_buffer = Alloca();
+  Release(released_buffer);
+  Dealloca(signaled_buffer, semaphore, 1);
+  Dealloca(pending_buffer, semaphore, 2);
+  IREE_ASSERT_OK(iree_hal_semaphore_signal(semaphore, 1));
+  EXPECT_EQ(4, LiveStorageCount());
+  iree_hal_task_buffer_pool_trim(pool_);
+  EXPECT_EQ(2, LiveStorageCount());
+  Release(live_buffer);
+  iree_hal_task_buffer_pool_trim(pool_);
+  EXPECT_EQ(1, LiveStorageCount());
+  Alloca();
+  EXPECT_EQ(2, LiveStorageCount());
+}
+
+TEST_F(TaskBufferPoolTest, FreeSizeIsCapped) {
+  CreatePool(/*max_free_size=*/2 * kBlockSize);
+  std::vector<iree_hal_buffer_t*> buffers;
+  for (int i = 0; i < 4; ++i) buffers.push_back(Alloca());
+  uint8_t* last_address = StorageAddress(buffers.back());
+  for (iree_hal_buffer_t* buffer : buffers) Release(buffer);
+  EXPECT_EQ(2, LiveStorageCount());
+  // The most recently released storage is kept.
+  EXPECT_EQ(last_address, StorageAddress(Alloca()));
+}
+
+TEST_F(TaskBufferPoolTest, MissEvictsReleasedStorage) {
+  CreatePool(/*max_free_size=*/kBlockSize);
+  iree_hal_semaphore_t* semaphore = CreateSemaphore();
+  iree_hal_buffer_t* buffer0 = Alloca();
+  iree_hal_buffer_t* buffer1 = Alloca();
+  Dealloca(buffer0, semaphore, 1);
+  Dealloca(buffer1, semaphore, 1);
+  Release(buffer0);
+  Release(buffer1);
+  // Pending storage is kept even when over the limit.
+  EXPECT_EQ(2, LiveStorageCount());
+  IREE_ASSERT_OK(iree_hal_semaphore_signal(semaphore, 1));
+  // Storage that cannot be reused for a larger allocation is freed down to the
+  // limit before new storage is allocated.
+  Alloca(4 * kBlockSize);
+  EXPECT_EQ(2, LiveStorageCount());
+  iree_hal_task_buffer_pool_trim(pool_);
+  EXPECT_EQ(1, LiveStorageCount());
+}
+
+}  // namespace
@@ -34,6 +34,124 @@
 // additional allocations required during recording or execution. That means our
 // command buffer here is essentially just a builder for the task system types
 // and manager of the lifetime of the tasks.
+//
+// One-shot command buffers hand their task DAG over to the submission they are
+// issued in. Reusable command buffers keep the recorded DAG as a template that
+// is never executed itself and instead clone it into the submission arena each
+// time they are issued. Cloning is a copy of the recorded tasks and a remap of
+// the edges between them and is much cheaper than re-recording: no validation,
+// resource tracking, or buffer mapping is repeated. As the template is only
+// read the same command buffer may be issued any number of times concurrently.
+//
+// Nested command buffers are templates as well and are cloned into the primary
+// command buffer that executes them. Bindings pushed with a binding table slot
+// instead of a buffer are recorded as fixups on their tasks and resolved
+// against the binding table provided to execute_commands as the tasks are
+// cloned. This allows a nested command buffer to be recorded once and executed
+// against different buffers each time.
+//
+// Execution barriers don't force a join-fork of all work. All memory is
+// coherent on the CPU and the only ordering that matters is between tasks that
+// access overlapping buffer ranges with at least one of them writing. Each task
+// tracks the ranges it accesses (dispatch bindings, transfer sources and
+// targets) and depends only on the tasks recorded before the most recent
+// execution barrier that it conflicts with. Independent work recorded across
+// barriers is then free to execute concurrently. Work we can't track the
+// accesses of (nested command buffers) is still bracketed by global barriers.
+
+// A binding of a recorded task that references a binding table slot.
+// When the task is cloned the buffer range is mapped and its pointer and length
+// are written into the task at the given byte offsets.
+typedef struct iree_hal_task_command_buffer_fixup_t {
+  // Binding table slot the buffer is sourced from.
+  uint32_t slot;
+  // Byte offsets of the void* binding pointer and size_t binding length in the
+  // task.
+  uint32_t ptr_offset;
+  uint32_t length_offset;
+  // Range of the binding relative to the binding table entry range.
+  iree_device_size_t offset;
+  iree_device_size_t length;
+} iree_hal_task_command_buffer_fixup_t;
+
+// Header prefixed to each task recorded into a template command buffer.
+// Records are linked in recording order and their ordinals are used to remap
+// the edges between tasks when cloning the DAG.
+typedef iree_alignas(iree_max_align_t) struct
+    iree_hal_task_command_buffer_record_t {
+  struct iree_hal_task_command_buffer_record_t* next;
+  // Index of the record in recording order.
+  iree_host_size_t ordinal;
+  // Size of the task in bytes including any trailing command data.
+  iree_host_size_t task_size;
+  // Bindings of the task resolved from the binding table when cloned.
+  iree_host_size_t fixup_count;
+  const iree_hal_task_command_buffer_fixup_t* fixups;
+} iree_hal_task_command_buffer_record_t;
+
+// A byte range of an allocated buffer. A NULL |buffer| is a range that is only
+// known once executed (such as a binding table slot) and is assumed to overlap
+// every other range.
+typedef struct iree_hal_task_command_buffer_range_t {
+  iree_hal_buffer_t* buffer;
+  iree_device_size_t begin;
+  iree_device_size_t end;
+} iree_hal_task_command_buffer_range_t;
+
+// A buffer range accessed by a recorded task.
+typedef struct iree_hal_task_command_buffer_access_t {
+  iree_hal_task_command_buffer_range_t range;
+  bool is_write;
+} iree_hal_task_command_buffer_access_t;
+
+// An edge from a recorded task to a task that depends on it.
+typedef struct iree_hal_task_command_buffer_edge_t {
+  struct iree_hal_task_command_buffer_edge_t* next;
+  iree_task_t* task;
+} iree_hal_task_command_buffer_edge_t;
+
+// A task recorded into the DAG and the tasks that depend on it.
+// Only used during recording: the edges are materialized into the tasks when
+// flushed as a task with more than one dependent needs a barrier to fan out to
+// them and we can't know how many it will have until no more can be added.
+typedef struct iree_hal_task_command_buffer_node_t {
+  struct iree_hal_task_command_buffer_node_t* next;
+  iree_task_t* task;
+  // Execution barrier epoch the task was recorded in.
+  uint32_t epoch;
+  // True if the task depends on another; tasks that don't are DAG roots.
+  bool has_dependencies;
+  // Tasks that depend on this one, most recently added first.
+  iree_host_size_t dependent_count;
+  iree_hal_task_command_buffer_edge_t* dependent_head;
+} iree_hal_task_command_buffer_node_t;
+
+// A buffer access of a recorded task that later tasks may need to be ordered
+// after.
+typedef struct iree_hal_task_command_buffer_tracked_access_t {
+  struct iree_hal_task_command_buffer_tracked_access_t* next;
+  iree_hal_task_command_buffer_node_t* node;
+  iree_hal_task_command_buffer_access_t access;
+  // First epoch in which the access is hidden behind a later write of the
+  // whole range. Tasks recorded in that epoch or after depend on the write and
+  // through it on this access, so it no longer needs to be tracked.
+  uint32_t superseded_epoch;
+} iree_hal_task_command_buffer_tracked_access_t;
+
+// Maximum number of buffer accesses tracked for dependency analysis. When more
+// are tracked at an execution barrier it is emitted as a global barrier that
+// resets tracking instead, bounding the recording cost of each command.
+#define IREE_HAL_TASK_COMMAND_BUFFER_MAX_TRACKED_ACCESSES 512
+
+// A binding pushed with a binding table slot instead of a buffer.
+typedef struct iree_hal_task_command_buffer_binding_ref_t {
+  // True if the binding is sourced from |slot| of the binding table.
+  bool indirect;
+  uint32_t slot;
+  iree_device_size_t offset;
+  iree_device_size_t length;
+} iree_hal_task_command_buffer_binding_ref_t;
+
 typedef struct iree_hal_task_command_buffer_t {
   iree_hal_command_buffer_t base;
   iree_allocator_t host_allocator;
@@ -59,24 +177,40 @@ typedef struct iree_hal_task_command_buffer_t {
   // An empty list indicates that root_tasks are also the leaves.
   iree_task_list_t leaf_tasks;
 
+  // All tasks recorded into a template command buffer in recording order.
+  // Empty for one-shot primary command buffers.
+  iree_hal_task_command_buffer_record_t* record_head;
+  iree_hal_task_command_buffer_record_t* record_tail;
+  iree_host_size_t record_count;
+
+  // Total number of fixups across all records. Command buffers with fixups can
+  // only be executed with a binding table.
+  iree_host_size_t fixup_count;
+
   // TODO(benvanik): move this out of the struct and allocate from the arena -
   // we only need this during recording and it's ~4KB of waste otherwise.
   // State tracked within the command buffer during recording only.
   struct {
-    // The last global barrier that was inserted, if any.
-    // The barrier is allocated and inserted into the DAG when requested but the
-    // actual barrier dependency list is only allocated and set on flushes.
-    // This lets us allocate the appropriately sized barrier task list from the
-    // arena even though when the barrier is recorded we don't yet know what
-    // other tasks we'll be emitting as we walk the command stream.
-    iree_task_barrier_t* open_barrier;
-
-    // The number of tasks in the open barrier (|open_tasks|), used to quickly
-    // allocate storage for the task list without needing to walk the list.
-    iree_host_size_t open_task_count;
-
-    // All execution tasks emitted that must execute after |open_barrier|.
-    iree_task_list_t open_tasks;
+    // All tasks recorded since the last global barrier in recording order,
+    // starting with the barrier itself. Flushed into the task DAG on each
+    // global barrier and at the end of recording.
+    iree_hal_task_command_buffer_node_t* node_head;
+    iree_hal_task_command_buffer_node_t* node_tail;
+
+    // The last global barrier that was inserted, if any. Tasks recorded after
+    // it that don't depend on any other task depend on it.
+    iree_hal_task_command_buffer_node_t* join;
+
+    // Incremented on each execution barrier. Tasks only depend on tasks
+    // recorded in prior epochs and those recorded within the same epoch may
+    // execute concurrently.
+    uint32_t epoch;
+
+    // Buffer accesses of the tasks recorded since the last global barrier.
+    iree_hal_task_command_buffer_tracked_access_t* access_head;
+    iree_host_size_t access_count;
+    // Tracked accesses no longer in use that can be reused.
+    iree_hal_task_command_buffer_tracked_access_t* access_pool;
 
     // A flattened list of all available descriptor set bindings.
     // As descriptor sets are pushed/bound the bindings will be updated to
@@ -89,6 +223,17 @@ typedef struct iree_hal_task_command_buffer_t {
         binding_lengths[IREE_HAL_LOCAL_MAX_DESCRIPTOR_SET_COUNT *
                         IREE_HAL_LOCAL_MAX_DESCRIPTOR_BINDING_COUNT];
 
+    // The buffer ranges of |bindings| used to track the accesses of dispatches.
+    iree_hal_task_command_buffer_range_t
+        binding_ranges[IREE_HAL_LOCAL_MAX_DESCRIPTOR_SET_COUNT *
+                       IREE_HAL_LOCAL_MAX_DESCRIPTOR_BINDING_COUNT];
+
+    // Binding table references for the bindings that were pushed without a
+    // buffer. The entries in |bindings| are NULL for those.
+    iree_hal_task_command_buffer_binding_ref_t
+        binding_refs[IREE_HAL_LOCAL_MAX_DESCRIPTOR_SET_COUNT *
+                     IREE_HAL_LOCAL_MAX_DESCRIPTOR_BINDING_COUNT];
+
     // All available push constants updated each time push_constants is called.
     // Reset only with the command buffer and otherwise will maintain its values
     // during recording to allow for partial push_constants updates.
@@ -115,25 +260,6 @@ iree_status_t iree_hal_task_command_buffer_create(
   IREE_ASSERT_ARGUMENT(out_command_buffer);
   *out_command_buffer = NULL;
 
-  if (!iree_all_bits_set(mode, IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT)) {
-    // If we want reuse we'd need to support duplicating the task DAG after
-    // recording or have some kind of copy-on-submit behavior that does so if
-    // a command buffer is submitted for execution twice. Allowing for the same
-    // command buffer to be enqueued multiple times would be fine so long as
-    // execution doesn't overlap (`cmdbuf|cmdbuf` vs
-    // `cmdbuf -> semaphore -> cmdbuf`) though we'd still need to be careful
-    // that we did the enqueuing and reset of the task structures at the right
-    // times. Definitely something that'll be useful in the future... but not
-    // today :)
-    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
-                            "only one-shot command buffer usage is supported");
-  }
-  if (binding_capacity > 0) {
-    // TODO(#10144): support indirect command buffers with binding tables.
-    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
-                            "indirect command buffers not yet implemented");
-  }
-
   IREE_TRACE_ZONE_BEGIN(z0);
 
   iree_hal_task_command_buffer_t* command_buffer = NULL;
@@ -148,6 +274,10 @@ iree_status_t iree_hal_task_command_buffer_create(
     iree_arena_initialize(block_pool, &command_buffer->arena);
     iree_task_list_initialize(&command_buffer->root_tasks);
     iree_task_list_initialize(&command_buffer->leaf_tasks);
+    command_buffer->record_head = NULL;
+    command_buffer->record_tail = NULL;
+    command_buffer->record_count = 0;
+    command_buffer->fixup_count = 0;
     memset(&command_buffer->state, 0, sizeof(command_buffer->state));
     status = iree_hal_resource_set_allocate(block_pool,
                                             &command_buffer->resource_set);
@@ -190,8 +320,55 @@ bool iree_hal_task_command_buffer_isa(
 //===----------------------------------------------------------------------===//
 
 static iree_status_t iree_hal_task_command_buffer_flush_tasks(
+    iree_hal_task_command_buffer_t* command_buffer, iree_task_t* join_task);
+static iree_status_t iree_hal_task_command_buffer_emit_global_barrier(
     iree_hal_task_command_buffer_t* command_buffer);
 
+// Returns true if the tasks recorded into |command_buffer| are a template that
+// is cloned each time the command buffer is issued or executed by another.
+static bool iree_hal_task_command_buffer_is_template(
+    const iree_hal_task_command_buffer_t* command_buffer) {
+  return !iree_all_bits_set(command_buffer->base.mode,
+                            IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT) ||
+         iree_all_bits_set(command_buffer->base.mode,
+                           IREE_HAL_COMMAND_BUFFER_MODE_NESTED);
+}
+
+// Returns the record of a |task| allocated with
+// iree_hal_task_command_buffer_allocate_task in a template command buffer.
+static iree_hal_task_command_buffer_record_t*
+iree_hal_task_command_buffer_task_record(const iree_task_t* task) {
+  return (iree_hal_task_command_buffer_record_t*)task - 1;
+}
+
+// Allocates |task_size| bytes for a task and its trailing command data from
+// the command buffer arena. Tasks of template command buffers are prefixed with
+// a record so that the DAG can be cloned.
+static iree_status_t iree_hal_task_command_buffer_allocate_task(
+    iree_hal_task_command_buffer_t* command_buffer, iree_host_size_t task_size,
+    void** out_task) {
+  if (!iree_hal_task_command_buffer_is_template(command_buffer)) {
+    return iree_arena_allocate(&command_buffer->arena, task_size, out_task);
+  }
+  iree_hal_task_command_buffer_record_t* record = NULL;
+  IREE_RETURN_IF_ERROR(iree_arena_allocate(&command_buffer->arena,
+                                           sizeof(*record) + task_size,
+                                           (void**)&record));
+  record->next = NULL;
+  record->ordinal = command_buffer->record_count++;
+  record->task_size = task_size;
+  record->fixup_count = 0;
+  record->fixups = NULL;
+  if (command_buffer->record_tail) {
+    command_buffer->record_tail->next = record;
+  } else {
+    command_buffer->record_head = record;
+  }
+  command_buffer->record_tail = record;
+  *out_task = record + 1;
+  return iree_ok_status();
+}
+
 static iree_status_t iree_hal_task_command_buffer_begin(
     iree_hal_command_buffer_t* base_command_buffer) {
   iree_hal_task_command_buffer_t* command_buffer =
@@ -208,139 +385,291 @@ static iree_status_t iree_hal_task_command_buffer_end(
   iree_hal_task_command_buffer_t* command_buffer =
       iree_hal_task_command_buffer_cast(base_command_buffer);
 
-  // Flush any open barriers.
-  IREE_RETURN_IF_ERROR(
-      iree_hal_task_command_buffer_flush_tasks(command_buffer));
-
-  // Move the tasks from the leaf list (tail) to the root list (head) if this
-  // was the first set of tasks recorded.
-  if (iree_task_list_is_empty(&command_buffer->root_tasks) &&
-      !iree_task_list_is_empty(&command_buffer->leaf_tasks)) {
-    iree_task_list_move(&command_buffer->leaf_tasks,
-                        &command_buffer->root_tasks);
+  // A task that neither depends on nor is depended on by any other task is both
+  // a root and a leaf but the task lists are intrusive and it can only be in
+  // one of them. If all tasks are like that the root tasks are also the leaves
+  // (and the leaf list is left empty) and otherwise we join the leaves into a
+  // final global barrier.
+  bool any_isolated = false;
+  bool all_isolated = true;
+  for (iree_hal_task_command_buffer_node_t* node =
+           command_buffer->state.node_head;
+       node != NULL; node = node->next) {
+    bool is_isolated = !node->has_dependencies && !node->dependent_count;
+    any_isolated |= is_isolated;
+    all_isolated &= is_isolated;
+  }
+  if (any_isolated && !all_isolated) {
+    IREE_RETURN_IF_ERROR(
+        iree_hal_task_command_buffer_emit_global_barrier(command_buffer));
   }
 
+  // Flush the tasks recorded since the last global barrier.
+  IREE_RETURN_IF_ERROR(
+      iree_hal_task_command_buffer_flush_tasks(command_buffer, NULL));
+
   iree_hal_resource_set_freeze(command_buffer->resource_set);
 
   return iree_ok_status();
 }
 
-// Flushes all open tasks to the previous barrier and prepares for more
-// recording. The root tasks are also populated here when required as this is
-// the one place where we can see both halves of the most recent synchronization
-// event: those tasks recorded prior (if any) and the task that marks the set of
-// tasks that will be recorded after (if any).
+// Appends a node for |task| to the tasks recorded since the last global
+// barrier.
+static iree_status_t iree_hal_task_command_buffer_append_node(
+    iree_hal_task_command_buffer_t* command_buffer, iree_task_t* task,
+    iree_hal_task_command_buffer_node_t** out_node) {
+  iree_hal_task_command_buffer_node_t* node = NULL;
+  IREE_RETURN_IF_ERROR(iree_arena_allocate(&command_buffer->arena,
+                                           sizeof(*node), (void**)&node));
+  node->next = NULL;
+  node->task = task;
+  node->epoch = command_buffer->state.epoch;
+  node->has_dependencies = false;
+  node->dependent_count = 0;
+  node->dependent_head = NULL;
+  if (command_buffer->state.node_tail) {
+    command_buffer->state.node_tail->next = node;
+  } else {
+    command_buffer->state.node_head = node;
+  }
+  command_buffer->state.node_tail = node;
+  *out_node = node;
+  return iree_ok_status();
+}
+
+// Makes |dependent_task| depend on the task of |node|.
+static iree_status_t iree_hal_task_command_buffer_add_dependent(
+    iree_hal_task_command_buffer_t* command_buffer,
+    iree_hal_task_command_buffer_node_t* node, iree_task_t* dependent_task) {
+  // All dependencies of a task are added before recording the next one so a
+  // duplicate edge can only be the most recently added one.
+  if (node->dependent_head && node->dependent_head->task == dependent_task) {
+    return iree_ok_status();
+  }
+  iree_hal_task_command_buffer_edge_t* edge = NULL;
+  IREE_RETURN_IF_ERROR(iree_arena_allocate(&command_buffer->arena,
+                                           sizeof(*edge), (void**)&edge));
+  edge->next = node->dependent_head;
+  edge->task = dependent_task;
+  node->dependent_head = edge;
+  ++node->dependent_count;
+  return iree_ok_status();
+}
+
+// Flushes all tasks recorded since the last global barrier into the task DAG.
+// Tasks that nothing depends on are joined into |join_task| if provided and
+// otherwise become the leaves of the DAG. This is the one place where we can
+// see all of the dependents of the tasks: those recorded after the next global
+// barrier can only depend on it.
 static iree_status_t iree_hal_task_command_buffer_flush_tasks(
-    iree_hal_task_command_buffer_t* command_buffer) {
-  iree_task_barrier_t* open_barrier = command_buffer->state.open_barrier;
-  if (open_barrier != NULL) {
-    // There is an open barrier we need to fixup the fork out to all of the open
-    // tasks that were recorded after it.
-    iree_task_t* task_head =
-        iree_task_list_front(&command_buffer->state.open_tasks);
-    iree_host_size_t dependent_task_count =
-        command_buffer->state.open_task_count;
-    if (dependent_task_count == 1) {
-      // Special-case: only one open task so we can avoid the additional barrier
+    iree_hal_task_command_buffer_t* command_buffer, iree_task_t* join_task) {
+  for (iree_hal_task_command_buffer_node_t* node =
+           command_buffer->state.node_head;
+       node != NULL; node = node->next) {
+    iree_task_t* task = node->task;
+    if (node->dependent_count == 1) {
+      // Special-case: only one dependent so we can avoid the additional barrier
       // overhead by reusing the completion task.
-      iree_task_set_completion_task(&open_barrier->header, task_head);
-    } else if (dependent_task_count > 1) {
-      // Allocate the list of tasks we'll stash back on the previous barrier.
-      // Since we couldn't know at the time how many tasks would end up in the
-      // barrier we had to defer it until now.
+      iree_task_set_completion_task(task, node->dependent_head->task);
+    } else if (node->dependent_count > 1) {
+      // Fan out through a barrier. Global barriers already are one and other
+      // tasks complete into a new one.
+      iree_task_barrier_t* barrier = NULL;
+      if (task->type == IREE_TASK_TYPE_BARRIER) {
+        barrier = (iree_task_barrier_t*)task;
+      } else {
+        IREE_RETURN_IF_ERROR(iree_hal_task_command_buffer_allocate_task(
+            command_buffer, sizeof(*barrier), (void**)&barrier));
+        iree_task_barrier_initialize_empty(command_buffer->scope, barrier);
+        iree_task_set_completion_task(task, &barrier->header);
+      }
       iree_task_t** dependent_tasks = NULL;
       IREE_RETURN_IF_ERROR(iree_arena_allocate(
-          &command_buffer->arena, dependent_task_count * sizeof(iree_task_t*),
+          &command_buffer->arena,
+          node->dependent_count * sizeof(iree_task_t*),
           (void**)&dependent_tasks));
-      iree_task_t* task = task_head;
-      for (iree_host_size_t i = 0; i < dependent_task_count; ++i) {
-        dependent_tasks[i] = task;
-        task = task->next_task;
+      // Edges were added most recent first; restore recording order.
+      iree_hal_task_command_buffer_edge_t* edge = node->dependent_head;
+      for (iree_host_size_t i = node->dependent_count; i > 0; --i) {
+        dependent_tasks[i - 1] = edge->task;
+        edge = edge->next;
       }
-      iree_task_barrier_set_dependent_tasks(open_barrier, dependent_task_count,
+      iree_task_barrier_set_dependent_tasks(barrier, node->dependent_count,
                                             dependent_tasks);
+    } else if (join_task) {
+      iree_task_set_completion_task(task, join_task);
+    } else if (node->has_dependencies) {
+      iree_task_list_push_back(&command_buffer->leaf_tasks, task);
+    }
+    // NOTE: tasks that are both roots and leaves only go in the root list; see
+    // iree_hal_task_command_buffer_end.
+    if (!node->has_dependencies) {
+      iree_task_list_push_back(&command_buffer->root_tasks, task);
     }
   }
-  command_buffer->state.open_barrier = NULL;
-
-  // Move the open tasks to the tail as they represent the first half of the
-  // *next* barrier that will be inserted.
-  if (command_buffer->state.open_task_count > 0) {
-    iree_task_list_move(&command_buffer->state.open_tasks,
-                        &command_buffer->leaf_tasks);
-    command_buffer->state.open_task_count = 0;
+  command_buffer->state.node_head = NULL;
+  command_buffer->state.node_tail = NULL;
+  command_buffer->state.join = NULL;
+  return iree_ok_status();
+}
+
+// Emits the given |barrier| as a global barrier that all tasks recorded so far
+// complete into and all subsequently recorded tasks execute after.
+static iree_status_t iree_hal_task_command_buffer_emit_join(
+    iree_hal_task_command_buffer_t* command_buffer,
+    iree_task_barrier_t* barrier) {
+  IREE_RETURN_IF_ERROR(iree_hal_task_command_buffer_flush_tasks(
+      command_buffer, &barrier->header));
+
+  // Start the next set of tasks with the barrier.
+  iree_hal_task_command_buffer_node_t* node = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_task_command_buffer_append_node(
+      command_buffer, &barrier->header, &node));
+  node->has_dependencies = true;
+  command_buffer->state.join = node;
+
+  // All accesses so far are ordered before the barrier.
+  iree_hal_task_command_buffer_tracked_access_t* tracked =
+      command_buffer->state.access_head;
+  while (tracked) {
+    iree_hal_task_command_buffer_tracked_access_t* next = tracked->next;
+    tracked->next = command_buffer->state.access_pool;
+    command_buffer->state.access_pool = tracked;
+    tracked = next;
   }
+  command_buffer->state.access_head = NULL;
+  command_buffer->state.access_count = 0;
 
   return iree_ok_status();
 }
 
 // Emits a global barrier, splitting execution into all prior recorded tasks
-// and all subsequent recorded tasks. This is currently the critical piece that
-// limits our concurrency: changing to fine-grained barriers (via barrier
-// buffers or events) will allow more work to overlap at the cost of more brain
-// to build out the proper task graph.
+// and all subsequent recorded tasks. Only used for work whose buffer accesses
+// aren't tracked as it limits concurrency to that of the tasks between two
+// global barriers.
 static iree_status_t iree_hal_task_command_buffer_emit_global_barrier(
     iree_hal_task_command_buffer_t* command_buffer) {
-  // Flush open tasks to the previous barrier. This resets our state such that
-  // we can assign the new open barrier and start recording tasks for it.
-  // Previous tasks will be moved into the leaf_tasks list.
-  IREE_RETURN_IF_ERROR(
-      iree_hal_task_command_buffer_flush_tasks(command_buffer));
+  // Nothing to join if no tasks were recorded since the last global barrier.
+  iree_hal_task_command_buffer_node_t* node_head =
+      command_buffer->state.node_head;
+  if (!node_head || (node_head == command_buffer->state.join &&
+                     node_head == command_buffer->state.node_tail)) {
+    return iree_ok_status();
+  }
 
-  // Allocate the new open barrier.
-  // As we are recording forward we can't yet assign the dependent tasks (the
-  // second half of the synchronization domain) and instead are just inserting
-  // it so we can setup the join from previous tasks (the first half of the
-  // synchronization domain).
   iree_task_barrier_t* barrier = NULL;
-  IREE_RETURN_IF_ERROR(iree_arena_allocate(&command_buffer->arena,
-                                           sizeof(*barrier), (void**)&barrier));
+  IREE_RETURN_IF_ERROR(iree_hal_task_command_buffer_allocate_task(
+      command_buffer, sizeof(*barrier), (void**)&barrier));
   iree_task_barrier_initialize_empty(command_buffer->scope, barrier);
+  return iree_hal_task_command_buffer_emit_join(command_buffer, barrier);
+}
 
-  // If there were previous tasks then join them to the barrier.
-  for (iree_task_t* task = iree_task_list_front(&command_buffer->leaf_tasks);
-       task != NULL; task = task->next_task) {
-    iree_task_set_completion_task(task, &barrier->header);
-  }
-
-  // Move the tasks from the leaf list (tail) to the root list (head) if this
-  // was the first set of tasks recorded.
-  if (iree_task_list_is_empty(&command_buffer->root_tasks) &&
-      !iree_task_list_is_empty(&command_buffer->leaf_tasks)) {
-    iree_task_list_move(&command_buffer->leaf_tasks,
-                        &command_buffer->root_tasks);
+// Returns the range of |length| bytes at |offset| in |buffer|.
+static iree_hal_task_command_buffer_range_t
+iree_hal_task_command_buffer_make_range(iree_hal_buffer_t* buffer,
+                                        iree_device_size_t offset,
+                                        iree_device_size_t length) {
+  if (length == IREE_WHOLE_BUFFER) {
+    length = iree_hal_buffer_byte_length(buffer) - offset;
   }
+  iree_device_size_t begin = iree_hal_buffer_byte_offset(buffer) + offset;
+  iree_hal_task_command_buffer_range_t range = {
+      .buffer = iree_hal_buffer_allocated_buffer(buffer),
+      .begin = begin,
+      .end = begin + length,
+  };
+  return range;
+}
 
-  // Reset the tail of the command buffer to the barrier. This leaves us in a
-  // consistent state if the recording ends immediate after this (the barrier
-  // will be the last task).
-  iree_task_list_t* target_task_list =
-      iree_task_list_is_empty(&command_buffer->root_tasks)
-          ? &command_buffer->root_tasks
-          : &command_buffer->leaf_tasks;
-  iree_task_list_initialize(target_task_list);
-  iree_task_list_push_back(target_task_list, &barrier->header);
-
-  // NOTE: all new tasks emitted will be executed after this barrier.
-  command_buffer->state.open_barrier = barrier;
-  command_buffer->state.open_task_count = 0;
+// Returns true if |a| and |b| overlap.
+static bool iree_hal_task_command_buffer_ranges_overlap(
+    const iree_hal_task_command_buffer_range_t* a,
+    const iree_hal_task_command_buffer_range_t* b) {
+  if (!a->buffer || !b->buffer) return true;
+  return a->buffer == b->buffer && a->begin < b->end && b->begin < a->end;
+}
 
-  return iree_ok_status();
+// Returns true if |a| contains all of |b|.
+static bool iree_hal_task_command_buffer_range_contains(
+    const iree_hal_task_command_buffer_range_t* a,
+    const iree_hal_task_command_buffer_range_t* b) {
+  return a->buffer && a->buffer == b->buffer && a->begin <= b->begin &&
+         b->end <= a->end;
 }
 
-// Emits a the given execution |task| into the current open synchronization
-// scope (after state.open_barrier and before the next barrier).
+// Emits the given execution |task| performing |accesses| into the DAG.
+// The task depends on each task recorded before the most recent execution
+// barrier that accesses an overlapping range where one of the two accesses is a
+// write. Tasks without any such dependency depend on the last global barrier
+// or are roots of the DAG.
 static iree_status_t iree_hal_task_command_buffer_emit_execution_task(
-    iree_hal_task_command_buffer_t* command_buffer, iree_task_t* task) {
-  if (command_buffer->state.open_barrier == NULL) {
-    // If there is no open barrier then we are at the head and going right into
-    // the task DAG.
-    iree_task_list_push_back(&command_buffer->leaf_tasks, task);
-  } else {
-    // Append to the open task list that will be flushed to the open barrier.
-    iree_task_list_push_back(&command_buffer->state.open_tasks, task);
-    ++command_buffer->state.open_task_count;
+    iree_hal_task_command_buffer_t* command_buffer, iree_task_t* task,
+    iree_host_size_t access_count,
+    const iree_hal_task_command_buffer_access_t* accesses) {
+  iree_hal_task_command_buffer_node_t* node = NULL;
+  IREE_RETURN_IF_ERROR(
+      iree_hal_task_command_buffer_append_node(command_buffer, task, &node));
+  const uint32_t epoch = node->epoch;
+
+  // Walk the tracked accesses to find conflicts, dropping those that have been
+  // superseded as we go.
+  iree_hal_task_command_buffer_tracked_access_t** tracked_ptr =
+      &command_buffer->state.access_head;
+  while (*tracked_ptr) {
+    iree_hal_task_command_buffer_tracked_access_t* tracked = *tracked_ptr;
+    if (tracked->superseded_epoch <= epoch) {
+      *tracked_ptr = tracked->next;
+      tracked->next = command_buffer->state.access_pool;
+      command_buffer->state.access_pool = tracked;
+      --command_buffer->state.access_count;
+      continue;
+    }
+    tracked_ptr = &tracked->next;
+    if (tracked->node->epoch == epoch) continue;
+    for (iree_host_size_t i = 0; i < access_count; ++i) {
+      if (!tracked->access.is_write && !accesses[i].is_write) continue;
+      if (!iree_hal_task_command_buffer_ranges_overlap(
+              &tracked->access.range, &accesses[i].range)) {
+        continue;
+      }
+      IREE_RETURN_IF_ERROR(iree_hal_task_command_buffer_add_dependent(
+          command_buffer, tracked->node, task));
+      node->has_dependencies = true;
+      if (accesses[i].is_write &&
+          iree_hal_task_command_buffer_range_contains(&accesses[i].range,
+                                                      &tracked->access.range)) {
+        // Tasks recorded after the next barrier will depend on this one.
+        tracked->superseded_epoch = iree_min(tracked->superseded_epoch,
+                                             epoch + 1);
+      }
+    }
+  }
+  if (!node->has_dependencies && command_buffer->state.join) {
+    IREE_RETURN_IF_ERROR(iree_hal_task_command_buffer_add_dependent(
+        command_buffer, command_buffer->state.join, task));
+    node->has_dependencies = true;
+  }
+
+  // Track the accesses for the tasks recorded after the next barrier.
+  for (iree_host_size_t i = 0; i < access_count; ++i) {
+    const iree_hal_task_command_buffer_range_t* range = &accesses[i].range;
+    if (range->buffer && range->begin >= range->end) continue;
+    iree_hal_task_command_buffer_tracked_access_t* tracked =
+        command_buffer->state.access_pool;
+    if (tracked) {
+      command_buffer->state.access_pool = tracked->next;
+    } else {
+      IREE_RETURN_IF_ERROR(iree_arena_allocate(
+          &command_buffer->arena, sizeof(*tracked), (void**)&tracked));
+    }
+    tracked->next = command_buffer->state.access_head;
+    tracked->node = node;
+    tracked->access = accesses[i];
+    tracked->superseded_epoch = UINT32_MAX;
+    command_buffer->state.access_head = tracked;
+    ++command_buffer->state.access_count;
   }
+
   return iree_ok_status();
 }
 
@@ -348,6 +677,165 @@ static iree_status_t iree_hal_task_command_buffer_emit_execution_task(
 // iree_hal_task_command_buffer_t execution
 //===----------------------------------------------------------------------===//
 
+// Resolves |fixup| against |binding_table| and writes the binding pointer and
+// length into the cloned |task|.
+static iree_status_t iree_hal_task_command_buffer_apply_fixup(
+    const iree_hal_task_command_buffer_fixup_t* fixup,
+    iree_hal_buffer_binding_table_t binding_table, iree_task_t* task) {
+  if (IREE_UNLIKELY(fixup->slot >= binding_table.count)) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "binding table slot %u out of range (count=%" PRIhsz
+                            ")",
+                            fixup->slot, binding_table.count);
+  }
+  const iree_hal_buffer_binding_t* binding =
+      &binding_table.bindings[fixup->slot];
+  if (IREE_UNLIKELY(!binding->buffer)) {
+    return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                            "binding table slot %u has no buffer", fixup->slot);
+  }
+
+  // The binding range is relative to the binding table entry range.
+  iree_device_size_t length = fixup->length;
+  if (length == IREE_WHOLE_BUFFER && binding->length != IREE_WHOLE_BUFFER) {
+    if (IREE_UNLIKELY(fixup->offset > binding->length)) {
+      return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                              "binding offset %" PRIdsz
+                              " past the end of binding table slot %u",
+                              fixup->offset, fixup->slot);
+    }
+    length = binding->length - fixup->offset;
+  }
+  iree_hal_buffer_mapping_t buffer_mapping = {{0}};
+  IREE_RETURN_IF_ERROR(iree_hal_buffer_map_range(
+      binding->buffer, IREE_HAL_MAPPING_MODE_PERSISTENT,
+      IREE_HAL_MEMORY_ACCESS_ANY, binding->offset + fixup->offset, length,
+      &buffer_mapping));
+  *(void**)((uint8_t*)task + fixup->ptr_offset) = buffer_mapping.contents.data;
+  *(size_t*)((uint8_t*)task + fixup->length_offset) =
+      buffer_mapping.contents.data_length;
+  return iree_ok_status();
+}
+
+// Clones the task DAG recorded in a template |command_buffer| and returns the
+// clones of its root and leaf tasks. The clones are recorded into
+// |target_command_buffer| if provided and otherwise allocated from |arena|.
+// Bindings referencing binding table slots are resolved with |binding_table|.
+//
+// The recorded tasks are only read and never issued so their execution state
+// (dependency counts, flags, status) is that of freshly initialized tasks and
+// can be copied as-is.
+static iree_status_t iree_hal_task_command_buffer_clone_tasks(
+    iree_hal_task_command_buffer_t* command_buffer,
+    iree_hal_buffer_binding_table_t binding_table,
+    iree_hal_task_command_buffer_t* target_command_buffer,
+    iree_arena_allocator_t* arena, iree_task_list_t* out_root_tasks,
+    iree_task_list_t* out_leaf_tasks) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, command_buffer->record_count);
+  iree_task_list_initialize(out_root_tasks);
+  iree_task_list_initialize(out_leaf_tasks);
+  if (target_command_buffer) arena = &target_command_buffer->arena;
+
+  iree_task_t** clones = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_arena_allocate(arena,
+                              command_buffer->record_count * sizeof(*clones),
+                              (void**)&clones));
+
+  // Copy the tasks along with their trailing command data. Closures receive
+  // the command as their user context and must point at the copy.
+  for (const iree_hal_task_command_buffer_record_t* record =
+           command_buffer->record_head;
+       record != NULL; record = record->next) {
+    const iree_task_t* task = (const iree_task_t*)(record + 1);
+    iree_task_t* clone = NULL;
+    IREE_RETURN_AND_END_ZONE_IF_ERROR(
+        z0, target_command_buffer
+                ? iree_hal_task_command_buffer_allocate_task(
+                      target_command_buffer, record->task_size, (void**)&clone)
+                : iree_arena_allocate(arena, record->task_size,
+                                      (void**)&clone));
+    memcpy(clone, task, record->task_size);
+    clone->next_task = NULL;
+    if (clone->type == IREE_TASK_TYPE_CALL) {
+      iree_task_call_t* call_task = (iree_task_call_t*)clone;
+      if (call_task->closure.user_context == task) {
+        call_task->closure.user_context = clone;
+      }
+    } else if (clone->type == IREE_TASK_TYPE_DISPATCH) {
+      iree_task_dispatch_t* dispatch_task = (iree_task_dispatch_t*)clone;
+      if (dispatch_task->closure.user_context == task) {
+        dispatch_task->closure.user_context = clone;
+      }
+    }
+    for (iree_host_size_t i = 0; i < record->fixup_count; ++i) {
+      IREE_RETURN_AND_END_ZONE_IF_ERROR(
+          z0, iree_hal_task_command_buffer_apply_fixup(&record->fixups[i],
+                                                       binding_table, clone));
+    }
+    clones[record->ordinal] = clone;
+  }
+
+  // Remap the edges of the DAG to the clones. Dependency counts were copied
+  // with the tasks and need no changes.
+  for (const iree_hal_task_command_buffer_record_t* record =
+           command_buffer->record_head;
+       record != NULL; record = record->next) {
+    const iree_task_t* task = (const iree_task_t*)(record + 1);
+    iree_task_t* clone = clones[record->ordinal];
+    if (task->completion_task) {
+      clone->completion_task =
+          clones[iree_hal_task_command_buffer_task_record(task->completion_task)
+                     ->ordinal];
+    }
+    if (task->type != IREE_TASK_TYPE_BARRIER) continue;
+    const iree_task_barrier_t* barrier = (const iree_task_barrier_t*)task;
+    if (barrier->dependent_task_count == 0) continue;
+    iree_task_t** dependent_tasks = NULL;
+    IREE_RETURN_AND_END_ZONE_IF_ERROR(
+        z0, iree_arena_allocate(
+                arena, barrier->dependent_task_count * sizeof(iree_task_t*),
+                (void**)&dependent_tasks));
+    for (iree_host_size_t i = 0; i < barrier->dependent_task_count; ++i) {
+      dependent_tasks[i] =
+          clones[iree_hal_task_command_buffer_task_record(
+                     barrier->dependent_tasks[i])
+                     ->ordinal];
+    }
+    ((iree_task_barrier_t*)clone)->dependent_tasks = dependent_tasks;
+  }
+
+  for (iree_task_t* task = command_buffer->root_tasks.head; task != NULL;
+       task = task->next_task) {
+    iree_task_list_push_back(
+        out_root_tasks,
+        clones[iree_hal_task_command_buffer_task_record(task)->ordinal]);
+  }
+  for (iree_task_t* task = command_buffer->leaf_tasks.head; task != NULL;
+       task = task->next_task) {
+    iree_task_list_push_back(
+        out_leaf_tasks,
+        clones[iree_hal_task_command_buffer_task_record(task)->ordinal]);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+iree_status_t iree_hal_task_command_buffer_validate_issue(
+    iree_hal_command_buffer_t* base_command_buffer) {
+  iree_hal_task_command_buffer_t* command_buffer =
+      iree_hal_task_command_buffer_cast(base_command_buffer);
+  if (IREE_UNLIKELY(command_buffer->fixup_count > 0)) {
+    return iree_make_status(
+        IREE_STATUS_FAILED_PRECONDITION,
+        "command buffer references binding table slots and can only be "
+        "executed with a binding table");
+  }
+  return iree_ok_status();
+}
+
 iree_status_t iree_hal_task_command_buffer_issue(
     iree_hal_command_buffer_t* base_command_buffer,
     iree_hal_task_queue_state_t* queue_state, iree_task_t* retire_task,
@@ -362,29 +850,43 @@ iree_status_t iree_hal_task_command_buffer_issue(
     return iree_ok_status();
   }
 
-  bool has_leaf_tasks = !iree_task_list_is_empty(&command_buffer->leaf_tasks);
+  IREE_RETURN_IF_ERROR(
+      iree_hal_task_command_buffer_validate_issue(base_command_buffer));
+
+  // One-shot command buffers hand their tasks over to the submission. After
+  // this they are owned by the submission and we need to ensure the command
+  // buffer doesn't try to discard them. Reusable command buffers keep their
+  // tasks and submit a clone allocated from the submission |arena| instead.
+  iree_task_list_t root_tasks;
+  iree_task_list_t leaf_tasks;
+  if (!iree_hal_task_command_buffer_is_template(command_buffer)) {
+    iree_task_list_move(&command_buffer->root_tasks, &root_tasks);
+    iree_task_list_move(&command_buffer->leaf_tasks, &leaf_tasks);
+  } else {
+    IREE_RETURN_IF_ERROR(iree_hal_task_command_buffer_clone_tasks(
+        command_buffer, iree_hal_buffer_binding_table_empty(),
+        /*target_command_buffer=*/NULL, arena, &root_tasks, &leaf_tasks));
+  }
+
+  bool has_leaf_tasks = !iree_task_list_is_empty(&leaf_tasks);
   if (has_leaf_tasks) {
     // Chain the retire task onto the leaf tasks as their completion indicates
     // that all commands have completed.
-    for (iree_task_t* task = command_buffer->leaf_tasks.head; task != NULL;
+    for (iree_task_t* task = leaf_tasks.head; task != NULL;
          task = task->next_task) {
       iree_task_set_completion_task(task, retire_task);
     }
   } else {
     // If we have no leaf tasks it means that this is a single layer DAG and
     // after the root tasks complete the entire command buffer has completed.
-    for (iree_task_t* task = command_buffer->root_tasks.head; task != NULL;
+    for (iree_task_t* task = root_tasks.head; task != NULL;
          task = task->next_task) {
       iree_task_set_completion_task(task, retire_task);
     }
   }
 
   // Enqueue all root tasks that are ready to run immediately.
-  // After this all of the command buffer tasks are owned by the submission and
-  // we need to ensure the command buffer doesn't try to discard them.
-  iree_task_submission_enqueue_list(pending_submission,
-                                    &command_buffer->root_tasks);
-  iree_task_list_initialize(&command_buffer->leaf_tasks);
+  iree_task_submission_enqueue_list(pending_submission, &root_tasks);
 
   return iree_ok_status();
 }
@@ -409,6 +911,21 @@ static void iree_hal_task_command_buffer_end_debug_group(
 // iree_hal_command_buffer_execution_barrier
 //===----------------------------------------------------------------------===//
 
+// Emits an execution barrier. Tasks recorded after it depend on the tasks
+// recorded before it that they have conflicting buffer accesses with; memory
+// and buffer barriers need no handling of their own as the accesses of every
+// task are tracked. If too many accesses are tracked we fall back to a global
+// barrier to reset the tracking.
+static iree_status_t iree_hal_task_command_buffer_emit_barrier(
+    iree_hal_task_command_buffer_t* command_buffer) {
+  ++command_buffer->state.epoch;
+  if (command_buffer->state.access_count >
+      IREE_HAL_TASK_COMMAND_BUFFER_MAX_TRACKED_ACCESSES) {
+    return iree_hal_task_command_buffer_emit_global_barrier(command_buffer);
+  }
+  return iree_ok_status();
+}
+
 static iree_status_t iree_hal_task_command_buffer_execution_barrier(
     iree_hal_command_buffer_t* base_command_buffer,
     iree_hal_execution_stage_t source_stage_mask,
@@ -420,10 +937,7 @@ static iree_status_t iree_hal_task_command_buffer_execution_barrier(
     const iree_hal_buffer_barrier_t* buffer_barriers) {
   iree_hal_task_command_buffer_t* command_buffer =
       iree_hal_task_command_buffer_cast(base_command_buffer);
-
-  // TODO(benvanik): actual DAG construction. Right now we are just doing simple
-  // global barriers each time and forcing a join-fork point.
-  return iree_hal_task_command_buffer_emit_global_barrier(command_buffer);
+  return iree_hal_task_command_buffer_emit_barrier(command_buffer);
 }
 
 //===----------------------------------------------------------------------===//
@@ -433,7 +947,8 @@ static iree_status_t iree_hal_task_command_buffer_execution_barrier(
 static iree_status_t iree_hal_task_command_buffer_signal_event(
     iree_hal_command_buffer_t* base_command_buffer, iree_hal_event_t* event,
     iree_hal_execution_stage_t source_stage_mask) {
-  // TODO(#4518): implement events. For now we just insert global barriers.
+  // Events only order work within the command buffer and the ordering is
+  // established by the dependency tracking in wait_events.
   return iree_ok_status();
 }
 
@@ -444,7 +959,8 @@ static iree_status_t iree_hal_task_command_buffer_signal_event(
 static iree_status_t iree_hal_task_command_buffer_reset_event(
     iree_hal_command_buffer_t* base_command_buffer, iree_hal_event_t* event,
     iree_hal_execution_stage_t source_stage_mask) {
-  // TODO(#4518): implement events. For now we just insert global barriers.
+  // Events only order work within the command buffer and the ordering is
+  // established by the dependency tracking in wait_events.
   return iree_ok_status();
 }
 
@@ -463,8 +979,10 @@ static iree_status_t iree_hal_task_command_buffer_wait_events(
     const iree_hal_buffer_barrier_t* buffer_barriers) {
   iree_hal_task_command_buffer_t* command_buffer =
       iree_hal_task_command_buffer_cast(base_command_buffer);
-  // TODO(#4518): implement events. For now we just insert global barriers.
-  return iree_hal_task_command_buffer_emit_global_barrier(command_buffer);
+  // Waiting is treated as a barrier: tasks recorded after the wait depend on
+  // the conflicting tasks recorded before it, which includes all those recorded
+  // before the events were signaled.
+  return iree_hal_task_command_buffer_emit_barrier(command_buffer);
 }
 
 //===----------------------------------------------------------------------===//
@@ -532,8 +1050,8 @@ static iree_status_t iree_hal_task_command_buffer_fill_buffer(
       command_buffer->resource_set, 1, &target_buffer));
 
   iree_hal_cmd_fill_buffer_t* cmd = NULL;
-  IREE_RETURN_IF_ERROR(
-      iree_arena_allocate(&command_buffer->arena, sizeof(*cmd), (void**)&cmd));
+  IREE_RETURN_IF_ERROR(iree_hal_task_command_buffer_allocate_task(
+      command_buffer, sizeof(*cmd), (void**)&cmd));
 
   const uint32_t workgroup_size[3] = {
       /*x=*/IREE_HAL_CMD_FILL_SLICE_LENGTH,
@@ -555,8 +1073,13 @@ static iree_status_t iree_hal_task_command_buffer_fill_buffer(
   memcpy(cmd->pattern, pattern, pattern_length);
   cmd->pattern_length = pattern_length;
 
-  return iree_hal_task_command_buffer_emit_execution_task(command_buffer,
-                                                          &cmd->task.header);
+  const iree_hal_task_command_buffer_access_t access = {
+      .range = iree_hal_task_command_buffer_make_range(target_buffer,
+                                                       target_offset, length),
+      .is_write = true,
+  };
+  return iree_hal_task_command_buffer_emit_execution_task(
+      command_buffer, &cmd->task.header, 1, &access);
 }
 
 //===----------------------------------------------------------------------===//
@@ -597,8 +1120,8 @@ static iree_status_t iree_hal_task_command_buffer_update_buffer(
       sizeof(iree_hal_cmd_update_buffer_t) + length;
 
   iree_hal_cmd_update_buffer_t* cmd = NULL;
-  IREE_RETURN_IF_ERROR(iree_arena_allocate(&command_buffer->arena,
-                                           total_cmd_size, (void**)&cmd));
+  IREE_RETURN_IF_ERROR(iree_hal_task_command_buffer_allocate_task(
+      command_buffer, total_cmd_size, (void**)&cmd));
 
   iree_task_call_initialize(
       command_buffer->scope,
@@ -611,8 +1134,13 @@ static iree_status_t iree_hal_task_command_buffer_update_buffer(
   memcpy(cmd->source_buffer, (const uint8_t*)source_buffer + source_offset,
          cmd->length);
 
-  return iree_hal_task_command_buffer_emit_execution_task(command_buffer,
-                                                          &cmd->task.header);
+  const iree_hal_task_command_buffer_access_t access = {
+      .range = iree_hal_task_command_buffer_make_range(target_buffer,
+                                                       target_offset, length),
+      .is_write = true,
+  };
+  return iree_hal_task_command_buffer_emit_execution_task(
+      command_buffer, &cmd->task.header, 1, &access);
 }
 
 //===----------------------------------------------------------------------===//
@@ -672,8 +1200,8 @@ static iree_status_t iree_hal_task_command_buffer_copy_buffer(
       iree_hal_resource_set_insert(command_buffer->resource_set, 2, buffers));
 
   iree_hal_cmd_copy_buffer_t* cmd = NULL;
-  IREE_RETURN_IF_ERROR(
-      iree_arena_allocate(&command_buffer->arena, sizeof(*cmd), (void**)&cmd));
+  IREE_RETURN_IF_ERROR(iree_hal_task_command_buffer_allocate_task(
+      command_buffer, sizeof(*cmd), (void**)&cmd));
 
   const uint32_t workgroup_size[3] = {
       /*x=*/IREE_HAL_CMD_COPY_SLICE_LENGTH,
@@ -695,8 +1223,20 @@ static iree_status_t iree_hal_task_command_buffer_copy_buffer(
   cmd->target_offset = target_offset;
   cmd->length = length;
 
-  return iree_hal_task_command_buffer_emit_execution_task(command_buffer,
-                                                          &cmd->task.header);
+  const iree_hal_task_command_buffer_access_t accesses[2] = {
+      {
+          .range = iree_hal_task_command_buffer_make_range(
+              source_buffer, source_offset, length),
+          .is_write = false,
+      },
+      {
+          .range = iree_hal_task_command_buffer_make_range(
+              target_buffer, target_offset, length),
+          .is_write = true,
+      },
+  };
+  return iree_hal_task_command_buffer_emit_execution_task(
+      command_buffer, &cmd->task.header, IREE_ARRAYSIZE(accesses), accesses);
 }
 
 //===----------------------------------------------------------------------===//
@@ -799,10 +1339,31 @@ static iree_status_t iree_hal_task_command_buffer_push_descriptor_set(
           buffer_mapping.contents.data;
       command_buffer->state.binding_lengths[binding_ordinal] =
           buffer_mapping.contents.data_length;
+      command_buffer->state.binding_ranges[binding_ordinal] =
+          iree_hal_task_command_buffer_make_range(
+              bindings[i].buffer, bindings[i].offset,
+              buffer_mapping.contents.data_length);
+      command_buffer->state.binding_refs[binding_ordinal].indirect = false;
     } else {
-      // TODO(#10144): stash indirect binding reference in the state table.
-      return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
-                              "binding table lookup not yet supported");
+      // Stash the binding table reference; dispatches using it record a fixup
+      // that is resolved when the command buffer is executed.
+      if (IREE_UNLIKELY(bindings[i].buffer_slot >=
+                        command_buffer->base.binding_capacity)) {
+        return iree_make_status(
+            IREE_STATUS_OUT_OF_RANGE,
+            "binding table slot %u out of range (capacity=%u)",
+            bindings[i].buffer_slot, command_buffer->base.binding_capacity);
+      }
+      command_buffer->state.bindings[binding_ordinal] = NULL;
+      command_buffer->state.binding_lengths[binding_ordinal] = 0;
+      memset(&command_buffer->state.binding_ranges[binding_ordinal], 0,
+             sizeof(command_buffer->state.binding_ranges[binding_ordinal]));
+      iree_hal_task_command_buffer_binding_ref_t* binding_ref =
+          &command_buffer->state.binding_refs[binding_ordinal];
+      binding_ref->indirect = true;
+      binding_ref->slot = bindings[i].buffer_slot;
+      binding_ref->offset = bindings[i].offset;
+      binding_ref->length = bindings[i].length;
     }
   }
 
@@ -886,6 +1447,7 @@ static iree_status_t iree_hal_task_command_buffer_build_dispatch(
     iree_hal_command_buffer_t* base_command_buffer,
     iree_hal_executable_t* executable, int32_t entry_point,
     uint32_t workgroup_x, uint32_t workgroup_y, uint32_t workgroup_z,
+    const iree_hal_task_command_buffer_access_t* workgroups_access,
     iree_hal_cmd_dispatch_t** out_cmd) {
   iree_hal_task_command_buffer_t* command_buffer =
       iree_hal_task_command_buffer_cast(base_command_buffer);
@@ -903,6 +1465,8 @@ static iree_status_t iree_hal_task_command_buffer_build_dispatch(
           local_executable->pipeline_layouts[entry_point];
   iree_host_size_t push_constant_count = local_layout->push_constants;
   iree_hal_local_binding_mask_t used_binding_mask = local_layout->used_bindings;
+  iree_hal_local_binding_mask_t read_only_binding_mask =
+      local_layout->read_only_bindings;
   iree_host_size_t used_binding_count =
       iree_math_count_ones_u64(used_binding_mask);
 
@@ -918,8 +1482,8 @@ static iree_status_t iree_hal_task_command_buffer_build_dispatch(
       sizeof(*cmd) + push_constant_count * sizeof(uint32_t) +
       used_binding_count * sizeof(void*) +
       used_binding_count * sizeof(iree_device_size_t);
-  IREE_RETURN_IF_ERROR(iree_arena_allocate(&command_buffer->arena,
-                                           total_cmd_size, (void**)&cmd));
+  IREE_RETURN_IF_ERROR(iree_hal_task_command_buffer_allocate_task(
+      command_buffer, total_cmd_size, (void**)&cmd));
 
   cmd->executable = local_executable;
   cmd->ordinal = entry_point;
@@ -958,10 +1522,22 @@ static iree_status_t iree_hal_task_command_buffer_build_dispatch(
   // Note that we are just directly setting the binding data pointers here with
   // no ownership/retaining/etc - it's part of the HAL contract that buffers are
   // kept valid for the duration they may be in use.
+  //
+  // Bindings referencing binding table slots are left NULL and recorded as
+  // fixups resolved when the command buffer is executed with a binding table.
+  // There can be at most one per used binding.
   void** binding_ptrs = (void**)cmd_ptr;
   cmd_ptr += used_binding_count * sizeof(*binding_ptrs);
   size_t* binding_lengths = (size_t*)cmd_ptr;
   cmd_ptr += used_binding_count * sizeof(*binding_lengths);
+  //
+  // Each binding is also an access of the dispatch for dependency tracking;
+  // those not declared read-only are assumed to be written.
+  iree_hal_task_command_buffer_fixup_t* fixups = NULL;
+  iree_host_size_t fixup_count = 0;
+  iree_hal_task_command_buffer_access_t
+      accesses[IREE_HAL_LOCAL_BINDING_MASK_BITS + 1];
+  iree_host_size_t access_count = 0;
   iree_host_size_t binding_base = 0;
   for (iree_host_size_t i = 0; i < used_binding_count; ++i) {
     int mask_offset = iree_math_count_trailing_zeros_u64(used_binding_mask);
@@ -970,15 +1546,47 @@ static iree_status_t iree_hal_task_command_buffer_build_dispatch(
     used_binding_mask = iree_shr(used_binding_mask, mask_offset + 1);
     binding_ptrs[i] = command_buffer->state.bindings[binding_ordinal];
     binding_lengths[i] = command_buffer->state.binding_lengths[binding_ordinal];
-    if (!binding_ptrs[i]) {
+    accesses[access_count].range =
+        command_buffer->state.binding_ranges[binding_ordinal];
+    accesses[access_count].is_write =
+        !iree_all_bits_set(read_only_binding_mask, 1ull << binding_ordinal);
+    ++access_count;
+    const iree_hal_task_command_buffer_binding_ref_t* binding_ref =
+        &command_buffer->state.binding_refs[binding_ordinal];
+    if (binding_ref->indirect) {
+      if (!fixups) {
+        IREE_RETURN_IF_ERROR(iree_arena_allocate(
+            &command_buffer->arena, used_binding_count * sizeof(*fixups),
+            (void**)&fixups));
+      }
+      iree_hal_task_command_buffer_fixup_t* fixup = &fixups[fixup_count++];
+      fixup->slot = binding_ref->slot;
+      fixup->ptr_offset =
+          (uint32_t)((uint8_t*)&binding_ptrs[i] - (uint8_t*)cmd);
+      fixup->length_offset =
+          (uint32_t)((uint8_t*)&binding_lengths[i] - (uint8_t*)cmd);
+      fixup->offset = binding_ref->offset;
+      fixup->length = binding_ref->length;
+    } else if (!binding_ptrs[i]) {
       return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
                               "(flat) binding %d is NULL", binding_ordinal);
     }
   }
+  if (fixup_count > 0) {
+    // Only nested command buffers accept binding table slots and those are
+    // always templates with records.
+    iree_hal_task_command_buffer_record_t* record =
+        iree_hal_task_command_buffer_task_record(&cmd->task.header);
+    record->fixup_count = fixup_count;
+    record->fixups = fixups;
+    command_buffer->fixup_count += fixup_count;
+  }
+
+  if (workgroups_access) accesses[access_count++] = *workgroups_access;
 
   *out_cmd = cmd;
-  return iree_hal_task_command_buffer_emit_execution_task(command_buffer,
-                                                          &cmd->task.header);
+  return iree_hal_task_command_buffer_emit_execution_task(
+      command_buffer, &cmd->task.header, access_count, accesses);
 }
 
 static iree_status_t iree_hal_task_command_buffer_dispatch(
@@ -992,7 +1600,7 @@ static iree_status_t iree_hal_task_command_buffer_dispatch(
   iree_hal_cmd_dispatch_t* cmd = NULL;
   return iree_hal_task_command_buffer_build_dispatch(
       base_command_buffer, executable, entry_point, workgroup_x, workgroup_y,
-      workgroup_z, &cmd);
+      workgroup_z, /*workgroups_access=*/NULL, &cmd);
 }
 
 static iree_status_t iree_hal_task_command_buffer_dispatch_indirect(
@@ -1014,9 +1622,15 @@ static iree_status_t iree_hal_task_command_buffer_dispatch_indirect(
       IREE_HAL_MEMORY_ACCESS_READ, workgroups_offset, 3 * sizeof(uint32_t),
       &buffer_mapping));
 
+  const iree_hal_task_command_buffer_access_t workgroups_access = {
+      .range = iree_hal_task_command_buffer_make_range(
+          workgroups_buffer, workgroups_offset, 3 * sizeof(uint32_t)),
+      .is_write = false,
+  };
   iree_hal_cmd_dispatch_t* cmd = NULL;
   IREE_RETURN_IF_ERROR(iree_hal_task_command_buffer_build_dispatch(
-      base_command_buffer, executable, entry_point, 0, 0, 0, &cmd));
+      base_command_buffer, executable, entry_point, 0, 0, 0,
+      &workgroups_access, &cmd));
   cmd->task.workgroup_count.ptr = (const uint32_t*)buffer_mapping.contents.data;
   cmd->task.header.flags |= IREE_TASK_FLAG_DISPATCH_INDIRECT;
   return iree_ok_status();
@@ -1030,16 +1644,83 @@ static iree_status_t iree_hal_task_command_buffer_execute_commands(
     iree_hal_command_buffer_t* base_command_buffer,
     iree_hal_command_buffer_t* base_commands,
     iree_hal_buffer_binding_table_t binding_table) {
-  // TODO(#10144): support indirect command buffers by using deferred command
-  // buffers or caching the task topology (probably not worth the tracking).
-  // If we could separate the topology that referenced the binding table we'd
-  // be able to reissue but not concurrently (as each task can only be in flight
-  // as a singleton) - which may be enough in many cases but adds complexity to
-  // tracking as we'd need to either enforce serialization of subsequent
-  // submissions or copy-on-write-style clone the topology for each additional
-  // concurrent submission.
-  return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
-                          "indirect command buffers not yet implemented");
+  iree_hal_task_command_buffer_t* command_buffer =
+      iree_hal_task_command_buffer_cast(base_command_buffer);
+  if (!iree_hal_task_command_buffer_isa(base_commands)) {
+    return iree_make_status(
+        IREE_STATUS_INVALID_ARGUMENT,
+        "only task command buffers can be executed by task command buffers");
+  }
+  iree_hal_task_command_buffer_t* commands =
+      iree_hal_task_command_buffer_cast(base_commands);
+  if (!iree_hal_task_command_buffer_is_template(commands)) {
+    return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                            "executed command buffers must be nested or "
+                            "reusable");
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // The nested command buffer retains the resources used by its commands and
+  // the binding table buffers are retained here as they are now referenced by
+  // our clones of the commands.
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_hal_resource_set_insert(command_buffer->resource_set, 1,
+                                       &base_commands));
+  for (iree_host_size_t i = 0; i < binding_table.count; ++i) {
+    if (!binding_table.bindings[i].buffer) continue;
+    IREE_RETURN_AND_END_ZONE_IF_ERROR(
+        z0, iree_hal_resource_set_insert(command_buffer->resource_set, 1,
+                                         &binding_table.bindings[i].buffer));
+  }
+
+  // Clone the nested task DAG into ours with the bindings resolved.
+  iree_task_list_t root_tasks;
+  iree_task_list_t leaf_tasks;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_hal_task_command_buffer_clone_tasks(
+              commands, binding_table, command_buffer, /*arena=*/NULL,
+              &root_tasks, &leaf_tasks));
+
+  // The buffer ranges accessed by the nested tasks aren't tracked and the
+  // nested DAG is spliced in between two global barriers: the nested root tasks
+  // depend on the first and the nested leaf tasks join into the second.
+  iree_status_t status = iree_ok_status();
+  if (!iree_task_list_is_empty(&root_tasks)) {
+    status = iree_hal_task_command_buffer_emit_global_barrier(command_buffer);
+  }
+  iree_task_barrier_t* barrier = NULL;
+  if (iree_status_is_ok(status) && !iree_task_list_is_empty(&root_tasks)) {
+    status = iree_hal_task_command_buffer_allocate_task(
+        command_buffer, sizeof(*barrier), (void**)&barrier);
+  }
+  if (iree_status_is_ok(status) && barrier) {
+    iree_task_barrier_initialize_empty(command_buffer->scope, barrier);
+    // An empty leaf list indicates that the root tasks are also the leaves.
+    iree_task_list_t* nested_leaf_tasks =
+        iree_task_list_is_empty(&leaf_tasks) ? &root_tasks : &leaf_tasks;
+    for (iree_task_t* task = iree_task_list_front(nested_leaf_tasks);
+         task != NULL; task = task->next_task) {
+      iree_task_set_completion_task(task, &barrier->header);
+    }
+    // Without a prior global barrier nothing was recorded yet and the nested
+    // root tasks are our roots.
+    iree_hal_task_command_buffer_node_t* join = command_buffer->state.join;
+    while (iree_status_is_ok(status) && !iree_task_list_is_empty(&root_tasks)) {
+      iree_task_t* task = iree_task_list_pop_front(&root_tasks);
+      if (join) {
+        status = iree_hal_task_command_buffer_add_dependent(command_buffer,
+                                                            join, task);
+      } else {
+        iree_task_list_push_back(&command_buffer->root_tasks, task);
+      }
+    }
+    if (iree_status_is_ok(status)) {
+      status = iree_hal_task_command_buffer_emit_join(command_buffer, barrier);
+    }
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
 }
 
 //===----------------------------------------------------------------------===//
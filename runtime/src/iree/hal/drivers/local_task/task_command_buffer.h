@@ -30,6 +30,12 @@ iree_status_t iree_hal_task_command_buffer_create(
 bool iree_hal_task_command_buffer_isa(
     iree_hal_command_buffer_t* command_buffer);
 
+// Returns FAILED_PRECONDITION if |command_buffer| cannot be issued to a queue,
+// such as when it references binding table slots that can only be resolved by
+// executing it from another command buffer.
+iree_status_t iree_hal_task_command_buffer_validate_issue(
+    iree_hal_command_buffer_t* command_buffer);
+
 // Issues a recorded command buffer using the serial |queue_state|.
 // |queue_state| is used to track the synchronization scope of the queue from
 // prior commands such as signaled events and will be mutated as events are
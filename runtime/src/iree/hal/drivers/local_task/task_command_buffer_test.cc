@@ -0,0 +1,713 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// Tests for behavior specific to the task command buffer that the CTS does not
+// cover, such as executing nested command buffers with binding tables and
+// ordering tasks by their buffer accesses.
+
+#include "iree/hal/drivers/local_task/task_command_buffer.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <utility>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/hal/drivers/local_task/task_device.h"
+#include "iree/hal/local/executable_library.h"
+#include "iree/hal/local/loaders/static_library_loader.h"
+#include "iree/task/api.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace {
+
+//===----------------------------------------------------------------------===//
+// Test executable library
+//===----------------------------------------------------------------------===//
+
+// binding[1][x] = binding[0][x] + push_constant[0] for each workgroup x, after
+// spinning for push_constant[1] microseconds. Delaying the reads and writes
+// makes tasks that are not ordered after the dispatch when they should be
+// observe or clobber the wrong contents.
+static int add_constant(
+    const iree_hal_executable_environment_v0_t* environment,
+    const iree_hal_executable_dispatch_state_v0_t* dispatch_state,
+    const iree_hal_executable_workgroup_state_v0_t* workgroup_state) {
+  const iree_time_t deadline =
+      iree_time_now() + dispatch_state->push_constants[1] * 1000ll;
+  while (iree_time_now() < deadline) {
+  }
+  const uint32_t* src = (const uint32_t*)dispatch_state->binding_ptrs[0];
+  uint32_t* dst = (uint32_t*)dispatch_state->binding_ptrs[1];
+  const uint32_t x = workgroup_state->workgroup_id_x;
+  dst[x] = src[x] + dispatch_state->push_constants[0];
+  return 0;
+}
+
+static const iree_hal_executable_library_header_t test_library_header = {
+    IREE_HAL_EXECUTABLE_LIBRARY_VERSION_LATEST,
+    "task_command_buffer_test",
+    IREE_HAL_EXECUTABLE_LIBRARY_FEATURE_NONE,
+    IREE_HAL_EXECUTABLE_LIBRARY_SANITIZER_NONE,
+};
+static const iree_hal_executable_dispatch_v0_t test_library_entry_points[] = {
+    add_constant,
+};
+static const char* test_library_entry_point_names[] = {
+    "add_constant",
+};
+static const iree_hal_executable_library_v0_t test_library = {
+    &test_library_header,
+    /*imports=*/{0, NULL},
+    /*exports=*/
+    {
+        IREE_ARRAYSIZE(test_library_entry_points),
+        test_library_entry_points,
+        /*attrs=*/NULL,
+        test_library_entry_point_names,
+    },
+};
+
+static const iree_hal_executable_library_header_t** test_library_query(
+    iree_hal_executable_library_version_t max_version,
+    const iree_hal_executable_environment_v0_t* environment) {
+  return max_version <= IREE_HAL_EXECUTABLE_LIBRARY_VERSION_LATEST
+             ? (const iree_hal_executable_library_header_t**)&test_library
+             : NULL;
+}
+
+//===----------------------------------------------------------------------===//
+// Test fixture
+//===----------------------------------------------------------------------===//
+
+// Number of uint32_t elements in each test buffer.
+constexpr iree_host_size_t kElementCount = 64;
+
+// Delay of each workgroup of dispatches that other tasks must be ordered
+// around, long enough for the others to run first if they are not.
+constexpr uint32_t kDelayUs = 200;
+
+// Returns buffer contents made of runs of (element count, value).
+static std::vector<uint32_t> MakeContents(
+    std::initializer_list<std::pair<iree_host_size_t, uint32_t>> runs) {
+  std::vector<uint32_t> contents;
+  for (const auto& run : runs) {
+    contents.insert(contents.end(), run.first, run.second);
+  }
+  return contents;
+}
+
+class TaskCommandBufferTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    iree_allocator_t host_allocator = iree_allocator_system();
+
+    iree_task_topology_t topology;
+    iree_task_topology_initialize_from_group_count(/*group_count=*/4,
+                                                   &topology);
+    iree_task_executor_options_t options;
+    iree_task_executor_options_initialize(&options);
+    iree_status_t status = iree_task_executor_create(
+        options, &topology, host_allocator, &executor_);
+    iree_task_topology_deinitialize(&topology);
+    IREE_ASSERT_OK(status);
+
+    const iree_hal_executable_library_query_fn_t library_query_fns[] = {
+        test_library_query,
+    };
+    IREE_ASSERT_OK(iree_hal_static_library_loader_create(
+        IREE_ARRAYSIZE(library_query_fns), library_query_fns,
+        iree_hal_executable_import_provider_null(), host_allocator, &loader_));
+    IREE_ASSERT_OK(iree_hal_allocator_create_heap(
+        IREE_SV("heap"), host_allocator, host_allocator, &device_allocator_));
+    iree_hal_task_device_params_t params;
+    iree_hal_task_device_params_initialize(&params);
+    IREE_ASSERT_OK(iree_hal_task_device_create(
+        IREE_SV("local-task"), &params, /*queue_count=*/1, &executor_,
+        /*loader_count=*/1, &loader_, device_allocator_, host_allocator,
+        &device_));
+
+    const iree_hal_descriptor_set_layout_binding_t bindings[] = {
+        {0, IREE_HAL_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+         IREE_HAL_DESCRIPTOR_FLAG_READ_ONLY},
+        {1, IREE_HAL_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+         IREE_HAL_DESCRIPTOR_FLAG_NONE},
+    };
+    IREE_ASSERT_OK(iree_hal_descriptor_set_layout_create(
+        device_, IREE_HAL_DESCRIPTOR_SET_LAYOUT_FLAG_NONE,
+        IREE_ARRAYSIZE(bindings), bindings, &descriptor_set_layout_));
+    IREE_ASSERT_OK(iree_hal_pipeline_layout_create(
+        device_, /*push_constants=*/2, /*set_layout_count=*/1,
+        &descriptor_set_layout_, &pipeline_layout_));
+
+    IREE_ASSERT_OK(iree_hal_executable_cache_create(
+        device_, IREE_SV("default"), iree_loop_inline(&loop_status_),
+        &executable_cache_));
+    iree_hal_executable_params_t executable_params;
+    iree_hal_executable_params_initialize(&executable_params);
+    executable_params.executable_format = IREE_SV("static");
+    executable_params.executable_data = iree_make_const_byte_span(
+        test_library_header.name, strlen(test_library_header.name));
+    executable_params.pipeline_layout_count = 1;
+    executable_params.pipeline_layouts = &pipeline_layout_;
+    IREE_ASSERT_OK(iree_hal_executable_cache_prepare_executable(
+        executable_cache_, &executable_params, &executable_));
+  }
+
+  void TearDown() override {
+    for (iree_hal_buffer_t* buffer : buffers_) {
+      iree_hal_buffer_release(buffer);
+    }
+    iree_hal_executable_release(executable_);
+    iree_hal_executable_cache_release(executable_cache_);
+    iree_hal_pipeline_layout_release(pipeline_layout_);
+    iree_hal_descriptor_set_layout_release(descriptor_set_layout_);
+    iree_hal_device_release(device_);
+    iree_hal_allocator_release(device_allocator_);
+    iree_hal_executable_loader_release(loader_);
+    iree_task_executor_release(executor_);
+    IREE_ASSERT_OK(loop_status_);
+  }
+
+  // Returns a new buffer of |element_count| elements with each set to |value|.
+  // The buffer is released when the test ends.
+  iree_hal_buffer_t* CreateBuffer(
+      uint32_t value, iree_host_size_t element_count = kElementCount) {
+    iree_hal_buffer_params_t params = {0};
+    params.type =
+        IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL | IREE_HAL_MEMORY_TYPE_HOST_VISIBLE;
+    params.usage = IREE_HAL_BUFFER_USAGE_DISPATCH_STORAGE |
+                   IREE_HAL_BUFFER_USAGE_TRANSFER |
+                   IREE_HAL_BUFFER_USAGE_MAPPING;
+    iree_hal_buffer_t* buffer = NULL;
+    IREE_CHECK_OK(iree_hal_allocator_allocate_buffer(
+        device_allocator_, params, element_count * sizeof(uint32_t), &buffer));
+    IREE_CHECK_OK(iree_hal_buffer_map_fill(buffer, 0, IREE_WHOLE_BUFFER,
+                                           &value, sizeof(value)));
+    buffers_.push_back(buffer);
+    return buffer;
+  }
+
+  std::vector<uint32_t> ReadBuffer(iree_hal_buffer_t* buffer) {
+    iree_device_size_t byte_length = iree_hal_buffer_byte_length(buffer);
+    std::vector<uint32_t> contents(byte_length / sizeof(uint32_t));
+    IREE_CHECK_OK(
+        iree_hal_buffer_map_read(buffer, 0, contents.data(), byte_length));
+    return contents;
+  }
+
+  // Records a dispatch of add_constant over the first |count| elements of the
+  // |input| and |output| bindings with each workgroup delayed by |delay_us|.
+  void RecordAddConstant(iree_hal_command_buffer_t* command_buffer,
+                         iree_hal_descriptor_set_binding_t input,
+                         iree_hal_descriptor_set_binding_t output,
+                         uint32_t constant,
+                         iree_host_size_t count = kElementCount,
+                         uint32_t delay_us = 0) {
+    input.binding = 0;
+    output.binding = 1;
+    const iree_hal_descriptor_set_binding_t bindings[] = {input, output};
+    const uint32_t push_constants[] = {constant, delay_us};
+    IREE_ASSERT_OK(iree_hal_command_buffer_push_constants(
+        command_buffer, pipeline_layout_, /*offset=*/0, push_constants,
+        sizeof(push_constants)));
+    IREE_ASSERT_OK(iree_hal_command_buffer_push_descriptor_set(
+        command_buffer, pipeline_layout_, /*set=*/0, IREE_ARRAYSIZE(bindings),
+        bindings));
+    IREE_ASSERT_OK(iree_hal_command_buffer_dispatch(
+        command_buffer, executable_, /*entry_point=*/0, (uint32_t)count, 1,
+        1));
+  }
+
+  void RecordBarrier(iree_hal_command_buffer_t* command_buffer) {
+    IREE_ASSERT_OK(iree_hal_command_buffer_execution_barrier(
+        command_buffer, IREE_HAL_EXECUTION_STAGE_COMMAND_RETIRE,
+        IREE_HAL_EXECUTION_STAGE_COMMAND_ISSUE,
+        IREE_HAL_EXECUTION_BARRIER_FLAG_NONE, 0, NULL, 0, NULL));
+  }
+
+  // Submits |command_buffer| and waits for it to complete.
+  iree_status_t SubmitAndWait(iree_hal_command_buffer_t* command_buffer) {
+    iree_hal_semaphore_t* semaphore = NULL;
+    IREE_RETURN_IF_ERROR(iree_hal_semaphore_create(device_, 0ull, &semaphore));
+    uint64_t signal_value = 1ull;
+    iree_hal_semaphore_list_t signal_semaphores = {1, &semaphore,
+                                                   &signal_value};
+    iree_status_t status = iree_hal_device_queue_execute(
+        device_, IREE_HAL_QUEUE_AFFINITY_ANY, iree_hal_semaphore_list_empty(),
+        signal_semaphores, 1, &command_buffer);
+    if (iree_status_is_ok(status)) {
+      status = iree_hal_semaphore_wait(semaphore, signal_value,
+                                       iree_infinite_timeout());
+    }
+    if (iree_status_is_ok(status)) {
+      // Waits may complete on failure; the failure is in the payload.
+      uint64_t value = 0;
+      status = iree_hal_semaphore_query(semaphore, &value);
+    }
+    iree_hal_semaphore_release(semaphore);
+    return status;
+  }
+
+  static iree_hal_descriptor_set_binding_t SlotBinding(
+      uint32_t slot, iree_device_size_t offset = 0,
+      iree_device_size_t length = IREE_WHOLE_BUFFER) {
+    return {0, slot, NULL, offset, length};
+  }
+
+  static iree_hal_descriptor_set_binding_t BufferBinding(
+      iree_hal_buffer_t* buffer, iree_device_size_t offset = 0,
+      iree_device_size_t length = IREE_WHOLE_BUFFER) {
+    return {0, 0, buffer, offset, length};
+  }
+
+  // Binds |count| elements of |buffer| starting at element |first|.
+  static iree_hal_descriptor_set_binding_t ElementsBinding(
+      iree_hal_buffer_t* buffer, iree_host_size_t first,
+      iree_host_size_t count) {
+    return BufferBinding(buffer, first * sizeof(uint32_t),
+                         count * sizeof(uint32_t));
+  }
+
+  iree_hal_command_buffer_t* BeginOneShotCommandBuffer() {
+    iree_hal_command_buffer_t* command_buffer = NULL;
+    IREE_CHECK_OK(iree_hal_command_buffer_create(
+        device_, IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT,
+        IREE_HAL_COMMAND_CATEGORY_ANY, IREE_HAL_QUEUE_AFFINITY_ANY,
+        /*binding_capacity=*/0, &command_buffer));
+    IREE_CHECK_OK(iree_hal_command_buffer_begin(command_buffer));
+    return command_buffer;
+  }
+
+  // Ends, submits, and releases |command_buffer|.
+  void EndAndSubmit(iree_hal_command_buffer_t* command_buffer) {
+    IREE_ASSERT_OK(iree_hal_command_buffer_end(command_buffer));
+    IREE_ASSERT_OK(SubmitAndWait(command_buffer));
+    iree_hal_command_buffer_release(command_buffer);
+  }
+
+  iree_task_executor_t* executor_ = NULL;
+  iree_hal_executable_loader_t* loader_ = NULL;
+  iree_hal_allocator_t* device_allocator_ = NULL;
+  iree_hal_device_t* device_ = NULL;
+  iree_hal_descriptor_set_layout_t* descriptor_set_layout_ = NULL;
+  iree_hal_pipeline_layout_t* pipeline_layout_ = NULL;
+  iree_status_t loop_status_ = iree_ok_status();
+  iree_hal_executable_cache_t* executable_cache_ = NULL;
+  iree_hal_executable_t* executable_ = NULL;
+  std::vector<iree_hal_buffer_t*> buffers_;
+};
+
+//===----------------------------------------------------------------------===//
+// Nested command buffers
+//===----------------------------------------------------------------------===//
+
+// A nested command buffer recorded once against binding table slots is
+// executed twice with different binding tables.
+TEST_F(TaskCommandBufferTest, NestedWithTwoBindingTables) {
+  iree_hal_command_buffer_t* nested = NULL;
+  IREE_ASSERT_OK(iree_hal_command_buffer_create(
+      device_, IREE_HAL_COMMAND_BUFFER_MODE_NESTED,
+      IREE_HAL_COMMAND_CATEGORY_DISPATCH, IREE_HAL_QUEUE_AFFINITY_ANY,
+      /*binding_capacity=*/2, &nested));
+  IREE_ASSERT_OK(iree_hal_command_buffer_begin(nested));
+  RecordAddConstant(nested, SlotBinding(0), SlotBinding(1), 10);
+  IREE_ASSERT_OK(iree_hal_command_buffer_end(nested));
+
+  // The second execution writes to the second half of its output buffer only
+  // and reads the output of the first.
+  iree_hal_buffer_t* input = CreateBuffer(1);
+  iree_hal_buffer_t* output0 = CreateBuffer(0);
+  iree_hal_buffer_t* output1 = CreateBuffer(0);
+  const iree_device_size_t half_size = kElementCount / 2 * sizeof(uint32_t);
+  const iree_hal_buffer_binding_t bindings0[] = {
+      {input, 0, IREE_WHOLE_BUFFER},
+      {output0, 0, IREE_WHOLE_BUFFER},
+  };
+  const iree_hal_buffer_binding_t bindings1[] = {
+      {output0, 0, half_size},
+      {output1, half_size, half_size},
+  };
+
+  iree_hal_command_buffer_t* command_buffer = NULL;
+  IREE_ASSERT_OK(iree_hal_command_buffer_create(
+      device_, IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT,
+      IREE_HAL_COMMAND_CATEGORY_DISPATCH, IREE_HAL_QUEUE_AFFINITY_ANY,
+      /*binding_capacity=*/0, &command_buffer));
+  IREE_ASSERT_OK(iree_hal_command_buffer_begin(command_buffer));
+  IREE_ASSERT_OK(iree_hal_command_buffer_execute_commands(
+      command_buffer, nested, {IREE_ARRAYSIZE(bindings0), bindings0}));
+  RecordBarrier(command_buffer);
+  IREE_ASSERT_OK(iree_hal_command_buffer_execute_commands(
+      command_buffer, nested, {IREE_ARRAYSIZE(bindings1), bindings1}));
+  IREE_ASSERT_OK(iree_hal_command_buffer_end(command_buffer));
+  IREE_ASSERT_OK(SubmitAndWait(command_buffer));
+  iree_hal_command_buffer_release(command_buffer);
+  iree_hal_command_buffer_release(nested);
+
+  EXPECT_EQ(ReadBuffer(output0), std::vector<uint32_t>(kElementCount, 11));
+  std::vector<uint32_t> expected_output1(kElementCount, 0);
+  std::fill(expected_output1.begin() + kElementCount / 2,
+            expected_output1.end(), 21);
+  EXPECT_EQ(ReadBuffer(output1), expected_output1);
+}
+
+// A reusable command buffer executing a nested one can be submitted repeatedly
+// and sees the current contents of the binding table buffers each time.
+TEST_F(TaskCommandBufferTest, NestedInReusableCommandBuffer) {
+  iree_hal_command_buffer_t* nested = NULL;
+  IREE_ASSERT_OK(iree_hal_command_buffer_create(
+      device_, IREE_HAL_COMMAND_BUFFER_MODE_NESTED,
+      IREE_HAL_COMMAND_CATEGORY_DISPATCH, IREE_HAL_QUEUE_AFFINITY_ANY,
+      /*binding_capacity=*/2, &nested));
+  IREE_ASSERT_OK(iree_hal_command_buffer_begin(nested));
+  RecordAddConstant(nested, SlotBinding(0), SlotBinding(1), 5);
+  IREE_ASSERT_OK(iree_hal_command_buffer_end(nested));
+
+  iree_hal_buffer_t* input = CreateBuffer(1);
+  iree_hal_buffer_t* output = CreateBuffer(0);
+  const iree_hal_buffer_binding_t bindings[] = {
+      {input, 0, IREE_WHOLE_BUFFER},
+      {output, 0, IREE_WHOLE_BUFFER},
+  };
+  iree_hal_command_buffer_t* command_buffer = NULL;
+  IREE_ASSERT_OK(iree_hal_command_buffer_create(
+      device_, /*mode=*/0,
+      IREE_HAL_COMMAND_CATEGORY_DISPATCH, IREE_HAL_QUEUE_AFFINITY_ANY,
+      /*binding_capacity=*/0, &command_buffer));
+  IREE_ASSERT_OK(iree_hal_command_buffer_begin(command_buffer));
+  IREE_ASSERT_OK(iree_hal_command_buffer_execute_commands(
+      command_buffer, nested, {IREE_ARRAYSIZE(bindings), bindings}));
+  IREE_ASSERT_OK(iree_hal_command_buffer_end(command_buffer));
+  iree_hal_command_buffer_release(nested);
+
+  IREE_ASSERT_OK(SubmitAndWait(command_buffer));
+  EXPECT_EQ(ReadBuffer(output), std::vector<uint32_t>(kElementCount, 6));
+  uint32_t new_input = 100;
+  IREE_ASSERT_OK(iree_hal_buffer_map_fill(input, 0, IREE_WHOLE_BUFFER,
+                                          &new_input, sizeof(new_input)));
+  IREE_ASSERT_OK(SubmitAndWait(command_buffer));
+  EXPECT_EQ(ReadBuffer(output), std::vector<uint32_t>(kElementCount, 105));
+  iree_hal_command_buffer_release(command_buffer);
+}
+
+// One-shot nested command buffers are also templates that are cloned when
+// executed as they may be executed by multiple command buffers.
+TEST_F(TaskCommandBufferTest, OneShotNested) {
+  iree_hal_buffer_t* input = CreateBuffer(7);
+  iree_hal_buffer_t* direct_output = CreateBuffer(0);
+  iree_hal_buffer_t* slot_output = CreateBuffer(0);
+
+  iree_hal_command_buffer_t* nested = NULL;
+  IREE_ASSERT_OK(iree_hal_command_buffer_create(
+      device_,
+      IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT |
+          IREE_HAL_COMMAND_BUFFER_MODE_NESTED,
+      IREE_HAL_COMMAND_CATEGORY_DISPATCH, IREE_HAL_QUEUE_AFFINITY_ANY,
+      /*binding_capacity=*/1, &nested));
+  IREE_ASSERT_OK(iree_hal_command_buffer_begin(nested));
+  RecordAddConstant(nested, BufferBinding(input), BufferBinding(direct_output),
+                    1);
+  RecordBarrier(nested);
+  RecordAddConstant(nested, BufferBinding(direct_output), SlotBinding(0), 2);
+  IREE_ASSERT_OK(iree_hal_command_buffer_end(nested));
+
+  const iree_hal_buffer_binding_t bindings[] = {
+      {slot_output, 0, IREE_WHOLE_BUFFER},
+  };
+  iree_hal_command_buffer_t* command_buffer = NULL;
+  IREE_ASSERT_OK(iree_hal_command_buffer_create(
+      device_, IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT,
+      IREE_HAL_COMMAND_CATEGORY_DISPATCH, IREE_HAL_QUEUE_AFFINITY_ANY,
+      /*binding_capacity=*/0, &command_buffer));
+  IREE_ASSERT_OK(iree_hal_command_buffer_begin(command_buffer));
+  IREE_ASSERT_OK(iree_hal_command_buffer_execute_commands(
+      command_buffer, nested, {IREE_ARRAYSIZE(bindings), bindings}));
+  IREE_ASSERT_OK(iree_hal_command_buffer_end(command_buffer));
+  iree_hal_command_buffer_release(nested);
+  IREE_ASSERT_OK(SubmitAndWait(command_buffer));
+  iree_hal_command_buffer_release(command_buffer);
+
+  EXPECT_EQ(ReadBuffer(direct_output), std::vector<uint32_t>(kElementCount, 8));
+  EXPECT_EQ(ReadBuffer(slot_output), std::vector<uint32_t>(kElementCount, 10));
+}
+
+// Command buffers with bindings left unresolved can only be executed by other
+// command buffers with a binding table and are rejected when submitted. The
+// queue remains usable.
+TEST_F(TaskCommandBufferTest, SubmitUnresolvedFixupsFails) {
+  iree_hal_command_buffer_t* nested = NULL;
+  IREE_ASSERT_OK(iree_hal_command_buffer_create(
+      device_, IREE_HAL_COMMAND_BUFFER_MODE_NESTED,
+      IREE_HAL_COMMAND_CATEGORY_DISPATCH, IREE_HAL_QUEUE_AFFINITY_ANY,
+      /*binding_capacity=*/2, &nested));
+  IREE_ASSERT_OK(iree_hal_command_buffer_begin(nested));
+  RecordAddConstant(nested, SlotBinding(0), SlotBinding(1), 1);
+  IREE_ASSERT_OK(iree_hal_command_buffer_end(nested));
+  IREE_EXPECT_STATUS_IS(IREE_STATUS_FAILED_PRECONDITION,
+                        SubmitAndWait(nested));
+  iree_hal_command_buffer_release(nested);
+
+  iree_hal_buffer_t* input = CreateBuffer(1);
+  iree_hal_buffer_t* output = CreateBuffer(0);
+  iree_hal_command_buffer_t* command_buffer = NULL;
+  IREE_ASSERT_OK(iree_hal_command_buffer_create(
+      device_, IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT,
+      IREE_HAL_COMMAND_CATEGORY_DISPATCH, IREE_HAL_QUEUE_AFFINITY_ANY,
+      /*binding_capacity=*/0, &command_buffer));
+  IREE_ASSERT_OK(iree_hal_command_buffer_begin(command_buffer));
+  RecordAddConstant(command_buffer, BufferBinding(input), BufferBinding(output),
+                    1);
+  IREE_ASSERT_OK(iree_hal_command_buffer_end(command_buffer));
+  IREE_ASSERT_OK(SubmitAndWait(command_buffer));
+  iree_hal_command_buffer_release(command_buffer);
+  EXPECT_EQ(ReadBuffer(output), std::vector<uint32_t>(kElementCount, 2));
+}
+
+// Binding table slots that are out of range or empty fail execute_commands.
+TEST_F(TaskCommandBufferTest, ExecuteWithInvalidBindingTableFails) {
+  iree_hal_command_buffer_t* nested = NULL;
+  IREE_ASSERT_OK(iree_hal_command_buffer_create(
+      device_, IREE_HAL_COMMAND_BUFFER_MODE_NESTED,
+      IREE_HAL_COMMAND_CATEGORY_DISPATCH, IREE_HAL_QUEUE_AFFINITY_ANY,
+      /*binding_capacity=*/2, &nested));
+  IREE_ASSERT_OK(iree_hal_command_buffer_begin(nested));
+  RecordAddConstant(nested, SlotBinding(0), SlotBinding(1), 1);
+  IREE_ASSERT_OK(iree_hal_command_buffer_end(nested));
+
+  iree_hal_buffer_t* input = CreateBuffer(1);
+  const iree_hal_buffer_binding_t short_bindings[] = {
+      {input, 0, IREE_WHOLE_BUFFER},
+  };
+  const iree_hal_buffer_binding_t empty_bindings[] = {
+      {input, 0, IREE_WHOLE_BUFFER},
+      {NULL, 0, 0},
+  };
+  iree_hal_command_buffer_t* command_buffer = NULL;
+  IREE_ASSERT_OK(iree_hal_command_buffer_create(
+      device_, IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT,
+      IREE_HAL_COMMAND_CATEGORY_DISPATCH, IREE_HAL_QUEUE_AFFINITY_ANY,
+      /*binding_capacity=*/0, &command_buffer));
+  IREE_ASSERT_OK(iree_hal_command_buffer_begin(command_buffer));
+  IREE_EXPECT_STATUS_IS(
+      IREE_STATUS_OUT_OF_RANGE,
+      iree_hal_command_buffer_execute_commands(
+          command_buffer, nested,
+          {IREE_ARRAYSIZE(short_bindings), short_bindings}));
+  IREE_EXPECT_STATUS_IS(
+      IREE_STATUS_FAILED_PRECONDITION,
+      iree_hal_command_buffer_execute_commands(
+          command_buffer, nested,
+          {IREE_ARRAYSIZE(empty_bindings), empty_bindings}));
+  iree_hal_command_buffer_release(command_buffer);
+  iree_hal_command_buffer_release(nested);
+}
+
+//===----------------------------------------------------------------------===//
+// Dependency tracking
+//===----------------------------------------------------------------------===//
+// Tasks recorded after an execution barrier only wait for the tasks before it
+// with conflicting buffer accesses. The first dispatch of each test is delayed
+// so that a missing dependency on it shows up in the results.
+
+// Read-after-write of a partially overlapping subrange.
+TEST_F(TaskCommandBufferTest, ReadAfterWriteAcrossBarrier) {
+  iree_hal_buffer_t* input = CreateBuffer(1);
+  iree_hal_buffer_t* x = CreateBuffer(0);
+  iree_hal_buffer_t* y = CreateBuffer(0);
+  iree_hal_command_buffer_t* command_buffer = BeginOneShotCommandBuffer();
+  // x[16, 48) = 2
+  RecordAddConstant(command_buffer, ElementsBinding(input, 0, 32),
+                    ElementsBinding(x, 16, 32), 1, 32, kDelayUs);
+  RecordBarrier(command_buffer);
+  // y[0, 32) = x[32, 64) + 10
+  RecordAddConstant(command_buffer, ElementsBinding(x, 32, 32),
+                    ElementsBinding(y, 0, 32), 10, 32);
+  EndAndSubmit(command_buffer);
+  EXPECT_EQ(ReadBuffer(x), MakeContents({{16, 0}, {32, 2}, {16, 0}}));
+  EXPECT_EQ(ReadBuffer(y), MakeContents({{16, 12}, {16, 10}, {32, 0}}));
+}
+
+// Write-after-read of a partially overlapping subrange.
+TEST_F(TaskCommandBufferTest, WriteAfterReadAcrossBarrier) {
+  iree_hal_buffer_t* x = CreateBuffer(1);
+  iree_hal_buffer_t* y = CreateBuffer(0);
+  iree_hal_buffer_t* z = CreateBuffer(5);
+  iree_hal_command_buffer_t* command_buffer = BeginOneShotCommandBuffer();
+  // y[0, 48) = x[0, 48) + 1
+  RecordAddConstant(command_buffer, ElementsBinding(x, 0, 48),
+                    ElementsBinding(y, 0, 48), 1, 48, kDelayUs);
+  RecordBarrier(command_buffer);
+  // x[32, 64) = z[0, 32) + 1
+  RecordAddConstant(command_buffer, ElementsBinding(z, 0, 32),
+                    ElementsBinding(x, 32, 32), 1, 32);
+  EndAndSubmit(command_buffer);
+  EXPECT_EQ(ReadBuffer(x), MakeContents({{32, 1}, {32, 6}}));
+  EXPECT_EQ(ReadBuffer(y), MakeContents({{48, 2}, {16, 0}}));
+}
+
+// Write-after-write of a partially overlapping subrange.
+TEST_F(TaskCommandBufferTest, WriteAfterWriteAcrossBarrier) {
+  iree_hal_buffer_t* input = CreateBuffer(0);
+  iree_hal_buffer_t* x = CreateBuffer(0);
+  iree_hal_command_buffer_t* command_buffer = BeginOneShotCommandBuffer();
+  // x[0, 48) = 1
+  RecordAddConstant(command_buffer, ElementsBinding(input, 0, 48),
+                    ElementsBinding(x, 0, 48), 1, 48, kDelayUs);
+  RecordBarrier(command_buffer);
+  // x[16, 64) = 2
+  RecordAddConstant(command_buffer, ElementsBinding(input, 0, 48),
+                    ElementsBinding(x, 16, 48), 2, 48);
+  EndAndSubmit(command_buffer);
+  EXPECT_EQ(ReadBuffer(x), MakeContents({{16, 1}, {48, 2}}));
+}
+
+// Dispatches on disjoint ranges across a barrier are independent, including
+// those on disjoint subranges of the same buffer. Each still completes before
+// the command buffer does.
+TEST_F(TaskCommandBufferTest, IndependentAcrossBarrier) {
+  iree_hal_buffer_t* input = CreateBuffer(1);
+  iree_hal_buffer_t* x = CreateBuffer(0);
+  iree_hal_buffer_t* y = CreateBuffer(0);
+  iree_hal_command_buffer_t* command_buffer = BeginOneShotCommandBuffer();
+  RecordAddConstant(command_buffer, ElementsBinding(input, 0, 32),
+                    ElementsBinding(x, 0, 32), 1, 32, kDelayUs);
+  RecordBarrier(command_buffer);
+  RecordAddConstant(command_buffer, ElementsBinding(input, 0, 32),
+                    ElementsBinding(x, 32, 32), 2, 32, kDelayUs);
+  RecordBarrier(command_buffer);
+  RecordAddConstant(command_buffer, BufferBinding(input), BufferBinding(y), 3,
+                    kElementCount, kDelayUs);
+  EndAndSubmit(command_buffer);
+  EXPECT_EQ(ReadBuffer(x), MakeContents({{32, 2}, {32, 3}}));
+  EXPECT_EQ(ReadBuffer(y), MakeContents({{kElementCount, 4}}));
+}
+
+// A write of a whole range hides earlier accesses of the range from the tasks
+// recorded after it, which are still ordered after those through the write.
+TEST_F(TaskCommandBufferTest, WholeRangeWriteSupersedesAccesses) {
+  iree_hal_buffer_t* input = CreateBuffer(1);
+  iree_hal_buffer_t* x = CreateBuffer(0);
+  iree_hal_buffer_t* y = CreateBuffer(0);
+  iree_hal_buffer_t* z = CreateBuffer(0);
+  iree_hal_command_buffer_t* command_buffer = BeginOneShotCommandBuffer();
+  // x[0, 32) = 2
+  RecordAddConstant(command_buffer, BufferBinding(input),
+                    ElementsBinding(x, 0, 32), 1, 32, kDelayUs);
+  RecordBarrier(command_buffer);
+  // y = x + 1, reading x[0, 32) after the write above.
+  RecordAddConstant(command_buffer, BufferBinding(x), BufferBinding(y), 1,
+                    kElementCount, kDelayUs);
+  RecordBarrier(command_buffer);
+  // x = input + 10, superseding both prior accesses of x.
+  RecordAddConstant(command_buffer, BufferBinding(input), BufferBinding(x),
+                    10);
+  RecordBarrier(command_buffer);
+  // z = x + 100
+  RecordAddConstant(command_buffer, BufferBinding(x), BufferBinding(z), 100);
+  EndAndSubmit(command_buffer);
+  EXPECT_EQ(ReadBuffer(x), MakeContents({{kElementCount, 11}}));
+  EXPECT_EQ(ReadBuffer(y), MakeContents({{32, 3}, {32, 1}}));
+  EXPECT_EQ(ReadBuffer(z), MakeContents({{kElementCount, 111}}));
+}
+
+// Tracking too many accesses at a barrier falls back to a global barrier and
+// dependencies are tracked again after it.
+TEST_F(TaskCommandBufferTest, ManyAccessesFallBackToGlobalBarrier) {
+  // Each dispatch accesses 2 ranges: enough dispatches to track more than
+  // IREE_HAL_TASK_COMMAND_BUFFER_MAX_TRACKED_ACCESSES (512) at the barrier.
+  constexpr iree_host_size_t kDispatchCount = 300;
+  iree_hal_buffer_t* input = CreateBuffer(1);
+  iree_hal_buffer_t* x = CreateBuffer(0, kDispatchCount);
+  iree_hal_buffer_t* y = CreateBuffer(0, kDispatchCount);
+  iree_hal_buffer_t* z = CreateBuffer(0, kDispatchCount);
+  iree_hal_command_buffer_t* command_buffer = BeginOneShotCommandBuffer();
+  for (iree_host_size_t i = 0; i < kDispatchCount; ++i) {
+    // x[i] = i + 1
+    RecordAddConstant(command_buffer, ElementsBinding(input, 0, 1),
+                      ElementsBinding(x, i, 1), (uint32_t)i, 1,
+                      i == 0 ? kDelayUs * 10 : 0);
+  }
+  RecordBarrier(command_buffer);
+  RecordAddConstant(command_buffer, BufferBinding(x), BufferBinding(y), 10,
+                    kDispatchCount, kDelayUs);
+  RecordBarrier(command_buffer);
+  RecordAddConstant(command_buffer, BufferBinding(y), BufferBinding(z), 100,
+                    kDispatchCount);
+  EndAndSubmit(command_buffer);
+  std::vector<uint32_t> x_contents = ReadBuffer(x);
+  std::vector<uint32_t> z_contents = ReadBuffer(z);
+  for (iree_host_size_t i = 0; i < kDispatchCount; ++i) {
+    EXPECT_EQ(x_contents[i], i + 1);
+    EXPECT_EQ(z_contents[i], i + 111);
+  }
+}
+
+// A task that neither depends on another nor has dependents is both a root and
+// a leaf of the DAG; the command buffer must still complete after it when other
+// tasks do have dependencies. The isolated tasks are single slow workgroups
+// that leave workers free for the others to complete first.
+TEST_F(TaskCommandBufferTest, IsolatedTaskWithDependentTasks) {
+  iree_hal_buffer_t* input = CreateBuffer(1);
+  iree_hal_buffer_t* x = CreateBuffer(0);
+  iree_hal_buffer_t* y = CreateBuffer(0);
+  iree_hal_buffer_t* isolated_root = CreateBuffer(0);
+  iree_hal_buffer_t* isolated_leaf = CreateBuffer(0);
+  iree_hal_command_buffer_t* command_buffer = BeginOneShotCommandBuffer();
+  RecordAddConstant(command_buffer, BufferBinding(input),
+                    BufferBinding(isolated_root), 5, 1, kDelayUs * 50);
+  RecordAddConstant(command_buffer, BufferBinding(input), BufferBinding(x), 1);
+  RecordBarrier(command_buffer);
+  RecordAddConstant(command_buffer, BufferBinding(x), BufferBinding(y), 1);
+  RecordAddConstant(command_buffer, BufferBinding(input),
+                    BufferBinding(isolated_leaf), 7, 1, kDelayUs * 50);
+  EndAndSubmit(command_buffer);
+  EXPECT_EQ(ReadBuffer(y), MakeContents({{kElementCount, 3}}));
+  EXPECT_EQ(ReadBuffer(isolated_root),
+            MakeContents({{1, 6}, {kElementCount - 1, 0}}));
+  EXPECT_EQ(ReadBuffer(isolated_leaf),
+            MakeContents({{1, 8}, {kElementCount - 1, 0}}));
+}
+
+// Nested command buffers executed in between tracked tasks are ordered after
+// all prior tasks and before all later ones.
+TEST_F(TaskCommandBufferTest, ExecuteCommandsWithinDAG) {
+  iree_hal_command_buffer_t* nested = NULL;
+  IREE_ASSERT_OK(iree_hal_command_buffer_create(
+      device_, IREE_HAL_COMMAND_BUFFER_MODE_NESTED,
+      IREE_HAL_COMMAND_CATEGORY_DISPATCH, IREE_HAL_QUEUE_AFFINITY_ANY,
+      /*binding_capacity=*/2, &nested));
+  IREE_ASSERT_OK(iree_hal_command_buffer_begin(nested));
+  RecordAddConstant(nested, SlotBinding(0), SlotBinding(1), 10, kElementCount,
+                    kDelayUs);
+  IREE_ASSERT_OK(iree_hal_command_buffer_end(nested));
+
+  iree_hal_buffer_t* input = CreateBuffer(1);
+  iree_hal_buffer_t* x = CreateBuffer(0);
+  iree_hal_buffer_t* y = CreateBuffer(0);
+  iree_hal_buffer_t* z = CreateBuffer(0);
+  const iree_hal_buffer_binding_t bindings[] = {
+      {x, 0, IREE_WHOLE_BUFFER},
+      {y, 0, IREE_WHOLE_BUFFER},
+  };
+  iree_hal_command_buffer_t* command_buffer = BeginOneShotCommandBuffer();
+  RecordAddConstant(command_buffer, BufferBinding(input), BufferBinding(x), 1,
+                    kElementCount, kDelayUs);
+  RecordBarrier(command_buffer);
+  IREE_ASSERT_OK(iree_hal_command_buffer_execute_commands(
+      command_buffer, nested, {IREE_ARRAYSIZE(bindings), bindings}));
+  RecordBarrier(command_buffer);
+  RecordAddConstant(command_buffer, BufferBinding(y), BufferBinding(z), 100);
+  EndAndSubmit(command_buffer);
+  iree_hal_command_buffer_release(nested);
+  EXPECT_EQ(ReadBuffer(z), MakeContents({{kElementCount, 112}}));
+}
+
+}  // namespace
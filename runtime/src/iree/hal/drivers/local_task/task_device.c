@@ -12,6 +12,8 @@
 
 #include "iree/base/internal/arena.h"
 #include "iree/base/internal/cpu.h"
+#include "iree/base/internal/math.h"
+#include "iree/hal/drivers/local_task/task_buffer_pool.h"
 #include "iree/hal/drivers/local_task/task_command_buffer.h"
 #include "iree/hal/drivers/local_task/task_event.h"
 #include "iree/hal/drivers/local_task/task_queue.h"
@@ -19,6 +21,8 @@
 #include "iree/hal/local/executable_environment.h"
 #include "iree/hal/local/local_executable_cache.h"
 #include "iree/hal/local/local_pipeline_layout.h"
+#include "iree/hal/local/profiling.h"
+#include "iree/hal/utils/fd_file.h"
 #include "iree/hal/utils/file_transfer.h"
 #include "iree/hal/utils/memory_file.h"
 
@@ -26,6 +30,9 @@ typedef struct iree_hal_task_device_t {
   iree_hal_resource_t resource;
   iree_string_view_t identifier;
 
+  // Directory for persistent executable caches; may be empty.
+  iree_string_view_t executable_cache_dir;
+
   // Block pool used for small allocations like tasks and submissions.
   iree_arena_block_pool_t small_block_pool;
 
@@ -39,9 +46,19 @@ typedef struct iree_hal_task_device_t {
   iree_allocator_t host_allocator;
   iree_hal_allocator_t* device_allocator;
 
+  // Stream-ordered pool used for queue-ordered allocations.
+  iree_hal_task_buffer_pool_t* buffer_pool;
+
   // Optional provider used for creating/configuring collective channels.
   iree_hal_channel_provider_t* channel_provider;
 
+  // Active profiling session begun on this device, if any.
+  iree_hal_local_profiling_session_t* profiling_session;
+
+  // True if the queue executors are on differing NUMA nodes. When false all
+  // queues are equally local and selection never queries the caller's node.
+  bool queues_span_nodes;
+
   iree_host_size_t queue_count;
   iree_hal_task_queue_t queues[];
 } iree_hal_task_device_t;
@@ -58,6 +75,8 @@ void iree_hal_task_device_params_initialize(
     iree_hal_task_device_params_t* out_params) {
   out_params->arena_block_size = 32 * 1024;
   out_params->queue_scope_flags = IREE_TASK_SCOPE_FLAG_NONE;
+  out_params->executable_cache_dir = iree_string_view_empty();
+  out_params->buffer_pool_max_free_size = 256 * 1024 * 1024;
 }
 
 static iree_status_t iree_hal_task_device_check_params(
@@ -102,7 +121,8 @@ iree_status_t iree_hal_task_device_create(
   iree_host_size_t struct_size = sizeof(*device) +
                                  queue_count * sizeof(*device->queues) +
                                  loader_count * sizeof(*device->loaders);
-  iree_host_size_t total_size = struct_size + identifier.size;
+  iree_host_size_t total_size =
+      struct_size + identifier.size + params->executable_cache_dir.size;
   iree_status_t status =
       iree_allocator_malloc(host_allocator, total_size, (void**)&device);
   if (iree_status_is_ok(status)) {
@@ -111,6 +131,9 @@ iree_status_t iree_hal_task_device_create(
                                  &device->resource);
     iree_string_view_append_to_buffer(identifier, &device->identifier,
                                       (char*)device + struct_size);
+    iree_string_view_append_to_buffer(
+        params->executable_cache_dir, &device->executable_cache_dir,
+        (char*)device + struct_size + identifier.size);
     device->host_allocator = host_allocator;
     device->device_allocator = device_allocator;
     iree_hal_allocator_retain(device_allocator);
@@ -120,6 +143,12 @@ iree_status_t iree_hal_task_device_create(
     iree_arena_block_pool_initialize(params->arena_block_size, host_allocator,
                                      &device->large_block_pool);
 
+    status = iree_hal_task_buffer_pool_create(
+        params->buffer_pool_max_free_size, host_allocator,
+        &device->buffer_pool);
+  }
+
+  if (iree_status_is_ok(status)) {
     device->loader_count = loader_count;
     device->loaders =
         (iree_hal_executable_loader_t**)((uint8_t*)device + sizeof(*device) +
@@ -135,6 +164,10 @@ iree_status_t iree_hal_task_device_create(
       iree_hal_task_queue_initialize(
           device->identifier, params->queue_scope_flags, queue_executors[i],
           &device->small_block_pool, &device->queues[i]);
+      if (iree_task_executor_node_mask(queue_executors[i]) !=
+          iree_task_executor_node_mask(queue_executors[0])) {
+        device->queues_span_nodes = true;
+      }
     }
   }
 
@@ -160,6 +193,9 @@ static void iree_hal_task_device_destroy(iree_hal_device_t* base_device) {
     iree_hal_executable_loader_release(device->loaders[i]);
   }
 
+  iree_hal_task_buffer_pool_release(device->buffer_pool);
+  iree_status_ignore(
+      iree_hal_local_profiling_session_end(device->profiling_session));
   iree_hal_allocator_release(device->device_allocator);
   iree_hal_channel_provider_release(device->channel_provider);
 
@@ -213,6 +249,7 @@ static iree_status_t iree_hal_task_device_trim(iree_hal_device_t* base_device) {
   for (iree_host_size_t i = 0; i < device->queue_count; ++i) {
     iree_hal_task_queue_trim(&device->queues[i]);
   }
+  iree_hal_task_buffer_pool_trim(device->buffer_pool);
   IREE_RETURN_IF_ERROR(iree_hal_allocator_trim(device->device_allocator));
 
   iree_arena_block_pool_trim(&device->small_block_pool);
@@ -265,7 +302,77 @@ static iree_status_t iree_hal_task_device_query_i64(
       (int)category.size, category.data, (int)key.size, key.data);
 }
 
+// NOTE: threading support is optional.
+#if IREE_SYNCHRONIZATION_DISABLE_UNSAFE
+#define iree_hal_task_thread_local
+#elif defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201102L) && \
+    !__STDC_NO_THREADS__
+#define iree_hal_task_thread_local _Thread_local
+#elif defined(IREE_COMPILER_MSVC)
+#define iree_hal_task_thread_local __declspec(thread)
+#else
+#define iree_hal_task_thread_local
+#endif  // IREE_SYNCHRONIZATION_DISABLE_UNSAFE
+
+// Number of submissions from a thread between requerying its NUMA node.
+// The query is a syscall and threads rarely migrate across nodes.
+#define IREE_HAL_TASK_DEVICE_NODE_REQUERY_INTERVAL 64
+
+// Returns the NUMA node of the calling thread as of its last requery.
+static iree_task_topology_node_id_t iree_hal_task_device_current_node(void) {
+  static iree_hal_task_thread_local iree_task_topology_node_id_t node_id = 0;
+  static iree_hal_task_thread_local uint32_t queries_until_refresh = 0;
+  if (queries_until_refresh == 0) {
+    node_id = iree_task_topology_query_current_node();
+    queries_until_refresh = IREE_HAL_TASK_DEVICE_NODE_REQUERY_INTERVAL;
+  }
+  --queries_until_refresh;
+  return node_id;
+}
+
 // Returns the queue index to submit work to based on the |queue_affinity|.
+// Bit N of the affinity maps to queue N (and its executor). When multiple
+// queues are allowed we prefer the one whose executor runs on NUMA |node_id|
+// so that submissions stay on the node that (likely) produced their inputs.
+// Affinities with no bits in range wrap around.
+static iree_host_size_t iree_hal_task_device_select_queue_on_node(
+    iree_hal_task_device_t* device, iree_hal_queue_affinity_t queue_affinity,
+    iree_task_topology_node_id_t node_id) {
+  if (device->queue_count == 1) return 0;
+  const iree_hal_queue_affinity_t queue_mask =
+      device->queue_count >= 64 ? IREE_HAL_QUEUE_AFFINITY_ANY
+                                : ((1ull << device->queue_count) - 1);
+  const iree_hal_queue_affinity_t valid_affinity = queue_affinity & queue_mask;
+  if (!valid_affinity) return queue_affinity % device->queue_count;
+
+  // Multiple queues allowed: pick the first one local to |node_id|.
+  if (device->queues_span_nodes && node_id < 64 &&
+      iree_math_count_ones_u64(valid_affinity) > 1) {
+    const uint64_t node_bit = 1ull << node_id;
+    iree_hal_queue_affinity_t remaining_affinity = valid_affinity;
+    while (remaining_affinity) {
+      const int queue_index =
+          iree_math_count_trailing_zeros_u64(remaining_affinity);
+      remaining_affinity &= remaining_affinity - 1;
+      if (iree_task_executor_node_mask(device->queues[queue_index].executor) &
+          node_bit) {
+        return queue_index;
+      }
+    }
+  }
+  return iree_math_count_trailing_zeros_u64(valid_affinity);
+}
+
+iree_host_size_t iree_hal_task_device_select_queue_for_node(
+    iree_hal_device_t* base_device, iree_hal_queue_affinity_t queue_affinity,
+    iree_task_topology_node_id_t node_id) {
+  iree_hal_task_device_t* device = iree_hal_task_device_cast(base_device);
+  return iree_hal_task_device_select_queue_on_node(device, queue_affinity,
+                                                   node_id);
+}
+
+// Returns the queue index to submit work to from the calling thread.
+// The node is only queried when it could change the selection.
 //
 // If we wanted to have dedicated transfer queues we'd fork off based on
 // command_categories. For now all queues are general purpose.
@@ -273,10 +380,10 @@ static iree_host_size_t iree_hal_task_device_select_queue(
     iree_hal_task_device_t* device,
     iree_hal_command_category_t command_categories,
     iree_hal_queue_affinity_t queue_affinity) {
-  // TODO(benvanik): evaluate if we want to obscure this mapping a bit so that
-  // affinity really means "equivalent affinities map to equivalent queues" and
-  // not a specific queue index.
-  return queue_affinity % device->queue_count;
+  const iree_task_topology_node_id_t node_id =
+      device->queues_span_nodes ? iree_hal_task_device_current_node() : 0;
+  return iree_hal_task_device_select_queue_on_node(device, queue_affinity,
+                                                   node_id);
 }
 
 static iree_status_t iree_hal_task_device_create_channel(
@@ -330,24 +437,31 @@ static iree_status_t iree_hal_task_device_create_executable_cache(
         iree_task_executor_worker_count(device->queues[i].executor);
   }
 
-  return iree_hal_local_executable_cache_create(
+  return iree_hal_local_executable_cache_create_persistent(
       identifier, total_worker_count, device->loader_count, device->loaders,
-      iree_hal_device_host_allocator(base_device), out_executable_cache);
+      device->executable_cache_dir, iree_hal_device_host_allocator(base_device),
+      out_executable_cache);
 }
 
 static iree_status_t iree_hal_task_device_import_file(
     iree_hal_device_t* base_device, iree_hal_queue_affinity_t queue_affinity,
     iree_hal_memory_access_t access, iree_io_file_handle_t* handle,
     iree_hal_external_file_flags_t flags, iree_hal_file_t** out_file) {
-  if (iree_io_file_handle_type(handle) !=
-      IREE_IO_FILE_HANDLE_TYPE_HOST_ALLOCATION) {
-    return iree_make_status(
-        IREE_STATUS_UNAVAILABLE,
-        "implementation does not support the external file type");
+  switch (iree_io_file_handle_type(handle)) {
+    case IREE_IO_FILE_HANDLE_TYPE_HOST_ALLOCATION:
+      return iree_hal_memory_file_wrap(
+          queue_affinity, access, handle,
+          iree_hal_device_allocator(base_device),
+          iree_hal_device_host_allocator(base_device), out_file);
+    case IREE_IO_FILE_HANDLE_TYPE_FD:
+      return iree_hal_fd_file_from_handle(
+          access, handle, iree_hal_device_host_allocator(base_device),
+          out_file);
+    default:
+      return iree_make_status(
+          IREE_STATUS_UNAVAILABLE,
+          "implementation does not support the external file type");
   }
-  return iree_hal_memory_file_wrap(
-      queue_affinity, access, handle, iree_hal_device_allocator(base_device),
-      iree_hal_device_host_allocator(base_device), out_file);
 }
 
 static iree_status_t iree_hal_task_device_create_pipeline_layout(
@@ -391,14 +505,21 @@ static iree_status_t iree_hal_task_device_queue_alloca(
     iree_hal_allocator_pool_t pool, iree_hal_buffer_params_t params,
     iree_device_size_t allocation_size,
     iree_hal_buffer_t** IREE_RESTRICT out_buffer) {
-  // TODO(benvanik): queue-ordered allocations.
-  IREE_RETURN_IF_ERROR(iree_hal_semaphore_list_wait(wait_semaphore_list,
-                                                    iree_infinite_timeout()));
-  IREE_RETURN_IF_ERROR(
-      iree_hal_allocator_allocate_buffer(iree_hal_device_allocator(base_device),
-                                         params, allocation_size, out_buffer));
-  IREE_RETURN_IF_ERROR(iree_hal_semaphore_list_signal(signal_semaphore_list));
-  return iree_ok_status();
+  iree_hal_task_device_t* device = iree_hal_task_device_cast(base_device);
+
+  // Host memory can be reserved immediately and the pool only hands out
+  // storage whose previous users are ordered before the wait list, so the
+  // allocation itself only needs to be ordered on the queue to signal.
+  IREE_RETURN_IF_ERROR(iree_hal_task_buffer_pool_alloca(
+      device->buffer_pool, device->device_allocator, wait_semaphore_list,
+      params, allocation_size, out_buffer));
+  iree_status_t status = iree_hal_device_queue_barrier(
+      base_device, queue_affinity, wait_semaphore_list, signal_semaphore_list);
+  if (!iree_status_is_ok(status)) {
+    iree_hal_buffer_release(*out_buffer);
+    *out_buffer = NULL;
+  }
+  return status;
 }
 
 static iree_status_t iree_hal_task_device_queue_dealloca(
@@ -406,10 +527,14 @@ static iree_status_t iree_hal_task_device_queue_dealloca(
     const iree_hal_semaphore_list_t wait_semaphore_list,
     const iree_hal_semaphore_list_t signal_semaphore_list,
     iree_hal_buffer_t* buffer) {
-  // TODO(benvanik): queue-ordered allocations.
+  iree_hal_task_device_t* device = iree_hal_task_device_cast(base_device);
+
+  // The storage is handed to new allocations once the signal list is reached
+  // or when they wait on it themselves.
   IREE_RETURN_IF_ERROR(iree_hal_device_queue_barrier(
       base_device, queue_affinity, wait_semaphore_list, signal_semaphore_list));
-  return iree_ok_status();
+  return iree_hal_task_buffer_pool_dealloca(device->buffer_pool, buffer,
+                                            signal_semaphore_list);
 }
 
 static iree_status_t iree_hal_task_device_queue_read(
@@ -492,27 +617,31 @@ static iree_status_t iree_hal_task_device_wait_semaphores(
 static iree_status_t iree_hal_task_device_profiling_begin(
     iree_hal_device_t* base_device,
     const iree_hal_device_profiling_options_t* options) {
-  // Unimplemented (and that's ok).
-  // We could hook in to vendor APIs (Intel/ARM/etc) or generic perf infra:
-  // https://man7.org/linux/man-pages/man2/perf_event_open.2.html
-  // Capturing things like:
-  //   PERF_COUNT_HW_CPU_CYCLES / PERF_COUNT_HW_INSTRUCTIONS
-  //   PERF_COUNT_HW_CACHE_REFERENCES / PERF_COUNT_HW_CACHE_MISSES
-  //   etc
-  // TODO(benvanik): shared iree/hal/local/profiling implementation of this.
-  return iree_ok_status();
+  iree_hal_task_device_t* device = iree_hal_task_device_cast(base_device);
+  if (device->profiling_session) {
+    return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                            "profiling already begun on this device");
+  }
+  // Dispatch counters are captured around each executable call with
+  // perf_event_open; see iree/hal/local/profiling.h. Other modes are
+  // unimplemented (and that's ok).
+  return iree_hal_local_profiling_session_begin(
+      options, device->host_allocator, &device->profiling_session);
 }
 
 static iree_status_t iree_hal_task_device_profiling_flush(
     iree_hal_device_t* base_device) {
-  // Unimplemented (and that's ok).
-  return iree_ok_status();
+  iree_hal_task_device_t* device = iree_hal_task_device_cast(base_device);
+  return iree_hal_local_profiling_session_flush(device->profiling_session);
 }
 
 static iree_status_t iree_hal_task_device_profiling_end(
     iree_hal_device_t* base_device) {
-  // Unimplemented (and that's ok).
-  return iree_ok_status();
+  iree_hal_task_device_t* device = iree_hal_task_device_cast(base_device);
+  iree_status_t status =
+      iree_hal_local_profiling_session_end(device->profiling_session);
+  device->profiling_session = NULL;
+  return status;
 }
 
 static const iree_hal_device_vtable_t iree_hal_task_device_vtable = {
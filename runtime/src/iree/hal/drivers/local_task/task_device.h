@@ -25,6 +25,14 @@ typedef struct iree_hal_task_device_params_t {
   iree_host_size_t arena_block_size;
   // Default flags for the iree_task_scope_t used for each queue.
   iree_task_scope_flags_t queue_scope_flags;
+  // Existing directory used to persist prepared executables across processes
+  // or empty to disable persistence. Only executables prepared with
+  // IREE_HAL_EXECUTABLE_CACHING_MODE_ALLOW_PERSISTENT_CACHING are persisted.
+  iree_string_view_t executable_cache_dir;
+  // Maximum total size of the storage kept for reuse by queue-ordered
+  // allocations after it has been deallocated. Higher values avoid
+  // reallocating storage for programs with large transient working sets.
+  iree_device_size_t buffer_pool_max_free_size;
 } iree_hal_task_device_params_t;
 
 // Initializes |out_params| to default values.
@@ -38,6 +46,9 @@ void iree_hal_task_device_params_initialize(
 // programs with one entry in |queue_executors| providing the scheduling scope.
 // Multiple queues may share the same executor. When multiple executors are used
 // queries for device capabilities will always report from the first.
+// Queue affinity bit N routes submissions to queue N; affinities allowing
+// multiple queues prefer the queue whose executor is on the NUMA node of the
+// submitting thread.
 //
 // |loaders| is the set of executable loaders that are available for loading in
 // the device context. The loaders are retained for the lifetime of the device.
@@ -48,6 +59,13 @@ iree_status_t iree_hal_task_device_create(
     iree_hal_allocator_t* device_allocator, iree_allocator_t host_allocator,
     iree_hal_device_t** out_device);
 
+// Returns the index of the queue that work with |queue_affinity| is routed to
+// when submitted from a thread running on NUMA node |node_id|.
+// Submissions use the node of the calling thread; this is exposed for testing.
+iree_host_size_t iree_hal_task_device_select_queue_for_node(
+    iree_hal_device_t* device, iree_hal_queue_affinity_t queue_affinity,
+    iree_task_topology_node_id_t node_id);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
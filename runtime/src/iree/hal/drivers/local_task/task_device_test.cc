@@ -0,0 +1,122 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/drivers/local_task/task_device.h"
+
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/task/api.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace {
+
+class TaskDeviceQueueSelectionTest : public ::testing::Test {
+ protected:
+  void TearDown() override {
+    iree_hal_device_release(device_);
+    for (iree_task_executor_t* executor : executors_) {
+      iree_task_executor_release(executor);
+    }
+  }
+
+  // Creates a single-worker executor that claims to run on NUMA |node_id|.
+  iree_task_executor_t* CreateExecutorOnNode(
+      iree_task_topology_node_id_t node_id) {
+    iree_task_topology_t topology;
+    iree_task_topology_initialize_from_group_count(/*group_count=*/1,
+                                                   &topology);
+    topology.groups[0].node_id = node_id;
+    iree_task_executor_options_t options;
+    iree_task_executor_options_initialize(&options);
+    iree_task_executor_t* executor = NULL;
+    iree_status_t status = iree_task_executor_create(
+        options, &topology, iree_allocator_system(), &executor);
+    iree_task_topology_deinitialize(&topology);
+    IREE_CHECK_OK(status);
+    executors_.push_back(executor);
+    return executor;
+  }
+
+  // Creates the device with one queue per entry in |queue_executors|.
+  void CreateDevice(std::vector<iree_task_executor_t*> queue_executors) {
+    iree_hal_task_device_params_t params;
+    iree_hal_task_device_params_initialize(&params);
+    iree_hal_allocator_t* device_allocator = NULL;
+    IREE_ASSERT_OK(iree_hal_allocator_create_heap(
+        IREE_SV("heap"), iree_allocator_system(), iree_allocator_system(),
+        &device_allocator));
+    IREE_ASSERT_OK(iree_hal_task_device_create(
+        IREE_SV("local-task"), &params, queue_executors.size(),
+        queue_executors.data(), /*loader_count=*/0, /*loaders=*/NULL,
+        device_allocator, iree_allocator_system(), &device_));
+    iree_hal_allocator_release(device_allocator);
+  }
+
+  iree_host_size_t Select(iree_hal_queue_affinity_t queue_affinity,
+                          iree_task_topology_node_id_t node_id) {
+    return iree_hal_task_device_select_queue_for_node(device_, queue_affinity,
+                                                      node_id);
+  }
+
+  std::vector<iree_task_executor_t*> executors_;
+  iree_hal_device_t* device_ = NULL;
+};
+
+TEST_F(TaskDeviceQueueSelectionTest, SingleQueue) {
+  CreateDevice({CreateExecutorOnNode(1)});
+  EXPECT_EQ(0, Select(IREE_HAL_QUEUE_AFFINITY_ANY, 0));
+  EXPECT_EQ(0, Select(IREE_HAL_QUEUE_AFFINITY_ANY, 1));
+  EXPECT_EQ(0, Select(1ull << 5, 0));
+}
+
+TEST_F(TaskDeviceQueueSelectionTest, PrefersQueueOnCallerNode) {
+  CreateDevice({CreateExecutorOnNode(0), CreateExecutorOnNode(1)});
+  EXPECT_EQ(0, Select(IREE_HAL_QUEUE_AFFINITY_ANY, 0));
+  EXPECT_EQ(1, Select(IREE_HAL_QUEUE_AFFINITY_ANY, 1));
+  EXPECT_EQ(0, Select(0b11, 0));
+  EXPECT_EQ(1, Select(0b11, 1));
+}
+
+TEST_F(TaskDeviceQueueSelectionTest, ExplicitAffinityOverridesNode) {
+  CreateDevice({CreateExecutorOnNode(0), CreateExecutorOnNode(1)});
+  // A single allowed queue is always used even when remote to the caller.
+  EXPECT_EQ(0, Select(0b01, 1));
+  EXPECT_EQ(1, Select(0b10, 0));
+}
+
+TEST_F(TaskDeviceQueueSelectionTest, NoLocalQueueUsesFirstAllowed) {
+  CreateDevice({CreateExecutorOnNode(0), CreateExecutorOnNode(1),
+                CreateExecutorOnNode(1)});
+  // Node 2 has no queue so the first allowed queue is used.
+  EXPECT_EQ(0, Select(IREE_HAL_QUEUE_AFFINITY_ANY, 2));
+  EXPECT_EQ(1, Select(0b110, 2));
+  // The first local queue among those allowed is used.
+  EXPECT_EQ(2, Select(0b101, 1));
+  EXPECT_EQ(1, Select(0b111, 1));
+  // Nodes beyond the node mask range cannot be local.
+  EXPECT_EQ(0, Select(IREE_HAL_QUEUE_AFFINITY_ANY, 64));
+}
+
+TEST_F(TaskDeviceQueueSelectionTest, SharedNodeIgnoresCaller) {
+  // All queues are on the same node so the caller's node is irrelevant.
+  CreateDevice({CreateExecutorOnNode(1), CreateExecutorOnNode(1)});
+  EXPECT_EQ(0, Select(IREE_HAL_QUEUE_AFFINITY_ANY, 0));
+  EXPECT_EQ(0, Select(IREE_HAL_QUEUE_AFFINITY_ANY, 1));
+  EXPECT_EQ(1, Select(0b10, 1));
+}
+
+TEST_F(TaskDeviceQueueSelectionTest, OutOfRangeAffinityWraps) {
+  CreateDevice({CreateExecutorOnNode(0), CreateExecutorOnNode(1),
+                CreateExecutorOnNode(0)});
+  // Affinities with no bits in range map onto the queues by value.
+  EXPECT_EQ(1, Select(1ull << 4, 0));
+  EXPECT_EQ(2, Select(1ull << 3, 1));
+}
+
+}  // namespace
@@ -54,6 +54,7 @@ iree_status_t iree_hal_task_driver_create(
   //   + loaders[] VLA
   // - queue_executors[]
   // - identifier string
+  // - executable cache directory string
   iree_hal_task_driver_t* driver = NULL;
   iree_host_size_t struct_size =
       sizeof(*driver) + loader_count * sizeof(*driver->loaders);
@@ -61,6 +62,8 @@ iree_status_t iree_hal_task_driver_create(
   struct_size += queue_count * sizeof(driver->queue_executors[0]);
   iree_host_size_t identifier_offset = struct_size;
   struct_size += identifier.size;
+  iree_host_size_t executable_cache_dir_offset = struct_size;
+  struct_size += default_params->executable_cache_dir.size;
   iree_status_t status =
       iree_allocator_malloc(host_allocator, struct_size, (void**)&driver);
   if (iree_status_is_ok(status)) {
@@ -74,6 +77,10 @@ iree_status_t iree_hal_task_driver_create(
                                       (char*)driver + identifier_offset);
     memcpy(&driver->default_params, default_params,
            sizeof(driver->default_params));
+    iree_string_view_append_to_buffer(
+        default_params->executable_cache_dir,
+        &driver->default_params.executable_cache_dir,
+        (char*)driver + executable_cache_dir_offset);
 
     driver->queue_count = queue_count;
     driver->queue_executors =
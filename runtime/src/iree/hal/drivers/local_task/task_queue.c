@@ -461,6 +461,15 @@ void iree_hal_task_queue_trim(iree_hal_task_queue_t* queue) {
 
 static iree_status_t iree_hal_task_queue_submit_batch(
     iree_hal_task_queue_t* queue, const iree_hal_submission_batch_t* batch) {
+  // Reject command buffers that can never be issued now instead of failing
+  // the queue scope (and with it all future submissions) when issuing them.
+  for (iree_host_size_t i = 0; i < batch->command_buffer_count; ++i) {
+    if (iree_hal_task_command_buffer_isa(batch->command_buffers[i])) {
+      IREE_RETURN_IF_ERROR(iree_hal_task_command_buffer_validate_issue(
+          batch->command_buffers[i]));
+    }
+  }
+
   // Task to retire the submission and free the transient memory allocated for
   // it (including the command itself). We allocate this first so it can get an
   // arena which we will use to allocate all other commands.
@@ -100,6 +100,23 @@ IREE_API_EXPORT void iree_hal_file_release(iree_hal_file_t* file);
 
 typedef struct iree_hal_file_vtable_t {
   void(IREE_API_PTR* destroy)(iree_hal_file_t* IREE_RESTRICT file);
+
+  // EXPERIMENTAL: synchronous host access used by the streaming file transfer
+  // utilities. See iree/hal/utils/memory_file.h.
+  iree_hal_memory_access_t(IREE_API_PTR* allowed_access)(
+      iree_hal_file_t* file);
+  uint64_t(IREE_API_PTR* length)(iree_hal_file_t* file);
+  iree_hal_buffer_t*(IREE_API_PTR* storage_buffer)(iree_hal_file_t* file);
+  iree_status_t(IREE_API_PTR* read)(iree_hal_file_t* file,
+                                    uint64_t file_offset,
+                                    iree_hal_buffer_t* buffer,
+                                    iree_device_size_t buffer_offset,
+                                    iree_device_size_t length);
+  iree_status_t(IREE_API_PTR* write)(iree_hal_file_t* file,
+                                     uint64_t file_offset,
+                                     iree_hal_buffer_t* buffer,
+                                     iree_device_size_t buffer_offset,
+                                     iree_device_size_t length);
 } iree_hal_file_vtable_t;
 IREE_HAL_ASSERT_VTABLE_LAYOUT(iree_hal_file_vtable_t);
 
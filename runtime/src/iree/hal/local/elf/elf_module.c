@@ -287,6 +287,21 @@ static iree_status_t iree_elf_module_load_segments(
   return iree_ok_status();
 }
 
+// Returns the iree_memory_access_t to apply to a segment with |p_flags|.
+static iree_memory_access_t iree_elf_module_segment_access(
+    iree_elf_word_t p_flags) {
+  // Interpret the access bits and widen to the implicit allowable
+  // permissions. See Table 7-37:
+  // https://docs.oracle.com/cd/E19683-01/816-1386/6m7qcoblk/index.html#chapter6-34713
+  iree_memory_access_t access = 0;
+  if (p_flags & IREE_ELF_PF_R) access |= IREE_MEMORY_ACCESS_READ;
+  if (p_flags & IREE_ELF_PF_W) access |= IREE_MEMORY_ACCESS_WRITE;
+  if (p_flags & IREE_ELF_PF_X) access |= IREE_MEMORY_ACCESS_EXECUTE;
+  if (access & IREE_MEMORY_ACCESS_WRITE) access |= IREE_MEMORY_ACCESS_READ;
+  if (access & IREE_MEMORY_ACCESS_EXECUTE) access |= IREE_MEMORY_ACCESS_READ;
+  return access;
+}
+
 // Applies segment memory protection attributes.
 // This will make pages read-only and must only be performed after relocation
 // (which writes to pages of all types). Executable pages will be flushed from
@@ -298,15 +313,8 @@ static iree_status_t iree_elf_module_protect_segments(
     const iree_elf_phdr_t* phdr = &load_state->phdr_table[i];
     if (phdr->p_type != IREE_ELF_PT_LOAD) continue;
 
-    // Interpret the access bits and widen to the implicit allowable
-    // permissions. See Table 7-37:
-    // https://docs.oracle.com/cd/E19683-01/816-1386/6m7qcoblk/index.html#chapter6-34713
-    iree_memory_access_t access = 0;
-    if (phdr->p_flags & IREE_ELF_PF_R) access |= IREE_MEMORY_ACCESS_READ;
-    if (phdr->p_flags & IREE_ELF_PF_W) access |= IREE_MEMORY_ACCESS_WRITE;
-    if (phdr->p_flags & IREE_ELF_PF_X) access |= IREE_MEMORY_ACCESS_EXECUTE;
-    if (access & IREE_MEMORY_ACCESS_WRITE) access |= IREE_MEMORY_ACCESS_READ;
-    if (access & IREE_MEMORY_ACCESS_EXECUTE) access |= IREE_MEMORY_ACCESS_READ;
+    iree_memory_access_t access =
+        iree_elf_module_segment_access(phdr->p_flags);
 
     // We only support R+X (no W).
     if ((phdr->p_flags & IREE_ELF_PF_X) && (phdr->p_flags & IREE_ELF_PF_W)) {
@@ -566,17 +574,456 @@ static const iree_elf_sym_t* iree_elf_module_lookup_global_symbol(
   return NULL;
 }
 
+//==============================================================================
+// Position-independent images
+//==============================================================================
+// A module image is a snapshot of the loaded and relocated virtual address
+// range of a module with all base-address-dependent words rebased to 0 and a
+// table of those words (fixups) that need the load bias added back. Loading an
+// image is just mapping/copying the pages, patching the fixups, and applying
+// protections; no ELF parsing or relocation processing is required.
+//
+// Which words depend on the load address is detected by relocating the module
+// twice at two different addresses and diffing the results: words that differ
+// by exactly the difference in addresses are fixups and any other difference
+// (such as a truncated 32-bit absolute relocation) makes the module
+// unrepresentable as an image. This keeps the image format independent of the
+// architecture-specific relocation types.
+//
+// File layout:
+//   iree_elf_image_header_t
+//   iree_elf_image_range_t[range_count]
+//   uint64_t fixup_vaddrs[fixup_count]
+//   (padding to IREE_ELF_IMAGE_ALIGNMENT)
+//   image bytes [vaddr_size] starting at vaddr_min
+//   source ELF bytes [source_length]
+//
+// The source ELF the image was produced from is stored in full such that an
+// image is only ever used for the exact ELF it was produced from regardless of
+// how it was located (such as by a hash that may collide).
+
+// Magic identifier at the start of all images.
+static const uint8_t iree_elf_image_magic[8] = {'I', 'R', 'E', 'E',
+                                                'E', 'L', 'F', 'I'};
+
+// Version of the image format; bumped on any incompatible change.
+#define IREE_ELF_IMAGE_VERSION 2
+
+// Alignment of the image bytes in the file and of the image length.
+// This is the largest common host page size such that images can be mapped
+// directly on all hosts regardless of their page size.
+#define IREE_ELF_IMAGE_ALIGNMENT (64 * 1024)
+
+// Range of the image that is committed and/or protected on load.
+enum iree_elf_image_range_flag_bits_t {
+  // Range pages are committed and loaded from the image.
+  IREE_ELF_IMAGE_RANGE_FLAG_LOAD = 1u << 0,
+};
+
+typedef struct iree_elf_image_range_t {
+  uint64_t vaddr;
+  uint64_t length;
+  // Final iree_memory_access_t of the range after fixups are applied.
+  uint32_t access;
+  // iree_elf_image_range_flag_bits_t.
+  uint32_t flags;
+} iree_elf_image_range_t;
+
+typedef struct iree_elf_image_header_t {
+  uint8_t magic[8];
+  uint32_t version;
+  // ELF e_machine the image was loaded for.
+  uint16_t machine;
+  // sizeof(void*) of the host that produced the image; fixups are this size.
+  uint16_t pointer_size;
+  // File offset of the image bytes, aligned to IREE_ELF_IMAGE_ALIGNMENT.
+  uint64_t image_offset;
+  // Virtual address of the first byte of the image.
+  uint64_t vaddr_min;
+  // Total image length, aligned to IREE_ELF_IMAGE_ALIGNMENT.
+  uint64_t vaddr_size;
+  // Dynamic table values required for symbol lookup and initialization.
+  uint64_t dynstr;
+  uint64_t dynstr_size;
+  uint64_t dynsym;
+  uint64_t dynsym_count;
+  uint64_t init;
+  uint64_t init_array;
+  uint64_t init_array_count;
+  uint32_t range_count;
+  uint32_t fixup_count;
+  // Length of the source ELF stored after the image bytes.
+  uint64_t source_length;
+} iree_elf_image_header_t;
+
+// Copies all PT_LOAD segments of the loaded |module| into |target| which spans
+// the module virtual address range starting at |vaddr_min|.
+static void iree_elf_module_copy_segments(
+    iree_elf_module_load_state_t* load_state, iree_elf_module_t* module,
+    iree_host_size_t vaddr_min, uint8_t* target) {
+  for (iree_elf_half_t i = 0; i < load_state->ehdr->e_phnum; ++i) {
+    const iree_elf_phdr_t* phdr = &load_state->phdr_table[i];
+    if (phdr->p_type != IREE_ELF_PT_LOAD) continue;
+    memcpy(target + (phdr->p_vaddr - vaddr_min),
+           module->vaddr_bias + phdr->p_vaddr, phdr->p_memsz);
+  }
+}
+
+// Makes an unrelocated copy of the loaded |module| segments and relocates it
+// at a different address than the module itself. The returned |out_shadow|
+// spans the entire module virtual address range and must be freed by the
+// caller.
+static iree_status_t iree_elf_module_relocate_shadow(
+    iree_elf_module_load_state_t* load_state, iree_elf_module_t* module,
+    uint8_t** out_shadow) {
+  *out_shadow = NULL;
+  const iree_host_size_t vaddr_min =
+      (iree_host_size_t)(module->vaddr_base - module->vaddr_bias);
+  uint8_t* shadow = NULL;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      module->host_allocator, module->vaddr_size, (void**)&shadow));
+  iree_elf_module_copy_segments(load_state, module, vaddr_min, shadow);
+
+  iree_elf_relocation_state_t reloc_state;
+  memset(&reloc_state, 0, sizeof(reloc_state));
+  reloc_state.vaddr_bias = shadow - vaddr_min;
+  reloc_state.dyn_table = load_state->dyn_table;
+  reloc_state.dyn_table_count = load_state->dyn_table_count;
+  reloc_state.dynsym = module->dynsym;
+  reloc_state.dynsym_count = module->dynsym_count;
+  iree_status_t status = iree_elf_arch_apply_relocations(&reloc_state);
+  if (iree_status_is_ok(status)) {
+    *out_shadow = shadow;
+  } else {
+    iree_allocator_free(module->host_allocator, shadow);
+  }
+  return status;
+}
+
+// Builds an image of the relocated |module| by diffing it against |shadow|,
+// a copy of the module relocated at a different address. |source_data| is the
+// ELF the module was loaded from and is stored in the image.
+// Returns IREE_STATUS_UNIMPLEMENTED if the module relocations are not
+// representable as image fixups.
+static iree_status_t iree_elf_module_build_image(
+    iree_elf_module_load_state_t* load_state, iree_elf_module_t* module,
+    const uint8_t* shadow, iree_const_byte_span_t source_data,
+    iree_byte_span_t* out_image) {
+  *out_image = iree_make_byte_span(NULL, 0);
+  const iree_host_size_t vaddr_min =
+      (iree_host_size_t)(module->vaddr_base - module->vaddr_bias);
+  const iree_host_size_t vaddr_size =
+      iree_host_align(module->vaddr_size, IREE_ELF_IMAGE_ALIGNMENT);
+  const uintptr_t module_bias = (uintptr_t)module->vaddr_bias;
+  const uintptr_t shadow_bias = (uintptr_t)shadow - vaddr_min;
+
+  // Copy out the relocated module; uncommitted gaps remain zeros as they are
+  // in the shadow.
+  uint8_t* relocated = NULL;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      module->host_allocator, module->vaddr_size, (void**)&relocated));
+  iree_elf_module_copy_segments(load_state, module, vaddr_min, relocated);
+
+  // Find all words that depend on the load address.
+  // NOTE: vaddr_min is page aligned and thus so is every word offset.
+  iree_status_t status = iree_ok_status();
+  iree_host_size_t fixup_count = 0;
+  for (iree_host_size_t offset = 0;
+       offset + sizeof(uintptr_t) <= module->vaddr_size;
+       offset += sizeof(uintptr_t)) {
+    uintptr_t module_value = 0;
+    uintptr_t shadow_value = 0;
+    memcpy(&module_value, relocated + offset, sizeof(module_value));
+    memcpy(&shadow_value, shadow + offset, sizeof(shadow_value));
+    if (module_value == shadow_value) continue;
+    if (module_value - module_bias != shadow_value - shadow_bias) {
+      status = iree_make_status(
+          IREE_STATUS_UNIMPLEMENTED,
+          "relocated word at vaddr %" PRIhsz
+          " is not a base-relative address; module cannot be imaged",
+          vaddr_min + offset);
+      break;
+    }
+    ++fixup_count;
+  }
+
+  iree_host_size_t range_count = 0;
+  for (iree_elf_half_t i = 0; i < load_state->ehdr->e_phnum; ++i) {
+    const iree_elf_phdr_t* phdr = &load_state->phdr_table[i];
+    if (phdr->p_type == IREE_ELF_PT_LOAD ||
+        phdr->p_type == IREE_ELF_PT_GNU_RELRO) {
+      ++range_count;
+    }
+  }
+
+  // Allocate the image storage.
+  const iree_host_size_t table_size =
+      sizeof(iree_elf_image_header_t) +
+      range_count * sizeof(iree_elf_image_range_t) +
+      fixup_count * sizeof(uint64_t);
+  const iree_host_size_t image_offset =
+      iree_host_align(table_size, IREE_ELF_IMAGE_ALIGNMENT);
+  iree_byte_span_t image = iree_make_byte_span(
+      NULL, image_offset + vaddr_size + source_data.data_length);
+  if (iree_status_is_ok(status)) {
+    status = iree_allocator_malloc(module->host_allocator, image.data_length,
+                                   (void**)&image.data);
+  }
+
+  if (iree_status_is_ok(status)) {
+    iree_elf_image_header_t* header = (iree_elf_image_header_t*)image.data;
+    memcpy(header->magic, iree_elf_image_magic, sizeof(header->magic));
+    header->version = IREE_ELF_IMAGE_VERSION;
+    header->machine = load_state->ehdr->e_machine;
+    header->pointer_size = sizeof(uintptr_t);
+    header->image_offset = image_offset;
+    header->vaddr_min = vaddr_min;
+    header->vaddr_size = vaddr_size;
+    header->dynstr = (uint64_t)((const uint8_t*)module->dynstr -
+                                module->vaddr_bias);
+    header->dynstr_size = module->dynstr_size;
+    header->dynsym = (uint64_t)((const uint8_t*)module->dynsym -
+                                module->vaddr_bias);
+    header->dynsym_count = module->dynsym_count;
+    header->init = load_state->init;
+    header->init_array =
+        load_state->init_array
+            ? (uint64_t)((const uint8_t*)load_state->init_array -
+                         module->vaddr_bias)
+            : 0;
+    header->init_array_count = load_state->init_array_count;
+    header->range_count = (uint32_t)range_count;
+    header->fixup_count = (uint32_t)fixup_count;
+    header->source_length = source_data.data_length;
+
+    // PT_LOAD ranges first as PT_GNU_RELRO ranges may alias them and must be
+    // protected afterward.
+    iree_elf_image_range_t* ranges = (iree_elf_image_range_t*)(header + 1);
+    iree_host_size_t range_index = 0;
+    for (iree_elf_half_t i = 0; i < load_state->ehdr->e_phnum; ++i) {
+      const iree_elf_phdr_t* phdr = &load_state->phdr_table[i];
+      if (phdr->p_type != IREE_ELF_PT_LOAD) continue;
+      ranges[range_index].vaddr = phdr->p_vaddr;
+      ranges[range_index].length = phdr->p_memsz;
+      ranges[range_index].access =
+          iree_elf_module_segment_access(phdr->p_flags);
+      ranges[range_index].flags = IREE_ELF_IMAGE_RANGE_FLAG_LOAD;
+      ++range_index;
+    }
+    for (iree_elf_half_t i = 0; i < load_state->ehdr->e_phnum; ++i) {
+      const iree_elf_phdr_t* phdr = &load_state->phdr_table[i];
+      if (phdr->p_type != IREE_ELF_PT_GNU_RELRO) continue;
+      ranges[range_index].vaddr = phdr->p_vaddr;
+      ranges[range_index].length = phdr->p_memsz;
+      ranges[range_index].access = IREE_MEMORY_ACCESS_READ;
+      ranges[range_index].flags = 0;
+      ++range_index;
+    }
+
+    // Copy the image contents and rebase all fixups to 0.
+    uint64_t* fixups = (uint64_t*)(ranges + range_count);
+    uint8_t* image_data = image.data + image_offset;
+    memcpy(image_data, relocated, module->vaddr_size);
+    iree_host_size_t fixup_index = 0;
+    for (iree_host_size_t offset = 0;
+         offset + sizeof(uintptr_t) <= module->vaddr_size;
+         offset += sizeof(uintptr_t)) {
+      uintptr_t module_value = 0;
+      uintptr_t shadow_value = 0;
+      memcpy(&module_value, relocated + offset, sizeof(module_value));
+      memcpy(&shadow_value, shadow + offset, sizeof(shadow_value));
+      if (module_value == shadow_value) continue;
+      const uintptr_t rebased_value = module_value - module_bias;
+      memcpy(image_data + offset, &rebased_value, sizeof(rebased_value));
+      fixups[fixup_index++] = vaddr_min + offset;
+    }
+    memcpy(image_data + vaddr_size, source_data.data, source_data.data_length);
+
+    *out_image = image;
+  }
+
+  iree_allocator_free(module->host_allocator, relocated);
+  return status;
+}
+
+// Verifies that |image_data| contains a well-formed image for this host that
+// was produced from |source_data| and returns the header.
+static iree_status_t iree_elf_module_verify_image(
+    iree_const_byte_span_t image_data, iree_const_byte_span_t source_data,
+    const iree_elf_image_header_t** out_header) {
+  *out_header = NULL;
+  if (image_data.data_length < sizeof(iree_elf_image_header_t)) {
+    return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                            "image data smaller than the header");
+  }
+  const iree_elf_image_header_t* header =
+      (const iree_elf_image_header_t*)image_data.data;
+  if (memcmp(header->magic, iree_elf_image_magic, sizeof(header->magic)) != 0) {
+    return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                            "data provided is not an ELF module image");
+  }
+  if (header->version != IREE_ELF_IMAGE_VERSION ||
+      header->pointer_size != sizeof(uintptr_t) ||
+      !iree_elf_machine_is_valid(header->machine)) {
+    return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                            "ELF module image version %u for machine %04X is "
+                            "not compatible with the host",
+                            header->version, (uint32_t)header->machine);
+  }
+  const uint64_t table_size =
+      sizeof(*header) +
+      (uint64_t)header->range_count * sizeof(iree_elf_image_range_t) +
+      (uint64_t)header->fixup_count * sizeof(uint64_t);
+  if (table_size > header->image_offset ||
+      !iree_host_size_has_alignment(header->image_offset,
+                                    IREE_ELF_IMAGE_ALIGNMENT) ||
+      header->image_offset + header->vaddr_size + header->source_length !=
+          image_data.data_length) {
+    return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                            "ELF module image tables out of bounds");
+  }
+  if (header->source_length != source_data.data_length ||
+      memcmp(image_data.data + header->image_offset + header->vaddr_size,
+             source_data.data, source_data.data_length) != 0) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "ELF module image was produced from a different "
+                            "ELF than the one provided");
+  }
+  const uint64_t vaddr_end = header->vaddr_min + header->vaddr_size;
+  const iree_elf_image_range_t* ranges =
+      (const iree_elf_image_range_t*)(header + 1);
+  for (uint32_t i = 0; i < header->range_count; ++i) {
+    if (ranges[i].vaddr < header->vaddr_min ||
+        ranges[i].vaddr + ranges[i].length > vaddr_end) {
+      return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                              "ELF module image range out of bounds");
+    }
+    if ((ranges[i].access & IREE_MEMORY_ACCESS_WRITE) &&
+        (ranges[i].access & IREE_MEMORY_ACCESS_EXECUTE)) {
+      return iree_make_status(IREE_STATUS_PERMISSION_DENIED,
+                              "unable to create a writable executable segment");
+    }
+  }
+  const uint64_t* fixups = (const uint64_t*)(ranges + header->range_count);
+  for (uint32_t i = 0; i < header->fixup_count; ++i) {
+    if (fixups[i] < header->vaddr_min ||
+        fixups[i] + sizeof(uintptr_t) > vaddr_end) {
+      return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                              "ELF module image fixup out of bounds");
+    }
+  }
+  if (header->dynstr < header->vaddr_min ||
+      header->dynstr + header->dynstr_size > vaddr_end ||
+      header->dynsym < header->vaddr_min ||
+      header->dynsym + header->dynsym_count * sizeof(iree_elf_sym_t) >
+          vaddr_end ||
+      !header->dynstr_size || !header->dynsym_count) {
+    return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                            "ELF module image symbol tables out of bounds");
+  }
+  *out_header = header;
+  return iree_ok_status();
+}
+
+// Commits and loads the image ranges, preferring to map them directly from
+// |image_path| when possible.
+static iree_status_t iree_elf_module_load_image_ranges(
+    iree_const_byte_span_t image_data, const iree_elf_image_header_t* header,
+    const char* image_path, iree_elf_module_t* module) {
+  const iree_memory_info_t memory_info = iree_memory_query_info();
+  const iree_host_size_t page_size = memory_info.normal_page_size;
+  const iree_elf_image_range_t* ranges =
+      (const iree_elf_image_range_t*)(header + 1);
+  bool try_map = image_path != NULL &&
+                 iree_host_size_has_alignment(IREE_ELF_IMAGE_ALIGNMENT,
+                                              page_size);
+  for (uint32_t i = 0; i < header->range_count; ++i) {
+    if (!(ranges[i].flags & IREE_ELF_IMAGE_RANGE_FLAG_LOAD)) continue;
+    const iree_host_size_t range_offset =
+        (iree_host_size_t)(ranges[i].vaddr - header->vaddr_min);
+    if (try_map) {
+      // Map the pages overlapping the range directly from the file. The image
+      // length is padded such that any page in range is present in the file.
+      const iree_host_size_t page_offset =
+          iree_page_align_start(range_offset, page_size);
+      const iree_host_size_t page_length =
+          iree_page_align_end(range_offset + ranges[i].length, page_size) -
+          page_offset;
+      iree_status_t status = iree_memory_view_map_file(
+          module->vaddr_base + page_offset, page_length, image_path,
+          header->image_offset + page_offset);
+      if (iree_status_is_ok(status)) {
+        // The file may have been replaced since |image_data| was verified.
+        // Both views share the same page cache pages so this only reads them.
+        if (memcmp(module->vaddr_base + range_offset,
+                   image_data.data + header->image_offset + range_offset,
+                   ranges[i].length) != 0) {
+          return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                                  "ELF module image file changed while "
+                                  "loading");
+        }
+        continue;
+      }
+      if (!iree_status_is_unavailable(status)) return status;
+      iree_status_ignore(status);
+      try_map = false;
+    }
+    iree_byte_range_t byte_range = {
+        .offset = ranges[i].vaddr,
+        .length = ranges[i].length,
+    };
+    IREE_RETURN_IF_ERROR(iree_memory_view_commit_ranges(
+        module->vaddr_bias, 1, &byte_range,
+        IREE_MEMORY_ACCESS_READ | IREE_MEMORY_ACCESS_WRITE));
+    memcpy(module->vaddr_base + range_offset,
+           image_data.data + header->image_offset + range_offset,
+           ranges[i].length);
+  }
+  return iree_ok_status();
+}
+
+// Applies fixups and protections to the loaded image ranges.
+static iree_status_t iree_elf_module_finalize_image_ranges(
+    const iree_elf_image_header_t* header, iree_elf_module_t* module) {
+  const iree_elf_image_range_t* ranges =
+      (const iree_elf_image_range_t*)(header + 1);
+  const uint64_t* fixups = (const uint64_t*)(ranges + header->range_count);
+  const uintptr_t bias = (uintptr_t)module->vaddr_bias;
+  for (uint32_t i = 0; i < header->fixup_count; ++i) {
+    uint8_t* fixup_ptr = module->vaddr_bias + fixups[i];
+    uintptr_t value = 0;
+    memcpy(&value, fixup_ptr, sizeof(value));
+    value += bias;
+    memcpy(fixup_ptr, &value, sizeof(value));
+  }
+  for (uint32_t i = 0; i < header->range_count; ++i) {
+    iree_byte_range_t byte_range = {
+        .offset = ranges[i].vaddr,
+        .length = ranges[i].length,
+    };
+    IREE_RETURN_IF_ERROR(iree_memory_view_protect_ranges(
+        module->vaddr_bias, 1, &byte_range, ranges[i].access));
+    if (ranges[i].access & IREE_MEMORY_ACCESS_EXECUTE) {
+      iree_memory_flush_icache(module->vaddr_bias + ranges[i].vaddr,
+                               ranges[i].length);
+    }
+  }
+  return iree_ok_status();
+}
+
 //==============================================================================
 // API
 //==============================================================================
 
-iree_status_t iree_elf_module_initialize_from_memory(
+static iree_status_t iree_elf_module_initialize_from_memory_impl(
     iree_const_byte_span_t raw_data,
     const iree_elf_import_table_t* import_table,
-    iree_allocator_t host_allocator, iree_elf_module_t* out_module) {
+    iree_allocator_t host_allocator, iree_elf_module_t* out_module,
+    iree_byte_span_t* out_image) {
   IREE_ASSERT_ARGUMENT(raw_data.data);
   IREE_ASSERT_ARGUMENT(out_module);
   IREE_TRACE_ZONE_BEGIN(z0);
+  const iree_const_byte_span_t source_data = raw_data;
 
   // If the file is a FatELF then select the ELF for this architecture.
   // Ignored of not a FatELF and otherwise errors if no compatible architecture
@@ -611,11 +1058,32 @@ iree_status_t iree_elf_module_initialize_from_memory(
     status = iree_elf_module_verify_no_imports(&load_state, out_module);
   }
 
+  // If an image was requested relocate a shadow copy of the module at another
+  // address prior to relocating the module itself; the two are diffed to find
+  // the words that depend on the load address.
+  uint8_t* shadow = NULL;
+  if (iree_status_is_ok(status) && out_image) {
+    status = iree_elf_module_relocate_shadow(&load_state, out_module, &shadow);
+  }
+
   // Apply relocations to the loaded pages.
   if (iree_status_is_ok(status)) {
     status = iree_elf_module_apply_relocations(&load_state, out_module);
   }
 
+  // Build the image while the pages are still writeable. Modules that cannot
+  // be imaged still load successfully and just produce no image.
+  if (iree_status_is_ok(status) && shadow) {
+    iree_status_t image_status = iree_elf_module_build_image(
+        &load_state, out_module, shadow, source_data, out_image);
+    if (iree_status_is_unimplemented(image_status)) {
+      iree_status_ignore(image_status);
+    } else {
+      status = image_status;
+    }
+  }
+  iree_allocator_free(host_allocator, shadow);
+
   // Apply final protections to the loaded pages now that relocations have been
   // performed.
   if (iree_status_is_ok(status)) {
@@ -632,6 +1100,90 @@ iree_status_t iree_elf_module_initialize_from_memory(
     // On failure gracefully clean up the module by releasing any allocated
     // memory during the partial initialization.
     iree_elf_module_deinitialize(out_module);
+    if (out_image) {
+      iree_allocator_free(host_allocator, out_image->data);
+      *out_image = iree_make_byte_span(NULL, 0);
+    }
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+iree_status_t iree_elf_module_initialize_from_memory(
+    iree_const_byte_span_t raw_data,
+    const iree_elf_import_table_t* import_table,
+    iree_allocator_t host_allocator, iree_elf_module_t* out_module) {
+  return iree_elf_module_initialize_from_memory_impl(
+      raw_data, import_table, host_allocator, out_module, /*out_image=*/NULL);
+}
+
+iree_status_t iree_elf_module_initialize_from_memory_with_image(
+    iree_const_byte_span_t raw_data,
+    const iree_elf_import_table_t* import_table,
+    iree_allocator_t host_allocator, iree_elf_module_t* out_module,
+    iree_byte_span_t* out_image) {
+  IREE_ASSERT_ARGUMENT(out_image);
+  *out_image = iree_make_byte_span(NULL, 0);
+  return iree_elf_module_initialize_from_memory_impl(
+      raw_data, import_table, host_allocator, out_module, out_image);
+}
+
+iree_status_t iree_elf_module_initialize_from_image(
+    iree_const_byte_span_t image_data, iree_const_byte_span_t source_data,
+    const char* image_path, iree_allocator_t host_allocator,
+    iree_elf_module_t* out_module) {
+  IREE_ASSERT_ARGUMENT(image_data.data);
+  IREE_ASSERT_ARGUMENT(out_module);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  memset(out_module, 0, sizeof(*out_module));
+  out_module->host_allocator = host_allocator;
+
+  const iree_elf_image_header_t* header = NULL;
+  iree_status_t status =
+      iree_elf_module_verify_image(image_data, source_data, &header);
+
+  // Reserve the address space and map or copy in the image.
+  iree_memory_jit_context_begin();
+  if (iree_status_is_ok(status)) {
+    status = iree_memory_view_reserve(
+        IREE_MEMORY_VIEW_FLAG_MAY_EXECUTE, (iree_host_size_t)header->vaddr_size,
+        host_allocator, (void**)&out_module->vaddr_base);
+  }
+  if (iree_status_is_ok(status)) {
+    out_module->vaddr_size = (iree_host_size_t)header->vaddr_size;
+    out_module->vaddr_bias =
+        out_module->vaddr_base - (iree_host_size_t)header->vaddr_min;
+    status = iree_elf_module_load_image_ranges(image_data, header, image_path,
+                                               out_module);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_elf_module_finalize_image_ranges(header, out_module);
+  }
+  iree_memory_jit_context_end();
+
+  // Setup the symbol tables used for lookups and run initializers.
+  if (iree_status_is_ok(status)) {
+    out_module->dynstr =
+        (const char*)(out_module->vaddr_bias + header->dynstr);
+    out_module->dynstr_size = (iree_host_size_t)header->dynstr_size;
+    out_module->dynsym =
+        (const iree_elf_sym_t*)(out_module->vaddr_bias + header->dynsym);
+    out_module->dynsym_count = (iree_host_size_t)header->dynsym_count;
+
+    iree_elf_module_load_state_t load_state;
+    memset(&load_state, 0, sizeof(load_state));
+    load_state.init = (iree_elf_addr_t)header->init;
+    load_state.init_array =
+        header->init_array ? (const iree_elf_addr_t*)(out_module->vaddr_bias +
+                                                      header->init_array)
+                           : NULL;
+    load_state.init_array_count =
+        load_state.init_array ? (iree_host_size_t)header->init_array_count : 0;
+    status = iree_elf_module_run_initializers(&load_state, out_module);
+  }
+
+  if (!iree_status_is_ok(status)) {
+    iree_elf_module_deinitialize(out_module);
   }
   IREE_TRACE_ZONE_END(z0);
   return status;
@@ -77,6 +77,46 @@ iree_status_t iree_elf_module_initialize_from_memory(
     const iree_elf_import_table_t* import_table,
     iree_allocator_t host_allocator, iree_elf_module_t* out_module);
 
+// Initializes an ELF module from the ELF |raw_data| in memory like
+// iree_elf_module_initialize_from_memory and additionally produces an image of
+// the loaded module in |out_image| that can be persisted and later loaded with
+// iree_elf_module_initialize_from_image without parsing or relocating the ELF.
+// The image is allocated from |host_allocator| and must be freed by the caller.
+//
+// If the module relocations cannot be represented in an image (such as when
+// absolute addresses are truncated) the module is still initialized and
+// |out_image| will be empty.
+iree_status_t iree_elf_module_initialize_from_memory_with_image(
+    iree_const_byte_span_t raw_data,
+    const iree_elf_import_table_t* import_table,
+    iree_allocator_t host_allocator, iree_elf_module_t* out_module,
+    iree_byte_span_t* out_image);
+
+// Initializes an ELF module from an image produced by
+// iree_elf_module_initialize_from_memory_with_image on a compatible host.
+// |image_data| only needs to remain valid for the initialization of the module.
+// |source_data| must be the ELF the image was produced from; images contain a
+// full copy of their source ELF and are rejected if it differs.
+//
+// Returns IREE_STATUS_FAILED_PRECONDITION if the image is malformed or not
+// compatible with the host and IREE_STATUS_INVALID_ARGUMENT if it was produced
+// from a different ELF than |source_data|.
+//
+// If |image_path| is provided it should reference a file with the same
+// contents as |image_data| and where supported the module pages will be mapped
+// copy-on-write from the file instead of being copied. Only pages containing
+// base-relative addresses are written during loading and all others remain
+// shared with the page cache (and other processes loading the same image).
+// Mapped pages are compared against |image_data| and the load fails with
+// IREE_STATUS_FAILED_PRECONDITION if the file was changed.
+//
+// Images are trusted to the same degree as the ELF they were produced from and
+// only basic bounds checks are performed.
+iree_status_t iree_elf_module_initialize_from_image(
+    iree_const_byte_span_t image_data, iree_const_byte_span_t source_data,
+    const char* image_path, iree_allocator_t host_allocator,
+    iree_elf_module_t* out_module);
+
 // Deinitializes a |module|, releasing any allocated executable or data pages.
 // Invalidates all symbol pointers previous retrieved from the module and any
 // pointer to data that may have been in the module text or rwdata.
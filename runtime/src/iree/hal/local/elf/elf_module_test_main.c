@@ -51,23 +51,15 @@ static iree_status_t query_arch_test_file_data(
                           "the application for the current target platform");
 }
 
-static iree_status_t run_test() {
-  iree_const_byte_span_t file_data;
-  IREE_RETURN_IF_ERROR(query_arch_test_file_data(&file_data));
-
-  iree_elf_import_table_t import_table;
-  memset(&import_table, 0, sizeof(import_table));
-  iree_elf_module_t module;
-  IREE_RETURN_IF_ERROR(iree_elf_module_initialize_from_memory(
-      file_data, &import_table, iree_allocator_system(), &module));
-
+// Queries the library from the loaded |module| and runs its entry point.
+static iree_status_t run_module(iree_elf_module_t* module) {
   iree_hal_executable_environment_v0_t environment;
   iree_hal_executable_environment_initialize(iree_allocator_system(),
                                              &environment);
 
   void* query_fn_ptr = NULL;
   IREE_RETURN_IF_ERROR(iree_elf_module_lookup_export(
-      &module, IREE_HAL_EXECUTABLE_LIBRARY_EXPORT_NAME, &query_fn_ptr));
+      module, IREE_HAL_EXECUTABLE_LIBRARY_EXPORT_NAME, &query_fn_ptr));
 
   union {
     const iree_hal_executable_library_header_t** header;
@@ -150,8 +142,98 @@ static iree_status_t run_test() {
       break;
     }
   }
+  return status;
+}
+
+// Returns OK if loading |image| fails as expected when it is truncated, when
+// it is paired with a different source ELF than |file_data|, and when its
+// header is corrupt.
+static iree_status_t verify_image_rejected(iree_const_byte_span_t image,
+                                           iree_const_byte_span_t file_data) {
+  iree_elf_module_t module;
+  iree_status_t status = iree_elf_module_initialize_from_image(
+      iree_make_const_byte_span(image.data, image.data_length - 1), file_data,
+      /*image_path=*/NULL, iree_allocator_system(), &module);
+  if (!iree_status_is_failed_precondition(status)) {
+    if (iree_status_is_ok(status)) iree_elf_module_deinitialize(&module);
+    return iree_status_join(
+        iree_make_status(IREE_STATUS_INTERNAL, "truncated image was accepted"),
+        status);
+  }
+  iree_status_ignore(status);
+
+  // A source of the same length with a single differing byte.
+  uint8_t* other_data = NULL;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      iree_allocator_system(), file_data.data_length, (void**)&other_data));
+  memcpy(other_data, file_data.data, file_data.data_length);
+  other_data[file_data.data_length - 1] ^= 0xFF;
+  status = iree_elf_module_initialize_from_image(
+      image, iree_make_const_byte_span(other_data, file_data.data_length),
+      /*image_path=*/NULL, iree_allocator_system(), &module);
+  iree_allocator_free(iree_allocator_system(), other_data);
+  if (!iree_status_is_invalid_argument(status)) {
+    if (iree_status_is_ok(status)) iree_elf_module_deinitialize(&module);
+    return iree_status_join(
+        iree_make_status(IREE_STATUS_INTERNAL,
+                         "image of a different source was accepted"),
+        status);
+  }
+  iree_status_ignore(status);
+
+  // An image with a corrupt magic header.
+  uint8_t* corrupt_data = NULL;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      iree_allocator_system(), image.data_length, (void**)&corrupt_data));
+  memcpy(corrupt_data, image.data, image.data_length);
+  corrupt_data[0] ^= 0xFF;
+  status = iree_elf_module_initialize_from_image(
+      iree_make_const_byte_span(corrupt_data, image.data_length), file_data,
+      /*image_path=*/NULL, iree_allocator_system(), &module);
+  iree_allocator_free(iree_allocator_system(), corrupt_data);
+  if (!iree_status_is_failed_precondition(status)) {
+    if (iree_status_is_ok(status)) iree_elf_module_deinitialize(&module);
+    return iree_status_join(
+        iree_make_status(IREE_STATUS_INTERNAL, "corrupt image was accepted"),
+        status);
+  }
+  iree_status_ignore(status);
+  return iree_ok_status();
+}
+
+static iree_status_t run_test() {
+  iree_const_byte_span_t file_data;
+  IREE_RETURN_IF_ERROR(query_arch_test_file_data(&file_data));
+
+  iree_elf_import_table_t import_table;
+  memset(&import_table, 0, sizeof(import_table));
+  iree_elf_module_t module;
+  IREE_RETURN_IF_ERROR(iree_elf_module_initialize_from_memory(
+      file_data, &import_table, iree_allocator_system(), &module));
+  iree_status_t status = run_module(&module);
+  iree_elf_module_deinitialize(&module);
+  IREE_RETURN_IF_ERROR(status);
 
+  // Load again producing an image and then load the module from the image.
+  iree_byte_span_t image = iree_make_byte_span(NULL, 0);
+  IREE_RETURN_IF_ERROR(iree_elf_module_initialize_from_memory_with_image(
+      file_data, &import_table, iree_allocator_system(), &module, &image));
+  status = run_module(&module);
   iree_elf_module_deinitialize(&module);
+  if (iree_status_is_ok(status) && image.data_length > 0) {
+    status = iree_elf_module_initialize_from_image(
+        iree_make_const_byte_span(image.data, image.data_length), file_data,
+        /*image_path=*/NULL, iree_allocator_system(), &module);
+    if (iree_status_is_ok(status)) {
+      status = run_module(&module);
+      iree_elf_module_deinitialize(&module);
+    }
+  }
+  if (iree_status_is_ok(status) && image.data_length > 0) {
+    status = verify_image_rejected(
+        iree_make_const_byte_span(image.data, image.data_length), file_data);
+  }
+  iree_allocator_free(iree_allocator_system(), image.data);
   return status;
 }
 
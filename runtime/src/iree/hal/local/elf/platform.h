@@ -89,4 +89,19 @@ iree_status_t iree_memory_view_protect_ranges(void* base_address,
                                               const iree_byte_range_t* ranges,
                                               iree_memory_access_t new_access);
 
+// Commits |length| bytes of the view at |base_address| by mapping the file at
+// |path| starting at |file_offset| with private copy-on-write semantics and
+// read/write access. |base_address|, |length|, and |file_offset| must all be
+// aligned to the host page size. Later changes to the file may or may not be
+// reflected in the mapped pages until they are written.
+//
+// Returns IREE_STATUS_UNAVAILABLE if the platform does not support mapping
+// files into views in which case callers should commit and copy instead.
+//
+// Implemented by mmap+MAP_FIXED|MAP_PRIVATE where available.
+iree_status_t iree_memory_view_map_file(void* base_address,
+                                        iree_host_size_t length,
+                                        const char* path,
+                                        uint64_t file_offset);
+
 #endif  // IREE_HAL_LOCAL_ELF_PLATFORM_H_
@@ -136,4 +136,15 @@ iree_status_t iree_memory_view_protect_ranges(void* base_address,
   return status;
 }
 
+// NOTE: executable pages must come from MAP_JIT reservations on hardened
+// runtimes and those cannot be backed by files.
+iree_status_t iree_memory_view_map_file(void* base_address,
+                                        iree_host_size_t length,
+                                        const char* path,
+                                        uint64_t file_offset) {
+  return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                          "file-backed memory views not supported on "
+                          "Apple platforms");
+}
+
 #endif  // IREE_PLATFORM_APPLE
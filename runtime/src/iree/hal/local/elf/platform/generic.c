@@ -49,4 +49,13 @@ iree_status_t iree_memory_view_protect_ranges(void* base_address,
   return iree_ok_status();
 }
 
+iree_status_t iree_memory_view_map_file(void* base_address,
+                                        iree_host_size_t length,
+                                        const char* path,
+                                        uint64_t file_offset) {
+  return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                          "file-backed memory views not supported on "
+                          "this platform");
+}
+
 #endif  // IREE_PLATFORM_GENERIC
@@ -9,6 +9,7 @@
 #if defined(IREE_PLATFORM_ANDROID) || defined(IREE_PLATFORM_LINUX)
 
 #include <errno.h>
+#include <fcntl.h>
 #include <sys/mman.h>
 #include <unistd.h>
 
@@ -109,4 +110,32 @@ iree_status_t iree_memory_view_protect_ranges(void* base_address,
   return status;
 }
 
+iree_status_t iree_memory_view_map_file(void* base_address,
+                                        iree_host_size_t length,
+                                        const char* path,
+                                        uint64_t file_offset) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  int fd = open(path, O_RDONLY | O_CLOEXEC);
+  if (fd == -1) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(iree_status_code_from_errno(errno),
+                            "unable to open '%s' for mapping", path);
+  }
+
+  // NOTE: the file descriptor can be closed immediately as the mapping retains
+  // its own reference to the file.
+  iree_status_t status = iree_ok_status();
+  void* result = mmap(base_address, length, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_FIXED, fd, (off_t)file_offset);
+  if (result == MAP_FAILED) {
+    status = iree_make_status(iree_status_code_from_errno(errno),
+                              "mmap of file '%s' failed", path);
+  }
+  close(fd);
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 #endif  // IREE_PLATFORM_*
@@ -112,4 +112,15 @@ iree_status_t iree_memory_view_protect_ranges(void* base_address,
   return status;
 }
 
+// TODO: MapViewOfFile3 with MEM_REPLACE_PLACEHOLDER could map into the
+// reservation once it is created with MEM_RESERVE_PLACEHOLDER.
+iree_status_t iree_memory_view_map_file(void* base_address,
+                                        iree_host_size_t length,
+                                        const char* path,
+                                        uint64_t file_offset) {
+  return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                          "file-backed memory views not supported on "
+                          "Windows");
+}
+
 #endif  // IREE_PLATFORM_WINDOWS
@@ -107,3 +107,25 @@ iree_status_t iree_hal_executable_loader_try_load(
   return executable_loader->vtable->try_load(
       executable_loader, executable_params, worker_capacity, out_executable);
 }
+
+iree_status_t iree_hal_executable_loader_try_load_persistent(
+    iree_hal_executable_loader_t* executable_loader,
+    const iree_hal_executable_params_t* executable_params,
+    iree_host_size_t worker_capacity, const char* cache_path,
+    iree_hal_executable_t** out_executable) {
+  IREE_ASSERT_ARGUMENT(executable_loader);
+  IREE_ASSERT_ARGUMENT(cache_path);
+  if (!executable_loader->vtable->try_load_persistent) {
+    return iree_hal_executable_loader_try_load(
+        executable_loader, executable_params, worker_capacity, out_executable);
+  }
+  IREE_ASSERT_ARGUMENT(executable_params);
+  IREE_ASSERT_ARGUMENT(!executable_params->pipeline_layout_count ||
+                       executable_params->pipeline_layouts);
+  IREE_ASSERT_ARGUMENT(!executable_params->executable_data.data_length ||
+                       executable_params->executable_data.data);
+  IREE_ASSERT_ARGUMENT(out_executable);
+  return executable_loader->vtable->try_load_persistent(
+      executable_loader, executable_params, worker_capacity, cache_path,
+      out_executable);
+}
@@ -158,6 +158,19 @@ iree_status_t iree_hal_executable_loader_try_load(
     const iree_hal_executable_params_t* executable_params,
     iree_host_size_t worker_capacity, iree_hal_executable_t** out_executable);
 
+// Tries loading the executable as with iree_hal_executable_loader_try_load
+// using the file at |cache_path| as persistent storage for loader-specific
+// prepared data (such as relocated images). Loaders supporting persistence will
+// load from the file if it was produced from the same executable and otherwise
+// load normally and try to store the prepared data to the file for future
+// loads. Failures to read or write the file are not errors. Loaders that do
+// not support persistence ignore |cache_path|.
+iree_status_t iree_hal_executable_loader_try_load_persistent(
+    iree_hal_executable_loader_t* executable_loader,
+    const iree_hal_executable_params_t* executable_params,
+    iree_host_size_t worker_capacity, const char* cache_path,
+    iree_hal_executable_t** out_executable);
+
 //===----------------------------------------------------------------------===//
 // iree_hal_executable_loader_t implementation details
 //===----------------------------------------------------------------------===//
@@ -174,6 +187,13 @@ typedef struct iree_hal_executable_loader_vtable_t {
       iree_hal_executable_loader_t* executable_loader,
       const iree_hal_executable_params_t* executable_params,
       iree_host_size_t worker_capacity, iree_hal_executable_t** out_executable);
+
+  // Optional; iree_hal_executable_loader_try_load is used if omitted.
+  iree_status_t(IREE_API_PTR* try_load_persistent)(
+      iree_hal_executable_loader_t* executable_loader,
+      const iree_hal_executable_params_t* executable_params,
+      iree_host_size_t worker_capacity, const char* cache_path,
+      iree_hal_executable_t** out_executable);
 } iree_hal_executable_loader_vtable_t;
 
 #ifdef __cplusplus
@@ -6,10 +6,13 @@
 
 #include "iree/hal/local/loaders/embedded_elf_loader.h"
 
+#include <inttypes.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <stdio.h>
 
+#include "iree/base/internal/file_io.h"
 #include "iree/hal/api.h"
 #include "iree/hal/local/elf/elf_module.h"
 #include "iree/hal/local/executable_library.h"
@@ -81,13 +84,118 @@ static iree_status_t iree_hal_elf_executable_query_library(
 
   executable->identifier = iree_make_cstring_view(header->name);
   executable->base.dispatch_attrs = executable->library.v0->exports.attrs;
+  executable->base.dispatch_names = executable->library.v0->exports.names;
   return iree_ok_status();
 }
 
+#if IREE_FILE_IO_ENABLE
+
+// Stores |image| to |cache_path| such that concurrent loaders never observe a
+// partially written file. Failures are ignored as the cache is best-effort.
+static void iree_hal_elf_executable_store_image(
+    const char* cache_path, iree_const_byte_span_t image,
+    iree_allocator_t host_allocator) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)image.data_length);
+
+  // Write to a unique temporary file and then rename it over the cache path.
+  const iree_host_size_t temp_path_capacity = strlen(cache_path) + 32;
+  char* temp_path = NULL;
+  iree_status_t status = iree_allocator_malloc(
+      host_allocator, temp_path_capacity, (void**)&temp_path);
+  if (iree_status_is_ok(status)) {
+    snprintf(temp_path, temp_path_capacity, "%s.%016" PRIx64 ".tmp", cache_path,
+             (uint64_t)iree_time_now() ^ (uint64_t)(uintptr_t)&image);
+    status = iree_file_write_contents(temp_path, image);
+    if (iree_status_is_ok(status) && rename(temp_path, cache_path) != 0) {
+      status = iree_make_status(IREE_STATUS_UNAVAILABLE,
+                                "failed to rename cache file into place");
+    }
+    if (!iree_status_is_ok(status)) remove(temp_path);
+  }
+  iree_allocator_free(host_allocator, temp_path);
+  iree_status_ignore(status);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+// Loads the ELF module from the image at |cache_path| if it was produced from
+// |elf_data| and otherwise loads it from |elf_data|. A new image is stored to
+// |cache_path| only if there was no usable image there: entries produced from
+// a different ELF with the same key are left in place and failures unrelated
+// to the image contents do not cause rewrites.
+static iree_status_t iree_hal_elf_executable_load_persistent_module(
+    iree_const_byte_span_t elf_data, const char* cache_path,
+    iree_allocator_t host_allocator, iree_elf_module_t* out_module) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Try loading the cached image; the file contents are only used for the
+  // duration of the load as the pages are mapped independently.
+  iree_file_contents_t* image_contents = NULL;
+  iree_status_t status = iree_file_read_contents(
+      cache_path, IREE_FILE_READ_FLAG_MMAP, host_allocator, &image_contents);
+  if (iree_status_is_ok(status)) {
+    status = iree_elf_module_initialize_from_image(
+        image_contents->const_buffer, elf_data, cache_path, host_allocator,
+        out_module);
+    iree_file_contents_free(image_contents);
+  }
+  if (iree_status_is_ok(status)) {
+    IREE_TRACE_ZONE_APPEND_TEXT(z0, "hit");
+    IREE_TRACE_ZONE_END(z0);
+    return status;
+  }
+  // Missing files are NOT_FOUND and malformed, truncated, or incompatible
+  // images are FAILED_PRECONDITION; all other failures (including images of
+  // other ELFs) keep the existing entry.
+  const bool store_image = iree_status_is_not_found(status) ||
+                           iree_status_is_failed_precondition(status);
+  iree_status_ignore(status);
+  IREE_TRACE_ZONE_APPEND_TEXT(z0, "miss");
+
+  // Cache miss: load from the ELF and, if the entry needs to be populated,
+  // produce an image for the next load.
+  iree_byte_span_t image = iree_make_byte_span(NULL, 0);
+  if (store_image) {
+    status = iree_elf_module_initialize_from_memory_with_image(
+        elf_data, /*import_table=*/NULL, host_allocator, out_module, &image);
+  } else {
+    status = iree_elf_module_initialize_from_memory(
+        elf_data, /*import_table=*/NULL, host_allocator, out_module);
+  }
+  if (iree_status_is_ok(status) && image.data_length > 0) {
+    iree_hal_elf_executable_store_image(
+        cache_path, iree_make_const_byte_span(image.data, image.data_length),
+        host_allocator);
+  }
+  iree_allocator_free(host_allocator, image.data);
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+#endif  // IREE_FILE_IO_ENABLE
+
+// Loads the ELF module from |elf_data| or the persistent |cache_path| if
+// provided.
+static iree_status_t iree_hal_elf_executable_load_module(
+    iree_const_byte_span_t elf_data, const char* cache_path,
+    iree_allocator_t host_allocator, iree_elf_module_t* out_module) {
+#if IREE_FILE_IO_ENABLE
+  if (cache_path) {
+    return iree_hal_elf_executable_load_persistent_module(
+        elf_data, cache_path, host_allocator, out_module);
+  }
+#endif  // IREE_FILE_IO_ENABLE
+  return iree_elf_module_initialize_from_memory(
+      elf_data, /*import_table=*/NULL, host_allocator, out_module);
+}
+
 static iree_status_t iree_hal_elf_executable_create(
     const iree_hal_executable_params_t* executable_params,
     const iree_hal_executable_import_provider_t import_provider,
-    iree_allocator_t host_allocator, iree_hal_executable_t** out_executable) {
+    const char* cache_path, iree_allocator_t host_allocator,
+    iree_hal_executable_t** out_executable) {
   IREE_ASSERT_ARGUMENT(executable_params);
   IREE_ASSERT_ARGUMENT(executable_params->executable_data.data &&
                        executable_params->executable_data.data_length);
@@ -131,9 +239,9 @@ static iree_status_t iree_hal_elf_executable_create(
 
   // Attempt to load the ELF module.
   if (iree_status_is_ok(status)) {
-    status = iree_elf_module_initialize_from_memory(
-        executable_params->executable_data, /*import_table=*/NULL,
-        host_allocator, &executable->module);
+    status = iree_hal_elf_executable_load_module(
+        executable_params->executable_data, cache_path, host_allocator,
+        &executable->module);
   }
 
   // Query metadata and get the entry point function pointers.
@@ -298,6 +406,25 @@ static iree_status_t iree_hal_embedded_elf_loader_try_load(
   // Perform the load of the ELF and wrap it in an executable handle.
   iree_status_t status = iree_hal_elf_executable_create(
       executable_params, base_executable_loader->import_provider,
+      /*cache_path=*/NULL, executable_loader->host_allocator, out_executable);
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+static iree_status_t iree_hal_embedded_elf_loader_try_load_persistent(
+    iree_hal_executable_loader_t* base_executable_loader,
+    const iree_hal_executable_params_t* executable_params,
+    iree_host_size_t worker_capacity, const char* cache_path,
+    iree_hal_executable_t** out_executable) {
+  iree_hal_embedded_elf_loader_t* executable_loader =
+      (iree_hal_embedded_elf_loader_t*)base_executable_loader;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Perform the load of the ELF (or its cached image) and wrap it in an
+  // executable handle.
+  iree_status_t status = iree_hal_elf_executable_create(
+      executable_params, base_executable_loader->import_provider, cache_path,
       executable_loader->host_allocator, out_executable);
 
   IREE_TRACE_ZONE_END(z0);
@@ -309,4 +436,5 @@ static const iree_hal_executable_loader_vtable_t
         .destroy = iree_hal_embedded_elf_loader_destroy,
         .query_support = iree_hal_embedded_elf_loader_query_support,
         .try_load = iree_hal_embedded_elf_loader_try_load,
+        .try_load_persistent = iree_hal_embedded_elf_loader_try_load_persistent,
 };
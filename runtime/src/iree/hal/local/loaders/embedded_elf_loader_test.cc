@@ -0,0 +1,230 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/local/loaders/embedded_elf_loader.h"
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/hal/local/executable_library.h"
+#include "iree/hal/local/local_executable.h"
+#include "iree/hal/local/local_executable_cache.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+// ELF modules for various platforms embedded in the binary:
+#include "iree/hal/local/elf/testdata/elementwise_mul.h"
+
+namespace {
+
+namespace fs = std::filesystem;
+
+// Returns the ELF for the current architecture or an empty vector if there is
+// none embedded.
+static std::vector<uint8_t> GetArchElfData() {
+  iree_string_view_t pattern = iree_string_view_empty();
+#if defined(IREE_ARCH_ARM_32)
+  pattern = IREE_SV("*_arm_32.so");
+#elif defined(IREE_ARCH_ARM_64)
+  pattern = IREE_SV("*_arm_64.so");
+#elif defined(IREE_ARCH_RISCV_32)
+  pattern = IREE_SV("*_riscv_32.so");
+#elif defined(IREE_ARCH_RISCV_64)
+  pattern = IREE_SV("*_riscv_64.so");
+#elif defined(IREE_ARCH_X86_32)
+  pattern = IREE_SV("*_x86_32.so");
+#elif defined(IREE_ARCH_X86_64)
+  pattern = IREE_SV("*_x86_64.so");
+#endif  // IREE_ARCH_*
+  if (iree_string_view_is_empty(pattern)) return {};
+  for (size_t i = 0; i < elementwise_mul_size(); ++i) {
+    const struct iree_file_toc_t* file_toc = &elementwise_mul_create()[i];
+    if (iree_string_view_match_pattern(iree_make_cstring_view(file_toc->name),
+                                       pattern)) {
+      return std::vector<uint8_t>(file_toc->data,
+                                  file_toc->data + file_toc->size);
+    }
+  }
+  return {};
+}
+
+static std::string ReadFile(const fs::path& path) {
+  std::ifstream stream(path, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(stream),
+                     std::istreambuf_iterator<char>());
+}
+
+static void WriteFile(const fs::path& path, const std::string& contents) {
+  std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+  stream.write(contents.data(), contents.size());
+}
+
+class EmbeddedElfLoaderPersistentTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    elf_data_ = GetArchElfData();
+    if (elf_data_.empty()) {
+      GTEST_SKIP() << "no ELF embedded for the current architecture";
+    }
+
+    const char* test_tmpdir = getenv("TEST_TMPDIR");
+    const char* test_name =
+        ::testing::UnitTest::GetInstance()->current_test_info()->name();
+    cache_dir_ =
+        (test_tmpdir ? fs::path(test_tmpdir) : fs::temp_directory_path()) /
+        (std::string("iree_elf_cache_") + test_name);
+    fs::remove_all(cache_dir_);
+    fs::create_directories(cache_dir_);
+
+    IREE_ASSERT_OK(iree_hal_embedded_elf_loader_create(
+        /*plugin_manager=*/NULL, iree_allocator_system(), &loader_));
+    std::string cache_dir = cache_dir_.string();
+    IREE_ASSERT_OK(iree_hal_local_executable_cache_create_persistent(
+        IREE_SV("cache"), /*worker_capacity=*/1, /*loader_count=*/1,
+        &loader_, iree_make_string_view(cache_dir.data(), cache_dir.size()),
+        iree_allocator_system(), &executable_cache_));
+  }
+
+  void TearDown() override {
+    iree_hal_executable_cache_release(executable_cache_);
+    iree_hal_executable_loader_release(loader_);
+    fs::remove_all(cache_dir_);
+  }
+
+  // Returns all entries in the cache directory.
+  std::vector<fs::path> ListEntries() {
+    std::vector<fs::path> entries;
+    for (const auto& entry : fs::directory_iterator(cache_dir_)) {
+      entries.push_back(entry.path());
+    }
+    return entries;
+  }
+
+  // Prepares |elf_data| with persistent caching allowed and verifies that the
+  // loaded executable computes the expected results.
+  void PrepareAndRun(const std::vector<uint8_t>& elf_data) {
+    iree_hal_executable_params_t params;
+    iree_hal_executable_params_initialize(&params);
+    params.caching_mode =
+        IREE_HAL_EXECUTABLE_CACHING_MODE_ALLOW_PERSISTENT_CACHING;
+    params.executable_format = IREE_SV("embedded-elf-" IREE_ARCH);
+    params.executable_data =
+        iree_make_const_byte_span(elf_data.data(), elf_data.size());
+    iree_hal_executable_t* executable = NULL;
+    IREE_ASSERT_OK(iree_hal_executable_cache_prepare_executable(
+        executable_cache_, &params, &executable));
+
+    // ret0 = arg0 * arg1
+    float arg0[4] = {1.0f, 2.0f, 3.0f, 4.0f};
+    float arg1[4] = {100.0f, 200.0f, 300.0f, 400.0f};
+    float ret0[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    size_t binding_lengths[3] = {sizeof(arg0), sizeof(arg1), sizeof(ret0)};
+    void* binding_ptrs[3] = {arg0, arg1, ret0};
+    iree_hal_executable_dispatch_state_v0_t dispatch_state;
+    memset(&dispatch_state, 0, sizeof(dispatch_state));
+    dispatch_state.workgroup_size_x = 1;
+    dispatch_state.workgroup_size_y = 1;
+    dispatch_state.workgroup_size_z = 1;
+    dispatch_state.workgroup_count_x = 1;
+    dispatch_state.workgroup_count_y = 1;
+    dispatch_state.workgroup_count_z = 1;
+    dispatch_state.max_concurrency = 1;
+    dispatch_state.binding_count = 3;
+    dispatch_state.binding_lengths = binding_lengths;
+    dispatch_state.binding_ptrs = binding_ptrs;
+    iree_hal_executable_workgroup_state_v0_t workgroup_state;
+    memset(&workgroup_state, 0, sizeof(workgroup_state));
+    IREE_EXPECT_OK(iree_hal_local_executable_issue_call(
+        iree_hal_local_executable_cast(executable), /*ordinal=*/0,
+        &dispatch_state, &workgroup_state, /*worker_id=*/0));
+    EXPECT_EQ(100.0f, ret0[0]);
+    EXPECT_EQ(400.0f, ret0[1]);
+    EXPECT_EQ(900.0f, ret0[2]);
+    EXPECT_EQ(1600.0f, ret0[3]);
+
+    iree_hal_executable_release(executable);
+  }
+
+  std::vector<uint8_t> elf_data_;
+  fs::path cache_dir_;
+  iree_hal_executable_loader_t* loader_ = NULL;
+  iree_hal_executable_cache_t* executable_cache_ = NULL;
+};
+
+TEST_F(EmbeddedElfLoaderPersistentTest, MissPopulatesAndHitReuses) {
+  ASSERT_NO_FATAL_FAILURE(PrepareAndRun(elf_data_));
+  std::vector<fs::path> entries = ListEntries();
+  ASSERT_EQ(1, entries.size());
+  const fs::path entry = entries[0];
+  EXPECT_EQ(".ireeimg", entry.extension());
+
+  // Entries are replaced by renaming new files over them: a hard link to the
+  // original entry tells us whether it was rewritten.
+  const fs::path link = cache_dir_ / "original.link";
+  fs::create_hard_link(entry, link);
+  ASSERT_NO_FATAL_FAILURE(PrepareAndRun(elf_data_));
+  EXPECT_TRUE(fs::equivalent(entry, link));
+  EXPECT_EQ(2, ListEntries().size());
+}
+
+TEST_F(EmbeddedElfLoaderPersistentTest, CorruptEntryIsReplacedOnce) {
+  ASSERT_NO_FATAL_FAILURE(PrepareAndRun(elf_data_));
+  std::vector<fs::path> entries = ListEntries();
+  ASSERT_EQ(1, entries.size());
+  const fs::path entry = entries[0];
+  const std::string valid_contents = ReadFile(entry);
+
+  // Flip bytes in the header; the entry must not be used and is replaced.
+  std::string corrupt_contents = valid_contents;
+  for (size_t i = 0; i < 64; ++i) corrupt_contents[i] ^= 0x5A;
+  WriteFile(entry, corrupt_contents);
+  ASSERT_NO_FATAL_FAILURE(PrepareAndRun(elf_data_));
+  EXPECT_EQ(valid_contents, ReadFile(entry));
+
+  // Truncated entries are also replaced.
+  WriteFile(entry, valid_contents.substr(0, valid_contents.size() / 2));
+  ASSERT_NO_FATAL_FAILURE(PrepareAndRun(elf_data_));
+  EXPECT_EQ(valid_contents, ReadFile(entry));
+
+  // The repaired entry is then reused as-is.
+  const fs::path link = cache_dir_ / "repaired.link";
+  fs::create_hard_link(entry, link);
+  ASSERT_NO_FATAL_FAILURE(PrepareAndRun(elf_data_));
+  EXPECT_TRUE(fs::equivalent(entry, link));
+}
+
+TEST_F(EmbeddedElfLoaderPersistentTest, CollidingEntryIsNotUsedOrReplaced) {
+  // A different executable: trailing bytes are ignored by the ELF loader but
+  // change the executable contents.
+  std::vector<uint8_t> other_elf_data = elf_data_;
+  other_elf_data.resize(other_elf_data.size() + 16, 0xCD);
+  ASSERT_NO_FATAL_FAILURE(PrepareAndRun(other_elf_data));
+  std::vector<fs::path> entries = ListEntries();
+  ASSERT_EQ(1, entries.size());
+  const std::string other_contents = ReadFile(entries[0]);
+  fs::remove(entries[0]);
+
+  ASSERT_NO_FATAL_FAILURE(PrepareAndRun(elf_data_));
+  entries = ListEntries();
+  ASSERT_EQ(1, entries.size());
+  const fs::path entry = entries[0];
+
+  // Simulate a key collision by storing the other executable's entry under
+  // this executable's key. It must be detected, bypassed, and left in place.
+  WriteFile(entry, other_contents);
+  const fs::path link = cache_dir_ / "colliding.link";
+  fs::create_hard_link(entry, link);
+  ASSERT_NO_FATAL_FAILURE(PrepareAndRun(elf_data_));
+  EXPECT_TRUE(fs::equivalent(entry, link));
+  EXPECT_EQ(other_contents, ReadFile(entry));
+}
+
+}  // namespace
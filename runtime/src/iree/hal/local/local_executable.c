@@ -7,6 +7,7 @@
 #include "iree/hal/local/local_executable.h"
 
 #include "iree/hal/local/executable_environment.h"
+#include "iree/hal/local/profiling.h"
 
 void iree_hal_local_executable_initialize(
     const iree_hal_local_executable_vtable_t* vtable,
@@ -25,8 +26,10 @@ void iree_hal_local_executable_initialize(
     iree_hal_pipeline_layout_retain(source_pipeline_layouts[i]);
   }
 
-  // Function attributes are optional and populated by the parent type.
+  // Function attributes and names are optional and populated by the parent
+  // type.
   out_base_executable->dispatch_attrs = NULL;
+  out_base_executable->dispatch_names = NULL;
 
   // Default environment with no imports assigned.
   iree_hal_executable_environment_initialize(host_allocator,
@@ -54,10 +57,21 @@ iree_status_t iree_hal_local_executable_issue_call(
   IREE_ASSERT_ARGUMENT(executable);
   IREE_ASSERT_ARGUMENT(dispatch_state);
   IREE_ASSERT_ARGUMENT(workgroup_state);
-  return ((const iree_hal_local_executable_vtable_t*)
-              executable->resource.vtable)
-      ->issue_call(executable, ordinal, dispatch_state, workgroup_state,
-                   worker_id);
+  const iree_hal_local_executable_vtable_t* vtable =
+      (const iree_hal_local_executable_vtable_t*)executable->resource.vtable;
+  iree_hal_local_profiling_sample_t sample;
+  if (IREE_LIKELY(!iree_hal_local_profiling_is_active()) ||
+      !iree_hal_local_profiling_call_begin(&sample)) {
+    return vtable->issue_call(executable, ordinal, dispatch_state,
+                              workgroup_state, worker_id);
+  }
+  iree_status_t status = vtable->issue_call(executable, ordinal, dispatch_state,
+                                            workgroup_state, worker_id);
+  iree_hal_local_profiling_call_end(
+      &sample, executable, ordinal,
+      executable->dispatch_names ? executable->dispatch_names[ordinal] : NULL,
+      worker_id);
+  return status;
 }
 
 iree_status_t iree_hal_local_executable_issue_dispatch_inline(
@@ -35,6 +35,10 @@ typedef struct iree_hal_local_executable_t {
   // of memory required by the function.
   const iree_hal_executable_dispatch_attrs_v0_t* dispatch_attrs;
 
+  // Optional table of export names used to attribute profiling data. Contains
+  // NULL or empty names for exports that have none.
+  const char* const* dispatch_names;
+
   // Execution environment.
   iree_hal_executable_environment_v0_t environment;
 } iree_hal_local_executable_t;
@@ -6,13 +6,17 @@
 
 #include "iree/hal/local/local_executable_cache.h"
 
+#include <inttypes.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdio.h>
 
 typedef struct iree_hal_local_executable_cache_t {
   iree_hal_resource_t resource;
   iree_allocator_t host_allocator;
   iree_string_view_t identifier;
+  // Directory persistent cache entries are stored in or empty if disabled.
+  iree_string_view_t persistent_cache_dir;
   iree_host_size_t worker_capacity;
   iree_host_size_t loader_count;
   iree_hal_executable_loader_t* loaders[];
@@ -32,6 +36,16 @@ iree_status_t iree_hal_local_executable_cache_create(
     iree_host_size_t loader_count, iree_hal_executable_loader_t** loaders,
     iree_allocator_t host_allocator,
     iree_hal_executable_cache_t** out_executable_cache) {
+  return iree_hal_local_executable_cache_create_persistent(
+      identifier, worker_capacity, loader_count, loaders,
+      iree_string_view_empty(), host_allocator, out_executable_cache);
+}
+
+iree_status_t iree_hal_local_executable_cache_create_persistent(
+    iree_string_view_t identifier, iree_host_size_t worker_capacity,
+    iree_host_size_t loader_count, iree_hal_executable_loader_t** loaders,
+    iree_string_view_t persistent_cache_dir, iree_allocator_t host_allocator,
+    iree_hal_executable_cache_t** out_executable_cache) {
   IREE_ASSERT_ARGUMENT(!loader_count || loaders);
   IREE_ASSERT_ARGUMENT(out_executable_cache);
   *out_executable_cache = NULL;
@@ -41,16 +55,21 @@ iree_status_t iree_hal_local_executable_cache_create(
   iree_hal_local_executable_cache_t* executable_cache = NULL;
   iree_host_size_t total_size =
       sizeof(*executable_cache) +
-      loader_count * sizeof(*executable_cache->loaders) + identifier.size;
+      loader_count * sizeof(*executable_cache->loaders) + identifier.size +
+      persistent_cache_dir.size;
   iree_status_t status = iree_allocator_malloc(host_allocator, total_size,
                                                (void**)&executable_cache);
   if (iree_status_is_ok(status)) {
     iree_hal_resource_initialize(&iree_hal_local_executable_cache_vtable,
                                  &executable_cache->resource);
     executable_cache->host_allocator = host_allocator;
+    char* string_storage = (char*)executable_cache + total_size -
+                           identifier.size - persistent_cache_dir.size;
     iree_string_view_append_to_buffer(
-        identifier, &executable_cache->identifier,
-        (char*)executable_cache + total_size - identifier.size);
+        identifier, &executable_cache->identifier, string_storage);
+    iree_string_view_append_to_buffer(
+        persistent_cache_dir, &executable_cache->persistent_cache_dir,
+        string_storage + identifier.size);
     executable_cache->worker_capacity = worker_capacity;
 
     executable_cache->loader_count = loader_count;
@@ -96,12 +115,67 @@ static bool iree_hal_local_executable_cache_can_prepare_format(
   return false;
 }
 
+// Hashes the executable format and contents with 64-bit FNV-1a.
+// This is only used to name persistent cache entries and may collide: loaders
+// must verify that an entry was produced from the same executable contents
+// before using it. The cache directory must be as trusted as the executables
+// themselves.
+static uint64_t iree_hal_local_executable_cache_hash(
+    const iree_hal_executable_params_t* executable_params) {
+  uint64_t hash = 0xCBF29CE484222325ull;
+  for (iree_host_size_t i = 0; i < executable_params->executable_format.size;
+       ++i) {
+    hash ^= (uint8_t)executable_params->executable_format.data[i];
+    hash *= 0x100000001B3ull;
+  }
+  const uint8_t* data = executable_params->executable_data.data;
+  for (iree_host_size_t i = 0;
+       i < executable_params->executable_data.data_length; ++i) {
+    hash ^= data[i];
+    hash *= 0x100000001B3ull;
+  }
+  return hash;
+}
+
+// Formats the persistent cache file path for the given executable into
+// |buffer|. Returns false if persistent caching is not enabled or allowed.
+static bool iree_hal_local_executable_cache_format_persistent_path(
+    iree_hal_local_executable_cache_t* executable_cache,
+    const iree_hal_executable_params_t* executable_params,
+    iree_host_size_t buffer_capacity, char* buffer) {
+  if (iree_string_view_is_empty(executable_cache->persistent_cache_dir) ||
+      !iree_all_bits_set(
+          executable_params->caching_mode,
+          IREE_HAL_EXECUTABLE_CACHING_MODE_ALLOW_PERSISTENT_CACHING) ||
+      !executable_params->executable_data.data_length) {
+    return false;
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+  const uint64_t hash = iree_hal_local_executable_cache_hash(executable_params);
+  int length = snprintf(
+      buffer, buffer_capacity, "%.*s/%016" PRIx64 "-%" PRIx64 ".ireeimg",
+      (int)executable_cache->persistent_cache_dir.size,
+      executable_cache->persistent_cache_dir.data, hash,
+      (uint64_t)executable_params->executable_data.data_length);
+  IREE_TRACE_ZONE_END(z0);
+  return length > 0 && (iree_host_size_t)length < buffer_capacity;
+}
+
 static iree_status_t iree_hal_local_executable_cache_prepare_executable(
     iree_hal_executable_cache_t* base_executable_cache,
     const iree_hal_executable_params_t* executable_params,
     iree_hal_executable_t** out_executable) {
   iree_hal_local_executable_cache_t* executable_cache =
       iree_hal_local_executable_cache_cast(base_executable_cache);
+
+  // If the executable is allowed to be persisted then route the load through
+  // the persistent path so loaders can reuse or populate their cached data.
+  char persistent_path[1024];
+  const bool is_persistent =
+      iree_hal_local_executable_cache_format_persistent_path(
+          executable_cache, executable_params, sizeof(persistent_path),
+          persistent_path);
+
   for (iree_host_size_t i = 0; i < executable_cache->loader_count; ++i) {
     if (!iree_hal_executable_loader_query_support(
             executable_cache->loaders[i], executable_params->caching_mode,
@@ -112,9 +186,15 @@ static iree_status_t iree_hal_local_executable_cache_prepare_executable(
     // The loader _may_ handle the executable; if the specific executable is not
     // supported then the try will fail with IREE_STATUS_CANCELLED and we should
     // continue trying other loaders.
-    iree_status_t status = iree_hal_executable_loader_try_load(
-        executable_cache->loaders[i], executable_params,
-        executable_cache->worker_capacity, out_executable);
+    iree_status_t status =
+        is_persistent
+            ? iree_hal_executable_loader_try_load_persistent(
+                  executable_cache->loaders[i], executable_params,
+                  executable_cache->worker_capacity, persistent_path,
+                  out_executable)
+            : iree_hal_executable_loader_try_load(
+                  executable_cache->loaders[i], executable_params,
+                  executable_cache->worker_capacity, out_executable);
     if (iree_status_is_ok(status)) {
       // Executable was successfully loaded.
       return status;
@@ -29,6 +29,24 @@ iree_status_t iree_hal_local_executable_cache_create(
     iree_allocator_t host_allocator,
     iree_hal_executable_cache_t** out_executable_cache);
 
+// Creates a local executable cache that persists prepared executables in the
+// |persistent_cache_dir| directory across processes. Only executables prepared
+// with IREE_HAL_EXECUTABLE_CACHING_MODE_ALLOW_PERSISTENT_CACHING are persisted
+// and entries are keyed by a hash of the executable format and contents such
+// that multiple programs and processes can share the same directory. What is
+// stored is up to the loaders (see
+// iree_hal_executable_loader_try_load_persistent) but entries must only be
+// used for the exact executable they were produced from as keys may collide.
+// Loaders that do not support persistence load as normal.
+//
+// The directory must exist. An empty |persistent_cache_dir| disables
+// persistence and is equivalent to iree_hal_local_executable_cache_create.
+iree_status_t iree_hal_local_executable_cache_create_persistent(
+    iree_string_view_t identifier, iree_host_size_t worker_capacity,
+    iree_host_size_t loader_count, iree_hal_executable_loader_t** loaders,
+    iree_string_view_t persistent_cache_dir, iree_allocator_t host_allocator,
+    iree_hal_executable_cache_t** out_executable_cache);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
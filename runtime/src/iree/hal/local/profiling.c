@@ -0,0 +1,547 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/local/profiling.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "iree/base/internal/atomics.h"
+#include "iree/base/internal/call_once.h"
+#include "iree/base/internal/synchronization.h"
+
+#if defined(IREE_PLATFORM_LINUX) || defined(IREE_PLATFORM_ANDROID)
+#define IREE_HAL_LOCAL_PROFILING_HAVE_PERF_EVENT 1
+#include <errno.h>
+#include <linux/perf_event.h>
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif  // IREE_PLATFORM_LINUX || IREE_PLATFORM_ANDROID
+
+#define IREE_HAL_LOCAL_PROFILING_DEFAULT_FILE_PATH "iree-dispatch-counters.csv"
+
+// Checked on every executable call; see iree_hal_local_profiling_is_active.
+iree_atomic_int64_t iree_hal_local_profiling_session_id = 0;
+
+#if defined(IREE_HAL_LOCAL_PROFILING_HAVE_PERF_EVENT)
+
+//===----------------------------------------------------------------------===//
+// Per-thread counters
+//===----------------------------------------------------------------------===//
+
+typedef enum iree_hal_local_profiling_counter_e {
+  IREE_HAL_LOCAL_PROFILING_COUNTER_CYCLES = 0,
+  IREE_HAL_LOCAL_PROFILING_COUNTER_INSTRUCTIONS,
+  IREE_HAL_LOCAL_PROFILING_COUNTER_CACHE_MISSES,
+  IREE_HAL_LOCAL_PROFILING_COUNTER_COUNT,
+} iree_hal_local_profiling_counter_t;
+
+// perf_event PERF_TYPE_HARDWARE config of each counter.
+static const uint64_t iree_hal_local_profiling_counter_configs[] = {
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES,
+};
+
+// Layout of a PERF_FORMAT_GROUP read with the total times enabled and running:
+//   nr, time_enabled, time_running, value[nr]
+#define IREE_HAL_LOCAL_PROFILING_GROUP_TIME_ENABLED 1
+#define IREE_HAL_LOCAL_PROFILING_GROUP_TIME_RUNNING 2
+#define IREE_HAL_LOCAL_PROFILING_GROUP_VALUES 3
+static_assert(sizeof(((iree_hal_local_profiling_sample_t*)0)->values) >=
+                  (IREE_HAL_LOCAL_PROFILING_GROUP_VALUES +
+                   IREE_HAL_LOCAL_PROFILING_COUNTER_COUNT) *
+                      sizeof(uint64_t),
+              "sample too small for the counter group");
+
+// Counts of one export on one thread aggregated since the last flush.
+typedef struct iree_hal_local_profiling_entry_t {
+  struct iree_hal_local_profiling_entry_t* next;
+  // The export name pointer is part of the key as executables may be freed and
+  // their address reused while the session is active.
+  const void* executable;
+  iree_host_size_t ordinal;
+  const char* export_name;
+  uint64_t call_count;
+  int64_t duration_ns;
+  double counters[IREE_HAL_LOCAL_PROFILING_COUNTER_COUNT];
+  // Copy of the export name as the executable may not outlive the session.
+  char name[];
+} iree_hal_local_profiling_entry_t;
+
+// Counters and aggregated counts of a thread issuing executable calls.
+// Created on the first call a thread issues while a session is active and
+// kept until the thread exits so that the counters need only be opened once
+// per session. All state is allocated with the system allocator as it outlives
+// sessions.
+typedef struct iree_hal_local_profiling_thread_t {
+  // Next in the global thread list.
+  struct iree_hal_local_profiling_thread_t* next;
+  uint64_t thread_id;
+
+  // Guards everything below. Only contended when a session is flushed.
+  iree_slim_mutex_t mutex;
+
+  // Session the counters and entries belong to or 0 if none.
+  uint64_t session_id;
+  // Worker ID of the first call issued on the thread in the session.
+  uint32_t worker_id;
+
+  // perf_event group leader fd or -1 if no counter could be opened.
+  int group_fd;
+  // perf_event fds of each counter or -1 if the counter could not be opened.
+  int fds[IREE_HAL_LOCAL_PROFILING_COUNTER_COUNT];
+  // Index of each counter within the group read values, if opened.
+  int value_indices[IREE_HAL_LOCAL_PROFILING_COUNTER_COUNT];
+
+  iree_hal_local_profiling_entry_t* entry_head;
+  // Most recently used entry as consecutive calls are usually workgroups of
+  // the same dispatch.
+  iree_hal_local_profiling_entry_t* last_entry;
+} iree_hal_local_profiling_thread_t;
+
+struct iree_hal_local_profiling_session_t {
+  iree_allocator_t host_allocator;
+  uint64_t id;
+  FILE* file;
+  uint32_t flush_count;
+};
+
+// Process-wide profiling state.
+static struct {
+  // Guards everything below and changes to the active session ID.
+  iree_slim_mutex_t mutex;
+  uint64_t next_session_id;
+  iree_hal_local_profiling_session_t* session;
+  // All threads with profiling state.
+  iree_hal_local_profiling_thread_t* thread_head;
+  // Key of the calling thread state, destroyed when the thread exits.
+  pthread_key_t thread_key;
+} iree_hal_local_profiling_state;
+static iree_once_flag iree_hal_local_profiling_state_once = IREE_ONCE_FLAG_INIT;
+
+// Closes the counters of |thread| and frees its entries, then opens new
+// counters if |session_id| is not 0. Must be called with the thread mutex held
+// and only on the thread itself when opening counters as perf events count
+// the thread that opens them.
+static void iree_hal_local_profiling_thread_reset(
+    iree_hal_local_profiling_thread_t* thread, uint64_t session_id) {
+  for (int i = 0; i < IREE_HAL_LOCAL_PROFILING_COUNTER_COUNT; ++i) {
+    if (thread->fds[i] >= 0) close(thread->fds[i]);
+    thread->fds[i] = -1;
+    thread->value_indices[i] = -1;
+  }
+  thread->group_fd = -1;
+  while (thread->entry_head) {
+    iree_hal_local_profiling_entry_t* entry = thread->entry_head;
+    thread->entry_head = entry->next;
+    iree_allocator_free(iree_allocator_system(), entry);
+  }
+  thread->last_entry = NULL;
+  thread->session_id = session_id;
+  thread->worker_id = UINT32_MAX;
+  if (!session_id) return;
+
+  // Counters that fail to open (unsupported by the CPU or virtualized away, or
+  // denied by perf_event_paranoid) are left out. The rest are read as a group
+  // so that they are scheduled together and sampled with one system call.
+  int value_count = 0;
+  for (int i = 0; i < IREE_HAL_LOCAL_PROFILING_COUNTER_COUNT; ++i) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = iree_hal_local_profiling_counter_configs[i];
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED |
+                       PERF_FORMAT_TOTAL_TIME_RUNNING;
+    int fd = (int)syscall(SYS_perf_event_open, &attr, /*pid=*/0, /*cpu=*/-1,
+                          thread->group_fd, /*flags=*/0);
+    if (fd < 0) continue;
+    if (thread->group_fd < 0) thread->group_fd = fd;
+    thread->fds[i] = fd;
+    thread->value_indices[i] = value_count++;
+  }
+}
+
+// Reads the counter group of |thread| into |values|, zeroing them if there
+// are no counters. Must be called with the thread mutex held.
+static void iree_hal_local_profiling_thread_read(
+    iree_hal_local_profiling_thread_t* thread, uint64_t* values,
+    iree_host_size_t value_capacity) {
+  memset(values, 0, value_capacity * sizeof(*values));
+  if (thread->group_fd < 0) return;
+  if (read(thread->group_fd, values, value_capacity * sizeof(*values)) < 0) {
+    memset(values, 0, value_capacity * sizeof(*values));
+  }
+}
+
+static void iree_hal_local_profiling_thread_destroy(void* user_data) {
+  iree_hal_local_profiling_thread_t* thread =
+      (iree_hal_local_profiling_thread_t*)user_data;
+  iree_slim_mutex_lock(&iree_hal_local_profiling_state.mutex);
+  iree_hal_local_profiling_thread_t** thread_ptr =
+      &iree_hal_local_profiling_state.thread_head;
+  while (*thread_ptr != thread) thread_ptr = &(*thread_ptr)->next;
+  *thread_ptr = thread->next;
+  iree_slim_mutex_unlock(&iree_hal_local_profiling_state.mutex);
+
+  iree_slim_mutex_lock(&thread->mutex);
+  iree_hal_local_profiling_thread_reset(thread, 0);
+  iree_slim_mutex_unlock(&thread->mutex);
+  iree_slim_mutex_deinitialize(&thread->mutex);
+  iree_allocator_free(iree_allocator_system(), thread);
+}
+
+static void iree_hal_local_profiling_state_initialize(void) {
+  iree_slim_mutex_initialize(&iree_hal_local_profiling_state.mutex);
+  pthread_key_create(&iree_hal_local_profiling_state.thread_key,
+                     iree_hal_local_profiling_thread_destroy);
+}
+
+// Returns the profiling state of the calling thread, creating it if needed.
+static iree_hal_local_profiling_thread_t*
+iree_hal_local_profiling_thread_acquire(void) {
+  iree_hal_local_profiling_thread_t* thread =
+      (iree_hal_local_profiling_thread_t*)pthread_getspecific(
+          iree_hal_local_profiling_state.thread_key);
+  if (IREE_LIKELY(thread)) return thread;
+
+  iree_status_t status = iree_allocator_malloc(
+      iree_allocator_system(), sizeof(*thread), (void**)&thread);
+  if (!iree_status_is_ok(status)) {
+    iree_status_ignore(status);
+    return NULL;
+  }
+  memset(thread, 0, sizeof(*thread));
+  thread->thread_id = (uint64_t)syscall(SYS_gettid);
+  iree_slim_mutex_initialize(&thread->mutex);
+  thread->group_fd = -1;
+  for (int i = 0; i < IREE_HAL_LOCAL_PROFILING_COUNTER_COUNT; ++i) {
+    thread->fds[i] = -1;
+    thread->value_indices[i] = -1;
+  }
+  pthread_setspecific(iree_hal_local_profiling_state.thread_key, thread);
+
+  iree_slim_mutex_lock(&iree_hal_local_profiling_state.mutex);
+  thread->next = iree_hal_local_profiling_state.thread_head;
+  iree_hal_local_profiling_state.thread_head = thread;
+  iree_slim_mutex_unlock(&iree_hal_local_profiling_state.mutex);
+  return thread;
+}
+
+// Returns the entry of export |ordinal| of |executable| on |thread|, creating
+// it if needed, or NULL if out of memory. Must be called with the thread mutex
+// held.
+static iree_hal_local_profiling_entry_t*
+iree_hal_local_profiling_thread_lookup_entry(
+    iree_hal_local_profiling_thread_t* thread, const void* executable,
+    iree_host_size_t ordinal, const char* export_name) {
+  iree_hal_local_profiling_entry_t* entry = thread->last_entry;
+  if (entry && entry->executable == executable && entry->ordinal == ordinal &&
+      entry->export_name == export_name) {
+    return entry;
+  }
+  for (entry = thread->entry_head; entry; entry = entry->next) {
+    if (entry->executable == executable && entry->ordinal == ordinal &&
+        entry->export_name == export_name) {
+      thread->last_entry = entry;
+      return entry;
+    }
+  }
+
+  // Exports without names are identified by their ordinal and executable.
+  char unnamed_name[64];
+  const char* name = export_name;
+  if (!name || !name[0]) {
+    snprintf(unnamed_name, sizeof(unnamed_name),
+             "executable_%p_export_%" PRIhsz, executable, ordinal);
+    name = unnamed_name;
+  }
+  iree_host_size_t name_length = strlen(name);
+  iree_status_t status =
+      iree_allocator_malloc(iree_allocator_system(),
+                            sizeof(*entry) + name_length + 1, (void**)&entry);
+  if (!iree_status_is_ok(status)) {
+    iree_status_ignore(status);
+    return NULL;
+  }
+  memset(entry, 0, sizeof(*entry));
+  entry->executable = executable;
+  entry->ordinal = ordinal;
+  entry->export_name = export_name;
+  memcpy(entry->name, name, name_length + 1);
+  entry->next = thread->entry_head;
+  thread->entry_head = entry;
+  thread->last_entry = entry;
+  return entry;
+}
+
+//===----------------------------------------------------------------------===//
+// iree_hal_local_profiling_session_t
+//===----------------------------------------------------------------------===//
+
+iree_status_t iree_hal_local_profiling_session_begin(
+    const iree_hal_device_profiling_options_t* options,
+    iree_allocator_t host_allocator,
+    iree_hal_local_profiling_session_t** out_session) {
+  IREE_ASSERT_ARGUMENT(options);
+  IREE_ASSERT_ARGUMENT(out_session);
+  *out_session = NULL;
+  if (!iree_all_bits_set(options->mode,
+                         IREE_HAL_DEVICE_PROFILING_MODE_DISPATCH_COUNTERS)) {
+    return iree_ok_status();
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_call_once(&iree_hal_local_profiling_state_once,
+                 iree_hal_local_profiling_state_initialize);
+
+  iree_hal_local_profiling_session_t* session = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(host_allocator, sizeof(*session),
+                                (void**)&session));
+  memset(session, 0, sizeof(*session));
+  session->host_allocator = host_allocator;
+
+  const char* file_path = options->file_path && options->file_path[0]
+                              ? options->file_path
+                              : IREE_HAL_LOCAL_PROFILING_DEFAULT_FILE_PATH;
+  session->file = fopen(file_path, "w");
+  if (!session->file) {
+    iree_allocator_free(host_allocator, session);
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(iree_status_code_from_errno(errno),
+                            "failed to open profile file '%s'", file_path);
+  }
+  fprintf(session->file,
+          "flush,thread_id,worker_id,dispatch,workgroups,time_ns,cycles,"
+          "instructions,cache_misses\n");
+
+  iree_slim_mutex_lock(&iree_hal_local_profiling_state.mutex);
+  const bool is_active = iree_hal_local_profiling_state.session != NULL;
+  if (!is_active) {
+    session->id = ++iree_hal_local_profiling_state.next_session_id;
+    iree_hal_local_profiling_state.session = session;
+    iree_atomic_store_int64(&iree_hal_local_profiling_session_id,
+                            (int64_t)session->id, iree_memory_order_release);
+  }
+  iree_slim_mutex_unlock(&iree_hal_local_profiling_state.mutex);
+  if (is_active) {
+    fclose(session->file);
+    iree_allocator_free(host_allocator, session);
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                            "a local device profiling session is already "
+                            "active in the process");
+  }
+
+  *out_session = session;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+// Writes the entry counts of |thread| to the |session| file and resets them.
+// Must be called with the thread mutex held.
+static void iree_hal_local_profiling_session_write_thread(
+    iree_hal_local_profiling_session_t* session,
+    iree_hal_local_profiling_thread_t* thread) {
+  for (iree_hal_local_profiling_entry_t* entry = thread->entry_head; entry;
+       entry = entry->next) {
+    if (!entry->call_count) continue;
+    fprintf(session->file, "%u,%" PRIu64 ",%u,%s,%" PRIu64 ",%" PRId64,
+            session->flush_count, thread->thread_id, thread->worker_id,
+            entry->name, entry->call_count, entry->duration_ns);
+    for (int i = 0; i < IREE_HAL_LOCAL_PROFILING_COUNTER_COUNT; ++i) {
+      if (thread->value_indices[i] >= 0) {
+        fprintf(session->file, ",%.0f", entry->counters[i]);
+      } else {
+        fprintf(session->file, ",");
+      }
+    }
+    fprintf(session->file, "\n");
+    entry->call_count = 0;
+    entry->duration_ns = 0;
+    memset(entry->counters, 0, sizeof(entry->counters));
+  }
+}
+
+iree_status_t iree_hal_local_profiling_session_flush(
+    iree_hal_local_profiling_session_t* session) {
+  if (!session) return iree_ok_status();
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_slim_mutex_lock(&iree_hal_local_profiling_state.mutex);
+  for (iree_hal_local_profiling_thread_t* thread =
+           iree_hal_local_profiling_state.thread_head;
+       thread; thread = thread->next) {
+    iree_slim_mutex_lock(&thread->mutex);
+    if (thread->session_id == session->id) {
+      iree_hal_local_profiling_session_write_thread(session, thread);
+    }
+    iree_slim_mutex_unlock(&thread->mutex);
+  }
+  iree_slim_mutex_unlock(&iree_hal_local_profiling_state.mutex);
+  ++session->flush_count;
+
+  iree_status_t status = iree_ok_status();
+  if (fflush(session->file) != 0) {
+    status = iree_make_status(iree_status_code_from_errno(errno),
+                              "failed to write profile file");
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+iree_status_t iree_hal_local_profiling_session_end(
+    iree_hal_local_profiling_session_t* session) {
+  if (!session) return iree_ok_status();
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_status_t status = iree_hal_local_profiling_session_flush(session);
+
+  // Stop new calls from sampling and release the counters of all threads.
+  // Threads reopen their counters on their first call in the next session.
+  iree_slim_mutex_lock(&iree_hal_local_profiling_state.mutex);
+  iree_atomic_store_int64(&iree_hal_local_profiling_session_id, 0,
+                          iree_memory_order_release);
+  iree_hal_local_profiling_state.session = NULL;
+  for (iree_hal_local_profiling_thread_t* thread =
+           iree_hal_local_profiling_state.thread_head;
+       thread; thread = thread->next) {
+    iree_slim_mutex_lock(&thread->mutex);
+    if (thread->session_id == session->id) {
+      iree_hal_local_profiling_thread_reset(thread, 0);
+    }
+    iree_slim_mutex_unlock(&thread->mutex);
+  }
+  iree_slim_mutex_unlock(&iree_hal_local_profiling_state.mutex);
+
+  if (fclose(session->file) != 0 && iree_status_is_ok(status)) {
+    status = iree_make_status(iree_status_code_from_errno(errno),
+                              "failed to close profile file");
+  }
+  iree_allocator_free(session->host_allocator, session);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+//===----------------------------------------------------------------------===//
+// Executable call instrumentation
+//===----------------------------------------------------------------------===//
+
+bool iree_hal_local_profiling_call_begin(
+    iree_hal_local_profiling_sample_t* out_sample) {
+  // The state is only initialized by the first session so a session ID can
+  // only be observed once it has been.
+  uint64_t session_id = (uint64_t)iree_atomic_load_int64(
+      &iree_hal_local_profiling_session_id, iree_memory_order_acquire);
+  if (IREE_LIKELY(!session_id)) return false;
+
+  iree_hal_local_profiling_thread_t* thread =
+      iree_hal_local_profiling_thread_acquire();
+  if (!thread) return false;
+  out_sample->session_id = session_id;
+  out_sample->thread = thread;
+
+  iree_slim_mutex_lock(&thread->mutex);
+  if (thread->session_id != session_id) {
+    iree_hal_local_profiling_thread_reset(thread, session_id);
+  }
+  iree_hal_local_profiling_thread_read(thread, out_sample->values,
+                                       IREE_ARRAYSIZE(out_sample->values));
+  iree_slim_mutex_unlock(&thread->mutex);
+
+  out_sample->start_ns = iree_time_now();
+  return true;
+}
+
+void iree_hal_local_profiling_call_end(
+    const iree_hal_local_profiling_sample_t* sample, const void* executable,
+    iree_host_size_t ordinal, const char* export_name, uint32_t worker_id) {
+  iree_time_t end_ns = iree_time_now();
+  iree_hal_local_profiling_thread_t* thread =
+      (iree_hal_local_profiling_thread_t*)sample->thread;
+
+  iree_slim_mutex_lock(&thread->mutex);
+  // Calls spanning the end of the session are dropped.
+  if (thread->session_id != sample->session_id) {
+    iree_slim_mutex_unlock(&thread->mutex);
+    return;
+  }
+  uint64_t values[IREE_ARRAYSIZE(sample->values)];
+  iree_hal_local_profiling_thread_read(thread, values,
+                                       IREE_ARRAYSIZE(values));
+  iree_hal_local_profiling_entry_t* entry =
+      iree_hal_local_profiling_thread_lookup_entry(thread, executable, ordinal,
+                                                   export_name);
+  if (entry) {
+    if (thread->worker_id == UINT32_MAX) thread->worker_id = worker_id;
+    ++entry->call_count;
+    entry->duration_ns += end_ns - sample->start_ns;
+
+    // The kernel multiplexes counter groups when there are more events than
+    // hardware counters and the counts are scaled up by the fraction of the
+    // call the group was actually counting.
+    uint64_t time_enabled =
+        values[IREE_HAL_LOCAL_PROFILING_GROUP_TIME_ENABLED] -
+        sample->values[IREE_HAL_LOCAL_PROFILING_GROUP_TIME_ENABLED];
+    uint64_t time_running =
+        values[IREE_HAL_LOCAL_PROFILING_GROUP_TIME_RUNNING] -
+        sample->values[IREE_HAL_LOCAL_PROFILING_GROUP_TIME_RUNNING];
+    if (time_running) {
+      double scale = (double)time_enabled / (double)time_running;
+      for (int i = 0; i < IREE_HAL_LOCAL_PROFILING_COUNTER_COUNT; ++i) {
+        int value_index = thread->value_indices[i];
+        if (value_index < 0) continue;
+        value_index += IREE_HAL_LOCAL_PROFILING_GROUP_VALUES;
+        entry->counters[i] +=
+            scale * (double)(values[value_index] - sample->values[value_index]);
+      }
+    }
+  }
+  iree_slim_mutex_unlock(&thread->mutex);
+}
+
+#else
+
+iree_status_t iree_hal_local_profiling_session_begin(
+    const iree_hal_device_profiling_options_t* options,
+    iree_allocator_t host_allocator,
+    iree_hal_local_profiling_session_t** out_session) {
+  IREE_ASSERT_ARGUMENT(options);
+  IREE_ASSERT_ARGUMENT(out_session);
+  *out_session = NULL;
+  if (iree_all_bits_set(options->mode,
+                        IREE_HAL_DEVICE_PROFILING_MODE_DISPATCH_COUNTERS)) {
+    return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                            "dispatch counters require perf_event_open and "
+                            "are only available on Linux and Android");
+  }
+  return iree_ok_status();
+}
+
+iree_status_t iree_hal_local_profiling_session_flush(
+    iree_hal_local_profiling_session_t* session) {
+  return iree_ok_status();
+}
+
+iree_status_t iree_hal_local_profiling_session_end(
+    iree_hal_local_profiling_session_t* session) {
+  return iree_ok_status();
+}
+
+bool iree_hal_local_profiling_call_begin(
+    iree_hal_local_profiling_sample_t* out_sample) {
+  return false;
+}
+
+void iree_hal_local_profiling_call_end(
+    const iree_hal_local_profiling_sample_t* sample, const void* executable,
+    iree_host_size_t ordinal, const char* export_name, uint32_t worker_id) {}
+
+#endif  // IREE_HAL_LOCAL_PROFILING_HAVE_PERF_EVENT
@@ -0,0 +1,109 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_LOCAL_PROFILING_H_
+#define IREE_HAL_LOCAL_PROFILING_H_
+
+#include "iree/base/api.h"
+#include "iree/base/internal/atomics.h"
+#include "iree/hal/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+//===----------------------------------------------------------------------===//
+// iree_hal_local_profiling_session_t
+//===----------------------------------------------------------------------===//
+
+// A dispatch profiling session shared by the local devices.
+//
+// With IREE_HAL_DEVICE_PROFILING_MODE_DISPATCH_COUNTERS each thread issuing
+// executable calls (task workers, or callers of synchronous devices) counts
+// CPU cycles, retired instructions and last-level cache misses with Linux
+// perf_event_open along with wall time. Counts are aggregated per export and
+// thread and appended to the session file on each flush as CSV lines:
+//   flush,thread_id,worker_id,dispatch,workgroups,time_ns,cycles,
+//   instructions,cache_misses
+// where dispatch is the export name reported by the executable library and
+// counters that could not be opened on a thread are left empty. Reading the
+// counters costs a system call before and after each workgroup.
+//
+// Hardware counters are per-thread and workers may be shared across devices so
+// only one session may be active in the process at a time and it profiles all
+// local devices.
+typedef struct iree_hal_local_profiling_session_t
+    iree_hal_local_profiling_session_t;
+
+// Begins a profiling session as configured by |options|. |out_session| is set
+// to NULL if none of the requested modes are supported by the local devices.
+// The session writes to |options|.file_path, defaulting to
+// `iree-dispatch-counters.csv` in the working directory.
+//
+// Returns IREE_STATUS_FAILED_PRECONDITION if another session is active and
+// IREE_STATUS_UNAVAILABLE if dispatch counters are requested on a platform
+// without perf_event_open.
+iree_status_t iree_hal_local_profiling_session_begin(
+    const iree_hal_device_profiling_options_t* options,
+    iree_allocator_t host_allocator,
+    iree_hal_local_profiling_session_t** out_session);
+
+// Appends the counts aggregated since the last flush to the session file.
+// |session| may be NULL.
+iree_status_t iree_hal_local_profiling_session_flush(
+    iree_hal_local_profiling_session_t* session);
+
+// Flushes and ends |session|, closing its file and counters. |session| may be
+// NULL. All devices must be idle.
+iree_status_t iree_hal_local_profiling_session_end(
+    iree_hal_local_profiling_session_t* session);
+
+//===----------------------------------------------------------------------===//
+// Executable call instrumentation
+//===----------------------------------------------------------------------===//
+
+// ID of the active session or 0 if none.
+extern iree_atomic_int64_t iree_hal_local_profiling_session_id;
+
+// Returns true if a session may be active. Inlined into callers as a single
+// relaxed atomic load so that executable calls cost no more than that when not
+// profiling. iree_hal_local_profiling_call_begin makes the final decision.
+static inline bool iree_hal_local_profiling_is_active(void) {
+  return iree_atomic_load_int64(&iree_hal_local_profiling_session_id,
+                                iree_memory_order_relaxed) != 0;
+}
+
+// Counter values sampled before an executable call.
+typedef struct iree_hal_local_profiling_sample_t {
+  // Session that was active when sampled.
+  uint64_t session_id;
+  // Opaque per-thread counter state.
+  void* thread;
+  iree_time_t start_ns;
+  // Raw perf_event group read; see profiling.c.
+  uint64_t values[6];
+} iree_hal_local_profiling_sample_t;
+
+// Returns true and samples the calling thread's counters into |out_sample| if
+// a session is active. Callers must then call
+// iree_hal_local_profiling_call_end once the call has completed. Callers
+// should check iree_hal_local_profiling_is_active first to avoid the function
+// call when not profiling.
+bool iree_hal_local_profiling_call_begin(
+    iree_hal_local_profiling_sample_t* out_sample);
+
+// Accumulates the counters of a call of export |ordinal| of |executable|
+// issued on |worker_id| since |sample| was taken. |export_name| is the name of
+// the export, if known, and must remain valid for the duration of the call.
+void iree_hal_local_profiling_call_end(
+    const iree_hal_local_profiling_sample_t* sample, const void* executable,
+    iree_host_size_t ordinal, const char* export_name, uint32_t worker_id);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_LOCAL_PROFILING_H_
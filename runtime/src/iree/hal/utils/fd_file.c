@@ -0,0 +1,604 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/utils/fd_file.h"
+
+#if defined(IREE_PLATFORM_ANDROID) || defined(IREE_PLATFORM_APPLE) || \
+    defined(IREE_PLATFORM_LINUX)
+#define IREE_HAL_FD_FILE_SUPPORTED 1
+#include <errno.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#define IREE_HAL_FD_FILE_SUPPORTED 0
+#endif  // IREE_PLATFORM_*
+
+//===----------------------------------------------------------------------===//
+// Configuration
+//===----------------------------------------------------------------------===//
+
+#if !defined(IREE_HAL_FD_FILE_IO_URING)
+// When 1 io_uring will be used (if available at runtime) to keep multiple
+// block reads/writes in flight. Requires Linux kernel headers.
+#if defined(IREE_PLATFORM_LINUX) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define IREE_HAL_FD_FILE_IO_URING 1
+#endif  // __has_include(<linux/io_uring.h>)
+#endif  // IREE_PLATFORM_LINUX && __has_include
+#endif  // !IREE_HAL_FD_FILE_IO_URING
+#if !defined(IREE_HAL_FD_FILE_IO_URING)
+#define IREE_HAL_FD_FILE_IO_URING 0
+#endif  // !IREE_HAL_FD_FILE_IO_URING
+
+#if !defined(IREE_HAL_FD_FILE_BLOCK_SIZE)
+// Size in bytes of each individual read/write issued to the kernel. Smaller
+// blocks allow for more concurrency within the storage device at the cost of
+// more per-request overhead.
+#define IREE_HAL_FD_FILE_BLOCK_SIZE (1 * 1024 * 1024)
+#endif  // !IREE_HAL_FD_FILE_BLOCK_SIZE
+
+#if !defined(IREE_HAL_FD_FILE_QUEUE_DEPTH)
+// Maximum number of blocks in flight at a time. Must be a power of two.
+#define IREE_HAL_FD_FILE_QUEUE_DEPTH 32
+#endif  // !IREE_HAL_FD_FILE_QUEUE_DEPTH
+
+#if IREE_HAL_FD_FILE_IO_URING
+#include <linux/io_uring.h>
+#include <sched.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+
+#include "iree/base/internal/synchronization.h"
+#if !defined(__NR_io_uring_setup) || !defined(__NR_io_uring_enter) || \
+    !defined(__NR_io_uring_register)
+#undef IREE_HAL_FD_FILE_IO_URING
+#define IREE_HAL_FD_FILE_IO_URING 0
+#endif  // __NR_io_uring_*
+#endif  // IREE_HAL_FD_FILE_IO_URING
+
+#if IREE_HAL_FD_FILE_SUPPORTED
+
+//===----------------------------------------------------------------------===//
+// Synchronous positional I/O
+//===----------------------------------------------------------------------===//
+
+// Reads or writes |contents| from/to |fd| at |file_offset| with positional I/O.
+// Blocks until the entire range has been transferred.
+static iree_status_t iree_hal_fd_file_transfer_sync(int fd, bool is_read,
+                                                    uint64_t file_offset,
+                                                    iree_byte_span_t contents) {
+  uint8_t* data = contents.data;
+  iree_host_size_t remaining = contents.data_length;
+  while (remaining > 0) {
+    ssize_t ret =
+        is_read ? pread(fd, data, remaining, (off_t)file_offset)
+                : pwrite(fd, data, remaining, (off_t)file_offset);
+    if (ret < 0) {
+      if (errno == EINTR) continue;
+      return iree_make_status(iree_status_code_from_errno(errno),
+                              "file %s failed at offset %" PRIu64,
+                              is_read ? "read" : "write", file_offset);
+    } else if (ret == 0) {
+      return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                              "unexpected end of file at offset %" PRIu64,
+                              file_offset);
+    }
+    data += ret;
+    remaining -= (iree_host_size_t)ret;
+    file_offset += (uint64_t)ret;
+  }
+  return iree_ok_status();
+}
+
+//===----------------------------------------------------------------------===//
+// iree_hal_fd_file_ring_t
+//===----------------------------------------------------------------------===//
+
+#if IREE_HAL_FD_FILE_IO_URING
+
+// A minimal io_uring submission/completion ring.
+// We issue the syscalls directly instead of depending on liburing as we only
+// need a tiny fraction of its functionality: batches of reads/writes that we
+// submit and then reap before returning.
+typedef struct iree_hal_fd_file_ring_t {
+  // Ring file descriptor or -1 if the ring could not be created.
+  int ring_fd;
+  // Total number of submission queue entries available.
+  uint32_t sq_entries;
+
+  // Mapped ring memory. The completion ring may alias the submission ring if
+  // the kernel supports IORING_FEAT_SINGLE_MMAP.
+  void* sq_ring_ptr;
+  iree_host_size_t sq_ring_size;
+  void* cq_ring_ptr;
+  iree_host_size_t cq_ring_size;
+  struct io_uring_sqe* sqes;
+  iree_host_size_t sqes_size;
+
+  // Pointers into the shared ring memory.
+  unsigned* sq_head;
+  unsigned* sq_tail;
+  unsigned* sq_mask;
+  unsigned* sq_array;
+  unsigned* cq_head;
+  unsigned* cq_tail;
+  unsigned* cq_mask;
+  struct io_uring_cqe* cqes;
+} iree_hal_fd_file_ring_t;
+
+static void iree_hal_fd_file_ring_deinitialize(iree_hal_fd_file_ring_t* ring) {
+  if (ring->sqes) munmap(ring->sqes, ring->sqes_size);
+  if (ring->cq_ring_ptr && ring->cq_ring_ptr != ring->sq_ring_ptr) {
+    munmap(ring->cq_ring_ptr, ring->cq_ring_size);
+  }
+  if (ring->sq_ring_ptr) munmap(ring->sq_ring_ptr, ring->sq_ring_size);
+  if (ring->ring_fd >= 0) close(ring->ring_fd);
+  memset(ring, 0, sizeof(*ring));
+  ring->ring_fd = -1;
+}
+
+// Initializes |out_ring| with |entries| submission queue entries.
+// On failure the ring will have a ring_fd of -1 and callers should fall back to
+// synchronous I/O. Failure is common as io_uring may be disabled by the kernel
+// configuration or sandbox policy.
+static iree_status_t iree_hal_fd_file_ring_initialize(
+    uint32_t entries, iree_hal_fd_file_ring_t* out_ring) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  memset(out_ring, 0, sizeof(*out_ring));
+  out_ring->ring_fd = -1;
+
+  struct io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  int ring_fd = (int)syscall(__NR_io_uring_setup, entries, &params);
+  if (ring_fd < 0) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(iree_status_code_from_errno(errno),
+                            "io_uring_setup failed");
+  }
+  out_ring->ring_fd = ring_fd;
+  out_ring->sq_entries = params.sq_entries;
+
+  out_ring->sq_ring_size =
+      params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  out_ring->cq_ring_size =
+      params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+  const bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+  if (single_mmap) {
+    out_ring->sq_ring_size =
+        iree_max(out_ring->sq_ring_size, out_ring->cq_ring_size);
+    out_ring->cq_ring_size = out_ring->sq_ring_size;
+  }
+
+  iree_status_t status = iree_ok_status();
+  void* sq_ring_ptr =
+      mmap(NULL, out_ring->sq_ring_size, PROT_READ | PROT_WRITE,
+           MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQ_RING);
+  if (sq_ring_ptr == MAP_FAILED) {
+    status = iree_make_status(iree_status_code_from_errno(errno),
+                              "io_uring submission ring mmap failed");
+  } else {
+    out_ring->sq_ring_ptr = sq_ring_ptr;
+  }
+
+  if (iree_status_is_ok(status)) {
+    if (single_mmap) {
+      out_ring->cq_ring_ptr = out_ring->sq_ring_ptr;
+    } else {
+      void* cq_ring_ptr =
+          mmap(NULL, out_ring->cq_ring_size, PROT_READ | PROT_WRITE,
+               MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_CQ_RING);
+      if (cq_ring_ptr == MAP_FAILED) {
+        status = iree_make_status(iree_status_code_from_errno(errno),
+                                  "io_uring completion ring mmap failed");
+      } else {
+        out_ring->cq_ring_ptr = cq_ring_ptr;
+      }
+    }
+  }
+
+  if (iree_status_is_ok(status)) {
+    out_ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    void* sqes = mmap(NULL, out_ring->sqes_size, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+      status = iree_make_status(iree_status_code_from_errno(errno),
+                                "io_uring submission entries mmap failed");
+    } else {
+      out_ring->sqes = (struct io_uring_sqe*)sqes;
+    }
+  }
+
+  if (iree_status_is_ok(status)) {
+    uint8_t* sq_base = (uint8_t*)out_ring->sq_ring_ptr;
+    out_ring->sq_head = (unsigned*)(sq_base + params.sq_off.head);
+    out_ring->sq_tail = (unsigned*)(sq_base + params.sq_off.tail);
+    out_ring->sq_mask = (unsigned*)(sq_base + params.sq_off.ring_mask);
+    out_ring->sq_array = (unsigned*)(sq_base + params.sq_off.array);
+    uint8_t* cq_base = (uint8_t*)out_ring->cq_ring_ptr;
+    out_ring->cq_head = (unsigned*)(cq_base + params.cq_off.head);
+    out_ring->cq_tail = (unsigned*)(cq_base + params.cq_off.tail);
+    out_ring->cq_mask = (unsigned*)(cq_base + params.cq_off.ring_mask);
+    out_ring->cqes = (struct io_uring_cqe*)(cq_base + params.cq_off.cqes);
+  } else {
+    iree_hal_fd_file_ring_deinitialize(out_ring);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+// Submits all queued submission entries and waits for at least
+// |min_complete| completions. Returns 0 on success or the errno of the failure.
+// Entries may have been consumed by the kernel even on failure and callers
+// must check the submission queue head to see which are in flight.
+static int iree_hal_fd_file_ring_enter(iree_hal_fd_file_ring_t* ring,
+                                       uint32_t min_complete) {
+  for (;;) {
+    const unsigned to_submit =
+        *ring->sq_tail - __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE);
+    int ret = (int)syscall(__NR_io_uring_enter, ring->ring_fd, to_submit,
+                           min_complete,
+                           min_complete ? IORING_ENTER_GETEVENTS : 0, NULL, 0);
+    if (ret >= 0) return 0;
+    if (errno == EINTR) continue;
+    return errno;
+  }
+}
+
+// Tries to register |contents| as fixed buffer 0 so that the kernel can avoid
+// pinning the pages on every request. Returns false if registration failed
+// (usually due to RLIMIT_MEMLOCK) and non-fixed operations must be used.
+static bool iree_hal_fd_file_ring_register_buffer(
+    iree_hal_fd_file_ring_t* ring, iree_byte_span_t contents) {
+  struct iovec iov = {
+      .iov_base = contents.data,
+      .iov_len = contents.data_length,
+  };
+  return syscall(__NR_io_uring_register, ring->ring_fd,
+                 IORING_REGISTER_BUFFERS, &iov, 1) == 0;
+}
+
+static void iree_hal_fd_file_ring_unregister_buffer(
+    iree_hal_fd_file_ring_t* ring) {
+  syscall(__NR_io_uring_register, ring->ring_fd, IORING_UNREGISTER_BUFFERS,
+          NULL, 0);
+}
+
+// Reads or writes |contents| from/to |fd| at |file_offset| by splitting the
+// range into blocks and keeping up to the ring capacity in flight at a time.
+// Blocks until the entire range has been transferred.
+static iree_status_t iree_hal_fd_file_ring_transfer(
+    iree_hal_fd_file_ring_t* ring, int fd, bool is_read, uint64_t file_offset,
+    iree_byte_span_t contents) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  const iree_host_size_t block_size = IREE_HAL_FD_FILE_BLOCK_SIZE;
+  const iree_host_size_t block_count =
+      iree_host_size_ceil_div(contents.data_length, block_size);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)block_count);
+
+  // Registration is scoped to this transfer: the memory may be released by the
+  // caller as soon as we return and the kernel would otherwise keep the old
+  // pages pinned and targeted by subsequent fixed operations. It's only worth
+  // the cost when there are enough blocks sharing the registration.
+  const bool is_fixed =
+      block_count > 1 && iree_hal_fd_file_ring_register_buffer(ring, contents);
+  uint8_t opcode = 0;
+  if (is_read) {
+    opcode = is_fixed ? IORING_OP_READ_FIXED : IORING_OP_READ;
+  } else {
+    opcode = is_fixed ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+  }
+  IREE_TRACE_ZONE_APPEND_TEXT(z0, is_fixed ? "fixed" : "unregistered");
+
+  iree_status_t status = iree_ok_status();
+  iree_host_size_t next_block = 0;
+  // Blocks queued in the submission ring that the kernel has not consumed.
+  iree_host_size_t queued_count = 0;
+  // Blocks consumed by the kernel that have not completed. These reference
+  // |contents| and must complete before we return.
+  iree_host_size_t inflight_count = 0;
+  while (iree_status_is_ok(status) &&
+         (next_block < block_count || queued_count > 0 || inflight_count > 0)) {
+    // Fill the submission queue with as many blocks as we have room for.
+    unsigned sq_tail = *ring->sq_tail;
+    while (next_block < block_count &&
+           queued_count + inflight_count < ring->sq_entries) {
+      const iree_host_size_t block_offset = next_block * block_size;
+      const unsigned index = sq_tail & *ring->sq_mask;
+      struct io_uring_sqe* sqe = &ring->sqes[index];
+      memset(sqe, 0, sizeof(*sqe));
+      sqe->opcode = opcode;
+      sqe->fd = fd;
+      sqe->off = file_offset + block_offset;
+      sqe->addr = (uint64_t)(uintptr_t)(contents.data + block_offset);
+      sqe->len = (uint32_t)iree_min(block_size,
+                                    contents.data_length - block_offset);
+      sqe->buf_index = 0;
+      sqe->user_data = (uint64_t)next_block;
+      ring->sq_array[index] = index;
+      ++sq_tail;
+      ++next_block;
+      ++queued_count;
+    }
+    __atomic_store_n(ring->sq_tail, sq_tail, __ATOMIC_RELEASE);
+
+    // Submit and wait for at least one block to complete. EAGAIN and EBUSY
+    // indicate the kernel is temporarily out of resources or the completion
+    // queue is full; reaping below makes room and we retry.
+    const int error = iree_hal_fd_file_ring_enter(ring, /*min_complete=*/1);
+    const unsigned consumed_count =
+        queued_count - (sq_tail - __atomic_load_n(ring->sq_head,
+                                                  __ATOMIC_ACQUIRE));
+    queued_count -= consumed_count;
+    inflight_count += consumed_count;
+    if (error && error != EAGAIN && error != EBUSY) {
+      status = iree_make_status(iree_status_code_from_errno(error),
+                                "io_uring_enter failed");
+      break;
+    }
+
+    // Reap all available completions.
+    unsigned cq_head = *ring->cq_head;
+    const unsigned cq_tail = __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE);
+    if (error && cq_head == cq_tail) sched_yield();
+    for (; cq_head != cq_tail; ++cq_head) {
+      const struct io_uring_cqe* cqe = &ring->cqes[cq_head & *ring->cq_mask];
+      --inflight_count;
+      if (!iree_status_is_ok(status)) continue;
+      const iree_host_size_t block_offset =
+          (iree_host_size_t)cqe->user_data * block_size;
+      const iree_host_size_t block_length =
+          iree_min(block_size, contents.data_length - block_offset);
+      if (cqe->res == (int32_t)block_length) continue;
+      if (cqe->res < 0 && cqe->res != -EINTR && cqe->res != -EAGAIN &&
+          cqe->res != -EINVAL && cqe->res != -EOPNOTSUPP) {
+        status = iree_make_status(iree_status_code_from_errno(-cqe->res),
+                                  "file %s failed at offset %" PRIu64,
+                                  is_read ? "read" : "write",
+                                  file_offset + block_offset);
+        continue;
+      }
+      // Short transfers (or opcodes the kernel does not support) are rare
+      // enough that we finish the block synchronously.
+      const iree_host_size_t done_length =
+          cqe->res > 0 ? (iree_host_size_t)cqe->res : 0;
+      status = iree_hal_fd_file_transfer_sync(
+          fd, is_read, file_offset + block_offset + done_length,
+          iree_make_byte_span(contents.data + block_offset + done_length,
+                              block_length - done_length));
+    }
+    __atomic_store_n(ring->cq_head, cq_head, __ATOMIC_RELEASE);
+  }
+
+  // If we bailed early drop the blocks the kernel never consumed so that they
+  // are not submitted by a later transfer. This is safe as the ring is only
+  // entered by the thread holding the file lock and does not use SQPOLL.
+  if (queued_count > 0) {
+    __atomic_store_n(ring->sq_tail,
+                     __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE),
+                     __ATOMIC_RELEASE);
+    queued_count = 0;
+  }
+
+  // Wait for all blocks in flight as they reference the caller memory. The
+  // kernel posts completions without us entering the ring so if waiting fails
+  // we poll the completion queue instead of returning early.
+  while (inflight_count > 0) {
+    unsigned cq_head = *ring->cq_head;
+    const unsigned cq_tail = __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE);
+    inflight_count -= (iree_host_size_t)(cq_tail - cq_head);
+    __atomic_store_n(ring->cq_head, cq_tail, __ATOMIC_RELEASE);
+    if (inflight_count == 0) break;
+    if (iree_hal_fd_file_ring_enter(ring, /*min_complete=*/1) != 0) {
+      sched_yield();
+    }
+  }
+
+  if (is_fixed) iree_hal_fd_file_ring_unregister_buffer(ring);
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+#endif  // IREE_HAL_FD_FILE_IO_URING
+
+//===----------------------------------------------------------------------===//
+// iree_hal_fd_file_t
+//===----------------------------------------------------------------------===//
+
+typedef struct iree_hal_fd_file_t {
+  iree_hal_resource_t resource;
+  // Used to allocate this structure.
+  iree_allocator_t host_allocator;
+  // Allowed access bits.
+  iree_hal_memory_access_t access;
+  // Base file handle, retained.
+  iree_io_file_handle_t* handle;
+  // File descriptor from the handle.
+  int fd;
+#if IREE_HAL_FD_FILE_IO_URING
+  // Guards the ring as transfer workers may issue requests concurrently.
+  iree_slim_mutex_t ring_mutex;
+  // Ring used for all requests; ring_fd is -1 if io_uring is unavailable.
+  iree_hal_fd_file_ring_t ring;
+#endif  // IREE_HAL_FD_FILE_IO_URING
+} iree_hal_fd_file_t;
+
+static const iree_hal_file_vtable_t iree_hal_fd_file_vtable;
+
+static iree_hal_fd_file_t* iree_hal_fd_file_cast(
+    iree_hal_file_t* IREE_RESTRICT base_value) {
+  return (iree_hal_fd_file_t*)base_value;
+}
+
+IREE_API_EXPORT iree_status_t iree_hal_fd_file_from_handle(
+    iree_hal_memory_access_t access, iree_io_file_handle_t* handle,
+    iree_allocator_t host_allocator, iree_hal_file_t** out_file) {
+  IREE_ASSERT_ARGUMENT(handle);
+  IREE_ASSERT_ARGUMENT(out_file);
+  *out_file = NULL;
+  if (iree_io_file_handle_type(handle) != IREE_IO_FILE_HANDLE_TYPE_FD) {
+    return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                            "file handle is not a file descriptor");
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_hal_fd_file_t* file = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(host_allocator, sizeof(*file), (void**)&file));
+  iree_hal_resource_initialize(&iree_hal_fd_file_vtable, &file->resource);
+  file->host_allocator = host_allocator;
+  file->access = access;
+  file->handle = handle;
+  iree_io_file_handle_retain(handle);
+  file->fd = iree_io_file_handle_value(handle).fd;
+
+#if IREE_HAL_FD_FILE_IO_URING
+  // Failing to create the ring is not fatal; we'll use positional I/O instead.
+  iree_slim_mutex_initialize(&file->ring_mutex);
+  iree_status_t ring_status = iree_hal_fd_file_ring_initialize(
+      IREE_HAL_FD_FILE_QUEUE_DEPTH, &file->ring);
+  IREE_TRACE({
+    if (!iree_status_is_ok(ring_status)) {
+      IREE_TRACE_ZONE_APPEND_TEXT(z0, "io_uring unavailable");
+    }
+  });
+  iree_status_ignore(ring_status);
+#endif  // IREE_HAL_FD_FILE_IO_URING
+
+  *out_file = (iree_hal_file_t*)file;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+static void iree_hal_fd_file_destroy(iree_hal_file_t* IREE_RESTRICT base_file) {
+  iree_hal_fd_file_t* file = iree_hal_fd_file_cast(base_file);
+  iree_allocator_t host_allocator = file->host_allocator;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+#if IREE_HAL_FD_FILE_IO_URING
+  iree_hal_fd_file_ring_deinitialize(&file->ring);
+  iree_slim_mutex_deinitialize(&file->ring_mutex);
+#endif  // IREE_HAL_FD_FILE_IO_URING
+
+  iree_io_file_handle_release(file->handle);
+
+  iree_allocator_free(host_allocator, file);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+static iree_hal_memory_access_t iree_hal_fd_file_allowed_access(
+    iree_hal_file_t* base_file) {
+  iree_hal_fd_file_t* file = iree_hal_fd_file_cast(base_file);
+  return file->access;
+}
+
+static uint64_t iree_hal_fd_file_length(iree_hal_file_t* base_file) {
+  iree_hal_fd_file_t* file = iree_hal_fd_file_cast(base_file);
+  // Queried each time as writes may extend the file.
+  struct stat file_stat;
+  if (fstat(file->fd, &file_stat) != 0) return 0;
+  return (uint64_t)file_stat.st_size;
+}
+
+static iree_hal_buffer_t* iree_hal_fd_file_storage_buffer(
+    iree_hal_file_t* base_file) {
+  // Not backed by memory; all access must be staged.
+  return NULL;
+}
+
+// Transfers |contents| from/to the file at |file_offset|.
+static iree_status_t iree_hal_fd_file_transfer(iree_hal_fd_file_t* file,
+                                               bool is_read,
+                                               uint64_t file_offset,
+                                               iree_byte_span_t contents) {
+#if IREE_HAL_FD_FILE_IO_URING
+  if (file->ring.ring_fd >= 0) {
+    iree_slim_mutex_lock(&file->ring_mutex);
+    iree_status_t status = iree_hal_fd_file_ring_transfer(
+        &file->ring, file->fd, is_read, file_offset, contents);
+    iree_slim_mutex_unlock(&file->ring_mutex);
+    return status;
+  }
+#endif  // IREE_HAL_FD_FILE_IO_URING
+  return iree_hal_fd_file_transfer_sync(file->fd, is_read, file_offset,
+                                        contents);
+}
+
+static iree_status_t iree_hal_fd_file_read(iree_hal_file_t* base_file,
+                                           uint64_t file_offset,
+                                           iree_hal_buffer_t* buffer,
+                                           iree_device_size_t buffer_offset,
+                                           iree_device_size_t length) {
+  iree_hal_fd_file_t* file = iree_hal_fd_file_cast(base_file);
+  if (length == 0) return iree_ok_status();
+
+  // Read directly into the mapped staging buffer memory.
+  iree_hal_buffer_mapping_t mapping;
+  IREE_RETURN_IF_ERROR(iree_hal_buffer_map_range(
+      buffer, IREE_HAL_MAPPING_MODE_SCOPED,
+      IREE_HAL_MEMORY_ACCESS_DISCARD_WRITE, buffer_offset, length, &mapping));
+  iree_status_t status = iree_hal_fd_file_transfer(
+      file, /*is_read=*/true, file_offset, mapping.contents);
+  if (iree_status_is_ok(status) &&
+      !iree_all_bits_set(iree_hal_buffer_memory_type(buffer),
+                         IREE_HAL_MEMORY_TYPE_HOST_COHERENT)) {
+    status =
+        iree_hal_buffer_mapping_flush_range(&mapping, 0, IREE_WHOLE_BUFFER);
+  }
+  return iree_status_join(status, iree_hal_buffer_unmap_range(&mapping));
+}
+
+static iree_status_t iree_hal_fd_file_write(iree_hal_file_t* base_file,
+                                            uint64_t file_offset,
+                                            iree_hal_buffer_t* buffer,
+                                            iree_device_size_t buffer_offset,
+                                            iree_device_size_t length) {
+  iree_hal_fd_file_t* file = iree_hal_fd_file_cast(base_file);
+  if (length == 0) return iree_ok_status();
+
+  // Write directly from the mapped staging buffer memory.
+  iree_hal_buffer_mapping_t mapping;
+  IREE_RETURN_IF_ERROR(iree_hal_buffer_map_range(
+      buffer, IREE_HAL_MAPPING_MODE_SCOPED, IREE_HAL_MEMORY_ACCESS_READ,
+      buffer_offset, length, &mapping));
+  iree_status_t status = iree_ok_status();
+  if (!iree_all_bits_set(iree_hal_buffer_memory_type(buffer),
+                         IREE_HAL_MEMORY_TYPE_HOST_COHERENT)) {
+    status = iree_hal_buffer_mapping_invalidate_range(&mapping, 0,
+                                                      IREE_WHOLE_BUFFER);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_fd_file_transfer(file, /*is_read=*/false, file_offset,
+                                       mapping.contents);
+  }
+  return iree_status_join(status, iree_hal_buffer_unmap_range(&mapping));
+}
+
+static const iree_hal_file_vtable_t iree_hal_fd_file_vtable = {
+    .destroy = iree_hal_fd_file_destroy,
+    .allowed_access = iree_hal_fd_file_allowed_access,
+    .length = iree_hal_fd_file_length,
+    .storage_buffer = iree_hal_fd_file_storage_buffer,
+    .read = iree_hal_fd_file_read,
+    .write = iree_hal_fd_file_write,
+};
+
+#else
+
+IREE_API_EXPORT iree_status_t iree_hal_fd_file_from_handle(
+    iree_hal_memory_access_t access, iree_io_file_handle_t* handle,
+    iree_allocator_t host_allocator, iree_hal_file_t** out_file) {
+  IREE_ASSERT_ARGUMENT(out_file);
+  *out_file = NULL;
+  return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                          "file descriptors not supported on this platform");
+}
+
+#endif  // IREE_HAL_FD_FILE_SUPPORTED
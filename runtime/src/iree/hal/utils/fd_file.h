@@ -0,0 +1,49 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_UTILS_FD_FILE_H_
+#define IREE_HAL_UTILS_FD_FILE_H_
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/io/file_handle.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+//===----------------------------------------------------------------------===//
+// iree_hal_fd_file_t
+//===----------------------------------------------------------------------===//
+
+// Creates a file backed by the POSIX file descriptor in |handle|.
+// The handle is retained for the lifetime of the file.
+//
+// Reads and writes are performed synchronously with the host when requested
+// via iree_hal_file_read/iree_hal_file_write and are intended to be driven by
+// the streaming transfer utilities (iree_hal_device_queue_read_streaming).
+// Where available (Linux with io_uring) each request is split into blocks that
+// are all kept in flight at once against buffers registered with the kernel so
+// that storage devices with deep queues (NVMe/etc) are kept busy instead of
+// serializing on the latency of individual reads. If io_uring is unavailable
+// (old kernels, sandboxes, etc) positional reads/writes are used instead.
+//
+// Only handles created with iree_io_file_handle_wrap_fd reach this path.
+// Parameter files opened by the tooling flags (--parameters) are host
+// allocations (preloaded or mmapped) unless `--parameter_mode=file` is used in
+// which case parameters are read from file descriptors through this path.
+//
+// Fails with IREE_STATUS_UNAVAILABLE if the handle is not a file descriptor or
+// file descriptors are not supported on the platform.
+IREE_API_EXPORT iree_status_t iree_hal_fd_file_from_handle(
+    iree_hal_memory_access_t access, iree_io_file_handle_t* handle,
+    iree_allocator_t host_allocator, iree_hal_file_t** out_file);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_UTILS_FD_FILE_H_
@@ -0,0 +1,157 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/utils/fd_file.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/hal/utils/memory_file.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+#if defined(IREE_PLATFORM_ANDROID) || defined(IREE_PLATFORM_APPLE) || \
+    defined(IREE_PLATFORM_LINUX)
+#include <unistd.h>
+#define IREE_HAL_FD_FILE_TEST_SUPPORTED 1
+#endif  // IREE_PLATFORM_*
+
+namespace iree {
+namespace hal {
+namespace {
+
+#if defined(IREE_HAL_FD_FILE_TEST_SUPPORTED)
+
+class FdFileTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    IREE_ASSERT_OK(iree_hal_allocator_create_heap(
+        iree_make_cstring_view("test"), iree_allocator_system(),
+        iree_allocator_system(), &device_allocator_));
+    const char* tmpdir = getenv("TEST_TMPDIR");
+    if (!tmpdir) tmpdir = getenv("TMPDIR");
+    if (!tmpdir) tmpdir = "/tmp";
+    std::string path_template = std::string(tmpdir) + "/fd_file_test_XXXXXX";
+    std::vector<char> path(path_template.begin(), path_template.end());
+    path.push_back(0);
+    fd_ = mkstemp(path.data());
+    ASSERT_GE(fd_, 0);
+    unlink(path.data());
+  }
+
+  void TearDown() override {
+    if (fd_ >= 0) close(fd_);
+    iree_hal_allocator_release(device_allocator_);
+  }
+
+  // Writes |contents| to the file at |offset| directly with the fd.
+  void WriteFile(uint64_t offset, const std::vector<uint8_t>& contents) {
+    ASSERT_EQ(pwrite(fd_, contents.data(), contents.size(), (off_t)offset),
+              (ssize_t)contents.size());
+  }
+
+  iree_hal_file_t* OpenFile() {
+    iree_io_file_handle_t* handle = NULL;
+    IREE_CHECK_OK(iree_io_file_handle_wrap_fd(
+        IREE_IO_FILE_ACCESS_READ | IREE_IO_FILE_ACCESS_WRITE, fd_,
+        iree_io_file_handle_release_callback_null(), iree_allocator_system(),
+        &handle));
+    iree_hal_file_t* file = NULL;
+    IREE_CHECK_OK(iree_hal_fd_file_from_handle(IREE_HAL_MEMORY_ACCESS_ALL,
+                                               handle, iree_allocator_system(),
+                                               &file));
+    iree_io_file_handle_release(handle);
+    return file;
+  }
+
+  iree_hal_buffer_t* AllocateBuffer(iree_device_size_t size) {
+    iree_hal_buffer_params_t params = {0};
+    params.type =
+        IREE_HAL_MEMORY_TYPE_HOST_LOCAL | IREE_HAL_MEMORY_TYPE_DEVICE_VISIBLE;
+    params.usage =
+        IREE_HAL_BUFFER_USAGE_TRANSFER | IREE_HAL_BUFFER_USAGE_MAPPING;
+    iree_hal_buffer_t* buffer = NULL;
+    IREE_CHECK_OK(iree_hal_allocator_allocate_buffer(device_allocator_, params,
+                                                     size, &buffer));
+    return buffer;
+  }
+
+  static std::vector<uint8_t> MakePattern(size_t length, uint8_t seed) {
+    std::vector<uint8_t> pattern(length);
+    for (size_t i = 0; i < length; ++i) {
+      pattern[i] = (uint8_t)(i * 31 + seed);
+    }
+    return pattern;
+  }
+
+  iree_hal_allocator_t* device_allocator_ = NULL;
+  int fd_ = -1;
+};
+
+TEST_F(FdFileTest, Properties) {
+  WriteFile(0, MakePattern(1234, 1));
+  iree_hal_file_t* file = OpenFile();
+  EXPECT_EQ(iree_hal_file_allowed_access(file), IREE_HAL_MEMORY_ACCESS_ALL);
+  EXPECT_EQ(iree_hal_file_length(file), 1234u);
+  EXPECT_EQ(iree_hal_file_storage_buffer(file), nullptr);
+  iree_hal_file_release(file);
+}
+
+// Reads a range spanning several blocks so that multiple requests are in
+// flight at once when io_uring is available.
+TEST_F(FdFileTest, ReadMultipleBlocks) {
+  const size_t length = 5 * 1024 * 1024 + 123;
+  std::vector<uint8_t> contents = MakePattern(length, 7);
+  WriteFile(100, contents);
+  iree_hal_file_t* file = OpenFile();
+  iree_hal_buffer_t* buffer = AllocateBuffer(length + 64);
+
+  IREE_ASSERT_OK(iree_hal_file_read(file, 100, buffer, 64, length));
+  std::vector<uint8_t> result(length);
+  IREE_ASSERT_OK(iree_hal_buffer_map_read(buffer, 64, result.data(), length));
+  EXPECT_EQ(result, contents);
+
+  iree_hal_buffer_release(buffer);
+  iree_hal_file_release(file);
+}
+
+TEST_F(FdFileTest, ReadPastEnd) {
+  WriteFile(0, MakePattern(100, 3));
+  iree_hal_file_t* file = OpenFile();
+  iree_hal_buffer_t* buffer = AllocateBuffer(200);
+  IREE_EXPECT_STATUS_IS(IREE_STATUS_OUT_OF_RANGE,
+                        iree_hal_file_read(file, 0, buffer, 0, 200));
+  iree_hal_buffer_release(buffer);
+  iree_hal_file_release(file);
+}
+
+TEST_F(FdFileTest, WriteMultipleBlocks) {
+  const size_t length = 3 * 1024 * 1024 + 17;
+  std::vector<uint8_t> contents = MakePattern(length, 11);
+  iree_hal_file_t* file = OpenFile();
+  iree_hal_buffer_t* buffer = AllocateBuffer(length);
+  IREE_ASSERT_OK(
+      iree_hal_buffer_map_write(buffer, 0, contents.data(), length));
+
+  IREE_ASSERT_OK(iree_hal_file_write(file, 32, buffer, 0, length));
+  EXPECT_EQ(iree_hal_file_length(file), 32 + length);
+  std::vector<uint8_t> result(length);
+  ASSERT_EQ(pread(fd_, result.data(), length, 32), (ssize_t)length);
+  EXPECT_EQ(result, contents);
+
+  iree_hal_buffer_release(buffer);
+  iree_hal_file_release(file);
+}
+
+#endif  // IREE_HAL_FD_FILE_TEST_SUPPORTED
+
+}  // namespace
+}  // namespace hal
+}  // namespace iree
@@ -53,7 +53,8 @@ typedef struct iree_hal_file_transfer_options_t {
 // performed as part of the transfer.
 //
 // WARNING: this only works with memory files as created via
-// iree_hal_memory_file_wrap.
+// iree_hal_memory_file_wrap and file descriptor files as created via
+// iree_hal_fd_file_from_handle.
 IREE_API_EXPORT iree_status_t iree_hal_device_queue_read_streaming(
     iree_hal_device_t* device, iree_hal_queue_affinity_t queue_affinity,
     const iree_hal_semaphore_list_t wait_semaphore_list,
@@ -76,7 +77,8 @@ IREE_API_EXPORT iree_status_t iree_hal_device_queue_read_streaming(
 // performed as part of the transfer.
 //
 // WARNING: this only works with memory files as created via
-// iree_hal_memory_file_wrap.
+// iree_hal_memory_file_wrap and file descriptor files as created via
+// iree_hal_fd_file_from_handle.
 IREE_API_EXPORT iree_status_t iree_hal_device_queue_write_streaming(
     iree_hal_device_t* device, iree_hal_queue_affinity_t queue_affinity,
     const iree_hal_semaphore_list_t wait_semaphore_list,
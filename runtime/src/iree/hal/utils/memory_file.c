@@ -6,6 +6,8 @@
 
 #include "iree/hal/utils/memory_file.h"
 
+#include "iree/hal/detail.h"
+
 //===----------------------------------------------------------------------===//
 // Configuration
 //===----------------------------------------------------------------------===//
@@ -274,90 +276,106 @@ static void iree_hal_memory_file_try_import_buffer(
   iree_status_ignore(status);
 }
 
+static iree_hal_memory_access_t iree_hal_memory_file_allowed_access(
+    iree_hal_file_t* base_file) {
+  iree_hal_memory_file_t* file = iree_hal_memory_file_cast(base_file);
+  return file->access;
+}
+
+static uint64_t iree_hal_memory_file_length(iree_hal_file_t* base_file) {
+  iree_hal_memory_file_t* file = iree_hal_memory_file_cast(base_file);
+  return file->storage->contents.data_length;
+}
+
+static iree_hal_buffer_t* iree_hal_memory_file_storage_buffer(
+    iree_hal_file_t* base_file) {
+  iree_hal_memory_file_t* file = iree_hal_memory_file_cast(base_file);
+  return file->imported_buffer;
+}
+
+static iree_status_t iree_hal_memory_file_read(
+    iree_hal_file_t* base_file, uint64_t file_offset, iree_hal_buffer_t* buffer,
+    iree_device_size_t buffer_offset, iree_device_size_t length) {
+  iree_hal_memory_file_t* file = iree_hal_memory_file_cast(base_file);
+
+  // Copy from the file contents to the staging buffer.
+  iree_byte_span_t file_contents = file->storage->contents;
+  return iree_hal_buffer_map_write(buffer, buffer_offset,
+                                   file_contents.data + file_offset, length);
+}
+
+static iree_status_t iree_hal_memory_file_write(
+    iree_hal_file_t* base_file, uint64_t file_offset, iree_hal_buffer_t* buffer,
+    iree_device_size_t buffer_offset, iree_device_size_t length) {
+  iree_hal_memory_file_t* file = iree_hal_memory_file_cast(base_file);
+
+  // Copy from the staging buffer to the file contents.
+  iree_byte_span_t file_contents = file->storage->contents;
+  return iree_hal_buffer_map_read(buffer, buffer_offset,
+                                  file_contents.data + file_offset, length);
+}
+
 static const iree_hal_file_vtable_t iree_hal_memory_file_vtable = {
     .destroy = iree_hal_memory_file_destroy,
+    .allowed_access = iree_hal_memory_file_allowed_access,
+    .length = iree_hal_memory_file_length,
+    .storage_buffer = iree_hal_memory_file_storage_buffer,
+    .read = iree_hal_memory_file_read,
+    .write = iree_hal_memory_file_write,
 };
 
 //===----------------------------------------------------------------------===//
 // EXPERIMENTAL: synchronous file read/write API
 //===----------------------------------------------------------------------===//
 // This is incomplete and may not appear like this on the iree_hal_file_t
-// vtable; this does work for memory files though.
+// vtable; this does work for memory files and file descriptor files though.
 
-IREE_API_EXPORT iree_hal_memory_access_t
-iree_hal_file_allowed_access(iree_hal_file_t* base_file) {
-  IREE_ASSERT_ARGUMENT(base_file);
-
-  // EXPERIMENTAL: today only memory files. This should be on the file vtable
-  // (if supported - not all implementations need to support it).
-  iree_hal_memory_file_t* file = (iree_hal_memory_file_t*)base_file;
+#define _VTABLE_DISPATCH(file, method_name) \
+  IREE_HAL_VTABLE_DISPATCH(file, iree_hal_file, method_name)
 
-  return file->access;
+IREE_API_EXPORT iree_hal_memory_access_t
+iree_hal_file_allowed_access(iree_hal_file_t* file) {
+  IREE_ASSERT_ARGUMENT(file);
+  return _VTABLE_DISPATCH(file, allowed_access)(file);
 }
 
-IREE_API_EXPORT uint64_t iree_hal_file_length(iree_hal_file_t* base_file) {
-  IREE_ASSERT_ARGUMENT(base_file);
-
-  // EXPERIMENTAL: today only memory files. This should be on the file vtable
-  // (if supported - not all implementations need to support it).
-  iree_hal_memory_file_t* file = (iree_hal_memory_file_t*)base_file;
-
-  return file->storage->contents.data_length;
+IREE_API_EXPORT uint64_t iree_hal_file_length(iree_hal_file_t* file) {
+  IREE_ASSERT_ARGUMENT(file);
+  return _VTABLE_DISPATCH(file, length)(file);
 }
 
 IREE_API_EXPORT iree_hal_buffer_t* iree_hal_file_storage_buffer(
-    iree_hal_file_t* base_file) {
-  IREE_ASSERT_ARGUMENT(base_file);
-
-  // EXPERIMENTAL: today only memory files. This should be on the file vtable
-  // (if supported - not all implementations need to support it).
-  iree_hal_memory_file_t* file = (iree_hal_memory_file_t*)base_file;
-
-  return file->imported_buffer;
+    iree_hal_file_t* file) {
+  IREE_ASSERT_ARGUMENT(file);
+  return _VTABLE_DISPATCH(file, storage_buffer)(file);
 }
 
 IREE_API_EXPORT iree_status_t iree_hal_file_read(
-    iree_hal_file_t* base_file, uint64_t file_offset, iree_hal_buffer_t* buffer,
+    iree_hal_file_t* file, uint64_t file_offset, iree_hal_buffer_t* buffer,
     iree_device_size_t buffer_offset, iree_device_size_t length) {
-  IREE_ASSERT_ARGUMENT(base_file);
+  IREE_ASSERT_ARGUMENT(file);
   IREE_ASSERT_ARGUMENT(buffer);
   IREE_TRACE_ZONE_BEGIN(z0);
   IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, file_offset);
   IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)buffer_offset);
   IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)length);
-
-  // EXPERIMENTAL: today only memory files. This should be on the file vtable
-  // (if supported - not all implementations need to support it).
-  iree_hal_memory_file_t* file = (iree_hal_memory_file_t*)base_file;
-
-  // Copy from the file contents to the staging buffer.
-  iree_byte_span_t file_contents = file->storage->contents;
-  iree_status_t status = iree_hal_buffer_map_write(
-      buffer, buffer_offset, file_contents.data + file_offset, length);
-
+  iree_status_t status = _VTABLE_DISPATCH(file, read)(file, file_offset, buffer,
+                                                      buffer_offset, length);
   IREE_TRACE_ZONE_END(z0);
   return status;
 }
 
 IREE_API_EXPORT iree_status_t iree_hal_file_write(
-    iree_hal_file_t* base_file, uint64_t file_offset, iree_hal_buffer_t* buffer,
+    iree_hal_file_t* file, uint64_t file_offset, iree_hal_buffer_t* buffer,
     iree_device_size_t buffer_offset, iree_device_size_t length) {
-  IREE_ASSERT_ARGUMENT(base_file);
+  IREE_ASSERT_ARGUMENT(file);
   IREE_ASSERT_ARGUMENT(buffer);
   IREE_TRACE_ZONE_BEGIN(z0);
   IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, file_offset);
   IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)buffer_offset);
   IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)length);
-
-  // EXPERIMENTAL: today only memory files. This should be on the file vtable
-  // (if supported - not all implementations need to support it).
-  iree_hal_memory_file_t* file = (iree_hal_memory_file_t*)base_file;
-
-  // Copy from the staging buffer to the file contents.
-  iree_byte_span_t file_contents = file->storage->contents;
-  iree_status_t status = iree_hal_buffer_map_read(
-      buffer, buffer_offset, file_contents.data + file_offset, length);
-
+  iree_status_t status = _VTABLE_DISPATCH(file, write)(
+      file, file_offset, buffer, buffer_offset, length);
   IREE_TRACE_ZONE_END(z0);
   return status;
 }
@@ -32,7 +32,7 @@ IREE_API_EXPORT iree_status_t iree_hal_memory_file_wrap(
 // EXPERIMENTAL: synchronous file read/write API
 //===----------------------------------------------------------------------===//
 // This is incomplete and may not appear like this on the iree_hal_file_t
-// vtable; this does work for memory files though.
+// vtable; this does work for memory files and file descriptor files though.
 
 // Returns the memory access allowed to the file.
 // This may be more strict than the original file handle backing the resource
@@ -9,6 +9,12 @@
 #include "iree/base/internal/atomics.h"
 #include "iree/io/memory_stream.h"
 
+#if defined(IREE_PLATFORM_ANDROID) || defined(IREE_PLATFORM_APPLE) || \
+    defined(IREE_PLATFORM_LINUX)
+#include <errno.h>
+#include <unistd.h>
+#endif  // IREE_PLATFORM_*
+
 //===----------------------------------------------------------------------===//
 // iree_io_file_handle_t
 //===----------------------------------------------------------------------===//
@@ -60,6 +66,21 @@ IREE_API_EXPORT iree_status_t iree_io_file_handle_wrap_host_allocation(
                                   release_callback, host_allocator, out_handle);
 }
 
+IREE_API_EXPORT iree_status_t iree_io_file_handle_wrap_fd(
+    iree_io_file_access_t allowed_access, int fd,
+    iree_io_file_handle_release_callback_t release_callback,
+    iree_allocator_t host_allocator, iree_io_file_handle_t** out_handle) {
+  iree_io_file_handle_primitive_t handle_primitive = {
+      .type = IREE_IO_FILE_HANDLE_TYPE_FD,
+      .value =
+          {
+              .fd = fd,
+          },
+  };
+  return iree_io_file_handle_wrap(allowed_access, handle_primitive,
+                                  release_callback, host_allocator, out_handle);
+}
+
 static void iree_io_file_handle_destroy(iree_io_file_handle_t* handle) {
   IREE_ASSERT_ARGUMENT(handle);
   IREE_TRACE_ZONE_BEGIN(z0);
@@ -111,6 +132,20 @@ iree_io_file_handle_flush(iree_io_file_handle_t* handle) {
       // No-op (though we could flush when known mapped).
       break;
     }
+    case IREE_IO_FILE_HANDLE_TYPE_FD: {
+#if defined(IREE_PLATFORM_ANDROID) || defined(IREE_PLATFORM_APPLE) || \
+    defined(IREE_PLATFORM_LINUX)
+      if (fsync(handle->primitive.value.fd) != 0) {
+        status = iree_make_status(iree_status_code_from_errno(errno),
+                                  "unable to sync file descriptor");
+      }
+#else
+      status = iree_make_status(IREE_STATUS_UNAVAILABLE,
+                                "file descriptors not supported on this "
+                                "platform");
+#endif  // IREE_PLATFORM_*
+      break;
+    }
     default: {
       status = iree_make_status(IREE_STATUS_UNIMPLEMENTED,
                                 "flush not supported on handle type %d",
@@ -122,6 +157,160 @@ iree_io_file_handle_flush(iree_io_file_handle_t* handle) {
   return status;
 }
 
+// Verifies that |handle| allows |required_access|.
+static iree_status_t iree_io_file_handle_verify_access(
+    const iree_io_file_handle_t* handle,
+    iree_io_file_access_t required_access) {
+  if (!iree_all_bits_set(handle->access, required_access)) {
+    return iree_make_status(IREE_STATUS_PERMISSION_DENIED,
+                            "file handle does not allow %s access",
+                            iree_all_bits_set(required_access,
+                                              IREE_IO_FILE_ACCESS_WRITE)
+                                ? "write"
+                                : "read");
+  }
+  return iree_ok_status();
+}
+
+// Returns the host allocation range [offset, offset+length) of |handle| or
+// fails if the range is out of bounds.
+static iree_status_t iree_io_file_handle_host_allocation_range(
+    const iree_io_file_handle_t* handle, uint64_t offset,
+    iree_host_size_t length, uint8_t** out_ptr) {
+  iree_byte_span_t host_allocation = handle->primitive.value.host_allocation;
+  if (offset > host_allocation.data_length ||
+      length > host_allocation.data_length - offset) {
+    return iree_make_status(
+        IREE_STATUS_OUT_OF_RANGE,
+        "file range %" PRIu64 "-%" PRIu64
+        " out of range of host allocation with %" PRIhsz " bytes available",
+        offset, offset + length, host_allocation.data_length);
+  }
+  *out_ptr = host_allocation.data + offset;
+  return iree_ok_status();
+}
+
+IREE_API_EXPORT iree_status_t iree_io_file_handle_read(
+    iree_io_file_handle_t* handle, uint64_t offset, iree_byte_span_t buffer) {
+  IREE_ASSERT_ARGUMENT(handle);
+  IREE_ASSERT_ARGUMENT(!buffer.data_length || buffer.data);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)buffer.data_length);
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_io_file_handle_verify_access(handle, IREE_IO_FILE_ACCESS_READ));
+  iree_status_t status = iree_ok_status();
+  switch (handle->primitive.type) {
+    case IREE_IO_FILE_HANDLE_TYPE_HOST_ALLOCATION: {
+      uint8_t* source_ptr = NULL;
+      status = iree_io_file_handle_host_allocation_range(
+          handle, offset, buffer.data_length, &source_ptr);
+      if (iree_status_is_ok(status)) {
+        memcpy(buffer.data, source_ptr, buffer.data_length);
+      }
+      break;
+    }
+    case IREE_IO_FILE_HANDLE_TYPE_FD: {
+#if defined(IREE_PLATFORM_ANDROID) || defined(IREE_PLATFORM_APPLE) || \
+    defined(IREE_PLATFORM_LINUX)
+      iree_host_size_t total_read = 0;
+      while (total_read < buffer.data_length) {
+        ssize_t read_length = pread(
+            handle->primitive.value.fd, buffer.data + total_read,
+            buffer.data_length - total_read, (off_t)(offset + total_read));
+        if (read_length < 0) {
+          if (errno == EINTR) continue;
+          status = iree_make_status(iree_status_code_from_errno(errno),
+                                    "failed to read %" PRIhsz
+                                    " bytes at file offset %" PRIu64,
+                                    buffer.data_length - total_read,
+                                    offset + total_read);
+          break;
+        } else if (read_length == 0) {
+          status = iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                                    "file ended at offset %" PRIu64
+                                    " with %" PRIhsz " bytes remaining to read",
+                                    offset + total_read,
+                                    buffer.data_length - total_read);
+          break;
+        }
+        total_read += (iree_host_size_t)read_length;
+      }
+#else
+      status = iree_make_status(IREE_STATUS_UNAVAILABLE,
+                                "file descriptors not supported on this "
+                                "platform");
+#endif  // IREE_PLATFORM_*
+      break;
+    }
+    default: {
+      status = iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                                "read not supported on handle type %d",
+                                (int)handle->primitive.type);
+      break;
+    }
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+IREE_API_EXPORT iree_status_t iree_io_file_handle_write(
+    iree_io_file_handle_t* handle, uint64_t offset,
+    iree_const_byte_span_t buffer) {
+  IREE_ASSERT_ARGUMENT(handle);
+  IREE_ASSERT_ARGUMENT(!buffer.data_length || buffer.data);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)buffer.data_length);
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_io_file_handle_verify_access(handle, IREE_IO_FILE_ACCESS_WRITE));
+  iree_status_t status = iree_ok_status();
+  switch (handle->primitive.type) {
+    case IREE_IO_FILE_HANDLE_TYPE_HOST_ALLOCATION: {
+      uint8_t* target_ptr = NULL;
+      status = iree_io_file_handle_host_allocation_range(
+          handle, offset, buffer.data_length, &target_ptr);
+      if (iree_status_is_ok(status)) {
+        memcpy(target_ptr, buffer.data, buffer.data_length);
+      }
+      break;
+    }
+    case IREE_IO_FILE_HANDLE_TYPE_FD: {
+#if defined(IREE_PLATFORM_ANDROID) || defined(IREE_PLATFORM_APPLE) || \
+    defined(IREE_PLATFORM_LINUX)
+      iree_host_size_t total_written = 0;
+      while (total_written < buffer.data_length) {
+        ssize_t written_length =
+            pwrite(handle->primitive.value.fd, buffer.data + total_written,
+                   buffer.data_length - total_written,
+                   (off_t)(offset + total_written));
+        if (written_length < 0) {
+          if (errno == EINTR) continue;
+          status = iree_make_status(iree_status_code_from_errno(errno),
+                                    "failed to write %" PRIhsz
+                                    " bytes at file offset %" PRIu64,
+                                    buffer.data_length - total_written,
+                                    offset + total_written);
+          break;
+        }
+        total_written += (iree_host_size_t)written_length;
+      }
+#else
+      status = iree_make_status(IREE_STATUS_UNAVAILABLE,
+                                "file descriptors not supported on this "
+                                "platform");
+#endif  // IREE_PLATFORM_*
+      break;
+    }
+    default: {
+      status = iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                                "write not supported on handle type %d",
+                                (int)handle->primitive.type);
+      break;
+    }
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 //===----------------------------------------------------------------------===//
 // iree_io_stream_t utilities
 //===----------------------------------------------------------------------===//
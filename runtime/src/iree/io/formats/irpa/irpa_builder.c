@@ -6,6 +6,11 @@
 
 #include "iree/io/formats/irpa/irpa_builder.h"
 
+#include "iree/base/internal/memory.h"
+#include "iree/io/memory_stream.h"
+#include "iree/io/parallel_for.h"
+#include "iree/io/parameter_codec.h"
+
 IREE_API_EXPORT iree_status_t iree_io_parameter_archive_builder_initialize(
     iree_allocator_t host_allocator,
     iree_io_parameter_archive_builder_t* out_builder) {
@@ -136,6 +141,7 @@ IREE_API_EXPORT iree_status_t iree_io_parameter_archive_builder_write(
         .type = source_entry->type,
         .storage = source_entry->storage,
     };
+    iree_io_parameter_index_chunk_t* target_chunks = NULL;
     switch (source_entry->type) {
       case IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_SPLAT: {
         iree_io_parameter_archive_splat_entry_t splat_entry = {
@@ -182,6 +188,48 @@ IREE_API_EXPORT iree_status_t iree_io_parameter_archive_builder_write(
             z0, iree_io_stream_write(stream, sizeof(data_entry), &data_entry));
         break;
       }
+      case IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_CHUNKED: {
+        const iree_host_size_t chunk_count =
+            target_entry.storage.chunked.chunk_count;
+        const iree_io_parameter_archive_metadata_ref_t chunk_table_ref = {
+            .offset = metadata_offset,
+            .length = chunk_count * sizeof(iree_io_parameter_archive_chunk_t),
+        };
+        metadata_offset += chunk_table_ref.length;
+        iree_io_parameter_archive_chunked_entry_t chunked_entry = {
+            .header =
+                {
+                    .entry_size = sizeof(chunked_entry),
+                    .type = IREE_IO_PARAMETER_ARCHIVE_ENTRY_TYPE_CHUNKED,
+                    .flags = 0,
+                    .name = name_ref,
+                    .metadata = metadata_ref,
+                    .minimum_alignment = 0,
+                },
+            .length = target_entry.length,
+            .chunk_size = target_entry.storage.chunked.chunk_size,
+            .chunk_table = chunk_table_ref,
+        };
+        IREE_RETURN_AND_END_ZONE_IF_ERROR(
+            z0, iree_io_stream_write(stream, sizeof(chunked_entry),
+                                     &chunked_entry));
+
+        // Chunks in the builder are relative to the storage segment and need
+        // to be rebased for the target index.
+        if (chunk_count > 0) {
+          IREE_RETURN_AND_END_ZONE_IF_ERROR(
+              z0, iree_allocator_malloc(builder->host_allocator,
+                                        chunk_count * sizeof(*target_chunks),
+                                        (void**)&target_chunks));
+        }
+        for (iree_host_size_t j = 0; j < chunk_count; ++j) {
+          target_chunks[j] = target_entry.storage.chunked.chunks[j];
+          target_chunks[j].offset += storage_segment.offset;
+        }
+        target_entry.storage.chunked.handle = file_handle;
+        target_entry.storage.chunked.chunks = target_chunks;
+        break;
+      }
       default: {
         IREE_RETURN_AND_END_ZONE_IF_ERROR(
             z0, iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
@@ -192,8 +240,10 @@ IREE_API_EXPORT iree_status_t iree_io_parameter_archive_builder_write(
 
     // Add the entry to the target_index referencing the location in the file
     // reserved for the entry storage.
-    IREE_RETURN_AND_END_ZONE_IF_ERROR(
-        z0, iree_io_parameter_index_add(target_index, &target_entry));
+    iree_status_t add_status =
+        iree_io_parameter_index_add(target_index, &target_entry);
+    iree_allocator_free(builder->host_allocator, target_chunks);
+    IREE_RETURN_AND_END_ZONE_IF_ERROR(z0, add_status);
   }
 
   // Write out the metadata table.
@@ -211,6 +261,29 @@ IREE_API_EXPORT iree_status_t iree_io_parameter_archive_builder_write(
     IREE_RETURN_AND_END_ZONE_IF_ERROR(
         z0, iree_io_stream_write(stream, source_entry->metadata.data_length,
                                  source_entry->metadata.data));
+
+    // Write the chunk table of chunked entries.
+    if (source_entry->type ==
+        IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_CHUNKED) {
+      for (iree_host_size_t j = 0;
+           j < source_entry->storage.chunked.chunk_count; ++j) {
+        const iree_io_parameter_index_chunk_t* chunk =
+            &source_entry->storage.chunked.chunks[j];
+        iree_io_parameter_archive_chunk_t chunk_record = {
+            .storage =
+                {
+                    .offset = chunk->offset,
+                    .length = chunk->length,
+                },
+            .content_hash = chunk->content_hash,
+            .codec = (iree_io_parameter_archive_codec_t)chunk->codec,
+            .reserved = 0,
+        };
+        IREE_RETURN_AND_END_ZONE_IF_ERROR(
+            z0, iree_io_stream_write(stream, sizeof(chunk_record),
+                                     &chunk_record));
+      }
+    }
   }
 
   IREE_TRACE_ZONE_END(z0);
@@ -297,49 +370,790 @@ IREE_API_EXPORT iree_status_t iree_io_parameter_archive_builder_add_data_entry(
   return iree_ok_status();
 }
 
-IREE_API_EXPORT iree_status_t iree_io_build_parameter_archive(
+IREE_API_EXPORT iree_io_physical_offset_t
+iree_io_parameter_archive_builder_reserve_storage(
+    iree_io_parameter_archive_builder_t* builder,
+    iree_io_physical_size_t minimum_alignment, iree_io_physical_size_t length) {
+  IREE_ASSERT_ARGUMENT(builder);
+  iree_io_physical_offset_t offset =
+      iree_align_uint64(builder->storage_segment_size, minimum_alignment);
+  builder->storage_segment_size = offset + length;
+  if (!builder->storage_alignment) {
+    // First reservation sets the base alignment.
+    builder->storage_alignment = minimum_alignment;
+  }
+  return offset;
+}
+
+IREE_API_EXPORT iree_status_t
+iree_io_parameter_archive_builder_add_chunked_entry(
+    iree_io_parameter_archive_builder_t* builder, iree_string_view_t name,
+    iree_const_byte_span_t metadata, iree_io_physical_size_t data_length,
+    iree_io_physical_size_t chunk_size, iree_host_size_t chunk_count,
+    const iree_io_parameter_index_chunk_t* chunks) {
+  IREE_ASSERT_ARGUMENT(builder);
+  IREE_ASSERT_ARGUMENT(!chunk_count || chunks);
+  for (iree_host_size_t i = 0; i < chunk_count; ++i) {
+    if (chunks[i].offset > builder->storage_segment_size ||
+        chunks[i].length > builder->storage_segment_size - chunks[i].offset) {
+      return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                              "chunk %" PRIhsz
+                              " of `%.*s` references unreserved storage",
+                              i, (int)name.size, name.data);
+    }
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_TEXT(z0, name.data, name.size);
+  iree_io_parameter_index_entry_t entry = {
+      .key = name,
+      .metadata = metadata,
+      .length = data_length,
+      .type = IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_CHUNKED,
+      .storage =
+          {
+              .chunked =
+                  {
+                      .handle = NULL,  // set on commit
+                      .chunk_size = chunk_size,
+                      .chunk_count = chunk_count,
+                      .chunks = chunks,
+                  },
+          },
+  };
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_io_parameter_index_add(builder->index, &entry));
+  builder->entry_segment_size =
+      iree_align_uint64(builder->entry_segment_size,
+                        IREE_IO_PARAMETER_ARCHIVE_ENTRY_ALIGNMENT) +
+      sizeof(iree_io_parameter_archive_chunked_entry_t);
+  builder->metadata_segment_size +=
+      name.size + metadata.data_length +
+      chunk_count * sizeof(iree_io_parameter_archive_chunk_t);
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+//===----------------------------------------------------------------------===//
+// iree_io_build_parameter_archive
+//===----------------------------------------------------------------------===//
+
+// Returns the host pointer to the |length| bytes at |offset| in |handle| if it
+// is a host allocation containing the full range.
+static uint8_t* iree_io_parameter_archive_host_ptr(
+    iree_io_file_handle_t* handle, iree_io_physical_offset_t offset,
+    iree_io_physical_size_t length) {
+  iree_io_file_handle_primitive_t primitive =
+      iree_io_file_handle_primitive(handle);
+  if (primitive.type != IREE_IO_FILE_HANDLE_TYPE_HOST_ALLOCATION) return NULL;
+  iree_byte_span_t host_allocation = primitive.value.host_allocation;
+  if (offset > host_allocation.data_length ||
+      length > host_allocation.data_length - offset) {
+    return NULL;
+  }
+  return host_allocation.data + offset;
+}
+
+typedef struct iree_io_parameter_archive_worker_t
+    iree_io_parameter_archive_worker_t;
+
+// Processes the work item at |work_index| on |worker|.
+typedef iree_status_t (*iree_io_parameter_archive_work_fn_t)(
+    void* user_data, iree_io_parameter_archive_worker_t* worker,
+    uint64_t work_index);
+
+// State for a single worker participating in a parallel loop.
+struct iree_io_parameter_archive_worker_t {
+  // Scratch buffers used by work functions when contents are not directly
+  // addressable. Allocated on first use and reused for all work items.
+  iree_byte_span_t scratch[2];
+  // Position carried across work items processed by the worker. Work items
+  // are claimed in increasing order so this can be used to resume searches.
+  iree_host_size_t cursor;
+};
+
+// Returns scratch buffer |slot| of |worker| with at least |length| bytes.
+static iree_status_t iree_io_parameter_archive_worker_scratch(
+    iree_io_parameter_archive_worker_t* worker,
+    iree_allocator_t host_allocator, iree_host_size_t slot,
+    iree_host_size_t length, uint8_t** out_ptr) {
+  iree_byte_span_t* scratch = &worker->scratch[slot];
+  if (scratch->data_length < length) {
+    iree_allocator_free(host_allocator, scratch->data);
+    scratch->data = NULL;
+    scratch->data_length = 0;
+    IREE_RETURN_IF_ERROR(iree_allocator_malloc_uninitialized(
+        host_allocator, length, (void**)&scratch->data));
+    scratch->data_length = length;
+  }
+  *out_ptr = scratch->data;
+  return iree_ok_status();
+}
+
+static void iree_io_parameter_archive_worker_release_scratch(
+    iree_io_parameter_archive_worker_t* worker,
+    iree_allocator_t host_allocator) {
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(worker->scratch); ++i) {
+    iree_allocator_free(host_allocator, worker->scratch[i].data);
+    worker->scratch[i] = iree_byte_span_empty();
+  }
+}
+
+// Shared state for all workers participating in a parallel loop.
+typedef struct iree_io_parameter_archive_work_t {
+  iree_io_parameter_archive_work_fn_t fn;
+  void* user_data;
+  iree_io_parameter_archive_worker_t* workers;
+} iree_io_parameter_archive_work_t;
+
+static iree_status_t iree_io_parameter_archive_work_item(
+    void* user_data, iree_host_size_t worker_index, uint64_t work_index) {
+  iree_io_parameter_archive_work_t* work =
+      (iree_io_parameter_archive_work_t*)user_data;
+  return work->fn(work->user_data, &work->workers[worker_index], work_index);
+}
+
+// Calls |fn| for each work item in [0, |work_count|) using up to
+// |max_concurrency| threads, including the calling thread.
+static iree_status_t iree_io_parameter_archive_parallel_for(
+    uint64_t work_count, iree_host_size_t max_concurrency,
+    iree_io_parameter_archive_work_fn_t fn, void* user_data,
+    iree_allocator_t host_allocator) {
+  if (!work_count) return iree_ok_status();
+  const iree_host_size_t worker_count =
+      iree_io_parallel_for_worker_count(work_count, max_concurrency);
+  iree_io_parameter_archive_work_t work = {
+      .fn = fn,
+      .user_data = user_data,
+      .workers = NULL,
+  };
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      host_allocator, worker_count * sizeof(*work.workers),
+      (void**)&work.workers));
+  iree_status_t status = iree_io_parallel_for(
+      IREE_SV("iree-irpa-build"), work_count, worker_count,
+      iree_io_parameter_archive_work_item, &work, host_allocator);
+  for (iree_host_size_t i = 0; i < worker_count; ++i) {
+    iree_io_parameter_archive_worker_release_scratch(&work.workers[i],
+                                                     host_allocator);
+  }
+  iree_allocator_free(host_allocator, work.workers);
+  return status;
+}
+
+//===----------------------------------------------------------------------===//
+// Parameter content copies
+//===----------------------------------------------------------------------===//
+
+// A single parameter whose contents are copied from the source to the target.
+typedef struct iree_io_parameter_archive_copy_op_t {
+  iree_io_file_handle_t* source_handle;
+  iree_io_physical_offset_t source_offset;
+  iree_io_physical_offset_t target_offset;
+  iree_io_physical_size_t length;
+  // Global index of the first chunk of the op across all ops.
+  uint64_t chunk_base;
+} iree_io_parameter_archive_copy_op_t;
+
+// Shared state for all threads participating in the copy.
+typedef struct iree_io_parameter_archive_copy_t {
+  iree_allocator_t host_allocator;
+  iree_io_file_handle_t* target_handle;
+  iree_io_physical_size_t chunk_size;
+  iree_host_size_t op_count;
+  iree_io_parameter_archive_copy_op_t* ops;
+  // Total number of chunks across all ops.
+  uint64_t chunk_count;
+} iree_io_parameter_archive_copy_t;
+
+// Copies chunk |chunk_index| of all chunks across all |copy| ops.
+static iree_status_t iree_io_parameter_archive_copy_chunk(
+    void* user_data, iree_io_parameter_archive_worker_t* worker,
+    uint64_t chunk_index) {
+  iree_io_parameter_archive_copy_t* copy =
+      (iree_io_parameter_archive_copy_t*)user_data;
+
+  // Chunks are claimed in increasing order so the op containing the chunk is
+  // always at or after the last op this worker processed.
+  while (worker->cursor + 1 < copy->op_count &&
+         copy->ops[worker->cursor + 1].chunk_base <= chunk_index) {
+    ++worker->cursor;
+  }
+  const iree_io_parameter_archive_copy_op_t* op = &copy->ops[worker->cursor];
+  const iree_io_physical_offset_t chunk_offset =
+      (chunk_index - op->chunk_base) * copy->chunk_size;
+  const iree_host_size_t chunk_length = (iree_host_size_t)iree_min(
+      copy->chunk_size, op->length - chunk_offset);
+  const iree_io_physical_offset_t source_offset =
+      op->source_offset + chunk_offset;
+  const iree_io_physical_offset_t target_offset =
+      op->target_offset + chunk_offset;
+
+  // Sources that are host allocations (usually mapped files) are written
+  // directly from their storage. The advice lets the OS start paging in the
+  // chunk as a sequential scan instead of faulting one page at a time.
+  uint8_t* source_ptr = iree_io_parameter_archive_host_ptr(
+      op->source_handle, source_offset, chunk_length);
+  if (source_ptr) {
+    iree_memory_advise(source_ptr, chunk_length,
+                       IREE_MEMORY_ADVICE_WILL_NEED |
+                           IREE_MEMORY_ADVICE_SEQUENTIAL);
+    return iree_io_file_handle_write(
+        copy->target_handle, target_offset,
+        iree_make_const_byte_span(source_ptr, chunk_length));
+  }
+
+  // Targets that are host allocations are read into directly.
+  uint8_t* target_ptr = iree_io_parameter_archive_host_ptr(
+      copy->target_handle, target_offset, chunk_length);
+  if (target_ptr) {
+    return iree_io_file_handle_read(
+        op->source_handle, source_offset,
+        iree_make_byte_span(target_ptr, chunk_length));
+  }
+
+  // Neither side is addressable so bounce through a scratch buffer.
+  uint8_t* scratch = NULL;
+  IREE_RETURN_IF_ERROR(iree_io_parameter_archive_worker_scratch(
+      worker, copy->host_allocator, 0, (iree_host_size_t)copy->chunk_size,
+      &scratch));
+  IREE_RETURN_IF_ERROR(iree_io_file_handle_read(
+      op->source_handle, source_offset,
+      iree_make_byte_span(scratch, chunk_length)));
+  return iree_io_file_handle_write(
+      copy->target_handle, target_offset,
+      iree_make_const_byte_span(scratch, chunk_length));
+}
+
+// Builds the list of copy ops for all data entries in |source_index| that have
+// been written to |target_index|.
+static iree_status_t iree_io_parameter_archive_copy_initialize(
     iree_io_parameter_index_t* source_index,
     iree_io_parameter_index_t* target_index,
-    iree_io_parameter_archive_file_open_callback_t target_file_open,
+    iree_io_file_handle_t* target_file_handle,
     iree_io_physical_offset_t target_file_offset,
-    iree_allocator_t host_allocator) {
-  IREE_ASSERT_ARGUMENT(source_index);
-  IREE_ASSERT_ARGUMENT(target_index);
-  IREE_ASSERT_ARGUMENT(target_file_open.fn);
+    iree_io_physical_size_t chunk_size, iree_allocator_t host_allocator,
+    iree_io_parameter_archive_copy_t* out_copy) {
+  memset(out_copy, 0, sizeof(*out_copy));
+  out_copy->host_allocator = host_allocator;
+  out_copy->target_handle = target_file_handle;
+  out_copy->chunk_size = chunk_size;
+
+  const iree_host_size_t entry_count =
+      iree_io_parameter_index_count(source_index);
+  if (!entry_count) return iree_ok_status();
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      host_allocator, entry_count * sizeof(out_copy->ops[0]),
+      (void**)&out_copy->ops));
+
+  for (iree_host_size_t i = 0; i < entry_count; ++i) {
+    const iree_io_parameter_index_entry_t* source_entry = NULL;
+    IREE_RETURN_IF_ERROR(
+        iree_io_parameter_index_get(source_index, i, &source_entry));
+    if (source_entry->type != IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_FILE ||
+        !source_entry->length) {
+      continue;  // no contents to copy
+    }
+    const iree_io_parameter_index_entry_t* target_entry = NULL;
+    IREE_RETURN_IF_ERROR(iree_io_parameter_index_lookup(
+        target_index, source_entry->key, &target_entry));
+    if (target_entry->type != IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_FILE) {
+      continue;  // written as chunks
+    }
+    iree_io_parameter_archive_copy_op_t* op =
+        &out_copy->ops[out_copy->op_count++];
+    op->source_handle = source_entry->storage.file.handle;
+    op->source_offset = source_entry->storage.file.offset;
+    op->target_offset = target_file_offset + target_entry->storage.file.offset;
+    op->length = target_entry->length;
+    op->chunk_base = out_copy->chunk_count;
+    out_copy->chunk_count += (op->length + chunk_size - 1) / chunk_size;
+  }
+  return iree_ok_status();
+}
+
+static void iree_io_parameter_archive_copy_deinitialize(
+    iree_io_parameter_archive_copy_t* copy) {
+  iree_allocator_free(copy->host_allocator, copy->ops);
+  memset(copy, 0, sizeof(*copy));
+}
+
+//===----------------------------------------------------------------------===//
+// Chunked parameter contents
+//===----------------------------------------------------------------------===//
+
+// A chunk of a source parameter that is stored in a chunked entry.
+typedef struct iree_io_parameter_archive_chunk_job_t {
+  iree_io_file_handle_t* source_handle;
+  iree_io_physical_offset_t source_offset;
+  iree_host_size_t length;
+  // Hash of the chunk contents.
+  uint64_t content_hash;
+  // Codec the chunk is stored with and the length of the encoded contents.
+  iree_io_parameter_codec_t codec;
+  iree_host_size_t encoded_length;
+  // Index of the job whose storage holds the contents of this chunk. This is
+  // the job's own index unless it has been deduplicated against an earlier one.
+  iree_host_size_t storage_job;
+  // Offset of the encoded contents relative to the storage segment.
+  iree_io_physical_offset_t storage_offset;
+} iree_io_parameter_archive_chunk_job_t;
+
+// Shared state for building chunked entries.
+typedef struct iree_io_parameter_archive_chunking_t {
+  iree_allocator_t host_allocator;
+  iree_io_physical_size_t chunk_size;
+  iree_io_parameter_codec_t codec;
+  // All chunks of all non-empty data entries in source index order.
+  iree_host_size_t job_count;
+  iree_io_parameter_archive_chunk_job_t* jobs;
+  // Target file and the absolute offset of its storage segment. Assigned once
+  // the archive has been opened.
+  iree_io_file_handle_t* target_handle;
+  iree_io_physical_offset_t target_storage_offset;
+} iree_io_parameter_archive_chunking_t;
+
+// Returns the number of chunks a parameter of |length| is split into.
+static uint64_t iree_io_parameter_archive_chunk_count(
+    iree_io_physical_size_t length, iree_io_physical_size_t chunk_size) {
+  return length / chunk_size + (length % chunk_size != 0 ? 1 : 0);
+}
+
+// Splits all non-empty data entries in |source_index| into chunks.
+static iree_status_t iree_io_parameter_archive_chunking_initialize(
+    iree_io_parameter_index_t* source_index, iree_io_physical_size_t chunk_size,
+    iree_io_parameter_codec_t codec, iree_allocator_t host_allocator,
+    iree_io_parameter_archive_chunking_t* out_chunking) {
+  memset(out_chunking, 0, sizeof(*out_chunking));
+  out_chunking->host_allocator = host_allocator;
+  out_chunking->chunk_size = chunk_size;
+  out_chunking->codec = codec;
+
+  const iree_host_size_t entry_count =
+      iree_io_parameter_index_count(source_index);
+  uint64_t job_count = 0;
+  for (iree_host_size_t i = 0; i < entry_count; ++i) {
+    const iree_io_parameter_index_entry_t* source_entry = NULL;
+    IREE_RETURN_IF_ERROR(
+        iree_io_parameter_index_get(source_index, i, &source_entry));
+    if (source_entry->type == IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_FILE) {
+      job_count += iree_io_parameter_archive_chunk_count(source_entry->length,
+                                                         chunk_size);
+    }
+  }
+  if (!job_count) return iree_ok_status();
+  if (job_count > IREE_HOST_SIZE_MAX / sizeof(out_chunking->jobs[0])) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "too many chunks (%" PRIu64 ") for the host",
+                            job_count);
+  }
+  IREE_RETURN_IF_ERROR(
+      iree_allocator_malloc(host_allocator,
+                            (iree_host_size_t)job_count *
+                                sizeof(out_chunking->jobs[0]),
+                            (void**)&out_chunking->jobs));
+
+  for (iree_host_size_t i = 0; i < entry_count; ++i) {
+    const iree_io_parameter_index_entry_t* source_entry = NULL;
+    IREE_RETURN_IF_ERROR(
+        iree_io_parameter_index_get(source_index, i, &source_entry));
+    if (source_entry->type != IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_FILE) {
+      continue;
+    }
+    for (iree_io_physical_offset_t offset = 0; offset < source_entry->length;
+         offset += chunk_size) {
+      iree_io_parameter_archive_chunk_job_t* job =
+          &out_chunking->jobs[out_chunking->job_count];
+      job->source_handle = source_entry->storage.file.handle;
+      job->source_offset = source_entry->storage.file.offset + offset;
+      job->length = (iree_host_size_t)iree_min(chunk_size,
+                                               source_entry->length - offset);
+      job->storage_job = out_chunking->job_count++;
+    }
+  }
+  return iree_ok_status();
+}
+
+static void iree_io_parameter_archive_chunking_deinitialize(
+    iree_io_parameter_archive_chunking_t* chunking) {
+  iree_allocator_free(chunking->host_allocator, chunking->jobs);
+  memset(chunking, 0, sizeof(*chunking));
+}
+
+// Returns the source contents of |job| either directly from the source file or
+// read into scratch buffer |slot| of |worker|.
+static iree_status_t iree_io_parameter_archive_chunk_contents(
+    const iree_io_parameter_archive_chunking_t* chunking,
+    iree_io_parameter_archive_worker_t* worker, iree_host_size_t slot,
+    const iree_io_parameter_archive_chunk_job_t* job,
+    const uint8_t** out_contents) {
+  uint8_t* source_ptr = iree_io_parameter_archive_host_ptr(
+      job->source_handle, job->source_offset, job->length);
+  if (source_ptr) {
+    iree_memory_advise(source_ptr, job->length,
+                       IREE_MEMORY_ADVICE_WILL_NEED |
+                           IREE_MEMORY_ADVICE_SEQUENTIAL);
+    *out_contents = source_ptr;
+    return iree_ok_status();
+  }
+  uint8_t* scratch = NULL;
+  IREE_RETURN_IF_ERROR(iree_io_parameter_archive_worker_scratch(
+      worker, chunking->host_allocator, slot, job->length, &scratch));
+  IREE_RETURN_IF_ERROR(iree_io_file_handle_read(
+      job->source_handle, job->source_offset,
+      iree_make_byte_span(scratch, job->length)));
+  *out_contents = scratch;
+  return iree_ok_status();
+}
+
+// Hashes the chunk at |job_index| and measures its encoded length. Chunks that
+// do not get smaller when encoded are stored as-is.
+static iree_status_t iree_io_parameter_archive_measure_chunk(
+    void* user_data, iree_io_parameter_archive_worker_t* worker,
+    uint64_t job_index) {
+  iree_io_parameter_archive_chunking_t* chunking =
+      (iree_io_parameter_archive_chunking_t*)user_data;
+  iree_io_parameter_archive_chunk_job_t* job = &chunking->jobs[job_index];
+  const uint8_t* contents = NULL;
+  IREE_RETURN_IF_ERROR(iree_io_parameter_archive_chunk_contents(
+      chunking, worker, 0, job, &contents));
+  iree_const_byte_span_t source =
+      iree_make_const_byte_span(contents, job->length);
+  job->content_hash = iree_io_parameter_codec_hash(source);
+  job->codec = IREE_IO_PARAMETER_CODEC_NONE;
+  job->encoded_length = job->length;
+  if (chunking->codec == IREE_IO_PARAMETER_CODEC_NONE || job->length <= 1) {
+    return iree_ok_status();
+  }
+
+  // Only accept encodings strictly smaller than the source.
+  uint8_t* encoded = NULL;
+  IREE_RETURN_IF_ERROR(iree_io_parameter_archive_worker_scratch(
+      worker, chunking->host_allocator, 1, job->length - 1, &encoded));
+  iree_host_size_t encoded_length = 0;
+  iree_status_t status = iree_io_parameter_codec_encode(
+      chunking->codec, source, iree_make_byte_span(encoded, job->length - 1),
+      &encoded_length);
+  if (iree_status_is_resource_exhausted(status)) {
+    iree_status_ignore(status);
+    return iree_ok_status();
+  }
+  IREE_RETURN_IF_ERROR(status);
+  job->codec = chunking->codec;
+  job->encoded_length = encoded_length;
+  return iree_ok_status();
+}
+
+// Compares the source contents of jobs |a| and |b| byte-for-byte.
+static iree_status_t iree_io_parameter_archive_chunks_equal(
+    const iree_io_parameter_archive_chunking_t* chunking,
+    iree_io_parameter_archive_worker_t* worker,
+    const iree_io_parameter_archive_chunk_job_t* a,
+    const iree_io_parameter_archive_chunk_job_t* b, bool* out_equal) {
+  *out_equal = false;
+  if (a->length != b->length || a->content_hash != b->content_hash) {
+    return iree_ok_status();
+  }
+  const uint8_t* a_contents = NULL;
+  IREE_RETURN_IF_ERROR(iree_io_parameter_archive_chunk_contents(
+      chunking, worker, 0, a, &a_contents));
+  const uint8_t* b_contents = NULL;
+  IREE_RETURN_IF_ERROR(iree_io_parameter_archive_chunk_contents(
+      chunking, worker, 1, b, &b_contents));
+  *out_equal = memcmp(a_contents, b_contents, a->length) == 0;
+  return iree_ok_status();
+}
+
+// Assigns storage in |builder| to all chunks. When |deduplicate| is set chunks
+// with contents identical to an earlier chunk share its storage.
+static iree_status_t iree_io_parameter_archive_chunking_layout(
+    iree_io_parameter_archive_chunking_t* chunking, bool deduplicate,
+    iree_io_parameter_archive_builder_t* builder) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
-  iree_io_parameter_archive_builder_t builder;
-  iree_io_parameter_archive_builder_initialize(host_allocator, &builder);
+  // Open-addressed table of job indices keyed by content hash.
+  iree_host_size_t* table = NULL;
+  iree_host_size_t table_mask = 0;
+  if (deduplicate && chunking->job_count) {
+    iree_host_size_t table_capacity = 16;
+    while (table_capacity < chunking->job_count * 2) table_capacity <<= 1;
+    IREE_RETURN_AND_END_ZONE_IF_ERROR(
+        z0, iree_allocator_malloc_uninitialized(
+                chunking->host_allocator, table_capacity * sizeof(*table),
+                (void**)&table));
+    memset(table, 0xFF, table_capacity * sizeof(*table));
+    table_mask = table_capacity - 1;
+  }
 
-  // Declare a parameter for each entry in the index.
-  // This lets us calculate the size we require to store the entry metadata and
-  // its contents (if any). No data is accessed yet.
+  iree_io_parameter_archive_worker_t worker;
+  memset(&worker, 0, sizeof(worker));
   iree_status_t status = iree_ok_status();
+  iree_host_size_t duplicate_count = 0;
+  for (iree_host_size_t i = 0; i < chunking->job_count; ++i) {
+    iree_io_parameter_archive_chunk_job_t* job = &chunking->jobs[i];
+    if (table) {
+      iree_host_size_t slot = (iree_host_size_t)job->content_hash & table_mask;
+      for (; table[slot] != IREE_HOST_SIZE_MAX;
+           slot = (slot + 1) & table_mask) {
+        bool equal = false;
+        status = iree_io_parameter_archive_chunks_equal(
+            chunking, &worker, &chunking->jobs[table[slot]], job, &equal);
+        if (!iree_status_is_ok(status)) break;
+        if (equal) {
+          job->storage_job = table[slot];
+          break;
+        }
+      }
+      if (!iree_status_is_ok(status)) break;
+      if (job->storage_job == i) table[slot] = i;
+    }
+    if (job->storage_job == i) {
+      job->storage_offset = iree_io_parameter_archive_builder_reserve_storage(
+          builder, IREE_IO_PARAMETER_ARCHIVE_DEFAULT_DATA_ALIGNMENT,
+          job->encoded_length);
+    } else {
+      // Encoding is deterministic so identical contents encode identically.
+      const iree_io_parameter_archive_chunk_job_t* storage_job =
+          &chunking->jobs[job->storage_job];
+      job->codec = storage_job->codec;
+      job->encoded_length = storage_job->encoded_length;
+      job->storage_offset = storage_job->storage_offset;
+      ++duplicate_count;
+    }
+  }
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)duplicate_count);
+
+  iree_io_parameter_archive_worker_release_scratch(&worker,
+                                                   chunking->host_allocator);
+  iree_allocator_free(chunking->host_allocator, table);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+// Encodes and writes the chunk at |job_index| to its storage in the target if
+// it is not sharing storage with another chunk.
+static iree_status_t iree_io_parameter_archive_write_chunk(
+    void* user_data, iree_io_parameter_archive_worker_t* worker,
+    uint64_t job_index) {
+  iree_io_parameter_archive_chunking_t* chunking =
+      (iree_io_parameter_archive_chunking_t*)user_data;
+  const iree_io_parameter_archive_chunk_job_t* job =
+      &chunking->jobs[job_index];
+  if (job->storage_job != job_index) return iree_ok_status();
+  const uint8_t* contents = NULL;
+  IREE_RETURN_IF_ERROR(iree_io_parameter_archive_chunk_contents(
+      chunking, worker, 0, job, &contents));
+  const iree_io_physical_offset_t target_offset =
+      chunking->target_storage_offset + job->storage_offset;
+  if (job->codec == IREE_IO_PARAMETER_CODEC_NONE) {
+    return iree_io_file_handle_write(
+        chunking->target_handle, target_offset,
+        iree_make_const_byte_span(contents, job->length));
+  }
+  uint8_t* encoded = NULL;
+  IREE_RETURN_IF_ERROR(iree_io_parameter_archive_worker_scratch(
+      worker, chunking->host_allocator, 1, job->encoded_length, &encoded));
+  iree_host_size_t encoded_length = 0;
+  IREE_RETURN_IF_ERROR(iree_io_parameter_codec_encode(
+      job->codec, iree_make_const_byte_span(contents, job->length),
+      iree_make_byte_span(encoded, job->encoded_length), &encoded_length));
+  if (encoded_length != job->encoded_length) {
+    return iree_make_status(IREE_STATUS_INTERNAL,
+                            "chunk encoded to %" PRIhsz
+                            " bytes but %" PRIhsz " were reserved",
+                            encoded_length, job->encoded_length);
+  }
+  return iree_io_file_handle_write(
+      chunking->target_handle, target_offset,
+      iree_make_const_byte_span(encoded, encoded_length));
+}
+
+// Declares a chunked entry in |builder| for |source_entry| using the chunks
+// starting at |*inout_job_cursor|.
+static iree_status_t iree_io_parameter_archive_builder_declare_chunked_entry(
+    iree_io_parameter_archive_builder_t* builder,
+    const iree_io_parameter_index_entry_t* source_entry,
+    const iree_io_parameter_archive_chunking_t* chunking,
+    iree_host_size_t* inout_job_cursor) {
+  const iree_host_size_t chunk_count =
+      (iree_host_size_t)iree_io_parameter_archive_chunk_count(
+          source_entry->length, chunking->chunk_size);
+  iree_io_parameter_index_chunk_t* chunks = NULL;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      chunking->host_allocator, chunk_count * sizeof(*chunks),
+      (void**)&chunks));
+  for (iree_host_size_t i = 0; i < chunk_count; ++i) {
+    const iree_io_parameter_archive_chunk_job_t* job =
+        &chunking->jobs[*inout_job_cursor + i];
+    chunks[i].offset = job->storage_offset;
+    chunks[i].length = job->encoded_length;
+    chunks[i].content_hash = job->content_hash;
+    chunks[i].codec = job->codec;
+  }
+  *inout_job_cursor += chunk_count;
+  iree_status_t status = iree_io_parameter_archive_builder_add_chunked_entry(
+      builder, source_entry->key, source_entry->metadata, source_entry->length,
+      chunking->chunk_size, chunk_count, chunks);
+  iree_allocator_free(chunking->host_allocator, chunks);
+  return status;
+}
+
+//===----------------------------------------------------------------------===//
+// Archive construction
+//===----------------------------------------------------------------------===//
+
+// Declares an entry in |builder| for each entry in |source_index|. If
+// |chunking| is provided all non-empty data entries are declared as chunked
+// entries referencing its chunks.
+static iree_status_t iree_io_parameter_archive_builder_declare_index(
+    iree_io_parameter_archive_builder_t* builder,
+    iree_io_parameter_index_t* source_index,
+    const iree_io_parameter_archive_chunking_t* chunking) {
+  iree_host_size_t job_cursor = 0;
   for (iree_host_size_t i = 0; i < iree_io_parameter_index_count(source_index);
        ++i) {
     const iree_io_parameter_index_entry_t* source_entry = NULL;
-    status = iree_io_parameter_index_get(source_index, i, &source_entry);
-    if (!iree_status_is_ok(status)) break;
+    IREE_RETURN_IF_ERROR(
+        iree_io_parameter_index_get(source_index, i, &source_entry));
     switch (source_entry->type) {
       case IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_SPLAT:
-        status = iree_io_parameter_archive_builder_add_splat_entry(
-            &builder, source_entry->key, source_entry->metadata,
+        IREE_RETURN_IF_ERROR(iree_io_parameter_archive_builder_add_splat_entry(
+            builder, source_entry->key, source_entry->metadata,
             source_entry->storage.splat.pattern,
-            source_entry->storage.splat.pattern_length, source_entry->length);
+            source_entry->storage.splat.pattern_length, source_entry->length));
         break;
       case IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_FILE:
-        status = iree_io_parameter_archive_builder_add_data_entry(
-            &builder, source_entry->key, source_entry->metadata,
+        if (chunking && source_entry->length) {
+          IREE_RETURN_IF_ERROR(
+              iree_io_parameter_archive_builder_declare_chunked_entry(
+                  builder, source_entry, chunking, &job_cursor));
+          break;
+        }
+        IREE_RETURN_IF_ERROR(iree_io_parameter_archive_builder_add_data_entry(
+            builder, source_entry->key, source_entry->metadata,
             IREE_IO_PARAMETER_ARCHIVE_DEFAULT_DATA_ALIGNMENT,
-            source_entry->length);
+            source_entry->length));
         break;
       default:
-        status = iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
-                                  "unhandled index entry storage type %d",
-                                  (int)source_entry->type);
-        break;
+        return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                                "unhandled index entry storage type %d",
+                                (int)source_entry->type);
+    }
+  }
+  return iree_ok_status();
+}
+
+// Writes the archive header, entry table, and metadata of |builder| to
+// |target_file_handle| at |target_file_offset| with a single positioned write
+// and appends entries to |target_index| referencing the file.
+static iree_status_t iree_io_parameter_archive_builder_write_header(
+    const iree_io_parameter_archive_builder_t* builder,
+    iree_io_file_handle_t* target_file_handle,
+    iree_io_physical_offset_t target_file_offset,
+    iree_io_parameter_index_t* target_index, iree_allocator_t host_allocator) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Everything up to the storage segment is produced in memory; it is small
+  // relative to the parameter contents.
+  iree_host_size_t header_length =
+      (iree_host_size_t)iree_io_parameter_archive_builder_storage_offset(
+          builder);
+  uint8_t* header_data = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(host_allocator, header_length,
+                                (void**)&header_data));
+  iree_io_stream_t* header_stream = NULL;
+  iree_status_t status = iree_io_memory_stream_wrap(
+      IREE_IO_STREAM_MODE_WRITABLE | IREE_IO_STREAM_MODE_SEEKABLE,
+      iree_make_byte_span(header_data, header_length),
+      iree_io_memory_stream_release_callback_null(), host_allocator,
+      &header_stream);
+  if (iree_status_is_ok(status)) {
+    status = iree_io_parameter_archive_builder_write(
+        builder, target_file_handle, target_file_offset, header_stream,
+        target_index);
+  }
+  iree_io_stream_release(header_stream);
+  if (iree_status_is_ok(status)) {
+    status = iree_io_file_handle_write(
+        target_file_handle, target_file_offset,
+        iree_make_const_byte_span(header_data, header_length));
+  }
+  iree_allocator_free(host_allocator, header_data);
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+IREE_API_EXPORT iree_status_t iree_io_build_parameter_archive(
+    iree_io_parameter_index_t* source_index,
+    iree_io_parameter_index_t* target_index,
+    iree_io_parameter_archive_file_open_callback_t target_file_open,
+    iree_io_physical_offset_t target_file_offset,
+    iree_allocator_t host_allocator) {
+  iree_io_parameter_archive_build_options_t options;
+  memset(&options, 0, sizeof(options));
+  options.max_concurrency = 1;
+  return iree_io_build_parameter_archive_with_options(
+      source_index, target_index, target_file_open, target_file_offset,
+      options, host_allocator);
+}
+
+IREE_API_EXPORT iree_status_t iree_io_build_parameter_archive_with_options(
+    iree_io_parameter_index_t* source_index,
+    iree_io_parameter_index_t* target_index,
+    iree_io_parameter_archive_file_open_callback_t target_file_open,
+    iree_io_physical_offset_t target_file_offset,
+    iree_io_parameter_archive_build_options_t options,
+    iree_allocator_t host_allocator) {
+  IREE_ASSERT_ARGUMENT(source_index);
+  IREE_ASSERT_ARGUMENT(target_index);
+  IREE_ASSERT_ARGUMENT(target_file_open.fn);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  const iree_io_physical_size_t chunk_size =
+      options.chunk_size ? options.chunk_size
+                         : IREE_IO_PARAMETER_ARCHIVE_BUILD_DEFAULT_CHUNK_SIZE;
+  if (chunk_size > IREE_HOST_SIZE_MAX) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "chunk size %" PRIu64
+                            " exceeds the host address space",
+                            chunk_size);
+  }
+  const bool deduplicate = iree_all_bits_set(
+      options.flags, IREE_IO_PARAMETER_ARCHIVE_BUILD_FLAG_DEDUPLICATE);
+  const bool use_chunking =
+      deduplicate || options.codec != IREE_IO_PARAMETER_CODEC_NONE;
+
+  iree_io_parameter_archive_builder_t builder;
+  iree_io_parameter_archive_builder_initialize(host_allocator, &builder);
+
+  // When storing chunked entries the archive layout depends on the contents
+  // of each chunk so all chunks are hashed and encoded up-front to determine
+  // their final size and which can share storage. The encoded contents are
+  // discarded and produced again when written to avoid keeping them resident.
+  iree_io_parameter_archive_chunking_t chunking;
+  memset(&chunking, 0, sizeof(chunking));
+  iree_status_t status = iree_ok_status();
+  if (use_chunking) {
+    status = iree_io_parameter_archive_chunking_initialize(
+        source_index, chunk_size, options.codec, host_allocator, &chunking);
+    if (iree_status_is_ok(status)) {
+      status = iree_io_parameter_archive_parallel_for(
+          chunking.job_count, options.max_concurrency,
+          iree_io_parameter_archive_measure_chunk, &chunking, host_allocator);
+    }
+    if (iree_status_is_ok(status)) {
+      status = iree_io_parameter_archive_chunking_layout(&chunking,
+                                                         deduplicate, &builder);
     }
-    if (!iree_status_is_ok(status)) break;
+  }
+
+  // Declare a parameter for each entry in the index.
+  // This lets us calculate the size we require to store the entry metadata and
+  // its contents (if any). Unless chunking no data is accessed yet.
+  if (iree_status_is_ok(status)) {
+    status = iree_io_parameter_archive_builder_declare_index(
+        &builder, source_index, use_chunking ? &chunking : NULL);
   }
 
   // Open a file of sufficient size (now that we know it) for writing.
@@ -353,60 +1167,43 @@ IREE_API_EXPORT iree_status_t iree_io_build_parameter_archive(
                                  archive_length, &target_file_handle);
   }
 
-  // Wrap the target file in a stream.
-  iree_io_stream_t* target_stream = NULL;
-  if (iree_status_is_ok(status)) {
-    status =
-        iree_io_stream_open(IREE_IO_STREAM_MODE_WRITABLE, target_file_handle,
-                            target_file_offset, host_allocator, &target_stream);
-  }
-
   // Commit the archive header to the file and produce an index referencing it.
   // This will allow us to know where to copy file contents.
   if (iree_status_is_ok(status)) {
-    status = iree_io_parameter_archive_builder_write(
-        &builder, target_file_handle, target_file_offset, target_stream,
-        target_index);
+    status = iree_io_parameter_archive_builder_write_header(
+        &builder, target_file_handle, target_file_offset, target_index,
+        host_allocator);
   }
 
-  // Copy over parameter entry file contents (if any).
-  // This is a slow operation and something we could optimize with lower-level
-  // platform primitives.
-  if (iree_status_is_ok(status)) {
-    for (iree_host_size_t i = 0;
-         i < iree_io_parameter_index_count(source_index); ++i) {
-      const iree_io_parameter_index_entry_t* source_entry = NULL;
-      status = iree_io_parameter_index_get(source_index, i, &source_entry);
-      if (!iree_status_is_ok(status)) break;
-      const iree_io_parameter_index_entry_t* target_entry = NULL;
-      status = iree_io_parameter_index_lookup(target_index, source_entry->key,
-                                              &target_entry);
-      if (!iree_status_is_ok(status)) break;
-      switch (source_entry->type) {
-        case IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_SPLAT:
-          // No work to do.
-          break;
-        case IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_FILE:
-          status = iree_io_stream_seek(
-              target_stream, IREE_IO_STREAM_SEEK_SET,
-              target_file_offset + target_entry->storage.file.offset);
-          if (!iree_status_is_ok(status)) break;
-          status = iree_io_stream_write_file(
-              target_stream, source_entry->storage.file.handle,
-              source_entry->storage.file.offset, target_entry->length,
-              host_allocator);
-          break;
-        default:
-          status = iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
-                                    "unhandled index entry storage type %d",
-                                    (int)source_entry->type);
-          break;
-      }
-      if (!iree_status_is_ok(status)) break;
-    }
+  // Write chunked entry contents. Each unique chunk has a fixed location in
+  // the target now that the layout is known.
+  if (iree_status_is_ok(status) && use_chunking) {
+    chunking.target_handle = target_file_handle;
+    chunking.target_storage_offset =
+        target_file_offset +
+        iree_io_parameter_archive_builder_storage_offset(&builder);
+    status = iree_io_parameter_archive_parallel_for(
+        chunking.job_count, options.max_concurrency,
+        iree_io_parameter_archive_write_chunk, &chunking, host_allocator);
   }
+  iree_io_parameter_archive_chunking_deinitialize(&chunking);
 
-  iree_io_stream_release(target_stream);
+  // Copy over parameter entry file contents (if any). Each chunk has a fixed
+  // location in the target now that the layout is known and can be copied
+  // independently of all others.
+  iree_io_parameter_archive_copy_t copy;
+  memset(&copy, 0, sizeof(copy));
+  if (iree_status_is_ok(status)) {
+    status = iree_io_parameter_archive_copy_initialize(
+        source_index, target_index, target_file_handle, target_file_offset,
+        chunk_size, host_allocator, &copy);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_io_parameter_archive_parallel_for(
+        copy.chunk_count, options.max_concurrency,
+        iree_io_parameter_archive_copy_chunk, &copy, host_allocator);
+  }
+  iree_io_parameter_archive_copy_deinitialize(&copy);
 
   // Flush file contents before returning to the caller (in case they open the
   // file via a different handle).
@@ -88,6 +88,28 @@ IREE_API_EXPORT iree_status_t iree_io_parameter_archive_builder_add_data_entry(
     iree_const_byte_span_t metadata, iree_io_physical_size_t minimum_alignment,
     iree_io_physical_size_t data_length);
 
+// Reserves |length| bytes in the storage segment of |builder| aligned to at
+// least |minimum_alignment| that are not associated with any single entry and
+// returns the offset of the range relative to the storage segment. Used to
+// place chunks that may be shared by multiple chunked entries.
+IREE_API_EXPORT iree_io_physical_offset_t
+iree_io_parameter_archive_builder_reserve_storage(
+    iree_io_parameter_archive_builder_t* builder,
+    iree_io_physical_size_t minimum_alignment, iree_io_physical_size_t length);
+
+// Adds a new chunked entry to |builder|.
+// |metadata| (if provided) and |chunks| are copied prior to returning.
+// |chunks| must contain exactly ceil(|data_length| / |chunk_size|) chunks with
+// offsets relative to the storage segment that have been reserved with
+// iree_io_parameter_archive_builder_reserve_storage. Multiple chunks (in the
+// same or different entries) may reference the same storage.
+IREE_API_EXPORT iree_status_t
+iree_io_parameter_archive_builder_add_chunked_entry(
+    iree_io_parameter_archive_builder_t* builder, iree_string_view_t name,
+    iree_const_byte_span_t metadata, iree_io_physical_size_t data_length,
+    iree_io_physical_size_t chunk_size, iree_host_size_t chunk_count,
+    const iree_io_parameter_index_chunk_t* chunks);
+
 // Callback for opening a file for writing.
 // Implementations need to ensure that at least |archive_length| bytes are
 // available in the file starting at |archive_offset|.
@@ -117,6 +139,68 @@ IREE_API_EXPORT iree_status_t iree_io_build_parameter_archive(
     iree_io_physical_offset_t target_file_offset,
     iree_allocator_t host_allocator);
 
+// Default size of each positioned read/write issued when copying parameter
+// contents into an archive.
+#define IREE_IO_PARAMETER_ARCHIVE_BUILD_DEFAULT_CHUNK_SIZE (8 * 1024 * 1024)
+
+// Controls how parameter contents are stored in the archive.
+enum iree_io_parameter_archive_build_flag_bits_t {
+  IREE_IO_PARAMETER_ARCHIVE_BUILD_FLAG_NONE = 0u,
+  // Parameters with identical chunks (within a parameter or across parameters)
+  // share a single copy of the chunk in the archive. Candidate chunks are found
+  // by content hash and verified byte-for-byte before being shared.
+  IREE_IO_PARAMETER_ARCHIVE_BUILD_FLAG_DEDUPLICATE = 1u << 0,
+};
+typedef uint32_t iree_io_parameter_archive_build_flags_t;
+
+// Options controlling how parameter contents are copied into the archive by
+// iree_io_build_parameter_archive_with_options.
+typedef struct iree_io_parameter_archive_build_options_t {
+  // Maximum number of threads (including the calling thread) used to copy
+  // parameter contents. 0 or 1 copies all contents on the calling thread.
+  iree_host_size_t max_concurrency;
+  // Size of each positioned read/write used to copy parameter contents. This
+  // is the unit of work distributed across threads and bounds the transient
+  // memory used per thread when neither the source nor the target is directly
+  // addressable. 0 uses IREE_IO_PARAMETER_ARCHIVE_BUILD_DEFAULT_CHUNK_SIZE.
+  // When deduplicating or encoding this is also the size of each chunk of the
+  // resulting chunked entries.
+  iree_io_physical_size_t chunk_size;
+  // Flags controlling how contents are stored.
+  iree_io_parameter_archive_build_flags_t flags;
+  // Codec used to encode each chunk. Chunks that do not shrink when encoded
+  // are stored as-is.
+  iree_io_parameter_codec_t codec;
+} iree_io_parameter_archive_build_options_t;
+
+// Builds a parameter archive as with iree_io_build_parameter_archive using the
+// provided |options|.
+//
+// The full archive layout is computed before any contents are copied and each
+// chunk of each parameter is then written to its final location with a
+// positioned write. Chunks are distributed across up to
+// |options.max_concurrency| threads with no ordering between them. Source
+// contents are streamed a chunk at a time: host allocations (such as mapped
+// files) are copied directly without intermediate buffers and file descriptors
+// are read on demand so the whole source is never resident at once.
+//
+// If deduplication is enabled or a codec is specified all non-empty data
+// parameters are stored as chunked entries. Each chunk is hashed and encoded in
+// parallel once to determine the archive layout and then encoded again when
+// written so that the encoded contents never need to be resident all at once.
+//
+// The file handle returned by |target_file_open| may be either a host
+// allocation or a file descriptor; file descriptors avoid mapping the entire
+// archive into the address space and let the OS write back pages as they are
+// produced.
+IREE_API_EXPORT iree_status_t iree_io_build_parameter_archive_with_options(
+    iree_io_parameter_index_t* source_index,
+    iree_io_parameter_index_t* target_index,
+    iree_io_parameter_archive_file_open_callback_t target_file_open,
+    iree_io_physical_offset_t target_file_offset,
+    iree_io_parameter_archive_build_options_t options,
+    iree_allocator_t host_allocator);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
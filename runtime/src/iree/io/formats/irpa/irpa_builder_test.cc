@@ -0,0 +1,247 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/io/formats/irpa/irpa_builder.h"
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "iree/io/formats/irpa/irpa_parser.h"
+#include "iree/io/parameter_codec.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace iree {
+namespace {
+
+// Opens the target archive as a host allocation backed by |storage|.
+static iree_status_t OpenVectorFile(void* user_data,
+                                    iree_io_physical_offset_t archive_offset,
+                                    iree_io_physical_size_t archive_length,
+                                    iree_io_file_handle_t** out_file_handle) {
+  auto* storage = reinterpret_cast<std::vector<uint8_t>*>(user_data);
+  storage->resize(archive_offset + archive_length, 0xCD);
+  return iree_io_file_handle_wrap_host_allocation(
+      IREE_IO_FILE_ACCESS_READ | IREE_IO_FILE_ACCESS_WRITE,
+      iree_make_byte_span(storage->data(), storage->size()),
+      iree_io_file_handle_release_callback_null(), iree_allocator_system(),
+      out_file_handle);
+}
+
+static std::vector<uint8_t> MakePattern(size_t length, uint8_t seed) {
+  std::vector<uint8_t> pattern(length);
+  for (size_t i = 0; i < length; ++i) {
+    pattern[i] = (uint8_t)(i * 13 + seed);
+  }
+  return pattern;
+}
+
+class IrpaBuilderTest : public ::testing::TestWithParam<
+                            iree_io_parameter_archive_build_options_t> {};
+
+// Builds an archive from a source index with a mix of splat and data entries
+// and verifies the parsed result references the original contents.
+TEST_P(IrpaBuilderTest, RoundTrip) {
+  // Source file contains all data parameters back-to-back at odd offsets.
+  const size_t lengths[] = {1, 4096, 3 * 1000 + 7, 0, 70 * 1024 + 3};
+  std::vector<uint8_t> source_contents = MakePattern(100 * 1024, 5);
+  iree_io_file_handle_t* source_handle = NULL;
+  IREE_ASSERT_OK(iree_io_file_handle_wrap_host_allocation(
+      IREE_IO_FILE_ACCESS_READ,
+      iree_make_byte_span(source_contents.data(), source_contents.size()),
+      iree_io_file_handle_release_callback_null(), iree_allocator_system(),
+      &source_handle));
+
+  iree_io_parameter_index_t* source_index = NULL;
+  IREE_ASSERT_OK(
+      iree_io_parameter_index_create(iree_allocator_system(), &source_index));
+  std::vector<std::string> names;
+  for (size_t i = 0; i < IREE_ARRAYSIZE(lengths); ++i) {
+    names.push_back("data" + std::to_string(i));
+  }
+  size_t source_offset = 3;
+  for (size_t i = 0; i < IREE_ARRAYSIZE(lengths); ++i) {
+    iree_io_parameter_index_entry_t entry = {};
+    entry.key = iree_make_string_view(names[i].data(), names[i].size());
+    entry.metadata = iree_const_byte_span_empty();
+    entry.length = lengths[i];
+    entry.type = IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_FILE;
+    entry.storage.file.handle = source_handle;
+    entry.storage.file.offset = source_offset;
+    IREE_ASSERT_OK(iree_io_parameter_index_add(source_index, &entry));
+    source_offset += lengths[i] + 1;
+  }
+  iree_io_parameter_index_entry_t splat_entry = {};
+  splat_entry.key = IREE_SV("splat");
+  splat_entry.metadata = iree_const_byte_span_empty();
+  splat_entry.length = 1024;
+  splat_entry.type = IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_SPLAT;
+  splat_entry.storage.splat.pattern[0] = 0xAB;
+  splat_entry.storage.splat.pattern_length = 1;
+  IREE_ASSERT_OK(iree_io_parameter_index_add(source_index, &splat_entry));
+
+  // Build the archive.
+  std::vector<uint8_t> target_contents;
+  iree_io_parameter_index_t* built_index = NULL;
+  IREE_ASSERT_OK(
+      iree_io_parameter_index_create(iree_allocator_system(), &built_index));
+  iree_io_parameter_archive_file_open_callback_t open_callback = {
+      OpenVectorFile,
+      &target_contents,
+  };
+  IREE_ASSERT_OK(iree_io_build_parameter_archive_with_options(
+      source_index, built_index, open_callback, /*target_file_offset=*/0,
+      GetParam(), iree_allocator_system()));
+  EXPECT_EQ(iree_io_parameter_index_count(built_index),
+            iree_io_parameter_index_count(source_index));
+
+  // Parse the archive back and verify contents.
+  iree_io_file_handle_t* target_handle = NULL;
+  IREE_ASSERT_OK(iree_io_file_handle_wrap_host_allocation(
+      IREE_IO_FILE_ACCESS_READ,
+      iree_make_byte_span(target_contents.data(), target_contents.size()),
+      iree_io_file_handle_release_callback_null(), iree_allocator_system(),
+      &target_handle));
+  iree_io_parameter_index_t* parsed_index = NULL;
+  IREE_ASSERT_OK(
+      iree_io_parameter_index_create(iree_allocator_system(), &parsed_index));
+  IREE_ASSERT_OK(iree_io_parse_irpa_index(target_handle, parsed_index));
+  ASSERT_EQ(iree_io_parameter_index_count(parsed_index),
+            iree_io_parameter_index_count(source_index));
+  source_offset = 3;
+  for (size_t i = 0; i < IREE_ARRAYSIZE(lengths); ++i) {
+    const iree_io_parameter_index_entry_t* entry = NULL;
+    IREE_ASSERT_OK(iree_io_parameter_index_lookup(
+        parsed_index, iree_make_string_view(names[i].data(), names[i].size()),
+        &entry));
+    ASSERT_EQ(entry->length, lengths[i]);
+    std::vector<uint8_t> expected(
+        source_contents.begin() + source_offset,
+        source_contents.begin() + source_offset + lengths[i]);
+    std::vector<uint8_t> actual(lengths[i]);
+    if (entry->type == IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_CHUNKED) {
+      IREE_ASSERT_OK(iree_io_parameter_chunked_entry_read(
+          entry, 0, iree_make_byte_span(actual.data(), actual.size()),
+          /*max_concurrency=*/4, iree_allocator_system()));
+    } else {
+      ASSERT_EQ(entry->type, IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_FILE);
+      memcpy(actual.data(), target_contents.data() + entry->storage.file.offset,
+             lengths[i]);
+    }
+    EXPECT_EQ(actual, expected) << names[i];
+    source_offset += lengths[i] + 1;
+  }
+  const iree_io_parameter_index_entry_t* parsed_splat = NULL;
+  IREE_ASSERT_OK(iree_io_parameter_index_lookup(parsed_index, IREE_SV("splat"),
+                                                &parsed_splat));
+  EXPECT_EQ(parsed_splat->type,
+            IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_SPLAT);
+  EXPECT_EQ(parsed_splat->length, 1024u);
+  EXPECT_EQ(parsed_splat->storage.splat.pattern[0], 0xAB);
+
+  iree_io_parameter_index_release(parsed_index);
+  iree_io_file_handle_release(target_handle);
+  iree_io_parameter_index_release(built_index);
+  iree_io_parameter_index_release(source_index);
+  iree_io_file_handle_release(source_handle);
+}
+
+// Builds an archive with two parameters referencing the same contents and
+// verifies that their chunks share storage.
+TEST(IrpaBuilderDeduplicationTest, SharedChunks) {
+  std::vector<uint8_t> source_contents = MakePattern(10 * 1024, 9);
+  iree_io_file_handle_t* source_handle = NULL;
+  IREE_ASSERT_OK(iree_io_file_handle_wrap_host_allocation(
+      IREE_IO_FILE_ACCESS_READ,
+      iree_make_byte_span(source_contents.data(), source_contents.size()),
+      iree_io_file_handle_release_callback_null(), iree_allocator_system(),
+      &source_handle));
+  iree_io_parameter_index_t* source_index = NULL;
+  IREE_ASSERT_OK(
+      iree_io_parameter_index_create(iree_allocator_system(), &source_index));
+  const char* names[] = {"a", "b"};
+  for (const char* name : names) {
+    iree_io_parameter_index_entry_t entry = {};
+    entry.key = iree_make_cstring_view(name);
+    entry.metadata = iree_const_byte_span_empty();
+    entry.length = source_contents.size();
+    entry.type = IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_FILE;
+    entry.storage.file.handle = source_handle;
+    entry.storage.file.offset = 0;
+    IREE_ASSERT_OK(iree_io_parameter_index_add(source_index, &entry));
+  }
+
+  std::vector<uint8_t> target_contents;
+  iree_io_parameter_index_t* built_index = NULL;
+  IREE_ASSERT_OK(
+      iree_io_parameter_index_create(iree_allocator_system(), &built_index));
+  iree_io_parameter_archive_file_open_callback_t open_callback = {
+      OpenVectorFile,
+      &target_contents,
+  };
+  iree_io_parameter_archive_build_options_t options = {};
+  options.max_concurrency = 2;
+  options.chunk_size = 4096;
+  options.flags = IREE_IO_PARAMETER_ARCHIVE_BUILD_FLAG_DEDUPLICATE;
+  IREE_ASSERT_OK(iree_io_build_parameter_archive_with_options(
+      source_index, built_index, open_callback, /*target_file_offset=*/0,
+      options, iree_allocator_system()));
+  // Only one copy of the contents is stored.
+  EXPECT_LT(target_contents.size(), 2 * source_contents.size());
+
+  const iree_io_parameter_index_entry_t* a = NULL;
+  IREE_ASSERT_OK(
+      iree_io_parameter_index_lookup(built_index, IREE_SV("a"), &a));
+  const iree_io_parameter_index_entry_t* b = NULL;
+  IREE_ASSERT_OK(
+      iree_io_parameter_index_lookup(built_index, IREE_SV("b"), &b));
+  ASSERT_EQ(a->type, IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_CHUNKED);
+  ASSERT_EQ(b->type, IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_CHUNKED);
+  ASSERT_EQ(a->storage.chunked.chunk_count, 3u);
+  ASSERT_EQ(b->storage.chunked.chunk_count, 3u);
+  for (iree_host_size_t i = 0; i < a->storage.chunked.chunk_count; ++i) {
+    EXPECT_EQ(a->storage.chunked.chunks[i].offset,
+              b->storage.chunked.chunks[i].offset);
+  }
+  std::vector<uint8_t> result(source_contents.size());
+  IREE_ASSERT_OK(iree_io_parameter_chunked_entry_read(
+      b, 0, iree_make_byte_span(result.data(), result.size()), 1,
+      iree_allocator_system()));
+  EXPECT_EQ(result, source_contents);
+
+  iree_io_parameter_index_release(built_index);
+  iree_io_parameter_index_release(source_index);
+  iree_io_file_handle_release(source_handle);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    BuildOptions, IrpaBuilderTest,
+    ::testing::Values(
+        // Serial with the default chunk size.
+        iree_io_parameter_archive_build_options_t{1, 0},
+        // Serial with small chunks so that parameters span multiple chunks.
+        iree_io_parameter_archive_build_options_t{1, 1000},
+        // Parallel with small chunks.
+        iree_io_parameter_archive_build_options_t{4, 1000},
+        // More threads than there are chunks.
+        iree_io_parameter_archive_build_options_t{64, 0},
+        // Deduplicated chunks.
+        iree_io_parameter_archive_build_options_t{
+            4, 1000, IREE_IO_PARAMETER_ARCHIVE_BUILD_FLAG_DEDUPLICATE,
+            IREE_IO_PARAMETER_CODEC_NONE},
+        // Compressed chunks.
+        iree_io_parameter_archive_build_options_t{
+            4, 1000, IREE_IO_PARAMETER_ARCHIVE_BUILD_FLAG_NONE,
+            IREE_IO_PARAMETER_CODEC_LZ4_BLOCK},
+        // Deduplicated and compressed chunks on a single thread.
+        iree_io_parameter_archive_build_options_t{
+            1, 4096, IREE_IO_PARAMETER_ARCHIVE_BUILD_FLAG_DEDUPLICATE,
+            IREE_IO_PARAMETER_CODEC_LZ4_BLOCK}));
+
+}  // namespace
+}  // namespace iree
@@ -154,6 +154,95 @@ static iree_status_t iree_io_parse_irpa_v0_data_entry(
   return iree_io_parameter_index_add(index, &entry);
 }
 
+static iree_status_t iree_io_parse_irpa_v0_chunked_entry(
+    iree_io_file_handle_t* file_handle, iree_const_byte_span_t file_contents,
+    iree_io_physical_offset_t base_offset,
+    const iree_io_parameter_archive_header_v0_t* header,
+    const iree_io_parameter_archive_chunked_entry_t* chunked_entry,
+    iree_string_view_t name, iree_const_byte_span_t metadata,
+    iree_io_parameter_index_t* index) {
+  if (chunked_entry->header.entry_size < sizeof(*chunked_entry)) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "chunked entry length underflow");
+  }
+  if (chunked_entry->chunk_size == 0) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "chunked entry has a zero chunk size");
+  }
+  const uint64_t chunk_count =
+      chunked_entry->length / chunked_entry->chunk_size +
+      (chunked_entry->length % chunked_entry->chunk_size != 0 ? 1 : 0);
+  const uint64_t table_length = chunked_entry->chunk_table.length;
+  const uint64_t record_size = sizeof(iree_io_parameter_archive_chunk_t);
+  if (chunk_count >
+          IREE_HOST_SIZE_MAX / sizeof(iree_io_parameter_index_chunk_t) ||
+      table_length % record_size != 0 ||
+      table_length / record_size != chunk_count) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "chunk table size %" PRIu64
+                            " does not match the %" PRIu64
+                            " chunks required by the entry length",
+                            table_length, chunk_count);
+  }
+  iree_const_byte_span_t chunk_table = iree_const_byte_span_empty();
+  IREE_RETURN_IF_ERROR(iree_io_resolve_irpa_v0_metadata(
+                           file_contents, base_offset, header,
+                           chunked_entry->chunk_table, &chunk_table),
+                       "resolving chunk table");
+
+  // Convert the chunk table into the index form with file-relative offsets.
+  // The index clones the table when the entry is added.
+  iree_allocator_t host_allocator = iree_allocator_system();
+  iree_io_parameter_index_chunk_t* chunks = NULL;
+  if (chunk_count > 0) {
+    IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+        host_allocator, (iree_host_size_t)chunk_count * sizeof(*chunks),
+        (void**)&chunks));
+  }
+  iree_status_t status = iree_ok_status();
+  for (iree_host_size_t i = 0; i < chunk_count; ++i) {
+    // The metadata segment has no alignment requirements.
+    iree_io_parameter_archive_chunk_t chunk;
+    memcpy(&chunk, chunk_table.data + i * sizeof(chunk), sizeof(chunk));
+    if (chunk.codec != IREE_IO_PARAMETER_ARCHIVE_CODEC_NONE &&
+        chunk.codec != IREE_IO_PARAMETER_ARCHIVE_CODEC_LZ4_BLOCK) {
+      status = iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                                "chunk %" PRIhsz " has unsupported codec %u",
+                                i, chunk.codec);
+      break;
+    }
+    status = iree_io_resolve_irpa_v0_storage(file_contents, base_offset,
+                                             header, chunk.storage,
+                                             &chunks[i].offset);
+    if (!iree_status_is_ok(status)) break;
+    chunks[i].length = chunk.storage.length;
+    chunks[i].content_hash = chunk.content_hash;
+    chunks[i].codec = (iree_io_parameter_codec_t)chunk.codec;
+  }
+
+  if (iree_status_is_ok(status)) {
+    iree_io_parameter_index_entry_t entry = {
+        .key = name,
+        .metadata = metadata,
+        .length = chunked_entry->length,
+        .type = IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_CHUNKED,
+        .storage =
+            {
+                .chunked =
+                    {
+                        .handle = file_handle,
+                        .chunk_size = chunked_entry->chunk_size,
+                        .chunk_count = (iree_host_size_t)chunk_count,
+                        .chunks = chunks,
+                    },
+            },
+    };
+    status = iree_io_parameter_index_add(index, &entry);
+  }
+  iree_allocator_free(host_allocator, chunks);
+  return status;
+}
+
 static iree_status_t iree_io_parse_irpa_v0_index_from_memory(
     iree_io_file_handle_t* file_handle, iree_const_byte_span_t file_contents,
     iree_io_physical_offset_t base_offset,
@@ -250,6 +339,13 @@ static iree_status_t iree_io_parse_irpa_v0_index_from_memory(
             metadata, index));
         break;
       }
+      case IREE_IO_PARAMETER_ARCHIVE_ENTRY_TYPE_CHUNKED: {
+        IREE_RETURN_IF_ERROR(iree_io_parse_irpa_v0_chunked_entry(
+            file_handle, file_contents, base_offset, header,
+            (const iree_io_parameter_archive_chunked_entry_t*)entry_header,
+            name, metadata, index));
+        break;
+      }
       default:
         return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
                                 "parser does not support entry type %d",
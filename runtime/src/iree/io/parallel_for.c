@@ -0,0 +1,168 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/io/parallel_for.h"
+
+#include "iree/base/internal/atomics.h"
+#include "iree/base/internal/synchronization.h"
+#include "iree/base/internal/threading.h"
+
+// Shared state for all threads participating in a loop.
+typedef struct iree_io_parallel_for_loop_t {
+  iree_io_parallel_for_fn_t fn;
+  void* user_data;
+  uint64_t work_count;
+  // Next work item to be claimed by any thread.
+  iree_atomic_int64_t next_work;
+  // Set when any thread fails so that others stop claiming work.
+  iree_atomic_int32_t failed;
+  // Number of spawned threads that have not yet finished their work.
+  iree_atomic_int32_t live_threads;
+  // Posted each time a spawned thread finishes.
+  iree_notification_t thread_exited;
+} iree_io_parallel_for_loop_t;
+
+// State for a single thread participating in a loop.
+typedef struct iree_io_parallel_for_worker_t {
+  iree_io_parallel_for_loop_t* loop;
+  iree_host_size_t worker_index;
+  iree_thread_t* thread;
+  iree_status_t status;
+} iree_io_parallel_for_worker_t;
+
+// Claims and processes work items until all have been claimed or any thread
+// fails.
+static void iree_io_parallel_for_worker_run(
+    iree_io_parallel_for_worker_t* worker) {
+  iree_io_parallel_for_loop_t* loop = worker->loop;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  while (!iree_atomic_load_int32(&loop->failed, iree_memory_order_acquire)) {
+    uint64_t work_index = (uint64_t)iree_atomic_fetch_add_int64(
+        &loop->next_work, 1, iree_memory_order_relaxed);
+    if (work_index >= loop->work_count) break;
+    worker->status =
+        loop->fn(loop->user_data, worker->worker_index, work_index);
+    if (!iree_status_is_ok(worker->status)) {
+      iree_atomic_store_int32(&loop->failed, 1, iree_memory_order_release);
+      break;
+    }
+  }
+  IREE_TRACE_ZONE_END(z0);
+}
+
+// Entry point for spawned threads that notifies the caller when done.
+static int iree_io_parallel_for_thread_main(void* entry_arg) {
+  iree_io_parallel_for_worker_t* worker =
+      (iree_io_parallel_for_worker_t*)entry_arg;
+  iree_io_parallel_for_loop_t* loop = worker->loop;
+  iree_io_parallel_for_worker_run(worker);
+  iree_atomic_fetch_sub_int32(&loop->live_threads, 1,
+                              iree_memory_order_acq_rel);
+  iree_notification_post(&loop->thread_exited, IREE_ALL_WAITERS);
+  return 0;
+}
+
+static bool iree_io_parallel_for_threads_exited(void* arg) {
+  iree_io_parallel_for_loop_t* loop = (iree_io_parallel_for_loop_t*)arg;
+  return iree_atomic_load_int32(&loop->live_threads,
+                                iree_memory_order_acquire) == 0;
+}
+
+IREE_API_EXPORT iree_host_size_t iree_io_parallel_for_worker_count(
+    uint64_t work_count, iree_host_size_t max_concurrency) {
+  iree_host_size_t worker_count = iree_max(1, max_concurrency);
+  if (worker_count > work_count) worker_count = (iree_host_size_t)work_count;
+  return worker_count;
+}
+
+IREE_API_EXPORT iree_status_t iree_io_parallel_for(
+    iree_string_view_t thread_name, uint64_t work_count,
+    iree_host_size_t max_concurrency, iree_io_parallel_for_fn_t fn,
+    void* user_data, iree_allocator_t host_allocator) {
+  IREE_ASSERT_ARGUMENT(fn);
+  if (!work_count) return iree_ok_status();
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)work_count);
+
+  iree_io_parallel_for_loop_t loop;
+  memset(&loop, 0, sizeof(loop));
+  loop.fn = fn;
+  loop.user_data = user_data;
+  loop.work_count = work_count;
+  iree_atomic_store_int64(&loop.next_work, 0, iree_memory_order_relaxed);
+  iree_atomic_store_int32(&loop.failed, 0, iree_memory_order_relaxed);
+  iree_atomic_store_int32(&loop.live_threads, 0, iree_memory_order_relaxed);
+
+  // Run inline when there's nothing to parallelize.
+  const iree_host_size_t worker_count =
+      iree_io_parallel_for_worker_count(work_count, max_concurrency);
+  if (worker_count == 1) {
+    iree_io_parallel_for_worker_t worker = {
+        .loop = &loop,
+        .worker_index = 0,
+        .thread = NULL,
+        .status = iree_ok_status(),
+    };
+    iree_io_parallel_for_worker_run(&worker);
+    IREE_TRACE_ZONE_END(z0);
+    return worker.status;
+  }
+
+  iree_io_parallel_for_worker_t* workers = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(host_allocator,
+                                worker_count * sizeof(*workers),
+                                (void**)&workers));
+  iree_notification_initialize(&loop.thread_exited);
+
+  // Spin up additional threads. If thread creation fails the remaining work is
+  // picked up by the threads that were created and the calling thread.
+  iree_thread_create_params_t thread_params;
+  memset(&thread_params, 0, sizeof(thread_params));
+  thread_params.name = thread_name;
+  for (iree_host_size_t i = 0; i < worker_count; ++i) {
+    workers[i].loop = &loop;
+    workers[i].worker_index = i;
+    workers[i].status = iree_ok_status();
+  }
+  for (iree_host_size_t i = 1; i < worker_count; ++i) {
+    iree_atomic_fetch_add_int32(&loop.live_threads, 1,
+                                iree_memory_order_relaxed);
+    iree_status_t create_status =
+        iree_thread_create(iree_io_parallel_for_thread_main, &workers[i],
+                           thread_params, host_allocator, &workers[i].thread);
+    if (!iree_status_is_ok(create_status)) {
+      iree_atomic_fetch_sub_int32(&loop.live_threads, 1,
+                                  iree_memory_order_relaxed);
+      iree_status_ignore(create_status);
+      break;
+    }
+  }
+
+  // Participate from the calling thread and then wait for all others to finish
+  // their work. Releasing a thread only joins it if it has started running so
+  // that alone can't tell us the loop state is unused; once all threads have
+  // finished releasing them joins each (including its final notification post)
+  // so the notification can be safely deinitialized afterward.
+  iree_io_parallel_for_worker_run(&workers[0]);
+  iree_notification_await(&loop.thread_exited,
+                          iree_io_parallel_for_threads_exited, &loop,
+                          iree_infinite_timeout());
+  iree_status_t status = iree_ok_status();
+  for (iree_host_size_t i = 0; i < worker_count; ++i) {
+    iree_thread_release(workers[i].thread);
+    if (iree_status_is_ok(status)) {
+      status = workers[i].status;
+    } else {
+      iree_status_ignore(workers[i].status);
+    }
+  }
+  iree_notification_deinitialize(&loop.thread_exited);
+  iree_allocator_free(host_allocator, workers);
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
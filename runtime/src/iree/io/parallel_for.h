@@ -0,0 +1,56 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_IO_PARALLEL_FOR_H_
+#define IREE_IO_PARALLEL_FOR_H_
+
+#include <stdint.h>
+
+#include "iree/base/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+//===----------------------------------------------------------------------===//
+// iree_io_parallel_for
+//===----------------------------------------------------------------------===//
+
+// Processes the work item at |work_index| on the worker with ordinal
+// |worker_index| in [0, iree_io_parallel_for_worker_count).
+// Each worker processes its items serially and claims them in increasing
+// order so per-worker state indexed by |worker_index| needs no
+// synchronization and can carry positions across items.
+typedef iree_status_t(IREE_API_PTR* iree_io_parallel_for_fn_t)(
+    void* user_data, iree_host_size_t worker_index, uint64_t work_index);
+
+// Returns the number of workers iree_io_parallel_for will use for
+// |work_count| items with up to |max_concurrency| threads. Callers with
+// per-worker state should allocate this many entries.
+IREE_API_EXPORT iree_host_size_t iree_io_parallel_for_worker_count(
+    uint64_t work_count, iree_host_size_t max_concurrency);
+
+// Calls |fn| for each work item in [0, |work_count|) using up to
+// |max_concurrency| threads including the calling thread. Intended for
+// one-shot host I/O and codec work (archive building, decoding, file opening)
+// where spinning up threads for the duration of the loop is cheap relative to
+// the work and no long-lived executor is available.
+//
+// If thread creation fails (platforms without threading, resource limits, etc)
+// the remaining work is picked up by the threads that were created and the
+// calling thread. Once any item fails no new items are claimed and the
+// failure of the lowest-ordinal failing worker is returned. All threads have
+// exited before this returns.
+IREE_API_EXPORT iree_status_t iree_io_parallel_for(
+    iree_string_view_t thread_name, uint64_t work_count,
+    iree_host_size_t max_concurrency, iree_io_parallel_for_fn_t fn,
+    void* user_data, iree_allocator_t host_allocator);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_IO_PARALLEL_FOR_H_
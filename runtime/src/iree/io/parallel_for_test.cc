@@ -0,0 +1,94 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/io/parallel_for.h"
+
+#include <atomic>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace {
+
+struct Loop {
+  // Number of times each work item was processed.
+  std::vector<std::atomic<int>> counts;
+  // Last work item processed by each worker.
+  std::vector<int64_t> last_work;
+  // Work item that fails (if any).
+  int64_t failing_work = -1;
+  bool out_of_order = false;
+
+  Loop(uint64_t work_count, iree_host_size_t worker_count)
+      : counts(work_count), last_work(worker_count, -1) {}
+
+  static iree_status_t Process(void* user_data, iree_host_size_t worker_index,
+                               uint64_t work_index) {
+    Loop* loop = static_cast<Loop*>(user_data);
+    ++loop->counts[work_index];
+    // Only touched by the owning worker.
+    if ((int64_t)work_index <= loop->last_work[worker_index]) {
+      loop->out_of_order = true;
+    }
+    loop->last_work[worker_index] = (int64_t)work_index;
+    if ((int64_t)work_index == loop->failing_work) {
+      return iree_make_status(IREE_STATUS_DATA_LOSS, "work %" PRIu64,
+                              work_index);
+    }
+    return iree_ok_status();
+  }
+};
+
+TEST(ParallelForTest, WorkerCount) {
+  EXPECT_EQ(1, iree_io_parallel_for_worker_count(100, 0));
+  EXPECT_EQ(1, iree_io_parallel_for_worker_count(100, 1));
+  EXPECT_EQ(4, iree_io_parallel_for_worker_count(100, 4));
+  EXPECT_EQ(3, iree_io_parallel_for_worker_count(3, 8));
+}
+
+TEST(ParallelForTest, Empty) {
+  Loop loop(0, 1);
+  IREE_EXPECT_OK(iree_io_parallel_for(IREE_SV("test"), 0, 4, Loop::Process,
+                                      &loop, iree_allocator_system()));
+}
+
+TEST(ParallelForTest, ProcessesEachItemOnce) {
+  for (iree_host_size_t max_concurrency : {1, 2, 8}) {
+    const uint64_t work_count = 1000;
+    Loop loop(work_count, iree_io_parallel_for_worker_count(
+                              work_count, max_concurrency));
+    IREE_ASSERT_OK(iree_io_parallel_for(IREE_SV("test"), work_count,
+                                        max_concurrency, Loop::Process, &loop,
+                                        iree_allocator_system()));
+    for (uint64_t i = 0; i < work_count; ++i) {
+      EXPECT_EQ(1, loop.counts[i].load()) << "work " << i;
+    }
+    EXPECT_FALSE(loop.out_of_order);
+  }
+}
+
+TEST(ParallelForTest, StopsOnFailure) {
+  for (iree_host_size_t max_concurrency : {1, 4}) {
+    const uint64_t work_count = 10000;
+    Loop loop(work_count, iree_io_parallel_for_worker_count(
+                              work_count, max_concurrency));
+    loop.failing_work = 10;
+    iree_status_t status =
+        iree_io_parallel_for(IREE_SV("test"), work_count, max_concurrency,
+                             Loop::Process, &loop, iree_allocator_system());
+    IREE_EXPECT_STATUS_IS(IREE_STATUS_DATA_LOSS,
+                          iree::Status(std::move(status)));
+    // Workers stop claiming once the failure is observed but others may have
+    // raced ahead before then; no item is ever processed twice.
+    for (uint64_t i = 0; i < work_count; ++i) {
+      EXPECT_LE(loop.counts[i].load(), 1) << "work " << i;
+    }
+  }
+}
+
+}  // namespace
@@ -0,0 +1,540 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/io/parameter_codec.h"
+
+#include "iree/io/parallel_for.h"
+
+//===----------------------------------------------------------------------===//
+// Content hashing
+//===----------------------------------------------------------------------===//
+
+#define IREE_IO_CODEC_PRIME64_1 0x9E3779B185EBCA87ull
+#define IREE_IO_CODEC_PRIME64_2 0xC2B2AE3D27D4EB4Full
+#define IREE_IO_CODEC_PRIME64_3 0x165667B19E3779F9ull
+
+static inline uint64_t iree_io_codec_load_u64(const uint8_t* ptr) {
+  uint64_t value = 0;
+  memcpy(&value, ptr, sizeof(value));
+  return value;
+}
+
+static inline uint32_t iree_io_codec_load_u32(const uint8_t* ptr) {
+  uint32_t value = 0;
+  memcpy(&value, ptr, sizeof(value));
+  return value;
+}
+
+static inline uint64_t iree_io_codec_rotl64(uint64_t value, int amount) {
+  return (value << amount) | (value >> (64 - amount));
+}
+
+// Mixes 8 bytes at a time with a final avalanche step. The hash only needs to
+// be good enough to make false positives rare as matches are always verified.
+IREE_API_EXPORT uint64_t
+iree_io_parameter_codec_hash(iree_const_byte_span_t contents) {
+  const uint8_t* ptr = contents.data;
+  iree_host_size_t remaining = contents.data_length;
+  uint64_t hash = IREE_IO_CODEC_PRIME64_3 ^
+                  ((uint64_t)contents.data_length * IREE_IO_CODEC_PRIME64_1);
+  for (; remaining >= 8; remaining -= 8, ptr += 8) {
+    uint64_t lane = iree_io_codec_load_u64(ptr) * IREE_IO_CODEC_PRIME64_2;
+    lane = iree_io_codec_rotl64(lane, 31) * IREE_IO_CODEC_PRIME64_1;
+    hash ^= lane;
+    hash = iree_io_codec_rotl64(hash, 27) * IREE_IO_CODEC_PRIME64_1 +
+           IREE_IO_CODEC_PRIME64_3;
+  }
+  for (; remaining > 0; --remaining, ++ptr) {
+    hash ^= (uint64_t)(*ptr) * IREE_IO_CODEC_PRIME64_3;
+    hash = iree_io_codec_rotl64(hash, 11) * IREE_IO_CODEC_PRIME64_1;
+  }
+  hash ^= hash >> 33;
+  hash *= IREE_IO_CODEC_PRIME64_2;
+  hash ^= hash >> 29;
+  hash *= IREE_IO_CODEC_PRIME64_3;
+  hash ^= hash >> 32;
+  return hash;
+}
+
+//===----------------------------------------------------------------------===//
+// LZ4 block format
+//===----------------------------------------------------------------------===//
+// Implements the LZ4 block format (no frame header) as documented in
+// https://github.com/lz4/lz4/blob/dev/doc/lz4_Block_format.md. Blocks produced
+// here can be decoded by any conforming LZ4 decoder and vice versa.
+//
+// The encoder is a simple greedy single-pass matcher; it favors encode speed
+// and determinism over ratio as parameters are often poorly compressible and
+// decode speed is what matters at load time.
+
+// Minimum match length representable in a sequence.
+#define IREE_IO_LZ4_MIN_MATCH 4
+// The last 5 bytes of a block are always literals.
+#define IREE_IO_LZ4_LAST_LITERALS 5
+// The last match must start at least 12 bytes before the end of the block.
+#define IREE_IO_LZ4_MF_LIMIT 12
+// Maximum distance of a match from the current position.
+#define IREE_IO_LZ4_MAX_DISTANCE 65535
+// log2 of the number of entries in the encoder match table.
+#define IREE_IO_LZ4_HASH_LOG 12
+
+static inline uint32_t iree_io_lz4_hash(uint32_t sequence) {
+  return (sequence * 2654435761u) >> (32 - IREE_IO_LZ4_HASH_LOG);
+}
+
+// Emits the portion of a literal or match |length| that overflows its 4-bit
+// token field as a run of 255 bytes followed by the remainder.
+static inline uint8_t* iree_io_lz4_write_length(uint8_t* op,
+                                                iree_host_size_t length) {
+  for (; length >= 255; length -= 255) *op++ = 255;
+  *op++ = (uint8_t)length;
+  return op;
+}
+
+// Emits a sequence of |literal_length| literals from |literals| followed by
+// an optional match (|match_length| == 0 for the final literal-only sequence).
+// Returns NULL if the sequence does not fit in [op, op_end).
+static uint8_t* iree_io_lz4_write_sequence(uint8_t* op, const uint8_t* op_end,
+                                           const uint8_t* literals,
+                                           iree_host_size_t literal_length,
+                                           iree_host_size_t match_distance,
+                                           iree_host_size_t match_length) {
+  // Token + literal length bytes + literals [+ distance + match length bytes].
+  // This must be exact so that an encoding can be reproduced into a target
+  // sized to a previously measured encoded length.
+  iree_host_size_t required = 1 + literal_length;
+  if (literal_length >= 15) required += 1 + (literal_length - 15) / 255;
+  if (match_length > 0) {
+    required += 2;
+    iree_host_size_t match_code = match_length - IREE_IO_LZ4_MIN_MATCH;
+    if (match_code >= 15) required += 1 + (match_code - 15) / 255;
+  }
+  if (required > (iree_host_size_t)(op_end - op)) return NULL;
+
+  uint8_t* token = op++;
+  *token = 0;
+  if (literal_length >= 15) {
+    *token = 15 << 4;
+    op = iree_io_lz4_write_length(op, literal_length - 15);
+  } else {
+    *token = (uint8_t)(literal_length << 4);
+  }
+  memcpy(op, literals, literal_length);
+  op += literal_length;
+  if (match_length == 0) return op;
+
+  *op++ = (uint8_t)(match_distance & 0xFF);
+  *op++ = (uint8_t)(match_distance >> 8);
+  iree_host_size_t match_code = match_length - IREE_IO_LZ4_MIN_MATCH;
+  if (match_code >= 15) {
+    *token |= 15;
+    op = iree_io_lz4_write_length(op, match_code - 15);
+  } else {
+    *token |= (uint8_t)match_code;
+  }
+  return op;
+}
+
+static iree_status_t iree_io_lz4_encode(iree_const_byte_span_t source,
+                                        iree_byte_span_t target,
+                                        iree_host_size_t* out_length) {
+  const uint8_t* src = source.data;
+  const iree_host_size_t src_length = source.data_length;
+  uint8_t* op = target.data;
+  const uint8_t* op_end = target.data + target.data_length;
+
+  iree_host_size_t anchor = 0;
+  if (src_length > IREE_IO_LZ4_MF_LIMIT) {
+    // Positions are only candidates; stale or empty (0) entries are rejected
+    // by comparing the bytes they reference.
+    uint32_t table[1 << IREE_IO_LZ4_HASH_LOG];
+    memset(table, 0, sizeof(table));
+    const iree_host_size_t match_limit = src_length - IREE_IO_LZ4_MF_LIMIT;
+    const iree_host_size_t extend_limit =
+        src_length - IREE_IO_LZ4_LAST_LITERALS;
+    iree_host_size_t ip = 0;
+    iree_host_size_t misses = 0;
+    while (ip < match_limit) {
+      const uint32_t sequence = iree_io_codec_load_u32(src + ip);
+      const uint32_t hash = iree_io_lz4_hash(sequence);
+      const iree_host_size_t candidate = table[hash];
+      table[hash] = (uint32_t)ip;
+      if (candidate >= ip || ip - candidate > IREE_IO_LZ4_MAX_DISTANCE ||
+          iree_io_codec_load_u32(src + candidate) != sequence) {
+        // Skip ahead faster through incompressible regions.
+        ip += 1 + (misses++ >> 6);
+        continue;
+      }
+      misses = 0;
+
+      // Extend the match backward over pending literals and forward up to the
+      // point where the trailing literals begin.
+      iree_host_size_t match_start = ip;
+      iree_host_size_t match_ref = candidate;
+      while (match_start > anchor && match_ref > 0 &&
+             src[match_start - 1] == src[match_ref - 1]) {
+        --match_start;
+        --match_ref;
+      }
+      iree_host_size_t match_end = ip + IREE_IO_LZ4_MIN_MATCH;
+      iree_host_size_t ref_end = candidate + IREE_IO_LZ4_MIN_MATCH;
+      while (match_end < extend_limit && src[match_end] == src[ref_end]) {
+        ++match_end;
+        ++ref_end;
+      }
+
+      op = iree_io_lz4_write_sequence(op, op_end, src + anchor,
+                                      match_start - anchor,
+                                      match_start - match_ref,
+                                      match_end - match_start);
+      if (!op) {
+        return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                                "encoded contents exceed target capacity");
+      }
+      anchor = match_end;
+      ip = match_end;
+      // Seed the table with a position inside the match to improve the odds
+      // of finding the next repetition.
+      if (ip - 2 < match_limit) {
+        table[iree_io_lz4_hash(iree_io_codec_load_u32(src + ip - 2))] =
+            (uint32_t)(ip - 2);
+      }
+    }
+  }
+
+  // Trailing literals.
+  op = iree_io_lz4_write_sequence(op, op_end, src + anchor,
+                                  src_length - anchor, 0, 0);
+  if (!op) {
+    return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                            "encoded contents exceed target capacity");
+  }
+  *out_length = (iree_host_size_t)(op - target.data);
+  return iree_ok_status();
+}
+
+// Accumulates the extension bytes of a length into |length|.
+// Returns false if the source is exhausted.
+static inline bool iree_io_lz4_read_length(const uint8_t** ip,
+                                           const uint8_t* ip_end,
+                                           iree_host_size_t* length) {
+  uint8_t byte = 0;
+  do {
+    if (*ip >= ip_end) return false;
+    byte = *(*ip)++;
+    *length += byte;
+  } while (byte == 255);
+  return true;
+}
+
+static iree_status_t iree_io_lz4_decode(iree_const_byte_span_t source,
+                                        iree_byte_span_t target) {
+  const uint8_t* ip = source.data;
+  const uint8_t* ip_end = source.data + source.data_length;
+  uint8_t* op = target.data;
+  uint8_t* op_end = target.data + target.data_length;
+  for (;;) {
+    if (ip >= ip_end) {
+      return iree_make_status(IREE_STATUS_DATA_LOSS,
+                              "truncated LZ4 block (missing token)");
+    }
+    const uint8_t token = *ip++;
+
+    iree_host_size_t literal_length = token >> 4;
+    if (literal_length == 15 &&
+        !iree_io_lz4_read_length(&ip, ip_end, &literal_length)) {
+      return iree_make_status(IREE_STATUS_DATA_LOSS,
+                              "truncated LZ4 block (literal length)");
+    }
+    if (literal_length > (iree_host_size_t)(ip_end - ip) ||
+        literal_length > (iree_host_size_t)(op_end - op)) {
+      return iree_make_status(IREE_STATUS_DATA_LOSS,
+                              "LZ4 literals out of bounds");
+    }
+    memcpy(op, ip, literal_length);
+    ip += literal_length;
+    op += literal_length;
+    if (ip == ip_end) break;  // final sequence has no match
+
+    if (ip_end - ip < 2) {
+      return iree_make_status(IREE_STATUS_DATA_LOSS,
+                              "truncated LZ4 block (match distance)");
+    }
+    const iree_host_size_t distance =
+        (iree_host_size_t)ip[0] | ((iree_host_size_t)ip[1] << 8);
+    ip += 2;
+    if (distance == 0 || distance > (iree_host_size_t)(op - target.data)) {
+      return iree_make_status(IREE_STATUS_DATA_LOSS,
+                              "LZ4 match distance out of bounds");
+    }
+    iree_host_size_t match_length = token & 15;
+    if (match_length == 15 &&
+        !iree_io_lz4_read_length(&ip, ip_end, &match_length)) {
+      return iree_make_status(IREE_STATUS_DATA_LOSS,
+                              "truncated LZ4 block (match length)");
+    }
+    match_length += IREE_IO_LZ4_MIN_MATCH;
+    if (match_length > (iree_host_size_t)(op_end - op)) {
+      return iree_make_status(IREE_STATUS_DATA_LOSS,
+                              "LZ4 match out of bounds");
+    }
+
+    // Matches may overlap the output being produced (distance < length) in
+    // which case they must be copied byte-by-byte to replicate the pattern.
+    const uint8_t* match = op - distance;
+    if (distance >= match_length) {
+      memcpy(op, match, match_length);
+      op += match_length;
+    } else {
+      for (iree_host_size_t i = 0; i < match_length; ++i) *op++ = *match++;
+    }
+  }
+  if (op != op_end) {
+    return iree_make_status(IREE_STATUS_DATA_LOSS,
+                            "LZ4 block decoded to %" PRIhsz
+                            " bytes but %" PRIhsz " were expected",
+                            (iree_host_size_t)(op - target.data),
+                            target.data_length);
+  }
+  return iree_ok_status();
+}
+
+//===----------------------------------------------------------------------===//
+// Codec dispatch
+//===----------------------------------------------------------------------===//
+
+IREE_API_EXPORT iree_host_size_t iree_io_parameter_codec_encode_bound(
+    iree_io_parameter_codec_t codec, iree_host_size_t length) {
+  switch (codec) {
+    case IREE_IO_PARAMETER_CODEC_LZ4_BLOCK:
+      return length + length / 255 + 16;
+    default:
+      return length;
+  }
+}
+
+IREE_API_EXPORT iree_status_t iree_io_parameter_codec_encode(
+    iree_io_parameter_codec_t codec, iree_const_byte_span_t source,
+    iree_byte_span_t target, iree_host_size_t* out_length) {
+  IREE_ASSERT_ARGUMENT(out_length);
+  *out_length = 0;
+  switch (codec) {
+    case IREE_IO_PARAMETER_CODEC_NONE:
+      if (target.data_length < source.data_length) {
+        return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                                "target capacity too small");
+      }
+      memcpy(target.data, source.data, source.data_length);
+      *out_length = source.data_length;
+      return iree_ok_status();
+    case IREE_IO_PARAMETER_CODEC_LZ4_BLOCK:
+      return iree_io_lz4_encode(source, target, out_length);
+    default:
+      return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                              "unsupported parameter codec %u", codec);
+  }
+}
+
+IREE_API_EXPORT iree_status_t iree_io_parameter_codec_decode(
+    iree_io_parameter_codec_t codec, iree_const_byte_span_t source,
+    iree_byte_span_t target) {
+  switch (codec) {
+    case IREE_IO_PARAMETER_CODEC_NONE:
+      if (target.data_length != source.data_length) {
+        return iree_make_status(IREE_STATUS_DATA_LOSS,
+                                "raw chunk length mismatch");
+      }
+      memcpy(target.data, source.data, source.data_length);
+      return iree_ok_status();
+    case IREE_IO_PARAMETER_CODEC_LZ4_BLOCK:
+      return iree_io_lz4_decode(source, target);
+    default:
+      return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                              "unsupported parameter codec %u", codec);
+  }
+}
+
+//===----------------------------------------------------------------------===//
+// Chunked entry access
+//===----------------------------------------------------------------------===//
+
+typedef struct iree_io_parameter_chunked_read_worker_t {
+  // Holds encoded chunk contents read from files that are not host accessible.
+  iree_byte_span_t encoded;
+  // Holds decoded chunk contents for chunks only partially covered by the read.
+  iree_byte_span_t decoded;
+} iree_io_parameter_chunked_read_worker_t;
+
+typedef struct iree_io_parameter_chunked_read_t {
+  const iree_io_parameter_index_entry_t* entry;
+  // Offset of the range within the entry.
+  uint64_t offset;
+  // Target of the range.
+  iree_byte_span_t target;
+  // Range of chunks overlapping the range.
+  iree_host_size_t chunk_base;
+  iree_host_size_t chunk_count;
+  iree_allocator_t host_allocator;
+  // Per-worker scratch state indexed by worker ordinal.
+  iree_io_parameter_chunked_read_worker_t* workers;
+} iree_io_parameter_chunked_read_t;
+
+// Returns a host pointer to |length| bytes at |offset| in |handle| if the
+// handle is backed by a host allocation.
+static const uint8_t* iree_io_parameter_chunked_host_ptr(
+    iree_io_file_handle_t* handle, uint64_t offset, uint64_t length) {
+  iree_io_file_handle_primitive_t primitive =
+      iree_io_file_handle_primitive(handle);
+  if (primitive.type != IREE_IO_FILE_HANDLE_TYPE_HOST_ALLOCATION) return NULL;
+  iree_byte_span_t host_allocation = primitive.value.host_allocation;
+  if (offset > host_allocation.data_length ||
+      length > host_allocation.data_length - offset) {
+    return NULL;
+  }
+  return host_allocation.data + offset;
+}
+
+// Grows |span| to at least |length| bytes, discarding its contents.
+static iree_status_t iree_io_parameter_chunked_reserve(
+    iree_allocator_t host_allocator, iree_host_size_t length,
+    iree_byte_span_t* span) {
+  if (span->data_length >= length) return iree_ok_status();
+  iree_allocator_free(host_allocator, span->data);
+  span->data = NULL;
+  span->data_length = 0;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc_uninitialized(
+      host_allocator, length, (void**)&span->data));
+  span->data_length = length;
+  return iree_ok_status();
+}
+
+// Decodes the portion of chunk |chunk_index| overlapping the read range.
+static iree_status_t iree_io_parameter_chunked_read_chunk(
+    iree_io_parameter_chunked_read_t* read,
+    iree_io_parameter_chunked_read_worker_t* worker,
+    iree_host_size_t chunk_index) {
+  const iree_io_parameter_index_entry_t* entry = read->entry;
+  iree_io_file_handle_t* handle = entry->storage.chunked.handle;
+  const iree_io_parameter_index_chunk_t* chunk =
+      &entry->storage.chunked.chunks[chunk_index];
+
+  // Compute the overlap of the chunk with the read range.
+  const uint64_t chunk_begin = chunk_index * entry->storage.chunked.chunk_size;
+  const uint64_t chunk_end =
+      iree_min(chunk_begin + entry->storage.chunked.chunk_size, entry->length);
+  const uint64_t range_begin = iree_max(chunk_begin, read->offset);
+  const uint64_t range_end =
+      iree_min(chunk_end, read->offset + read->target.data_length);
+  uint8_t* target_ptr = read->target.data + (range_begin - read->offset);
+  const iree_host_size_t range_length =
+      (iree_host_size_t)(range_end - range_begin);
+  const iree_host_size_t decoded_length =
+      (iree_host_size_t)(chunk_end - chunk_begin);
+
+  // Raw chunks can be read directly without staging.
+  if (chunk->codec == IREE_IO_PARAMETER_CODEC_NONE) {
+    if (chunk->length != decoded_length) {
+      return iree_make_status(IREE_STATUS_DATA_LOSS,
+                              "raw chunk %" PRIhsz " length mismatch",
+                              chunk_index);
+    }
+    return iree_io_file_handle_read(
+        handle, chunk->offset + (range_begin - chunk_begin),
+        iree_make_byte_span(target_ptr, range_length));
+  }
+
+  // Get the encoded contents either in-place or by reading them from the file.
+  if (chunk->length > IREE_HOST_SIZE_MAX) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "chunk exceeds host addressable range");
+  }
+  const iree_host_size_t encoded_length = (iree_host_size_t)chunk->length;
+  const uint8_t* encoded_ptr =
+      iree_io_parameter_chunked_host_ptr(handle, chunk->offset, chunk->length);
+  if (!encoded_ptr) {
+    IREE_RETURN_IF_ERROR(iree_io_parameter_chunked_reserve(
+        read->host_allocator, encoded_length, &worker->encoded));
+    IREE_RETURN_IF_ERROR(iree_io_file_handle_read(
+        handle, chunk->offset,
+        iree_make_byte_span(worker->encoded.data, encoded_length)));
+    encoded_ptr = worker->encoded.data;
+  }
+  iree_const_byte_span_t encoded =
+      iree_make_const_byte_span(encoded_ptr, encoded_length);
+
+  // Decode directly into the target if the whole chunk is covered.
+  if (range_length == decoded_length) {
+    return iree_io_parameter_codec_decode(
+        chunk->codec, encoded, iree_make_byte_span(target_ptr, range_length));
+  }
+  IREE_RETURN_IF_ERROR(iree_io_parameter_chunked_reserve(
+      read->host_allocator, decoded_length, &worker->decoded));
+  IREE_RETURN_IF_ERROR(iree_io_parameter_codec_decode(
+      chunk->codec, encoded,
+      iree_make_byte_span(worker->decoded.data, decoded_length)));
+  memcpy(target_ptr, worker->decoded.data + (range_begin - chunk_begin),
+         range_length);
+  return iree_ok_status();
+}
+
+// Decodes chunk |work_index| of the read (relative to its first chunk).
+static iree_status_t iree_io_parameter_chunked_read_work_item(
+    void* user_data, iree_host_size_t worker_index, uint64_t work_index) {
+  iree_io_parameter_chunked_read_t* read =
+      (iree_io_parameter_chunked_read_t*)user_data;
+  return iree_io_parameter_chunked_read_chunk(
+      read, &read->workers[worker_index],
+      read->chunk_base + (iree_host_size_t)work_index);
+}
+
+IREE_API_EXPORT iree_status_t iree_io_parameter_chunked_entry_read(
+    const iree_io_parameter_index_entry_t* entry, uint64_t offset,
+    iree_byte_span_t target, iree_host_size_t max_concurrency,
+    iree_allocator_t host_allocator) {
+  IREE_ASSERT_ARGUMENT(entry);
+  if (entry->type != IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_CHUNKED) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "parameter entry is not chunked");
+  }
+  if (offset > entry->length || target.data_length > entry->length - offset) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "read range %" PRIu64 " (%" PRIhsz
+                            " bytes) exceeds parameter length %" PRIu64,
+                            offset, target.data_length, entry->length);
+  }
+  if (target.data_length == 0) return iree_ok_status();
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)target.data_length);
+
+  const uint64_t chunk_size = entry->storage.chunked.chunk_size;
+  iree_io_parameter_chunked_read_t read;
+  memset(&read, 0, sizeof(read));
+  read.entry = entry;
+  read.offset = offset;
+  read.target = target;
+  read.chunk_base = (iree_host_size_t)(offset / chunk_size);
+  read.chunk_count = (iree_host_size_t)(
+      (offset + target.data_length - 1) / chunk_size - read.chunk_base + 1);
+  read.host_allocator = host_allocator;
+
+  iree_host_size_t worker_count =
+      iree_io_parallel_for_worker_count(read.chunk_count, max_concurrency);
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(host_allocator,
+                                worker_count * sizeof(*read.workers),
+                                (void**)&read.workers));
+  iree_status_t status = iree_io_parallel_for(
+      IREE_SV("iree-param-decode"), read.chunk_count, worker_count,
+      iree_io_parameter_chunked_read_work_item, &read, host_allocator);
+  for (iree_host_size_t i = 0; i < worker_count; ++i) {
+    iree_allocator_free(host_allocator, read.workers[i].encoded.data);
+    iree_allocator_free(host_allocator, read.workers[i].decoded.data);
+  }
+  iree_allocator_free(host_allocator, read.workers);
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
@@ -0,0 +1,68 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_IO_PARAMETER_CODEC_H_
+#define IREE_IO_PARAMETER_CODEC_H_
+
+#include "iree/base/api.h"
+#include "iree/io/parameter_index.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+//===----------------------------------------------------------------------===//
+// Chunk encoding
+//===----------------------------------------------------------------------===//
+
+// Returns a 64-bit hash of |contents| suitable for identifying chunks with
+// identical contents. Collisions are possible and users must compare contents
+// before treating two chunks as equal.
+IREE_API_EXPORT uint64_t
+iree_io_parameter_codec_hash(iree_const_byte_span_t contents);
+
+// Returns the maximum number of bytes produced by encoding |length| bytes with
+// |codec|.
+IREE_API_EXPORT iree_host_size_t iree_io_parameter_codec_encode_bound(
+    iree_io_parameter_codec_t codec, iree_host_size_t length);
+
+// Encodes |source| with |codec| into |target| and returns the encoded length
+// in |out_length|. Encoding is deterministic: the same input always produces
+// the same output. Fails with IREE_STATUS_RESOURCE_EXHAUSTED if |target| is
+// too small to hold the encoded contents; callers that only want to keep
+// encodings smaller than the source can pass a |target| of that size.
+IREE_API_EXPORT iree_status_t iree_io_parameter_codec_encode(
+    iree_io_parameter_codec_t codec, iree_const_byte_span_t source,
+    iree_byte_span_t target, iree_host_size_t* out_length);
+
+// Decodes |source| encoded with |codec| into |target|. The decoded contents
+// must exactly fill |target|. Fails with IREE_STATUS_DATA_LOSS if the source
+// is malformed.
+IREE_API_EXPORT iree_status_t iree_io_parameter_codec_decode(
+    iree_io_parameter_codec_t codec, iree_const_byte_span_t source,
+    iree_byte_span_t target);
+
+//===----------------------------------------------------------------------===//
+// Chunked entry access
+//===----------------------------------------------------------------------===//
+
+// Decodes the range [offset, offset + target.data_length) of the chunked
+// |entry| into |target|. Chunks are decoded directly into |target| when they
+// are fully covered by the range and the work is distributed across up to
+// |max_concurrency| threads (including the calling thread) when the range
+// spans multiple chunks. |host_allocator| is used for thread state and
+// transient buffers for chunks that are only partially covered or stored in
+// files that are not host accessible.
+IREE_API_EXPORT iree_status_t iree_io_parameter_chunked_entry_read(
+    const iree_io_parameter_index_entry_t* entry, uint64_t offset,
+    iree_byte_span_t target, iree_host_size_t max_concurrency,
+    iree_allocator_t host_allocator);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_IO_PARAMETER_CODEC_H_
@@ -0,0 +1,196 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/io/parameter_codec.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace {
+
+// Returns |length| bytes with a mix of repetitive and noisy regions.
+static std::vector<uint8_t> MakeContents(size_t length, uint32_t seed) {
+  std::vector<uint8_t> contents(length);
+  uint32_t state = seed;
+  for (size_t i = 0; i < length; ++i) {
+    state = state * 1664525u + 1013904223u;
+    contents[i] = ((i / 97) % 3 == 0) ? (uint8_t)(state >> 24) : (uint8_t)(i);
+  }
+  return contents;
+}
+
+static std::vector<uint8_t> Encode(iree_io_parameter_codec_t codec,
+                                   const std::vector<uint8_t>& source) {
+  std::vector<uint8_t> encoded(
+      iree_io_parameter_codec_encode_bound(codec, source.size()));
+  iree_host_size_t encoded_length = 0;
+  IREE_CHECK_OK(iree_io_parameter_codec_encode(
+      codec, iree_make_const_byte_span(source.data(), source.size()),
+      iree_make_byte_span(encoded.data(), encoded.size()), &encoded_length));
+  encoded.resize(encoded_length);
+  return encoded;
+}
+
+TEST(ParameterCodecTest, HashDistinguishesContents) {
+  std::vector<uint8_t> a = MakeContents(1000, 1);
+  std::vector<uint8_t> b = a;
+  b[999] ^= 1;
+  auto hash = [](const std::vector<uint8_t>& v) {
+    return iree_io_parameter_codec_hash(
+        iree_make_const_byte_span(v.data(), v.size()));
+  };
+  EXPECT_EQ(hash(a), hash(a));
+  EXPECT_NE(hash(a), hash(b));
+  EXPECT_NE(hash(std::vector<uint8_t>(8, 0)), hash(std::vector<uint8_t>(9, 0)));
+}
+
+TEST(ParameterCodecTest, Lz4RoundTrip) {
+  for (size_t length : {0, 1, 12, 13, 64, 4096, 65536 + 17, 300000}) {
+    std::vector<uint8_t> source = MakeContents(length, (uint32_t)length);
+    std::vector<uint8_t> encoded =
+        Encode(IREE_IO_PARAMETER_CODEC_LZ4_BLOCK, source);
+    std::vector<uint8_t> decoded(length, 0xCD);
+    IREE_ASSERT_OK(iree_io_parameter_codec_decode(
+        IREE_IO_PARAMETER_CODEC_LZ4_BLOCK,
+        iree_make_const_byte_span(encoded.data(), encoded.size()),
+        iree_make_byte_span(decoded.data(), decoded.size())));
+    EXPECT_EQ(decoded, source) << "length " << length;
+  }
+}
+
+TEST(ParameterCodecTest, Lz4CompressesRepetition) {
+  std::vector<uint8_t> source(1024 * 1024, 0x42);
+  std::vector<uint8_t> encoded =
+      Encode(IREE_IO_PARAMETER_CODEC_LZ4_BLOCK, source);
+  EXPECT_LT(encoded.size(), source.size() / 100);
+}
+
+TEST(ParameterCodecTest, Lz4EncodeCapacityExhausted) {
+  std::vector<uint8_t> source(4096);
+  uint32_t state = 7;
+  for (uint8_t& value : source) {
+    state = state * 1664525u + 1013904223u;
+    value = (uint8_t)(state >> 24);
+  }
+  std::vector<uint8_t> encoded(source.size() / 2);
+  iree_host_size_t encoded_length = 0;
+  IREE_EXPECT_STATUS_IS(
+      IREE_STATUS_RESOURCE_EXHAUSTED,
+      iree_io_parameter_codec_encode(
+          IREE_IO_PARAMETER_CODEC_LZ4_BLOCK,
+          iree_make_const_byte_span(source.data(), source.size()),
+          iree_make_byte_span(encoded.data(), encoded.size()),
+          &encoded_length));
+}
+
+TEST(ParameterCodecTest, Lz4DecodeRejectsMalformed) {
+  std::vector<uint8_t> source(1000, 0x11);
+  std::vector<uint8_t> encoded =
+      Encode(IREE_IO_PARAMETER_CODEC_LZ4_BLOCK, source);
+  std::vector<uint8_t> decoded(source.size());
+  // Truncated input.
+  IREE_EXPECT_STATUS_IS(
+      IREE_STATUS_DATA_LOSS,
+      iree_io_parameter_codec_decode(
+          IREE_IO_PARAMETER_CODEC_LZ4_BLOCK,
+          iree_make_const_byte_span(encoded.data(), encoded.size() - 1),
+          iree_make_byte_span(decoded.data(), decoded.size())));
+  // Target too small.
+  IREE_EXPECT_STATUS_IS(
+      IREE_STATUS_DATA_LOSS,
+      iree_io_parameter_codec_decode(
+          IREE_IO_PARAMETER_CODEC_LZ4_BLOCK,
+          iree_make_const_byte_span(encoded.data(), encoded.size()),
+          iree_make_byte_span(decoded.data(), decoded.size() - 1)));
+  // Match referencing data before the start of the output.
+  const uint8_t bad_distance[] = {0x10, 0xAA, 0x05, 0x00, 0x00};
+  IREE_EXPECT_STATUS_IS(
+      IREE_STATUS_DATA_LOSS,
+      iree_io_parameter_codec_decode(
+          IREE_IO_PARAMETER_CODEC_LZ4_BLOCK,
+          iree_make_const_byte_span(bad_distance, sizeof(bad_distance)),
+          iree_make_byte_span(decoded.data(), 5)));
+}
+
+// Reads ranges of a chunked entry mixing raw and compressed chunks.
+TEST(ParameterCodecTest, ChunkedEntryRead) {
+  const size_t chunk_size = 1000;
+  const size_t length = 10 * chunk_size + 123;
+  std::vector<uint8_t> contents = MakeContents(length, 3);
+
+  // Lay out chunks back-to-back in the storage with every other one encoded.
+  std::vector<uint8_t> storage;
+  std::vector<iree_io_parameter_index_chunk_t> chunks;
+  for (size_t offset = 0; offset < length; offset += chunk_size) {
+    std::vector<uint8_t> chunk(
+        contents.begin() + offset,
+        contents.begin() + std::min(offset + chunk_size, length));
+    iree_io_parameter_index_chunk_t chunk_ref = {};
+    chunk_ref.offset = storage.size();
+    chunk_ref.content_hash = iree_io_parameter_codec_hash(
+        iree_make_const_byte_span(chunk.data(), chunk.size()));
+    if (chunks.size() % 2 == 0) {
+      chunk_ref.codec = IREE_IO_PARAMETER_CODEC_LZ4_BLOCK;
+      chunk = Encode(chunk_ref.codec, chunk);
+    } else {
+      chunk_ref.codec = IREE_IO_PARAMETER_CODEC_NONE;
+    }
+    chunk_ref.length = chunk.size();
+    storage.insert(storage.end(), chunk.begin(), chunk.end());
+    chunks.push_back(chunk_ref);
+  }
+
+  iree_io_file_handle_t* handle = NULL;
+  IREE_ASSERT_OK(iree_io_file_handle_wrap_host_allocation(
+      IREE_IO_FILE_ACCESS_READ,
+      iree_make_byte_span(storage.data(), storage.size()),
+      iree_io_file_handle_release_callback_null(), iree_allocator_system(),
+      &handle));
+  iree_io_parameter_index_entry_t entry = {};
+  entry.key = IREE_SV("chunked");
+  entry.length = length;
+  entry.type = IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_CHUNKED;
+  entry.storage.chunked.handle = handle;
+  entry.storage.chunked.chunk_size = chunk_size;
+  entry.storage.chunked.chunk_count = chunks.size();
+  entry.storage.chunked.chunks = chunks.data();
+
+  struct {
+    size_t offset;
+    size_t length;
+    iree_host_size_t max_concurrency;
+  } ranges[] = {
+      {0, length, 1},     {0, length, 4}, {0, length, 64},   {1500, 10, 4},
+      {999, 2, 4},        {2000, 1000, 4}, {length - 1, 1, 1}, {500, 8000, 3},
+  };
+  for (const auto& range : ranges) {
+    std::vector<uint8_t> result(range.length, 0xCD);
+    IREE_ASSERT_OK(iree_io_parameter_chunked_entry_read(
+        &entry, range.offset,
+        iree_make_byte_span(result.data(), result.size()),
+        range.max_concurrency, iree_allocator_system()));
+    std::vector<uint8_t> expected(
+        contents.begin() + range.offset,
+        contents.begin() + range.offset + range.length);
+    EXPECT_EQ(result, expected) << range.offset << "+" << range.length;
+  }
+
+  std::vector<uint8_t> result(2);
+  IREE_EXPECT_STATUS_IS(
+      IREE_STATUS_OUT_OF_RANGE,
+      iree_io_parameter_chunked_entry_read(
+          &entry, length - 1, iree_make_byte_span(result.data(), 2), 1,
+          iree_allocator_system()));
+
+  iree_io_file_handle_release(handle);
+}
+
+}  // namespace
@@ -9,6 +9,14 @@
 #include "iree/base/internal/atomics.h"
 #include "iree/base/internal/synchronization.h"
 
+// A slot in the key lookup table.
+typedef struct iree_io_parameter_index_bucket_t {
+  // Hash of the entry key; only valid if entry is non-NULL.
+  uint64_t hash;
+  // Entry stored in the bucket or NULL if the bucket is empty.
+  const iree_io_parameter_index_entry_t* entry;
+} iree_io_parameter_index_bucket_t;
+
 struct iree_io_parameter_index_t {
   iree_atomic_ref_count_t ref_count;
   iree_allocator_t host_allocator;
@@ -24,6 +32,12 @@ struct iree_io_parameter_index_t {
   iree_host_size_t entry_count;
   // Dense list of entries in the index. Grows as needed.
   iree_io_parameter_index_entry_t** entries;
+
+  // Open-addressed (linear probing) key lookup table with a power-of-two
+  // capacity kept at least twice the entry capacity. Only the first entry
+  // added with a given key is present in the table.
+  iree_host_size_t bucket_capacity;
+  iree_io_parameter_index_bucket_t* buckets;
 };
 
 IREE_API_EXPORT iree_status_t iree_io_parameter_index_create(
@@ -46,6 +60,8 @@ IREE_API_EXPORT iree_status_t iree_io_parameter_index_create(
   index->entry_capacity = 0;
   index->entry_count = 0;
   index->entries = NULL;
+  index->bucket_capacity = 0;
+  index->buckets = NULL;
 
   *out_index = index;
   IREE_TRACE_ZONE_END(z0);
@@ -65,12 +81,18 @@ static void iree_io_parameter_index_destroy(iree_io_parameter_index_t* index) {
       case IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_FILE:
         iree_io_file_handle_release(entry->storage.file.handle);
         break;
+      case IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_CHUNKED:
+        iree_io_file_handle_release(entry->storage.chunked.handle);
+        break;
     }
     iree_allocator_free(host_allocator, entry);
   }
   if (index->entries) {
     iree_allocator_free(host_allocator, index->entries);
   }
+  if (index->buckets) {
+    iree_allocator_free(host_allocator, index->buckets);
+  }
 
   iree_slim_mutex_deinitialize(&index->mutex);
 
@@ -102,6 +124,34 @@ iree_io_parameter_index_count(iree_io_parameter_index_t* index) {
   return count;
 }
 
+static uint64_t iree_io_parameter_index_hash_key(iree_string_view_t key) {
+  // FNV-1a.
+  uint64_t hash = 0xCBF29CE484222325ull;
+  for (iree_host_size_t i = 0; i < key.size; ++i) {
+    hash ^= (uint8_t)key.data[i];
+    hash *= 0x100000001B3ull;
+  }
+  return hash;
+}
+
+// Returns the bucket holding the entry with |key| or the empty bucket where it
+// would be inserted. The table must have at least one empty bucket.
+static iree_io_parameter_index_bucket_t* iree_io_parameter_index_find_bucket(
+    iree_io_parameter_index_bucket_t* buckets, iree_host_size_t bucket_capacity,
+    uint64_t hash, iree_string_view_t key) {
+  const iree_host_size_t mask = bucket_capacity - 1;
+  iree_host_size_t slot = (iree_host_size_t)hash & mask;
+  for (;;) {
+    iree_io_parameter_index_bucket_t* bucket = &buckets[slot];
+    if (!bucket->entry) return bucket;
+    if (bucket->hash == hash &&
+        iree_string_view_equal(bucket->entry->key, key)) {
+      return bucket;
+    }
+    slot = (slot + 1) & mask;
+  }
+}
+
 static iree_status_t iree_io_parameter_index_reserve_unsafe(
     iree_io_parameter_index_t* index, iree_host_size_t new_capacity) {
   IREE_ASSERT_ARGUMENT(index);
@@ -109,15 +159,50 @@ static iree_status_t iree_io_parameter_index_reserve_unsafe(
   IREE_TRACE_ZONE_BEGIN(z0);
   IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, new_capacity);
 
+  // Size the lookup table to keep the load factor at or below 1/2 when the
+  // entry list is full.
+  iree_host_size_t new_bucket_capacity = iree_max(16, index->bucket_capacity);
+  while (new_bucket_capacity < new_capacity * 2) new_bucket_capacity *= 2;
+  iree_io_parameter_index_bucket_t* new_buckets = NULL;
+  iree_status_t status = iree_ok_status();
+  if (new_bucket_capacity != index->bucket_capacity) {
+    status = iree_allocator_malloc(
+        index->host_allocator, new_bucket_capacity * sizeof(*new_buckets),
+        (void**)&new_buckets);
+  }
+
   iree_io_parameter_index_entry_t** new_entries = index->entries;
-  iree_status_t status = iree_allocator_realloc(
-      index->host_allocator, new_capacity * sizeof(index->entries[0]),
-      (void**)&new_entries);
+  if (iree_status_is_ok(status)) {
+    status = iree_allocator_realloc(index->host_allocator,
+                                    new_capacity * sizeof(index->entries[0]),
+                                    (void**)&new_entries);
+  }
   if (iree_status_is_ok(status)) {
     index->entry_capacity = new_capacity;
     index->entries = new_entries;
   }
 
+  // Rehash all existing entries into the new lookup table. Entries are inserted
+  // in order so that the first entry with any given key remains the one found.
+  if (iree_status_is_ok(status) && new_buckets) {
+    for (iree_host_size_t i = 0; i < index->entry_count; ++i) {
+      const iree_io_parameter_index_entry_t* entry = index->entries[i];
+      const uint64_t hash = iree_io_parameter_index_hash_key(entry->key);
+      iree_io_parameter_index_bucket_t* bucket =
+          iree_io_parameter_index_find_bucket(new_buckets, new_bucket_capacity,
+                                              hash, entry->key);
+      if (!bucket->entry) {
+        bucket->hash = hash;
+        bucket->entry = entry;
+      }
+    }
+    iree_allocator_free(index->host_allocator, index->buckets);
+    index->bucket_capacity = new_bucket_capacity;
+    index->buckets = new_buckets;
+  } else if (new_buckets) {
+    iree_allocator_free(index->host_allocator, new_buckets);
+  }
+
   IREE_TRACE_ZONE_END(z0);
   return status;
 }
@@ -148,19 +233,48 @@ iree_io_parameter_index_add(iree_io_parameter_index_t* index,
         index, iree_max(16, index->entry_capacity * 2));
   }
 
+  // Chunked entries must have a chunk table that covers the entire entry.
+  iree_host_size_t chunk_table_size = 0;
+  if (iree_status_is_ok(status) &&
+      entry->type == IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_CHUNKED) {
+    const uint64_t chunk_size = entry->storage.chunked.chunk_size;
+    if (!chunk_size ||
+        entry->storage.chunked.chunk_count !=
+            entry->length / chunk_size +
+                (entry->length % chunk_size != 0 ? 1 : 0)) {
+      status = iree_make_status(
+          IREE_STATUS_INVALID_ARGUMENT,
+          "chunked entry `%.*s` has %" PRIhsz
+          " chunks of %" PRIu64 " bytes which does not cover %" PRIu64
+          " bytes",
+          (int)entry->key.size, entry->key.data,
+          entry->storage.chunked.chunk_count, chunk_size, entry->length);
+    } else if (entry->storage.chunked.chunk_count >
+               IREE_HOST_SIZE_MAX / sizeof(iree_io_parameter_index_chunk_t)) {
+      status = iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                                "chunk table size overflow");
+    } else {
+      chunk_table_size = entry->storage.chunked.chunk_count *
+                         sizeof(iree_io_parameter_index_chunk_t);
+    }
+  }
+
   // Clone the entry memory. We allocate it as a single slab and stash the
   // pointers for easier access by callers. Entries themselves are never
-  // reallocated so the pointers are safe to embed.
+  // reallocated so the pointers are safe to embed. The chunk table (if any)
+  // is placed first after the entry to keep it naturally aligned.
   iree_io_parameter_index_entry_t* cloned_entry = NULL;
   if (iree_status_is_ok(status)) {
-    iree_host_size_t total_size =
-        sizeof(*cloned_entry) + entry->key.size + entry->metadata.data_length;
+    iree_host_size_t total_size = sizeof(*cloned_entry) + chunk_table_size +
+                                  entry->key.size +
+                                  entry->metadata.data_length;
     status = iree_allocator_malloc(index->host_allocator, total_size,
                                    (void**)&cloned_entry);
   }
   if (iree_status_is_ok(status)) {
     cloned_entry->key = iree_make_string_view(
-        (char*)cloned_entry + sizeof(*cloned_entry), entry->key.size);
+        (char*)cloned_entry + sizeof(*cloned_entry) + chunk_table_size,
+        entry->key.size);
     cloned_entry->metadata =
         iree_const_byte_span_is_empty(entry->metadata)
             ? iree_const_byte_span_empty()
@@ -179,13 +293,35 @@ iree_io_parameter_index_add(iree_io_parameter_index_t* index,
         cloned_entry->storage.file = entry->storage.file;
         iree_io_file_handle_retain(cloned_entry->storage.file.handle);
         break;
+      case IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_CHUNKED: {
+        cloned_entry->storage.chunked = entry->storage.chunked;
+        iree_io_parameter_index_chunk_t* cloned_chunks =
+            (iree_io_parameter_index_chunk_t*)((uint8_t*)cloned_entry +
+                                               sizeof(*cloned_entry));
+        if (chunk_table_size) {
+          memcpy(cloned_chunks, entry->storage.chunked.chunks,
+                 chunk_table_size);
+        }
+        cloned_entry->storage.chunked.chunks = cloned_chunks;
+        iree_io_file_handle_retain(cloned_entry->storage.chunked.handle);
+        break;
+      }
     }
     memcpy((void*)cloned_entry->key.data, entry->key.data, entry->key.size);
     memcpy((void*)cloned_entry->metadata.data, entry->metadata.data,
            entry->metadata.data_length);
 
-    // Append the entry to the file index.
+    // Append the entry to the file index and make it available for lookup
+    // unless an earlier entry has the same key.
     index->entries[index->entry_count++] = cloned_entry;
+    const uint64_t hash = iree_io_parameter_index_hash_key(cloned_entry->key);
+    iree_io_parameter_index_bucket_t* bucket =
+        iree_io_parameter_index_find_bucket(
+            index->buckets, index->bucket_capacity, hash, cloned_entry->key);
+    if (!bucket->entry) {
+      bucket->hash = hash;
+      bucket->entry = cloned_entry;
+    }
   }
 
   iree_slim_mutex_unlock(&index->mutex);
@@ -193,6 +329,34 @@ iree_io_parameter_index_add(iree_io_parameter_index_t* index,
   return status;
 }
 
+IREE_API_EXPORT iree_status_t iree_io_parameter_index_merge(
+    iree_io_parameter_index_t* index, iree_io_parameter_index_t* source) {
+  IREE_ASSERT_ARGUMENT(index);
+  IREE_ASSERT_ARGUMENT(source);
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Entries are only ever appended so any added to |source| concurrently are
+  // ignored.
+  iree_host_size_t source_count = iree_io_parameter_index_count(source);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, source_count);
+  iree_slim_mutex_lock(&index->mutex);
+  iree_status_t status = iree_io_parameter_index_reserve_unsafe(
+      index, index->entry_count + source_count);
+  iree_slim_mutex_unlock(&index->mutex);
+
+  for (iree_host_size_t i = 0; i < source_count && iree_status_is_ok(status);
+       ++i) {
+    const iree_io_parameter_index_entry_t* entry = NULL;
+    status = iree_io_parameter_index_get(source, i, &entry);
+    if (iree_status_is_ok(status)) {
+      status = iree_io_parameter_index_add(index, entry);
+    }
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 IREE_API_EXPORT iree_status_t iree_io_parameter_index_get(
     iree_io_parameter_index_t* index, iree_host_size_t i,
     const iree_io_parameter_index_entry_t** out_entry) {
@@ -226,12 +390,11 @@ IREE_API_EXPORT iree_status_t iree_io_parameter_index_lookup(
   iree_slim_mutex_lock(&index->mutex);
 
   iree_status_t status = iree_ok_status();
-  for (iree_host_size_t i = 0; i < index->entry_count; ++i) {
-    const iree_io_parameter_index_entry_t* entry = index->entries[i];
-    if (iree_string_view_equal(key, entry->key)) {
-      *out_entry = entry;
-      break;
-    }
+  if (index->entry_count > 0) {
+    *out_entry = iree_io_parameter_index_find_bucket(
+                     index->buckets, index->bucket_capacity,
+                     iree_io_parameter_index_hash_key(key), key)
+                     ->entry;
   }
   if (*out_entry == NULL) {
     status = iree_make_status(IREE_STATUS_NOT_FOUND,
@@ -301,6 +464,15 @@ IREE_API_EXPORT iree_status_t iree_io_parameter_index_dump(
             (int)entry->key.size, entry->key.data));
         break;
       }
+      case IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_CHUNKED: {
+        IREE_RETURN_IF_ERROR(iree_string_builder_append_format(
+            builder,
+            "%9" PRIhsz " chunks |                - | %16" PRIu64
+            " | `%.*s`\n",
+            entry->storage.chunked.chunk_count, entry->length,
+            (int)entry->key.size, entry->key.data));
+        break;
+      }
       default: {
         IREE_RETURN_IF_ERROR(iree_string_builder_append_format(
             builder,
@@ -23,8 +23,32 @@ typedef enum iree_io_parameter_index_entry_storage_type_e {
   // Parameter is backed by a range of bytes within a file. Access rights are
   // inherited from the file handle.
   IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_FILE,
+  // Parameter is backed by a sequence of chunks within a file that may each be
+  // encoded (compressed) and may be shared with other chunks. Chunked
+  // parameters are read-only and must be decoded on the host when read.
+  IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_CHUNKED,
 } iree_io_parameter_index_entry_storage_type_t;
 
+// Encoding of a chunk of a chunked parameter.
+typedef enum iree_io_parameter_codec_e {
+  // Chunk contents are stored as-is.
+  IREE_IO_PARAMETER_CODEC_NONE = 0u,
+  // Chunk contents are stored as a single LZ4 block.
+  IREE_IO_PARAMETER_CODEC_LZ4_BLOCK = 1u,
+} iree_io_parameter_codec_t;
+
+// A chunk of a chunked parameter.
+typedef struct iree_io_parameter_index_chunk_t {
+  // Offset of the encoded chunk in bytes relative to the base file offset.
+  uint64_t offset;
+  // Length of the encoded chunk in bytes.
+  uint64_t length;
+  // Hash of the decoded chunk contents.
+  uint64_t content_hash;
+  // Encoding of the chunk contents.
+  iree_io_parameter_codec_t codec;
+} iree_io_parameter_index_chunk_t;
+
 // Power of two; enough bytes to fit complex128 (complex<f64>).
 // Prefer 1, 2, and 4 byte patterns as they can often hit hardware accelerated
 // fast paths while 8 and 16 may require emulation.
@@ -64,12 +88,27 @@ typedef struct iree_io_parameter_index_entry_t {
       // Offset of the entry in bytes relative to the base file offset.
       uint64_t offset;
     } file;
+    // Describes a chunked file-backed parameter.
+    // Valid when type is IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_CHUNKED.
+    struct {
+      // File handle backing all chunks of this entry, retained.
+      iree_io_file_handle_t* handle;
+      // Decoded length of each chunk in bytes. The last chunk decodes to the
+      // remainder of the entry length.
+      uint64_t chunk_size;
+      // Total number of chunks; ceil(length / chunk_size).
+      iree_host_size_t chunk_count;
+      // Dense list of chunks in decoded order. Copied into the index when the
+      // entry is added.
+      const iree_io_parameter_index_chunk_t* chunks;
+    } chunked;
   } storage;
 } iree_io_parameter_index_entry_t;
 
 // An in-memory file index mapping keys to byte ranges in referenced files.
-// A single index may contain entries from multiple files. Each parameter is
-// backed by a contiguous range in a single file.
+// A single index may contain entries from multiple files such as all of the
+// shards of a parameter set. Each parameter is backed by a contiguous range in
+// a single file.
 //
 // Thread-safe due to insert-only behavior. If we ever wanted to allow removal
 // from the index we would need to change callers to hold a mutex or design
@@ -108,6 +147,14 @@ IREE_API_EXPORT iree_status_t
 iree_io_parameter_index_add(iree_io_parameter_index_t* index,
                             const iree_io_parameter_index_entry_t* entry);
 
+// Adds all entries from |source| to |index| in the order they were added to
+// |source|. Entries are cloned as with iree_io_parameter_index_add and |source|
+// may be released after the call returns. Used to combine indices built
+// independently (such as from the shards of a parameter set parsed in
+// parallel) while keeping deterministic lookup results.
+IREE_API_EXPORT iree_status_t iree_io_parameter_index_merge(
+    iree_io_parameter_index_t* index, iree_io_parameter_index_t* source);
+
 // Returns the entry at index |i| in [0, iree_io_parameter_index_count).
 // The returned |out_entry| is valid for the lifetime of the index.
 IREE_API_EXPORT iree_status_t iree_io_parameter_index_get(
@@ -115,6 +162,8 @@ IREE_API_EXPORT iree_status_t iree_io_parameter_index_get(
     const iree_io_parameter_index_entry_t** out_entry);
 
 // Performs a file entry lookup of |key| in the index and returns it.
+// If multiple entries have the same key the first one added is returned.
+// Lookups are hashed and take constant time regardless of the index size.
 // The returned |out_entry| is valid for the lifetime of the index.
 IREE_API_EXPORT iree_status_t iree_io_parameter_index_lookup(
     iree_io_parameter_index_t* index, iree_string_view_t key,
@@ -6,20 +6,47 @@
 
 #include "iree/io/parameter_index_provider.h"
 
+#include "iree/base/internal/memory.h"
+#include "iree/base/internal/synchronization.h"
 #include "iree/hal/utils/file_cache.h"
+#include "iree/io/parameter_codec.h"
 
 // Limit concurrent operations to avoid blowing the stack. This is arbitrary and
 // if we wanted to support more we could switch to using heap allocations or
 // a growable stack scratchpad.
 #define IREE_IO_PARAMETER_OP_BATCH_MAX_CONCURRENCY 8
 
+// Maximum number of threads (including the calling thread) used to decode the
+// chunks of a single chunked parameter.
+#define IREE_IO_PARAMETER_DECODE_MAX_CONCURRENCY 8
+
+// Initial capacity of the import table. Grown by powers of two as needed.
+#define IREE_IO_PARAMETER_IMPORT_INITIAL_CAPACITY 64
+
+// Number of live buffers aliasing the host memory of an index entry.
+typedef struct iree_io_parameter_import_slot_t {
+  const iree_io_parameter_index_entry_t* entry;
+  iree_host_size_t live_count;
+} iree_io_parameter_import_slot_t;
+
 typedef struct iree_io_parameter_index_provider_t {
   iree_io_parameter_provider_t base;
   iree_allocator_t host_allocator;
   iree_host_size_t max_concurrent_operations;
+  iree_io_parameter_index_provider_flags_t flags;
   iree_string_view_t scope;
   iree_io_parameter_index_t* index;
   iree_hal_file_cache_t* file_cache;
+
+  // Guards the import table.
+  iree_slim_mutex_t import_mutex;
+  // Open-addressed table of entries whose host memory has been imported as
+  // buffers. Only maintained for reclaimable providers as they are the only
+  // ones that release host memory and must not do so while it is aliased.
+  // Capacity is a power of two and slots are never removed.
+  iree_host_size_t import_capacity;
+  iree_host_size_t import_count;
+  iree_io_parameter_import_slot_t* import_slots;
 } iree_io_parameter_index_provider_t;
 
 static const iree_io_parameter_provider_vtable_t
@@ -35,6 +62,18 @@ IREE_API_EXPORT iree_status_t iree_io_parameter_index_provider_create(
     iree_string_view_t scope, iree_io_parameter_index_t* index,
     iree_host_size_t max_concurrent_operations, iree_allocator_t host_allocator,
     iree_io_parameter_provider_t** out_provider) {
+  return iree_io_parameter_index_provider_create_with_flags(
+      scope, index, max_concurrent_operations,
+      IREE_IO_PARAMETER_INDEX_PROVIDER_FLAG_NONE, host_allocator, out_provider);
+}
+
+IREE_API_EXPORT iree_status_t
+iree_io_parameter_index_provider_create_with_flags(
+    iree_string_view_t scope, iree_io_parameter_index_t* index,
+    iree_host_size_t max_concurrent_operations,
+    iree_io_parameter_index_provider_flags_t flags,
+    iree_allocator_t host_allocator,
+    iree_io_parameter_provider_t** out_provider) {
   IREE_ASSERT_ARGUMENT(index);
   IREE_ASSERT_ARGUMENT(out_provider);
   *out_provider = NULL;
@@ -53,6 +92,7 @@ IREE_API_EXPORT iree_status_t iree_io_parameter_index_provider_create(
   provider->base.vtable = &iree_io_parameter_index_provider_vtable;
   provider->host_allocator = host_allocator;
   provider->max_concurrent_operations = max_concurrent_operations;
+  provider->flags = flags;
 
   provider->scope = iree_make_string_view(
       (const char*)provider + sizeof(*provider), scope.size);
@@ -61,6 +101,8 @@ IREE_API_EXPORT iree_status_t iree_io_parameter_index_provider_create(
   provider->index = index;
   iree_io_parameter_index_retain(index);
 
+  iree_slim_mutex_initialize(&provider->import_mutex);
+
   iree_status_t status =
       iree_hal_file_cache_create(host_allocator, &provider->file_cache);
 
@@ -83,6 +125,9 @@ static void iree_io_parameter_index_provider_destroy(
   iree_hal_file_cache_release(provider->file_cache);
   iree_io_parameter_index_release(provider->index);
 
+  iree_allocator_free(host_allocator, provider->import_slots);
+  iree_slim_mutex_deinitialize(&provider->import_mutex);
+
   iree_allocator_free(host_allocator, provider);
 
   IREE_TRACE_ZONE_END(z0);
@@ -179,6 +224,14 @@ static iree_status_t iree_io_validate_parameter_range(
             IREE_HAL_MEMORY_ACCESS_WRITE | IREE_HAL_MEMORY_ACCESS_DISCARD;
       }
       break;
+    case IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_CHUNKED:
+      // Chunked entries are decoded on read and cannot be written in-place.
+      if (iree_all_bits_set(
+              iree_io_file_handle_access(entry->storage.chunked.handle),
+              IREE_IO_FILE_ACCESS_READ)) {
+        allowed_access |= IREE_HAL_MEMORY_ACCESS_READ;
+      }
+      break;
     default:
       // Unknown entries are inaccessible.
       allowed_access = IREE_HAL_MEMORY_ACCESS_NONE;
@@ -214,6 +267,163 @@ static iree_status_t iree_io_validate_parameter_range(
   return iree_ok_status();
 }
 
+// Returns the host memory backing the |entry| range [offset, offset+length) if
+// the entry is stored in a file backed by a host allocation (such as a mapped
+// file) or an empty span if the entry is not host accessible.
+// The range must have already been validated against the entry.
+static iree_byte_span_t iree_io_parameter_index_entry_host_range(
+    const iree_io_parameter_index_entry_t* entry, uint64_t offset,
+    uint64_t length) {
+  if (entry->type != IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_FILE ||
+      iree_io_file_handle_type(entry->storage.file.handle) !=
+          IREE_IO_FILE_HANDLE_TYPE_HOST_ALLOCATION) {
+    return iree_make_byte_span(NULL, 0);
+  }
+  iree_byte_span_t host_allocation =
+      iree_io_file_handle_primitive(entry->storage.file.handle)
+          .value.host_allocation;
+  const uint64_t file_offset = entry->storage.file.offset + offset;
+  if (file_offset > host_allocation.data_length ||
+      length > host_allocation.data_length - file_offset) {
+    return iree_make_byte_span(NULL, 0);
+  }
+  return iree_make_byte_span(host_allocation.data + file_offset,
+                             (iree_host_size_t)length);
+}
+
+// Issues access pattern hints for the host memory backing the |entry| range
+// [offset, offset+length) if the provider has prefetching enabled. Has no
+// effect if the entry is not host accessible.
+static void iree_io_parameter_index_provider_prefetch(
+    iree_io_parameter_index_provider_t* provider,
+    const iree_io_parameter_index_entry_t* entry, uint64_t offset,
+    uint64_t length, iree_memory_advice_t advice) {
+  if (!iree_all_bits_set(provider->flags,
+                         IREE_IO_PARAMETER_INDEX_PROVIDER_FLAG_PREFETCH)) {
+    return;
+  }
+  iree_byte_span_t host_range =
+      iree_io_parameter_index_entry_host_range(entry, offset, length);
+  if (iree_byte_span_is_empty(host_range)) return;
+  iree_memory_advise(host_range.data, host_range.data_length, advice);
+}
+
+//===----------------------------------------------------------------------===//
+// Import tracking
+//===----------------------------------------------------------------------===//
+
+// Returns the slot for |entry| in the import table or the empty slot where it
+// would be inserted. The table must have a non-zero capacity.
+static iree_io_parameter_import_slot_t*
+iree_io_parameter_index_provider_find_import_slot_unsafe(
+    iree_io_parameter_index_provider_t* provider,
+    const iree_io_parameter_index_entry_t* entry) {
+  const iree_host_size_t mask = provider->import_capacity - 1;
+  iree_host_size_t slot =
+      (iree_host_size_t)(((uintptr_t)entry >> 4) * 0x9E3779B97F4A7C15ull) &
+      mask;
+  while (provider->import_slots[slot].entry &&
+         provider->import_slots[slot].entry != entry) {
+    slot = (slot + 1) & mask;
+  }
+  return &provider->import_slots[slot];
+}
+
+// Grows the import table so that at least one more entry can be inserted while
+// keeping the load factor at or below 1/2.
+static iree_status_t iree_io_parameter_index_provider_reserve_import_unsafe(
+    iree_io_parameter_index_provider_t* provider) {
+  if ((provider->import_count + 1) * 2 <= provider->import_capacity) {
+    return iree_ok_status();
+  }
+  iree_host_size_t new_capacity =
+      provider->import_capacity ? provider->import_capacity * 2
+                                : IREE_IO_PARAMETER_IMPORT_INITIAL_CAPACITY;
+  iree_io_parameter_import_slot_t* new_slots = NULL;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(provider->host_allocator,
+                                             new_capacity * sizeof(*new_slots),
+                                             (void**)&new_slots));
+  iree_io_parameter_import_slot_t* old_slots = provider->import_slots;
+  iree_host_size_t old_capacity = provider->import_capacity;
+  provider->import_slots = new_slots;
+  provider->import_capacity = new_capacity;
+  for (iree_host_size_t i = 0; i < old_capacity; ++i) {
+    if (!old_slots[i].entry) continue;
+    *iree_io_parameter_index_provider_find_import_slot_unsafe(
+        provider, old_slots[i].entry) = old_slots[i];
+  }
+  iree_allocator_free(provider->host_allocator, old_slots);
+  return iree_ok_status();
+}
+
+// Returns true if any live buffer aliases the host memory of |entry|.
+static bool iree_io_parameter_index_provider_is_imported(
+    iree_io_parameter_index_provider_t* provider,
+    const iree_io_parameter_index_entry_t* entry) {
+  iree_slim_mutex_lock(&provider->import_mutex);
+  bool is_imported =
+      provider->import_capacity &&
+      iree_io_parameter_index_provider_find_import_slot_unsafe(provider, entry)
+              ->live_count > 0;
+  iree_slim_mutex_unlock(&provider->import_mutex);
+  return is_imported;
+}
+
+// A buffer aliasing the host memory of an index entry.
+typedef struct iree_io_parameter_import_t {
+  // Retained so that the index and its entries outlive the buffer.
+  iree_io_parameter_index_provider_t* provider;
+  const iree_io_parameter_index_entry_t* entry;
+} iree_io_parameter_import_t;
+
+static void iree_io_parameter_import_buffer_release(void* user_data,
+                                                    iree_hal_buffer_t* buffer) {
+  iree_io_parameter_import_t* import = (iree_io_parameter_import_t*)user_data;
+  iree_io_parameter_index_provider_t* provider = import->provider;
+  iree_slim_mutex_lock(&provider->import_mutex);
+  --iree_io_parameter_index_provider_find_import_slot_unsafe(provider,
+                                                             import->entry)
+        ->live_count;
+  iree_slim_mutex_unlock(&provider->import_mutex);
+  iree_allocator_free(provider->host_allocator, import);
+  iree_io_parameter_provider_release((iree_io_parameter_provider_t*)provider);
+}
+
+// Records that a buffer aliasing the host memory of |entry| is being created
+// and returns the callback that must be invoked when it is released.
+static iree_status_t iree_io_parameter_index_provider_begin_import(
+    iree_io_parameter_index_provider_t* provider,
+    const iree_io_parameter_index_entry_t* entry,
+    iree_hal_buffer_release_callback_t* out_release_callback) {
+  iree_io_parameter_import_t* import = NULL;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      provider->host_allocator, sizeof(*import), (void**)&import));
+  iree_slim_mutex_lock(&provider->import_mutex);
+  iree_status_t status =
+      iree_io_parameter_index_provider_reserve_import_unsafe(provider);
+  if (iree_status_is_ok(status)) {
+    iree_io_parameter_import_slot_t* slot =
+        iree_io_parameter_index_provider_find_import_slot_unsafe(provider,
+                                                                 entry);
+    if (!slot->entry) {
+      slot->entry = entry;
+      ++provider->import_count;
+    }
+    ++slot->live_count;
+  }
+  iree_slim_mutex_unlock(&provider->import_mutex);
+  if (!iree_status_is_ok(status)) {
+    iree_allocator_free(provider->host_allocator, import);
+    return status;
+  }
+  import->provider = provider;
+  import->entry = entry;
+  iree_io_parameter_provider_retain((iree_io_parameter_provider_t*)provider);
+  out_release_callback->fn = iree_io_parameter_import_buffer_release;
+  out_release_callback->user_data = import;
+  return iree_ok_status();
+}
+
 // Stateful batch management of multiple parameter operations.
 //
 // The batch distributes operations over multiple timelines based on how much
@@ -673,6 +883,96 @@ static void iree_io_file_handle_buffer_release(void* user_data,
   iree_io_file_handle_release((iree_io_file_handle_t*)user_data);
 }
 
+typedef struct {
+  iree_allocator_t host_allocator;
+  void* ptr;
+} iree_io_parameter_staging_t;
+
+static void iree_io_parameter_staging_release(
+    void* user_data, iree_io_file_handle_primitive_t handle_primitive) {
+  iree_io_parameter_staging_t* staging =
+      (iree_io_parameter_staging_t*)user_data;
+  iree_allocator_t host_allocator = staging->host_allocator;
+  iree_allocator_free_aligned(host_allocator, staging->ptr);
+  iree_allocator_free(host_allocator, staging);
+}
+
+// Decodes the chunked |entry| range [offset, offset+length) into a new host
+// allocation aligned for import as a HAL buffer and returns a file handle
+// wrapping it in |out_handle|. Decoding happens synchronously on the host as
+// the operation is enqueued; this is safe as parameter contents are immutable
+// while referenced by the index.
+static iree_status_t iree_io_parameter_index_provider_decode_chunked(
+    iree_io_parameter_index_provider_t* provider,
+    const iree_io_parameter_index_entry_t* entry, uint64_t offset,
+    uint64_t length, iree_io_file_handle_t** out_handle) {
+  *out_handle = NULL;
+  if (length > IREE_HOST_SIZE_MAX) {
+    return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                            "parameter `%.*s` range exceeds the host address "
+                            "space (length=%" PRIu64 ")",
+                            (int)entry->key.size, entry->key.data, length);
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, length);
+
+  iree_allocator_t host_allocator = provider->host_allocator;
+  iree_io_parameter_staging_t* staging = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(host_allocator, sizeof(*staging),
+                                (void**)&staging));
+  staging->host_allocator = host_allocator;
+  staging->ptr = NULL;
+  iree_status_t status = iree_allocator_malloc_aligned(
+      host_allocator, iree_max(1, (iree_host_size_t)length),
+      IREE_HAL_HEAP_BUFFER_ALIGNMENT, 0, &staging->ptr);
+
+  iree_byte_span_t contents =
+      iree_make_byte_span(staging->ptr, (iree_host_size_t)length);
+  if (iree_status_is_ok(status)) {
+    status = iree_io_parameter_chunked_entry_read(
+        entry, offset, contents, IREE_IO_PARAMETER_DECODE_MAX_CONCURRENCY,
+        host_allocator);
+  }
+
+  iree_io_file_handle_t* handle = NULL;
+  if (iree_status_is_ok(status)) {
+    iree_io_file_handle_release_callback_t release_callback = {
+        .fn = iree_io_parameter_staging_release,
+        .user_data = staging,
+    };
+    status = iree_io_file_handle_wrap_host_allocation(
+        IREE_IO_FILE_ACCESS_READ, contents, release_callback, host_allocator,
+        &handle);
+  }
+
+  if (iree_status_is_ok(status)) {
+    *out_handle = handle;
+  } else {
+    iree_allocator_free_aligned(host_allocator, staging->ptr);
+    iree_allocator_free(host_allocator, staging);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+// Decodes the chunked |entry| range [offset, offset+length) and imports the
+// decoded contents as a HAL file that can be read from offset 0.
+static iree_status_t iree_io_parameter_index_provider_import_chunked(
+    iree_io_parameter_op_batch_t* batch,
+    const iree_io_parameter_index_entry_t* entry, uint64_t offset,
+    uint64_t length, iree_hal_file_t** out_file) {
+  *out_file = NULL;
+  iree_io_file_handle_t* handle = NULL;
+  IREE_RETURN_IF_ERROR(iree_io_parameter_index_provider_decode_chunked(
+      batch->provider, entry, offset, length, &handle));
+  iree_status_t status = iree_hal_file_import(
+      batch->device, batch->queue_affinity, IREE_HAL_MEMORY_ACCESS_READ,
+      handle, IREE_HAL_EXTERNAL_FILE_FLAG_NONE, out_file);
+  iree_io_file_handle_release(handle);
+  return status;
+}
+
 static iree_status_t iree_io_parameter_index_provider_load(
     iree_io_parameter_provider_t* base_provider, iree_hal_device_t* device,
     iree_hal_queue_affinity_t queue_affinity,
@@ -728,44 +1028,86 @@ static iree_status_t iree_io_parameter_index_provider_load(
     // conditions in which we use this with some better file handle helpers that
     // allow us to map files that we already have open via other mechanisms
     // (FILE, fd, etc).
+    //
+    // Parameters within archives are not guaranteed to be aligned to what
+    // devices require for buffers and if they are not we fall back to the
+    // allocate + read path below. On the CPU the import is a no-op wrap of the
+    // mapped pages and avoids both the copy and the duplicate memory.
+    //
+    // Chunked parameters are decoded on the host into aligned staging memory
+    // that is then imported in the same way as a mapped file. If the import
+    // fails the decoded contents are read into a device allocation instead.
     iree_hal_buffer_t* target_buffer = NULL;
+    iree_io_file_handle_t* host_handle = NULL;  // unretained
+    iree_io_file_handle_t* decoded_handle = NULL;  // retained if chunked
+    iree_byte_span_t host_range = iree_make_byte_span(NULL, 0);
     if (iree_status_is_ok(status) &&
-        source_entry->type == IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_FILE &&
-        iree_io_file_handle_type(source_entry->storage.file.handle) ==
-            IREE_IO_FILE_HANDLE_TYPE_HOST_ALLOCATION) {
-      iree_byte_span_t host_allocation =
-          iree_io_file_handle_primitive(source_entry->storage.file.handle)
-              .value.host_allocation;
+        source_entry->type ==
+            IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_CHUNKED) {
+      status = iree_io_parameter_index_provider_decode_chunked(
+          provider, source_entry, span.parameter_offset, span.length,
+          &decoded_handle);
+      if (iree_status_is_ok(status) && span.buffer_offset == 0) {
+        host_handle = decoded_handle;
+        host_range =
+            iree_io_file_handle_primitive(decoded_handle).value.host_allocation;
+      }
+    } else if (iree_status_is_ok(status) && span.buffer_offset == 0) {
+      host_handle = source_entry->storage.file.handle;
+      host_range = iree_io_parameter_index_entry_host_range(
+          source_entry, span.parameter_offset, span.length);
+    }
+    if (!iree_byte_span_is_empty(host_range) &&
+        iree_host_size_has_alignment((iree_host_size_t)host_range.data,
+                                     IREE_HAL_HEAP_BUFFER_ALIGNMENT)) {
       iree_hal_external_buffer_t external_buffer = {
           .type = IREE_HAL_EXTERNAL_BUFFER_TYPE_HOST_ALLOCATION,
           .flags = IREE_HAL_EXTERNAL_BUFFER_FLAG_NONE,
-          .size = host_allocation.data_length,
+          .size = host_range.data_length,
           .handle =
               {
                   .host_allocation =
                       {
-                          .ptr = host_allocation.data +
-                                 source_entry->storage.file.offset,
+                          .ptr = host_range.data,
                       },
               },
       };
+      // Buffers aliasing reclaimable entry memory are tracked so that the
+      // pages are not released while the buffers may still be in use.
       iree_hal_buffer_release_callback_t release_callback = {
           .fn = iree_io_file_handle_buffer_release,
-          .user_data = source_entry->storage.file.handle,
+          .user_data = host_handle,
       };
-      iree_io_file_handle_retain(source_entry->storage.file.handle);
-      iree_status_t import_status = iree_hal_allocator_import_buffer(
-          iree_hal_device_allocator(device), target_params, &external_buffer,
-          release_callback, &target_buffer);
+      iree_status_t import_status = iree_ok_status();
+      if (host_handle != decoded_handle &&
+          iree_all_bits_set(
+              provider->flags,
+              IREE_IO_PARAMETER_INDEX_PROVIDER_FLAG_RECLAIMABLE)) {
+        import_status = iree_io_parameter_index_provider_begin_import(
+            provider, source_entry, &release_callback);
+      } else {
+        iree_io_file_handle_retain(host_handle);
+      }
       if (iree_status_is_ok(import_status)) {
-        // Import succeeded - issue a barrier to preserve the async timeline.
+        import_status = iree_hal_allocator_import_buffer(
+            iree_hal_device_allocator(device), target_params, &external_buffer,
+            release_callback, &target_buffer);
+        if (!iree_status_is_ok(import_status)) {
+          release_callback.fn(release_callback.user_data, NULL);
+        }
+      }
+      if (iree_status_is_ok(import_status)) {
+        // Import succeeded - the pages will be faulted in on first use so we
+        // ask the system to begin reading them now.
         IREE_TRACE_ZONE_APPEND_TEXT(z_entry, "import succeeded");
+        iree_io_parameter_index_provider_prefetch(
+            provider, source_entry, span.parameter_offset, span.length,
+            IREE_MEMORY_ADVICE_WILL_NEED);
       } else {
         // Failed to import - that's ok as we'll just do the full allocate +
         // read.
         IREE_TRACE_ZONE_APPEND_TEXT(z_entry, "import failed");
         import_status = iree_status_ignore(import_status);
-        iree_io_file_handle_release(source_entry->storage.file.handle);
       }
     }
 
@@ -790,12 +1132,30 @@ static iree_status_t iree_io_parameter_index_provider_load(
           }
           case IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_FILE: {
             IREE_ASSERT(source_file);
+            iree_io_parameter_index_provider_prefetch(
+                provider, source_entry, span.parameter_offset, span.length,
+                IREE_MEMORY_ADVICE_WILL_NEED | IREE_MEMORY_ADVICE_SEQUENTIAL);
             status = iree_io_parameter_op_batch_enqueue_file_read(
                 &batch, source_file,
                 source_entry->storage.file.offset + span.parameter_offset,
                 target_buffer, span.buffer_offset, span.length, 0);
             break;
           }
+          case IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_CHUNKED: {
+            IREE_ASSERT(decoded_handle);
+            iree_hal_file_t* decoded_file = NULL;
+            status = iree_hal_file_import(
+                device, queue_affinity, IREE_HAL_MEMORY_ACCESS_READ,
+                decoded_handle, IREE_HAL_EXTERNAL_FILE_FLAG_NONE,
+                &decoded_file);
+            if (iree_status_is_ok(status)) {
+              status = iree_io_parameter_op_batch_enqueue_file_read(
+                  &batch, decoded_file, 0, target_buffer, span.buffer_offset,
+                  span.length, 0);
+            }
+            iree_hal_file_release(decoded_file);
+            break;
+          }
           default: {
             status = iree_make_status(
                 IREE_STATUS_FAILED_PRECONDITION,
@@ -808,6 +1168,7 @@ static iree_status_t iree_io_parameter_index_provider_load(
     }
 
     iree_hal_file_release(source_file);
+    iree_io_file_handle_release(decoded_handle);
 
     // Emit the target buffer so the caller can handle it. The callee must
     // retain it if they want to keep it live. We're allowed to emit out of
@@ -880,12 +1241,32 @@ static iree_status_t iree_io_parameter_index_provider_gather(
         }
         case IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_FILE: {
           IREE_ASSERT(source_file);
+          // The read is only enqueued here and will execute once its
+          // timeline is reached; hinting now lets the system fault in the
+          // source pages while prior operations complete.
+          iree_io_parameter_index_provider_prefetch(
+              provider, source_entry, span.parameter_offset, span.length,
+              IREE_MEMORY_ADVICE_WILL_NEED | IREE_MEMORY_ADVICE_SEQUENTIAL);
           status = iree_io_parameter_op_batch_enqueue_file_read(
               &batch, source_file,
               source_entry->storage.file.offset + span.parameter_offset,
               target_buffer, span.buffer_offset, span.length, 0);
           break;
         }
+        case IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_CHUNKED: {
+          IREE_ASSERT(!source_file);
+          iree_hal_file_t* decoded_file = NULL;
+          status = iree_io_parameter_index_provider_import_chunked(
+              &batch, source_entry, span.parameter_offset, span.length,
+              &decoded_file);
+          if (iree_status_is_ok(status)) {
+            status = iree_io_parameter_op_batch_enqueue_file_read(
+                &batch, decoded_file, 0, target_buffer, span.buffer_offset,
+                span.length, 0);
+          }
+          iree_hal_file_release(decoded_file);
+          break;
+        }
         default: {
           status = iree_make_status(
               IREE_STATUS_FAILED_PRECONDITION,
@@ -981,6 +1362,56 @@ static iree_status_t iree_io_parameter_index_provider_scatter(
   return status;
 }
 
+static iree_status_t iree_io_parameter_index_provider_advise(
+    iree_io_parameter_provider_t* base_provider, iree_string_view_t scope,
+    iree_string_view_t key, uint64_t offset, uint64_t length,
+    iree_io_parameter_advice_t advice) {
+  iree_io_parameter_index_provider_t* provider =
+      iree_io_parameter_index_provider_cast(base_provider);
+
+  const iree_io_parameter_index_entry_t* entry = NULL;
+  IREE_RETURN_IF_ERROR(
+      iree_io_parameter_index_lookup(provider->index, key, &entry));
+  IREE_RETURN_IF_ERROR(iree_io_validate_parameter_range(
+      IREE_HAL_MEMORY_ACCESS_NONE, entry, offset, length));
+
+  // Only parameters directly backed by host memory have anything to page in or
+  // out; everything else is read from its backing storage on each use.
+  iree_byte_span_t host_range =
+      iree_io_parameter_index_entry_host_range(entry, offset, length);
+  if (iree_byte_span_is_empty(host_range)) return iree_ok_status();
+  switch (advice) {
+    case IREE_IO_PARAMETER_ADVICE_WILL_NEED:
+      iree_memory_advise(host_range.data, host_range.data_length,
+                         IREE_MEMORY_ADVICE_WILL_NEED);
+      break;
+    case IREE_IO_PARAMETER_ADVICE_DONT_NEED:
+      // Releasing pages of host allocations that aren't file mappings would
+      // discard their contents.
+      if (!iree_all_bits_set(
+              provider->flags,
+              IREE_IO_PARAMETER_INDEX_PROVIDER_FLAG_RECLAIMABLE)) {
+        break;
+      }
+      // Pages of read-only mappings fault back in with the same contents so
+      // they can be released even while imported buffers alias them. Writable
+      // mappings may hold modifications made through the buffers and are left
+      // in place until the buffers are released.
+      if (iree_any_bit_set(
+              iree_io_file_handle_access(entry->storage.file.handle),
+              IREE_IO_FILE_ACCESS_WRITE) &&
+          iree_io_parameter_index_provider_is_imported(provider, entry)) {
+        return iree_status_from_code(IREE_STATUS_FAILED_PRECONDITION);
+      }
+      iree_memory_advise(host_range.data, host_range.data_length,
+                         IREE_MEMORY_ADVICE_DONT_NEED);
+      break;
+    default:
+      break;
+  }
+  return iree_ok_status();
+}
+
 static const iree_io_parameter_provider_vtable_t
     iree_io_parameter_index_provider_vtable = {
         .destroy = iree_io_parameter_index_provider_destroy,
@@ -989,4 +1420,5 @@ static const iree_io_parameter_provider_vtable_t
         .load = iree_io_parameter_index_provider_load,
         .gather = iree_io_parameter_index_provider_gather,
         .scatter = iree_io_parameter_index_provider_scatter,
+        .advise = iree_io_parameter_index_provider_advise,
 };
@@ -21,6 +21,31 @@ extern "C" {
 // Reasonable default for the `max_concurrent_operations` parameter.
 #define IREE_IO_PARAMETER_INDEX_PROVIDER_DEFAULT_MAX_CONCURRENT_OPERATIONS 16
 
+// Controls parameter index provider behavior.
+enum iree_io_parameter_index_provider_flag_bits_t {
+  IREE_IO_PARAMETER_INDEX_PROVIDER_FLAG_NONE = 0u,
+
+  // Issues access pattern hints (madvise on POSIX) for parameters backed by
+  // host allocations such as mapped files ahead of performing operations on
+  // them. Loads that are able to import the mapped file ranges directly as
+  // buffers hint that the pages will be needed soon so that the system can
+  // begin faulting them in while the loads are scheduled. Gathers that copy
+  // out of the mapped file additionally hint sequential access so that the
+  // system can read ahead aggressively and reclaim the source pages once
+  // copied.
+  IREE_IO_PARAMETER_INDEX_PROVIDER_FLAG_PREFETCH = 1u << 0,
+
+  // Parameters backed by host allocations are shared file mappings whose pages
+  // can be released and later faulted back in from the file. Required for
+  // IREE_IO_PARAMETER_ADVICE_DONT_NEED to release any memory; without it the
+  // host allocations may be heap memory or private mappings whose contents
+  // would be lost. Pages of read-only mappings are released even while
+  // buffers imported by loads alias them. Advising writable mappings aliased
+  // by live buffers fails with IREE_STATUS_FAILED_PRECONDITION.
+  IREE_IO_PARAMETER_INDEX_PROVIDER_FLAG_RECLAIMABLE = 1u << 1,
+};
+typedef uint32_t iree_io_parameter_index_provider_flags_t;
+
 // Creates a parameter provider serving from the provided |index|.
 // As parameters are operated on their files will be registered with the devices
 // they are used on and cached for future requests.
@@ -35,6 +60,16 @@ IREE_API_EXPORT iree_status_t iree_io_parameter_index_provider_create(
     iree_host_size_t max_concurrent_operations, iree_allocator_t host_allocator,
     iree_io_parameter_provider_t** out_provider);
 
+// Creates a parameter provider serving from the provided |index| with the
+// behavior controlled by |flags|.
+// See iree_io_parameter_index_provider_create for more information.
+IREE_API_EXPORT iree_status_t iree_io_parameter_index_provider_create_with_flags(
+    iree_string_view_t scope, iree_io_parameter_index_t* index,
+    iree_host_size_t max_concurrent_operations,
+    iree_io_parameter_index_provider_flags_t flags,
+    iree_allocator_t host_allocator,
+    iree_io_parameter_provider_t** out_provider);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
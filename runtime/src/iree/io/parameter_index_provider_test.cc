@@ -0,0 +1,229 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/io/parameter_index_provider.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/base/internal/file_io.h"
+#include "iree/hal/api.h"
+#include "iree/hal/drivers/local_sync/sync_device.h"
+#include "iree/io/file_handle.h"
+#include "iree/io/parameter_index.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace {
+
+static constexpr iree_host_size_t kParameterLength = 64 * 1024;
+
+static iree_status_t EmitBuffer(void* user_data, iree_host_size_t i,
+                                iree_hal_buffer_t* buffer) {
+  iree_hal_buffer_retain(buffer);
+  *(iree_hal_buffer_t**)user_data = buffer;
+  return iree_ok_status();
+}
+
+static iree_status_t EnumerateWeight(void* user_data, iree_host_size_t i,
+                                     iree_string_view_t* out_key,
+                                     iree_io_parameter_span_t* out_span) {
+  *out_key = IREE_SV("weight");
+  out_span->parameter_offset = 0;
+  out_span->buffer_offset = 0;
+  out_span->length = kParameterLength;
+  return iree_ok_status();
+}
+
+class ParameterIndexProviderTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    iree_allocator_t host_allocator = iree_allocator_system();
+    IREE_ASSERT_OK(iree_hal_allocator_create_heap(
+        IREE_SV("heap"), host_allocator, host_allocator, &device_allocator_));
+    iree_hal_sync_device_params_t params;
+    iree_hal_sync_device_params_initialize(&params);
+    IREE_ASSERT_OK(iree_hal_sync_device_create(
+        IREE_SV("local-sync"), &params, /*loader_count=*/0, /*loaders=*/NULL,
+        device_allocator_, host_allocator, &device_));
+    IREE_ASSERT_OK(iree_io_parameter_index_create(host_allocator, &index_));
+
+    contents_.resize(kParameterLength);
+    for (size_t i = 0; i < contents_.size(); ++i) {
+      contents_[i] = (uint8_t)(i * 7 + i / 4096);
+    }
+  }
+
+  void TearDown() override {
+    iree_io_parameter_provider_release(provider_);
+    iree_io_parameter_index_release(index_);
+    iree_hal_device_release(device_);
+    iree_hal_allocator_release(device_allocator_);
+  }
+
+  // Adds the `weight` parameter backed by |handle| at offset 0 and creates a
+  // reclaimable provider serving it.
+  void CreateReclaimableProvider(iree_io_file_handle_t* handle) {
+    iree_io_parameter_index_entry_t entry;
+    memset(&entry, 0, sizeof(entry));
+    entry.key = IREE_SV("weight");
+    entry.length = kParameterLength;
+    entry.type = IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_FILE;
+    entry.storage.file.handle = handle;
+    entry.storage.file.offset = 0;
+    IREE_ASSERT_OK(iree_io_parameter_index_add(index_, &entry));
+    IREE_ASSERT_OK(iree_io_parameter_index_provider_create_with_flags(
+        IREE_SV("model"), index_,
+        IREE_IO_PARAMETER_INDEX_PROVIDER_DEFAULT_MAX_CONCURRENT_OPERATIONS,
+        IREE_IO_PARAMETER_INDEX_PROVIDER_FLAG_RECLAIMABLE,
+        iree_allocator_system(), &provider_));
+  }
+
+  // Loads the `weight` parameter and returns the resulting buffer.
+  iree_hal_buffer_t* LoadWeight() {
+    iree_hal_semaphore_t* semaphore = NULL;
+    IREE_CHECK_OK(iree_hal_semaphore_create(device_, 0ull, &semaphore));
+    uint64_t signal_value = 1ull;
+    iree_hal_semaphore_list_t signal_semaphore_list = {
+        1,
+        &semaphore,
+        &signal_value,
+    };
+    iree_hal_buffer_params_t target_params = {0};
+    target_params.type =
+        IREE_HAL_MEMORY_TYPE_HOST_LOCAL | IREE_HAL_MEMORY_TYPE_DEVICE_VISIBLE;
+    target_params.usage =
+        IREE_HAL_BUFFER_USAGE_TRANSFER | IREE_HAL_BUFFER_USAGE_MAPPING;
+    target_params.access = IREE_HAL_MEMORY_ACCESS_READ;
+    iree_hal_buffer_t* buffer = NULL;
+    iree_io_parameter_enumerator_t enumerator = {EnumerateWeight, NULL};
+    iree_io_parameter_emitter_t emitter = {EmitBuffer, &buffer};
+    IREE_CHECK_OK(iree_io_parameter_provider_load(
+        provider_, device_, IREE_HAL_QUEUE_AFFINITY_ANY,
+        iree_hal_semaphore_list_empty(), signal_semaphore_list,
+        IREE_SV("model"), target_params, /*count=*/1, enumerator, emitter));
+    IREE_CHECK_OK(
+        iree_hal_semaphore_wait(semaphore, 1ull, iree_infinite_timeout()));
+    iree_hal_semaphore_release(semaphore);
+    return buffer;
+  }
+
+  // Returns true if |buffer| aliases |host_ptr| instead of holding a copy.
+  static bool IsImported(iree_hal_buffer_t* buffer, const void* host_ptr) {
+    iree_hal_buffer_mapping_t mapping;
+    IREE_CHECK_OK(iree_hal_buffer_map_range(
+        buffer, IREE_HAL_MAPPING_MODE_SCOPED, IREE_HAL_MEMORY_ACCESS_READ, 0,
+        IREE_WHOLE_BUFFER, &mapping));
+    bool is_imported = mapping.contents.data == host_ptr;
+    IREE_CHECK_OK(iree_hal_buffer_unmap_range(&mapping));
+    return is_imported;
+  }
+
+  static std::vector<uint8_t> ReadBuffer(iree_hal_buffer_t* buffer) {
+    std::vector<uint8_t> actual(kParameterLength);
+    IREE_CHECK_OK(
+        iree_hal_buffer_map_read(buffer, 0, actual.data(), actual.size()));
+    return actual;
+  }
+
+  iree_hal_allocator_t* device_allocator_ = NULL;
+  iree_hal_device_t* device_ = NULL;
+  iree_io_parameter_index_t* index_ = NULL;
+  iree_io_parameter_provider_t* provider_ = NULL;
+  std::vector<uint8_t> contents_;
+};
+
+static void ReleaseFileContents(
+    void* user_data, iree_io_file_handle_primitive_t handle_primitive) {
+  iree_file_contents_free((iree_file_contents_t*)user_data);
+}
+
+// Tests that pages of a read-only file mapping imported by a load can be
+// released while the buffer is live and that the buffer faults them back in.
+TEST_F(ParameterIndexProviderTest, EvictImportedReadOnlyMapping) {
+  std::string path =
+      ::testing::TempDir() + "/parameter_index_provider_test_mapping.bin";
+  FILE* file = fopen(path.c_str(), "wb");
+  ASSERT_NE(file, nullptr);
+  ASSERT_EQ(fwrite(contents_.data(), 1, contents_.size(), file),
+            contents_.size());
+  fclose(file);
+  iree_file_contents_t* file_contents = NULL;
+  iree_status_t status =
+      iree_file_read_contents(path.c_str(), IREE_FILE_READ_FLAG_MMAP,
+                              iree_allocator_system(), &file_contents);
+  std::remove(path.c_str());
+  if (iree_status_is_unavailable(status) ||
+      iree_status_is_unimplemented(status)) {
+    iree_status_ignore(status);
+    GTEST_SKIP() << "file mapping not supported on this platform";
+  }
+  IREE_ASSERT_OK(status);
+  iree_io_file_handle_release_callback_t release_callback = {
+      ReleaseFileContents,
+      file_contents,
+  };
+  iree_io_file_handle_t* handle = NULL;
+  IREE_ASSERT_OK(iree_io_file_handle_wrap_host_allocation(
+      IREE_IO_FILE_ACCESS_READ, file_contents->buffer, release_callback,
+      iree_allocator_system(), &handle));
+  CreateReclaimableProvider(handle);
+  iree_io_file_handle_release(handle);
+
+  iree_hal_buffer_t* buffer = LoadWeight();
+  ASSERT_NE(buffer, nullptr);
+  EXPECT_TRUE(IsImported(buffer, file_contents->const_buffer.data));
+  EXPECT_EQ(ReadBuffer(buffer), contents_);
+
+  IREE_EXPECT_OK(iree_io_parameter_provider_advise(
+      provider_, IREE_SV("model"), IREE_SV("weight"), 0, kParameterLength,
+      IREE_IO_PARAMETER_ADVICE_DONT_NEED));
+  EXPECT_EQ(ReadBuffer(buffer), contents_);
+
+  iree_hal_buffer_release(buffer);
+}
+
+// Tests that pages of a writable host allocation imported by a load are not
+// released while the buffer is live.
+TEST_F(ParameterIndexProviderTest, RefuseEvictingImportedWritableAllocation) {
+  void* host_ptr = NULL;
+  IREE_ASSERT_OK(iree_allocator_malloc_aligned(
+      iree_allocator_system(), kParameterLength, IREE_HAL_HEAP_BUFFER_ALIGNMENT,
+      0, &host_ptr));
+  memcpy(host_ptr, contents_.data(), contents_.size());
+  iree_io_file_handle_t* handle = NULL;
+  IREE_ASSERT_OK(iree_io_file_handle_wrap_host_allocation(
+      IREE_IO_FILE_ACCESS_READ | IREE_IO_FILE_ACCESS_WRITE,
+      iree_make_byte_span(host_ptr, kParameterLength),
+      iree_io_file_handle_release_callback_null(), iree_allocator_system(),
+      &handle));
+  CreateReclaimableProvider(handle);
+  iree_io_file_handle_release(handle);
+
+  iree_hal_buffer_t* buffer = LoadWeight();
+  ASSERT_NE(buffer, nullptr);
+  EXPECT_TRUE(IsImported(buffer, host_ptr));
+
+  IREE_EXPECT_STATUS_IS(
+      IREE_STATUS_FAILED_PRECONDITION,
+      iree_io_parameter_provider_advise(provider_, IREE_SV("model"),
+                                        IREE_SV("weight"), 0, kParameterLength,
+                                        IREE_IO_PARAMETER_ADVICE_DONT_NEED));
+  EXPECT_EQ(ReadBuffer(buffer), contents_);
+
+  iree_hal_buffer_release(buffer);
+  iree_io_parameter_provider_release(provider_);
+  provider_ = NULL;
+  iree_io_parameter_index_release(index_);
+  index_ = NULL;
+  iree_allocator_free_aligned(iree_allocator_system(), host_ptr);
+}
+
+}  // namespace
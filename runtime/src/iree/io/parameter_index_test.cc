@@ -0,0 +1,100 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/io/parameter_index.h"
+
+#include <cstring>
+#include <string>
+
+#include "iree/base/api.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace {
+
+using ::iree::Status;
+using ::iree::StatusCode;
+using ::iree::testing::status::StatusIs;
+
+class ParameterIndexTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    IREE_ASSERT_OK(
+        iree_io_parameter_index_create(iree_allocator_system(), &index_));
+  }
+  void TearDown() override { iree_io_parameter_index_release(index_); }
+
+  static iree_status_t AddSplat(iree_io_parameter_index_t* index,
+                                const std::string& key, uint64_t length) {
+    iree_io_parameter_index_entry_t entry;
+    memset(&entry, 0, sizeof(entry));
+    entry.key = iree_make_string_view(key.data(), key.size());
+    entry.length = length;
+    entry.type = IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_SPLAT;
+    entry.storage.splat.pattern_length = 1;
+    return iree_io_parameter_index_add(index, &entry);
+  }
+
+  uint64_t LookupLength(const std::string& key) {
+    const iree_io_parameter_index_entry_t* entry = NULL;
+    IREE_CHECK_OK(iree_io_parameter_index_lookup(
+        index_, iree_make_string_view(key.data(), key.size()), &entry));
+    return entry->length;
+  }
+
+  iree_io_parameter_index_t* index_ = NULL;
+};
+
+TEST_F(ParameterIndexTest, LookupMissing) {
+  const iree_io_parameter_index_entry_t* entry = NULL;
+  EXPECT_THAT(Status(iree_io_parameter_index_lookup(index_, IREE_SV("a"),
+                                                    &entry)),
+              StatusIs(StatusCode::kNotFound));
+  IREE_ASSERT_OK(AddSplat(index_, "a", 1));
+  EXPECT_THAT(Status(iree_io_parameter_index_lookup(index_, IREE_SV("b"),
+                                                    &entry)),
+              StatusIs(StatusCode::kNotFound));
+}
+
+TEST_F(ParameterIndexTest, LookupMany) {
+  // Enough entries to grow the lookup table several times.
+  for (int i = 0; i < 5000; ++i) {
+    IREE_ASSERT_OK(AddSplat(index_, "p" + std::to_string(i), i));
+  }
+  EXPECT_EQ(iree_io_parameter_index_count(index_), 5000);
+  for (int i = 0; i < 5000; ++i) {
+    EXPECT_EQ(LookupLength("p" + std::to_string(i)), i);
+  }
+}
+
+TEST_F(ParameterIndexTest, DuplicateKeysReturnFirst) {
+  IREE_ASSERT_OK(AddSplat(index_, "a", 1));
+  IREE_ASSERT_OK(AddSplat(index_, "a", 2));
+  // Force a rehash and ensure the first entry is still the one found.
+  IREE_ASSERT_OK(iree_io_parameter_index_reserve(index_, 1000));
+  EXPECT_EQ(iree_io_parameter_index_count(index_), 2);
+  EXPECT_EQ(LookupLength("a"), 1);
+}
+
+TEST_F(ParameterIndexTest, Merge) {
+  iree_io_parameter_index_t* shards[2] = {NULL, NULL};
+  for (int i = 0; i < 2; ++i) {
+    IREE_ASSERT_OK(
+        iree_io_parameter_index_create(iree_allocator_system(), &shards[i]));
+    IREE_ASSERT_OK(AddSplat(shards[i], "shared", 100 + i));
+    IREE_ASSERT_OK(AddSplat(shards[i], "s" + std::to_string(i), i));
+  }
+  for (int i = 0; i < 2; ++i) {
+    IREE_ASSERT_OK(iree_io_parameter_index_merge(index_, shards[i]));
+    iree_io_parameter_index_release(shards[i]);
+  }
+  EXPECT_EQ(iree_io_parameter_index_count(index_), 4);
+  EXPECT_EQ(LookupLength("shared"), 100);
+  EXPECT_EQ(LookupLength("s0"), 0);
+  EXPECT_EQ(LookupLength("s1"), 1);
+}
+
+}  // namespace
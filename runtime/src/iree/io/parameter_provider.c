@@ -203,3 +203,17 @@ IREE_API_EXPORT iree_status_t iree_io_parameter_provider_scatter(
   IREE_TRACE_ZONE_END(z0);
   return iree_ok_status();
 }
+
+IREE_API_EXPORT iree_status_t iree_io_parameter_provider_advise(
+    iree_io_parameter_provider_t* provider, iree_string_view_t scope,
+    iree_string_view_t key, uint64_t offset, uint64_t length,
+    iree_io_parameter_advice_t advice) {
+  IREE_ASSERT_ARGUMENT(provider);
+  if (!provider->vtable->advise) return iree_ok_status();
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_TEXT(z0, key.data, key.size);
+  iree_status_t status =
+      provider->vtable->advise(provider, scope, key, offset, length, advice);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
@@ -36,6 +36,17 @@ typedef enum iree_io_parameter_provider_signal_e {
   IREE_IO_PARAMETER_PROVIDER_SIGNAL_LOW_MEMORY = 2,
 } iree_io_parameter_provider_signal_t;
 
+// Hints describing how a parameter will be used in the near future.
+typedef enum iree_io_parameter_advice_e {
+  // Parameter contents will be used soon and the provider should begin making
+  // them resident (such as by faulting in mapped file pages).
+  IREE_IO_PARAMETER_ADVICE_WILL_NEED = 0,
+  // Parameter contents will not be used soon and the provider may release any
+  // host memory backing them. Contents must remain available and will be
+  // brought back in from their backing storage on next use.
+  IREE_IO_PARAMETER_ADVICE_DONT_NEED = 1,
+} iree_io_parameter_advice_t;
+
 typedef struct iree_io_parameter_span_t {
   uint64_t parameter_offset;
   iree_device_size_t buffer_offset;
@@ -181,6 +192,18 @@ IREE_API_EXPORT iree_status_t iree_io_parameter_provider_scatter(
     iree_hal_buffer_t* source_buffer, iree_string_view_t target_scope,
     iree_host_size_t count, iree_io_parameter_enumerator_t enumerator);
 
+// Advises |provider| how the range [offset, offset+length) of the parameter
+// with |key| in |scope| will be used in the near future. Advice is a hint and
+// providers that have no use for it ignore it.
+//
+// Returns IREE_STATUS_NOT_FOUND if the parameter is not found and
+// IREE_STATUS_FAILED_PRECONDITION if IREE_IO_PARAMETER_ADVICE_DONT_NEED cannot
+// release the memory because it is still referenced by live buffers.
+IREE_API_EXPORT iree_status_t iree_io_parameter_provider_advise(
+    iree_io_parameter_provider_t* provider, iree_string_view_t scope,
+    iree_string_view_t key, uint64_t offset, uint64_t length,
+    iree_io_parameter_advice_t advice);
+
 //===----------------------------------------------------------------------===//
 // iree_io_parameter_provider_t implementation details
 //===----------------------------------------------------------------------===//
@@ -220,6 +243,13 @@ typedef struct iree_io_parameter_provider_vtable_t {
       const iree_hal_semaphore_list_t signal_semaphore_list,
       iree_hal_buffer_t* source_buffer, iree_string_view_t target_scope,
       iree_host_size_t count, iree_io_parameter_enumerator_t enumerator);
+
+  // Optional; providers that take no advice can leave this NULL.
+  iree_status_t(IREE_API_PTR* advise)(iree_io_parameter_provider_t* provider,
+                                      iree_string_view_t scope,
+                                      iree_string_view_t key, uint64_t offset,
+                                      uint64_t length,
+                                      iree_io_parameter_advice_t advice);
 } iree_io_parameter_provider_vtable_t;
 
 struct iree_io_parameter_provider_t {
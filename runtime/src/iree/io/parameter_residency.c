@@ -0,0 +1,396 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/io/parameter_residency.h"
+
+#include "iree/base/internal/atomics.h"
+#include "iree/base/internal/synchronization.h"
+
+// Initial capacity of the entry table. Grown by powers of two as needed.
+#define IREE_IO_PARAMETER_RESIDENCY_INITIAL_CAPACITY 64
+
+typedef struct iree_io_parameter_residency_entry_t
+    iree_io_parameter_residency_entry_t;
+struct iree_io_parameter_residency_entry_t {
+  // Neighbors in the LRU list when resident.
+  iree_io_parameter_residency_entry_t* prev;
+  iree_io_parameter_residency_entry_t* next;
+  // Provider serving the parameter (retained).
+  iree_io_parameter_provider_t* provider;
+  // Scope and key of the parameter; stored immediately after the entry.
+  iree_string_view_t scope;
+  iree_string_view_t key;
+  uint64_t hash;
+  // Epoch of the last operation that used the entry.
+  uint64_t epoch;
+  // Range of the parameter that has been used while resident.
+  uint64_t offset;
+  uint64_t length;
+  bool resident;
+};
+
+struct iree_io_parameter_residency_t {
+  iree_atomic_ref_count_t ref_count;
+  iree_allocator_t host_allocator;
+  uint64_t budget;
+
+  // Guards all mutable state below.
+  iree_slim_mutex_t mutex;
+
+  // Incremented for each touch so that entries used by the current operation
+  // can be distinguished from older ones.
+  uint64_t epoch;
+  // Total length of all resident entries.
+  uint64_t resident_bytes;
+
+  // Resident entries ordered from least-recently-used (head) to
+  // most-recently-used (tail).
+  iree_io_parameter_residency_entry_t* lru_head;
+  iree_io_parameter_residency_entry_t* lru_tail;
+
+  // Open-addressed table of all entries ever used. Capacity is a power of two.
+  iree_host_size_t entry_capacity;
+  iree_host_size_t entry_count;
+  iree_io_parameter_residency_entry_t** entries;
+};
+
+IREE_API_EXPORT iree_status_t iree_io_parameter_residency_create(
+    uint64_t budget, iree_allocator_t host_allocator,
+    iree_io_parameter_residency_t** out_residency) {
+  IREE_ASSERT_ARGUMENT(out_residency);
+  *out_residency = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)budget);
+
+  iree_io_parameter_residency_t* residency = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(host_allocator, sizeof(*residency),
+                                (void**)&residency));
+  iree_atomic_ref_count_init(&residency->ref_count);
+  residency->host_allocator = host_allocator;
+  residency->budget = budget;
+  iree_slim_mutex_initialize(&residency->mutex);
+
+  *out_residency = residency;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+static void iree_io_parameter_residency_destroy(
+    iree_io_parameter_residency_t* residency) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_allocator_t host_allocator = residency->host_allocator;
+
+  for (iree_host_size_t i = 0; i < residency->entry_capacity; ++i) {
+    iree_io_parameter_residency_entry_t* entry = residency->entries[i];
+    if (!entry) continue;
+    iree_io_parameter_provider_release(entry->provider);
+    iree_allocator_free(host_allocator, entry);
+  }
+  iree_allocator_free(host_allocator, residency->entries);
+  iree_slim_mutex_deinitialize(&residency->mutex);
+  iree_allocator_free(host_allocator, residency);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+IREE_API_EXPORT void iree_io_parameter_residency_retain(
+    iree_io_parameter_residency_t* residency) {
+  if (IREE_LIKELY(residency)) {
+    iree_atomic_ref_count_inc(&residency->ref_count);
+  }
+}
+
+IREE_API_EXPORT void iree_io_parameter_residency_release(
+    iree_io_parameter_residency_t* residency) {
+  if (IREE_LIKELY(residency) &&
+      iree_atomic_ref_count_dec(&residency->ref_count) == 1) {
+    iree_io_parameter_residency_destroy(residency);
+  }
+}
+
+IREE_API_EXPORT uint64_t iree_io_parameter_residency_resident_bytes(
+    iree_io_parameter_residency_t* residency) {
+  IREE_ASSERT_ARGUMENT(residency);
+  iree_slim_mutex_lock(&residency->mutex);
+  uint64_t resident_bytes = residency->resident_bytes;
+  iree_slim_mutex_unlock(&residency->mutex);
+  return resident_bytes;
+}
+
+//===----------------------------------------------------------------------===//
+// Entry table
+//===----------------------------------------------------------------------===//
+
+static uint64_t iree_io_parameter_residency_hash_bytes(
+    uint64_t hash, const void* data, iree_host_size_t length) {
+  // FNV-1a.
+  const uint8_t* bytes = (const uint8_t*)data;
+  for (iree_host_size_t i = 0; i < length; ++i) {
+    hash ^= bytes[i];
+    hash *= 0x100000001B3ull;
+  }
+  return hash;
+}
+
+static uint64_t iree_io_parameter_residency_hash(
+    iree_io_parameter_provider_t* provider, iree_string_view_t scope,
+    iree_string_view_t key) {
+  uint64_t hash = 0xCBF29CE484222325ull;
+  hash = iree_io_parameter_residency_hash_bytes(hash, &provider,
+                                                sizeof(provider));
+  hash = iree_io_parameter_residency_hash_bytes(hash, scope.data, scope.size);
+  // Separates the scope from the key so that "ab"+"c" != "a"+"bc".
+  hash = iree_io_parameter_residency_hash_bytes(hash, &scope.size,
+                                                sizeof(scope.size));
+  return iree_io_parameter_residency_hash_bytes(hash, key.data, key.size);
+}
+
+// Returns the slot where the entry matching the given parameter is stored or
+// the empty slot where it would be inserted.
+static iree_host_size_t iree_io_parameter_residency_find_slot_unsafe(
+    iree_io_parameter_residency_t* residency, uint64_t hash,
+    iree_io_parameter_provider_t* provider, iree_string_view_t scope,
+    iree_string_view_t key) {
+  const iree_host_size_t mask = residency->entry_capacity - 1;
+  iree_host_size_t slot = (iree_host_size_t)hash & mask;
+  for (;;) {
+    iree_io_parameter_residency_entry_t* entry = residency->entries[slot];
+    if (!entry) return slot;
+    if (entry->hash == hash && entry->provider == provider &&
+        iree_string_view_equal(entry->scope, scope) &&
+        iree_string_view_equal(entry->key, key)) {
+      return slot;
+    }
+    slot = (slot + 1) & mask;
+  }
+}
+
+// Grows the entry table so that at least one more entry can be inserted while
+// keeping the load factor at or below 1/2.
+static iree_status_t iree_io_parameter_residency_reserve_unsafe(
+    iree_io_parameter_residency_t* residency) {
+  if ((residency->entry_count + 1) * 2 <= residency->entry_capacity) {
+    return iree_ok_status();
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_host_size_t new_capacity =
+      residency->entry_capacity
+          ? residency->entry_capacity * 2
+          : IREE_IO_PARAMETER_RESIDENCY_INITIAL_CAPACITY;
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, new_capacity);
+  iree_io_parameter_residency_entry_t** new_entries = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(residency->host_allocator,
+                                new_capacity * sizeof(*new_entries),
+                                (void**)&new_entries));
+
+  // Rehash all existing entries into the new table.
+  iree_io_parameter_residency_entry_t** old_entries = residency->entries;
+  iree_host_size_t old_capacity = residency->entry_capacity;
+  residency->entries = new_entries;
+  residency->entry_capacity = new_capacity;
+  for (iree_host_size_t i = 0; i < old_capacity; ++i) {
+    iree_io_parameter_residency_entry_t* entry = old_entries[i];
+    if (!entry) continue;
+    iree_host_size_t slot = iree_io_parameter_residency_find_slot_unsafe(
+        residency, entry->hash, entry->provider, entry->scope, entry->key);
+    new_entries[slot] = entry;
+  }
+  iree_allocator_free(residency->host_allocator, old_entries);
+
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+// Returns the entry for the given parameter, inserting a new non-resident
+// entry if the parameter has not been used before.
+static iree_status_t iree_io_parameter_residency_lookup_unsafe(
+    iree_io_parameter_residency_t* residency,
+    iree_io_parameter_provider_t* provider, iree_string_view_t scope,
+    iree_string_view_t key, iree_io_parameter_residency_entry_t** out_entry) {
+  IREE_RETURN_IF_ERROR(iree_io_parameter_residency_reserve_unsafe(residency));
+  const uint64_t hash = iree_io_parameter_residency_hash(provider, scope, key);
+  iree_host_size_t slot = iree_io_parameter_residency_find_slot_unsafe(
+      residency, hash, provider, scope, key);
+  iree_io_parameter_residency_entry_t* entry = residency->entries[slot];
+  if (entry) {
+    *out_entry = entry;
+    return iree_ok_status();
+  }
+
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      residency->host_allocator, sizeof(*entry) + scope.size + key.size,
+      (void**)&entry));
+  char* string_storage = (char*)entry + sizeof(*entry);
+  memcpy(string_storage, scope.data, scope.size);
+  memcpy(string_storage + scope.size, key.data, key.size);
+  entry->scope = iree_make_string_view(string_storage, scope.size);
+  entry->key = iree_make_string_view(string_storage + scope.size, key.size);
+  entry->hash = hash;
+  entry->provider = provider;
+  iree_io_parameter_provider_retain(provider);
+  residency->entries[slot] = entry;
+  ++residency->entry_count;
+  *out_entry = entry;
+  return iree_ok_status();
+}
+
+//===----------------------------------------------------------------------===//
+// LRU list
+//===----------------------------------------------------------------------===//
+
+static void iree_io_parameter_residency_unlink_unsafe(
+    iree_io_parameter_residency_t* residency,
+    iree_io_parameter_residency_entry_t* entry) {
+  if (entry->prev) {
+    entry->prev->next = entry->next;
+  } else {
+    residency->lru_head = entry->next;
+  }
+  if (entry->next) {
+    entry->next->prev = entry->prev;
+  } else {
+    residency->lru_tail = entry->prev;
+  }
+  entry->prev = NULL;
+  entry->next = NULL;
+}
+
+static void iree_io_parameter_residency_link_tail_unsafe(
+    iree_io_parameter_residency_t* residency,
+    iree_io_parameter_residency_entry_t* entry) {
+  entry->prev = residency->lru_tail;
+  entry->next = NULL;
+  if (residency->lru_tail) {
+    residency->lru_tail->next = entry;
+  } else {
+    residency->lru_head = entry;
+  }
+  residency->lru_tail = entry;
+}
+
+// Advises the provider of |entry| that it is no longer needed and removes it
+// from the resident set.
+static iree_status_t iree_io_parameter_residency_evict_unsafe(
+    iree_io_parameter_residency_t* residency,
+    iree_io_parameter_residency_entry_t* entry) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_TEXT(z0, entry->key.data, entry->key.size);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)entry->length);
+  iree_io_parameter_residency_unlink_unsafe(residency, entry);
+  entry->resident = false;
+  residency->resident_bytes -= entry->length;
+  iree_status_t status = iree_io_parameter_provider_advise(
+      entry->provider, entry->scope, entry->key, entry->offset, entry->length,
+      IREE_IO_PARAMETER_ADVICE_DONT_NEED);
+  if (iree_status_is_failed_precondition(status)) {
+    // Still referenced by live buffers (such as writable mappings imported by
+    // a load): the provider can't release it and we stop tracking it until it
+    // is next used so that only memory that can be reclaimed is budgeted.
+    IREE_TRACE_ZONE_APPEND_TEXT(z0, "referenced");
+    status = iree_status_ignore(status);
+  }
+  entry->offset = 0;
+  entry->length = 0;
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+//===----------------------------------------------------------------------===//
+// Residency management
+//===----------------------------------------------------------------------===//
+
+// Marks the range of |span| in |entry| as used by the current operation and
+// advises any newly used range as needed.
+static iree_status_t iree_io_parameter_residency_use_unsafe(
+    iree_io_parameter_residency_t* residency,
+    iree_io_parameter_residency_entry_t* entry,
+    const iree_io_parameter_span_t* span) {
+  const uint64_t span_begin = span->parameter_offset;
+  const uint64_t span_end = span->parameter_offset + span->length;
+  uint64_t begin = span_begin;
+  uint64_t end = span_end;
+  if (entry->resident) {
+    begin = iree_min(begin, entry->offset);
+    end = iree_max(end, entry->offset + entry->length);
+    iree_io_parameter_residency_unlink_unsafe(residency, entry);
+  }
+  iree_io_parameter_residency_link_tail_unsafe(residency, entry);
+  entry->epoch = residency->epoch;
+
+  // Nothing to do if the span was already resident.
+  const bool was_resident = entry->resident;
+  if (was_resident && begin == entry->offset &&
+      end - begin == entry->length) {
+    return iree_ok_status();
+  }
+  residency->resident_bytes += (end - begin) - entry->length;
+  entry->offset = begin;
+  entry->length = end - begin;
+  entry->resident = true;
+  return iree_io_parameter_provider_advise(
+      entry->provider, entry->scope, entry->key, span_begin, span->length,
+      IREE_IO_PARAMETER_ADVICE_WILL_NEED);
+}
+
+IREE_API_EXPORT iree_status_t iree_io_parameter_residency_touch(
+    iree_io_parameter_residency_t* residency,
+    iree_io_parameter_provider_t* provider, iree_string_view_t scope,
+    iree_host_size_t count, iree_io_parameter_enumerator_t enumerator) {
+  IREE_ASSERT_ARGUMENT(residency);
+  IREE_ASSERT_ARGUMENT(provider);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, count);
+
+  iree_slim_mutex_lock(&residency->mutex);
+  const uint64_t epoch = ++residency->epoch;
+
+  // Bring in all parameters used by the operation.
+  iree_status_t status = iree_ok_status();
+  for (iree_host_size_t i = 0; i < count && iree_status_is_ok(status); ++i) {
+    iree_string_view_t key = iree_string_view_empty();
+    iree_io_parameter_span_t span = {0};
+    status = enumerator.fn(enumerator.user_data, i, &key, &span);
+    iree_io_parameter_residency_entry_t* entry = NULL;
+    if (iree_status_is_ok(status)) {
+      status = iree_io_parameter_residency_lookup_unsafe(residency, provider,
+                                                         scope, key, &entry);
+    }
+    if (iree_status_is_ok(status)) {
+      status = iree_io_parameter_residency_use_unsafe(residency, entry, &span);
+    }
+  }
+
+  // Evict least-recently-used parameters until within budget. Parameters used
+  // by this operation are at the tail of the list and are never evicted here.
+  while (iree_status_is_ok(status) &&
+         residency->resident_bytes > residency->budget &&
+         residency->lru_head && residency->lru_head->epoch != epoch) {
+    status = iree_io_parameter_residency_evict_unsafe(residency,
+                                                      residency->lru_head);
+  }
+
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)residency->resident_bytes);
+  iree_slim_mutex_unlock(&residency->mutex);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+IREE_API_EXPORT iree_status_t
+iree_io_parameter_residency_trim(iree_io_parameter_residency_t* residency) {
+  IREE_ASSERT_ARGUMENT(residency);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_slim_mutex_lock(&residency->mutex);
+  iree_status_t status = iree_ok_status();
+  while (residency->lru_head) {
+    status = iree_status_join(status, iree_io_parameter_residency_evict_unsafe(
+                                          residency, residency->lru_head));
+  }
+  iree_slim_mutex_unlock(&residency->mutex);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
@@ -0,0 +1,84 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_IO_PARAMETER_RESIDENCY_H_
+#define IREE_IO_PARAMETER_RESIDENCY_H_
+
+#include <stdint.h>
+
+#include "iree/base/api.h"
+#include "iree/io/parameter_provider.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+//===----------------------------------------------------------------------===//
+// iree_io_parameter_residency_t
+//===----------------------------------------------------------------------===//
+
+// Tracks which parameters are in use and keeps the host memory backing them
+// within a fixed budget. Parameters are advised as needed as they are used and
+// the least-recently-used parameters are advised as not needed when the budget
+// is exceeded so that providers can release their memory back to the system.
+//
+// Residency is tracked per parameter as the range of bytes that has been used
+// from it. Providers decide what advice means for their storage: providers
+// serving from mapped files release the pages back to the file and fault them
+// back in when next used while providers that copy parameters into device
+// memory on each use may ignore it entirely. Advice never invalidates buffers
+// that were previously returned by providers; it only controls whether their
+// backing memory is kept resident.
+//
+// Use is only observed when parameters are loaded or gathered and not when
+// the resulting buffers are accessed by programs. Read-only mapped files
+// imported by loads are still released as the buffers fault the pages back in
+// from the file when next accessed. Parameters whose memory can't be released
+// while aliased by live buffers (such as writable mappings) have their
+// eviction refused by providers and are dropped from the resident set (and the
+// budget) until they are next used.
+//
+// Thread-safe: multiple threads can use the residency tracker concurrently.
+typedef struct iree_io_parameter_residency_t iree_io_parameter_residency_t;
+
+// Creates a residency tracker limiting the bytes of parameters considered
+// resident at any time to |budget|. Parameters used in a single operation are
+// never evicted by that operation even if they exceed the budget on their own.
+IREE_API_EXPORT iree_status_t iree_io_parameter_residency_create(
+    uint64_t budget, iree_allocator_t host_allocator,
+    iree_io_parameter_residency_t** out_residency);
+
+// Retains the given |residency| for the caller.
+IREE_API_EXPORT void iree_io_parameter_residency_retain(
+    iree_io_parameter_residency_t* residency);
+
+// Releases the given |residency| from the caller.
+IREE_API_EXPORT void iree_io_parameter_residency_release(
+    iree_io_parameter_residency_t* residency);
+
+// Returns the total bytes of parameters currently considered resident.
+IREE_API_EXPORT uint64_t iree_io_parameter_residency_resident_bytes(
+    iree_io_parameter_residency_t* residency);
+
+// Records that the |count| parameter spans produced by |enumerator| from
+// |scope| in |provider| are about to be used. Parameters that are not yet
+// resident are advised as needed and least-recently-used parameters not part
+// of this operation are then advised as not needed until the budget is met.
+IREE_API_EXPORT iree_status_t iree_io_parameter_residency_touch(
+    iree_io_parameter_residency_t* residency,
+    iree_io_parameter_provider_t* provider, iree_string_view_t scope,
+    iree_host_size_t count, iree_io_parameter_enumerator_t enumerator);
+
+// Advises all resident parameters as not needed and marks them non-resident.
+// Used when the system is low on memory or the program is suspending.
+IREE_API_EXPORT iree_status_t
+iree_io_parameter_residency_trim(iree_io_parameter_residency_t* residency);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_IO_PARAMETER_RESIDENCY_H_
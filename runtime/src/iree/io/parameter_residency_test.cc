@@ -0,0 +1,203 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/io/parameter_residency.h"
+
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/base/internal/atomics.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace {
+
+using Advice = std::pair<std::string, iree_io_parameter_advice_t>;
+
+// Provider that records all advice it is given.
+struct RecordingProvider {
+  iree_io_parameter_provider_t base;
+  std::vector<Advice> advice;
+  // Keys that refuse to be released as if aliased by live buffers.
+  std::set<std::string> referenced_keys;
+
+  static void Destroy(iree_io_parameter_provider_t* provider) {}
+  static iree_status_t Notify(iree_io_parameter_provider_t* provider,
+                              iree_io_parameter_provider_signal_t signal) {
+    return iree_ok_status();
+  }
+  static bool QuerySupport(iree_io_parameter_provider_t* provider,
+                           iree_string_view_t scope) {
+    return true;
+  }
+  static iree_status_t Advise(iree_io_parameter_provider_t* provider,
+                              iree_string_view_t scope, iree_string_view_t key,
+                              uint64_t offset, uint64_t length,
+                              iree_io_parameter_advice_t advice) {
+    RecordingProvider* self = reinterpret_cast<RecordingProvider*>(provider);
+    std::string key_str(key.data, key.size);
+    self->advice.emplace_back(key_str, advice);
+    if (advice == IREE_IO_PARAMETER_ADVICE_DONT_NEED &&
+        self->referenced_keys.count(key_str)) {
+      return iree_status_from_code(IREE_STATUS_FAILED_PRECONDITION);
+    }
+    return iree_ok_status();
+  }
+
+  RecordingProvider() {
+    static const iree_io_parameter_provider_vtable_t vtable = {
+        /*.destroy=*/Destroy,
+        /*.notify=*/Notify,
+        /*.query_support=*/QuerySupport,
+        /*.load=*/NULL,
+        /*.gather=*/NULL,
+        /*.scatter=*/NULL,
+        /*.advise=*/Advise,
+    };
+    iree_atomic_ref_count_init(&base.ref_count);
+    base.vtable = &vtable;
+  }
+
+  std::vector<Advice> TakeAdvice() { return std::exchange(advice, {}); }
+};
+
+struct Span {
+  const char* key;
+  uint64_t offset;
+  uint64_t length;
+};
+
+static iree_status_t SpanEnumerator(void* user_data, iree_host_size_t i,
+                                    iree_string_view_t* out_key,
+                                    iree_io_parameter_span_t* out_span) {
+  const Span& span = static_cast<const std::vector<Span>*>(user_data)->at(i);
+  *out_key = iree_make_cstring_view(span.key);
+  out_span->parameter_offset = span.offset;
+  out_span->buffer_offset = 0;
+  out_span->length = span.length;
+  return iree_ok_status();
+}
+
+class ParameterResidencyTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    IREE_ASSERT_OK(iree_io_parameter_residency_create(
+        /*budget=*/1000, iree_allocator_system(), &residency_));
+  }
+  void TearDown() override { iree_io_parameter_residency_release(residency_); }
+
+  iree_status_t Touch(std::vector<Span> spans) {
+    iree_io_parameter_enumerator_t enumerator = {SpanEnumerator, &spans};
+    return iree_io_parameter_residency_touch(residency_, &provider_.base,
+                                             IREE_SV("scope"), spans.size(),
+                                             enumerator);
+  }
+
+  RecordingProvider provider_;
+  iree_io_parameter_residency_t* residency_ = NULL;
+};
+
+static Advice WillNeed(const char* key) {
+  return {key, IREE_IO_PARAMETER_ADVICE_WILL_NEED};
+}
+static Advice DontNeed(const char* key) {
+  return {key, IREE_IO_PARAMETER_ADVICE_DONT_NEED};
+}
+
+TEST_F(ParameterResidencyTest, WithinBudget) {
+  IREE_ASSERT_OK(Touch({{"a", 0, 400}, {"b", 0, 400}}));
+  EXPECT_EQ(provider_.TakeAdvice(),
+            (std::vector<Advice>{WillNeed("a"), WillNeed("b")}));
+  EXPECT_EQ(iree_io_parameter_residency_resident_bytes(residency_), 800);
+
+  // Reusing resident parameters has no effect.
+  IREE_ASSERT_OK(Touch({{"a", 100, 100}}));
+  EXPECT_TRUE(provider_.TakeAdvice().empty());
+  EXPECT_EQ(iree_io_parameter_residency_resident_bytes(residency_), 800);
+}
+
+TEST_F(ParameterResidencyTest, EvictsLeastRecentlyUsed) {
+  IREE_ASSERT_OK(Touch({{"a", 0, 400}}));
+  IREE_ASSERT_OK(Touch({{"b", 0, 400}}));
+  IREE_ASSERT_OK(Touch({{"a", 0, 400}}));
+  provider_.TakeAdvice();
+
+  // b is the least recently used and is evicted to make room for c.
+  IREE_ASSERT_OK(Touch({{"c", 0, 400}}));
+  EXPECT_EQ(provider_.TakeAdvice(),
+            (std::vector<Advice>{WillNeed("c"), DontNeed("b")}));
+  EXPECT_EQ(iree_io_parameter_residency_resident_bytes(residency_), 800);
+
+  // b is brought back in when next used.
+  IREE_ASSERT_OK(Touch({{"b", 0, 400}}));
+  EXPECT_EQ(provider_.TakeAdvice(),
+            (std::vector<Advice>{WillNeed("b"), DontNeed("a")}));
+}
+
+TEST_F(ParameterResidencyTest, GrowsUsedRange) {
+  IREE_ASSERT_OK(Touch({{"a", 0, 100}}));
+  IREE_ASSERT_OK(Touch({{"a", 500, 100}}));
+  EXPECT_EQ(provider_.TakeAdvice(),
+            (std::vector<Advice>{WillNeed("a"), WillNeed("a")}));
+  EXPECT_EQ(iree_io_parameter_residency_resident_bytes(residency_), 600);
+}
+
+TEST_F(ParameterResidencyTest, NeverEvictsCurrentOperation) {
+  // The operation alone exceeds the budget but all of its parameters are kept.
+  IREE_ASSERT_OK(Touch({{"a", 0, 200}}));
+  IREE_ASSERT_OK(Touch({{"b", 0, 800}, {"c", 0, 800}}));
+  EXPECT_EQ(provider_.TakeAdvice(),
+            (std::vector<Advice>{WillNeed("a"), WillNeed("b"), WillNeed("c"),
+                                 DontNeed("a")}));
+  EXPECT_EQ(iree_io_parameter_residency_resident_bytes(residency_), 1600);
+}
+
+TEST_F(ParameterResidencyTest, SkipsReferencedParameters) {
+  // a is aliased by live buffers and can't be released: it is dropped from the
+  // resident set and b is evicted as well to get back within budget.
+  provider_.referenced_keys.insert("a");
+  IREE_ASSERT_OK(Touch({{"a", 0, 400}}));
+  IREE_ASSERT_OK(Touch({{"b", 0, 400}}));
+  provider_.TakeAdvice();
+  IREE_ASSERT_OK(Touch({{"c", 0, 800}}));
+  EXPECT_EQ(provider_.TakeAdvice(),
+            (std::vector<Advice>{WillNeed("c"), DontNeed("a"),
+                                 DontNeed("b")}));
+  EXPECT_EQ(iree_io_parameter_residency_resident_bytes(residency_), 800);
+
+  // Once released a is tracked again when next used.
+  provider_.referenced_keys.clear();
+  IREE_ASSERT_OK(Touch({{"a", 0, 400}}));
+  EXPECT_EQ(provider_.TakeAdvice(),
+            (std::vector<Advice>{WillNeed("a"), DontNeed("c")}));
+  EXPECT_EQ(iree_io_parameter_residency_resident_bytes(residency_), 400);
+}
+
+TEST_F(ParameterResidencyTest, Trim) {
+  IREE_ASSERT_OK(Touch({{"a", 0, 100}, {"b", 0, 100}}));
+  provider_.TakeAdvice();
+  IREE_ASSERT_OK(iree_io_parameter_residency_trim(residency_));
+  EXPECT_EQ(provider_.TakeAdvice(),
+            (std::vector<Advice>{DontNeed("a"), DontNeed("b")}));
+  EXPECT_EQ(iree_io_parameter_residency_resident_bytes(residency_), 0);
+}
+
+TEST_F(ParameterResidencyTest, ManyParameters) {
+  // Exercises growth of the entry table.
+  std::vector<std::string> keys;
+  for (int i = 0; i < 1000; ++i) keys.push_back("p" + std::to_string(i));
+  for (int round = 0; round < 2; ++round) {
+    for (const std::string& key : keys) {
+      IREE_ASSERT_OK(Touch({{key.c_str(), 0, 10}}));
+    }
+  }
+  EXPECT_EQ(iree_io_parameter_residency_resident_bytes(residency_), 1000);
+}
+
+}  // namespace
@@ -6,6 +6,7 @@
 
 #include "iree/modules/io/parameters/module.h"
 
+#include "iree/io/parameter_residency.h"
 #include "iree/modules/hal/types.h"
 
 #define IREE_IO_PARAMETERS_MODULE_VERSION_0_0 0x00000000u
@@ -18,6 +19,8 @@
 
 typedef struct iree_io_parameters_module_t {
   iree_allocator_t host_allocator;
+  // Tracks parameters used across all providers; NULL if unlimited.
+  iree_io_parameter_residency_t* residency;
   iree_host_size_t provider_count;
   iree_io_parameter_provider_t* providers[];
 } iree_io_parameters_module_t;
@@ -33,6 +36,8 @@ typedef struct iree_io_parameters_module_state_t {
 static void IREE_API_PTR iree_io_parameters_module_destroy(void* base_module) {
   iree_io_parameters_module_t* module =
       IREE_IO_PARAMETERS_MODULE_CAST(base_module);
+  iree_io_parameter_residency_release(module->residency);
+  module->residency = NULL;
   for (iree_host_size_t i = 0; i < module->provider_count; ++i) {
     iree_io_parameter_provider_release(module->providers[i]);
   }
@@ -90,6 +95,14 @@ static iree_status_t IREE_API_PTR iree_io_parameters_module_notify(
       IREE_TRACE_ZONE_END(z0);
       return iree_ok_status();
   }
+  // Resident parameters are released before the providers are notified so
+  // that they can reclaim the memory.
+  if (module->residency &&
+      (provider_signal == IREE_IO_PARAMETER_PROVIDER_SIGNAL_SUSPEND ||
+       provider_signal == IREE_IO_PARAMETER_PROVIDER_SIGNAL_LOW_MEMORY)) {
+    IREE_RETURN_AND_END_ZONE_IF_ERROR(
+        z0, iree_io_parameter_residency_trim(module->residency));
+  }
   for (iree_host_size_t i = 0; i < module->provider_count; ++i) {
     IREE_RETURN_AND_END_ZONE_IF_ERROR(
         z0, iree_io_parameter_provider_notify(module->providers[i],
@@ -243,6 +256,21 @@ static iree_status_t iree_io_parameters_indirect_enumerator(
   return iree_ok_status();
 }
 
+// Records the use of the enumerated parameters with the module residency
+// tracker (if any) so that they are brought in ahead of the operation and
+// others are evicted to stay within budget. Loads and gathers are the only
+// uses the module observes: parameters imported as buffers by loads are used
+// by programs directly and evicting them only releases pages that the buffers
+// fault back in from the file when next accessed.
+static iree_status_t iree_io_parameters_module_touch(
+    iree_io_parameters_module_t* module, iree_io_parameter_provider_t* provider,
+    iree_string_view_t scope, iree_host_size_t count,
+    iree_io_parameter_enumerator_t enumerator) {
+  if (!module->residency) return iree_ok_status();
+  return iree_io_parameter_residency_touch(module->residency, provider, scope,
+                                           count, enumerator);
+}
+
 static iree_status_t iree_io_parameters_vm_list_emitter(
     void* user_data, iree_host_size_t i, iree_hal_buffer_t* buffer) {
   iree_vm_list_t* list = (iree_vm_list_t*)user_data;
@@ -289,6 +317,10 @@ IREE_VM_ABI_EXPORT(iree_io_parameters_module_load,     //
       .fn = iree_io_parameters_indirect_enumerator,
       .user_data = &enumerator_args,
   };
+  IREE_RETURN_IF_ERROR(iree_io_parameters_module_touch(
+      IREE_IO_PARAMETERS_MODULE_CAST(module), provider,
+      iree_vm_buffer_as_string(source_scope), enumerator_args.count,
+      enumerator));
 
   iree_vm_list_t* target_buffers = NULL;
   IREE_RETURN_IF_ERROR(iree_vm_list_create(
@@ -356,6 +388,10 @@ IREE_VM_ABI_EXPORT(iree_io_parameters_module_gather,   //
       .fn = iree_io_parameters_indirect_enumerator,
       .user_data = &enumerator_args,
   };
+  IREE_RETURN_IF_ERROR(iree_io_parameters_module_touch(
+      IREE_IO_PARAMETERS_MODULE_CAST(module), provider,
+      iree_vm_buffer_as_string(source_scope), enumerator_args.count,
+      enumerator));
   return iree_io_parameter_provider_gather(
       provider, device, queue_affinity,
       iree_hal_fence_semaphore_list(wait_fence),
@@ -464,7 +500,20 @@ IREE_API_EXPORT iree_status_t iree_io_parameters_module_create(
     iree_vm_instance_t* instance, iree_host_size_t provider_count,
     iree_io_parameter_provider_t* const* providers,
     iree_allocator_t host_allocator, iree_vm_module_t** out_module) {
+  iree_io_parameters_module_options_t options;
+  memset(&options, 0, sizeof(options));
+  return iree_io_parameters_module_create_with_options(
+      instance, provider_count, providers, &options, host_allocator,
+      out_module);
+}
+
+IREE_API_EXPORT iree_status_t iree_io_parameters_module_create_with_options(
+    iree_vm_instance_t* instance, iree_host_size_t provider_count,
+    iree_io_parameter_provider_t* const* providers,
+    const iree_io_parameters_module_options_t* options,
+    iree_allocator_t host_allocator, iree_vm_module_t** out_module) {
   IREE_ASSERT_ARGUMENT(instance);
+  IREE_ASSERT_ARGUMENT(options);
   IREE_ASSERT_ARGUMENT(!provider_count || providers);
   IREE_ASSERT_ARGUMENT(out_module);
   *out_module = NULL;
@@ -503,6 +552,15 @@ IREE_API_EXPORT iree_status_t iree_io_parameters_module_create(
     iree_io_parameter_provider_retain(providers[i]);
   }
 
-  *out_module = base_module;
-  return iree_ok_status();
+  if (options->residency_budget) {
+    status = iree_io_parameter_residency_create(
+        options->residency_budget, host_allocator, &module->residency);
+  }
+
+  if (iree_status_is_ok(status)) {
+    *out_module = base_module;
+  } else {
+    iree_vm_module_release(base_module);
+  }
+  return status;
 }
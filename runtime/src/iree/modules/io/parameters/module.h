@@ -24,6 +24,25 @@ IREE_API_EXPORT iree_status_t iree_io_parameters_module_create(
     iree_allocator_t host_allocator,
     iree_vm_module_t** IREE_RESTRICT out_module);
 
+// Options controlling parameters module behavior.
+typedef struct iree_io_parameters_module_options_t {
+  // Maximum number of bytes of parameters kept resident in host memory by
+  // providers. When exceeded the least-recently-used parameters are advised as
+  // no longer needed so that providers can release their memory (such as by
+  // dropping mapped file pages) and they are brought back in on next use.
+  // 0 disables residency management.
+  uint64_t residency_budget;
+} iree_io_parameters_module_options_t;
+
+// Creates a module for accessing parameters via a set of |providers| as with
+// iree_io_parameters_module_create using the provided |options|.
+IREE_API_EXPORT iree_status_t iree_io_parameters_module_create_with_options(
+    iree_vm_instance_t* instance, iree_host_size_t provider_count,
+    iree_io_parameter_provider_t* const* providers,
+    const iree_io_parameters_module_options_t* options,
+    iree_allocator_t host_allocator,
+    iree_vm_module_t** IREE_RESTRICT out_module);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -6,6 +6,8 @@
 
 #include "iree/modules/vmvx/elementwise.h"
 
+#include "iree/schemas/cpu_data.h"
+
 // TODO: We should only be including/using this in standalone builds. In others,
 // we have to emulate or use other mechanisms. Since this file only contains
 // fallback implementations, we don't care about the quality *that* much but
@@ -274,3 +276,35 @@ DISPATCH_UKERNEL_UNARY_2D(floorf, IREE_UK_X32U_FLOORF, iree_uk_uint32_t, x32u);
 DISPATCH_UKERNEL_UNARY_2D(logf, IREE_UK_X32U_LOGF, iree_uk_uint32_t, x32u);
 DISPATCH_UKERNEL_UNARY_2D(negf, IREE_UK_X32U_NEGF, iree_uk_uint32_t, x32u);
 DISPATCH_UKERNEL_UNARY_2D(rsqrtf, IREE_UK_X32U_RSQRTF, iree_uk_uint32_t, x32u);
+
+//===----------------------------------------------------------------------===//
+// CPU-specialized kernel selection.
+//===----------------------------------------------------------------------===//
+
+iree_uk_x32b_2d_func_t iree_uk_x32b_2d_select(
+    iree_uk_x32b_2d_func_t generic_func, const iree_uk_uint64_t* cpu_data) {
+  iree_uk_x32b_2d_func_t specialized_func = 0;
+#if defined(IREE_ARCH_ARM_64)
+  specialized_func = iree_uk_x32b_2d_select_arm_64(generic_func);
+#elif defined(IREE_VMVX_BUILD_X86_64_AVX2_FMA)
+  if (iree_uk_all_bits_set(cpu_data[0], IREE_CPU_DATA0_X86_64_AVX2 |
+                                            IREE_CPU_DATA0_X86_64_FMA)) {
+    specialized_func = iree_uk_x32b_2d_select_x86_64_avx2_fma(generic_func);
+  }
+#endif  // defined(IREE_VMVX_BUILD_X86_64_AVX2_FMA)
+  return specialized_func ? specialized_func : generic_func;
+}
+
+iree_uk_x32u_2d_func_t iree_uk_x32u_2d_select(
+    iree_uk_x32u_2d_func_t generic_func, const iree_uk_uint64_t* cpu_data) {
+  iree_uk_x32u_2d_func_t specialized_func = 0;
+#if defined(IREE_ARCH_ARM_64)
+  specialized_func = iree_uk_x32u_2d_select_arm_64(generic_func);
+#elif defined(IREE_VMVX_BUILD_X86_64_AVX2_FMA)
+  if (iree_uk_all_bits_set(cpu_data[0], IREE_CPU_DATA0_X86_64_AVX2 |
+                                            IREE_CPU_DATA0_X86_64_FMA)) {
+    specialized_func = iree_uk_x32u_2d_select_x86_64_avx2_fma(generic_func);
+  }
+#endif  // defined(IREE_VMVX_BUILD_X86_64_AVX2_FMA)
+  return specialized_func ? specialized_func : generic_func;
+}
@@ -93,6 +93,34 @@ DECLARE_UKERNEL_UNARY_2D(logf, iree_uk_uint32_t, x32u);
 DECLARE_UKERNEL_UNARY_2D(negf, iree_uk_uint32_t, x32u);
 DECLARE_UKERNEL_UNARY_2D(rsqrtf, iree_uk_uint32_t, x32u);
 
+//===----------------------------------------------------------------------===//
+// CPU-specialized kernels.
+//===----------------------------------------------------------------------===//
+
+// Returns a variant of |generic_func|, one of the iree_uk_x32b_*_2d functions
+// declared above, specialized for the CPU features in |cpu_data|, or
+// |generic_func| itself if there is none. Specialized variants accept the same
+// arguments and produce bit-identical results, falling back to |generic_func|
+// for layouts they don't handle. Meant to be called once, at module creation.
+iree_uk_x32b_2d_func_t iree_uk_x32b_2d_select(
+    iree_uk_x32b_2d_func_t generic_func, const iree_uk_uint64_t* cpu_data);
+
+// Same as iree_uk_x32b_2d_select, for iree_uk_x32u_*_2d functions.
+iree_uk_x32u_2d_func_t iree_uk_x32u_2d_select(
+    iree_uk_x32u_2d_func_t generic_func, const iree_uk_uint64_t* cpu_data);
+
+// Architecture-specific parts of the above, returning 0 when there is no
+// specialization of |generic_func|. Each is only defined when the
+// corresponding source file is built, see elementwise.c.
+iree_uk_x32b_2d_func_t iree_uk_x32b_2d_select_arm_64(
+    iree_uk_x32b_2d_func_t generic_func);
+iree_uk_x32u_2d_func_t iree_uk_x32u_2d_select_arm_64(
+    iree_uk_x32u_2d_func_t generic_func);
+iree_uk_x32b_2d_func_t iree_uk_x32b_2d_select_x86_64_avx2_fma(
+    iree_uk_x32b_2d_func_t generic_func);
+iree_uk_x32u_2d_func_t iree_uk_x32u_2d_select_x86_64_avx2_fma(
+    iree_uk_x32u_2d_func_t generic_func);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -0,0 +1,230 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/modules/vmvx/elementwise.h"
+
+// NEON is part of the baseline Arm 64-bit ISA, so this file is always built and
+// only needs to compile to nothing on other architectures.
+#if defined(IREE_ARCH_ARM_64)
+
+#include <arm_neon.h>
+
+//===----------------------------------------------------------------------===//
+// Vector ops on 4 x 32-bit lanes.
+//===----------------------------------------------------------------------===//
+
+// All ops take and return uint32x4_t so that a single row loop serves all
+// types.
+#define IREE_UK_NEON_F32_BINARY_OP(name, intrinsic)                          \
+  static inline uint32x4_t iree_uk_neon_##name(uint32x4_t a, uint32x4_t b) { \
+    return vreinterpretq_u32_f32(                                            \
+        intrinsic(vreinterpretq_f32_u32(a), vreinterpretq_f32_u32(b)));      \
+  }
+
+#define IREE_UK_NEON_F32_UNARY_OP(name, intrinsic)                     \
+  static inline uint32x4_t iree_uk_neon_##name(uint32x4_t a) {         \
+    return vreinterpretq_u32_f32(intrinsic(vreinterpretq_f32_u32(a))); \
+  }
+
+IREE_UK_NEON_F32_BINARY_OP(addf, vaddq_f32)
+IREE_UK_NEON_F32_BINARY_OP(divf, vdivq_f32)
+IREE_UK_NEON_F32_BINARY_OP(mulf, vmulq_f32)
+IREE_UK_NEON_F32_BINARY_OP(subf, vsubq_f32)
+
+static inline uint32x4_t iree_uk_neon_addi(uint32x4_t a, uint32x4_t b) {
+  return vaddq_u32(a, b);
+}
+static inline uint32x4_t iree_uk_neon_andi(uint32x4_t a, uint32x4_t b) {
+  return vandq_u32(a, b);
+}
+static inline uint32x4_t iree_uk_neon_muli(uint32x4_t a, uint32x4_t b) {
+  return vmulq_u32(a, b);
+}
+static inline uint32x4_t iree_uk_neon_ori(uint32x4_t a, uint32x4_t b) {
+  return vorrq_u32(a, b);
+}
+static inline uint32x4_t iree_uk_neon_subi(uint32x4_t a, uint32x4_t b) {
+  return vsubq_u32(a, b);
+}
+static inline uint32x4_t iree_uk_neon_xori(uint32x4_t a, uint32x4_t b) {
+  return veorq_u32(a, b);
+}
+
+IREE_UK_NEON_F32_UNARY_OP(absf, vabsq_f32)
+IREE_UK_NEON_F32_UNARY_OP(ceilf, vrndpq_f32)
+IREE_UK_NEON_F32_UNARY_OP(floorf, vrndmq_f32)
+IREE_UK_NEON_F32_UNARY_OP(negf, vnegq_f32)
+
+// Not vrsqrteq_f32, which is only an 8-bit approximation.
+static inline uint32x4_t iree_uk_neon_rsqrtf(uint32x4_t a) {
+  return vreinterpretq_u32_f32(
+      vdivq_f32(vdupq_n_f32(1.0f), vsqrtq_f32(vreinterpretq_f32_u32(a))));
+}
+
+//===----------------------------------------------------------------------===//
+// Row loops.
+//===----------------------------------------------------------------------===//
+
+// Loads 4 lanes from |ptr| if |stride| is 1, or broadcasts *ptr if it is 0.
+static inline uint32x4_t iree_uk_neon_load(const iree_uk_uint32_t* ptr,
+                                           iree_uk_index_t stride) {
+  return stride ? vld1q_u32(ptr) : vdupq_n_u32(*ptr);
+}
+
+// Copies the last |count| < 4 elements of a row into a full vector, so that
+// tails go through the same vector op as the rest of the row.
+static inline uint32x4_t iree_uk_neon_load_tail(const iree_uk_uint32_t* ptr,
+                                                iree_uk_index_t stride,
+                                                iree_uk_index_t count) {
+  if (!stride) return vdupq_n_u32(*ptr);
+  iree_uk_uint32_t buf[4] = {0};
+  for (iree_uk_index_t j = 0; j < count; ++j) buf[j] = ptr[j];
+  return vld1q_u32(buf);
+}
+
+static inline void iree_uk_neon_store_tail(iree_uk_uint32_t* ptr,
+                                           uint32x4_t v,
+                                           iree_uk_index_t count) {
+  iree_uk_uint32_t buf[4];
+  vst1q_u32(buf, v);
+  for (iree_uk_index_t j = 0; j < count; ++j) ptr[j] = buf[j];
+}
+
+static IREE_UK_ATTRIBUTE_ALWAYS_INLINE inline void iree_uk_x32b_row_neon(
+    uint32x4_t (*op)(uint32x4_t, uint32x4_t), const iree_uk_uint32_t* lhs,
+    iree_uk_index_t lhs_stride1, const iree_uk_uint32_t* rhs,
+    iree_uk_index_t rhs_stride1, iree_uk_uint32_t* out, iree_uk_index_t size) {
+  iree_uk_index_t j = 0;
+  for (; j + 4 <= size; j += 4) {
+    uint32x4_t a = iree_uk_neon_load(lhs + j * lhs_stride1, lhs_stride1);
+    uint32x4_t b = iree_uk_neon_load(rhs + j * rhs_stride1, rhs_stride1);
+    vst1q_u32(out + j, op(a, b));
+  }
+  if (j < size) {
+    uint32x4_t a =
+        iree_uk_neon_load_tail(lhs + j * lhs_stride1, lhs_stride1, size - j);
+    uint32x4_t b =
+        iree_uk_neon_load_tail(rhs + j * rhs_stride1, rhs_stride1, size - j);
+    iree_uk_neon_store_tail(out + j, op(a, b), size - j);
+  }
+}
+
+static IREE_UK_ATTRIBUTE_ALWAYS_INLINE inline void iree_uk_x32u_row_neon(
+    uint32x4_t (*op)(uint32x4_t), const iree_uk_uint32_t* in,
+    iree_uk_index_t in_stride1, iree_uk_uint32_t* out, iree_uk_index_t size) {
+  iree_uk_index_t j = 0;
+  for (; j + 4 <= size; j += 4) {
+    uint32x4_t a = iree_uk_neon_load(in + j * in_stride1, in_stride1);
+    vst1q_u32(out + j, op(a));
+  }
+  if (j < size) {
+    uint32x4_t a =
+        iree_uk_neon_load_tail(in + j * in_stride1, in_stride1, size - j);
+    iree_uk_neon_store_tail(out + j, op(a), size - j);
+  }
+}
+
+//===----------------------------------------------------------------------===//
+// 2D kernels.
+//===----------------------------------------------------------------------===//
+
+// Rows are vectorized when the output is contiguous and each input is either
+// contiguous or broadcast along the row (stride1 of 0). Other layouts go to the
+// generic kernel.
+#define IREE_UK_X32B_2D_ARM_64(opcode)                                       \
+  static int iree_uk_x32b_##opcode##_2d_arm_64(                              \
+      const iree_uk_uint32_t* lhs, iree_uk_index_t lhs_offset,               \
+      iree_uk_index_t lhs_stride0, iree_uk_index_t lhs_stride1,              \
+      const iree_uk_uint32_t* rhs, iree_uk_index_t rhs_offset,               \
+      iree_uk_index_t rhs_stride0, iree_uk_index_t rhs_stride1,              \
+      iree_uk_uint32_t* IREE_UK_RESTRICT out, iree_uk_index_t out_offset,    \
+      iree_uk_index_t out_stride0, iree_uk_index_t out_stride1,              \
+      iree_uk_index_t size0, iree_uk_index_t size1) {                        \
+    if (out_stride1 != 1 || (lhs_stride1 != 0 && lhs_stride1 != 1) ||        \
+        (rhs_stride1 != 0 && rhs_stride1 != 1)) {                            \
+      return iree_uk_x32b_##opcode##_2d(                                     \
+          lhs, lhs_offset, lhs_stride0, lhs_stride1, rhs, rhs_offset,        \
+          rhs_stride0, rhs_stride1, out, out_offset, out_stride0,            \
+          out_stride1, size0, size1);                                        \
+    }                                                                        \
+    for (iree_uk_index_t i = 0; i < size0; ++i) {                            \
+      iree_uk_x32b_row_neon(iree_uk_neon_##opcode, lhs + i * lhs_stride0,    \
+                            lhs_stride1, rhs + i * rhs_stride0, rhs_stride1, \
+                            out + i * out_stride0, size1);                   \
+    }                                                                        \
+    return 0;                                                                \
+  }
+
+#define IREE_UK_X32U_2D_ARM_64(opcode)                                         \
+  static int iree_uk_x32u_##opcode##_2d_arm_64(                                \
+      const iree_uk_uint32_t* in, iree_uk_index_t in_offset,                   \
+      iree_uk_index_t in_stride0, iree_uk_index_t in_stride1,                  \
+      iree_uk_uint32_t* IREE_UK_RESTRICT out, iree_uk_index_t out_offset,      \
+      iree_uk_index_t out_stride0, iree_uk_index_t out_stride1,                \
+      iree_uk_index_t size0, iree_uk_index_t size1) {                          \
+    if (out_stride1 != 1 || (in_stride1 != 0 && in_stride1 != 1)) {           \
+      return iree_uk_x32u_##opcode##_2d(in, in_offset, in_stride0, in_stride1, \
+                                        out, out_offset, out_stride0,          \
+                                        out_stride1, size0, size1);            \
+    }                                                                          \
+    for (iree_uk_index_t i = 0; i < size0; ++i) {                              \
+      iree_uk_x32u_row_neon(iree_uk_neon_##opcode, in + i * in_stride0,        \
+                            in_stride1, out + i * out_stride0, size1);         \
+    }                                                                          \
+    return 0;                                                                  \
+  }
+
+IREE_UK_X32B_2D_ARM_64(addf)
+IREE_UK_X32B_2D_ARM_64(addi)
+IREE_UK_X32B_2D_ARM_64(andi)
+IREE_UK_X32B_2D_ARM_64(divf)
+IREE_UK_X32B_2D_ARM_64(mulf)
+IREE_UK_X32B_2D_ARM_64(muli)
+IREE_UK_X32B_2D_ARM_64(ori)
+IREE_UK_X32B_2D_ARM_64(subf)
+IREE_UK_X32B_2D_ARM_64(subi)
+IREE_UK_X32B_2D_ARM_64(xori)
+
+IREE_UK_X32U_2D_ARM_64(absf)
+IREE_UK_X32U_2D_ARM_64(ceilf)
+IREE_UK_X32U_2D_ARM_64(floorf)
+IREE_UK_X32U_2D_ARM_64(negf)
+IREE_UK_X32U_2D_ARM_64(rsqrtf)
+
+//===----------------------------------------------------------------------===//
+// Selection.
+//===----------------------------------------------------------------------===//
+
+#define IREE_UK_SELECT_ARM_64(category, opcode)           \
+  if (generic_func == iree_uk_##category##_##opcode##_2d) \
+    return iree_uk_##category##_##opcode##_2d_arm_64;
+
+iree_uk_x32b_2d_func_t iree_uk_x32b_2d_select_arm_64(
+    iree_uk_x32b_2d_func_t generic_func) {
+  IREE_UK_SELECT_ARM_64(x32b, addf)
+  IREE_UK_SELECT_ARM_64(x32b, addi)
+  IREE_UK_SELECT_ARM_64(x32b, andi)
+  IREE_UK_SELECT_ARM_64(x32b, divf)
+  IREE_UK_SELECT_ARM_64(x32b, mulf)
+  IREE_UK_SELECT_ARM_64(x32b, muli)
+  IREE_UK_SELECT_ARM_64(x32b, ori)
+  IREE_UK_SELECT_ARM_64(x32b, subf)
+  IREE_UK_SELECT_ARM_64(x32b, subi)
+  IREE_UK_SELECT_ARM_64(x32b, xori)
+  return 0;
+}
+
+iree_uk_x32u_2d_func_t iree_uk_x32u_2d_select_arm_64(
+    iree_uk_x32u_2d_func_t generic_func) {
+  IREE_UK_SELECT_ARM_64(x32u, absf)
+  IREE_UK_SELECT_ARM_64(x32u, ceilf)
+  IREE_UK_SELECT_ARM_64(x32u, floorf)
+  IREE_UK_SELECT_ARM_64(x32u, negf)
+  IREE_UK_SELECT_ARM_64(x32u, rsqrtf)
+  return 0;
+}
+
+#endif  // defined(IREE_ARCH_ARM_64)
@@ -0,0 +1,305 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// Checks that the SIMD variants returned by iree_uk_x32{b,u}_2d_select produce
+// bit-identical results to the generic kernels, including on the layouts that
+// the SIMD variants only partly vectorize (odd sizes needing tails, broadcast
+// operands with stride 0) or fall back on (non-unit inner strides).
+
+#include "iree/base/api.h"
+#include "iree/builtins/ukernel/api.h"
+#include "iree/builtins/ukernel/tools/test.h"
+#include "iree/builtins/ukernel/tools/util.h"
+#include "iree/modules/vmvx/elementwise.h"
+
+// Value written to every output element that the kernels must not touch.
+#define IREE_VMVX_TEST_GUARD 0xDEADBEEFu
+
+// Guard elements past the end of output buffers to catch tails writing out of
+// bounds. At least one full vector of the widest SIMD variant.
+#define IREE_VMVX_TEST_OUT_PADDING 8
+
+// Row stride resolved to size1 when a case is run, for densely packed rows.
+#define IREE_VMVX_TEST_DENSE (-1)
+
+// A 2D operand layout. Strides are in elements and may be 0 to broadcast.
+typedef struct iree_vmvx_test_layout_t {
+  iree_uk_index_t offset;
+  iree_uk_index_t stride0;
+  iree_uk_index_t stride1;
+} iree_vmvx_test_layout_t;
+
+// Layouts of the operands of a single test case. The lhs layout is also used
+// for the single input of the unary ops.
+typedef struct iree_vmvx_test_case_t {
+  const char* name;
+  iree_vmvx_test_layout_t lhs;
+  iree_vmvx_test_layout_t rhs;
+  iree_vmvx_test_layout_t out;
+} iree_vmvx_test_case_t;
+
+// Fixed row strides are at least as large as the largest size1 tested so that
+// output rows never overlap. size0 is capped by the column_major case.
+static const iree_vmvx_test_case_t iree_vmvx_test_cases[] = {
+    {"contiguous",
+     {0, IREE_VMVX_TEST_DENSE, 1},
+     {0, IREE_VMVX_TEST_DENSE, 1},
+     {0, IREE_VMVX_TEST_DENSE, 1}},
+    {"offsets",
+     {3, IREE_VMVX_TEST_DENSE, 1},
+     {5, IREE_VMVX_TEST_DENSE, 1},
+     {7, IREE_VMVX_TEST_DENSE, 1}},
+    {"padded_rows", {1, 23, 1}, {2, 29, 1}, {3, 31, 1}},
+    {"broadcast_lhs_row", {0, 0, 1}, {0, 19, 1}, {0, 19, 1}},
+    {"broadcast_lhs_scalar", {4, 0, 0}, {0, 19, 1}, {0, 19, 1}},
+    {"broadcast_rhs_scalar", {0, 19, 1}, {4, 0, 0}, {0, 19, 1}},
+    {"broadcast_rhs_column", {0, 19, 1}, {0, 1, 0}, {0, 19, 1}},
+    {"broadcast_both", {2, 0, 0}, {0, 0, 0}, {1, IREE_VMVX_TEST_DENSE, 1}},
+    {"strided_lhs", {0, 40, 2}, {0, 19, 1}, {0, 19, 1}},
+    {"strided_out", {0, 19, 1}, {0, 19, 1}, {0, 40, 2}},
+    {"column_major", {0, 1, 3}, {0, 1, 3}, {0, IREE_VMVX_TEST_DENSE, 1}},
+};
+
+// Odd and even sizes around the 4- and 8-lane vector widths.
+static const iree_uk_index_t iree_vmvx_test_sizes1[] = {
+    1, 2, 3, 4, 5, 7, 8, 9, 11, 13, 15, 16, 17, 19};
+#define IREE_VMVX_TEST_MAX_SIZE0 3
+
+// Kind of input values an op is well-defined on.
+typedef enum iree_vmvx_test_domain_e {
+  // Finite floats of either sign.
+  IREE_VMVX_TEST_DOMAIN_FLOAT,
+  // Finite floats > 0.
+  IREE_VMVX_TEST_DOMAIN_POSITIVE_FLOAT,
+  // Any 32-bit value.
+  IREE_VMVX_TEST_DOMAIN_INT,
+  // Any 32-bit value other than 0 and -1 (avoiding INT_MIN / -1).
+  IREE_VMVX_TEST_DOMAIN_DIVISOR,
+  // Values in [0, 32).
+  IREE_VMVX_TEST_DOMAIN_SHIFT,
+} iree_vmvx_test_domain_t;
+
+typedef struct iree_vmvx_test_binary_op_t {
+  iree_uk_x32b_2d_func_t generic_func;
+  iree_vmvx_test_domain_t lhs_domain;
+  iree_vmvx_test_domain_t rhs_domain;
+} iree_vmvx_test_binary_op_t;
+
+typedef struct iree_vmvx_test_unary_op_t {
+  iree_uk_x32u_2d_func_t generic_func;
+  iree_vmvx_test_domain_t domain;
+} iree_vmvx_test_unary_op_t;
+
+static iree_vmvx_test_layout_t iree_vmvx_test_resolve_layout(
+    iree_vmvx_test_layout_t layout, iree_uk_index_t size1) {
+  if (layout.stride0 == IREE_VMVX_TEST_DENSE) layout.stride0 = size1;
+  return layout;
+}
+
+// Returns the number of elements needed to hold |layout| for the given sizes.
+static iree_uk_index_t iree_vmvx_test_buffer_size(
+    iree_vmvx_test_layout_t layout, iree_uk_index_t size0,
+    iree_uk_index_t size1) {
+  return layout.offset + (size0 - 1) * layout.stride0 +
+         (size1 - 1) * layout.stride1 + 1;
+}
+
+static iree_uk_uint32_t iree_vmvx_test_float_bits(float value) {
+  iree_uk_uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+static iree_uk_uint32_t* iree_vmvx_test_make_values(
+    iree_vmvx_test_domain_t domain, iree_uk_index_t count,
+    iree_uk_random_engine_t* engine) {
+  iree_uk_uint32_t* values = malloc(count * sizeof(*values));
+  for (iree_uk_index_t i = 0; i < count; ++i) {
+    float u = iree_uk_random_engine_get_0_65535(engine) / 65535.f;
+    iree_uk_uint32_t bits = iree_uk_random_engine_get_uint32(engine);
+    switch (domain) {
+      case IREE_VMVX_TEST_DOMAIN_FLOAT:
+        values[i] = iree_vmvx_test_float_bits(100.f * (2.f * u - 1.f));
+        break;
+      case IREE_VMVX_TEST_DOMAIN_POSITIVE_FLOAT:
+        values[i] = iree_vmvx_test_float_bits(0.5f + 100.f * u);
+        break;
+      case IREE_VMVX_TEST_DOMAIN_INT:
+        values[i] = bits;
+        break;
+      case IREE_VMVX_TEST_DOMAIN_DIVISOR:
+        values[i] = (bits == 0 || bits == 0xFFFFFFFFu) ? 7 : bits;
+        break;
+      case IREE_VMVX_TEST_DOMAIN_SHIFT:
+        values[i] = bits % 32;
+        break;
+    }
+  }
+  return values;
+}
+
+static iree_uk_uint32_t* iree_vmvx_test_make_guarded_output(
+    iree_uk_index_t count) {
+  iree_uk_uint32_t* values = malloc(count * sizeof(*values));
+  for (iree_uk_index_t i = 0; i < count; ++i) {
+    values[i] = IREE_VMVX_TEST_GUARD;
+  }
+  return values;
+}
+
+static void iree_vmvx_test_binary(iree_uk_test_t* test, const void* params) {
+  const iree_vmvx_test_binary_op_t* op = params;
+  iree_uk_x32b_2d_func_t selected_func =
+      iree_uk_x32b_2d_select(op->generic_func, iree_uk_test_cpu_data(test));
+  iree_uk_random_engine_t* engine = iree_uk_test_random_engine(test);
+  for (int c = 0; c < IREE_ARRAYSIZE(iree_vmvx_test_cases); ++c) {
+    const iree_vmvx_test_case_t* test_case = &iree_vmvx_test_cases[c];
+    for (iree_uk_index_t size0 = 1; size0 <= IREE_VMVX_TEST_MAX_SIZE0;
+         ++size0) {
+      for (int s = 0; s < IREE_ARRAYSIZE(iree_vmvx_test_sizes1); ++s) {
+        iree_uk_index_t size1 = iree_vmvx_test_sizes1[s];
+        iree_vmvx_test_layout_t lhs_layout =
+            iree_vmvx_test_resolve_layout(test_case->lhs, size1);
+        iree_vmvx_test_layout_t rhs_layout =
+            iree_vmvx_test_resolve_layout(test_case->rhs, size1);
+        iree_vmvx_test_layout_t out_layout =
+            iree_vmvx_test_resolve_layout(test_case->out, size1);
+        iree_uk_uint32_t* lhs = iree_vmvx_test_make_values(
+            op->lhs_domain,
+            iree_vmvx_test_buffer_size(lhs_layout, size0, size1), engine);
+        iree_uk_uint32_t* rhs = iree_vmvx_test_make_values(
+            op->rhs_domain,
+            iree_vmvx_test_buffer_size(rhs_layout, size0, size1), engine);
+        iree_uk_index_t out_size =
+            iree_vmvx_test_buffer_size(out_layout, size0, size1) +
+            IREE_VMVX_TEST_OUT_PADDING;
+        iree_uk_uint32_t* expected =
+            iree_vmvx_test_make_guarded_output(out_size);
+        iree_uk_uint32_t* actual = iree_vmvx_test_make_guarded_output(out_size);
+        op->generic_func(lhs, lhs_layout.offset, lhs_layout.stride0,
+                         lhs_layout.stride1, rhs, rhs_layout.offset,
+                         rhs_layout.stride0, rhs_layout.stride1, expected,
+                         out_layout.offset, out_layout.stride0,
+                         out_layout.stride1, size0, size1);
+        selected_func(lhs, lhs_layout.offset, lhs_layout.stride0,
+                      lhs_layout.stride1, rhs, rhs_layout.offset,
+                      rhs_layout.stride0, rhs_layout.stride1, actual,
+                      out_layout.offset, out_layout.stride0,
+                      out_layout.stride1, size0, size1);
+        if (memcmp(expected, actual, out_size * sizeof(*actual))) {
+          fprintf(stderr, "mismatch in case %s with size %dx%d\n",
+                  test_case->name, (int)size0, (int)size1);
+          IREE_UK_TEST_FAIL(test);
+        }
+        free(lhs);
+        free(rhs);
+        free(expected);
+        free(actual);
+      }
+    }
+  }
+}
+
+static void iree_vmvx_test_unary(iree_uk_test_t* test, const void* params) {
+  const iree_vmvx_test_unary_op_t* op = params;
+  iree_uk_x32u_2d_func_t selected_func =
+      iree_uk_x32u_2d_select(op->generic_func, iree_uk_test_cpu_data(test));
+  iree_uk_random_engine_t* engine = iree_uk_test_random_engine(test);
+  for (int c = 0; c < IREE_ARRAYSIZE(iree_vmvx_test_cases); ++c) {
+    const iree_vmvx_test_case_t* test_case = &iree_vmvx_test_cases[c];
+    for (iree_uk_index_t size0 = 1; size0 <= IREE_VMVX_TEST_MAX_SIZE0;
+         ++size0) {
+      for (int s = 0; s < IREE_ARRAYSIZE(iree_vmvx_test_sizes1); ++s) {
+        iree_uk_index_t size1 = iree_vmvx_test_sizes1[s];
+        iree_vmvx_test_layout_t in_layout =
+            iree_vmvx_test_resolve_layout(test_case->lhs, size1);
+        iree_vmvx_test_layout_t out_layout =
+            iree_vmvx_test_resolve_layout(test_case->out, size1);
+        iree_uk_uint32_t* in = iree_vmvx_test_make_values(
+            op->domain, iree_vmvx_test_buffer_size(in_layout, size0, size1),
+            engine);
+        iree_uk_index_t out_size =
+            iree_vmvx_test_buffer_size(out_layout, size0, size1) +
+            IREE_VMVX_TEST_OUT_PADDING;
+        iree_uk_uint32_t* expected =
+            iree_vmvx_test_make_guarded_output(out_size);
+        iree_uk_uint32_t* actual = iree_vmvx_test_make_guarded_output(out_size);
+        op->generic_func(in, in_layout.offset, in_layout.stride0,
+                         in_layout.stride1, expected, out_layout.offset,
+                         out_layout.stride0, out_layout.stride1, size0, size1);
+        selected_func(in, in_layout.offset, in_layout.stride0,
+                      in_layout.stride1, actual, out_layout.offset,
+                      out_layout.stride0, out_layout.stride1, size0, size1);
+        if (memcmp(expected, actual, out_size * sizeof(*actual))) {
+          fprintf(stderr, "mismatch in case %s with size %dx%d\n",
+                  test_case->name, (int)size0, (int)size1);
+          IREE_UK_TEST_FAIL(test);
+        }
+        free(in);
+        free(expected);
+        free(actual);
+      }
+    }
+  }
+}
+
+#define IREE_VMVX_TEST_BINARY(opcode, lhs_domain, rhs_domain, cpu_features) \
+  do {                                                                     \
+    iree_vmvx_test_binary_op_t op = {                                      \
+        iree_uk_x32b_##opcode##_2d,                                        \
+        IREE_VMVX_TEST_DOMAIN_##lhs_domain,                                \
+        IREE_VMVX_TEST_DOMAIN_##rhs_domain,                                \
+    };                                                                     \
+    iree_uk_test("x32b_" #opcode, iree_vmvx_test_binary, &op,              \
+                 cpu_features);                                            \
+  } while (0)
+
+#define IREE_VMVX_TEST_UNARY(opcode, domain, cpu_features)                  \
+  do {                                                                      \
+    iree_vmvx_test_unary_op_t op = {                                        \
+        iree_uk_x32u_##opcode##_2d,                                         \
+        IREE_VMVX_TEST_DOMAIN_##domain,                                     \
+    };                                                                      \
+    iree_uk_test("x32u_" #opcode, iree_vmvx_test_unary, &op, cpu_features); \
+  } while (0)
+
+static void iree_vmvx_test_all(const char* cpu_features) {
+  IREE_VMVX_TEST_BINARY(addf, FLOAT, FLOAT, cpu_features);
+  IREE_VMVX_TEST_BINARY(addi, INT, INT, cpu_features);
+  IREE_VMVX_TEST_BINARY(andi, INT, INT, cpu_features);
+  IREE_VMVX_TEST_BINARY(divf, FLOAT, POSITIVE_FLOAT, cpu_features);
+  IREE_VMVX_TEST_BINARY(divsi, INT, DIVISOR, cpu_features);
+  IREE_VMVX_TEST_BINARY(divui, INT, DIVISOR, cpu_features);
+  IREE_VMVX_TEST_BINARY(mulf, FLOAT, FLOAT, cpu_features);
+  IREE_VMVX_TEST_BINARY(muli, INT, INT, cpu_features);
+  IREE_VMVX_TEST_BINARY(ori, INT, INT, cpu_features);
+  IREE_VMVX_TEST_BINARY(shli, INT, SHIFT, cpu_features);
+  IREE_VMVX_TEST_BINARY(shrsi, INT, SHIFT, cpu_features);
+  IREE_VMVX_TEST_BINARY(shrui, INT, SHIFT, cpu_features);
+  IREE_VMVX_TEST_BINARY(subf, FLOAT, FLOAT, cpu_features);
+  IREE_VMVX_TEST_BINARY(subi, INT, INT, cpu_features);
+  IREE_VMVX_TEST_BINARY(xori, INT, INT, cpu_features);
+  IREE_VMVX_TEST_UNARY(absf, FLOAT, cpu_features);
+  IREE_VMVX_TEST_UNARY(ceilf, FLOAT, cpu_features);
+  IREE_VMVX_TEST_UNARY(ctlz, INT, cpu_features);
+  IREE_VMVX_TEST_UNARY(expf, FLOAT, cpu_features);
+  IREE_VMVX_TEST_UNARY(floorf, FLOAT, cpu_features);
+  IREE_VMVX_TEST_UNARY(logf, POSITIVE_FLOAT, cpu_features);
+  IREE_VMVX_TEST_UNARY(negf, FLOAT, cpu_features);
+  IREE_VMVX_TEST_UNARY(rsqrtf, POSITIVE_FLOAT, cpu_features);
+}
+
+int main(int argc, char** argv) {
+  // Runs each test once with the baseline CPU data and once more with the
+  // given features, if the CPU has them, so that the selected variants are
+  // compared against the generic kernels on the host.
+#if defined(IREE_ARCH_X86_64)
+  iree_vmvx_test_all("avx2_fma");
+#else
+  iree_vmvx_test_all("");
+#endif  // defined(IREE_ARCH_X86_64)
+  return iree_uk_test_exit_status();
+}
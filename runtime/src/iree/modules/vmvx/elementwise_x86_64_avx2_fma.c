@@ -0,0 +1,220 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <immintrin.h>
+
+#include "iree/modules/vmvx/elementwise.h"
+
+//===----------------------------------------------------------------------===//
+// Vector ops on 8 x 32-bit lanes.
+//===----------------------------------------------------------------------===//
+
+// All ops take and return __m256i so that a single row loop serves all types.
+#define IREE_UK_AVX2_F32_BINARY_OP(name, intrinsic)                         \
+  static inline __m256i iree_uk_avx2_##name(__m256i a, __m256i b) {         \
+    return _mm256_castps_si256(                                             \
+        intrinsic(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b)));         \
+  }
+
+IREE_UK_AVX2_F32_BINARY_OP(addf, _mm256_add_ps)
+IREE_UK_AVX2_F32_BINARY_OP(divf, _mm256_div_ps)
+IREE_UK_AVX2_F32_BINARY_OP(mulf, _mm256_mul_ps)
+IREE_UK_AVX2_F32_BINARY_OP(subf, _mm256_sub_ps)
+
+static inline __m256i iree_uk_avx2_addi(__m256i a, __m256i b) {
+  return _mm256_add_epi32(a, b);
+}
+static inline __m256i iree_uk_avx2_andi(__m256i a, __m256i b) {
+  return _mm256_and_si256(a, b);
+}
+static inline __m256i iree_uk_avx2_muli(__m256i a, __m256i b) {
+  return _mm256_mullo_epi32(a, b);
+}
+static inline __m256i iree_uk_avx2_ori(__m256i a, __m256i b) {
+  return _mm256_or_si256(a, b);
+}
+static inline __m256i iree_uk_avx2_subi(__m256i a, __m256i b) {
+  return _mm256_sub_epi32(a, b);
+}
+static inline __m256i iree_uk_avx2_xori(__m256i a, __m256i b) {
+  return _mm256_xor_si256(a, b);
+}
+
+static inline __m256i iree_uk_avx2_absf(__m256i a) {
+  return _mm256_andnot_si256(_mm256_set1_epi32(0x80000000), a);
+}
+static inline __m256i iree_uk_avx2_ceilf(__m256i a) {
+  return _mm256_castps_si256(_mm256_ceil_ps(_mm256_castsi256_ps(a)));
+}
+static inline __m256i iree_uk_avx2_floorf(__m256i a) {
+  return _mm256_castps_si256(_mm256_floor_ps(_mm256_castsi256_ps(a)));
+}
+static inline __m256i iree_uk_avx2_negf(__m256i a) {
+  return _mm256_xor_si256(_mm256_set1_epi32(0x80000000), a);
+}
+// Not _mm256_rsqrt_ps, which is only a 12-bit approximation.
+static inline __m256i iree_uk_avx2_rsqrtf(__m256i a) {
+  return _mm256_castps_si256(_mm256_div_ps(
+      _mm256_set1_ps(1.0f), _mm256_sqrt_ps(_mm256_castsi256_ps(a))));
+}
+
+//===----------------------------------------------------------------------===//
+// Row loops.
+//===----------------------------------------------------------------------===//
+
+// Mask of the first |count| lanes, for 0 < count < 8.
+static inline __m256i iree_uk_avx2_tail_mask(iree_uk_index_t count) {
+  return _mm256_cmpgt_epi32(_mm256_set1_epi32((int)count),
+                            _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+}
+
+// Loads 8 lanes from |ptr| if |stride| is 1, or broadcasts *ptr if it is 0.
+static inline __m256i iree_uk_avx2_load(const iree_uk_uint32_t* ptr,
+                                        iree_uk_index_t stride) {
+  return stride ? _mm256_loadu_si256((const __m256i*)ptr)
+                : _mm256_set1_epi32((int)*ptr);
+}
+
+// Same as iree_uk_avx2_load, only reading the lanes enabled in |mask|.
+static inline __m256i iree_uk_avx2_maskload(const iree_uk_uint32_t* ptr,
+                                            iree_uk_index_t stride,
+                                            __m256i mask) {
+  return stride ? _mm256_maskload_epi32((const int*)ptr, mask)
+                : _mm256_set1_epi32((int)*ptr);
+}
+
+static IREE_UK_ATTRIBUTE_ALWAYS_INLINE inline void iree_uk_x32b_row_avx2(
+    __m256i (*op)(__m256i, __m256i), const iree_uk_uint32_t* lhs,
+    iree_uk_index_t lhs_stride1, const iree_uk_uint32_t* rhs,
+    iree_uk_index_t rhs_stride1, iree_uk_uint32_t* out, iree_uk_index_t size) {
+  iree_uk_index_t j = 0;
+  for (; j + 8 <= size; j += 8) {
+    __m256i a = iree_uk_avx2_load(lhs + j * lhs_stride1, lhs_stride1);
+    __m256i b = iree_uk_avx2_load(rhs + j * rhs_stride1, rhs_stride1);
+    _mm256_storeu_si256((__m256i*)(out + j), op(a, b));
+  }
+  if (j < size) {
+    __m256i mask = iree_uk_avx2_tail_mask(size - j);
+    __m256i a = iree_uk_avx2_maskload(lhs + j * lhs_stride1, lhs_stride1, mask);
+    __m256i b = iree_uk_avx2_maskload(rhs + j * rhs_stride1, rhs_stride1, mask);
+    _mm256_maskstore_epi32((int*)(out + j), mask, op(a, b));
+  }
+}
+
+static IREE_UK_ATTRIBUTE_ALWAYS_INLINE inline void iree_uk_x32u_row_avx2(
+    __m256i (*op)(__m256i), const iree_uk_uint32_t* in,
+    iree_uk_index_t in_stride1, iree_uk_uint32_t* out, iree_uk_index_t size) {
+  iree_uk_index_t j = 0;
+  for (; j + 8 <= size; j += 8) {
+    __m256i a = iree_uk_avx2_load(in + j * in_stride1, in_stride1);
+    _mm256_storeu_si256((__m256i*)(out + j), op(a));
+  }
+  if (j < size) {
+    __m256i mask = iree_uk_avx2_tail_mask(size - j);
+    __m256i a = iree_uk_avx2_maskload(in + j * in_stride1, in_stride1, mask);
+    _mm256_maskstore_epi32((int*)(out + j), mask, op(a));
+  }
+}
+
+//===----------------------------------------------------------------------===//
+// 2D kernels.
+//===----------------------------------------------------------------------===//
+
+// Rows are vectorized when the output is contiguous and each input is either
+// contiguous or broadcast along the row (stride1 of 0), which covers what the
+// compiler emits for VMVX in practice. Other layouts go to the generic kernel.
+#define IREE_UK_X32B_2D_X86_64_AVX2_FMA(opcode)                              \
+  static int iree_uk_x32b_##opcode##_2d_x86_64_avx2_fma(                     \
+      const iree_uk_uint32_t* lhs, iree_uk_index_t lhs_offset,               \
+      iree_uk_index_t lhs_stride0, iree_uk_index_t lhs_stride1,              \
+      const iree_uk_uint32_t* rhs, iree_uk_index_t rhs_offset,               \
+      iree_uk_index_t rhs_stride0, iree_uk_index_t rhs_stride1,              \
+      iree_uk_uint32_t* IREE_UK_RESTRICT out, iree_uk_index_t out_offset,    \
+      iree_uk_index_t out_stride0, iree_uk_index_t out_stride1,              \
+      iree_uk_index_t size0, iree_uk_index_t size1) {                        \
+    if (out_stride1 != 1 || (lhs_stride1 != 0 && lhs_stride1 != 1) ||        \
+        (rhs_stride1 != 0 && rhs_stride1 != 1)) {                            \
+      return iree_uk_x32b_##opcode##_2d(                                     \
+          lhs, lhs_offset, lhs_stride0, lhs_stride1, rhs, rhs_offset,        \
+          rhs_stride0, rhs_stride1, out, out_offset, out_stride0,            \
+          out_stride1, size0, size1);                                        \
+    }                                                                        \
+    for (iree_uk_index_t i = 0; i < size0; ++i) {                            \
+      iree_uk_x32b_row_avx2(iree_uk_avx2_##opcode, lhs + i * lhs_stride0,    \
+                            lhs_stride1, rhs + i * rhs_stride0, rhs_stride1, \
+                            out + i * out_stride0, size1);                   \
+    }                                                                        \
+    return 0;                                                                \
+  }
+
+#define IREE_UK_X32U_2D_X86_64_AVX2_FMA(opcode)                                \
+  static int iree_uk_x32u_##opcode##_2d_x86_64_avx2_fma(                       \
+      const iree_uk_uint32_t* in, iree_uk_index_t in_offset,                   \
+      iree_uk_index_t in_stride0, iree_uk_index_t in_stride1,                  \
+      iree_uk_uint32_t* IREE_UK_RESTRICT out, iree_uk_index_t out_offset,      \
+      iree_uk_index_t out_stride0, iree_uk_index_t out_stride1,                \
+      iree_uk_index_t size0, iree_uk_index_t size1) {                          \
+    if (out_stride1 != 1 || (in_stride1 != 0 && in_stride1 != 1)) {           \
+      return iree_uk_x32u_##opcode##_2d(in, in_offset, in_stride0, in_stride1, \
+                                        out, out_offset, out_stride0,          \
+                                        out_stride1, size0, size1);            \
+    }                                                                          \
+    for (iree_uk_index_t i = 0; i < size0; ++i) {                              \
+      iree_uk_x32u_row_avx2(iree_uk_avx2_##opcode, in + i * in_stride0,        \
+                            in_stride1, out + i * out_stride0, size1);         \
+    }                                                                          \
+    return 0;                                                                  \
+  }
+
+IREE_UK_X32B_2D_X86_64_AVX2_FMA(addf)
+IREE_UK_X32B_2D_X86_64_AVX2_FMA(addi)
+IREE_UK_X32B_2D_X86_64_AVX2_FMA(andi)
+IREE_UK_X32B_2D_X86_64_AVX2_FMA(divf)
+IREE_UK_X32B_2D_X86_64_AVX2_FMA(mulf)
+IREE_UK_X32B_2D_X86_64_AVX2_FMA(muli)
+IREE_UK_X32B_2D_X86_64_AVX2_FMA(ori)
+IREE_UK_X32B_2D_X86_64_AVX2_FMA(subf)
+IREE_UK_X32B_2D_X86_64_AVX2_FMA(subi)
+IREE_UK_X32B_2D_X86_64_AVX2_FMA(xori)
+
+IREE_UK_X32U_2D_X86_64_AVX2_FMA(absf)
+IREE_UK_X32U_2D_X86_64_AVX2_FMA(ceilf)
+IREE_UK_X32U_2D_X86_64_AVX2_FMA(floorf)
+IREE_UK_X32U_2D_X86_64_AVX2_FMA(negf)
+IREE_UK_X32U_2D_X86_64_AVX2_FMA(rsqrtf)
+
+//===----------------------------------------------------------------------===//
+// Selection.
+//===----------------------------------------------------------------------===//
+
+#define IREE_UK_SELECT_X86_64_AVX2_FMA(category, opcode)  \
+  if (generic_func == iree_uk_##category##_##opcode##_2d) \
+    return iree_uk_##category##_##opcode##_2d_x86_64_avx2_fma;
+
+iree_uk_x32b_2d_func_t iree_uk_x32b_2d_select_x86_64_avx2_fma(
+    iree_uk_x32b_2d_func_t generic_func) {
+  IREE_UK_SELECT_X86_64_AVX2_FMA(x32b, addf)
+  IREE_UK_SELECT_X86_64_AVX2_FMA(x32b, addi)
+  IREE_UK_SELECT_X86_64_AVX2_FMA(x32b, andi)
+  IREE_UK_SELECT_X86_64_AVX2_FMA(x32b, divf)
+  IREE_UK_SELECT_X86_64_AVX2_FMA(x32b, mulf)
+  IREE_UK_SELECT_X86_64_AVX2_FMA(x32b, muli)
+  IREE_UK_SELECT_X86_64_AVX2_FMA(x32b, ori)
+  IREE_UK_SELECT_X86_64_AVX2_FMA(x32b, subf)
+  IREE_UK_SELECT_X86_64_AVX2_FMA(x32b, subi)
+  IREE_UK_SELECT_X86_64_AVX2_FMA(x32b, xori)
+  return 0;
+}
+
+iree_uk_x32u_2d_func_t iree_uk_x32u_2d_select_x86_64_avx2_fma(
+    iree_uk_x32u_2d_func_t generic_func) {
+  IREE_UK_SELECT_X86_64_AVX2_FMA(x32u, absf)
+  IREE_UK_SELECT_X86_64_AVX2_FMA(x32u, ceilf)
+  IREE_UK_SELECT_X86_64_AVX2_FMA(x32u, floorf)
+  IREE_UK_SELECT_X86_64_AVX2_FMA(x32u, negf)
+  IREE_UK_SELECT_X86_64_AVX2_FMA(x32u, rsqrtf)
+  return 0;
+}
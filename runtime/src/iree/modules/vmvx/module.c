@@ -10,10 +10,13 @@
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include "iree/base/api.h"
 #include "iree/base/internal/cpu.h"
+#include "iree/base/internal/file_io.h"
 #include "iree/vm/api.h"
 
 // Include the ukernel support library so that we can use its implementations
@@ -22,6 +25,7 @@
 
 // Additional ukernel code specific to VMVX.
 #include "iree/modules/vmvx/elementwise.h"
+#include "iree/modules/vmvx/tile_sizes_cache.h"
 
 #define IREE_VMVX_MODULE_VERSION_0_0 0x00000000u
 #define IREE_VMVX_MODULE_VERSION_LATEST IREE_VMVX_MODULE_VERSION_0_0
@@ -45,8 +49,25 @@ void iree_uk_assert_fail(const char* file, int line, const char* function,
 // Module type definitions
 //===----------------------------------------------------------------------===//
 
+// Number of functions in exports.inl.
+enum {
+  IREE_VMVX_MODULE_FUNCTION_COUNT = 0
+#define EXPORT_FN(name, target_fn, arg_struct, arg_types, ret_types) +1
+#include "iree/modules/vmvx/exports.inl"  // IWYU pragma: keep
+#undef EXPORT_FN
+};
+
 typedef struct iree_vmvx_module_t {
   iree_allocator_t host_allocator;
+  // Copy of iree_vmvx_module_descriptor_ referencing |functions| below.
+  iree_vm_native_module_descriptor_t descriptor;
+  // Copy of iree_vmvx_module_funcs_ where elementwise ukernel targets have
+  // been replaced with variants specialized for the host CPU, so that the
+  // selection happens once at module creation instead of on every call.
+  iree_vm_native_function_ptr_t functions[IREE_VMVX_MODULE_FUNCTION_COUNT];
+  // Matmul tile sizes returned by query_tile_sizes instead of the built-in
+  // ones, loaded from the tile sizes cache, see iree_vmvx_module_load_cache.
+  iree_vmvx_tile_sizes_cache_t tile_sizes_cache;
   // TODO(benvanik): types when we are not registering them globally.
 } iree_vmvx_module_t;
 
@@ -713,11 +734,14 @@ IREE_VMVX_ABI_DEFINE_SHIM(query_tile_sizes_2d, II);
 
 IREE_VMVX_ABI_EXPORT(iree_vmvx_query_tile_sizes_2d, query_tile_sizes_2d, II) {
   IREE_TRACE_ZONE_BEGIN(z0);
+  iree_vmvx_module_t* vmvx_module = IREE_VMVX_MODULE_CAST(module);
   iree_uk_query_tile_sizes_2d_params_t ukernel_params = {
       .size0 = args->size0,
       .size1 = args->size1,
       .flags = args->flags,
       .cpu_data = (const iree_uk_uint64_t*)iree_cpu_data_fields(),
+      .tuned_matmuls = vmvx_module->tile_sizes_cache.matmuls,
+      .tuned_matmul_count = vmvx_module->tile_sizes_cache.matmul_count,
   };
   iree_uk_query_tile_sizes_2d_out_params_t ukernel_out_params;
   iree_uk_query_tile_sizes_2d(&ukernel_params, &ukernel_out_params);
@@ -761,6 +785,9 @@ static const iree_vm_native_export_descriptor_t iree_vmvx_module_exports_[] = {
 static_assert(IREE_ARRAYSIZE(iree_vmvx_module_funcs_) ==
                   IREE_ARRAYSIZE(iree_vmvx_module_exports_),
               "function pointer table must be 1:1 with exports");
+static_assert(IREE_ARRAYSIZE(iree_vmvx_module_funcs_) ==
+                  IREE_VMVX_MODULE_FUNCTION_COUNT,
+              "function count must match exports");
 
 static const iree_vm_native_module_descriptor_t iree_vmvx_module_descriptor_ = {
     .name = iree_string_view_literal("vmvx"),
@@ -777,6 +804,66 @@ static const iree_vm_native_module_descriptor_t iree_vmvx_module_descriptor_ = {
     .functions = iree_vmvx_module_funcs_,
 };
 
+// Initializes the descriptor and function table of |module|, selecting
+// elementwise ukernels specialized for the host CPU where available.
+static void iree_vmvx_module_select_functions(iree_vmvx_module_t* module) {
+  const iree_uk_uint64_t* cpu_data =
+      (const iree_uk_uint64_t*)iree_cpu_data_fields();
+  memcpy(module->functions, iree_vmvx_module_funcs_,
+         sizeof(module->functions));
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(module->functions); ++i) {
+    iree_vm_native_function_ptr_t* function = &module->functions[i];
+    if (function->shim ==
+        (iree_vm_native_function_shim_t)iree_vm_shim_ukernel_x32b_2d_v) {
+      function->target =
+          (iree_vm_native_function_target_t)iree_uk_x32b_2d_select(
+              (iree_uk_x32b_2d_func_t)function->target, cpu_data);
+    } else if (function->shim == (iree_vm_native_function_shim_t)
+                                     iree_vm_shim_ukernel_x32u_2d_v) {
+      function->target =
+          (iree_vm_native_function_target_t)iree_uk_x32u_2d_select(
+              (iree_uk_x32u_2d_func_t)function->target, cpu_data);
+    }
+  }
+  module->descriptor = iree_vmvx_module_descriptor_;
+  module->descriptor.functions = module->functions;
+}
+
+// Loads the tile sizes cache written by the mmt4d_autotune tool from the path
+// in the IREE_VMVX_TILE_SIZES_CACHE environment variable, if set, keeping the
+// fastest tile for each matmul operation among those that the mmt4d ukernel
+// has a tile function for on the host CPU.
+//
+// Unlike when targeting a known CPU, VMVX chooses tile sizes at runtime, so
+// this is where tiles tuned for the host can be picked up.
+static iree_status_t iree_vmvx_module_load_cache(
+    iree_vmvx_module_t* module, iree_allocator_t host_allocator) {
+  iree_vmvx_tile_sizes_cache_initialize(&module->tile_sizes_cache);
+#if IREE_FILE_IO_ENABLE
+  const char* path = getenv("IREE_VMVX_TILE_SIZES_CACHE");
+  if (!path || !path[0]) return iree_ok_status();
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_file_contents_t* contents = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_file_read_contents(path, IREE_FILE_READ_FLAG_DEFAULT,
+                                  host_allocator, &contents));
+  iree_status_t status = iree_vmvx_tile_sizes_cache_parse(
+      &module->tile_sizes_cache,
+      iree_make_string_view((const char*)contents->const_buffer.data,
+                            contents->const_buffer.data_length),
+      (const iree_uk_uint64_t*)iree_cpu_data_fields());
+  iree_file_contents_free(contents);
+  if (!iree_status_is_ok(status)) {
+    status = iree_status_annotate_f(status, "loading tile sizes cache %s",
+                                    path);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+#else
+  return iree_ok_status();
+#endif  // IREE_FILE_IO_ENABLE
+}
+
 IREE_API_EXPORT iree_status_t iree_vmvx_module_create(
     iree_vm_instance_t* instance, iree_allocator_t host_allocator,
     iree_vm_module_t** out_module) {
@@ -799,17 +886,19 @@ IREE_API_EXPORT iree_status_t iree_vmvx_module_create(
   IREE_RETURN_IF_ERROR(
       iree_allocator_malloc(host_allocator, total_size, (void**)&base_module));
   memset(base_module, 0, total_size);
-  iree_status_t status = iree_vm_native_module_initialize(
-      &interface, &iree_vmvx_module_descriptor_, instance, host_allocator,
-      base_module);
+  iree_vmvx_module_t* module = IREE_VMVX_MODULE_CAST(base_module);
+  module->host_allocator = host_allocator;
+  iree_vmvx_module_select_functions(module);
+  iree_status_t status = iree_vmvx_module_load_cache(module, host_allocator);
+  if (iree_status_is_ok(status)) {
+    status = iree_vm_native_module_initialize(
+        &interface, &module->descriptor, instance, host_allocator, base_module);
+  }
   if (!iree_status_is_ok(status)) {
     iree_allocator_free(host_allocator, base_module);
     return status;
   }
 
-  iree_vmvx_module_t* module = IREE_VMVX_MODULE_CAST(base_module);
-  module->host_allocator = host_allocator;
-
   *out_module = base_module;
   return iree_ok_status();
 }
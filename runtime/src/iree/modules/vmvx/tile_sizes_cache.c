@@ -0,0 +1,118 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/modules/vmvx/tile_sizes_cache.h"
+
+#include <stdio.h>
+#include <string.h>
+
+// Maps the type triples used in tile sizes caches to the query_tile_sizes
+// operations that VMVX can be asked about and to the corresponding mmt4d
+// types. Other types are ignored.
+static const struct {
+  const char* types;
+  iree_uk_uint32_t operation;
+  iree_uk_uint32_t mmt4d_type;
+} iree_vmvx_tile_sizes_cache_types_[] = {
+    {"f32f32f32", IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_F32F32F32,
+     IREE_UK_FLAG_MMT4D_TYPE_F32F32F32},
+    {"s8s8s32", IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_I8I8I32,
+     IREE_UK_FLAG_MMT4D_TYPE_S8S8S32},
+    {"f16f16f32", IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_F16F16F32,
+     IREE_UK_FLAG_MMT4D_TYPE_F16F16F32},
+    {"f16f16f16", IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_F16F16F16,
+     IREE_UK_FLAG_MMT4D_TYPE_F16F16F16},
+    {"bf16bf16f32",
+     IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_BF16BF16F32,
+     IREE_UK_FLAG_MMT4D_TYPE_BF16BF16F32},
+    {"bf16bf16bf16",
+     IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_BF16BF16BF16,
+     IREE_UK_FLAG_MMT4D_TYPE_BF16BF16BF16},
+};
+
+void iree_vmvx_tile_sizes_cache_initialize(
+    iree_vmvx_tile_sizes_cache_t* cache) {
+  memset(cache, 0, sizeof(*cache));
+}
+
+iree_status_t iree_vmvx_tile_sizes_cache_parse_line(
+    iree_vmvx_tile_sizes_cache_t* cache, iree_string_view_t line,
+    const iree_uk_uint64_t* cpu_data) {
+  char line_buffer[512];
+  if (line.size >= sizeof(line_buffer)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "tile sizes cache line too long: '%.*s'",
+                            (int)line.size, line.data);
+  }
+  memcpy(line_buffer, line.data, line.size);
+  line_buffer[line.size] = 0;
+  char arch[32];
+  char features[256];
+  char types[32];
+  int M0 = 0, N0 = 0, K0 = 0;
+  double rate = 0;
+  if (sscanf(line_buffer, "%31s %255s %31s %d %d %d %lf", arch, features,
+             types, &M0, &N0, &K0, &rate) != 7 ||
+      M0 <= 0 || N0 <= 0 || K0 <= 0) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "malformed tile sizes cache line: '%s'",
+                            line_buffer);
+  }
+  if (strcmp(arch, IREE_ARCH) != 0) return iree_ok_status();
+  for (iree_host_size_t i = 0;
+       i < IREE_ARRAYSIZE(iree_vmvx_tile_sizes_cache_types_); ++i) {
+    if (strcmp(types, iree_vmvx_tile_sizes_cache_types_[i].types) != 0) {
+      continue;
+    }
+    if (!(iree_uk_mmt4d_info(M0, N0, K0,
+                             iree_vmvx_tile_sizes_cache_types_[i].mmt4d_type,
+                             cpu_data) &
+          IREE_UK_FLAG_MMT4D_INFO_HAVE_ARCHITECTURE_SPECIFIC_TILE_FUNCTION)) {
+      return iree_ok_status();
+    }
+    iree_uk_uint32_t operation = iree_vmvx_tile_sizes_cache_types_[i].operation;
+    iree_host_size_t j = 0;
+    while (j < cache->matmul_count &&
+           cache->matmuls[j].operation != operation) {
+      ++j;
+    }
+    if (j == cache->matmul_count) {
+      ++cache->matmul_count;
+    } else if (rate <= cache->rates[j]) {
+      return iree_ok_status();
+    }
+    cache->rates[j] = rate;
+    cache->matmuls[j] = (iree_uk_query_tile_sizes_tuned_matmul_t){
+        .operation = operation, .M = M0, .K = K0, .N = N0};
+  }
+  return iree_ok_status();
+}
+
+iree_status_t iree_vmvx_tile_sizes_cache_parse(
+    iree_vmvx_tile_sizes_cache_t* cache, iree_string_view_t contents,
+    const iree_uk_uint64_t* cpu_data) {
+  iree_status_t status = iree_ok_status();
+  while (iree_status_is_ok(status) && !iree_string_view_is_empty(contents)) {
+    iree_string_view_t line = iree_string_view_empty();
+    iree_string_view_split(contents, '\n', &line, &contents);
+    line = iree_string_view_trim(line);
+    if (iree_string_view_is_empty(line) ||
+        iree_string_view_starts_with(line, IREE_SV("#"))) {
+      continue;
+    }
+    status = iree_vmvx_tile_sizes_cache_parse_line(cache, line, cpu_data);
+  }
+  return status;
+}
+
+const iree_uk_query_tile_sizes_tuned_matmul_t*
+iree_vmvx_tile_sizes_cache_lookup(const iree_vmvx_tile_sizes_cache_t* cache,
+                                  iree_uk_uint32_t operation) {
+  for (iree_host_size_t i = 0; i < cache->matmul_count; ++i) {
+    if (cache->matmuls[i].operation == operation) return &cache->matmuls[i];
+  }
+  return NULL;
+}
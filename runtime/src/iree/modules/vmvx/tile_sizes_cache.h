@@ -0,0 +1,64 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_MODULES_VMVX_TILE_SIZES_CACHE_H_
+#define IREE_MODULES_VMVX_TILE_SIZES_CACHE_H_
+
+#include "iree/base/api.h"
+#include "iree/builtins/ukernel/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// Upper bound on the number of matmul operations in
+// IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_*.
+#define IREE_VMVX_TILE_SIZES_CACHE_MAX_MATMULS 8
+
+// Matmul tile sizes read from a tile sizes cache written by the mmt4d_autotune
+// tool, see builtins/ukernel/tools/mmt4d_autotune.c for the format. Holds the
+// fastest usable tile for each query_tile_sizes matmul operation, to be passed
+// as iree_uk_query_tile_sizes_2d_params_t::tuned_matmuls.
+typedef struct iree_vmvx_tile_sizes_cache_t {
+  iree_uk_query_tile_sizes_tuned_matmul_t
+      matmuls[IREE_VMVX_TILE_SIZES_CACHE_MAX_MATMULS];
+  // Measured throughput of each of |matmuls|.
+  double rates[IREE_VMVX_TILE_SIZES_CACHE_MAX_MATMULS];
+  iree_host_size_t matmul_count;
+} iree_vmvx_tile_sizes_cache_t;
+
+// Initializes |cache| to hold no tiles.
+void iree_vmvx_tile_sizes_cache_initialize(iree_vmvx_tile_sizes_cache_t* cache);
+
+// Records the tile on |line| of a tile sizes cache into |cache| if it is usable
+// and faster than the tile held so far for the same operation. A tile is usable
+// if it is for the host architecture, for element types that VMVX can be asked
+// about, and if the mmt4d ukernel has an architecture-specific tile function
+// for it given |cpu_data|. The features column is not consulted: the cache may
+// have been written on another CPU and iree_uk_mmt4d_info is what decides
+// which tiles run fast here.
+//
+// Returns IREE_STATUS_INVALID_ARGUMENT if |line| is malformed.
+iree_status_t iree_vmvx_tile_sizes_cache_parse_line(
+    iree_vmvx_tile_sizes_cache_t* cache, iree_string_view_t line,
+    const iree_uk_uint64_t* cpu_data);
+
+// Records the usable tiles of all lines in |contents|, skipping empty lines and
+// '#' comments. See iree_vmvx_tile_sizes_cache_parse_line.
+iree_status_t iree_vmvx_tile_sizes_cache_parse(
+    iree_vmvx_tile_sizes_cache_t* cache, iree_string_view_t contents,
+    const iree_uk_uint64_t* cpu_data);
+
+// Returns the tile held for the query_tile_sizes matmul |operation| or NULL.
+const iree_uk_query_tile_sizes_tuned_matmul_t*
+iree_vmvx_tile_sizes_cache_lookup(const iree_vmvx_tile_sizes_cache_t* cache,
+                                  iree_uk_uint32_t operation);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_MODULES_VMVX_TILE_SIZES_CACHE_H_
@@ -0,0 +1,206 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/modules/vmvx/tile_sizes_cache.h"
+
+#include "iree/base/api.h"
+#include "iree/builtins/ukernel/api.h"
+#include "iree/builtins/ukernel/tools/test.h"
+#include "iree/builtins/ukernel/tools/util.h"
+
+typedef struct iree_vmvx_test_tile_t {
+  int M0, N0, K0;
+} iree_vmvx_test_tile_t;
+
+// Finds up to |capacity| f32 tiles that the mmt4d ukernel has an
+// architecture-specific tile function for with |cpu_data|. Returns how many.
+static int iree_vmvx_test_find_f32_tiles(const iree_uk_uint64_t* cpu_data,
+                                         iree_vmvx_test_tile_t* out_tiles,
+                                         int capacity) {
+  int count = 0;
+  for (int M0 = 1; M0 <= 32; M0 *= 2) {
+    for (int N0 = 1; N0 <= 64; N0 *= 2) {
+      for (int K0 = 1; K0 <= 4; K0 *= 2) {
+        if (count == capacity) return count;
+        if (iree_uk_mmt4d_info(M0, N0, K0, IREE_UK_FLAG_MMT4D_TYPE_F32F32F32,
+                               cpu_data) &
+            IREE_UK_FLAG_MMT4D_INFO_HAVE_ARCHITECTURE_SPECIFIC_TILE_FUNCTION) {
+          out_tiles[count++] = (iree_vmvx_test_tile_t){M0, N0, K0};
+        }
+      }
+    }
+  }
+  return count;
+}
+
+// Parses a single line built from the arguments into |cache| and returns the
+// resulting status code.
+static iree_status_code_t iree_vmvx_test_parse_line(
+    iree_vmvx_tile_sizes_cache_t* cache, const iree_uk_uint64_t* cpu_data,
+    const char* arch, const char* types, iree_vmvx_test_tile_t tile,
+    double rate) {
+  char line[256];
+  snprintf(line, sizeof line, "%s - %s %d %d %d %.2f", arch, types, tile.M0,
+           tile.N0, tile.K0, rate);
+  return iree_status_consume_code(iree_vmvx_tile_sizes_cache_parse_line(
+      cache, iree_make_cstring_view(line), cpu_data));
+}
+
+static bool iree_vmvx_test_lookup_is(const iree_vmvx_tile_sizes_cache_t* cache,
+                                     iree_vmvx_test_tile_t tile) {
+  const iree_uk_query_tile_sizes_tuned_matmul_t* tuned =
+      iree_vmvx_tile_sizes_cache_lookup(
+          cache, IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_F32F32F32);
+  return tuned && tuned->M == tile.M0 && tuned->N == tile.N0 &&
+         tuned->K == tile.K0;
+}
+
+static void iree_vmvx_test_malformed_lines(iree_uk_test_t* test,
+                                           const void* params) {
+  const iree_uk_uint64_t* cpu_data = iree_uk_test_cpu_data(test);
+  static const char* malformed_lines[] = {
+      "garbage",
+      IREE_ARCH " - f32f32f32 8 8",
+      IREE_ARCH " - f32f32f32 0 8 1 12.5",
+      IREE_ARCH " - f32f32f32 8 -8 1 12.5",
+  };
+  for (int i = 0; i < IREE_ARRAYSIZE(malformed_lines); ++i) {
+    iree_vmvx_tile_sizes_cache_t cache;
+    iree_vmvx_tile_sizes_cache_initialize(&cache);
+    iree_status_code_t code = iree_status_consume_code(
+        iree_vmvx_tile_sizes_cache_parse_line(
+            &cache, iree_make_cstring_view(malformed_lines[i]), cpu_data));
+    if (code != IREE_STATUS_INVALID_ARGUMENT || cache.matmul_count != 0) {
+      fprintf(stderr, "line '%s' not rejected\n", malformed_lines[i]);
+      IREE_UK_TEST_FAIL(test);
+    }
+  }
+  char long_line[1024];
+  memset(long_line, 'x', sizeof long_line);
+  iree_vmvx_tile_sizes_cache_t cache;
+  iree_vmvx_tile_sizes_cache_initialize(&cache);
+  if (iree_status_consume_code(iree_vmvx_tile_sizes_cache_parse_line(
+          &cache, iree_make_string_view(long_line, sizeof long_line),
+          cpu_data)) != IREE_STATUS_INVALID_ARGUMENT) {
+    IREE_UK_TEST_FAIL(test);
+  }
+}
+
+static void iree_vmvx_test_unusable_lines(iree_uk_test_t* test,
+                                          const void* params) {
+  const iree_uk_uint64_t* cpu_data = iree_uk_test_cpu_data(test);
+  iree_vmvx_test_tile_t tiles[1];
+  iree_vmvx_test_tile_t tile = {8, 8, 1};
+  if (iree_vmvx_test_find_f32_tiles(cpu_data, tiles, 1)) tile = tiles[0];
+  iree_vmvx_tile_sizes_cache_t cache;
+  iree_vmvx_tile_sizes_cache_initialize(&cache);
+  // Other architectures and types are ignored.
+  if (iree_vmvx_test_parse_line(&cache, cpu_data, "other_arch", "f32f32f32",
+                                tile, 10.0) != IREE_STATUS_OK ||
+      iree_vmvx_test_parse_line(&cache, cpu_data, IREE_ARCH, "s16s16s32", tile,
+                                10.0) != IREE_STATUS_OK ||
+      cache.matmul_count != 0) {
+    IREE_UK_TEST_FAIL(test);
+  }
+  // Tiles without a tile function for the CPU are ignored, whatever their
+  // features column claims.
+  iree_vmvx_test_tile_t odd_tile = {3, 5, 7};
+  if (iree_vmvx_test_parse_line(&cache, cpu_data, IREE_ARCH, "f32f32f32",
+                                odd_tile, 10.0) != IREE_STATUS_OK ||
+      cache.matmul_count != 0) {
+    IREE_UK_TEST_FAIL(test);
+  }
+}
+
+static void iree_vmvx_test_fastest_tile_wins(iree_uk_test_t* test,
+                                             const void* params) {
+  const iree_uk_uint64_t* cpu_data = iree_uk_test_cpu_data(test);
+  iree_vmvx_test_tile_t tiles[2];
+  int tile_count = iree_vmvx_test_find_f32_tiles(cpu_data, tiles, 2);
+  iree_vmvx_tile_sizes_cache_t cache;
+  iree_vmvx_tile_sizes_cache_initialize(&cache);
+  if (iree_vmvx_tile_sizes_cache_lookup(
+          &cache, IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_F32F32F32)) {
+    IREE_UK_TEST_FAIL(test);
+  }
+  if (tile_count < 2) {
+    // Too few tile functions for these CPU features to compare: only check
+    // that a line is recorded exactly if its tile has a tile function.
+    iree_vmvx_test_tile_t tile = {8, 8, 1};
+    if (tile_count) tile = tiles[0];
+    if (iree_vmvx_test_parse_line(&cache, cpu_data, IREE_ARCH, "f32f32f32",
+                                  tile, 10.0) != IREE_STATUS_OK ||
+        cache.matmul_count != (iree_host_size_t)tile_count) {
+      IREE_UK_TEST_FAIL(test);
+    }
+    return;
+  }
+  if (iree_vmvx_test_parse_line(&cache, cpu_data, IREE_ARCH, "f32f32f32",
+                                tiles[0], 10.0) != IREE_STATUS_OK ||
+      !iree_vmvx_test_lookup_is(&cache, tiles[0])) {
+    IREE_UK_TEST_FAIL(test);
+  }
+  // Slower tiles do not replace the current one, faster ones do.
+  if (iree_vmvx_test_parse_line(&cache, cpu_data, IREE_ARCH, "f32f32f32",
+                                tiles[1], 5.0) != IREE_STATUS_OK ||
+      !iree_vmvx_test_lookup_is(&cache, tiles[0])) {
+    IREE_UK_TEST_FAIL(test);
+  }
+  if (iree_vmvx_test_parse_line(&cache, cpu_data, IREE_ARCH, "f32f32f32",
+                                tiles[1], 20.0) != IREE_STATUS_OK ||
+      !iree_vmvx_test_lookup_is(&cache, tiles[1]) || cache.matmul_count != 1) {
+    IREE_UK_TEST_FAIL(test);
+  }
+  // Other operations are kept separately.
+  if (iree_vmvx_tile_sizes_cache_lookup(
+          &cache, IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_I8I8I32)) {
+    IREE_UK_TEST_FAIL(test);
+  }
+}
+
+static void iree_vmvx_test_parse_contents(iree_uk_test_t* test,
+                                          const void* params) {
+  const iree_uk_uint64_t* cpu_data = iree_uk_test_cpu_data(test);
+  iree_vmvx_test_tile_t tiles[2];
+  int tile_count = iree_vmvx_test_find_f32_tiles(cpu_data, tiles, 2);
+  if (tile_count < 2) return;
+  char contents[512];
+  snprintf(contents, sizeof contents,
+           "# Tile sizes cache written by mmt4d_autotune.\n"
+           "\n"
+           "  %s - f32f32f32 %d %d %d 10.00\r\n"
+           "other_arch - f32f32f32 %d %d %d 99.00\n"
+           "%s - f32f32f32 %d %d %d 20.00",
+           IREE_ARCH, tiles[0].M0, tiles[0].N0, tiles[0].K0, tiles[0].M0,
+           tiles[0].N0, tiles[0].K0, IREE_ARCH, tiles[1].M0, tiles[1].N0,
+           tiles[1].K0);
+  iree_vmvx_tile_sizes_cache_t cache;
+  iree_vmvx_tile_sizes_cache_initialize(&cache);
+  if (iree_status_consume_code(iree_vmvx_tile_sizes_cache_parse(
+          &cache, iree_make_cstring_view(contents), cpu_data)) !=
+          IREE_STATUS_OK ||
+      !iree_vmvx_test_lookup_is(&cache, tiles[1])) {
+    IREE_UK_TEST_FAIL(test);
+  }
+  // The first malformed line fails the whole parse.
+  iree_vmvx_tile_sizes_cache_initialize(&cache);
+  if (iree_status_consume_code(iree_vmvx_tile_sizes_cache_parse(
+          &cache, IREE_SV("# comment\nnot a tile\n"), cpu_data)) !=
+      IREE_STATUS_INVALID_ARGUMENT) {
+    IREE_UK_TEST_FAIL(test);
+  }
+}
+
+int main(int argc, char** argv) {
+  // Each test runs with the baseline CPU data, then with the host's.
+  iree_uk_test("malformed_lines", iree_vmvx_test_malformed_lines, NULL,
+               "host");
+  iree_uk_test("unusable_lines", iree_vmvx_test_unusable_lines, NULL, "host");
+  iree_uk_test("fastest_tile_wins", iree_vmvx_test_fastest_tile_wins, NULL,
+               "host");
+  iree_uk_test("parse_contents", iree_vmvx_test_parse_contents, NULL, "host");
+  return iree_uk_test_exit_status();
+}
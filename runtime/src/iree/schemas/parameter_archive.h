@@ -160,6 +160,10 @@ enum iree_io_parameter_archive_entry_type_e {
   // Entry represents data stored in an external file.
   // See iree_io_parameter_archive_external_entry_t.
   IREE_IO_PARAMETER_ARCHIVE_ENTRY_TYPE_EXTERNAL = 3,
+  // Entry represents data embedded in the archive as a sequence of chunks that
+  // may each be encoded and shared with other chunks.
+  // See iree_io_parameter_archive_chunked_entry_t.
+  IREE_IO_PARAMETER_ARCHIVE_ENTRY_TYPE_CHUNKED = 4,
 };
 // Defines the type of an entry in the archive entry table.
 typedef uint32_t iree_io_parameter_archive_entry_type_t;
@@ -226,6 +230,48 @@ typedef struct iree_io_parameter_archive_data_entry_t {
   iree_io_parameter_archive_storage_ref_t storage;
 } iree_io_parameter_archive_data_entry_t;
 
+// Encoding applied to a chunk of a chunked entry.
+enum iree_io_parameter_archive_codec_e {
+  // Chunk contents are stored as-is.
+  IREE_IO_PARAMETER_ARCHIVE_CODEC_NONE = 0,
+  // Chunk contents are stored as a single LZ4 block (no frame header).
+  // https://github.com/lz4/lz4/blob/dev/doc/lz4_Block_format.md
+  IREE_IO_PARAMETER_ARCHIVE_CODEC_LZ4_BLOCK = 1,
+};
+// Defines the encoding of a chunk of a chunked entry.
+typedef uint32_t iree_io_parameter_archive_codec_t;
+
+// A chunk of a chunked entry. Chunks with identical contents (within the same
+// entry or across entries) may reference the same storage range.
+typedef struct iree_io_parameter_archive_chunk_t {
+  // Relative offset and encoded length of the chunk in the data storage
+  // segment.
+  iree_io_parameter_archive_storage_ref_t storage;
+  // Hash of the decoded chunk contents used to identify duplicate chunks when
+  // building or appending to archives. Not verified when loading.
+  uint64_t content_hash;
+  // Encoding of the chunk contents in storage.
+  iree_io_parameter_archive_codec_t codec;
+  // Reserved for future use; must be zero.
+  uint32_t reserved;
+} iree_io_parameter_archive_chunk_t;
+
+// An entry stored as a sequence of chunks in the archive data storage segment.
+// Every chunk decodes to chunk_size bytes except the last which decodes to the
+// remainder of the entry length. The chunk table is stored in the metadata
+// segment as a dense array of iree_io_parameter_archive_chunk_t.
+typedef struct iree_io_parameter_archive_chunked_entry_t {
+  // Entry header with type IREE_IO_PARAMETER_ARCHIVE_ENTRY_TYPE_CHUNKED.
+  iree_io_parameter_archive_entry_header_t header;
+  // Total decoded length of the parameter in bytes.
+  iree_io_physical_size_t length;
+  // Decoded length of each chunk in bytes.
+  iree_io_physical_size_t chunk_size;
+  // Reference to the chunk table in the metadata segment. The table must have
+  // exactly ceil(length / chunk_size) chunks.
+  iree_io_parameter_archive_metadata_ref_t chunk_table;
+} iree_io_parameter_archive_chunked_entry_t;
+
 // An entry referencing data in an external file.
 typedef struct iree_io_parameter_archive_external_entry_t {
   // Entry header with type IREE_IO_PARAMETER_ARCHIVE_ENTRY_TYPE_EXTERNAL.
@@ -72,7 +72,12 @@ IREE_FLAG(
     " 'physical_cores':\n"
     "   Creates one executor per NUMA node in --task_topology_nodes= and one\n"
     "   group per physical core in each NUMA node up to the value specified\n"
-    "   by --task_topology_max_group_count=.");
+    "   by --task_topology_max_group_count=.\n"
+    " 'numa_per_queue':\n"
+    "   Like 'physical_cores' but defaults to all NUMA nodes in the system\n"
+    "   when --task_topology_nodes=current (the default). HAL devices created\n"
+    "   from the executors expose one queue per NUMA node such that queue\n"
+    "   affinity bit N routes submissions to the executor on the Nth node.");
 
 IREE_FLAG(
     int32_t, task_topology_group_count, 0,
@@ -128,11 +133,16 @@ static iree_status_t iree_task_topologies_select_nodes_from_flags(
   iree_string_view_t nodes_flag =
       iree_make_cstring_view(FLAG_task_topology_nodes);
   uint64_t node_mask = 0ull;
-  if (iree_string_view_is_empty(nodes_flag) ||
-      iree_string_view_equal(nodes_flag, IREE_SV("current"))) {
+  const bool numa_per_queue =
+      strcmp(FLAG_task_topology_mode, "numa_per_queue") == 0;
+  if (!numa_per_queue &&
+      (iree_string_view_is_empty(nodes_flag) ||
+       iree_string_view_equal(nodes_flag, IREE_SV("current")))) {
     // Use a single default node.
     node_mask = 1ull << iree_task_topology_query_current_node();
-  } else if (iree_string_view_equal(nodes_flag, IREE_SV("all"))) {
+  } else if (iree_string_view_is_empty(nodes_flag) ||
+             iree_string_view_equal(nodes_flag, IREE_SV("current")) ||
+             iree_string_view_equal(nodes_flag, IREE_SV("all"))) {
     // Use all nodes in the system (set bits starting at 0 for each node).
     node_mask = UINT64_MAX >> (64 - available_node_count);
   } else {
@@ -189,7 +199,8 @@ iree_status_t iree_task_topology_initialize_from_flags(
     iree_task_topology_initialize_from_group_count(
         FLAG_task_topology_group_count, out_topology);
     return iree_ok_status();
-  } else if (strcmp(FLAG_task_topology_mode, "physical_cores") == 0) {
+  } else if (strcmp(FLAG_task_topology_mode, "physical_cores") == 0 ||
+             strcmp(FLAG_task_topology_mode, "numa_per_queue") == 0) {
     // Physical cores sourced from a specific NUMA node.
     iree_task_topology_performance_level_t performance_level =
         IREE_TASK_TOPOLOGY_PERFORMANCE_LEVEL_ANY;
@@ -233,6 +244,7 @@ static void iree_task_flags_dump_task_topology(
     const iree_task_topology_group_t* group = &topology->groups[j];
     fprintf(stdout, "# group[%d]: '%s'\n", group->group_index, group->name);
     fprintf(stdout, "#      processor: %u\n", group->processor_index);
+    fprintf(stdout, "#           node: %u\n", group->node_id);
     fprintf(stdout, "#       affinity: ");
     if (group->ideal_thread_affinity.specified) {
       fprintf(
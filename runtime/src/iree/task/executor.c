@@ -47,6 +47,20 @@ static iree_host_size_t iree_task_topology_group_local_memory_size(
                          iree_hardware_destructive_interference_size);
 }
 
+// Returns a worker mask of all groups in |topology| that are on the same NUMA
+// node as |group| (including |group| itself).
+static iree_task_affinity_set_t iree_task_topology_calculate_node_sharing_mask(
+    const iree_task_topology_t* topology,
+    const iree_task_topology_group_t* group) {
+  iree_task_affinity_set_t mask = 0;
+  for (iree_host_size_t i = 0; i < topology->group_count; ++i) {
+    if (topology->groups[i].node_id == group->node_id) {
+      mask |= iree_task_affinity_for_worker((uint8_t)i);
+    }
+  }
+  return mask;
+}
+
 iree_status_t iree_task_executor_create(iree_task_executor_options_t options,
                                         const iree_task_topology_t* topology,
                                         iree_allocator_t allocator,
@@ -177,11 +191,14 @@ iree_status_t iree_task_executor_create(iree_task_executor_options_t options,
     for (iree_host_size_t i = 0; i < worker_count; ++i) {
       const iree_task_topology_group_t* group =
           iree_task_topology_get_group(topology, i);
+      if (group->node_id < 64) executor->node_mask |= 1ull << group->node_id;
       iree_host_size_t worker_local_memory_size =
           iree_task_topology_group_local_memory_size(options, group);
       iree_task_worker_t* worker = &executor->workers[i];
       status = iree_task_worker_initialize(
-          executor, i, group, options.worker_stack_size,
+          executor, i, group,
+          iree_task_topology_calculate_node_sharing_mask(topology, group),
+          options.worker_stack_size,
           iree_make_byte_span(worker_local_memory, worker_local_memory_size),
           &seed_prng, worker);
       worker_local_memory += worker_local_memory_size;
@@ -275,11 +292,34 @@ iree_host_size_t iree_task_executor_worker_count(
   return executor->worker_count;
 }
 
+uint64_t iree_task_executor_node_mask(iree_task_executor_t* executor) {
+  return executor->node_mask;
+}
+
 iree_event_pool_t* iree_task_executor_event_pool(
     iree_task_executor_t* executor) {
   return executor->event_pool;
 }
 
+void iree_task_executor_query_theft_statistics(
+    iree_task_executor_t* executor,
+    iree_task_executor_theft_statistics_t* out_statistics) {
+  IREE_ASSERT_ARGUMENT(executor);
+  IREE_ASSERT_ARGUMENT(out_statistics);
+  memset(out_statistics, 0, sizeof(*out_statistics));
+  for (iree_host_size_t i = 0; i < executor->worker_count; ++i) {
+    iree_task_worker_t* worker = &executor->workers[i];
+    for (iree_host_size_t j = 0; j < IREE_TASK_THEFT_LEVEL_COUNT; ++j) {
+      out_statistics->theft_count[j] += iree_atomic_load_int64(
+          &worker->theft_count[j], iree_memory_order_relaxed);
+    }
+    out_statistics->miss_count += iree_atomic_load_int64(
+        &worker->theft_miss_count, iree_memory_order_relaxed);
+    out_statistics->remote_deferral_count += iree_atomic_load_int64(
+        &worker->remote_theft_deferral_count, iree_memory_order_relaxed);
+  }
+}
+
 iree_status_t iree_task_executor_acquire_fence(iree_task_executor_t* executor,
                                                iree_task_scope_t* scope,
                                                iree_task_fence_t** out_fence) {
@@ -518,8 +558,9 @@ static iree_task_t* iree_task_executor_try_steal_task_from_affinity_set(
   if (!victim_mask) return NULL;
   max_theft_attempts = iree_min(max_theft_attempts,
                                 iree_task_affinity_set_count_ones(victim_mask));
-  victim_mask = iree_task_affinity_set_rotr(victim_mask, rotation_offset);
 
+  // NOTE: the mask is rotated once and offsets are relative to the rotation so
+  // that victim indices map back to the original worker bits.
   int worker_index = rotation_offset;
   iree_task_affinity_set_t mask =
       iree_task_affinity_set_rotr(victim_mask, worker_index);
@@ -536,7 +577,8 @@ static iree_task_t* iree_task_executor_try_steal_task_from_affinity_set(
     //            mask >>= 1 = 0b01010101
     //            victim_index = 4 % 64 = 4
     int offset = iree_task_affinity_set_count_trailing_zeros(mask);
-    int victim_index = (worker_index + offset) % executor->worker_count;
+    int victim_index =
+        (worker_index + offset) % (8 * sizeof(iree_task_affinity_set_t));
     worker_index += offset + 1;
     mask = iree_shr(mask, offset + 1);
     iree_task_worker_t* victim_worker = &executor->workers[victim_index];
@@ -564,12 +606,21 @@ static iree_task_t* iree_task_executor_try_steal_task_from_affinity_set(
 
 // Tries to steal an entire task from a sibling worker (based on topology).
 // Returns a task that is available (has not yet begun processing at all).
-// May steal multiple tasks and add them to the |local_task_queue|.
+// May steal multiple tasks and add them to the local task queue of
+// |thief_worker|.
 //
-// We do a scan through ideal victims indicated by the
-// |constructive_sharing_mask|; these are the workers most likely to have some
-// cache benefits to taking their work as they share some level of the cache
-// hierarchy and should be better to steal from than any random worker.
+// Victims are searched hierarchically, nearest first:
+//   1. workers indicated by the |constructive_sharing_mask|; these are the
+//      workers most likely to have some cache benefits to taking their work
+//      as they share some level of the cache hierarchy and should be better to
+//      steal from than any random worker.
+//   2. workers on the same NUMA node; we won't hit in their caches but the
+//      memory their tasks touch is likely local to our node.
+//   3. workers on remote NUMA nodes; only after the thief has failed to find
+//      work locally IREE_TASK_EXECUTOR_REMOTE_THEFT_MISS_THRESHOLD times in a
+//      row. Cross-node thefts pull the victim's working set across the
+//      interconnect and thrash both last level caches and are only worth it
+//      when the alternative is leaving the thief idle for a long time.
 //
 // To prevent biasing any particular victim we use a fast prng function to
 // select where in the set of potential victims defined by the topology
@@ -577,10 +628,7 @@ static iree_task_t* iree_task_executor_try_steal_task_from_affinity_set(
 // instead of bouncing around at random we just select the starting point in
 // our search and then go in-order.
 iree_task_t* iree_task_executor_try_steal_task(
-    iree_task_executor_t* executor,
-    iree_task_affinity_set_t constructive_sharing_mask,
-    uint32_t max_theft_attempts, iree_prng_minilcg128_state_t* theft_prng,
-    iree_task_queue_t* local_task_queue) {
+    iree_task_executor_t* executor, iree_task_worker_t* thief_worker) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
   // The masks are accessed with 'relaxed' order because they are just hints.
@@ -591,33 +639,73 @@ iree_task_t* iree_task_executor_try_steal_task(
       iree_atomic_task_affinity_set_load(&executor->worker_idle_mask,
                                          iree_memory_order_relaxed);
   // Limit the workers we will steal from to the ones that are currently live
-  // and not idle.
-  iree_task_affinity_set_t victim_mask = worker_live_mask & ~worker_idle_mask;
+  // and not idle (and not ourselves, as we only get here with an empty queue).
+  iree_task_affinity_set_t victim_mask =
+      worker_live_mask & ~worker_idle_mask & ~thief_worker->worker_bit;
+
+  // Partition the victims into the levels of the hierarchy. Cache sharing is
+  // limited to the local node as topologies that don't know their cache layout
+  // default to sharing with everything.
+  const iree_task_affinity_set_t node_sharing_mask =
+      thief_worker->node_sharing_mask;
+  iree_task_affinity_set_t level_masks[IREE_TASK_THEFT_LEVEL_COUNT];
+  level_masks[IREE_TASK_THEFT_LEVEL_CACHE] =
+      victim_mask & node_sharing_mask & thief_worker->constructive_sharing_mask;
+  level_masks[IREE_TASK_THEFT_LEVEL_NODE] =
+      victim_mask & node_sharing_mask &
+      ~thief_worker->constructive_sharing_mask;
+  level_masks[IREE_TASK_THEFT_LEVEL_REMOTE] = victim_mask & ~node_sharing_mask;
 
   // TODO(benvanik): it may be possible to rework this such that we better
   // use the prng; for example, instead of all this rotating stuff we could just
   // generate an 8-bit number (or even split it into two 4-bit numbers) per
   // theft attempt. The current rotation strategy is biased toward the same try
   // ordering vs. what we may really want with an unbiased random selection.
-  int rotation_offset = iree_prng_minilcg128_next_uint8(theft_prng) &
-                        (8 * sizeof(iree_task_affinity_set_t) - 1);
+  int rotation_offset =
+      iree_prng_minilcg128_next_uint8(&thief_worker->theft_prng) &
+      (8 * sizeof(iree_task_affinity_set_t) - 1);
 
   // Try first with the workers we may have some caches shared with. This
   // helps to prevent cache invalidations/availability updates as it's likely
   // that we won't need to go back to main memory (or higher cache tiers) in the
   // event that the thief and victim are running close to each other in time.
-  iree_task_t* task = iree_task_executor_try_steal_task_from_affinity_set(
-      executor, victim_mask & constructive_sharing_mask, max_theft_attempts,
-      rotation_offset, local_task_queue);
+  iree_task_t* task = NULL;
+  iree_task_theft_level_t level = IREE_TASK_THEFT_LEVEL_CACHE;
+  for (; level < IREE_TASK_THEFT_LEVEL_REMOTE; ++level) {
+    task = iree_task_executor_try_steal_task_from_affinity_set(
+        executor, level_masks[level], thief_worker->max_theft_attempts,
+        rotation_offset, &thief_worker->local_task_queue);
+    if (task) break;
+  }
+
+  // Only cross nodes if we've been starved locally for a while.
+  if (!task && level_masks[IREE_TASK_THEFT_LEVEL_REMOTE]) {
+    if (thief_worker->local_theft_miss_count >=
+        IREE_TASK_EXECUTOR_REMOTE_THEFT_MISS_THRESHOLD) {
+      level = IREE_TASK_THEFT_LEVEL_REMOTE;
+      task = iree_task_executor_try_steal_task_from_affinity_set(
+          executor, level_masks[level], thief_worker->max_theft_attempts,
+          rotation_offset, &thief_worker->local_task_queue);
+    } else {
+      iree_atomic_fetch_add_int64(&thief_worker->remote_theft_deferral_count,
+                                  1, iree_memory_order_relaxed);
+    }
+  }
+
   if (task) {
-    IREE_TRACE_ZONE_APPEND_TEXT(z0, "local");
+    thief_worker->local_theft_miss_count = 0;
+    iree_atomic_fetch_add_int64(&thief_worker->theft_count[level], 1,
+                                iree_memory_order_relaxed);
+    IREE_TRACE_ZONE_APPEND_TEXT(
+        z0, level == IREE_TASK_THEFT_LEVEL_CACHE  ? "cache"
+            : level == IREE_TASK_THEFT_LEVEL_NODE ? "node"
+                                                  : "remote");
   } else {
-    task = iree_task_executor_try_steal_task_from_affinity_set(
-        executor, victim_mask & ~constructive_sharing_mask, max_theft_attempts,
-        rotation_offset, local_task_queue);
-    if (task) {
-      IREE_TRACE_ZONE_APPEND_TEXT(z0, "non-local");
+    if (thief_worker->local_theft_miss_count < UINT32_MAX) {
+      ++thief_worker->local_theft_miss_count;
     }
+    iree_atomic_fetch_add_int64(&thief_worker->theft_miss_count, 1,
+                                iree_memory_order_relaxed);
   }
 
   IREE_TRACE_ZONE_END(z0);
@@ -336,6 +336,10 @@ void iree_task_executor_trim(iree_task_executor_t* executor);
 iree_host_size_t iree_task_executor_worker_count(
     iree_task_executor_t* executor);
 
+// Returns a bitmask of the NUMA nodes the executor workers are assigned to.
+// Bit N is set if any worker is on node N; nodes >= 64 are not represented.
+uint64_t iree_task_executor_node_mask(iree_task_executor_t* executor);
+
 // Returns an iree_event_t pool managed by the executor.
 // Users of the task system should acquire their transient events from this.
 // Long-lived events should be allocated on their own in order to avoid
@@ -348,6 +352,41 @@ iree_status_t iree_task_executor_acquire_fence(iree_task_executor_t* executor,
                                                iree_task_scope_t* scope,
                                                iree_task_fence_t** out_fence);
 
+// Levels of the topology hierarchy across which workers may steal tasks from
+// each other, ordered from nearest to farthest. Workers exhaust all victims at
+// one level before moving on to the next.
+typedef enum iree_task_theft_level_e {
+  // Victims that share some level of the cache hierarchy with the thief as
+  // indicated by the topology group constructive_sharing_mask.
+  IREE_TASK_THEFT_LEVEL_CACHE = 0,
+  // Victims on the same NUMA node as the thief that do not share caches.
+  IREE_TASK_THEFT_LEVEL_NODE,
+  // Victims on other NUMA nodes. Only attempted after
+  // IREE_TASK_EXECUTOR_REMOTE_THEFT_MISS_THRESHOLD consecutive local misses.
+  IREE_TASK_THEFT_LEVEL_REMOTE,
+
+  IREE_TASK_THEFT_LEVEL_COUNT,
+} iree_task_theft_level_t;
+
+// Work-stealing statistics aggregated across all workers of an executor.
+// Counters are monotonically increasing over the lifetime of the executor.
+typedef struct iree_task_executor_theft_statistics_t {
+  // Total number of successful thefts at each iree_task_theft_level_t.
+  int64_t theft_count[IREE_TASK_THEFT_LEVEL_COUNT];
+  // Total number of theft attempts that found no work at any level tried.
+  int64_t miss_count;
+  // Total number of theft attempts that skipped remote victims because the
+  // thief had not yet missed enough times locally.
+  int64_t remote_deferral_count;
+} iree_task_executor_theft_statistics_t;
+
+// Queries the work-stealing statistics of all workers in |executor|.
+// Workers update their counters without synchronization and the results may be
+// slightly stale if queried while work is in-flight.
+void iree_task_executor_query_theft_statistics(
+    iree_task_executor_t* executor,
+    iree_task_executor_theft_statistics_t* out_statistics);
+
 // TODO(benvanik): scheduling mode mutation, compute quota control, etc.
 
 // Submits a batch of tasks for execution.
@@ -5,6 +5,7 @@
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
 #include <cstddef>
+#include <cstdio>
 
 #include "iree/base/internal/prng.h"
 #include "iree/task/executor.h"
@@ -163,6 +164,18 @@ extern "C" int main(int argc, char* argv[]) {
 
   IREE_CHECK_OK(iree_task_scope_wait_idle(&scope_a, IREE_TIME_INFINITE_FUTURE));
 
+  // Dump work-stealing behavior; on multi-node systems the remote count should
+  // stay low relative to the cache/node counts.
+  iree_task_executor_theft_statistics_t theft_statistics;
+  iree_task_executor_query_theft_statistics(executor, &theft_statistics);
+  fprintf(stdout,
+          "thefts: cache=%" PRId64 ", node=%" PRId64 ", remote=%" PRId64
+          " (misses=%" PRId64 ", remote deferrals=%" PRId64 ")\n",
+          theft_statistics.theft_count[IREE_TASK_THEFT_LEVEL_CACHE],
+          theft_statistics.theft_count[IREE_TASK_THEFT_LEVEL_NODE],
+          theft_statistics.theft_count[IREE_TASK_THEFT_LEVEL_REMOTE],
+          theft_statistics.miss_count, theft_statistics.remote_deferral_count);
+
   iree_task_scope_deinitialize(&scope_a);
   iree_task_executor_release(executor);
   IREE_TRACE_APP_EXIT(0);
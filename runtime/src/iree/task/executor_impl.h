@@ -126,6 +126,9 @@ struct iree_task_executor_t {
   // live join/leave behavior we could change this to a registration mechanism.
   iree_host_size_t worker_count;
   iree_task_worker_t* workers;  // [worker_count]
+
+  // Bitmask of NUMA node IDs (< 64) that any worker topology group is on.
+  uint64_t node_mask;
 };
 
 // Merges a submission into the primary FIFO queues.
@@ -156,12 +159,10 @@ void iree_task_executor_coordinate(iree_task_executor_t* executor,
 
 // Tries to steal an entire task from a sibling worker (based on topology).
 // Returns a task that is available (has not yet begun processing at all).
-// May steal multiple tasks and add them to the |local_task_queue|.
+// May steal multiple tasks and add them to the local task queue of
+// |thief_worker|.
 iree_task_t* iree_task_executor_try_steal_task(
-    iree_task_executor_t* executor,
-    iree_task_affinity_set_t constructive_sharing_mask,
-    uint32_t max_theft_attempts, iree_prng_minilcg128_state_t* theft_prng,
-    iree_task_queue_t* local_task_queue);
+    iree_task_executor_t* executor, iree_task_worker_t* thief_worker);
 
 #ifdef __cplusplus
 }  // extern "C"
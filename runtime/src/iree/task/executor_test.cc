@@ -6,6 +6,7 @@
 
 #include "iree/task/executor.h"
 
+#include <atomic>
 #include <cstddef>
 
 #include "iree/testing/gtest.h"
@@ -135,4 +136,199 @@ TEST(ExecutorTest, SubmissionStress) {
   iree_task_topology_deinitialize(&topology);
 }
 
+// Runs a 64x16 dispatch on |executor| and returns the number of tiles that
+// executed.
+static int RunDispatch(iree_task_executor_t* executor) {
+  iree_task_scope_t scope;
+  iree_task_scope_initialize(iree_make_cstring_view("scope"),
+                             IREE_TASK_SCOPE_FLAG_NONE, &scope);
+
+  std::atomic<int> tile_count = {0};
+  const uint32_t workgroup_size[3] = {1, 1, 1};
+  const uint32_t workgroup_count[3] = {64, 16, 1};
+  iree_task_dispatch_t dispatch;
+  iree_task_dispatch_initialize(
+      &scope,
+      iree_task_make_dispatch_closure(
+          [](void* user_context, const iree_task_tile_context_t* tile_context,
+             iree_task_submission_t* pending_submission) {
+            ++*(std::atomic<int>*)user_context;
+            return iree_ok_status();
+          },
+          &tile_count),
+      workgroup_size, workgroup_count, &dispatch);
+
+  iree_task_fence_t* fence = NULL;
+  IREE_CHECK_OK(iree_task_executor_acquire_fence(executor, &scope, &fence));
+  iree_task_set_completion_task(&dispatch.header, &fence->header);
+
+  iree_task_submission_t submission;
+  iree_task_submission_initialize(&submission);
+  iree_task_submission_enqueue(&submission, &dispatch.header);
+  iree_task_executor_submit(executor, &submission);
+  iree_task_executor_flush(executor);
+  IREE_CHECK_OK(iree_task_scope_wait_idle(&scope, IREE_TIME_INFINITE_FUTURE));
+  iree_task_scope_deinitialize(&scope);
+  return tile_count;
+}
+
+// Tests that workers on a single NUMA node never count remote thefts.
+TEST(ExecutorTest, SingleNodeTheftStatistics) {
+  iree_task_topology_t topology;
+  iree_task_topology_initialize_from_group_count(/*group_count=*/4, &topology);
+  iree_task_executor_options_t options;
+  iree_task_executor_options_initialize(&options);
+  iree_task_executor_t* executor = NULL;
+  IREE_ASSERT_OK(iree_task_executor_create(options, &topology,
+                                           iree_allocator_system(), &executor));
+  iree_task_topology_deinitialize(&topology);
+
+  for (int i = 0; i < 16; ++i) {
+    EXPECT_EQ(64 * 16, RunDispatch(executor));
+  }
+
+  iree_task_executor_theft_statistics_t statistics;
+  iree_task_executor_query_theft_statistics(executor, &statistics);
+  EXPECT_EQ(0, statistics.theft_count[IREE_TASK_THEFT_LEVEL_REMOTE]);
+  EXPECT_EQ(0, statistics.remote_deferral_count);
+
+  iree_task_executor_release(executor);
+}
+
+// Tests that workers on multiple NUMA nodes that share caches within their node
+// only ever count cache-level and remote thefts.
+TEST(ExecutorTest, MultiNodeTheftStatistics) {
+  // Synthesize a 2-node topology with 2 groups per node where each node shares
+  // caches.
+  iree_task_topology_t topology;
+  iree_task_topology_initialize_from_group_count(/*group_count=*/4, &topology);
+  for (iree_host_size_t i = 0; i < topology.group_count; ++i) {
+    topology.groups[i].node_id = (iree_task_topology_node_id_t)(i / 2);
+    topology.groups[i].constructive_sharing_mask = 0x3ull << ((i / 2) * 2);
+  }
+
+  iree_task_executor_options_t options;
+  iree_task_executor_options_initialize(&options);
+  options.worker_local_memory_size = 64 * 1024;
+  iree_task_executor_t* executor = NULL;
+  IREE_ASSERT_OK(iree_task_executor_create(options, &topology,
+                                           iree_allocator_system(), &executor));
+  iree_task_topology_deinitialize(&topology);
+  EXPECT_EQ(0x3ull, iree_task_executor_node_mask(executor));
+
+  // No work has been performed so there can't have been any thefts. Workers
+  // may have already missed while starting up.
+  iree_task_executor_theft_statistics_t statistics;
+  iree_task_executor_query_theft_statistics(executor, &statistics);
+  for (int i = 0; i < IREE_TASK_THEFT_LEVEL_COUNT; ++i) {
+    EXPECT_EQ(0, statistics.theft_count[i]);
+  }
+
+  for (int i = 0; i < 16; ++i) {
+    EXPECT_EQ(64 * 16, RunDispatch(executor));
+  }
+
+  // Every victim on the local node shares caches with the thief.
+  iree_task_executor_query_theft_statistics(executor, &statistics);
+  EXPECT_EQ(0, statistics.theft_count[IREE_TASK_THEFT_LEVEL_NODE]);
+
+  iree_task_executor_release(executor);
+}
+
+// Tests that a worker with nothing to do on its own node steals from a remote
+// node once it has missed locally enough times.
+TEST(ExecutorTest, RemoteTheftWhenLocalNodeStarved) {
+  // One worker on each of 2 nodes and no sharing across workers.
+  iree_task_topology_t topology;
+  iree_task_topology_initialize_from_group_count(/*group_count=*/2, &topology);
+  for (iree_host_size_t i = 0; i < topology.group_count; ++i) {
+    topology.groups[i].node_id = (iree_task_topology_node_id_t)i;
+    topology.groups[i].constructive_sharing_mask = 1ull << i;
+  }
+  iree_task_executor_options_t options;
+  iree_task_executor_options_initialize(&options);
+  iree_task_executor_t* executor = NULL;
+  IREE_ASSERT_OK(iree_task_executor_create(options, &topology,
+                                           iree_allocator_system(), &executor));
+  iree_task_topology_deinitialize(&topology);
+
+  // Two calls are posted to worker 0. Whichever runs first blocks until the
+  // other has run, which can only happen if worker 1 steals it. Worker 1 keeps
+  // pumping (and missing local thefts) by running a chain of calls that
+  // resubmits itself until then. The deadline prevents hangs on failure.
+  struct State {
+    iree_task_scope_t scope;
+    std::atomic<int> started = {0};
+    iree_time_t deadline_ns = 0;
+    iree_task_call_t chain[2];
+    int chain_index = 0;
+  } state;
+  iree_task_scope_initialize(iree_make_cstring_view("scope"),
+                             IREE_TASK_SCOPE_FLAG_NONE, &state.scope);
+  state.deadline_ns = iree_time_now() + 10 * 1000000000ll;
+  auto blocking_call = [](void* user_context, iree_task_t* task,
+                          iree_task_submission_t* pending_submission) {
+    State* state = (State*)user_context;
+    if (state->started++ == 0) {
+      while (state->started < 2 && iree_time_now() < state->deadline_ns) {
+      }
+    }
+    return iree_ok_status();
+  };
+  auto chain_call = [](void* user_context, iree_task_t* task,
+                       iree_task_submission_t* pending_submission) {
+    State* state = (State*)user_context;
+    if (state->started >= 2 || iree_time_now() >= state->deadline_ns) {
+      return iree_ok_status();
+    }
+    // Tasks are retired before the pending submission is issued so the
+    // previous task in the chain is free for reuse. The fence dependency is
+    // handed off to the next task.
+    state->chain_index ^= 1;
+    iree_task_call_t* next_call = &state->chain[state->chain_index];
+    iree_task_call_initialize(&state->scope, ((iree_task_call_t*)task)->closure,
+                              next_call);
+    next_call->header.affinity_set = iree_task_affinity_for_worker(1);
+    next_call->header.completion_task = task->completion_task;
+    task->completion_task = NULL;
+    iree_task_submission_enqueue(pending_submission, &next_call->header);
+    return iree_ok_status();
+  };
+
+  iree_task_fence_t* fence = NULL;
+  IREE_ASSERT_OK(
+      iree_task_executor_acquire_fence(executor, &state.scope, &fence));
+  iree_task_submission_t submission;
+  iree_task_submission_initialize(&submission);
+  iree_task_call_t blocking_calls[2];
+  for (int i = 0; i < 2; ++i) {
+    iree_task_call_initialize(
+        &state.scope, iree_task_make_call_closure(blocking_call, &state),
+        &blocking_calls[i]);
+    blocking_calls[i].header.affinity_set = iree_task_affinity_for_worker(0);
+    iree_task_set_completion_task(&blocking_calls[i].header, &fence->header);
+    iree_task_submission_enqueue(&submission, &blocking_calls[i].header);
+  }
+  iree_task_call_initialize(&state.scope,
+                            iree_task_make_call_closure(chain_call, &state),
+                            &state.chain[0]);
+  state.chain[0].header.affinity_set = iree_task_affinity_for_worker(1);
+  iree_task_set_completion_task(&state.chain[0].header, &fence->header);
+  iree_task_submission_enqueue(&submission, &state.chain[0].header);
+  iree_task_executor_submit(executor, &submission);
+  iree_task_executor_flush(executor);
+  IREE_ASSERT_OK(
+      iree_task_scope_wait_idle(&state.scope, IREE_TIME_INFINITE_FUTURE));
+  EXPECT_LT(iree_time_now(), state.deadline_ns);
+
+  iree_task_executor_theft_statistics_t statistics;
+  iree_task_executor_query_theft_statistics(executor, &statistics);
+  EXPECT_EQ(0, statistics.theft_count[IREE_TASK_THEFT_LEVEL_CACHE]);
+  EXPECT_EQ(0, statistics.theft_count[IREE_TASK_THEFT_LEVEL_NODE]);
+  EXPECT_EQ(1, statistics.theft_count[IREE_TASK_THEFT_LEVEL_REMOTE]);
+
+  iree_task_scope_deinitialize(&state.scope);
+  iree_task_executor_release(executor);
+}
+
 }  // namespace
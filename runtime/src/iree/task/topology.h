@@ -74,6 +74,11 @@ typedef struct iree_task_topology_group_t {
   // Logical processor index.
   uint32_t processor_index;
 
+  // NUMA node the processor belongs to or 0 if the platform does not support
+  // querying the node. Groups with differing node IDs are assumed to be on
+  // different packages/sockets and not share any cache or local memory.
+  iree_task_topology_node_id_t node_id;
+
   // Total cache sizes (that we care about).
   iree_task_topology_caches_t caches;
 
@@ -28,7 +28,71 @@ static void iree_task_topology_initialize_fallback(
   IREE_TRACE_ZONE_END(z0);
 }
 
-#if defined(IREE_TASK_CPUINFO_DISABLED)
+//===----------------------------------------------------------------------===//
+// NUMA queries
+//===----------------------------------------------------------------------===//
+// cpuinfo has no notion of NUMA nodes (its clusters are groups of identical
+// cores and a single node may contain several of them) so we ask the kernel.
+
+#if defined(IREE_PLATFORM_LINUX) || defined(IREE_PLATFORM_ANDROID)
+
+#include <dirent.h>
+#include <stdio.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// Returns the NUMA node of logical processor |cpu_id| or 0 if the kernel does
+// not expose NUMA information.
+static iree_task_topology_node_id_t iree_task_topology_query_cpu_node(
+    uint32_t cpu_id) {
+  // Each CPU has a `nodeN` link to the node it belongs to.
+  char path[64];
+  snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u", cpu_id);
+  DIR* dir = opendir(path);
+  if (!dir) return 0;
+  iree_task_topology_node_id_t node_id = 0;
+  struct dirent* entry = NULL;
+  while ((entry = readdir(dir)) != NULL) {
+    unsigned int value = 0;
+    if (sscanf(entry->d_name, "node%u", &value) == 1) {
+      node_id = (iree_task_topology_node_id_t)value;
+      break;
+    }
+  }
+  closedir(dir);
+  return node_id;
+}
+
+// TODO(benvanik): change to a system API and move to iree/base/allocator.h so
+// it can be used there for binding memory to nodes.
+iree_host_size_t iree_task_topology_query_node_count(void) {
+  // The online node list is formatted as ranges (`0-1,3`). Node IDs are used
+  // as indices and may be sparse so we return the highest ID + 1.
+  FILE* file = fopen("/sys/devices/system/node/online", "r");
+  if (!file) return 1;
+  unsigned int highest_node_id = 0;
+  unsigned int value = 0;
+  while (fscanf(file, "%u", &value) == 1) {
+    highest_node_id = iree_max(highest_node_id, value);
+    if (fgetc(file) == EOF) break;  // skip `-` or `,`
+  }
+  fclose(file);
+  return (iree_host_size_t)highest_node_id + 1;
+}
+
+iree_task_topology_node_id_t iree_task_topology_query_current_node(void) {
+  unsigned int cpu = 0;
+  unsigned int node = 0;
+  if (syscall(SYS_getcpu, &cpu, &node, NULL) != 0) return 0;
+  return (iree_task_topology_node_id_t)node;
+}
+
+#else
+
+static inline iree_task_topology_node_id_t iree_task_topology_query_cpu_node(
+    uint32_t cpu_id) {
+  return 0;
+}
 
 iree_host_size_t iree_task_topology_query_node_count(void) { return 1; }
 
@@ -36,6 +100,10 @@ iree_task_topology_node_id_t iree_task_topology_query_current_node(void) {
   return 0;
 }
 
+#endif  // IREE_PLATFORM_LINUX || IREE_PLATFORM_ANDROID
+
+#if defined(IREE_TASK_CPUINFO_DISABLED)
+
 iree_status_t iree_task_topology_fixup_constructive_sharing_masks(
     iree_task_topology_t* topology) {
   // No-op.
@@ -64,6 +132,7 @@ iree_status_t iree_task_topology_initialize_from_logical_cpu_set(
     iree_task_topology_group_t* group = &out_topology->groups[i];
     iree_task_topology_group_initialize(i, group);
     group->processor_index = cpu_ids[i];
+    group->node_id = iree_task_topology_query_cpu_node(cpu_ids[i]);
 
     // NOTE: without cpuinfo we can't get cache sizes so we just guess some
     // conservative values.
@@ -101,12 +170,14 @@ static bool iree_task_topology_is_cpuinfo_available() {
   return cpuinfo_initialize() && cpuinfo_get_cores_count() > 0;
 }
 
-// TODO(benvanik): change to a system API and move to iree/base/allocator.h so
-// it can be used there for binding memory to nodes.
-iree_host_size_t iree_task_topology_query_node_count(void) {
-  if (!iree_task_topology_is_cpuinfo_available()) return 1;
-  // NOTE: this may span across packages!
-  return cpuinfo_get_clusters_count();
+// Returns the NUMA node ID of the given |processor|.
+static iree_task_topology_node_id_t iree_task_topology_node_id_from_processor(
+    const struct cpuinfo_processor* processor) {
+#if defined(__linux__)
+  return iree_task_topology_query_cpu_node(processor->linux_id);
+#else
+  return 0;
+#endif  // __linux__
 }
 
 // Returns the core of the calling thread or NULL if not supported.
@@ -116,13 +187,6 @@ static const struct cpuinfo_core* iree_task_topology_get_current_core() {
   return current_core;
 }
 
-iree_task_topology_node_id_t iree_task_topology_query_current_node(void) {
-  if (!iree_task_topology_is_cpuinfo_available()) return 0;
-  const struct cpuinfo_core* current_core =
-      iree_task_topology_get_current_core();
-  return current_core ? current_core->cluster->cluster_id : 0;
-}
-
 // Returns |core_id| rotated by the calling base core ID.
 // On many systems the kernel will have already assigned a randomized starting
 // core for thread distribution and we can just reuse that.
@@ -182,6 +246,7 @@ static void iree_task_topology_group_initialize_from_processor(
   out_group->processor_index =
       processor->core->processor_start + processor->smt_id;
 #endif  // __linux__
+  out_group->node_id = iree_task_topology_node_id_from_processor(processor);
   out_group->caches.l1_data =
       processor->cache.l1d ? processor->cache.l1d->size : 0;
   out_group->caches.l2_data =
@@ -322,17 +387,18 @@ typedef bool (*iree_task_topology_core_filter_t)(
     const struct cpuinfo_core* core, void* user_data);
 
 typedef struct iree_task_topology_core_filter_params_t {
-  uint32_t cluster_id;
+  iree_task_topology_node_id_t node_id;
   iree_task_topology_performance_level_t performance_level;
 } iree_task_topology_core_filter_params_t;
 
-// Matches all cores that have the provided cluster ID.
-static bool iree_task_topology_core_filter_by_cluster_id(
+// Matches all cores on the provided NUMA node.
+static bool iree_task_topology_core_filter_by_node_id(
     const struct cpuinfo_core* core, void* user_data) {
   const iree_task_topology_core_filter_params_t* params =
       (const iree_task_topology_core_filter_params_t*)user_data;
-  if (params->cluster_id != IREE_TASK_TOPOLOGY_NODE_ID_ANY &&
-      core->cluster->cluster_id != params->cluster_id) {
+  if (params->node_id != IREE_TASK_TOPOLOGY_NODE_ID_ANY &&
+      iree_task_topology_node_id_from_processor(cpuinfo_get_processor(
+          core->processor_start)) != params->node_id) {
     return false;
   }
   // cpuinfo doesn't expose performance levels and instead we have to switch on
@@ -424,11 +490,11 @@ iree_status_t iree_task_topology_initialize_from_physical_cores(
     iree_task_topology_performance_level_t performance_level,
     iree_host_size_t max_core_count, iree_task_topology_t* out_topology) {
   iree_task_topology_core_filter_params_t params = {
-      .cluster_id = node_id,
+      .node_id = node_id,
       .performance_level = performance_level,
   };
   return iree_task_topology_initialize_from_physical_cores_with_filter(
-      iree_task_topology_core_filter_by_cluster_id, &params, max_core_count,
+      iree_task_topology_core_filter_by_node_id, &params, max_core_count,
       out_topology);
 }
 
@@ -65,6 +65,19 @@ TEST(TopologyTest, Construction) {
   iree_task_topology_deinitialize(&topology);
 }
 
+TEST(TopologyTest, DefaultNodeId) {
+  // Groups without platform information are all assumed to be on node 0.
+  iree_task_topology_t topology;
+  iree_task_topology_initialize_from_group_count(/*group_count=*/4, &topology);
+  EXPECT_EQ(4, iree_task_topology_group_count(&topology));
+  for (iree_host_size_t i = 0; i < 4; ++i) {
+    const iree_task_topology_group_t* group =
+        iree_task_topology_get_group(&topology, i);
+    EXPECT_EQ(0, group->node_id);
+  }
+  iree_task_topology_deinitialize(&topology);
+}
+
 TEST(TopologyTest, MaxCapacity) {
   iree_task_topology_t topology;
   iree_task_topology_initialize(&topology);
@@ -145,4 +158,24 @@ TEST(TopologyTest, FromPhysicalCores) {
   iree_task_topology_deinitialize(&topology);
 }
 
+TEST(TopologyTest, NodeIdsInRange) {
+  // Node IDs are used as bit indices into node masks and must be within the
+  // reported node count.
+  iree_host_size_t node_count = iree_task_topology_query_node_count();
+  ASSERT_GE(node_count, 1);
+  EXPECT_LT(iree_task_topology_query_current_node(), node_count);
+  iree_task_topology_t topology;
+  iree_task_topology_initialize(&topology);
+  IREE_ASSERT_OK(iree_task_topology_initialize_from_physical_cores(
+      IREE_TASK_TOPOLOGY_NODE_ID_ANY, IREE_TASK_TOPOLOGY_PERFORMANCE_LEVEL_ANY,
+      IREE_TASK_TOPOLOGY_GROUP_BIT_COUNT, &topology));
+  for (iree_host_size_t i = 0; i < iree_task_topology_group_count(&topology);
+       ++i) {
+    const iree_task_topology_group_t* group =
+        iree_task_topology_get_group(&topology, i);
+    EXPECT_LT(group->node_id, node_count);
+  }
+  iree_task_topology_deinitialize(&topology);
+}
+
 }  // namespace
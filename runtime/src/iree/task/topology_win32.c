@@ -64,6 +64,22 @@ static void iree_task_topology_set_affinity_from_processor(
       iree_task_count_trailing_zeros_kaffinity(processor->GroupMask[0].Mask);
 }
 
+// Returns the NUMA node of the processor |affinity| is pinned to or 0 if it
+// cannot be queried.
+static iree_task_topology_node_id_t iree_task_topology_query_affinity_node(
+    const iree_thread_affinity_t* affinity) {
+  PROCESSOR_NUMBER processor_number;
+  memset(&processor_number, 0, sizeof(processor_number));
+  processor_number.Group = (WORD)affinity->group;
+  processor_number.Number = (BYTE)affinity->id;
+  USHORT node_number = 0;
+  if (!GetNumaProcessorNodeEx(&processor_number, &node_number) ||
+      node_number == 0xFFFF) {
+    return 0;
+  }
+  return (iree_task_topology_node_id_t)node_number;
+}
+
 // Uses |group_mask| to assign |cache| information to select topology groups.
 static void iree_task_topology_assign_cache_info(
     iree_task_topology_t* topology, GROUP_AFFINITY group_mask,
@@ -307,6 +323,7 @@ iree_status_t iree_task_topology_initialize_from_logical_cpu_set(
         affinity->smt = (p->Processor.Flags & LTP_PC_SMT) == LTP_PC_SMT;
         affinity->group = p->Processor.GroupMask[0].Group;
         affinity->id = group_offset + bit_offset;
+        group->node_id = iree_task_topology_query_affinity_node(affinity);
       }
       group_offset += bit_offset + 1;
       if (out_topology->group_count >= cpu_count) break;
@@ -545,6 +562,8 @@ iree_status_t iree_task_topology_initialize_from_physical_cores(
     group->constructive_sharing_mask = 0;  // set below
     iree_task_topology_set_affinity_from_processor(
         core, &group->ideal_thread_affinity);
+    group->node_id =
+        iree_task_topology_query_affinity_node(&group->ideal_thread_affinity);
   }
 
   // Assign constructive sharing masks to each topology group.
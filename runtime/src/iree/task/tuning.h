@@ -60,6 +60,19 @@ extern "C" {
 // Setting this to 0 will disable thefts.
 #define IREE_TASK_EXECUTOR_MAX_THEFT_ATTEMPTS_DIVISOR (1)
 
+// Number of consecutive theft attempts that must fail to find work on workers
+// within the same NUMA node before a worker will try to steal from workers on
+// remote nodes.
+//
+// Stealing across nodes is expensive: the stolen tasks will likely touch
+// memory local to the victim's node and the thief will then pull it across
+// the interconnect while also evicting the victim's last level cache lines.
+// It's only worth doing when the local node has run dry for a while and the
+// alternative is leaving the thief idle.
+//
+// Setting this to 0 will allow remote thefts as soon as local thefts fail.
+#define IREE_TASK_EXECUTOR_REMOTE_THEFT_MISS_THRESHOLD (4)
+
 // Maximum number of tasks that will be stolen in one go from another worker.
 //
 // Too few tasks will cause additional overhead as the worker repeatedly sips
@@ -24,8 +24,9 @@ static int iree_task_worker_main(iree_task_worker_t* worker);
 iree_status_t iree_task_worker_initialize(
     iree_task_executor_t* executor, iree_host_size_t worker_index,
     const iree_task_topology_group_t* topology_group,
-    iree_host_size_t stack_size, iree_byte_span_t local_memory,
-    iree_prng_splitmix64_state_t* seed_prng, iree_task_worker_t* out_worker) {
+    iree_task_affinity_set_t node_sharing_mask, iree_host_size_t stack_size,
+    iree_byte_span_t local_memory, iree_prng_splitmix64_state_t* seed_prng,
+    iree_task_worker_t* out_worker) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
   out_worker->executor = executor;
@@ -34,8 +35,10 @@ iree_status_t iree_task_worker_initialize(
   out_worker->ideal_thread_affinity = topology_group->ideal_thread_affinity;
   out_worker->constructive_sharing_mask =
       topology_group->constructive_sharing_mask;
+  out_worker->node_sharing_mask = node_sharing_mask;
   out_worker->max_theft_attempts =
       executor->worker_count / IREE_TASK_EXECUTOR_MAX_THEFT_ATTEMPTS_DIVISOR;
+  out_worker->local_theft_miss_count = 0;
   iree_prng_minilcg128_initialize(iree_prng_splitmix64_next(seed_prng),
                                   &out_worker->theft_prng);
   out_worker->local_memory = local_memory;
@@ -222,18 +225,19 @@ static bool iree_task_worker_pump_once(
     // complete tasks faster than others, etc).
     task = iree_task_queue_flush_from_lifo_slist(&worker->local_task_queue,
                                                  &worker->mailbox_slist);
+    // Work posted to us means the executor isn't starved for local work and
+    // any streak of failed local thefts is over.
+    if (task) worker->local_theft_miss_count = 0;
   }
 
 #if IREE_TASK_EXECUTOR_MAX_THEFT_ATTEMPTS_DIVISOR > 0
   // If we ran out of work assigned to this specific worker try to steal some
   // from other workers that we hopefully share some of the cache hierarchy
-  // with. Their tasks will be moved from their local queue into ours and the
-  // the first task in the queue is popped off and returned.
+  // with (falling back to workers on the same NUMA node and only rarely to
+  // workers on remote nodes). Their tasks will be moved from their local queue
+  // into ours and the first task in the queue is popped off and returned.
   if (!task) {
-    task = iree_task_executor_try_steal_task(
-        worker->executor, worker->constructive_sharing_mask,
-        worker->max_theft_attempts, &worker->theft_prng,
-        &worker->local_task_queue);
+    task = iree_task_executor_try_steal_task(worker->executor, worker);
   }
 #endif  // IREE_TASK_EXECUTOR_MAX_THEFT_ATTEMPTS_DIVISOR > 0
 
@@ -98,15 +98,31 @@ typedef struct iree_task_worker_t {
   // all share the same L3 cache.
   iree_task_affinity_set_t constructive_sharing_mask;
 
+  // A bitmask of other workers (including this one) whose topology groups are
+  // on the same NUMA node. Workers outside of this mask are only stolen from
+  // after repeated failures to find work locally.
+  iree_task_affinity_set_t node_sharing_mask;
+
   // Maximum number of attempts to make when trying to steal tasks from other
   // workers. This could be 64 (try stealing from all workers) or just a handful
   // (try stealing from these 3 other cores that share your L3 cache).
   uint32_t max_theft_attempts;
 
+  // Number of consecutive theft attempts that failed to find work on the local
+  // NUMA node. Reset whenever the worker receives or steals work.
+  // Only ever touched by the worker thread as it steals work.
+  uint32_t local_theft_miss_count;
+
   // Rotation counter for work stealing (ensures we don't favor one victim).
   // Only ever touched by the worker thread as it steals work.
   iree_prng_minilcg128_state_t theft_prng;
 
+  // Work-stealing counters. Only ever written by the worker thread but may be
+  // read from any thread via iree_task_executor_query_theft_statistics.
+  iree_atomic_int64_t theft_count[IREE_TASK_THEFT_LEVEL_COUNT];
+  iree_atomic_int64_t theft_miss_count;
+  iree_atomic_int64_t remote_theft_deferral_count;
+
   // Thread handle of the worker. If the thread has exited the handle will
   // remain valid so that the executor can query its state.
   iree_thread_t* thread;
@@ -156,11 +172,15 @@ static_assert(offsetof(iree_task_worker_t, local_task_queue) >=
 // tasks. Where supported the worker will be created in a suspended state so
 // that we aren't creating a thundering herd on startup:
 // https://en.wikipedia.org/wiki/Thundering_herd_problem
+//
+// |node_sharing_mask| indicates which other workers in the executor are on the
+// same NUMA node as |topology_group|.
 iree_status_t iree_task_worker_initialize(
     iree_task_executor_t* executor, iree_host_size_t worker_index,
     const iree_task_topology_group_t* topology_group,
-    iree_host_size_t stack_size, iree_byte_span_t local_memory,
-    iree_prng_splitmix64_state_t* seed_prng, iree_task_worker_t* out_worker);
+    iree_task_affinity_set_t node_sharing_mask, iree_host_size_t stack_size,
+    iree_byte_span_t local_memory, iree_prng_splitmix64_state_t* seed_prng,
+    iree_task_worker_t* out_worker);
 
 // Requests that the worker begin exiting (if it hasn't already).
 // If the worker is actively processing tasks it will wait until it has
@@ -6,12 +6,23 @@
 
 #include "iree/tooling/parameter_util.h"
 
+#if defined(IREE_PLATFORM_ANDROID) || defined(IREE_PLATFORM_APPLE) || \
+    defined(IREE_PLATFORM_LINUX)
+#define IREE_IO_PARAMETER_FD_SUPPORTED 1
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#else
+#define IREE_IO_PARAMETER_FD_SUPPORTED 0
+#endif  // IREE_PLATFORM_*
+
 #include "iree/base/internal/file_io.h"
 #include "iree/base/internal/flags.h"
 #include "iree/base/internal/path.h"
 #include "iree/io/formats/gguf/gguf_parser.h"
 #include "iree/io/formats/irpa/irpa_parser.h"
 #include "iree/io/formats/safetensors/safetensors_parser.h"
+#include "iree/io/parallel_for.h"
 #include "iree/io/parameter_index.h"
 #include "iree/io/parameter_index_provider.h"
 #include "iree/io/scope_map.h"
@@ -23,11 +34,22 @@
 
 IREE_FLAG(
     string, parameter_mode, "mmap",
-    "A parameter I/O mode of ['preload', 'mmap'].\n"
+    "A parameter I/O mode of ['preload', 'mmap', 'file'].\n"
     "  preload: read entire parameter files into wired memory on startup.\n"
     "  mmap: maps the parameter files into discardable memory - can increase\n"
     "        warm-up time and variance as mapped pages are swapped\n"
-    "        by the OS.");
+    "        by the OS.\n"
+    "  file: reads parameters from the files with the device file I/O\n"
+    "        (io_uring on Linux when available) into device allocations -\n"
+    "        parameter contents are not kept in host memory. Only supported\n"
+    "        on platforms with POSIX file descriptors.");
+
+IREE_FLAG(
+    int64_t, parameter_residency_budget, 0,
+    "Maximum number of bytes of parameters kept resident in host memory when\n"
+    "using `--parameter_mode=mmap`. Least-recently-used parameters beyond the\n"
+    "budget have their pages released back to the file and are faulted back\n"
+    "in when next used. 0 leaves residency to the OS.");
 
 static void iree_file_contents_release_callback(
     void* user_data, iree_io_file_handle_primitive_t handle_primitive) {
@@ -35,52 +57,70 @@ static void iree_file_contents_release_callback(
   iree_file_contents_free(file_contents);
 }
 
-// Opens the parameter file at |path| with the mode specified by the
-// --parameter_mode flag and returns its handle.
-static iree_status_t iree_io_open_parameter_file(
-    iree_string_view_t path, iree_allocator_t host_allocator,
-    iree_io_file_handle_t** out_file_handle) {
-  IREE_ASSERT_ARGUMENT(out_file_handle);
-  *out_file_handle = NULL;
-  IREE_TRACE_ZONE_BEGIN(z0);
-  IREE_TRACE_ZONE_APPEND_TEXT(z0, path.data, path.size);
-
-  char path_str[2048] = {0};
-  iree_string_view_to_cstring(path, path_str, sizeof(path_str));
-  iree_file_read_flags_t read_flags = 0;
-  if (strcmp(FLAG_parameter_mode, "mmap") == 0) {
-    read_flags |= IREE_FILE_READ_FLAG_MMAP;
-  } else if (strcmp(FLAG_parameter_mode, "preload") == 0) {
-    read_flags |= IREE_FILE_READ_FLAG_PRELOAD;
-  } else {
-    IREE_TRACE_ZONE_END(z0);
-    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
-                            "unrecognized --parameter_mode= value '%s'",
-                            FLAG_parameter_mode);
-  }
-
+// Opens the parameter file at |path| as a host allocation with the given
+// |read_flags| and returns its handle.
+static iree_status_t iree_io_open_parameter_file_contents(
+    const char* path, iree_file_read_flags_t read_flags,
+    iree_allocator_t host_allocator, iree_io_file_handle_t** out_file_handle) {
   iree_file_contents_t* file_contents = NULL;
-  IREE_RETURN_AND_END_ZONE_IF_ERROR(
-      z0, iree_file_read_contents(path_str, read_flags, host_allocator,
-                                  &file_contents));
-
+  IREE_RETURN_IF_ERROR(iree_file_read_contents(path, read_flags,
+                                               host_allocator, &file_contents));
   iree_io_file_handle_release_callback_t release_callback = {
       .fn = iree_file_contents_release_callback,
       .user_data = file_contents,
   };
-  iree_io_file_handle_t* file_handle = NULL;
   iree_status_t status = iree_io_file_handle_wrap_host_allocation(
       IREE_IO_FILE_ACCESS_READ, file_contents->buffer, release_callback,
-      host_allocator, &file_handle);
-  if (iree_status_is_ok(status)) {
-    *out_file_handle = file_handle;
-  } else {
+      host_allocator, out_file_handle);
+  if (!iree_status_is_ok(status)) {
     iree_file_contents_free(file_contents);
   }
-  IREE_TRACE_ZONE_END(z0);
   return status;
 }
 
+#if IREE_IO_PARAMETER_FD_SUPPORTED
+
+static void iree_io_fd_release_callback(
+    void* user_data, iree_io_file_handle_primitive_t handle_primitive) {
+  close(handle_primitive.value.fd);
+}
+
+// Opens the parameter file at |path| as a file descriptor for reading and
+// returns its handle. The descriptor is closed when the handle is released.
+static iree_status_t iree_io_open_parameter_file_descriptor(
+    const char* path, iree_allocator_t host_allocator,
+    iree_io_file_handle_t** out_file_handle) {
+  int fd = open(path, O_RDONLY | O_CLOEXEC);
+  if (fd == -1) {
+    return iree_make_status(iree_status_code_from_errno(errno),
+                            "failed to open file '%s'", path);
+  }
+  iree_io_file_handle_release_callback_t release_callback = {
+      .fn = iree_io_fd_release_callback,
+      .user_data = NULL,
+  };
+  iree_status_t status = iree_io_file_handle_wrap_fd(
+      IREE_IO_FILE_ACCESS_READ, fd, release_callback, host_allocator,
+      out_file_handle);
+  if (!iree_status_is_ok(status)) {
+    close(fd);
+  }
+  return status;
+}
+
+#else
+
+static iree_status_t iree_io_open_parameter_file_descriptor(
+    const char* path, iree_allocator_t host_allocator,
+    iree_io_file_handle_t** out_file_handle) {
+  return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                          "--parameter_mode=file requires POSIX file "
+                          "descriptors which are not available on this "
+                          "platform");
+}
+
+#endif  // IREE_IO_PARAMETER_FD_SUPPORTED
+
 //===----------------------------------------------------------------------===//
 // Parameter file format parsing
 //===----------------------------------------------------------------------===//
@@ -96,31 +136,106 @@ IREE_FLAG_LIST(
     "- .gguf (https://github.com/ggerganov/ggml/blob/master/docs/gguf.md)\n"
     "- .safetensors (https://github.com/huggingface/safetensors)");
 
-// Appends the parameter file located at |path| to |index|.
+// Parses the parameter file in |file_handle| based on the (inferred) format
+// of |path| and appends its parameters to |index|.
+static iree_status_t iree_io_parse_parameter_file_into_index(
+    iree_string_view_t path, iree_io_file_handle_t* file_handle,
+    iree_io_parameter_index_t* index) {
+  iree_string_view_t path_ext = iree_file_path_extension(path);
+  if (iree_string_view_equal_case(path_ext, IREE_SV("irpa"))) {
+    return iree_io_parse_irpa_index(file_handle, index);
+  } else if (iree_string_view_equal_case(path_ext, IREE_SV("gguf"))) {
+    return iree_io_parse_gguf_index(file_handle, index);
+  } else if (iree_string_view_equal_case(path_ext, IREE_SV("safetensors"))) {
+    return iree_io_parse_safetensors_index(file_handle, index);
+  }
+  return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                          "unhandled parameter file format: .%.*s",
+                          (int)path_ext.size, path_ext.data);
+}
+
+// Appends all parameters of |source| to |index| with the file-backed ones
+// reading from |fd_handle| instead of the mapped |mapped_handle| they were
+// parsed from. Chunked parameters are decoded on the host and keep reading
+// from the mapping.
+static iree_status_t iree_io_append_parameters_with_fd(
+    iree_io_parameter_index_t* source, iree_io_file_handle_t* mapped_handle,
+    iree_io_file_handle_t* fd_handle, iree_io_parameter_index_t* index) {
+  const iree_host_size_t count = iree_io_parameter_index_count(source);
+  IREE_RETURN_IF_ERROR(iree_io_parameter_index_reserve(
+      index, iree_io_parameter_index_count(index) + count));
+  for (iree_host_size_t i = 0; i < count; ++i) {
+    const iree_io_parameter_index_entry_t* source_entry = NULL;
+    IREE_RETURN_IF_ERROR(iree_io_parameter_index_get(source, i, &source_entry));
+    iree_io_parameter_index_entry_t entry = *source_entry;
+    if (entry.type == IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_FILE &&
+        entry.storage.file.handle == mapped_handle) {
+      entry.storage.file.handle = fd_handle;
+    }
+    IREE_RETURN_IF_ERROR(iree_io_parameter_index_add(index, &entry));
+  }
+  return iree_ok_status();
+}
+
+// Appends the parameter file located at |path| to |index| with the mode
+// specified by the --parameter_mode flag.
 static iree_status_t iree_io_append_parameter_file_to_index(
     iree_string_view_t path, iree_io_parameter_index_t* index,
     iree_allocator_t host_allocator) {
   IREE_ASSERT_ARGUMENT(index);
   IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_TEXT(z0, path.data, path.size);
+
+  char path_str[2048] = {0};
+  iree_string_view_to_cstring(path, path_str, sizeof(path_str));
+  iree_file_read_flags_t read_flags = 0;
+  bool use_fd = false;
+  if (strcmp(FLAG_parameter_mode, "mmap") == 0) {
+    read_flags |= IREE_FILE_READ_FLAG_MMAP;
+  } else if (strcmp(FLAG_parameter_mode, "preload") == 0) {
+    read_flags |= IREE_FILE_READ_FLAG_PRELOAD;
+  } else if (strcmp(FLAG_parameter_mode, "file") == 0) {
+    // The parsers need the file contents in host memory so the file is mapped
+    // while indexing; only the pages of the headers are touched.
+    read_flags |= IREE_FILE_READ_FLAG_MMAP;
+    use_fd = true;
+  } else {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "unrecognized --parameter_mode= value '%s'",
+                            FLAG_parameter_mode);
+  }
 
   // Open the file.
   iree_io_file_handle_t* file_handle = NULL;
   IREE_RETURN_AND_END_ZONE_IF_ERROR(
-      z0, iree_io_open_parameter_file(path, host_allocator, &file_handle));
+      z0, iree_io_open_parameter_file_contents(path_str, read_flags,
+                                               host_allocator, &file_handle));
 
-  // Index the file based on its (inferred) format.
   iree_status_t status = iree_ok_status();
-  iree_string_view_t path_ext = iree_file_path_extension(path);
-  if (iree_string_view_equal_case(path_ext, IREE_SV("irpa"))) {
-    status = iree_io_parse_irpa_index(file_handle, index);
-  } else if (iree_string_view_equal_case(path_ext, IREE_SV("gguf"))) {
-    status = iree_io_parse_gguf_index(file_handle, index);
-  } else if (iree_string_view_equal_case(path_ext, IREE_SV("safetensors"))) {
-    status = iree_io_parse_safetensors_index(file_handle, index);
+  if (!use_fd) {
+    // Index the file directly from its contents.
+    status = iree_io_parse_parameter_file_into_index(path, file_handle, index);
   } else {
-    status = iree_make_status(IREE_STATUS_UNIMPLEMENTED,
-                              "unhandled parameter file format: .%.*s",
-                              (int)path_ext.size, path_ext.data);
+    // Index the mapped file and then redirect the parameters to a file
+    // descriptor so that devices read them with their file I/O.
+    iree_io_parameter_index_t* mapped_index = NULL;
+    iree_io_file_handle_t* fd_handle = NULL;
+    status = iree_io_parameter_index_create(host_allocator, &mapped_index);
+    if (iree_status_is_ok(status)) {
+      status = iree_io_parse_parameter_file_into_index(path, file_handle,
+                                                       mapped_index);
+    }
+    if (iree_status_is_ok(status)) {
+      status = iree_io_open_parameter_file_descriptor(path_str, host_allocator,
+                                                      &fd_handle);
+    }
+    if (iree_status_is_ok(status)) {
+      status = iree_io_append_parameters_with_fd(mapped_index, file_handle,
+                                                 fd_handle, index);
+    }
+    iree_io_file_handle_release(fd_handle);
+    iree_io_parameter_index_release(mapped_index);
   }
 
   // Release our file reference - it's still retained by the index if it had any
@@ -131,34 +246,107 @@ static iree_status_t iree_io_append_parameter_file_to_index(
   return status;
 }
 
+IREE_FLAG(
+    int32_t, parameter_open_concurrency, 8,
+    "Maximum number of parameter files opened and indexed concurrently.\n"
+    "Each file is indexed independently and the results are merged into\n"
+    "their scope in command line order so that duplicate keys resolve the\n"
+    "same regardless of concurrency. 1 opens files serially.");
+
+// A single parameter file (shard) specified on the command line.
+typedef struct iree_io_parameter_shard_t {
+  // Scope the shard's parameters are made available under.
+  iree_string_view_t scope;
+  // Path of the parameter file.
+  iree_string_view_t path;
+  // Index containing only the parameters of this shard.
+  iree_io_parameter_index_t* index;
+  // Result of opening and indexing the shard.
+  iree_status_t status;
+} iree_io_parameter_shard_t;
+
+// Shared state of the threads opening shards.
+typedef struct iree_io_parameter_shard_list_t {
+  iree_allocator_t host_allocator;
+  iree_host_size_t count;
+  iree_io_parameter_shard_t* shards;
+} iree_io_parameter_shard_list_t;
+
+// Opens and indexes shard |work_index|. Shards are processed independently so
+// failures are recorded per shard and reported in order by the caller.
+static iree_status_t iree_io_parameter_shard_list_open_shard(
+    void* user_data, iree_host_size_t worker_index, uint64_t work_index) {
+  iree_io_parameter_shard_list_t* list =
+      (iree_io_parameter_shard_list_t*)user_data;
+  iree_io_parameter_shard_t* shard = &list->shards[work_index];
+  shard->status =
+      iree_io_parameter_index_create(list->host_allocator, &shard->index);
+  if (iree_status_is_ok(shard->status)) {
+    shard->status = iree_io_append_parameter_file_to_index(
+        shard->path, shard->index, list->host_allocator);
+  }
+  return iree_ok_status();
+}
+
 iree_status_t iree_tooling_build_parameter_indices_from_flags(
     iree_io_scope_map_t* scope_map) {
+  const iree_host_size_t shard_count = FLAG_parameters_list().count;
+  if (!shard_count) return iree_ok_status();
   IREE_TRACE_ZONE_BEGIN(z0);
+  iree_allocator_t host_allocator = scope_map->host_allocator;
+
+  iree_io_parameter_shard_list_t list;
+  memset(&list, 0, sizeof(list));
+  list.host_allocator = host_allocator;
+  list.count = shard_count;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(host_allocator,
+                                shard_count * sizeof(*list.shards),
+                                (void**)&list.shards));
 
-  // Create one index per scope and add parameters to each.
-  for (iree_host_size_t i = 0; i < FLAG_parameters_list().count; ++i) {
-    // Parse the `scope=path` flag. Note that the scope is optional.
+  // Parse the `scope=path` flags. Note that the scope is optional.
+  for (iree_host_size_t i = 0; i < shard_count; ++i) {
+    iree_io_parameter_shard_t* shard = &list.shards[i];
     iree_string_view_t flag = FLAG_parameters_list().values[i];
-    iree_string_view_t scope, path;
-    if (iree_string_view_split(flag, '=', &scope, &path) == -1) {
+    if (iree_string_view_split(flag, '=', &shard->scope, &shard->path) == -1) {
       // No scope provided (that's ok).
-      path = scope;
-      scope = iree_string_view_empty();
+      shard->path = shard->scope;
+      shard->scope = iree_string_view_empty();
     }
+    shard->status = iree_ok_status();
+  }
 
-    // Lookup (or create) the index for the given scope.
-    iree_io_parameter_index_t* index = NULL;  // unowned
-    IREE_RETURN_AND_END_ZONE_IF_ERROR(
-        z0, iree_io_scope_map_lookup(scope_map, scope, &index));
+  // Open and index all shards independently. Most of the startup time of
+  // programs with large sharded parameter sets is spent in file I/O and
+  // parsing headers so this is where parallelism helps.
+  iree_status_t status = iree_io_parallel_for(
+      IREE_SV("iree-param-open"), shard_count,
+      (iree_host_size_t)iree_max(1, FLAG_parameter_open_concurrency),
+      iree_io_parameter_shard_list_open_shard, &list, host_allocator);
 
-    // Index the file.
-    IREE_RETURN_AND_END_ZONE_IF_ERROR(
-        z0, iree_io_append_parameter_file_to_index(path, index,
-                                                   scope_map->host_allocator));
+  // Merge each shard into the index for its scope in command line order and
+  // report the first failure (if any).
+  for (iree_host_size_t i = 0; i < shard_count; ++i) {
+    iree_io_parameter_shard_t* shard = &list.shards[i];
+    if (iree_status_is_ok(status)) {
+      status = shard->status;
+    } else {
+      iree_status_ignore(shard->status);
+    }
+    if (iree_status_is_ok(status)) {
+      // Lookup (or create) the index for the given scope.
+      iree_io_parameter_index_t* index = NULL;  // unowned
+      status = iree_io_scope_map_lookup(scope_map, shard->scope, &index);
+      if (iree_status_is_ok(status)) {
+        status = iree_io_parameter_index_merge(index, shard->index);
+      }
+    }
+    iree_io_parameter_index_release(shard->index);
   }
 
+  iree_allocator_free(host_allocator, list.shards);
   IREE_TRACE_ZONE_END(z0);
-  return iree_ok_status();
+  return status;
 }
 
 iree_status_t iree_tooling_create_parameters_module_from_flags(
@@ -173,6 +361,16 @@ iree_status_t iree_tooling_create_parameters_module_from_flags(
   iree_status_t status =
       iree_tooling_build_parameter_indices_from_flags(&scope_map);
 
+  // Mapped files are only paged in as they are touched so we have the
+  // providers hint the system to fetch the pages ahead of use. Their pages can
+  // also be released back to the file when over the residency budget.
+  iree_io_parameter_index_provider_flags_t provider_flags =
+      IREE_IO_PARAMETER_INDEX_PROVIDER_FLAG_NONE;
+  if (strcmp(FLAG_parameter_mode, "mmap") == 0) {
+    provider_flags |= IREE_IO_PARAMETER_INDEX_PROVIDER_FLAG_PREFETCH |
+                      IREE_IO_PARAMETER_INDEX_PROVIDER_FLAG_RECLAIMABLE;
+  }
+
   // Create one provider per scope.
   iree_host_size_t provider_count = 0;
   iree_io_parameter_provider_t** providers =
@@ -180,10 +378,10 @@ iree_status_t iree_tooling_create_parameters_module_from_flags(
           scope_map.count * sizeof(iree_io_parameter_provider_t*));
   if (iree_status_is_ok(status)) {
     for (iree_host_size_t i = 0; i < scope_map.count; ++i) {
-      status = iree_io_parameter_index_provider_create(
+      status = iree_io_parameter_index_provider_create_with_flags(
           scope_map.entries[i]->scope, scope_map.entries[i]->index,
           IREE_IO_PARAMETER_INDEX_PROVIDER_DEFAULT_MAX_CONCURRENT_OPERATIONS,
-          host_allocator, &providers[i]);
+          provider_flags, host_allocator, &providers[i]);
       if (!iree_status_is_ok(status)) break;
       ++provider_count;
     }
@@ -191,8 +389,13 @@ iree_status_t iree_tooling_create_parameters_module_from_flags(
 
   // Create the module with the list of providers.
   if (iree_status_is_ok(status)) {
-    status = iree_io_parameters_module_create(
-        instance, provider_count, providers, host_allocator, out_module);
+    iree_io_parameters_module_options_t module_options;
+    memset(&module_options, 0, sizeof(module_options));
+    module_options.residency_budget =
+        (uint64_t)iree_max(0, FLAG_parameter_residency_budget);
+    status = iree_io_parameters_module_create_with_options(
+        instance, provider_count, providers, &module_options, host_allocator,
+        out_module);
   }
 
   // Cleanup (module owns providers which own indices/etc).
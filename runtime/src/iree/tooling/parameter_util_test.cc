@@ -0,0 +1,157 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/tooling/parameter_util.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/base/internal/flags.h"
+#include "iree/hal/api.h"
+#include "iree/hal/drivers/local_sync/sync_device.h"
+#include "iree/io/parameter_index.h"
+#include "iree/io/parameter_index_provider.h"
+#include "iree/io/scope_map.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace {
+
+// Writes a safetensors file at |path| containing a single U8 tensor named
+// |key| with |contents|.
+static void WriteSafetensorsFile(const std::string& path,
+                                 const std::string& key,
+                                 const std::vector<uint8_t>& contents) {
+  std::string length = std::to_string(contents.size());
+  std::string header = "{\"" + key + "\":{\"dtype\":\"U8\",\"shape\":[" +
+                       length + "],\"data_offsets\":[0," + length + "]}}";
+  uint64_t header_length = header.size();
+  FILE* file = fopen(path.c_str(), "wb");
+  ASSERT_NE(file, nullptr);
+  uint8_t header_length_le[8];
+  for (int i = 0; i < 8; ++i) {
+    header_length_le[i] = (uint8_t)(header_length >> (i * 8));
+  }
+  ASSERT_EQ(fwrite(header_length_le, 1, sizeof(header_length_le), file),
+            sizeof(header_length_le));
+  ASSERT_EQ(fwrite(header.data(), 1, header.size(), file), header.size());
+  ASSERT_EQ(fwrite(contents.data(), 1, contents.size(), file),
+            contents.size());
+  fclose(file);
+}
+
+// Parses |flags| as if they were passed on the command line. Flag values
+// reference the argument strings so |flags| must outlive their use.
+static void ParseFlags(std::vector<std::string>& flags) {
+  static char program[] = "parameter_util_test";
+  std::vector<char*> argv;
+  argv.push_back(program);
+  for (std::string& flag : flags) argv.push_back(&flag[0]);
+  int argc = (int)argv.size();
+  char** argv_ptr = argv.data();
+  IREE_ASSERT_OK(
+      iree_flags_parse(IREE_FLAGS_PARSE_MODE_DEFAULT, &argc, &argv_ptr));
+}
+
+// Tests that parameters opened with `--parameter_mode=file` are backed by file
+// descriptors and streamed into device buffers by the device file I/O. The
+// parameter spans several transfer blocks so that multiple reads are in flight
+// when io_uring is available.
+TEST(ParameterUtilTest, FileModeStreamsFromFileDescriptor) {
+#if defined(IREE_PLATFORM_ANDROID) || defined(IREE_PLATFORM_APPLE) || \
+    defined(IREE_PLATFORM_LINUX)
+  iree_allocator_t host_allocator = iree_allocator_system();
+
+  std::vector<uint8_t> contents(3 * 1024 * 1024 + 123);
+  for (size_t i = 0; i < contents.size(); ++i) {
+    contents[i] = (uint8_t)(i * 31 + i / 4096);
+  }
+  std::string path =
+      ::testing::TempDir() + "/parameter_util_test_file_mode.safetensors";
+  WriteSafetensorsFile(path, "weight", contents);
+  static std::vector<std::string> flags;
+  flags = {
+      "--parameter_mode=file",
+      "--parameters=model=" + path,
+  };
+  ParseFlags(flags);
+
+  iree_io_scope_map_t scope_map;
+  iree_io_scope_map_initialize(host_allocator, &scope_map);
+  IREE_ASSERT_OK(iree_tooling_build_parameter_indices_from_flags(&scope_map));
+  iree_io_parameter_index_t* index = NULL;
+  IREE_ASSERT_OK(
+      iree_io_scope_map_lookup(&scope_map, IREE_SV("model"), &index));
+  const iree_io_parameter_index_entry_t* entry = NULL;
+  IREE_ASSERT_OK(
+      iree_io_parameter_index_lookup(index, IREE_SV("weight"), &entry));
+  ASSERT_EQ(entry->type, IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_FILE);
+  EXPECT_EQ(iree_io_file_handle_type(entry->storage.file.handle),
+            IREE_IO_FILE_HANDLE_TYPE_FD);
+  EXPECT_EQ(entry->length, contents.size());
+
+  iree_io_parameter_provider_t* provider = NULL;
+  IREE_ASSERT_OK(iree_io_parameter_index_provider_create(
+      IREE_SV("model"), index,
+      IREE_IO_PARAMETER_INDEX_PROVIDER_DEFAULT_MAX_CONCURRENT_OPERATIONS,
+      host_allocator, &provider));
+
+  iree_hal_allocator_t* device_allocator = NULL;
+  IREE_ASSERT_OK(iree_hal_allocator_create_heap(
+      IREE_SV("heap"), host_allocator, host_allocator, &device_allocator));
+  iree_hal_sync_device_params_t device_params;
+  iree_hal_sync_device_params_initialize(&device_params);
+  iree_hal_device_t* device = NULL;
+  IREE_ASSERT_OK(iree_hal_sync_device_create(
+      IREE_SV("local-sync"), &device_params, /*loader_count=*/0,
+      /*loaders=*/NULL, device_allocator, host_allocator, &device));
+
+  iree_hal_buffer_params_t buffer_params = {0};
+  buffer_params.type =
+      IREE_HAL_MEMORY_TYPE_HOST_LOCAL | IREE_HAL_MEMORY_TYPE_DEVICE_VISIBLE;
+  buffer_params.usage =
+      IREE_HAL_BUFFER_USAGE_TRANSFER | IREE_HAL_BUFFER_USAGE_MAPPING;
+  iree_hal_buffer_t* buffer = NULL;
+  IREE_ASSERT_OK(iree_hal_allocator_allocate_buffer(
+      device_allocator, buffer_params, contents.size(), &buffer));
+
+  iree_hal_semaphore_t* semaphore = NULL;
+  IREE_ASSERT_OK(iree_hal_semaphore_create(device, 0ull, &semaphore));
+  uint64_t signal_value = 1ull;
+  iree_hal_semaphore_list_t signal_semaphore_list = {
+      1,
+      &semaphore,
+      &signal_value,
+  };
+  IREE_ASSERT_OK(iree_io_parameter_provider_read(
+      provider, device, IREE_HAL_QUEUE_AFFINITY_ANY,
+      iree_hal_semaphore_list_empty(), signal_semaphore_list, IREE_SV("model"),
+      IREE_SV("weight"), /*source_offset=*/0, buffer, /*target_offset=*/0,
+      contents.size()));
+  IREE_ASSERT_OK(
+      iree_hal_semaphore_wait(semaphore, 1ull, iree_infinite_timeout()));
+
+  std::vector<uint8_t> actual(contents.size());
+  IREE_ASSERT_OK(
+      iree_hal_buffer_map_read(buffer, 0, actual.data(), actual.size()));
+  EXPECT_EQ(actual, contents);
+
+  iree_hal_semaphore_release(semaphore);
+  iree_hal_buffer_release(buffer);
+  iree_hal_device_release(device);
+  iree_hal_allocator_release(device_allocator);
+  iree_io_parameter_provider_release(provider);
+  iree_io_scope_map_deinitialize(&scope_map);
+  std::remove(path.c_str());
+#else
+  GTEST_SKIP() << "file descriptors not supported on this platform";
+#endif  // IREE_PLATFORM_*
+}
+
+}  // namespace
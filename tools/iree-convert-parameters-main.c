@@ -19,6 +19,14 @@
 #include "iree/io/scope_map.h"
 #include "iree/tooling/parameter_util.h"
 
+#if defined(IREE_PLATFORM_ANDROID) || defined(IREE_PLATFORM_APPLE) || \
+    defined(IREE_PLATFORM_LINUX)
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#define IREE_TOOLING_OUTPUT_FD 1
+#endif  // IREE_PLATFORM_*
+
 //===----------------------------------------------------------------------===//
 // Parameter index logic
 //===----------------------------------------------------------------------===//
@@ -164,15 +172,87 @@ IREE_FLAG(bool, quiet, false,
 
 IREE_FLAG(string, output, "", "Output .irpa file path.");
 
-static void iree_io_file_handle_release_mapping(
-    void* user_data, iree_io_file_handle_primitive_t handle_primitive) {
-  iree_file_contents_free((iree_file_contents_t*)user_data);
+IREE_FLAG(int32_t, threads, 8,
+          "Maximum number of threads used to copy parameter contents into the\n"
+          "output file. 1 copies all contents on the main thread.");
+
+IREE_FLAG(bool, deduplicate, false,
+          "Stores identical chunks of parameter contents only once in the\n"
+          "output file.");
+
+IREE_FLAG(string, compression, "none",
+          "Codec used to compress chunks of parameter contents in the output\n"
+          "file: `none` or `lz4`.");
+
+// Parses the --compression= flag value into a codec.
+static iree_status_t iree_tooling_parse_compression_flag(
+    iree_io_parameter_codec_t* out_codec) {
+  iree_string_view_t value = iree_make_cstring_view(FLAG_compression);
+  if (iree_string_view_equal(value, IREE_SV("none"))) {
+    *out_codec = IREE_IO_PARAMETER_CODEC_NONE;
+  } else if (iree_string_view_equal(value, IREE_SV("lz4"))) {
+    *out_codec = IREE_IO_PARAMETER_CODEC_LZ4_BLOCK;
+  } else {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "unsupported --compression= value `%.*s`; "
+                            "expected `none` or `lz4`",
+                            (int)value.size, value.data);
+  }
+  return iree_ok_status();
 }
 
 typedef struct {
   iree_allocator_t host_allocator;
   const char* path;
 } iree_tooling_open_params_t;
+
+#if defined(IREE_TOOLING_OUTPUT_FD)
+
+static void iree_io_file_handle_release_fd(
+    void* user_data, iree_io_file_handle_primitive_t handle_primitive) {
+  close(handle_primitive.value.fd);
+}
+
+// Opens the output file for positioned writes. Contents are written through
+// the page cache as they are produced instead of dirtying a mapping of the
+// entire archive.
+static iree_status_t iree_tooling_open_output_parameter_file(
+    void* user_data, iree_io_physical_offset_t archive_offset,
+    iree_io_physical_size_t archive_length,
+    iree_io_file_handle_t** out_file_handle) {
+  iree_tooling_open_params_t* params = (iree_tooling_open_params_t*)user_data;
+  int fd = open(params->path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd == -1) {
+    return iree_make_status(iree_status_code_from_errno(errno),
+                            "failed to open file '%s'", params->path);
+  }
+  if (ftruncate(fd, (off_t)(archive_offset + archive_length)) == -1) {
+    iree_status_t status = iree_make_status(
+        iree_status_code_from_errno(errno),
+        "failed to extend file '%s' to %" PRIu64
+        " bytes (out of disk space or permission denied)",
+        params->path, archive_offset + archive_length);
+    close(fd);
+    return status;
+  }
+  iree_io_file_handle_release_callback_t release_callback = {
+      .fn = iree_io_file_handle_release_fd,
+      .user_data = NULL,
+  };
+  iree_status_t status = iree_io_file_handle_wrap_fd(
+      IREE_IO_FILE_ACCESS_READ | IREE_IO_FILE_ACCESS_WRITE, fd,
+      release_callback, params->host_allocator, out_file_handle);
+  if (!iree_status_is_ok(status)) close(fd);
+  return status;
+}
+
+#else
+
+static void iree_io_file_handle_release_mapping(
+    void* user_data, iree_io_file_handle_primitive_t handle_primitive) {
+  iree_file_contents_free((iree_file_contents_t*)user_data);
+}
+
 static iree_status_t iree_tooling_open_output_parameter_file(
     void* user_data, iree_io_physical_offset_t archive_offset,
     iree_io_physical_size_t archive_length,
@@ -196,6 +276,8 @@ static iree_status_t iree_tooling_open_output_parameter_file(
   return status;
 }
 
+#endif  // IREE_TOOLING_OUTPUT_FD
+
 int main(int argc, char** argv) {
   IREE_TRACE_APP_ENTER();
   IREE_TRACE_ZONE_BEGIN(z0);
@@ -216,6 +298,18 @@ int main(int argc, char** argv) {
       "    --parameters=input.safetensors \\\n"
       "    --output=output.irpa\n"
       "\n"
+      "Parameter contents are streamed from the inputs into their final\n"
+      "location in the output using up to `--threads=` threads. Use\n"
+      "`--parameter_mode=mmap` (the default) to avoid reading entire input\n"
+      "files into memory before conversion.\n"
+      "\n"
+      "Example deduplicating and compressing parameter contents:\n"
+      "  iree-convert-parameters \\\n"
+      "    --parameters=input.safetensors \\\n"
+      "    --deduplicate \\\n"
+      "    --compression=lz4 \\\n"
+      "    --output=output.irpa\n"
+      "\n"
       "Example mutating parameters:\n"
       "  iree-convert-parameters \\\n"
       "    --parameters=a.gguf \\\n"
@@ -256,6 +350,11 @@ int main(int argc, char** argv) {
     status = iree_io_parameter_index_create(host_allocator, &built_index);
   }
 
+  iree_io_parameter_codec_t codec = IREE_IO_PARAMETER_CODEC_NONE;
+  if (iree_status_is_ok(status)) {
+    status = iree_tooling_parse_compression_flag(&codec);
+  }
+
   // Write out the new archive.
   if (iree_status_is_ok(status)) {
     iree_tooling_open_params_t open_params = {
@@ -266,9 +365,17 @@ int main(int argc, char** argv) {
         .fn = iree_tooling_open_output_parameter_file,
         .user_data = &open_params,
     };
-    status = iree_io_build_parameter_archive(
+    iree_io_parameter_archive_build_options_t build_options = {
+        .max_concurrency = (iree_host_size_t)iree_max(1, FLAG_threads),
+        .chunk_size = 0,
+        .flags = FLAG_deduplicate
+                     ? IREE_IO_PARAMETER_ARCHIVE_BUILD_FLAG_DEDUPLICATE
+                     : IREE_IO_PARAMETER_ARCHIVE_BUILD_FLAG_NONE,
+        .codec = codec,
+    };
+    status = iree_io_build_parameter_archive_with_options(
         new_index, built_index, open_callback,
-        /*target_file_offset=*/0, host_allocator);
+        /*target_file_offset=*/0, build_options, host_allocator);
   }
 
   // Dump the new index ala iree-dump-parameters to show the final file.